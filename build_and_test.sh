@@ -21,7 +21,7 @@ mkdir -p build/bin
 # Set compiler and flags
 CC=gcc
 CFLAGS="-Wall -Wextra -std=c11 -I./src"
-LDFLAGS="-lm" # Add math library for quantum calculations
+LDFLAGS="-lm -lpthread" # Math library for quantum calculations, pthreads for concurrent components
 
 # Function to build a component
 build_component() {
@@ -91,12 +91,21 @@ hal_test=$(build_component "hal" \
     "tests/unit/test_hal.c")
 run_test "$hal_test"
 
+# Build and test the Trace facility
+echo -e "\n${BLUE}Building and testing Trace...${RESET}"
+trace_test=$(build_component "trace" \
+    "src/kernel/trace/trace.c" \
+    "tests/unit/test_trace.c")
+run_test "$trace_test"
+
 # Build and test the Memory Management System
 echo -e "\n${BLUE}Building and testing Memory Management System...${RESET}"
 mm_test=$(build_component "memory_manager" \
     "src/kernel/hal/hal.c" \
     "src/kernel/hal/arch/x86/x86_hal.c" \
     "src/kernel/memory/memory_manager.c" \
+    "src/quantum/entanglement/entanglement_registry.c" \
+    "src/kernel/trace/trace.c" \
     "tests/unit/test_memory_manager.c")
 run_test "$mm_test"
 
@@ -106,7 +115,9 @@ pm_test=$(build_component "process_manager" \
     "src/kernel/hal/hal.c" \
     "src/kernel/hal/arch/x86/x86_hal.c" \
     "src/kernel/memory/memory_manager.c" \
+    "src/quantum/entanglement/entanglement_registry.c" \
     "src/kernel/process/process_manager.c" \
+    "src/kernel/trace/trace.c" \
     "tests/unit/test_process_manager.c")
 run_test "$pm_test"
 
@@ -116,8 +127,10 @@ scheduler_test=$(build_component "scheduler" \
     "src/kernel/hal/hal.c" \
     "src/kernel/hal/arch/x86/x86_hal.c" \
     "src/kernel/memory/memory_manager.c" \
+    "src/quantum/entanglement/entanglement_registry.c" \
     "src/kernel/process/process_manager.c" \
     "src/kernel/process/scheduler.c" \
+    "src/kernel/trace/trace.c" \
     "tests/unit/test_scheduler.c")
 run_test "$scheduler_test"
 
@@ -125,7 +138,154 @@ run_test "$scheduler_test"
 echo -e "\n${BLUE}Building and testing Quantum Message Bus...${RESET}"
 qbus_test=$(build_component "quantum_message_bus" \
     "src/quantum/messaging/quantum_message_bus.c" \
+    "src/kernel/trace/trace.c" \
     "tests/unit/test_quantum_message_bus.c")
 run_test "$qbus_test"
 
+# Build and test the Quantum Message Bus federation transport
+echo -e "\n${BLUE}Building and testing Quantum Bus Transport...${RESET}"
+qbus_transport_test=$(build_component "quantum_bus_transport" \
+    "src/quantum/messaging/quantum_message_bus.c" \
+    "src/quantum/messaging/quantum_bus_transport.c" \
+    "src/kernel/trace/trace.c" \
+    "tests/unit/test_quantum_bus_transport.c")
+run_test "$qbus_transport_test"
+
+# Build and test the Memex Search Engine
+echo -e "\n${BLUE}Building and testing Memex Search Engine...${RESET}"
+memex_search_test=$(build_component "memex_search" \
+    "src/memex/search/search_engine.c" \
+    "src/memex/search/vector_index.c" \
+    "src/memex/search/result_cache.c" \
+    "src/memex/interface/memex_interface.c" \
+    "src/memex/knowledge/knowledge_graph.c" \
+    "src/memex/storage/knowledge_store.c" \
+    "src/quantum/messaging/quantum_message_bus.c" \
+    "src/kernel/trace/trace.c" \
+    "tests/unit/test_memex_search.c")
+run_test "$memex_search_test"
+
+# Build and test the Memex Knowledge Network
+echo -e "\n${BLUE}Building and testing Memex Knowledge Network...${RESET}"
+knowledge_network_test=$(build_component "knowledge_network" \
+    "src/memex/knowledge/knowledge_network.c" \
+    "src/memex/search/search_engine.c" \
+    "src/quantum/entanglement/entanglement_manager.c" \
+    "src/quantum/entanglement/entanglement_registry.c" \
+    "src/kernel/trace/trace.c" \
+    "tests/unit/test_knowledge_network.c")
+run_test "$knowledge_network_test"
+
+# Build and test the Memex Knowledge Graph
+echo -e "\n${BLUE}Building and testing Memex Knowledge Graph...${RESET}"
+knowledge_graph_test=$(build_component "knowledge_graph" \
+    "src/memex/knowledge/knowledge_graph.c" \
+    "src/memex/interface/memex_interface.c" \
+    "src/memex/search/search_engine.c" \
+    "src/memex/search/vector_index.c" \
+    "src/memex/search/result_cache.c" \
+    "src/memex/storage/knowledge_store.c" \
+    "src/quantum/messaging/quantum_message_bus.c" \
+    "src/kernel/trace/trace.c" \
+    "tests/unit/test_knowledge_graph.c")
+run_test "$knowledge_graph_test"
+
+# Build and test the Memex Knowledge Store
+echo -e "\n${BLUE}Building and testing Memex Knowledge Store...${RESET}"
+knowledge_store_test=$(build_component "knowledge_store" \
+    "src/memex/storage/knowledge_store.c" \
+    "tests/unit/test_knowledge_store.c")
+run_test "$knowledge_store_test"
+
+# Build and test the Memex Vector Index
+echo -e "\n${BLUE}Building and testing Memex Vector Index...${RESET}"
+vector_index_test=$(build_component "vector_index" \
+    "src/memex/search/vector_index.c" \
+    "tests/unit/test_vector_index.c")
+run_test "$vector_index_test"
+
+# Build and test the Memex Result Cache
+echo -e "\n${BLUE}Building and testing Memex Result Cache...${RESET}"
+result_cache_test=$(build_component "result_cache" \
+    "src/memex/search/result_cache.c" \
+    "tests/unit/test_result_cache.c")
+run_test "$result_cache_test"
+
+# Build and test the Quantum Ocular Processing Unit in isolation
+echo -e "\n${BLUE}Building and testing Quantum Ocular Processing Unit unit tests...${RESET}"
+quantum_ocular_unit_test=$(build_component "quantum_ocular" \
+    "src/quantum/ocular/quantum_ocular.c" \
+    "src/quantum/ocular/frame_ring.c" \
+    "src/kernel/trace/trace.c" \
+    "tests/unit/test_quantum_ocular.c")
+run_test "$quantum_ocular_unit_test"
+
+# Build and test the Ocular Frame Ring
+echo -e "\n${BLUE}Building and testing Ocular Frame Ring...${RESET}"
+frame_ring_test=$(build_component "frame_ring" \
+    "src/quantum/ocular/frame_ring.c" \
+    "src/quantum/messaging/quantum_message_bus.c" \
+    "src/kernel/trace/trace.c" \
+    "tests/unit/test_frame_ring.c")
+run_test "$frame_ring_test"
+
+# Build and test the Blink Spot Index
+echo -e "\n${BLUE}Building and testing Blink Spot Index...${RESET}"
+blink_index_test=$(build_component "blink_index" \
+    "src/quantum/teleport/blink_index.c" \
+    "tests/unit/test_blink_index.c")
+run_test "$blink_index_test"
+
+# Build and test the Quantum Teleportation System
+echo -e "\n${BLUE}Building and testing Quantum Teleportation System...${RESET}"
+quantum_teleport_test=$(build_component "quantum_teleport" \
+    "src/quantum/teleport/quantum_teleport.c" \
+    "src/quantum/teleport/blink_index.c" \
+    "src/quantum/messaging/quantum_message_bus.c" \
+    "src/kernel/trace/trace.c" \
+    "tests/unit/test_quantum_teleport.c")
+run_test "$quantum_teleport_test"
+
+# Build and test the Entanglement Registry
+echo -e "\n${BLUE}Building and testing Entanglement Registry...${RESET}"
+entanglement_registry_test=$(build_component "entanglement_registry" \
+    "src/quantum/entanglement/entanglement_registry.c" \
+    "tests/unit/test_entanglement_registry.c")
+run_test "$entanglement_registry_test"
+
+# Build and test the Reality Scene
+echo -e "\n${BLUE}Building and testing Reality Scene...${RESET}"
+qre_scene_test=$(build_component "qre_scene" \
+    "src/qre/qre_scene.c" \
+    "tests/unit/test_qre_scene.c")
+run_test "$qre_scene_test"
+
+# Build and test the Resonant Frequencies
+echo -e "\n${BLUE}Building and testing Resonant Frequencies...${RESET}"
+resonance_test=$(build_component "resonant_frequencies" \
+    "src/quantum/resonance/resonant_frequencies.c" \
+    "tests/unit/test_resonant_frequencies.c")
+run_test "$resonance_test"
+
+# Build and test the Quantum Reality Engine
+echo -e "\n${BLUE}Building and testing Quantum Reality Engine...${RESET}"
+qre_test=$(build_component "qre" \
+    "src/qre/qre.c" \
+    "src/qre/qre_scene.c" \
+    "src/quantum/entanglement/entanglement_manager.c" \
+    "src/quantum/entanglement/entanglement_registry.c" \
+    "src/kernel/trace/trace.c" \
+    "tests/unit/test_qre.c")
+run_test "$qre_test"
+
+# Build and test the Portal Gun
+echo -e "\n${BLUE}Building and testing Portal Gun...${RESET}"
+portal_gun_test=$(build_component "portal_gun" \
+    "src/quantum/portals/portal_gun.c" \
+    "src/quantum/entanglement/entanglement_manager.c" \
+    "src/quantum/entanglement/entanglement_registry.c" \
+    "src/kernel/trace/trace.c" \
+    "tests/unit/test_portal_gun.c")
+run_test "$portal_gun_test"
+
 echo -e "\n${GREEN}All build and tests completed successfully!${RESET}"
\ No newline at end of file
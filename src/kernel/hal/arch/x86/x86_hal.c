@@ -5,18 +5,53 @@
  * This file contains the implementation of the HAL for the x86 architecture.
  */
 
+/* mmap huge page flags and madvise under -std=c11 */
+#define _GNU_SOURCE
+
 #include "x86_hal.h"
 #include <string.h>
 #include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdatomic.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#include <cpuid.h>
+#define X86_HAS_TSC 1
+#endif
+
+/* How long the TSC is measured against the system clock */
+#define X86_TSC_CALIBRATION_NS 10000000ULL
 
-/* Static HAL operations structure for x86 */
-static HalOperations x86_hal_ops;
+/* Static HAL operations structure for x86; these are usable before init, which hal_init() calls */
+static HalOperations x86_hal_ops = {
+    .init = x86_hal_init,
+    .shutdown = x86_hal_shutdown,
+    .get_timestamp = x86_get_timestamp
+};
 
 /* CPU vendor strings */
 static const char* INTEL_VENDOR = "GenuineIntel";
 static const char* AMD_VENDOR = "AuthenticAMD";
 static const char* QUANTUM_VENDOR = "QuantumCPU"; /* Hypothetical quantum CPU vendor */
 
+/*
+ * TSC to nanoseconds
+ *
+ * Timestamps are the calibration's system clock time plus the cycles since
+ * then, scaled by a 32.32 fixed-point nanoseconds per cycle, so they carry
+ * on from CLOCK_MONOTONIC without a jump, then drift from it by the few
+ * parts per million the calibration is off. The scale stays 0 until the
+ * TSC has been calibrated, and timestamps come from the system clock until
+ * then.
+ */
+static uint64_t tsc_base_cycles = 0;
+static uint64_t tsc_base_ns = 0;
+static _Atomic uint64_t tsc_scale = 0;
+
 /**
  * @brief Execute CPUID instruction
  * 
@@ -59,6 +94,51 @@ static void x86_cpuid(X86CpuidParams* params) {
     }
 }
 
+/**
+ * @brief Read CLOCK_MONOTONIC in nanoseconds
+ */
+static uint64_t x86_monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Measure the TSC rate against the system clock
+ *
+ * Only an invariant TSC, which ticks at a constant rate through frequency
+ * and idle state changes, is used. Calibration happens once.
+ */
+static void x86_calibrate_tsc(void) {
+#ifdef X86_HAS_TSC
+    if (atomic_load(&tsc_scale) != 0) {
+        return;
+    }
+    
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 8))) {
+        printf("TSC is not invariant, timestamps use the system clock\n");
+        return;
+    }
+    
+    uint64_t start_ns = x86_monotonic_ns();
+    uint64_t start_cycles = __rdtsc();
+    uint64_t end_ns;
+    do {
+        end_ns = x86_monotonic_ns();
+    } while (end_ns - start_ns < X86_TSC_CALIBRATION_NS);
+    uint64_t end_cycles = __rdtsc();
+    if (end_cycles <= start_cycles) {
+        return;
+    }
+    
+    tsc_base_cycles = end_cycles;
+    tsc_base_ns = end_ns;
+    atomic_store_explicit(&tsc_scale, ((end_ns - start_ns) << 32) / (end_cycles - start_cycles),
+                          memory_order_release);
+#endif
+}
+
 /**
  * @brief Initialize the x86 HAL
  */
@@ -68,6 +148,9 @@ bool x86_hal_init(void) {
     x86_hal_ops.shutdown = x86_hal_shutdown;
     x86_hal_ops.get_processor_info = x86_get_processor_info;
     x86_hal_ops.get_memory_info = x86_get_memory_info;
+    x86_hal_ops.map_physical_memory = x86_map_physical_memory;
+    x86_hal_ops.unmap_physical_memory = x86_unmap_physical_memory;
+    x86_hal_ops.map_file = x86_map_file;
     x86_hal_ops.has_quantum_support = x86_has_quantum_support;
     
     /* In a real implementation, more functions would be initialized here */
@@ -91,6 +174,8 @@ bool x86_hal_init(void) {
         return false;
     }
     
+    x86_calibrate_tsc();
+    
     /* Initialization successful */
     printf("x86 HAL initialized with CPU vendor: %s\n", vendor);
     return true;
@@ -187,6 +272,16 @@ void x86_get_memory_info(HalMemoryInfo* info) {
     info->available_physical = 7ULL * 1024 * 1024 * 1024; /* 7 GB available */
     info->page_size = 4096; /* 4 KB pages */
     
+    /* In a real implementation, nodes would come from the ACPI SRAT */
+    /* For simulation, all memory and cores form a single node */
+    HalProcessorInfo processor_info;
+    x86_get_processor_info(&processor_info);
+    info->node_count = 1;
+    info->nodes[0].base = 0;
+    info->nodes[0].size = info->total_physical;
+    info->nodes[0].first_cpu = 0;
+    info->nodes[0].cpu_count = processor_info.core_count;
+    
     /* Quantum memory depends on hardware support */
     if (x86_has_quantum_support()) {
         info->total_quantum = 64; /* 64 qubits */
@@ -221,6 +316,138 @@ bool x86_has_quantum_support(void) {
     return (strcmp(vendor, QUANTUM_VENDOR) == 0);
 }
 
+/**
+ * @brief Convert HAL permissions to mmap protection bits
+ */
+static int x86_mmap_protection(uint32_t permissions) {
+    int protection = PROT_NONE;
+    if (permissions & HAL_MEM_READ) protection |= PROT_READ;
+    if (permissions & HAL_MEM_WRITE) protection |= PROT_WRITE;
+    if (permissions & HAL_MEM_EXEC) protection |= PROT_EXEC;
+    return protection;
+}
+
+/**
+ * @brief Map physical memory for x86
+ */
+HalVirtualAddr x86_map_physical_memory(HalPhysicalAddr phys, uint64_t size, uint32_t permissions) {
+    /* In a real implementation, this would install page table entries for phys */
+    /* For simulation, fresh anonymous memory stands in for the physical range */
+    (void)phys;
+    
+    uint64_t huge_size = 0;
+    if (permissions & HAL_MEM_HUGE_1G) {
+        huge_size = 1ULL << 30;
+    } else if (permissions & HAL_MEM_HUGE_2M) {
+        huge_size = 2ULL << 20;
+    }
+    if (size == 0 || (huge_size && size % huge_size != 0)) {
+        return NULL;
+    }
+    int protection = x86_mmap_protection(permissions);
+    
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+    /* Reserved huge pages first */
+    if (huge_size) {
+        int huge_shift = huge_size == (1ULL << 30) ? 30 : 21;
+        void* mapped = mmap(NULL, size, protection, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                            (huge_shift << MAP_HUGE_SHIFT), -1, 0);
+        if (mapped != MAP_FAILED) {
+            return mapped;
+        }
+    }
+#endif
+    
+    /* Otherwise ask for transparent huge pages on a huge page aligned range */
+    uint64_t length = size + huge_size;
+    uint8_t* mapped = mmap(NULL, length, protection, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED) {
+        return NULL;
+    }
+    if (!huge_size) {
+        return mapped;
+    }
+    
+    uint8_t* aligned = (uint8_t*)(((uintptr_t)mapped + huge_size - 1) & ~(uintptr_t)(huge_size - 1));
+    if (aligned > mapped) {
+        munmap(mapped, aligned - mapped);
+    }
+    if (aligned + size < mapped + length) {
+        munmap(aligned + size, mapped + length - (aligned + size));
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+    
+    return aligned;
+}
+
+/**
+ * @brief Unmap memory for x86
+ */
+void x86_unmap_physical_memory(HalVirtualAddr virt, uint64_t size) {
+    if (virt && size) {
+        munmap(virt, size);
+    }
+}
+
+/**
+ * @brief Map a file for x86
+ */
+HalVirtualAddr x86_map_file(const char* path, uint64_t offset, uint64_t* size, uint32_t permissions) {
+    if (!path || !size) {
+        return NULL;
+    }
+    
+    bool writable = (permissions & HAL_MEM_WRITE) != 0;
+    int fd = open(path, writable ? O_RDWR : O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || offset >= (uint64_t)file_stat.st_size ||
+        *size > (uint64_t)file_stat.st_size - offset) {
+        close(fd);
+        return NULL;
+    }
+    uint64_t length = *size ? *size : (uint64_t)file_stat.st_size - offset;
+    
+    /* Writable mappings are shared so changes reach the file */
+    void* mapped = mmap(NULL, length, x86_mmap_protection(permissions),
+                        writable ? MAP_SHARED : MAP_PRIVATE, fd, (off_t)offset);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return NULL;
+    }
+    
+    *size = length;
+    return mapped;
+}
+
+/**
+ * @brief Get the current timestamp for x86
+ */
+uint64_t x86_get_timestamp(void) {
+#ifdef X86_HAS_TSC
+    uint64_t scale = atomic_load_explicit(&tsc_scale, memory_order_acquire);
+    if (scale != 0) {
+        /* Split the multiply so cycles * scale cannot overflow */
+        uint64_t cycles = __rdtsc() - tsc_base_cycles;
+        return tsc_base_ns + (cycles >> 32) * scale + (((cycles & 0xffffffffULL) * scale) >> 32);
+    }
+#endif
+    return x86_monotonic_ns();
+}
+
+/**
+ * @brief Install the physical page allocator for x86
+ */
+void x86_set_page_allocator(HalPhysicalAddr (*alloc_page)(void), void (*free_page)(HalPhysicalAddr addr)) {
+    x86_hal_ops.alloc_physical_page = alloc_page;
+    x86_hal_ops.free_physical_page = free_page;
+}
+
 /**
  * @brief Get the x86 HAL operations
  */
@@ -87,4 +87,51 @@ void x86_get_memory_info(HalMemoryInfo* info);
  */
 bool x86_has_quantum_support(void);
 
+/**
+ * @brief Map physical memory for x86
+ * 
+ * @param phys Physical address to map
+ * @param size Size to map in bytes
+ * @param permissions HAL_MEM_* permissions, optionally with a huge page size
+ * @return Mapped virtual address or NULL on failure
+ */
+HalVirtualAddr x86_map_physical_memory(HalPhysicalAddr phys, uint64_t size, uint32_t permissions);
+
+/**
+ * @brief Unmap memory mapped by x86_map_physical_memory() or x86_map_file()
+ * 
+ * @param virt Mapped virtual address
+ * @param size Size of the mapping in bytes
+ */
+void x86_unmap_physical_memory(HalVirtualAddr virt, uint64_t size);
+
+/**
+ * @brief Map a file for x86
+ * 
+ * @param path Path of the file
+ * @param offset Offset of the mapping in the file (multiple of the page size)
+ * @param size Size to map in bytes; 0 maps to the end of the file and stores the size
+ * @param permissions HAL_MEM_* permissions; writable mappings write through to the file
+ * @return Mapped virtual address or NULL on failure
+ */
+HalVirtualAddr x86_map_file(const char* path, uint64_t offset, uint64_t* size, uint32_t permissions);
+
+/**
+ * @brief Get the current timestamp for x86
+ * 
+ * Reads the TSC once x86_hal_init() has calibrated it, and CLOCK_MONOTONIC
+ * before that or when the TSC is not invariant.
+ * 
+ * @return Timestamp in nanoseconds
+ */
+uint64_t x86_get_timestamp(void);
+
+/**
+ * @brief Install the physical page allocator for x86
+ * 
+ * @param alloc_page Page allocation function (NULL to remove)
+ * @param free_page Page free function (NULL to remove)
+ */
+void x86_set_page_allocator(HalPhysicalAddr (*alloc_page)(void), void (*free_page)(HalPhysicalAddr addr));
+
 #endif /* CTRLXT_X86_HAL_H */
\ No newline at end of file
@@ -7,6 +7,7 @@
  */
 
 #include "hal.h"
+#include <stddef.h>
 #include "arch/x86/x86_hal.h"
 /* Include other architectures as they are implemented */
 /* #include "arch/arm/arm_hal.h" */
@@ -84,6 +85,17 @@ void hal_shutdown(void) {
     ops->shutdown();
 }
 
+/**
+ * @brief Install the physical page allocator behind the HAL page operations
+ */
+void hal_set_page_allocator(HalPhysicalAddr (*alloc_page)(void), void (*free_page)(HalPhysicalAddr addr)) {
+    /* Make sure we've detected the architecture */
+    hal_get_operations();
+    
+    /* For now, we'll just assume x86 architecture */
+    x86_set_page_allocator(alloc_page, free_page);
+}
+
 /**
  * @brief Get the architecture name
  */
@@ -23,6 +23,8 @@
 #define HAL_MEM_QUANTUM   0x08    /**< Memory allows quantum operations */
 #define HAL_MEM_ENTANGLED 0x10    /**< Memory is quantum-entangled */
 #define HAL_MEM_SECURED   0x20    /**< Memory is secured against tampering */
+#define HAL_MEM_HUGE_2M   0x100   /**< Map with 2MB pages (size must be a multiple of 2MB) */
+#define HAL_MEM_HUGE_1G   0x200   /**< Map with 1GB pages (size must be a multiple of 1GB) */
 
 /**
  * @brief Processor information structure
@@ -40,6 +42,24 @@ typedef struct {
     NodeLevel resonance_level; /**< Processor's resonance level */
 } HalProcessorInfo;
 
+/**
+ * @brief Maximum number of memory nodes the HAL reports
+ */
+#define HAL_MAX_MEMORY_NODES 8
+
+/**
+ * @brief Memory node (NUMA node) structure
+ *
+ * A node is a range of physical memory together with the processors that
+ * reach it without crossing an interconnect.
+ */
+typedef struct {
+    uint64_t base;               /**< Physical address of the node's first byte */
+    uint64_t size;               /**< Size of the node's memory in bytes */
+    uint32_t first_cpu;          /**< First processor local to the node */
+    uint32_t cpu_count;          /**< Number of processors local to the node */
+} HalMemoryNode;
+
 /**
  * @brief Memory information structure
  */
@@ -52,6 +72,8 @@ typedef struct {
     bool supports_entanglement;  /**< Whether memory supports quantum entanglement */
     uint32_t entanglement_limit; /**< Maximum entangled memory regions */
     NodeLevel resonance_level;   /**< Memory's resonance level */
+    uint32_t node_count;         /**< Number of memory nodes (0 if unknown) */
+    HalMemoryNode nodes[HAL_MAX_MEMORY_NODES]; /**< Memory nodes, in address order */
 } HalMemoryInfo;
 
 /**
@@ -89,6 +111,7 @@ typedef struct {
     HalVirtualAddr (*map_physical_memory)(HalPhysicalAddr phys, uint64_t size, uint32_t permissions); /**< Map physical memory to virtual memory */
     void (*unmap_physical_memory)(HalVirtualAddr virt, uint64_t size);  /**< Unmap physical memory */
     void (*set_memory_permissions)(HalVirtualAddr addr, uint64_t size, uint32_t permissions); /**< Set memory region permissions */
+    HalVirtualAddr (*map_file)(const char* path, uint64_t offset, uint64_t* size, uint32_t permissions); /**< Map a file (size 0 maps to the end of the file and returns the size) */
     
     /* Interrupt functions */
     void (*enable_interrupts)(void);                    /**< Enable interrupts */
@@ -137,6 +160,17 @@ bool hal_init(void);
  */
 void hal_shutdown(void);
 
+/**
+ * @brief Install the physical page allocator behind the HAL page operations
+ * 
+ * The memory manager owns physical memory; it installs its page allocator
+ * here so alloc_physical_page/free_physical_page hand out pages it tracks.
+ * 
+ * @param alloc_page Page allocation function (NULL to remove)
+ * @param free_page Page free function (NULL to remove)
+ */
+void hal_set_page_allocator(HalPhysicalAddr (*alloc_page)(void), void (*free_page)(HalPhysicalAddr addr));
+
 /**
  * @brief Get the architecture name
  * 
@@ -8,6 +8,7 @@
 
 #include "kernel.h"
 #include "hal/hal.h"
+#include "trace/trace.h"
 #include <stdio.h>
 
 /* Kernel state variables */
@@ -43,6 +44,11 @@ bool kernel_init(ArchitectureType arch, uint64_t memory_limit) {
         return false;
     }
     
+    /* Trace events share the hardware clock */
+    if (hal_ops->get_timestamp) {
+        trace_set_clock(hal_ops->get_timestamp);
+    }
+    
     /* Detect available memory */
     HalMemoryInfo mem_info;
     if (hal_ops->get_memory_info) {
@@ -3,10 +3,20 @@
  * @brief Kernel Memory Management System implementation
  */
 
+/* pthread_mutex_trylock under -std=c11 */
+#define _XOPEN_SOURCE 700
+
 #include "memory_manager.h"
+#include "../../quantum/entanglement/entanglement_registry.h"
+#include "../trace/trace.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 /* Memory management state */
 static bool mm_initialized = false;
@@ -17,99 +27,1156 @@ static MemoryStats mm_stats = {0};
 static MemoryRegion* mm_regions_head = NULL;
 static uint32_t mm_next_region_id = 1;
 
-/* Entanglement table */
-#define MAX_ENTANGLEMENTS 256
-static EntanglementInfo mm_entanglements[MAX_ENTANGLEMENTS];
-static uint64_t mm_next_entanglement_id = 1;
+/*
+ * Memory region index
+ *
+ * Regions are also kept in an AVL tree ordered by start address. Every node
+ * records the highest end address in its subtree, which makes it an
+ * interval tree: lookups and overlap queries skip subtrees that end before
+ * the address of interest. The region found by the last lookup is checked
+ * first, since callers tend to look up the same region repeatedly.
+ */
+static MemoryRegion* mm_region_root = NULL;
+static MemoryRegion* mm_last_region = NULL;
+
+/*
+ * Physical page allocator
+ *
+ * Free physical memory is kept by a buddy allocator: a free block of order k
+ * is 2^k pages, starts on a 2^k page boundary relative to the zone base, and
+ * is linked into the free list of its order through per-page link arrays
+ * (the simulated physical memory itself cannot hold the links). Freeing a
+ * block merges it with its buddy for as long as the buddy is free too.
+ *
+ * Single-page allocations go through small per-CPU caches that refill from
+ * and drain to the zone in batches, so the common case never takes the zone
+ * lock. The zone sees cached pages as allocated; they are tracked in a
+ * separate array, written only under the cache locks, and count as free in
+ * the statistics.
+ *
+ * Every memory node has a zone of its own, and a CPU's cache only holds
+ * pages of the CPU's node. Pages of another node go through the cache of
+ * that node's first CPU, or straight to its zone if it has no CPUs.
+ */
+#define MM_BUDDY_ORDERS 19                 /**< Largest block is 2^18 pages */
+#define MM_MAX_CPUS 16                     /**< CPUs with their own caches */
+#define MM_PAGE_CACHE_SIZE 64              /**< Pages a cache holds before draining */
+#define MM_PAGE_CACHE_BATCH 16             /**< Pages moved per refill or drain */
+
+#define BUDDY_NONE UINT32_MAX
+#define BUDDY_PAGE_ORDER_MASK 0x1F         /**< Order of the block starting at the page */
+#define BUDDY_PAGE_ALLOCATED 0x40          /**< First page of an allocated block */
+#define BUDDY_PAGE_FREE 0x80               /**< First page of a free block */
+
+typedef struct {
+    HalPhysicalAddr base;                  /**< Physical address of page 0 */
+    uint32_t page_size;
+    uint32_t page_count;
+    uint32_t max_order;                    /**< Orders 0..max_order-1 are in use */
+    uint32_t* next;                        /**< Free list links, by page */
+    uint32_t* prev;
+    uint8_t* state;                        /**< BUDDY_PAGE_* flags and order, by page */
+    bool* cached;                          /**< Whether a page is held by a page cache, by page */
+    uint32_t free_heads[MM_BUDDY_ORDERS];
+    uint32_t free_counts[MM_BUDDY_ORDERS];
+    uint32_t nonempty;                     /**< Bit k set while order k has a free block */
+    HalPhysicalAddr start;                 /**< First usable address */
+    HalPhysicalAddr end;                   /**< End of the usable addresses */
+    uint64_t allocated;                    /**< Bytes handed out, including cached pages */
+    uint64_t contention;                   /**< Times the lock was already held */
+    pthread_mutex_t lock;
+} BuddyZone;
+
+typedef struct {
+    pthread_mutex_t lock;
+    uint32_t pages[MM_PAGE_CACHE_SIZE];    /**< Cached page indexes */
+    uint32_t count;
+    uint64_t hits;
+    uint64_t misses;
+} PageCache;
+
+static BuddyZone mm_zones[MM_MAX_NODES];
+static uint32_t mm_node_count = 1;
+static uint32_t mm_page_size = 4096;
+static PageCache mm_page_caches[MM_MAX_CPUS];
+static uint32_t mm_cpu_count = 1;
+static atomic_uint mm_next_cpu = 0;
+static _Thread_local int mm_thread_cpu = -1;
+
+/* Node topology and placement counters */
+static uint32_t mm_cpu_node[MM_MAX_CPUS];
+static uint32_t mm_node_first_cpu[MM_MAX_NODES];    /**< UINT32_MAX for nodes without CPUs */
+static atomic_uint mm_next_interleave_node = 0;
+static atomic_uint_fast64_t mm_node_allocations[MM_MAX_NODES];
+static atomic_uint_fast64_t mm_node_fallbacks[MM_MAX_NODES];
+
+/*
+ * Small object allocator
+ *
+ * Virtual allocations of up to MM_SLAB_MAX_OBJECT bytes are carved out of
+ * slabs instead of getting a buffer and a region of their own. A slab is a
+ * single MM_SLAB_SIZE region split into objects of one size class, with a
+ * bitmap of the objects in use kept outside the slab. Each CPU keeps the
+ * slabs it has allocated from that still have free objects on a list per
+ * size class; a slab that fills up leaves the list and rejoins it when an
+ * object is freed. Slabs only serve allocations of the type and flags they
+ * were created with, and quantum or entangled memory never uses them, since
+ * entanglement works on whole regions.
+ *
+ * Objects count as regions in the statistics. Their counters are kept per
+ * CPU and added up by mm_get_stats().
+ */
+#define MM_SLAB_SIZE (64 * 1024)           /**< Bytes per slab */
+#define MM_SLAB_MIN_SHIFT 4                /**< Smallest size class is 16 bytes */
+#define MM_SLAB_CLASSES 8                  /**< Size classes 16, 32, ... 2048 bytes */
+#define MM_SLAB_MAX_OBJECT (1u << (MM_SLAB_MIN_SHIFT + MM_SLAB_CLASSES - 1))
+#define MM_SLAB_BITMAP_WORDS (MM_SLAB_SIZE / (1u << MM_SLAB_MIN_SHIFT) / 64)
+
+struct SlabCache;
+
+typedef struct MemorySlab {
+    MemoryRegion region;                   /**< Region covering the whole slab */
+    MemoryRegion object_view;              /**< Region describing the last object looked up */
+    struct SlabCache* cache;               /**< Cache the slab belongs to */
+    struct MemorySlab* next;               /**< Next slab on the cache's partial list */
+    struct MemorySlab* prev;               /**< Previous slab on the cache's partial list */
+    bool partial;                          /**< Whether the slab is on the partial list */
+    uint32_t size_class;
+    uint32_t object_size;
+    uint32_t object_count;
+    uint32_t used;                         /**< Objects in use */
+    uint32_t hint;                         /**< Bitmap word to search first */
+    uint64_t bitmap[MM_SLAB_BITMAP_WORDS]; /**< Bit set for every object in use */
+} MemorySlab;
+
+typedef struct SlabCache {
+    pthread_mutex_t lock;
+    MemorySlab* partial[MM_SLAB_CLASSES];  /**< Slabs with free objects, by size class */
+    uint32_t objects;                      /**< Objects in use */
+    uint64_t used_virtual;                 /**< Bytes in use */
+    uint64_t used_physical;                /**< Bytes in use by RAM and shared memory objects */
+} SlabCache;
+
+static SlabCache mm_slab_caches[MM_MAX_CPUS];
+
+/* Guards the region list and index, which slab creation reaches from any CPU */
+static pthread_mutex_t mm_region_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Entanglements are QEREG_KIND_MEMORY entries of the shared registry */
+#define MAX_ENTANGLEMENTS 256
+
+/*
+ * Entanglement change tracking
+ *
+ * Each entanglement slot has a bitmap with one bit per MM_SYNC_BLOCK_SIZE
+ * block of the synchronized length, allocated on the first mm_mark_dirty().
+ * Synchronization copies the runs of marked blocks and clears them. Long
+ * runs are copied with non-temporal stores so a large sync does not evict
+ * the caches; the stores are fenced once per batch.
+ */
+#define MM_SYNC_BLOCK_SIZE 4096
+#define MM_SYNC_STREAM_MIN (256 * 1024)    /**< Shortest run copied with non-temporal stores */
+
+typedef struct {
+    uint64_t* dirty;                       /**< Bit set for every changed block */
+    uint32_t block_count;
+    bool tracked;                          /**< Whether any block was ever marked */
+} EntanglementDirty;
+
+/**
+ * @brief Registry payload of a memory entanglement
+ */
+typedef struct {
+    EntanglementInfo info;                 /**< Must stay first; lookups return it */
+    EntanglementDirty dirty;
+} MemoryEntanglement;
+
+_Static_assert(sizeof(MemoryEntanglement) <= QEREG_PAYLOAD_SIZE, "entanglement must fit a registry payload");
+
+/**
+ * @brief Get the address just past the end of a region
+ */
+static uintptr_t region_end(const MemoryRegion* region) {
+    return (uintptr_t)region->start + region->size;
+}
+
+/**
+ * @brief Find a memory region containing the given address
+ */
+static MemoryRegion* find_region(HalVirtualAddr addr) {
+    uintptr_t key = (uintptr_t)addr;
+    
+    pthread_mutex_lock(&mm_region_lock);
+    MemoryRegion* region = mm_last_region;
+    if (!region || key < (uintptr_t)region->start || key >= region_end(region)) {
+        /* A containing region is to the left whenever the left subtree reaches past the address */
+        region = NULL;
+        MemoryRegion* node = mm_region_root;
+        while (node) {
+            if (key >= (uintptr_t)node->start && key < region_end(node)) {
+                region = node;
+                mm_last_region = node;
+                break;
+            }
+            if (node->tree_left && node->tree_left->subtree_end > key) {
+                node = node->tree_left;
+            } else if (key >= (uintptr_t)node->start) {
+                node = node->tree_right;
+            } else {
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&mm_region_lock);
+    
+    return region;
+}
+
+/**
+ * @brief Whether a region sorts before another in the index
+ *
+ * Regions are ordered by start address; regions with equal starts are
+ * ordered by their own address, so every region has its own position.
+ */
+static bool region_before(const MemoryRegion* a, const MemoryRegion* b) {
+    if (a->start != b->start) {
+        return (uintptr_t)a->start < (uintptr_t)b->start;
+    }
+    
+    return (uintptr_t)a < (uintptr_t)b;
+}
+
+/**
+ * @brief Get the height of a region subtree
+ */
+static int32_t tree_height(const MemoryRegion* node) {
+    return node ? node->tree_height : 0;
+}
+
+/**
+ * @brief Recompute a node's height and subtree end from its children
+ */
+static void tree_update(MemoryRegion* node) {
+    int32_t left_height = tree_height(node->tree_left);
+    int32_t right_height = tree_height(node->tree_right);
+    node->tree_height = 1 + (left_height > right_height ? left_height : right_height);
+    
+    node->subtree_end = region_end(node);
+    if (node->tree_left && node->tree_left->subtree_end > node->subtree_end) {
+        node->subtree_end = node->tree_left->subtree_end;
+    }
+    if (node->tree_right && node->tree_right->subtree_end > node->subtree_end) {
+        node->subtree_end = node->tree_right->subtree_end;
+    }
+}
+
+/**
+ * @brief Rotate a subtree left or right
+ *
+ * @return New root of the subtree
+ */
+static MemoryRegion* tree_rotate(MemoryRegion* node, bool left) {
+    MemoryRegion* pivot;
+    if (left) {
+        pivot = node->tree_right;
+        node->tree_right = pivot->tree_left;
+        pivot->tree_left = node;
+    } else {
+        pivot = node->tree_left;
+        node->tree_left = pivot->tree_right;
+        pivot->tree_right = node;
+    }
+    
+    tree_update(node);
+    tree_update(pivot);
+    return pivot;
+}
+
+/**
+ * @brief Restore the AVL balance of a subtree after a change below it
+ *
+ * @return New root of the subtree
+ */
+static MemoryRegion* tree_rebalance(MemoryRegion* node) {
+    tree_update(node);
+    int32_t balance = tree_height(node->tree_left) - tree_height(node->tree_right);
+    
+    if (balance > 1) {
+        if (tree_height(node->tree_left->tree_left) < tree_height(node->tree_left->tree_right)) {
+            node->tree_left = tree_rotate(node->tree_left, true);
+        }
+        return tree_rotate(node, false);
+    }
+    if (balance < -1) {
+        if (tree_height(node->tree_right->tree_right) < tree_height(node->tree_right->tree_left)) {
+            node->tree_right = tree_rotate(node->tree_right, false);
+        }
+        return tree_rotate(node, true);
+    }
+    
+    return node;
+}
+
+/**
+ * @brief Insert a region into a subtree
+ *
+ * @return New root of the subtree
+ */
+static MemoryRegion* tree_insert(MemoryRegion* node, MemoryRegion* region) {
+    if (!node) {
+        region->tree_left = NULL;
+        region->tree_right = NULL;
+        tree_update(region);
+        return region;
+    }
+    
+    if (region_before(region, node)) {
+        node->tree_left = tree_insert(node->tree_left, region);
+    } else {
+        node->tree_right = tree_insert(node->tree_right, region);
+    }
+    
+    return tree_rebalance(node);
+}
+
+/**
+ * @brief Detach the leftmost node of a subtree
+ *
+ * @param min Set to the detached node
+ * @return New root of the subtree
+ */
+static MemoryRegion* tree_remove_min(MemoryRegion* node, MemoryRegion** min) {
+    if (!node->tree_left) {
+        *min = node;
+        return node->tree_right;
+    }
+    
+    node->tree_left = tree_remove_min(node->tree_left, min);
+    return tree_rebalance(node);
+}
+
+/**
+ * @brief Remove a region from a subtree
+ *
+ * @return New root of the subtree
+ */
+static MemoryRegion* tree_remove(MemoryRegion* node, MemoryRegion* region) {
+    if (!node) {
+        return NULL;
+    }
+    
+    if (node != region) {
+        if (region_before(region, node)) {
+            node->tree_left = tree_remove(node->tree_left, region);
+        } else {
+            node->tree_right = tree_remove(node->tree_right, region);
+        }
+        return tree_rebalance(node);
+    }
+    
+    if (!node->tree_left || !node->tree_right) {
+        return node->tree_left ? node->tree_left : node->tree_right;
+    }
+    
+    /* Replace the node with its in-order successor */
+    MemoryRegion* successor;
+    MemoryRegion* right = tree_remove_min(node->tree_right, &successor);
+    successor->tree_left = node->tree_left;
+    successor->tree_right = right;
+    return tree_rebalance(successor);
+}
+
+/**
+ * @brief Collect the regions of a subtree that overlap [start, end), in address order
+ */
+static void tree_collect(MemoryRegion* node, uintptr_t start, uintptr_t end,
+                         MemoryRegion** regions, uint32_t max_count, uint32_t* count) {
+    if (!node || node->subtree_end <= start || *count >= max_count) {
+        return;
+    }
+    
+    tree_collect(node->tree_left, start, end, regions, max_count, count);
+    if ((uintptr_t)node->start >= end) {
+        return;
+    }
+    if (region_end(node) > start && *count < max_count) {
+        regions[(*count)++] = node;
+    }
+    tree_collect(node->tree_right, start, end, regions, max_count, count);
+}
+
+/**
+ * @brief Find an entanglement by ID
+ */
+static EntanglementInfo* find_entanglement(uint64_t entanglement_id) {
+    MemoryEntanglement* entanglement = qereg_find(QEREG_KIND_MEMORY, entanglement_id);
+    return entanglement ? &entanglement->info : NULL;
+}
+
+/**
+ * @brief Get the change tracking state of an entanglement
+ */
+static EntanglementDirty* entanglement_dirty(const EntanglementInfo* entanglement) {
+    return &((MemoryEntanglement*)entanglement)->dirty;
+}
+
+/**
+ * @brief Release an entanglement's change tracking state
+ */
+static void reset_entanglement_dirty(EntanglementDirty* dirty) {
+    free(dirty->dirty);
+    memset(dirty, 0, sizeof(EntanglementDirty));
+}
+
+/**
+ * @brief Release a registry payload's change tracking state
+ */
+static void release_entanglement(void* payload) {
+    reset_entanglement_dirty(&((MemoryEntanglement*)payload)->dirty);
+}
+
+/**
+ * @brief Get the number of bytes an entanglement keeps synchronized
+ */
+static uint64_t sync_length(const EntanglementInfo* entanglement) {
+    return (entanglement->first_region->size < entanglement->second_region->size) ?
+           entanglement->first_region->size : entanglement->second_region->size;
+}
+
+/**
+ * @brief Copy memory for synchronization
+ *
+ * Long, 16-byte aligned copies bypass the caches; the caller fences them.
+ */
+static void sync_copy(void* dst, const void* src, uint64_t size) {
+#if defined(__SSE2__)
+    if (size >= MM_SYNC_STREAM_MIN && ((uintptr_t)dst & 15) == 0 && ((uintptr_t)src & 15) == 0) {
+        __m128i* out = (__m128i*)dst;
+        const __m128i* in = (const __m128i*)src;
+        uint64_t vectors = size / 64 * 4;
+        for (uint64_t i = 0; i < vectors; i += 4) {
+            __m128i a = _mm_load_si128(in + i);
+            __m128i b = _mm_load_si128(in + i + 1);
+            __m128i c = _mm_load_si128(in + i + 2);
+            __m128i d = _mm_load_si128(in + i + 3);
+            _mm_stream_si128(out + i, a);
+            _mm_stream_si128(out + i + 1, b);
+            _mm_stream_si128(out + i + 2, c);
+            _mm_stream_si128(out + i + 3, d);
+        }
+        memcpy(out + vectors, in + vectors, size - vectors * 16);
+        return;
+    }
+#endif
+    memcpy(dst, src, size);
+}
+
+/**
+ * @brief Copy an entanglement's source region over its destination
+ *
+ * The region with the higher resonance level is the source.
+ *
+ * @return Number of bytes copied
+ */
+static uint64_t sync_regions(EntanglementInfo* entanglement) {
+    MemoryRegion* source = entanglement->first_region;
+    MemoryRegion* destination = entanglement->second_region;
+    if (source->resonance_level < destination->resonance_level) {
+        source = entanglement->second_region;
+        destination = entanglement->first_region;
+    }
+    
+    uint64_t length = sync_length(entanglement);
+    EntanglementDirty* dirty = entanglement_dirty(entanglement);
+    if (!dirty->tracked) {
+        sync_copy(destination->start, source->start, length);
+        return length;
+    }
+    
+    /* Copy each run of changed blocks in one go, skipping clean words */
+    uint64_t copied = 0;
+    uint32_t block = 0;
+    while (block < dirty->block_count) {
+        uint64_t word = dirty->dirty[block / 64] >> (block % 64);
+        if (word == 0) {
+            block = (block / 64 + 1) * 64;
+            continue;
+        }
+        block += (uint32_t)__builtin_ctzll(word);
+        
+        uint32_t first = block;
+        while (block < dirty->block_count && (dirty->dirty[block / 64] >> (block % 64)) & 1) {
+            block++;
+        }
+        uint64_t offset = (uint64_t)first * MM_SYNC_BLOCK_SIZE;
+        uint64_t end = (uint64_t)block * MM_SYNC_BLOCK_SIZE < length ? (uint64_t)block * MM_SYNC_BLOCK_SIZE : length;
+        sync_copy((uint8_t*)destination->start + offset, (const uint8_t*)source->start + offset, end - offset);
+        copied += end - offset;
+    }
+    memset(dirty->dirty, 0, (dirty->block_count + 63) / 64 * sizeof(uint64_t));
+    
+    return copied;
+}
+
+/**
+ * @brief Add a memory region to the linked list and the index
+ */
+static void add_region(MemoryRegion* region) {
+    pthread_mutex_lock(&mm_region_lock);
+    
+    /* Add to the start of the list for simplicity */
+    region->next = mm_regions_head;
+    region->prev = NULL;
+    
+    if (mm_regions_head) {
+        mm_regions_head->prev = region;
+    }
+    
+    mm_regions_head = region;
+    mm_region_root = tree_insert(mm_region_root, region);
+    
+    /* Slabs are counted through the objects carved from them */
+    if (!region->slab) {
+        mm_stats.total_regions++;
+    }
+    
+    pthread_mutex_unlock(&mm_region_lock);
+}
+
+/**
+ * @brief Remove a memory region from the linked list and the index
+ */
+static void remove_region(MemoryRegion* region) {
+    pthread_mutex_lock(&mm_region_lock);
+    
+    if (region->prev) {
+        region->prev->next = region->next;
+    } else {
+        mm_regions_head = region->next;
+    }
+    
+    if (region->next) {
+        region->next->prev = region->prev;
+    }
+    
+    mm_region_root = tree_remove(mm_region_root, region);
+    if (mm_last_region == region) {
+        mm_last_region = NULL;
+    }
+    if (!region->slab) {
+        mm_stats.total_regions--;
+    }
+    
+    pthread_mutex_unlock(&mm_region_lock);
+}
+
+/**
+ * @brief Acquire a zone's lock, counting contention
+ */
+static void zone_lock(BuddyZone* zone) {
+    if (pthread_mutex_trylock(&zone->lock) != 0) {
+        pthread_mutex_lock(&zone->lock);
+        zone->contention++;
+    }
+}
+
+/**
+ * @brief Link a free block into the free list of its order
+ */
+static void zone_push(BuddyZone* zone, uint32_t page, uint32_t order) {
+    zone->state[page] = (uint8_t)(BUDDY_PAGE_FREE | order);
+    zone->prev[page] = BUDDY_NONE;
+    zone->next[page] = zone->free_heads[order];
+    if (zone->free_heads[order] != BUDDY_NONE) {
+        zone->prev[zone->free_heads[order]] = page;
+    }
+    zone->free_heads[order] = page;
+    zone->free_counts[order]++;
+    zone->nonempty |= 1u << order;
+}
+
+/**
+ * @brief Unlink a free block from the free list of its order
+ */
+static void zone_unlink(BuddyZone* zone, uint32_t page, uint32_t order) {
+    if (zone->prev[page] != BUDDY_NONE) {
+        zone->next[zone->prev[page]] = zone->next[page];
+    } else {
+        zone->free_heads[order] = zone->next[page];
+    }
+    if (zone->next[page] != BUDDY_NONE) {
+        zone->prev[zone->next[page]] = zone->prev[page];
+    }
+    
+    zone->state[page] = 0;
+    if (--zone->free_counts[order] == 0) {
+        zone->nonempty &= ~(1u << order);
+    }
+}
+
+/**
+ * @brief Set up a zone covering [start, end), all of it free
+ *
+ * The zone base is rounded down to the largest block size, so block
+ * alignment within the zone is physical alignment too; pages below start
+ * are never free. Physical page 0 is never handed out, so 0 can mean
+ * failure.
+ */
+static bool zone_init(BuddyZone* zone, HalPhysicalAddr start, HalPhysicalAddr end, uint32_t page_size) {
+    memset(zone, 0, sizeof(*zone));
+    zone->page_size = page_size;
+    for (uint32_t order = 0; order < MM_BUDDY_ORDERS; order++) {
+        zone->free_heads[order] = BUDDY_NONE;
+    }
+    pthread_mutex_init(&zone->lock, NULL);
+    
+    HalPhysicalAddr largest_block = (HalPhysicalAddr)page_size << (MM_BUDDY_ORDERS - 1);
+    zone->base = start & ~(largest_block - 1);
+    uint64_t first_page = (start - zone->base + page_size - 1) / page_size;
+    if (zone->base == 0 && first_page == 0) {
+        first_page = 1;
+    }
+    uint64_t page_count = end > zone->base ? (end - zone->base) / page_size : 0;
+    if (page_count >= BUDDY_NONE) {
+        page_count = BUDDY_NONE - 1;
+    }
+    if (page_count <= first_page) {
+        return true;
+    }
+    
+    zone->next = (uint32_t*)malloc(page_count * sizeof(uint32_t));
+    zone->prev = (uint32_t*)malloc(page_count * sizeof(uint32_t));
+    zone->state = (uint8_t*)calloc(page_count, sizeof(uint8_t));
+    zone->cached = (bool*)calloc(page_count, sizeof(bool));
+    if (!zone->next || !zone->prev || !zone->state || !zone->cached) {
+        free(zone->next);
+        free(zone->prev);
+        free(zone->state);
+        free(zone->cached);
+        zone->next = NULL;
+        zone->prev = NULL;
+        zone->state = NULL;
+        zone->cached = NULL;
+        return false;
+    }
+    zone->page_count = (uint32_t)page_count;
+    zone->max_order = MM_BUDDY_ORDERS;
+    zone->start = zone->base + first_page * page_size;
+    zone->end = zone->base + page_count * page_size;
+    
+    /* Carve the range into the largest aligned blocks */
+    uint32_t page = (uint32_t)first_page;
+    while (page < zone->page_count) {
+        uint32_t order = MM_BUDDY_ORDERS - 1;
+        while (order > 0 && ((page & ((1u << order) - 1)) != 0 || zone->page_count - page < (1u << order))) {
+            order--;
+        }
+        zone_push(zone, page, order);
+        page += 1u << order;
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Release a zone's metadata
+ */
+static void zone_destroy(BuddyZone* zone) {
+    free(zone->next);
+    free(zone->prev);
+    free(zone->state);
+    free(zone->cached);
+    pthread_mutex_destroy(&zone->lock);
+    memset(zone, 0, sizeof(*zone));
+}
+
+/**
+ * @brief Take a block of the given order from a zone
+ *
+ * Caller must hold the zone lock.
+ *
+ * @return First page of the block, or BUDDY_NONE if no block is free
+ */
+static uint32_t zone_alloc(BuddyZone* zone, uint32_t order) {
+    if (order >= zone->max_order) {
+        return BUDDY_NONE;
+    }
+    
+    /* Smallest order with a free block that is large enough */
+    uint32_t candidates = zone->nonempty & ~((1u << order) - 1);
+    if (candidates == 0) {
+        return BUDDY_NONE;
+    }
+    uint32_t found = (uint32_t)__builtin_ctz(candidates);
+    uint32_t page = zone->free_heads[found];
+    zone_unlink(zone, page, found);
+    
+    /* Give back the upper halves until the block is the requested size */
+    while (found > order) {
+        found--;
+        zone_push(zone, page + (1u << found), found);
+    }
+    
+    zone->state[page] = (uint8_t)(BUDDY_PAGE_ALLOCATED | order);
+    zone->allocated += (uint64_t)zone->page_size << order;
+    
+    return page;
+}
+
+/**
+ * @brief Return a block to a zone, merging it with free buddies
+ *
+ * Caller must hold the zone lock.
+ */
+static void zone_free(BuddyZone* zone, uint32_t page, uint32_t order) {
+    zone->allocated -= (uint64_t)zone->page_size << order;
+    
+    while (order + 1 < zone->max_order) {
+        uint32_t buddy = page ^ (1u << order);
+        if (buddy >= zone->page_count || zone->state[buddy] != (BUDDY_PAGE_FREE | order)) {
+            break;
+        }
+        zone_unlink(zone, buddy, order);
+        page &= ~(1u << order);
+        order++;
+    }
+    
+    zone_push(zone, page, order);
+}
+
+/**
+ * @brief Get the CPU whose caches the calling thread uses
+ *
+ * Threads are spread over the CPUs round-robin on first use.
+ */
+static uint32_t local_cpu(void) {
+    if (mm_thread_cpu < 0) {
+        mm_thread_cpu = (int)(atomic_fetch_add(&mm_next_cpu, 1) % MM_MAX_CPUS);
+    }
+    
+    return (uint32_t)mm_thread_cpu % mm_cpu_count;
+}
+
+/**
+ * @brief Get the page cache that holds a node's pages for the calling thread
+ *
+ * @return The calling CPU's cache if it is on the node, else the cache of
+ *         the node's first CPU, or NULL if the node has no CPUs
+ */
+static PageCache* node_page_cache(uint32_t node) {
+    uint32_t cpu = local_cpu();
+    if (mm_cpu_node[cpu] == node) {
+        return &mm_page_caches[cpu];
+    }
+    
+    return mm_node_first_cpu[node] != UINT32_MAX ? &mm_page_caches[mm_node_first_cpu[node]] : NULL;
+}
+
+/**
+ * @brief Allocate a single page of a node through a page cache
+ *
+ * @return Page index, or BUDDY_NONE if the node's memory is exhausted
+ */
+static uint32_t page_cache_alloc(uint32_t node) {
+    BuddyZone* zone = &mm_zones[node];
+    PageCache* cache = node_page_cache(node);
+    if (!cache) {
+        zone_lock(zone);
+        uint32_t page = zone_alloc(zone, 0);
+        pthread_mutex_unlock(&zone->lock);
+        return page;
+    }
+    
+    pthread_mutex_lock(&cache->lock);
+    if (cache->count == 0) {
+        cache->misses++;
+        zone_lock(zone);
+        while (cache->count < MM_PAGE_CACHE_BATCH) {
+            uint32_t page = zone_alloc(zone, 0);
+            if (page == BUDDY_NONE) {
+                break;
+            }
+            zone->cached[page] = true;
+            cache->pages[cache->count++] = page;
+        }
+        pthread_mutex_unlock(&zone->lock);
+    } else {
+        cache->hits++;
+    }
+    
+    uint32_t page = BUDDY_NONE;
+    if (cache->count > 0) {
+        page = cache->pages[--cache->count];
+        zone->cached[page] = false;
+    }
+    pthread_mutex_unlock(&cache->lock);
+    
+    return page;
+}
+
+/**
+ * @brief Free a single page of a node into a page cache
+ *
+ * @return false if the page is already in a cache
+ */
+static bool page_cache_free(uint32_t node, uint32_t page) {
+    BuddyZone* zone = &mm_zones[node];
+    PageCache* cache = node_page_cache(node);
+    if (!cache) {
+        zone_lock(zone);
+        zone_free(zone, page, 0);
+        pthread_mutex_unlock(&zone->lock);
+        return true;
+    }
+    
+    pthread_mutex_lock(&cache->lock);
+    if (zone->cached[page]) {
+        pthread_mutex_unlock(&cache->lock);
+        return false;
+    }
+    
+    if (cache->count == MM_PAGE_CACHE_SIZE) {
+        zone_lock(zone);
+        for (uint32_t i = 0; i < MM_PAGE_CACHE_BATCH; i++) {
+            uint32_t drained = cache->pages[--cache->count];
+            zone->cached[drained] = false;
+            zone_free(zone, drained, 0);
+        }
+        pthread_mutex_unlock(&zone->lock);
+    }
+    zone->cached[page] = true;
+    cache->pages[cache->count++] = page;
+    pthread_mutex_unlock(&cache->lock);
+    
+    return true;
+}
+
+/**
+ * @brief Return every cached page to its zone
+ */
+static void drain_page_caches(void) {
+    for (uint32_t i = 0; i < mm_cpu_count; i++) {
+        PageCache* cache = &mm_page_caches[i];
+        BuddyZone* zone = &mm_zones[mm_cpu_node[i]];
+        pthread_mutex_lock(&cache->lock);
+        zone_lock(zone);
+        while (cache->count > 0) {
+            uint32_t page = cache->pages[--cache->count];
+            zone->cached[page] = false;
+            zone_free(zone, page, 0);
+        }
+        pthread_mutex_unlock(&zone->lock);
+        pthread_mutex_unlock(&cache->lock);
+    }
+}
+
+/**
+ * @brief Find the node whose zone holds a physical address
+ *
+ * @return Node index, or UINT32_MAX if no zone holds the address
+ */
+static uint32_t zone_node(HalPhysicalAddr addr) {
+    for (uint32_t node = 0; node < mm_node_count; node++) {
+        if (addr >= mm_zones[node].start && addr < mm_zones[node].end) {
+            return node;
+        }
+    }
+    
+    return UINT32_MAX;
+}
+
+/**
+ * @brief Pick the node an allocation should be placed on first
+ *
+ * @return false if the policy names a node that does not exist
+ */
+static bool policy_node(MemoryPolicy policy, uint32_t node, uint32_t* chosen) {
+    switch (policy) {
+        case MM_POLICY_LOCAL:
+            *chosen = mm_cpu_node[local_cpu()];
+            return true;
+        case MM_POLICY_INTERLEAVE:
+            *chosen = atomic_fetch_add(&mm_next_interleave_node, 1) % mm_node_count;
+            return true;
+        case MM_POLICY_PREFERRED:
+        case MM_POLICY_BIND:
+            if (node >= mm_node_count) {
+                printf("Invalid memory node %u\n", node);
+                return false;
+            }
+            *chosen = node;
+            return true;
+        default:
+            printf("Invalid memory placement policy\n");
+            return false;
+    }
+}
+
+/**
+ * @brief Whether an allocation is served from a slab
+ */
+static bool slab_eligible(uint64_t size, MemoryType type, uint32_t flags) {
+    return size > 0 && size <= MM_SLAB_MAX_OBJECT &&
+           type != MEMORY_TYPE_QUANTUM && type != MEMORY_TYPE_ENTANGLED &&
+           (flags & (MM_FLAG_QUANTUM | MM_FLAG_ENTANGLED | MM_FLAG_HUGE_2M | MM_FLAG_HUGE_1G)) == 0;
+}
+
+/**
+ * @brief Link a slab into its cache's partial list
+ *
+ * Caller must hold the cache lock.
+ */
+static void slab_list_push(MemorySlab* slab) {
+    MemorySlab** head = &slab->cache->partial[slab->size_class];
+    slab->prev = NULL;
+    slab->next = *head;
+    if (*head) {
+        (*head)->prev = slab;
+    }
+    *head = slab;
+    slab->partial = true;
+}
+
+/**
+ * @brief Unlink a slab from its cache's partial list
+ *
+ * Caller must hold the cache lock.
+ */
+static void slab_list_unlink(MemorySlab* slab) {
+    if (slab->prev) {
+        slab->prev->next = slab->next;
+    } else {
+        slab->cache->partial[slab->size_class] = slab->next;
+    }
+    if (slab->next) {
+        slab->next->prev = slab->prev;
+    }
+    slab->next = NULL;
+    slab->prev = NULL;
+    slab->partial = false;
+}
 
 /**
- * @brief Find a memory region containing the given address
+ * @brief Create an empty slab on a cache's partial list
+ *
+ * Caller must hold the cache lock.
  */
-static MemoryRegion* find_region(HalVirtualAddr addr) {
-    MemoryRegion* region = mm_regions_head;
+static MemorySlab* slab_create(SlabCache* cache, uint32_t size_class, MemoryType type, uint32_t flags) {
+    MemorySlab* slab = (MemorySlab*)calloc(1, sizeof(MemorySlab));
+    if (!slab) {
+        return NULL;
+    }
     
-    while (region) {
-        if (addr >= region->start && addr < (HalVirtualAddr)((uint8_t*)region->start + region->size)) {
-            return region;
-        }
-        region = region->next;
+    /* For simulation, the slab is a dummy buffer like any other region */
+    void* memory = aligned_alloc(MM_SLAB_SIZE, MM_SLAB_SIZE);
+    if (!memory) {
+        free(slab);
+        return NULL;
+    }
+    
+    slab->cache = cache;
+    slab->size_class = size_class;
+    slab->object_size = 1u << (MM_SLAB_MIN_SHIFT + size_class);
+    slab->object_count = MM_SLAB_SIZE / slab->object_size;
+    
+    /* Bits past the last object are permanently in use */
+    uint32_t words = (slab->object_count + 63) / 64;
+    if (slab->object_count % 64 != 0) {
+        slab->bitmap[words - 1] = ~0ULL << (slab->object_count % 64);
     }
     
-    return NULL;
+    slab->region.start = memory;
+    slab->region.size = MM_SLAB_SIZE;
+    slab->region.type = type;
+    slab->region.flags = flags;
+    slab->region.resonance_level = NODE_ZERO_POINT;
+    slab->region.slab = slab;
+    slab->region.node = mm_cpu_node[cache - mm_slab_caches];
+    slab->region.backing = MEMORY_BACKING_HEAP;
+    slab->object_view = slab->region;
+    
+    add_region(&slab->region);
+    slab_list_push(slab);
+    
+    return slab;
 }
 
 /**
- * @brief Find an entanglement by ID
+ * @brief Release a slab and its memory
+ *
+ * Caller must hold the lock of the slab's cache.
  */
-static EntanglementInfo* find_entanglement(uint64_t entanglement_id) {
-    for (int i = 0; i < MAX_ENTANGLEMENTS; i++) {
-        if (mm_entanglements[i].id == entanglement_id) {
-            return &mm_entanglements[i];
-        }
+static void slab_destroy(MemorySlab* slab) {
+    if (slab->partial) {
+        slab_list_unlink(slab);
     }
-    
-    return NULL;
+    remove_region(&slab->region);
+    free(slab->region.start);
+    free(slab);
 }
 
 /**
- * @brief Find the next free entanglement slot
+ * @brief Allocate an object from the calling CPU's slabs
+ *
+ * @return Object address, or NULL if no slab could be created
  */
-static EntanglementInfo* find_free_entanglement_slot(void) {
-    for (int i = 0; i < MAX_ENTANGLEMENTS; i++) {
-        if (mm_entanglements[i].id == 0) {
-            return &mm_entanglements[i];
+static HalVirtualAddr slab_alloc(uint64_t size, MemoryType type, uint32_t flags) {
+    uint32_t size_class = 0;
+    while ((1ULL << (MM_SLAB_MIN_SHIFT + size_class)) < size) {
+        size_class++;
+    }
+    
+    SlabCache* cache = &mm_slab_caches[local_cpu()];
+    pthread_mutex_lock(&cache->lock);
+    
+    MemorySlab* slab = cache->partial[size_class];
+    while (slab && (slab->region.type != type || slab->region.flags != flags)) {
+        slab = slab->next;
+    }
+    if (!slab) {
+        slab = slab_create(cache, size_class, type, flags);
+        if (!slab) {
+            pthread_mutex_unlock(&cache->lock);
+            return NULL;
         }
     }
     
-    return NULL;
+    /* A partial slab always has a clear bit; start from where the last one was found */
+    uint32_t words = (slab->object_count + 63) / 64;
+    uint32_t word = slab->hint;
+    while (slab->bitmap[word] == ~0ULL) {
+        word = (word + 1) % words;
+    }
+    uint32_t bit = (uint32_t)__builtin_ctzll(~slab->bitmap[word]);
+    slab->bitmap[word] |= 1ULL << bit;
+    slab->hint = word;
+    
+    slab->used++;
+    if (slab->used == slab->object_count) {
+        slab_list_unlink(slab);
+    }
+    
+    cache->objects++;
+    cache->used_virtual += slab->object_size;
+    if (type == MEMORY_TYPE_RAM || type == MEMORY_TYPE_SHARED) {
+        cache->used_physical += slab->object_size;
+    }
+    
+    pthread_mutex_unlock(&cache->lock);
+    
+    return (uint8_t*)slab->region.start + (uint64_t)(word * 64 + bit) * slab->object_size;
 }
 
 /**
- * @brief Add a memory region to the linked list
+ * @brief Get the index of the object in use that contains an address
+ *
+ * Caller must hold the lock of the slab's cache.
+ *
+ * @return Object index, or -1 if the object is not in use
  */
-static void add_region(MemoryRegion* region) {
-    /* Add to the start of the list for simplicity */
-    region->next = mm_regions_head;
-    region->prev = NULL;
-    
-    if (mm_regions_head) {
-        mm_regions_head->prev = region;
+static int64_t slab_object_index(const MemorySlab* slab, HalVirtualAddr addr) {
+    uint32_t index = (uint32_t)(((uintptr_t)addr - (uintptr_t)slab->region.start) / slab->object_size);
+    if ((slab->bitmap[index / 64] & (1ULL << (index % 64))) == 0) {
+        return -1;
     }
     
-    mm_regions_head = region;
-    mm_stats.total_regions++;
+    return index;
 }
 
 /**
- * @brief Remove a memory region from the linked list
+ * @brief Return an object to its slab
+ *
+ * Empty slabs are released unless they are the last partial slab of their
+ * size class, which is kept for the next allocation.
+ *
+ * @return true if the object was freed, false if addr is not the start of an object in use
  */
-static void remove_region(MemoryRegion* region) {
-    if (region->prev) {
-        region->prev->next = region->next;
-    } else {
-        mm_regions_head = region->next;
+static bool slab_free(MemorySlab* slab, HalVirtualAddr addr) {
+    SlabCache* cache = slab->cache;
+    pthread_mutex_lock(&cache->lock);
+    
+    int64_t index = slab_object_index(slab, addr);
+    if (index < 0 || ((uintptr_t)addr - (uintptr_t)slab->region.start) % slab->object_size != 0) {
+        pthread_mutex_unlock(&cache->lock);
+        return false;
     }
     
-    if (region->next) {
-        region->next->prev = region->prev;
+    slab->bitmap[index / 64] &= ~(1ULL << (index % 64));
+    slab->used--;
+    
+    cache->objects--;
+    cache->used_virtual -= slab->object_size;
+    if (slab->region.type == MEMORY_TYPE_RAM || slab->region.type == MEMORY_TYPE_SHARED) {
+        cache->used_physical -= slab->object_size;
+    }
+    
+    if (!slab->partial) {
+        slab_list_push(slab);
+    } else if (slab->used == 0 && (cache->partial[slab->size_class] != slab || slab->next)) {
+        slab_destroy(slab);
     }
     
-    mm_stats.total_regions--;
+    pthread_mutex_unlock(&cache->lock);
+    return true;
+}
+
+/**
+ * @brief Describe the object in use that contains an address
+ *
+ * @return The slab's object view, or NULL if the object is not in use
+ */
+static MemoryRegion* slab_object_region(MemorySlab* slab, HalVirtualAddr addr) {
+    pthread_mutex_lock(&slab->cache->lock);
+    
+    MemoryRegion* view = NULL;
+    int64_t index = slab_object_index(slab, addr);
+    if (index >= 0) {
+        view = &slab->object_view;
+        view->start = (uint8_t*)slab->region.start + (uint64_t)index * slab->object_size;
+        view->size = slab->object_size;
+    }
+    
+    pthread_mutex_unlock(&slab->cache->lock);
+    return view;
+}
+
+/**
+ * @brief HAL page allocation entry point
+ */
+static HalPhysicalAddr alloc_page_for_hal(void) {
+    return mm_alloc_physical(mm_page_size, 0);
+}
+
+/**
+ * @brief HAL page free entry point
+ */
+static void free_page_for_hal(HalPhysicalAddr addr) {
+    mm_free_physical(addr, mm_page_size);
+}
+
+/**
+ * @brief Whether a region's physical memory is counted in mm_stats
+ *
+ * Huge pages come from the page allocator, which counts them per node.
+ */
+static bool region_counts_physical(const MemoryRegion* region) {
+    return (region->type == MEMORY_TYPE_RAM || region->type == MEMORY_TYPE_SHARED) &&
+           region->backing != MEMORY_BACKING_HUGE_PAGES;
 }
 
 /**
  * @brief Update memory statistics after allocation/freeing
  */
-static void update_stats_after_alloc(uint64_t size, MemoryType type) {
-    mm_stats.used_virtual += size;
-    mm_stats.free_virtual -= size;
+static void update_stats_after_alloc(MemoryRegion* region) {
+    mm_stats.used_virtual += region->size;
+    mm_stats.free_virtual -= region->size;
     
-    if (type == MEMORY_TYPE_RAM || type == MEMORY_TYPE_SHARED) {
-        mm_stats.used_physical += size;
-        mm_stats.free_physical -= size;
-    } else if (type == MEMORY_TYPE_QUANTUM || type == MEMORY_TYPE_ENTANGLED) {
+    if (region_counts_physical(region)) {
+        mm_stats.used_physical += region->size;
+        mm_stats.free_physical -= region->size;
+    } else if (region->type == MEMORY_TYPE_QUANTUM || region->type == MEMORY_TYPE_ENTANGLED) {
         /* Quantum memory is tracked separately */
-        uint64_t qubits_needed = (size * 8) / 32; /* Approximate conversion */
+        uint64_t qubits_needed = (region->size * 8) / 32; /* Approximate conversion */
         mm_stats.used_quantum += qubits_needed;
     }
 }
@@ -121,7 +1188,7 @@ static void update_stats_after_free(MemoryRegion* region) {
     mm_stats.used_virtual -= region->size;
     mm_stats.free_virtual += region->size;
     
-    if (region->type == MEMORY_TYPE_RAM || region->type == MEMORY_TYPE_SHARED) {
+    if (region_counts_physical(region)) {
         mm_stats.used_physical -= region->size;
         mm_stats.free_physical += region->size;
     } else if (region->type == MEMORY_TYPE_QUANTUM || region->type == MEMORY_TYPE_ENTANGLED) {
@@ -193,7 +1260,69 @@ bool mm_init(uint64_t memory_limit) {
     }
     
     /* Initialize entanglement table */
-    memset(mm_entanglements, 0, sizeof(mm_entanglements));
+    qereg_clear(QEREG_KIND_MEMORY, release_entanglement);
+    qereg_set_limit(QEREG_KIND_MEMORY, MAX_ENTANGLEMENTS);
+    
+    /* One set of page and slab caches per core */
+    mm_cpu_count = 1;
+    if (hal_ops->get_processor_info) {
+        HalProcessorInfo processor_info;
+        hal_ops->get_processor_info(&processor_info);
+        if (processor_info.core_count > 1) {
+            mm_cpu_count = processor_info.core_count < MM_MAX_CPUS ? processor_info.core_count : MM_MAX_CPUS;
+        }
+    }
+    
+    /* Without a node description, all memory and CPUs form one node */
+    HalMemoryNode nodes[MM_MAX_NODES];
+    mm_node_count = 1;
+    nodes[0].base = 0;
+    nodes[0].size = mm_memory_limit;
+    nodes[0].first_cpu = 0;
+    nodes[0].cpu_count = mm_cpu_count;
+    if (hal_ops->get_memory_info && mem_info.node_count > 0) {
+        mm_node_count = mem_info.node_count < MM_MAX_NODES ? mem_info.node_count : MM_MAX_NODES;
+        memcpy(nodes, mem_info.nodes, mm_node_count * sizeof(HalMemoryNode));
+    }
+    memset(mm_cpu_node, 0, sizeof(mm_cpu_node));
+    for (uint32_t node = 0; node < mm_node_count; node++) {
+        mm_node_first_cpu[node] = UINT32_MAX;
+        for (uint32_t cpu = nodes[node].first_cpu; cpu < nodes[node].first_cpu + nodes[node].cpu_count; cpu++) {
+            if (cpu < mm_cpu_count) {
+                mm_cpu_node[cpu] = node;
+                if (mm_node_first_cpu[node] == UINT32_MAX) {
+                    mm_node_first_cpu[node] = cpu;
+                }
+            }
+        }
+        atomic_store(&mm_node_allocations[node], 0);
+        atomic_store(&mm_node_fallbacks[node], 0);
+    }
+    
+    /* Hand each node's memory above what is already in use to its page allocator */
+    mm_page_size = (hal_ops->get_memory_info && mem_info.page_size) ? mem_info.page_size : 4096;
+    for (uint32_t node = 0; node < mm_node_count; node++) {
+        HalPhysicalAddr start = nodes[node].base > mm_stats.used_physical ? nodes[node].base : mm_stats.used_physical;
+        HalPhysicalAddr end = nodes[node].base + nodes[node].size;
+        if (end > mm_memory_limit) {
+            end = mm_memory_limit;
+        }
+        if (!zone_init(&mm_zones[node], start, end > start ? end : start, mm_page_size)) {
+            printf("Failed to allocate physical page allocator metadata\n");
+            for (uint32_t i = 0; i <= node; i++) {
+                zone_destroy(&mm_zones[i]);
+            }
+            return false;
+        }
+    }
+    
+    for (uint32_t i = 0; i < MM_MAX_CPUS; i++) {
+        memset(&mm_page_caches[i], 0, sizeof(PageCache));
+        pthread_mutex_init(&mm_page_caches[i].lock, NULL);
+        memset(&mm_slab_caches[i], 0, sizeof(SlabCache));
+        pthread_mutex_init(&mm_slab_caches[i].lock, NULL);
+    }
+    hal_set_page_allocator(alloc_page_for_hal, free_page_for_hal);
     
     printf("Memory Manager initialized\n");
     printf("Total Physical Memory: %llu bytes\n", (unsigned long long)mm_stats.total_physical);
@@ -214,12 +1343,30 @@ void mm_shutdown(void) {
     /* Free all memory regions */
     while (mm_regions_head) {
         MemoryRegion* next = mm_regions_head->next;
-        mm_free_virtual(mm_regions_head->start);
+        if (mm_regions_head->slab) {
+            /* Nothing else allocates once shutdown starts, so the cache lock is not needed */
+            slab_destroy(mm_regions_head->slab);
+        } else {
+            mm_free_virtual(mm_regions_head->start);
+        }
         mm_regions_head = next;
     }
+    mm_region_root = NULL;
+    mm_last_region = NULL;
     
     /* Clear entanglement table */
-    memset(mm_entanglements, 0, sizeof(mm_entanglements));
+    qereg_clear(QEREG_KIND_MEMORY, release_entanglement);
+    
+    /* Release the page allocator */
+    hal_set_page_allocator(NULL, NULL);
+    drain_page_caches();
+    for (uint32_t i = 0; i < MM_MAX_CPUS; i++) {
+        pthread_mutex_destroy(&mm_page_caches[i].lock);
+        pthread_mutex_destroy(&mm_slab_caches[i].lock);
+    }
+    for (uint32_t node = 0; node < mm_node_count; node++) {
+        zone_destroy(&mm_zones[node]);
+    }
     
     /* Reset statistics */
     memset(&mm_stats, 0, sizeof(mm_stats));
@@ -232,40 +1379,67 @@ void mm_shutdown(void) {
  * @brief Allocate physical memory
  */
 HalPhysicalAddr mm_alloc_physical(uint64_t size, uint32_t alignment) {
+    return mm_alloc_physical_policy(size, alignment, MM_POLICY_LOCAL, 0);
+}
+
+/**
+ * @brief Allocate physical memory on a memory node
+ */
+HalPhysicalAddr mm_alloc_physical_policy(uint64_t size, uint32_t alignment, MemoryPolicy policy, uint32_t node) {
     if (!mm_initialized) {
         return 0;
     }
     
-    /* Check if we have enough free physical memory */
-    if (size > mm_stats.free_physical) {
-        printf("Not enough free physical memory\n");
+    if (size == 0 || (alignment & (alignment - 1)) != 0) {
+        printf("Invalid physical allocation request\n");
         return 0;
     }
     
-    /* Get HAL operations */
-    const HalOperations* hal_ops = hal_get_operations();
-    if (!hal_ops || !hal_ops->alloc_physical_page) {
-        printf("Physical memory allocation not supported by HAL\n");
+    uint32_t first;
+    if (!policy_node(policy, node, &first)) {
         return 0;
     }
     
-    /* Calculate number of pages needed */
-    HalMemoryInfo mem_info;
-    hal_ops->get_memory_info(&mem_info);
-    uint32_t page_size = mem_info.page_size;
-    uint32_t pages_needed = (size + page_size - 1) / page_size;
-    
-    /* Allocate pages */
-    /* In a real implementation, this would handle alignment and contiguous allocation */
-    /* For now, we'll just simulate a successful allocation */
-    
-    HalPhysicalAddr physical_addr = 0x1000000; /* Simulated address */
+    /* Blocks are aligned to their own size, so alignment only raises the order */
+    uint64_t pages_needed = (size + mm_page_size - 1) / mm_page_size;
+    uint64_t alignment_pages = alignment > mm_page_size ? alignment / mm_page_size : 1;
+    if (alignment_pages > pages_needed) {
+        pages_needed = alignment_pages;
+    }
+    uint32_t order = 0;
+    while (order < MM_BUDDY_ORDERS && (1ULL << order) < pages_needed) {
+        order++;
+    }
     
-    /* Update statistics */
-    mm_stats.used_physical += size;
-    mm_stats.free_physical -= size;
+    /* Try the chosen node, then the others in turn unless bound */
+    uint32_t attempts = policy == MM_POLICY_BIND ? 1 : mm_node_count;
+    for (uint32_t i = 0; i < attempts; i++) {
+        uint32_t candidate = (first + i) % mm_node_count;
+        BuddyZone* zone = &mm_zones[candidate];
+        if (zone->page_count == 0) {
+            continue;
+        }
+        
+        uint32_t page;
+        if (order == 0) {
+            page = page_cache_alloc(candidate);
+        } else {
+            zone_lock(zone);
+            page = zone_alloc(zone, order);
+            pthread_mutex_unlock(&zone->lock);
+        }
+        
+        if (page != BUDDY_NONE) {
+            atomic_fetch_add(&mm_node_allocations[candidate], 1);
+            if (candidate != first) {
+                atomic_fetch_add(&mm_node_fallbacks[candidate], 1);
+            }
+            return zone->base + (HalPhysicalAddr)page * zone->page_size;
+        }
+    }
     
-    return physical_addr;
+    printf("Not enough free physical memory\n");
+    return 0;
 }
 
 /**
@@ -276,19 +1450,32 @@ bool mm_free_physical(HalPhysicalAddr addr, uint64_t size) {
         return false;
     }
     
-    /* Get HAL operations */
-    const HalOperations* hal_ops = hal_get_operations();
-    if (!hal_ops || !hal_ops->free_physical_page) {
-        printf("Physical memory deallocation not supported by HAL\n");
+    uint32_t node = zone_node(addr);
+    if (node == UINT32_MAX || (addr - mm_zones[node].base) % mm_page_size != 0) {
+        printf("Attempt to free invalid physical address\n");
         return false;
     }
     
-    /* In a real implementation, this would free the actual physical pages */
-    /* For now, we'll just simulate success */
+    BuddyZone* zone = &mm_zones[node];
+    uint32_t page = (uint32_t)((addr - zone->base) / zone->page_size);
+    uint8_t state = zone->state[page];
+    uint32_t order = state & BUDDY_PAGE_ORDER_MASK;
+    if ((state & ~BUDDY_PAGE_ORDER_MASK) != BUDDY_PAGE_ALLOCATED ||
+        size > ((uint64_t)zone->page_size << order)) {
+        printf("Attempt to free physical memory that is not allocated\n");
+        return false;
+    }
     
-    /* Update statistics */
-    mm_stats.used_physical -= size;
-    mm_stats.free_physical += size;
+    if (order == 0) {
+        if (!page_cache_free(node, page)) {
+            printf("Attempt to free physical memory that is not allocated\n");
+            return false;
+        }
+    } else {
+        zone_lock(zone);
+        zone_free(zone, page, order);
+        pthread_mutex_unlock(&zone->lock);
+    }
     
     return true;
 }
@@ -297,22 +1484,77 @@ bool mm_free_physical(HalPhysicalAddr addr, uint64_t size) {
  * @brief Allocate virtual memory
  */
 HalVirtualAddr mm_alloc_virtual(uint64_t size, MemoryType type, uint32_t flags) {
+    return mm_alloc_virtual_policy(size, type, flags, MM_POLICY_LOCAL, 0);
+}
+
+/**
+ * @brief Allocate virtual memory on a memory node
+ */
+HalVirtualAddr mm_alloc_virtual_policy(uint64_t size, MemoryType type, uint32_t flags,
+                                       MemoryPolicy policy, uint32_t node) {
     if (!mm_initialized) {
         return NULL;
     }
     
+    uint32_t chosen;
+    if (!policy_node(policy, node, &chosen)) {
+        return NULL;
+    }
+    
+    /* The calling CPU's slabs are on its own node */
+    if (slab_eligible(size, type, flags) && chosen == mm_cpu_node[local_cpu()]) {
+        HalVirtualAddr block = slab_alloc(size, type, flags);
+        if (block) {
+            TRACE_EVENT(TRACE_MM_ALLOC, TRACE_PHASE_INSTANT, (uintptr_t)block, size);
+        }
+        return block;
+    }
+    
     /* Create a new memory region */
     MemoryRegion* region = (MemoryRegion*)malloc(sizeof(MemoryRegion));
     if (!region) {
         return NULL;
     }
     
-    /* In a real implementation, this would allocate actual memory */
-    /* For simulation, we'll just allocate a dummy buffer */
-    void* memory = malloc(size);
-    if (!memory) {
-        free(region);
-        return NULL;
+    region->physical = 0; /* No physical mapping yet */
+    region->node = chosen;
+    region->backing = MEMORY_BACKING_HEAP;
+    
+    /* Huge pages come from the page allocator and need the HAL to map them */
+    const HalOperations* hal_ops = hal_get_operations();
+    uint64_t huge_size = (flags & MM_FLAG_HUGE_1G) ? (1ULL << 30) :
+                         (flags & MM_FLAG_HUGE_2M) ? (2ULL << 20) : 0;
+    void* memory = NULL;
+    if (huge_size && hal_ops && hal_ops->map_physical_memory && hal_ops->unmap_physical_memory) {
+        uint64_t rounded = (size + huge_size - 1) / huge_size * huge_size;
+        uint32_t huge_flag = huge_size == (1ULL << 30) ? HAL_MEM_HUGE_1G : HAL_MEM_HUGE_2M;
+        HalPhysicalAddr physical = mm_alloc_physical_policy(rounded, (uint32_t)huge_size,
+                                                            policy == MM_POLICY_BIND ? MM_POLICY_BIND : MM_POLICY_PREFERRED,
+                                                            chosen);
+        if (!physical) {
+            free(region);
+            return NULL;
+        }
+        memory = hal_ops->map_physical_memory(physical, rounded,
+                                              (flags & ~(MM_FLAG_HUGE_2M | MM_FLAG_HUGE_1G)) | huge_flag);
+        if (!memory) {
+            printf("Failed to map huge pages\n");
+            mm_free_physical(physical, rounded);
+            free(region);
+            return NULL;
+        }
+        size = rounded;
+        region->physical = physical;
+        region->node = zone_node(physical);
+        region->backing = MEMORY_BACKING_HUGE_PAGES;
+    } else {
+        /* In a real implementation, this would allocate actual memory */
+        /* For simulation, we'll just allocate a dummy buffer */
+        memory = malloc(size);
+        if (!memory) {
+            free(region);
+            return NULL;
+        }
     }
     
     /* Initialize the region */
@@ -320,10 +1562,10 @@ HalVirtualAddr mm_alloc_virtual(uint64_t size, MemoryType type, uint32_t flags)
     region->size = size;
     region->type = type;
     region->flags = flags;
-    region->physical = 0; /* No physical mapping yet */
     region->entanglement_id = 0; /* Not entangled */
     region->next = NULL;
     region->prev = NULL;
+    region->slab = NULL;
     
     /* Set resonance level based on memory type */
     switch (type) {
@@ -342,7 +1584,9 @@ HalVirtualAddr mm_alloc_virtual(uint64_t size, MemoryType type, uint32_t flags)
     add_region(region);
     
     /* Update statistics */
-    update_stats_after_alloc(size, type);
+    update_stats_after_alloc(region);
+    TRACE_EVENT(TRACE_MM_ALLOC, TRACE_PHASE_INSTANT, (uintptr_t)region->start,
+                region->size > UINT32_MAX ? UINT32_MAX : region->size);
     
     return region->start;
 }
@@ -362,6 +1606,15 @@ bool mm_free_virtual(HalVirtualAddr addr) {
         return false;
     }
     
+    if (region->slab) {
+        if (!slab_free(region->slab, addr)) {
+            printf("Attempt to free invalid memory address\n");
+            return false;
+        }
+        TRACE_EVENT(TRACE_MM_FREE, TRACE_PHASE_INSTANT, (uintptr_t)addr, 0);
+        return true;
+    }
+    
     /* Check if the region is entangled */
     if (region->entanglement_id != 0) {
         /* Break entanglement before freeing */
@@ -370,12 +1623,27 @@ bool mm_free_virtual(HalVirtualAddr addr) {
     
     /* Update statistics */
     update_stats_after_free(region);
+    TRACE_EVENT(TRACE_MM_FREE, TRACE_PHASE_INSTANT, (uintptr_t)addr,
+                region->size > UINT32_MAX ? UINT32_MAX : region->size);
     
     /* Remove from region list */
     remove_region(region);
     
     /* Free the actual memory */
-    free(region->start);
+    const HalOperations* hal_ops = hal_get_operations();
+    switch (region->backing) {
+        case MEMORY_BACKING_HUGE_PAGES:
+            hal_ops->unmap_physical_memory(region->start, region->size);
+            mm_free_physical(region->physical, region->size);
+            break;
+        case MEMORY_BACKING_MAPPED:
+        case MEMORY_BACKING_FILE:
+            hal_ops->unmap_physical_memory(region->start, region->size);
+            break;
+        default:
+            free(region->start);
+            break;
+    }
     free(region);
     
     return true;
@@ -420,13 +1688,68 @@ HalVirtualAddr mm_map_physical(HalPhysicalAddr physical, uint64_t size, uint32_t
     region->entanglement_id = 0; /* Not entangled */
     region->next = NULL;
     region->prev = NULL;
+    region->slab = NULL;
+    region->node = zone_node(physical) != UINT32_MAX ? zone_node(physical) : 0;
+    region->backing = MEMORY_BACKING_MAPPED;
     region->resonance_level = NODE_ZERO_POINT;
     
     /* Add to region list */
     add_region(region);
     
     /* Update statistics */
-    update_stats_after_alloc(size, MEMORY_TYPE_RAM);
+    update_stats_after_alloc(region);
+    
+    return virtual_addr;
+}
+
+/**
+ * @brief Map a file into virtual memory
+ */
+HalVirtualAddr mm_map_file(const char* path, uint64_t offset, uint64_t size, uint32_t flags) {
+    if (!mm_initialized || !path) {
+        return NULL;
+    }
+    
+    const HalOperations* hal_ops = hal_get_operations();
+    if (!hal_ops || !hal_ops->map_file || !hal_ops->unmap_physical_memory) {
+        printf("File mapping not supported by HAL\n");
+        return NULL;
+    }
+    
+    if (offset % mm_page_size != 0) {
+        printf("File mapping offset must be page-aligned\n");
+        return NULL;
+    }
+    
+    /* The HAL reports the mapped size when asked for the rest of the file */
+    uint64_t mapped_size = size;
+    HalVirtualAddr virtual_addr = hal_ops->map_file(path, offset, &mapped_size, flags);
+    if (!virtual_addr) {
+        printf("Failed to map file %s\n", path);
+        return NULL;
+    }
+    
+    MemoryRegion* region = (MemoryRegion*)malloc(sizeof(MemoryRegion));
+    if (!region) {
+        hal_ops->unmap_physical_memory(virtual_addr, mapped_size);
+        return NULL;
+    }
+    
+    region->start = virtual_addr;
+    region->size = mapped_size;
+    region->type = MEMORY_TYPE_FILE;
+    region->flags = flags;
+    region->physical = 0;
+    region->entanglement_id = 0; /* Not entangled */
+    region->next = NULL;
+    region->prev = NULL;
+    region->slab = NULL;
+    region->node = mm_get_current_node();
+    region->backing = MEMORY_BACKING_FILE;
+    region->resonance_level = NODE_ZERO_POINT;
+    
+    add_region(region);
+    update_stats_after_alloc(region);
     
     return virtual_addr;
 }
@@ -439,7 +1762,30 @@ MemoryRegion* mm_get_region_info(HalVirtualAddr addr) {
         return NULL;
     }
     
-    return find_region(addr);
+    MemoryRegion* region = find_region(addr);
+    if (region && region->slab) {
+        return slab_object_region(region->slab, addr);
+    }
+    
+    return region;
+}
+
+/**
+ * @brief Find the memory regions overlapping an address range
+ */
+uint32_t mm_find_regions(HalVirtualAddr start, uint64_t size, MemoryRegion** regions, uint32_t max_count) {
+    if (!mm_initialized || !regions || max_count == 0 || size == 0) {
+        return 0;
+    }
+    
+    uintptr_t range_start = (uintptr_t)start;
+    uintptr_t range_end = range_start + size < range_start ? UINTPTR_MAX : range_start + size;
+    
+    uint32_t count = 0;
+    pthread_mutex_lock(&mm_region_lock);
+    tree_collect(mm_region_root, range_start, range_end, regions, max_count, &count);
+    pthread_mutex_unlock(&mm_region_lock);
+    return count;
 }
 
 /**
@@ -466,21 +1812,28 @@ uint64_t mm_create_entanglement(HalVirtualAddr first_addr, HalVirtualAddr second
         return 0;
     }
     
+    /* Entanglement works on whole regions, which small allocations do not have */
+    if (first_region->slab || second_region->slab) {
+        printf("Small allocations cannot be entangled\n");
+        return 0;
+    }
+    
     /* Check if regions are already entangled */
     if (first_region->entanglement_id != 0 || second_region->entanglement_id != 0) {
         printf("Memory regions are already entangled\n");
         return 0;
     }
     
-    /* Find a free entanglement slot */
-    EntanglementInfo* slot = find_free_entanglement_slot();
-    if (!slot) {
+    /* Reserve an entanglement slot */
+    MemoryEntanglement* entry = NULL;
+    uint64_t entanglement_id = qereg_reserve(QEREG_KIND_MEMORY, (void**)&entry);
+    if (entanglement_id == 0) {
         printf("Maximum number of entanglements reached\n");
         return 0;
     }
     
     /* Set up the entanglement */
-    uint64_t entanglement_id = mm_next_entanglement_id++;
+    EntanglementInfo* slot = &entry->info;
     slot->id = entanglement_id;
     slot->first_region = first_region;
     slot->second_region = second_region;
@@ -499,6 +1852,7 @@ uint64_t mm_create_entanglement(HalVirtualAddr first_addr, HalVirtualAddr second
     
     /* Update statistics */
     mm_stats.total_entanglements++;
+    qereg_publish(entanglement_id);
     
     /* In a real implementation, this would perform actual quantum entanglement */
     /* For simulation, we'll create a simple memory copy to simulate synchronization */
@@ -540,7 +1894,8 @@ bool mm_break_entanglement(uint64_t entanglement_id) {
     }
     
     /* Clear the entanglement slot */
-    memset(entanglement, 0, sizeof(EntanglementInfo));
+    reset_entanglement_dirty(entanglement_dirty(entanglement));
+    qereg_remove(QEREG_KIND_MEMORY, entanglement_id);
     
     /* Update statistics */
     mm_stats.total_entanglements--;
@@ -571,52 +1926,122 @@ bool mm_get_entanglement_info(uint64_t entanglement_id, EntanglementInfo* info)
 }
 
 /**
- * @brief Synchronize quantum-entangled memory regions
+ * @brief Mark part of an entangled region as changed
  */
-bool mm_sync_entanglement(uint64_t entanglement_id) {
-    if (!mm_initialized) {
+bool mm_mark_dirty(HalVirtualAddr addr, uint64_t size) {
+    if (!mm_initialized || size == 0) {
         return false;
     }
     
-    /* Find the entanglement */
-    EntanglementInfo* entanglement = find_entanglement(entanglement_id);
+    MemoryRegion* region = find_region(addr);
+    EntanglementInfo* entanglement = NULL;
+    if (region && !region->slab && region->entanglement_id != 0) {
+        entanglement = find_entanglement(region->entanglement_id);
+    }
     if (!entanglement) {
-        printf("Invalid entanglement ID\n");
+        printf("Address is not in an entangled region\n");
         return false;
     }
     
-    /* Check if the regions are valid */
-    if (!entanglement->first_region || !entanglement->second_region) {
-        printf("Invalid entangled regions\n");
-        return false;
+    EntanglementDirty* dirty = entanglement_dirty(entanglement);
+    uint64_t length = sync_length(entanglement);
+    if (!dirty->dirty) {
+        dirty->block_count = (uint32_t)((length + MM_SYNC_BLOCK_SIZE - 1) / MM_SYNC_BLOCK_SIZE);
+        dirty->dirty = (uint64_t*)calloc((dirty->block_count + 63) / 64, sizeof(uint64_t));
+        if (!dirty->dirty) {
+            printf("Failed to allocate entanglement change tracking\n");
+            return false;
+        }
     }
-    
-    /* In a real implementation, this would perform proper quantum synchronization */
-    /* For simulation, we'll create a simple memory copy to simulate synchronization */
-    
-    /* Determine which region is the source based on resonance level */
-    if (entanglement->first_region->resonance_level >= entanglement->second_region->resonance_level) {
-        /* First region is source */
-        memcpy(entanglement->second_region->start, entanglement->first_region->start, 
-               (entanglement->first_region->size < entanglement->second_region->size) ? 
-               entanglement->first_region->size : entanglement->second_region->size);
-    } else {
-        /* Second region is source */
-        memcpy(entanglement->first_region->start, entanglement->second_region->start, 
-               (entanglement->first_region->size < entanglement->second_region->size) ? 
-               entanglement->first_region->size : entanglement->second_region->size);
+    dirty->tracked = true;
+    
+    /* Changes past the synchronized length are never copied */
+    uint64_t offset = (uintptr_t)addr - (uintptr_t)region->start;
+    if (offset < length) {
+        uint64_t end = (size < length - offset) ? offset + size : length;
+        uint32_t last = (uint32_t)((end - 1) / MM_SYNC_BLOCK_SIZE);
+        for (uint32_t block = (uint32_t)(offset / MM_SYNC_BLOCK_SIZE); block <= last; block++) {
+            dirty->dirty[block / 64] |= 1ULL << (block % 64);
+        }
+        entanglement->is_synchronized = false;
     }
     
-    /* Mark as synchronized */
-    entanglement->is_synchronized = true;
+    return true;
+}
+
+/**
+ * @brief Synchronize quantum-entangled memory regions
+ */
+bool mm_sync_entanglement(uint64_t entanglement_id) {
+    return mm_sync_entanglements(&entanglement_id, 1) == 1;
+}
+
+/**
+ * @brief Synchronize several entanglements
+ */
+uint32_t mm_sync_entanglements(const uint64_t* entanglement_ids, uint32_t count) {
+    if (!mm_initialized || !entanglement_ids) {
+        return 0;
+    }
     
-    /* Reduce stability slightly due to synchronization stress */
-    entanglement->stability *= 0.99;
-    if (entanglement->stability < 0.5) {
-        printf("Warning: Entanglement stability is low (%.2f)\n", entanglement->stability);
+    uint32_t synced = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        /* Find the entanglement */
+        EntanglementInfo* entanglement = find_entanglement(entanglement_ids[i]);
+        if (!entanglement) {
+            printf("Invalid entanglement ID\n");
+            continue;
+        }
+        
+        /* Check if the regions are valid */
+        if (!entanglement->first_region || !entanglement->second_region) {
+            printf("Invalid entangled regions\n");
+            continue;
+        }
+        
+        /* In a real implementation, this would perform proper quantum synchronization */
+        /* For simulation, we copy the changed memory from the source region */
+        mm_stats.entanglement_bytes_synced += sync_regions(entanglement);
+        
+        /* Mark as synchronized */
+        entanglement->is_synchronized = true;
+        
+        /* Reduce stability slightly due to synchronization stress */
+        entanglement->stability *= 0.99;
+        if (entanglement->stability < 0.5) {
+            printf("Warning: Entanglement stability is low (%.2f)\n", entanglement->stability);
+        }
+        
+        synced++;
     }
     
-    return true;
+#if defined(__SSE2__)
+    /* Order the non-temporal stores before anyone reads the destinations */
+    _mm_sfence();
+#endif
+    
+    return synced;
+}
+
+/**
+ * @brief Get the number of memory nodes
+ */
+uint32_t mm_get_node_count(void) {
+    return mm_node_count;
+}
+
+/**
+ * @brief Get the memory node local to a CPU
+ */
+uint32_t mm_get_cpu_node(uint32_t cpu) {
+    return cpu < mm_cpu_count ? mm_cpu_node[cpu] : 0;
+}
+
+/**
+ * @brief Get the memory node local to the calling thread
+ */
+uint32_t mm_get_current_node(void) {
+    return mm_cpu_node[local_cpu()];
 }
 
 /**
@@ -629,6 +2054,53 @@ void mm_get_stats(MemoryStats* stats) {
     
     /* Copy the statistics */
     memcpy(stats, &mm_stats, sizeof(MemoryStats));
+    
+    /* Add up the node zones */
+    stats->node_count = mm_node_count;
+    for (uint32_t node = 0; node < mm_node_count; node++) {
+        BuddyZone* zone = &mm_zones[node];
+        MemoryNodeStats* node_stats = &stats->nodes[node];
+        zone_lock(zone);
+        for (uint32_t order = 0; order < MM_BUDDY_ORDERS; order++) {
+            stats->free_blocks += zone->free_counts[order];
+            if (zone->free_counts[order] > 0 && ((uint64_t)zone->page_size << order) > stats->largest_free_block) {
+                stats->largest_free_block = (uint64_t)zone->page_size << order;
+            }
+        }
+        stats->used_physical += zone->allocated;
+        stats->free_physical -= zone->allocated;
+        stats->allocator_contention += zone->contention;
+        node_stats->total_physical = zone->end - zone->start;
+        node_stats->free_physical = node_stats->total_physical - zone->allocated;
+        pthread_mutex_unlock(&zone->lock);
+        node_stats->allocations = atomic_load(&mm_node_allocations[node]);
+        node_stats->fallbacks = atomic_load(&mm_node_fallbacks[node]);
+    }
+    
+    /* Pages parked in the per-CPU caches are free */
+    for (uint32_t i = 0; i < mm_cpu_count; i++) {
+        PageCache* cache = &mm_page_caches[i];
+        pthread_mutex_lock(&cache->lock);
+        uint64_t cached = (uint64_t)cache->count * mm_page_size;
+        stats->used_physical -= cached;
+        stats->free_physical += cached;
+        stats->nodes[mm_cpu_node[i]].free_physical += cached;
+        stats->page_cache_hits += cache->hits;
+        stats->page_cache_misses += cache->misses;
+        pthread_mutex_unlock(&cache->lock);
+    }
+    
+    /* Objects carved from slabs */
+    for (uint32_t i = 0; i < MM_MAX_CPUS; i++) {
+        SlabCache* cache = &mm_slab_caches[i];
+        pthread_mutex_lock(&cache->lock);
+        stats->total_regions += cache->objects;
+        stats->used_virtual += cache->used_virtual;
+        stats->free_virtual -= cache->used_virtual;
+        stats->used_physical += cache->used_physical;
+        stats->free_physical -= cache->used_physical;
+        pthread_mutex_unlock(&cache->lock);
+    }
 }
 
 /**
@@ -639,17 +2111,35 @@ void mm_print_stats(void) {
         return;
     }
     
+    /* Physical usage counts the per-CPU cached pages as free and includes slab objects */
+    MemoryStats stats;
+    mm_get_stats(&stats);
+    
     printf("\nMemory Manager Statistics:\n");
     printf("Total Physical Memory: %llu bytes\n", (unsigned long long)mm_stats.total_physical);
     printf("Used Physical Memory: %llu bytes (%.2f%%)\n", 
-           (unsigned long long)mm_stats.used_physical,
-           (double)mm_stats.used_physical * 100.0 / mm_stats.total_physical);
+           (unsigned long long)stats.used_physical,
+           (double)stats.used_physical * 100.0 / stats.total_physical);
     printf("Free Physical Memory: %llu bytes (%.2f%%)\n", 
-           (unsigned long long)mm_stats.free_physical,
-           (double)mm_stats.free_physical * 100.0 / mm_stats.total_physical);
+           (unsigned long long)stats.free_physical,
+           (double)stats.free_physical * 100.0 / stats.total_physical);
+    
+    printf("Free Physical Blocks: %u (largest: %llu bytes)\n", stats.free_blocks,
+           (unsigned long long)stats.largest_free_block);
+    printf("Page Cache Hits: %llu, Misses: %llu\n", (unsigned long long)stats.page_cache_hits,
+           (unsigned long long)stats.page_cache_misses);
+    printf("Allocator Lock Contention: %llu\n", (unsigned long long)stats.allocator_contention);
+    for (uint32_t node = 0; node < stats.node_count; node++) {
+        printf("Node %u: %llu of %llu bytes free, %llu allocations (%llu fallbacks)\n", node,
+               (unsigned long long)stats.nodes[node].free_physical,
+               (unsigned long long)stats.nodes[node].total_physical,
+               (unsigned long long)stats.nodes[node].allocations,
+               (unsigned long long)stats.nodes[node].fallbacks);
+    }
     
-    printf("Total Memory Regions: %u\n", mm_stats.total_regions);
-    printf("Total Entanglements: %u\n", mm_stats.total_entanglements);
+    printf("Total Memory Regions: %u\n", stats.total_regions);
+    printf("Total Entanglements: %u (%llu bytes synchronized)\n", mm_stats.total_entanglements,
+           (unsigned long long)mm_stats.entanglement_bytes_synced);
     
     if (mm_stats.total_quantum > 0) {
         printf("Total Quantum Memory: %llu qubits\n", (unsigned long long)mm_stats.total_quantum);
@@ -26,6 +26,23 @@
 #define MM_FLAG_CACHED     0x20    /**< Memory is cached */
 #define MM_FLAG_USER       0x40    /**< Memory is accessible by user mode */
 #define MM_FLAG_SYSTEM     0x80    /**< Memory is reserved for system use */
+#define MM_FLAG_HUGE_2M    0x100   /**< Memory is backed by 2MB pages */
+#define MM_FLAG_HUGE_1G    0x200   /**< Memory is backed by 1GB pages */
+
+/**
+ * @brief Maximum number of memory nodes
+ */
+#define MM_MAX_NODES HAL_MAX_MEMORY_NODES
+
+/**
+ * @brief Memory node placement policies
+ */
+typedef enum {
+    MM_POLICY_LOCAL,           /**< Calling CPU's node, falling back to the others */
+    MM_POLICY_PREFERRED,       /**< Given node, falling back to the others */
+    MM_POLICY_INTERLEAVE,      /**< Successive allocations rotate over the nodes */
+    MM_POLICY_BIND             /**< Given node only */
+} MemoryPolicy;
 
 /**
  * @brief Memory region types
@@ -35,9 +52,22 @@ typedef enum {
     MEMORY_TYPE_QUANTUM,       /**< Quantum memory */
     MEMORY_TYPE_DEVICE,        /**< Device memory */
     MEMORY_TYPE_SHARED,        /**< Shared memory */
-    MEMORY_TYPE_ENTANGLED      /**< Quantum-entangled memory */
+    MEMORY_TYPE_ENTANGLED,     /**< Quantum-entangled memory */
+    MEMORY_TYPE_FILE           /**< Memory-mapped file */
 } MemoryType;
 
+/**
+ * @brief Where a region's memory comes from
+ */
+typedef enum {
+    MEMORY_BACKING_HEAP,       /**< Simulated buffer from the heap */
+    MEMORY_BACKING_HUGE_PAGES, /**< Huge pages from the page allocator, mapped by the HAL */
+    MEMORY_BACKING_MAPPED,     /**< Caller's physical memory, mapped by the HAL */
+    MEMORY_BACKING_FILE        /**< File mapped by the HAL */
+} MemoryBacking;
+
+struct MemorySlab;
+
 /**
  * @brief Memory region structure
  */
@@ -51,6 +81,13 @@ typedef struct MemoryRegion {
     struct MemoryRegion* next;    /**< Next region in list */
     struct MemoryRegion* prev;    /**< Previous region in list */
     NodeLevel resonance_level;    /**< Resonance level for quantum operations */
+    struct MemoryRegion* tree_left;  /**< Left child in the region index */
+    struct MemoryRegion* tree_right; /**< Right child in the region index */
+    int32_t tree_height;          /**< Height of the index subtree rooted here */
+    uintptr_t subtree_end;        /**< Highest end address in the index subtree */
+    struct MemorySlab* slab;      /**< Slab the region's memory is carved from (NULL if none) */
+    uint32_t node;                /**< Memory node the region is placed on */
+    MemoryBacking backing;        /**< Where the region's memory comes from */
 } MemoryRegion;
 
 /**
@@ -65,6 +102,16 @@ typedef struct {
     bool is_synchronized;          /**< Whether regions are currently synchronized */
 } EntanglementInfo;
 
+/**
+ * @brief Per-node memory statistics
+ */
+typedef struct {
+    uint64_t total_physical;      /**< Physical memory managed on the node */
+    uint64_t free_physical;       /**< Free physical memory on the node */
+    uint64_t allocations;         /**< Physical allocations served by the node */
+    uint64_t fallbacks;           /**< Of those, allocations meant for another node */
+} MemoryNodeStats;
+
 /**
  * @brief Memory allocation information for tracking
  */
@@ -79,6 +126,14 @@ typedef struct {
     uint32_t total_entanglements; /**< Total number of memory entanglements */
     uint64_t total_quantum;       /**< Total quantum memory in qubits */
     uint64_t used_quantum;        /**< Used quantum memory in qubits */
+    uint32_t free_blocks;         /**< Free physical blocks of all sizes */
+    uint64_t largest_free_block;  /**< Largest contiguous free physical block in bytes */
+    uint64_t page_cache_hits;     /**< Single-page allocations served by a per-CPU cache */
+    uint64_t page_cache_misses;   /**< Single-page allocations that refilled a per-CPU cache */
+    uint64_t allocator_contention;/**< Times the physical allocator lock was already held */
+    uint64_t entanglement_bytes_synced; /**< Bytes copied by entanglement synchronization */
+    uint32_t node_count;          /**< Number of memory nodes */
+    MemoryNodeStats nodes[MM_MAX_NODES]; /**< Statistics of each memory node */
 } MemoryStats;
 
 /**
@@ -97,17 +152,40 @@ void mm_shutdown(void);
 /**
  * @brief Allocate physical memory
  * 
+ * Physically contiguous memory comes from a buddy allocator over the memory
+ * the HAL reports as available, rounded up to a power-of-two number of
+ * pages and aligned to its own size. Single pages come from a per-CPU cache
+ * without taking the allocator lock. The same allocator backs
+ * HalOperations.alloc_physical_page/free_physical_page once the memory
+ * manager is initialized. Memory is taken from the calling CPU's node
+ * first (MM_POLICY_LOCAL).
+ * 
  * @param size Size to allocate in bytes
  * @param alignment Required alignment (power of 2, 0 for default)
  * @return Physical address or 0 on failure
  */
 HalPhysicalAddr mm_alloc_physical(uint64_t size, uint32_t alignment);
 
+/**
+ * @brief Allocate physical memory on a memory node
+ * 
+ * Each node has its own buddy allocator; single pages come from the cache of
+ * a CPU on the node. Unless the policy is MM_POLICY_BIND, an allocation the
+ * chosen node cannot satisfy is served by the following nodes in turn.
+ * 
+ * @param size Size to allocate in bytes
+ * @param alignment Required alignment (power of 2, 0 for default)
+ * @param policy Node placement policy
+ * @param node Node for MM_POLICY_PREFERRED and MM_POLICY_BIND (ignored otherwise)
+ * @return Physical address or 0 on failure
+ */
+HalPhysicalAddr mm_alloc_physical_policy(uint64_t size, uint32_t alignment, MemoryPolicy policy, uint32_t node);
+
 /**
  * @brief Free physical memory
  * 
- * @param addr Physical address to free
- * @param size Size to free in bytes
+ * @param addr Physical address to free, as returned by mm_alloc_physical()
+ * @param size Size to free in bytes (at most the allocated size)
  * @return true if freeing succeeded, false otherwise
  */
 bool mm_free_physical(HalPhysicalAddr addr, uint64_t size);
@@ -115,6 +193,15 @@ bool mm_free_physical(HalPhysicalAddr addr, uint64_t size);
 /**
  * @brief Allocate virtual memory
  * 
+ * Allocations of up to 2KB that are neither quantum nor entangled are
+ * carved from per-CPU slabs of a power-of-two size class instead of getting
+ * a region of their own. They cannot be entangled. The region is placed on
+ * the calling CPU's node (MM_POLICY_LOCAL).
+ * 
+ * With MM_FLAG_HUGE_2M or MM_FLAG_HUGE_1G the size is rounded up to whole
+ * huge pages, taken from the page allocator and mapped with the region's
+ * permissions. If the HAL cannot map memory, the flags are ignored.
+ * 
  * @param size Size to allocate in bytes
  * @param type Memory type
  * @param flags Memory flags
@@ -122,6 +209,23 @@ bool mm_free_physical(HalPhysicalAddr addr, uint64_t size);
  */
 HalVirtualAddr mm_alloc_virtual(uint64_t size, MemoryType type, uint32_t flags);
 
+/**
+ * @brief Allocate virtual memory on a memory node
+ * 
+ * The node chosen by the policy is recorded in the region, so the scheduler
+ * can keep the threads using it on that node's CPUs. Small allocations only
+ * use the slabs of the calling CPU when the chosen node is the CPU's own.
+ * 
+ * @param size Size to allocate in bytes
+ * @param type Memory type
+ * @param flags Memory flags
+ * @param policy Node placement policy
+ * @param node Node for MM_POLICY_PREFERRED and MM_POLICY_BIND (ignored otherwise)
+ * @return Virtual address or NULL on failure
+ */
+HalVirtualAddr mm_alloc_virtual_policy(uint64_t size, MemoryType type, uint32_t flags,
+                                       MemoryPolicy policy, uint32_t node);
+
 /**
  * @brief Free virtual memory
  * 
@@ -140,14 +244,44 @@ bool mm_free_virtual(HalVirtualAddr addr);
  */
 HalVirtualAddr mm_map_physical(HalPhysicalAddr physical, uint64_t size, uint32_t flags);
 
+/**
+ * @brief Map a file into virtual memory
+ * 
+ * The region has type MEMORY_TYPE_FILE. With MM_FLAG_WRITE changes are
+ * written back to the file; otherwise they stay private to the mapping.
+ * 
+ * @param path Path of the file
+ * @param offset Offset in the file (multiple of the page size)
+ * @param size Size to map in bytes (0 for the rest of the file)
+ * @param flags Memory flags
+ * @return Mapped virtual address or NULL on failure
+ */
+HalVirtualAddr mm_map_file(const char* path, uint64_t offset, uint64_t size, uint32_t flags);
+
 /**
  * @brief Get information about a memory region
  * 
+ * For a small allocation the region describes the slab object holding the
+ * address and is overwritten by the next lookup in the same slab.
+ * 
  * @param addr Address within the region
  * @return Pointer to the memory region or NULL if not found
  */
 MemoryRegion* mm_get_region_info(HalVirtualAddr addr);
 
+/**
+ * @brief Find the memory regions overlapping an address range
+ * 
+ * Small allocations are reported as the slab they are carved from.
+ * 
+ * @param start Start of the range
+ * @param size Size of the range in bytes
+ * @param regions Array to store the overlapping regions, in address order
+ * @param max_count Maximum number of regions to store
+ * @return Number of regions stored
+ */
+uint32_t mm_find_regions(HalVirtualAddr start, uint64_t size, MemoryRegion** regions, uint32_t max_count);
+
 /**
  * @brief Create quantum entanglement between two memory regions
  * 
@@ -175,14 +309,61 @@ bool mm_break_entanglement(uint64_t entanglement_id);
  */
 bool mm_get_entanglement_info(uint64_t entanglement_id, EntanglementInfo* info);
 
+/**
+ * @brief Mark part of an entangled region as changed
+ * 
+ * Changes are tracked in 4KB blocks. Once any block of an entanglement has
+ * been marked, synchronizing it copies only the marked blocks; until then
+ * every synchronization copies the whole region.
+ * 
+ * @param addr Start of the changed memory, within an entangled region
+ * @param size Size of the changed memory in bytes
+ * @return true if the memory was marked, false otherwise
+ */
+bool mm_mark_dirty(HalVirtualAddr addr, uint64_t size);
+
 /**
  * @brief Synchronize quantum-entangled memory regions
  * 
+ * Copies the region with the higher resonance level over the other one,
+ * limited to the blocks marked with mm_mark_dirty() if any were.
+ * 
  * @param entanglement_id Entanglement ID to synchronize
  * @return true if synchronization succeeded, false otherwise
  */
 bool mm_sync_entanglement(uint64_t entanglement_id);
 
+/**
+ * @brief Synchronize several entanglements
+ * 
+ * @param entanglement_ids IDs of the entanglements to synchronize
+ * @param count Number of IDs
+ * @return Number of entanglements synchronized
+ */
+uint32_t mm_sync_entanglements(const uint64_t* entanglement_ids, uint32_t count);
+
+/**
+ * @brief Get the number of memory nodes
+ * 
+ * @return Number of nodes (1 if the HAL does not describe them)
+ */
+uint32_t mm_get_node_count(void);
+
+/**
+ * @brief Get the memory node local to a CPU
+ * 
+ * @param cpu CPU index
+ * @return Node index (0 for unknown CPUs)
+ */
+uint32_t mm_get_cpu_node(uint32_t cpu);
+
+/**
+ * @brief Get the memory node local to the calling thread
+ * 
+ * @return Node index
+ */
+uint32_t mm_get_current_node(void);
+
 /**
  * @brief Get memory statistics
  * 
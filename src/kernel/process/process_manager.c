@@ -3,11 +3,17 @@
  * @brief Process Management System implementation
  */
 
+/* Recursive mutexes and clock_gettime under -std=c11 */
+#define _XOPEN_SOURCE 700
+
 #include "process_manager.h"
+#include "../../quantum/entanglement/entanglement_registry.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <errno.h>
+#include <pthread.h>
 
 /* Process management state */
 static bool pm_initialized = false;
@@ -19,91 +25,302 @@ static Process* process_list_head = NULL;
 static uint64_t next_process_id = 1;
 static uint64_t next_thread_id = 1;
 
-/* Process entanglement tracking */
+/* Called before a thread structure is freed */
+static ThreadReleaseHook thread_release_hook = NULL;
+
+/*
+ * ID indexes
+ *
+ * Open-addressing hash tables map process and thread IDs to their objects,
+ * so lookups no longer walk the process list and every thread list. Slots
+ * are probed linearly from a Fibonacci hash of the ID; removal shifts later
+ * entries of the probe run back instead of leaving tombstones. A table
+ * doubles once it is half full.
+ */
+#define ID_INDEX_MIN_CAPACITY 64
+
+typedef struct {
+    uint64_t* ids;      /* 0 marks an empty slot */
+    void** objects;
+    uint32_t capacity;  /* Power of two */
+    uint32_t count;
+} IdIndex;
+
+static IdIndex process_index = {0};
+static IdIndex thread_index = {0};
+
+/*
+ * Object slabs
+ *
+ * Process and Thread structures come from chunks of objects of one size
+ * with a free list threaded through the free objects, instead of one
+ * malloc per object. Chunks are returned to the system at shutdown.
+ */
+#define SLAB_CHUNK_OBJECTS 64
+
+typedef struct SlabChunk {
+    struct SlabChunk* next;
+} SlabChunk;
+
+typedef struct {
+    size_t object_size;
+    SlabChunk* chunks;
+    void* free_list;
+} ObjectSlab;
+
+static ObjectSlab process_slab = { sizeof(Process), NULL, NULL };
+static ObjectSlab thread_slab = { sizeof(Thread), NULL, NULL };
+
+/* Process entanglements are QEREG_KIND_PROCESS entries of the shared registry */
 #define MAX_PROCESS_ENTANGLEMENTS 128
-static ProcessEntanglement process_entanglements[MAX_PROCESS_ENTANGLEMENTS];
-static uint64_t next_entanglement_id = 1;
+
+_Static_assert(sizeof(ProcessEntanglement) <= QEREG_PAYLOAD_SIZE, "entanglement must fit a registry payload");
+
+/* IDs of entanglements waiting for synchronization (is_synchronized false) */
+static uint64_t dirty_entanglements[MAX_PROCESS_ENTANGLEMENTS];
+static uint32_t dirty_entanglement_count = 0;
+
+/*
+ * Locking
+ *
+ * Every process manager function that changes processes, threads or
+ * entanglements holds this recursive lock, so the sync engine thread can
+ * work alongside them. Lookups do not take it; only callers create and
+ * destroy objects, and they do so under the lock.
+ */
+static pthread_mutex_t pm_mutex;
+static bool pm_mutex_initialized = false;
+
+/* Background sync engine */
+static pthread_t sync_engine_thread;
+static pthread_mutex_t sync_engine_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sync_engine_cond;
+static bool sync_engine_running = false;
+static uint32_t sync_engine_interval_ms = 0;
+static uint32_t sync_engine_batch_size = 0;
 
 /**
- * @brief Find a process by ID
+ * @brief Get the home slot of an ID in an index
  */
-static Process* find_process(ProcessId process_id) {
-    Process* process = process_list_head;
+static uint32_t id_index_slot(const IdIndex* index, uint64_t id) {
+    return (uint32_t)((id * 0x9E3779B97F4A7C15ULL) >> 32) & (index->capacity - 1);
+}
+
+/**
+ * @brief Find the object stored for an ID
+ */
+static void* id_index_find(const IdIndex* index, uint64_t id) {
+    if (index->capacity == 0 || id == 0) {
+        return NULL;
+    }
     
-    while (process) {
-        if (process->id == process_id) {
-            return process;
+    for (uint32_t slot = id_index_slot(index, id); index->ids[slot] != 0;
+         slot = (slot + 1) & (index->capacity - 1)) {
+        if (index->ids[slot] == id) {
+            return index->objects[slot];
         }
-        process = process->next;
     }
     
     return NULL;
 }
 
 /**
- * @brief Find a thread by ID
+ * @brief Store an entry in an index that has room for it
  */
-static Thread* find_thread(ThreadId thread_id) {
-    Process* process = process_list_head;
+static void id_index_place(IdIndex* index, uint64_t id, void* object) {
+    uint32_t slot = id_index_slot(index, id);
+    while (index->ids[slot] != 0) {
+        slot = (slot + 1) & (index->capacity - 1);
+    }
     
-    while (process) {
-        Thread* thread = process->threads;
-        while (thread) {
-            if (thread->id == thread_id) {
-                return thread;
+    index->ids[slot] = id;
+    index->objects[slot] = object;
+    index->count++;
+}
+
+/**
+ * @brief Add an ID to an index, growing it if needed
+ */
+static bool id_index_insert(IdIndex* index, uint64_t id, void* object) {
+    if ((index->count + 1) * 2 > index->capacity) {
+        uint32_t capacity = index->capacity ? index->capacity * 2 : ID_INDEX_MIN_CAPACITY;
+        uint64_t* ids = (uint64_t*)calloc(capacity, sizeof(uint64_t));
+        void** objects = (void**)calloc(capacity, sizeof(void*));
+        if (!ids || !objects) {
+            free(ids);
+            free(objects);
+            return false;
+        }
+        
+        /* Rehash into the larger table */
+        IdIndex grown = { ids, objects, capacity, 0 };
+        for (uint32_t i = 0; i < index->capacity; i++) {
+            if (index->ids[i] != 0) {
+                id_index_place(&grown, index->ids[i], index->objects[i]);
             }
-            thread = thread->next;
         }
-        process = process->next;
+        
+        free(index->ids);
+        free(index->objects);
+        *index = grown;
     }
     
-    return NULL;
+    id_index_place(index, id, object);
+    return true;
 }
 
 /**
- * @brief Find a thread by ID within a specific process
+ * @brief Remove an ID from an index
  */
-static Thread* find_thread_in_process(ProcessId process_id, ThreadId thread_id) {
-    Process* process = find_process(process_id);
-    if (!process) {
-        return NULL;
+static void id_index_remove(IdIndex* index, uint64_t id) {
+    if (index->capacity == 0) {
+        return;
     }
     
-    Thread* thread = process->threads;
-    while (thread) {
-        if (thread->id == thread_id) {
-            return thread;
+    uint32_t mask = index->capacity - 1;
+    uint32_t slot = id_index_slot(index, id);
+    while (index->ids[slot] != id) {
+        if (index->ids[slot] == 0) {
+            return;
         }
-        thread = thread->next;
+        slot = (slot + 1) & mask;
     }
     
-    return NULL;
+    /* Shift back later entries whose probe run passes through the hole */
+    uint32_t hole = slot;
+    for (uint32_t next = (hole + 1) & mask; index->ids[next] != 0; next = (next + 1) & mask) {
+        uint32_t home = id_index_slot(index, index->ids[next]);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            index->ids[hole] = index->ids[next];
+            index->objects[hole] = index->objects[next];
+            hole = next;
+        }
+    }
+    
+    index->ids[hole] = 0;
+    index->objects[hole] = NULL;
+    index->count--;
+}
+
+/**
+ * @brief Release an index's tables
+ */
+static void id_index_clear(IdIndex* index) {
+    free(index->ids);
+    free(index->objects);
+    memset(index, 0, sizeof(*index));
+}
+
+/**
+ * @brief Take a zeroed object from a slab
+ */
+static void* slab_alloc(ObjectSlab* slab) {
+    if (!slab->free_list) {
+        /* Carve a new chunk into free objects */
+        SlabChunk* chunk = (SlabChunk*)malloc(sizeof(SlabChunk) + slab->object_size * SLAB_CHUNK_OBJECTS);
+        if (!chunk) {
+            return NULL;
+        }
+        chunk->next = slab->chunks;
+        slab->chunks = chunk;
+        
+        uint8_t* objects = (uint8_t*)(chunk + 1);
+        for (int i = SLAB_CHUNK_OBJECTS - 1; i >= 0; i--) {
+            void* object = objects + (size_t)i * slab->object_size;
+            *(void**)object = slab->free_list;
+            slab->free_list = object;
+        }
+    }
+    
+    void* object = slab->free_list;
+    slab->free_list = *(void**)object;
+    memset(object, 0, slab->object_size);
+    
+    return object;
+}
+
+/**
+ * @brief Return an object to its slab
+ */
+static void slab_free(ObjectSlab* slab, void* object) {
+    *(void**)object = slab->free_list;
+    slab->free_list = object;
+}
+
+/**
+ * @brief Return all of a slab's chunks to the system
+ */
+static void slab_release(ObjectSlab* slab) {
+    while (slab->chunks) {
+        SlabChunk* next = slab->chunks->next;
+        free(slab->chunks);
+        slab->chunks = next;
+    }
+    slab->free_list = NULL;
+}
+
+/**
+ * @brief Find a process by ID
+ */
+static Process* find_process(ProcessId process_id) {
+    return (Process*)id_index_find(&process_index, process_id);
+}
+
+/**
+ * @brief Find a thread by ID
+ */
+static Thread* find_thread(ThreadId thread_id) {
+    return (Thread*)id_index_find(&thread_index, thread_id);
 }
 
 /**
  * @brief Find a process entanglement by ID
  */
 static ProcessEntanglement* find_entanglement(uint64_t entanglement_id) {
-    for (int i = 0; i < MAX_PROCESS_ENTANGLEMENTS; i++) {
-        if (process_entanglements[i].id == entanglement_id) {
-            return &process_entanglements[i];
-        }
+    return (ProcessEntanglement*)qereg_find(QEREG_KIND_PROCESS, entanglement_id);
+}
+
+/**
+ * @brief Add an entanglement to the dirty set
+ */
+static void mark_entanglement_dirty(ProcessEntanglement* entanglement) {
+    /* Entanglements not synchronized are already in the set */
+    if (!entanglement->is_synchronized) {
+        return;
     }
     
-    return NULL;
+    entanglement->is_synchronized = false;
+    dirty_entanglements[dirty_entanglement_count++] = entanglement->id;
+    pm_stats.dirty_entanglements = dirty_entanglement_count;
 }
 
 /**
- * @brief Find a free entanglement slot
+ * @brief Remove an entanglement from the dirty set
  */
-static ProcessEntanglement* find_free_entanglement_slot(void) {
-    for (int i = 0; i < MAX_PROCESS_ENTANGLEMENTS; i++) {
-        if (process_entanglements[i].id == 0) {
-            return &process_entanglements[i];
+static void clear_entanglement_dirty(ProcessEntanglement* entanglement) {
+    for (uint32_t i = 0; i < dirty_entanglement_count; i++) {
+        if (dirty_entanglements[i] == entanglement->id) {
+            dirty_entanglements[i] = dirty_entanglements[--dirty_entanglement_count];
+            break;
         }
     }
     
-    return NULL;
+    entanglement->is_synchronized = true;
+    pm_stats.dirty_entanglements = dirty_entanglement_count;
+}
+
+/**
+ * @brief Mark a process's entanglement dirty if it has one
+ */
+static void mark_process_dirty(const Process* process) {
+    if (process->entanglement_id == 0) {
+        return;
+    }
+    
+    ProcessEntanglement* entanglement = find_entanglement(process->entanglement_id);
+    if (entanglement) {
+        mark_entanglement_dirty(entanglement);
+    }
 }
 
 /**
@@ -140,6 +357,7 @@ static void remove_thread_from_process(Process* process, Thread* thread) {
     }
     
     process->thread_count--;
+    id_index_remove(&thread_index, thread->id);
     
     /* Update statistics */
     pm_stats.total_threads--;
@@ -184,6 +402,7 @@ static void remove_process(Process* process) {
     if (process->next) {
         process->next->prev = process->prev;
     }
+    id_index_remove(&process_index, process->id);
     
     /* Update statistics */
     pm_stats.total_processes--;
@@ -221,7 +440,11 @@ static void update_process_state(Process* process, ProcessState new_state) {
     }
     
     /* Update process state */
+    bool changed = process->state != new_state;
     process->state = new_state;
+    if (changed) {
+        mark_process_dirty(process);
+    }
     
     /* If process is terminated, update its threads */
     if (new_state == PROCESS_TERMINATED) {
@@ -237,9 +460,12 @@ static void update_process_state(Process* process, ProcessState new_state) {
  * @brief Initialize process entanglement table
  */
 static void init_process_entanglements(void) {
-    memset(process_entanglements, 0, sizeof(process_entanglements));
-    next_entanglement_id = 1;
+    qereg_clear(QEREG_KIND_PROCESS, NULL);
+    qereg_set_limit(QEREG_KIND_PROCESS, MAX_PROCESS_ENTANGLEMENTS);
     pm_stats.total_entanglements = 0;
+    
+    dirty_entanglement_count = 0;
+    pm_stats.dirty_entanglements = 0;
 }
 
 /**
@@ -251,6 +477,20 @@ bool pm_init(uint32_t max_processes) {
         return true;
     }
     
+    /* The lock is recursive so scheduler callbacks can re-enter the manager */
+    if (!pm_mutex_initialized) {
+        pthread_mutexattr_t attr;
+        pthread_mutexattr_init(&attr);
+        pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+        if (pthread_mutex_init(&pm_mutex, &attr) != 0) {
+            pthread_mutexattr_destroy(&attr);
+            printf("Failed to initialize process manager lock\n");
+            return false;
+        }
+        pthread_mutexattr_destroy(&attr);
+        pm_mutex_initialized = true;
+    }
+    
     /* Initialize process management state */
     pm_max_processes = (max_processes > 0) ? max_processes : MAX_PROCESSES;
     memset(&pm_stats, 0, sizeof(pm_stats));
@@ -275,6 +515,10 @@ void pm_shutdown(void) {
         return;
     }
     
+    /* The engine takes the lock itself, so stop it before holding it */
+    pm_stop_sync_engine();
+    pm_lock();
+    
     /* Terminate all processes */
     while (process_list_head) {
         pm_terminate_process(process_list_head->id, 0);
@@ -284,6 +528,10 @@ void pm_shutdown(void) {
     pm_max_processes = 0;
     memset(&pm_stats, 0, sizeof(pm_stats));
     process_list_head = NULL;
+    id_index_clear(&process_index);
+    id_index_clear(&thread_index);
+    slab_release(&process_slab);
+    slab_release(&thread_slab);
     next_process_id = 1;
     next_thread_id = 1;
     
@@ -291,13 +539,16 @@ void pm_shutdown(void) {
     init_process_entanglements();
     
     pm_initialized = false;
+    pm_unlock();
     printf("Process Manager shutdown complete\n");
 }
 
 /**
  * @brief Create a new process
+ *
+ * Caller must hold the process manager lock.
  */
-bool pm_create_process(const ProcessParams* params, ProcessId* process_id) {
+static bool create_process_locked(const ProcessParams* params, ProcessId* process_id) {
     if (!pm_initialized || !params || !process_id) {
         return false;
     }
@@ -309,14 +560,13 @@ bool pm_create_process(const ProcessParams* params, ProcessId* process_id) {
     }
     
     /* Allocate a new process structure */
-    Process* process = (Process*)malloc(sizeof(Process));
+    Process* process = (Process*)slab_alloc(&process_slab);
     if (!process) {
         printf("Cannot create process: memory allocation failed\n");
         return false;
     }
     
     /* Initialize the process */
-    memset(process, 0, sizeof(Process));
     process->id = next_process_id++;
     strncpy(process->name, params->name, sizeof(process->name) - 1);
     process->state = PROCESS_CREATED;
@@ -340,7 +590,7 @@ bool pm_create_process(const ProcessParams* params, ProcessId* process_id) {
     
     if (!process->memory_map) {
         printf("Cannot create process: memory allocation failed\n");
-        free(process);
+        slab_free(&process_slab, process);
         return false;
     }
     
@@ -361,17 +611,24 @@ bool pm_create_process(const ProcessParams* params, ProcessId* process_id) {
         .quantum_capable = params->quantum_capable
     };
     
+    /* Add process to the list (the main thread looks its process up) */
+    if (!id_index_insert(&process_index, process->id, process)) {
+        printf("Cannot create process: memory allocation failed\n");
+        mm_free_virtual(process->memory_map);
+        slab_free(&process_slab, process);
+        return false;
+    }
+    add_process(process);
+    
     ThreadId main_thread_id;
     if (!pm_create_thread(&thread_params, &main_thread_id)) {
         printf("Cannot create process: main thread creation failed\n");
+        remove_process(process);
         mm_free_virtual(process->memory_map);
-        free(process);
+        slab_free(&process_slab, process);
         return false;
     }
     
-    /* Add process to the list */
-    add_process(process);
-    
     /* Return the process ID */
     *process_id = process->id;
     
@@ -381,10 +638,22 @@ bool pm_create_process(const ProcessParams* params, ProcessId* process_id) {
     return true;
 }
 
+/**
+ * @brief Create a new process
+ */
+bool pm_create_process(const ProcessParams* params, ProcessId* process_id) {
+    pm_lock();
+    bool result = create_process_locked(params, process_id);
+    pm_unlock();
+    return result;
+}
+
 /**
  * @brief Terminate a process
+ *
+ * Caller must hold the process manager lock.
  */
-bool pm_terminate_process(ProcessId process_id, uint64_t exit_code) {
+static bool terminate_process_locked(ProcessId process_id, uint64_t exit_code) {
     if (!pm_initialized) {
         return false;
     }
@@ -427,14 +696,17 @@ bool pm_terminate_process(ProcessId process_id, uint64_t exit_code) {
             mm_free_virtual(thread->stack_base);
         }
         
-        free(thread);
+        if (thread_release_hook) {
+            thread_release_hook(thread);
+        }
+        slab_free(&thread_slab, thread);
     }
     
     /* Remove process from the list */
     remove_process(process);
     
     /* Free the process structure */
-    free(process);
+    slab_free(&process_slab, process);
     
     printf("Terminated process %llu with exit code %llu\n", 
            (unsigned long long)process_id, (unsigned long long)exit_code);
@@ -442,10 +714,22 @@ bool pm_terminate_process(ProcessId process_id, uint64_t exit_code) {
     return true;
 }
 
+/**
+ * @brief Terminate a process
+ */
+bool pm_terminate_process(ProcessId process_id, uint64_t exit_code) {
+    pm_lock();
+    bool result = terminate_process_locked(process_id, exit_code);
+    pm_unlock();
+    return result;
+}
+
 /**
  * @brief Create a new thread in a process
+ *
+ * Caller must hold the process manager lock.
  */
-bool pm_create_thread(const ThreadParams* params, ThreadId* thread_id) {
+static bool create_thread_locked(const ThreadParams* params, ThreadId* thread_id) {
     if (!pm_initialized || !params || !thread_id) {
         return false;
     }
@@ -471,14 +755,13 @@ bool pm_create_thread(const ThreadParams* params, ThreadId* thread_id) {
     }
     
     /* Allocate a new thread structure */
-    Thread* thread = (Thread*)malloc(sizeof(Thread));
+    Thread* thread = (Thread*)slab_alloc(&thread_slab);
     if (!thread) {
         printf("Cannot create thread: memory allocation failed\n");
         return false;
     }
     
     /* Initialize the thread */
-    memset(thread, 0, sizeof(Thread));
     thread->id = next_thread_id++;
     thread->process_id = params->process_id;
     thread->state = THREAD_CREATED;
@@ -486,6 +769,7 @@ bool pm_create_thread(const ThreadParams* params, ThreadId* thread_id) {
     thread->entry_point = params->entry_point;
     thread->user_data = params->arg;
     thread->resonance_level = process->resonance_level; /* Inherit from process */
+    thread->quantum_probability = 1.0;
     
     /* Allocate stack for the thread */
     uint64_t stack_size = params->stack_size > 0 ? params->stack_size : (1024 * 1024); /* 1MB default */
@@ -498,7 +782,7 @@ bool pm_create_thread(const ThreadParams* params, ThreadId* thread_id) {
     
     if (!thread->stack_base) {
         printf("Cannot create thread: stack allocation failed\n");
-        free(thread);
+        slab_free(&thread_slab, thread);
         return false;
     }
     
@@ -509,7 +793,14 @@ bool pm_create_thread(const ThreadParams* params, ThreadId* thread_id) {
     thread->context.program_counter = (uint64_t)params->entry_point;
     
     /* Add thread to the process */
+    if (!id_index_insert(&thread_index, thread->id, thread)) {
+        printf("Cannot create thread: memory allocation failed\n");
+        mm_free_virtual(thread->stack_base);
+        slab_free(&thread_slab, thread);
+        return false;
+    }
     add_thread_to_process(process, thread);
+    mark_process_dirty(process);
     
     /* Return the thread ID */
     *thread_id = thread->id;
@@ -520,10 +811,22 @@ bool pm_create_thread(const ThreadParams* params, ThreadId* thread_id) {
     return true;
 }
 
+/**
+ * @brief Create a new thread in a process
+ */
+bool pm_create_thread(const ThreadParams* params, ThreadId* thread_id) {
+    pm_lock();
+    bool result = create_thread_locked(params, thread_id);
+    pm_unlock();
+    return result;
+}
+
 /**
  * @brief Terminate a thread
+ *
+ * Caller must hold the process manager lock.
  */
-bool pm_terminate_thread(ThreadId thread_id, uint64_t exit_code) {
+static bool terminate_thread_locked(ThreadId thread_id, uint64_t exit_code) {
     if (!pm_initialized) {
         return false;
     }
@@ -572,7 +875,10 @@ bool pm_terminate_thread(ThreadId thread_id, uint64_t exit_code) {
             mm_free_virtual(thread->stack_base);
         }
         
-        free(thread);
+        if (thread_release_hook) {
+            thread_release_hook(thread);
+        }
+        slab_free(&thread_slab, thread);
         
         printf("Terminated thread %llu in process %llu\n", 
                (unsigned long long)thread_id, (unsigned long long)process->id);
@@ -581,6 +887,16 @@ bool pm_terminate_thread(ThreadId thread_id, uint64_t exit_code) {
     return true;
 }
 
+/**
+ * @brief Terminate a thread
+ */
+bool pm_terminate_thread(ThreadId thread_id, uint64_t exit_code) {
+    pm_lock();
+    bool result = terminate_thread_locked(thread_id, exit_code);
+    pm_unlock();
+    return result;
+}
+
 /**
  * @brief Get information about a process
  */
@@ -605,8 +921,10 @@ Thread* pm_get_thread(ThreadId thread_id) {
 
 /**
  * @brief Set process priority
+ *
+ * Caller must hold the process manager lock.
  */
-bool pm_set_process_priority(ProcessId process_id, PriorityLevel priority) {
+static bool set_process_priority_locked(ProcessId process_id, PriorityLevel priority) {
     if (!pm_initialized) {
         return false;
     }
@@ -626,14 +944,27 @@ bool pm_set_process_priority(ProcessId process_id, PriorityLevel priority) {
         thread->priority = priority;
         thread = thread->next;
     }
+    mark_process_dirty(process);
     
     return true;
 }
 
+/**
+ * @brief Set process priority
+ */
+bool pm_set_process_priority(ProcessId process_id, PriorityLevel priority) {
+    pm_lock();
+    bool result = set_process_priority_locked(process_id, priority);
+    pm_unlock();
+    return result;
+}
+
 /**
  * @brief Set thread priority
+ *
+ * Caller must hold the process manager lock.
  */
-bool pm_set_thread_priority(ThreadId thread_id, PriorityLevel priority) {
+static bool set_thread_priority_locked(ThreadId thread_id, PriorityLevel priority) {
     if (!pm_initialized) {
         return false;
     }
@@ -647,14 +978,38 @@ bool pm_set_thread_priority(ThreadId thread_id, PriorityLevel priority) {
     /* Update priority */
     thread->priority = priority;
     
+    Process* process = find_process(thread->process_id);
+    if (process) {
+        mark_process_dirty(process);
+    }
+    
     return true;
 }
 
+/**
+ * @brief Set thread priority
+ */
+bool pm_set_thread_priority(ThreadId thread_id, PriorityLevel priority) {
+    pm_lock();
+    bool result = set_thread_priority_locked(thread_id, priority);
+    pm_unlock();
+    return result;
+}
+
+/**
+ * @brief Set the hook called before a thread structure is freed
+ */
+void pm_set_thread_release_hook(ThreadReleaseHook hook) {
+    thread_release_hook = hook;
+}
+
 /**
  * @brief Create quantum entanglement between two processes
+ *
+ * Caller must hold the process manager lock.
  */
-uint64_t pm_create_process_entanglement(ProcessId first_process_id, ProcessId second_process_id,
-                                        ProcessEntanglementType type, NodeLevel resonance_level) {
+static uint64_t create_process_entanglement_locked(ProcessId first_process_id, ProcessId second_process_id,
+                                                   ProcessEntanglementType type, NodeLevel resonance_level) {
     if (!pm_initialized) {
         return 0;
     }
@@ -681,15 +1036,15 @@ uint64_t pm_create_process_entanglement(ProcessId first_process_id, ProcessId se
         return 0;
     }
     
-    /* Find a free entanglement slot */
-    ProcessEntanglement* slot = find_free_entanglement_slot();
-    if (!slot) {
+    /* Reserve an entanglement slot */
+    ProcessEntanglement* slot = NULL;
+    uint64_t entanglement_id = qereg_reserve(QEREG_KIND_PROCESS, (void**)&slot);
+    if (entanglement_id == 0) {
         printf("Cannot create process entanglement: maximum entanglements reached\n");
         return 0;
     }
     
     /* Set up the entanglement */
-    uint64_t entanglement_id = next_entanglement_id++;
     slot->id = entanglement_id;
     slot->first_process = first_process_id;
     slot->second_process = second_process_id;
@@ -697,6 +1052,7 @@ uint64_t pm_create_process_entanglement(ProcessId first_process_id, ProcessId se
     slot->resonance_level = resonance_level;
     slot->stability = 0.95; /* Initial stability */
     slot->is_synchronized = true;
+    qereg_publish(entanglement_id);
     
     /* Update the processes */
     first_process->entanglement_id = entanglement_id;
@@ -728,10 +1084,23 @@ uint64_t pm_create_process_entanglement(ProcessId first_process_id, ProcessId se
     return entanglement_id;
 }
 
+/**
+ * @brief Create quantum entanglement between two processes
+ */
+uint64_t pm_create_process_entanglement(ProcessId first_process_id, ProcessId second_process_id,
+                                        ProcessEntanglementType type, NodeLevel resonance_level) {
+    pm_lock();
+    uint64_t result = create_process_entanglement_locked(first_process_id, second_process_id, type, resonance_level);
+    pm_unlock();
+    return result;
+}
+
 /**
  * @brief Break process entanglement
+ *
+ * Caller must hold the process manager lock.
  */
-bool pm_break_process_entanglement(uint64_t entanglement_id) {
+static bool break_process_entanglement_locked(uint64_t entanglement_id) {
     if (!pm_initialized) {
         return false;
     }
@@ -779,7 +1148,8 @@ bool pm_break_process_entanglement(uint64_t entanglement_id) {
     }
     
     /* Clear the entanglement slot */
-    memset(entanglement, 0, sizeof(ProcessEntanglement));
+    clear_entanglement_dirty(entanglement);
+    qereg_remove(QEREG_KIND_PROCESS, entanglement_id);
     
     /* Update statistics */
     pm_stats.total_entanglements--;
@@ -791,21 +1161,19 @@ bool pm_break_process_entanglement(uint64_t entanglement_id) {
 }
 
 /**
- * @brief Synchronize entangled processes
+ * @brief Break process entanglement
  */
-bool pm_sync_process_entanglement(uint64_t entanglement_id) {
-    if (!pm_initialized) {
-        return false;
-    }
-    
-    /* Find the entanglement */
-    ProcessEntanglement* entanglement = find_entanglement(entanglement_id);
-    if (!entanglement) {
-        printf("Cannot synchronize process entanglement: entanglement %llu not found\n", 
-               (unsigned long long)entanglement_id);
-        return false;
-    }
-    
+bool pm_break_process_entanglement(uint64_t entanglement_id) {
+    pm_lock();
+    bool result = break_process_entanglement_locked(entanglement_id);
+    pm_unlock();
+    return result;
+}
+
+/**
+ * @brief Synchronize the two processes of an entanglement
+ */
+static bool sync_entanglement(ProcessEntanglement* entanglement) {
     /* Find the processes */
     Process* first_process = find_process(entanglement->first_process);
     Process* second_process = find_process(entanglement->second_process);
@@ -908,7 +1276,7 @@ bool pm_sync_process_entanglement(uint64_t entanglement_id) {
     }
     
     /* Mark as synchronized */
-    entanglement->is_synchronized = true;
+    clear_entanglement_dirty(entanglement);
     
     /* Reduce stability slightly due to synchronization stress */
     entanglement->stability *= 0.99;
@@ -919,11 +1287,231 @@ bool pm_sync_process_entanglement(uint64_t entanglement_id) {
     /* Update statistics */
     pm_stats.total_quantum_ops++;
     
+    return true;
+}
+
+/**
+ * @brief Synchronize entangled processes
+ *
+ * Caller must hold the process manager lock.
+ */
+static bool sync_process_entanglement_locked(uint64_t entanglement_id) {
+    if (!pm_initialized) {
+        return false;
+    }
+    
+    /* Find the entanglement */
+    ProcessEntanglement* entanglement = find_entanglement(entanglement_id);
+    if (!entanglement) {
+        printf("Cannot synchronize process entanglement: entanglement %llu not found\n", 
+               (unsigned long long)entanglement_id);
+        return false;
+    }
+    
+    if (!sync_entanglement(entanglement)) {
+        return false;
+    }
+    
     printf("Synchronized process entanglement (ID: %llu)\n", (unsigned long long)entanglement_id);
     
     return true;
 }
 
+/**
+ * @brief Synchronize entangled processes
+ */
+bool pm_sync_process_entanglement(uint64_t entanglement_id) {
+    pm_lock();
+    bool result = sync_process_entanglement_locked(entanglement_id);
+    pm_unlock();
+    return result;
+}
+
+/**
+ * @brief Mark a process's entanglement as needing synchronization
+ */
+void pm_mark_process_dirty(ProcessId process_id) {
+    if (!pm_initialized) {
+        return;
+    }
+    
+    pm_lock();
+    Process* process = find_process(process_id);
+    if (process) {
+        mark_process_dirty(process);
+    }
+    pm_unlock();
+}
+
+/**
+ * @brief Synchronize entanglements marked as needing it
+ */
+uint32_t pm_sync_dirty_entanglements(uint32_t max_count) {
+    if (!pm_initialized) {
+        return 0;
+    }
+    
+    pm_lock();
+    
+    /* Take the batch first; syncing can mark entanglements dirty again */
+    uint64_t batch[MAX_PROCESS_ENTANGLEMENTS];
+    uint32_t batch_count = dirty_entanglement_count;
+    if (max_count > 0 && batch_count > max_count) {
+        batch_count = max_count;
+    }
+    memcpy(batch, &dirty_entanglements[dirty_entanglement_count - batch_count], batch_count * sizeof(uint64_t));
+    
+    uint32_t synced = 0;
+    for (uint32_t i = 0; i < batch_count; i++) {
+        ProcessEntanglement* entanglement = find_entanglement(batch[i]);
+        if (!entanglement) {
+            continue;
+        }
+        if (sync_entanglement(entanglement)) {
+            synced++;
+        } else {
+            /* Leave it out of the set rather than retrying it forever */
+            clear_entanglement_dirty(entanglement);
+        }
+    }
+    pm_stats.entanglement_syncs += synced;
+    
+    pm_unlock();
+    
+    return synced;
+}
+
+/**
+ * @brief Background sync engine loop
+ */
+static void* sync_engine_main(void* arg) {
+    (void)arg;
+    
+    pthread_mutex_lock(&sync_engine_mutex);
+    while (sync_engine_running) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        uint64_t nsec = (uint64_t)deadline.tv_nsec + (uint64_t)sync_engine_interval_ms * 1000000ULL;
+        deadline.tv_sec += (time_t)(nsec / 1000000000ULL);
+        deadline.tv_nsec = (long)(nsec % 1000000000ULL);
+        
+        /* Sleep out the interval unless stopped */
+        int wait_result = 0;
+        while (sync_engine_running && wait_result != ETIMEDOUT) {
+            wait_result = pthread_cond_timedwait(&sync_engine_cond, &sync_engine_mutex, &deadline);
+        }
+        if (!sync_engine_running) {
+            break;
+        }
+        
+        pthread_mutex_unlock(&sync_engine_mutex);
+        pm_sync_dirty_entanglements(sync_engine_batch_size);
+        pthread_mutex_lock(&sync_engine_mutex);
+    }
+    pthread_mutex_unlock(&sync_engine_mutex);
+    
+    return NULL;
+}
+
+/**
+ * @brief Start the background entanglement sync engine
+ */
+bool pm_start_sync_engine(uint32_t interval_ms, uint32_t batch_size) {
+    if (!pm_initialized) {
+        return false;
+    }
+    
+    pthread_mutex_lock(&sync_engine_mutex);
+    if (sync_engine_running) {
+        pthread_mutex_unlock(&sync_engine_mutex);
+        return false;
+    }
+    
+    sync_engine_interval_ms = (interval_ms > 0) ? interval_ms : 1;
+    sync_engine_batch_size = batch_size;
+    
+    /* Timed waits use the monotonic clock */
+    pthread_condattr_t cond_attr;
+    pthread_condattr_init(&cond_attr);
+    pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&sync_engine_cond, &cond_attr);
+    pthread_condattr_destroy(&cond_attr);
+    
+    sync_engine_running = true;
+    if (pthread_create(&sync_engine_thread, NULL, sync_engine_main, NULL) != 0) {
+        sync_engine_running = false;
+        pthread_cond_destroy(&sync_engine_cond);
+        pthread_mutex_unlock(&sync_engine_mutex);
+        printf("Cannot start entanglement sync engine: thread creation failed\n");
+        return false;
+    }
+    pthread_mutex_unlock(&sync_engine_mutex);
+    
+    printf("Entanglement sync engine started (interval: %u ms, batch: %u)\n",
+           sync_engine_interval_ms, batch_size);
+    
+    return true;
+}
+
+/**
+ * @brief Stop the background entanglement sync engine
+ */
+void pm_stop_sync_engine(void) {
+    pthread_mutex_lock(&sync_engine_mutex);
+    if (!sync_engine_running) {
+        pthread_mutex_unlock(&sync_engine_mutex);
+        return;
+    }
+    
+    sync_engine_running = false;
+    pthread_cond_signal(&sync_engine_cond);
+    pthread_mutex_unlock(&sync_engine_mutex);
+    
+    pthread_join(sync_engine_thread, NULL);
+    pthread_cond_destroy(&sync_engine_cond);
+    
+    printf("Entanglement sync engine stopped\n");
+}
+
+/**
+ * @brief Get the partner of an execution-entangled process
+ */
+ProcessId pm_get_execution_partner(ProcessId process_id) {
+    if (!pm_initialized) {
+        return 0;
+    }
+    
+    pm_lock();
+    ProcessId partner = 0;
+    Process* process = find_process(process_id);
+    ProcessEntanglement* entanglement = process ? find_entanglement(process->entanglement_id) : NULL;
+    if (entanglement && entanglement->type == ENTANGLE_EXECUTION) {
+        partner = (entanglement->first_process == process_id) ? entanglement->second_process
+                                                               : entanglement->first_process;
+    }
+    pm_unlock();
+    
+    return partner;
+}
+
+/**
+ * @brief Acquire the process manager lock
+ */
+void pm_lock(void) {
+    if (pm_mutex_initialized) {
+        pthread_mutex_lock(&pm_mutex);
+    }
+}
+
+/**
+ * @brief Release the process manager lock
+ */
+void pm_unlock(void) {
+    if (pm_mutex_initialized) {
+        pthread_mutex_unlock(&pm_mutex);
+    }
+}
+
 /**
  * @brief Get a list of all processes
  */
@@ -972,12 +1560,20 @@ uint32_t pm_get_process_threads(ProcessId process_id, Thread** threads, uint32_t
  * @brief Get process statistics
  */
 void pm_get_stats(ProcessStats* stats) {
-    if (!pm_initialized || !stats) {
+    if (!stats) {
+        return;
+    }
+    
+    /* Nothing exists before initialization or after shutdown */
+    if (!pm_initialized) {
+        memset(stats, 0, sizeof(ProcessStats));
         return;
     }
     
     /* Copy the statistics */
+    pm_lock();
     memcpy(stats, &pm_stats, sizeof(ProcessStats));
+    pm_unlock();
 }
 
 /**
@@ -997,4 +1593,6 @@ void pm_print_stats(void) {
     printf("Total Process Entanglements: %u\n", pm_stats.total_entanglements);
     printf("Total Context Switches: %llu\n", (unsigned long long)pm_stats.total_context_switches);
     printf("Total Quantum Operations: %llu\n", (unsigned long long)pm_stats.total_quantum_ops);
+    printf("Dirty Entanglements: %u\n", pm_stats.dirty_entanglements);
+    printf("Entanglement Syncs: %llu\n", (unsigned long long)pm_stats.entanglement_syncs);
 }
\ No newline at end of file
@@ -118,8 +118,32 @@ typedef struct Thread {
     NodeLevel resonance_level;     /**< Thread resonance level */
     struct Thread* next;           /**< Next thread in list */
     struct Thread* prev;           /**< Previous thread in list */
+    struct Thread* run_next;       /**< Next thread in the scheduler ready queue */
+    struct Thread* run_prev;       /**< Previous thread in the scheduler ready queue */
+    PriorityLevel run_priority;    /**< Ready queue the thread is linked into */
+    uint32_t run_cpu;              /**< CPU whose ready queue holds (or last held) the thread */
+    bool run_queued;               /**< Whether the thread is in a ready queue */
+    double quantum_probability;    /**< Scheduler execution probability (1.0 outside superposition) */
+    PriorityLevel mlfq_level;      /**< Feedback queue level under SCHEDULER_MULTILEVEL_FEEDBACK */
+    uint64_t mlfq_slice_used;      /**< Runtime consumed at the current feedback level */
+    uint64_t mlfq_epoch;           /**< Scheduler reset epoch the feedback level belongs to */
+    uint64_t rt_runtime;           /**< Deadline reservation: runtime per period in nanoseconds (0 if none) */
+    uint64_t rt_period;            /**< Deadline reservation: period in nanoseconds */
+    uint64_t rt_deadline;          /**< Deadline reservation: relative deadline in nanoseconds */
+    uint64_t rt_abs_deadline;      /**< Absolute deadline of the current period */
+    uint64_t rt_budget_used;       /**< Runtime consumed in the current period */
+    uint32_t rt_cpu;               /**< CPU that admitted the reservation */
+    uint32_t rt_heap_slot;         /**< Position in the CPU's deadline heap plus one (0 if not queued there) */
+    uint32_t quantum_slot;         /**< Position in the CPU's quantum sampling tree plus one (0 if absent) */
 } Thread;
 
+/**
+ * @brief Hook called just before a thread structure is freed
+ * 
+ * Lets the scheduler unlink the thread from its ready queue.
+ */
+typedef void (*ThreadReleaseHook)(Thread* thread);
+
 /**
  * @brief Process structure
  */
@@ -156,6 +180,8 @@ typedef struct {
     uint32_t total_entanglements;   /**< Total number of process entanglements */
     uint64_t total_context_switches;/**< Total number of context switches */
     uint64_t total_quantum_ops;     /**< Total number of quantum operations */
+    uint32_t dirty_entanglements;   /**< Entanglements waiting for the sync engine */
+    uint64_t entanglement_syncs;    /**< Entanglements synchronized by the sync engine */
 } ProcessStats;
 
 /**
@@ -294,6 +320,64 @@ bool pm_break_process_entanglement(uint64_t entanglement_id);
  */
 bool pm_sync_process_entanglement(uint64_t entanglement_id);
 
+/**
+ * @brief Mark a process's entanglement as needing synchronization
+ * 
+ * Process state, priority and thread changes mark entanglements
+ * automatically; code that changes entangled processes or threads directly
+ * (such as the scheduler) calls this.
+ * 
+ * @param process_id Process ID
+ */
+void pm_mark_process_dirty(ProcessId process_id);
+
+/**
+ * @brief Synchronize entanglements marked as needing it
+ * 
+ * @param max_count Maximum number of entanglements to synchronize
+ * @return Number of entanglements synchronized
+ */
+uint32_t pm_sync_dirty_entanglements(uint32_t max_count);
+
+/**
+ * @brief Start the background entanglement sync engine
+ * 
+ * A background thread synchronizes up to batch_size dirty entanglements
+ * every interval_ms milliseconds while holding the process manager lock.
+ * 
+ * @param interval_ms Sync cadence in milliseconds (0 for 1 ms)
+ * @param batch_size Maximum entanglements per batch (0 for all)
+ * @return true if the engine was started, false otherwise
+ */
+bool pm_start_sync_engine(uint32_t interval_ms, uint32_t batch_size);
+
+/**
+ * @brief Stop the background entanglement sync engine
+ */
+void pm_stop_sync_engine(void);
+
+/**
+ * @brief Get the partner of an execution-entangled process
+ * 
+ * @param process_id Process ID
+ * @return Partner process ID, or 0 if the process is not execution-entangled
+ */
+ProcessId pm_get_execution_partner(ProcessId process_id);
+
+/**
+ * @brief Acquire the process manager lock
+ * 
+ * All process manager functions take this recursive lock. While the sync
+ * engine runs, code that changes Process or Thread fields directly must
+ * hold it as well.
+ */
+void pm_lock(void);
+
+/**
+ * @brief Release the process manager lock
+ */
+void pm_unlock(void);
+
 /**
  * @brief Get a list of all processes
  * 
@@ -313,6 +397,13 @@ uint32_t pm_get_all_processes(Process** processes, uint32_t max_count);
  */
 uint32_t pm_get_process_threads(ProcessId process_id, Thread** threads, uint32_t max_count);
 
+/**
+ * @brief Set the hook called before a thread structure is freed
+ * 
+ * @param hook Hook function (NULL to clear)
+ */
+void pm_set_thread_release_hook(ThreadReleaseHook hook);
+
 /**
  * @brief Get process statistics
  * 
@@ -9,15 +9,89 @@
 #include <string.h>
 #include <time.h>
 #include "../hal/hal.h"
+#include "../trace/trace.h"
 
 /* Scheduler state */
 static bool scheduler_initialized = false;
 static bool scheduler_running = false;
 static SchedulerState scheduler_state = {0};
 
-/* Ready queues for different priority levels */
+/*
+ * Per-CPU ready queues
+ *
+ * Every logical CPU has one ready queue per priority level. Threads are
+ * linked into their queue through the run_next/run_prev links embedded in
+ * Thread, so queueing never allocates. Bit i of a CPU's bitmap is set while
+ * its queue i is non-empty; the highest set bit is the highest runnable
+ * priority. A running thread is not queued; it goes back to the tail of its
+ * CPU's queue when it is switched out.
+ *
+ * Under SCHEDULER_REALTIME, threads with a deadline reservation wait in a
+ * per-CPU min-heap ordered by absolute deadline instead, ahead of every
+ * priority queue.
+ *
+ * Under SCHEDULER_QUANTUM, every queued thread also has a slot in its CPU's
+ * Fenwick tree of integer weights, so a weighted random pick takes
+ * O(log n) instead of a walk over every queue. Slots are kept dense by
+ * moving the last slot into any slot that is vacated.
+ */
 #define PRIORITY_QUEUE_COUNT (PRIORITY_QUANTUM + 1)
-static SchedulerQueueEntry* ready_queues[PRIORITY_QUEUE_COUNT] = {NULL};
+
+typedef struct {
+    Thread* head;
+    Thread* tail;
+} ReadyQueue;
+
+typedef struct {
+    ReadyQueue queues[PRIORITY_QUEUE_COUNT];
+    uint32_t bitmap;
+    uint32_t queued;
+    ThreadId current_thread;
+    ProcessId current_process;
+    uint64_t last_context_switch;
+    uint64_t context_switches;
+    Thread* deadline_heap[SCHEDULER_MAX_DEADLINE_THREADS];
+    uint32_t deadline_queued;
+    uint32_t deadline_threads;
+    uint64_t deadline_utilization;
+    Thread** quantum_threads;
+    uint64_t* quantum_weights;
+    uint64_t* quantum_tree;
+    uint32_t quantum_count;
+    uint32_t quantum_capacity;
+} CpuRunqueue;
+
+/* Fixed-point scale of quantum sampling weights */
+#define QUANTUM_WEIGHT_SCALE (1u << 20)
+
+static CpuRunqueue cpu_runqueues[SCHEDULER_MAX_CPUS];
+static uint64_t cpu_random_state[SCHEDULER_MAX_CPUS];
+static uint32_t cpu_count = 1;
+
+/*
+ * Memory node affinity
+ *
+ * Threads are placed on a CPU of the memory node their stack lives on,
+ * unless every such CPU has more than SCHEDULER_NUMA_IMBALANCE threads more
+ * than the least loaded CPU overall. Idle CPUs steal from CPUs on their own
+ * node first.
+ */
+#define SCHEDULER_NUMA_IMBALANCE 2
+
+static uint32_t cpu_node[SCHEDULER_MAX_CPUS];
+static uint64_t last_balance = 0;
+
+/*
+ * Multilevel feedback
+ *
+ * Under SCHEDULER_MULTILEVEL_FEEDBACK threads are queued by their feedback
+ * level instead of their priority. A thread's level is valid only for the
+ * reset epoch it was computed in; bumping the epoch returns every thread to
+ * its own priority the next time it is queued.
+ */
+static uint64_t level_time_slices[PRIORITY_QUEUE_COUNT];
+static uint64_t mlfq_epoch = 1;
+static uint64_t last_mlfq_reset = 0;
 
 /* Quantum superposition state tracking */
 #define MAX_SUPERPOSITIONS 32
@@ -28,13 +102,635 @@ typedef struct {
 } SuperpositionState;
 static SuperpositionState superposition_states[MAX_SUPERPOSITIONS] = {0};
 
+static void release_thread(Thread* thread);
+
 /**
  * @brief Get current timestamp in nanoseconds
+ *
+ * Scheduler times come from the trace clock, so they line up with the
+ * context switches it records.
  */
 static uint64_t get_timestamp_ns(void) {
-    /* In a real implementation, this would use a high-precision timer */
-    /* For simulation, we'll just use time() and convert to nanoseconds */
-    return (uint64_t)time(NULL) * 1000000000ULL;
+    return trace_now();
+}
+
+/**
+ * @brief Get the default time slice of a feedback level
+ *
+ * Lower levels hold CPU-bound threads and get longer slices.
+ */
+static uint64_t default_level_time_slice(PriorityLevel level) {
+    if (level > PRIORITY_HIGHEST) {
+        return scheduler_state.time_slice;
+    }
+    
+    return scheduler_state.time_slice * (uint64_t)(PRIORITY_HIGHEST - level + 1);
+}
+
+/**
+ * @brief Whether multilevel feedback moves a thread between levels
+ */
+static bool uses_feedback(const Thread* thread) {
+    return scheduler_state.type == SCHEDULER_MULTILEVEL_FEEDBACK && thread->priority <= PRIORITY_HIGHEST;
+}
+
+/**
+ * @brief Get the ready queue a thread belongs in
+ */
+static PriorityLevel queue_priority(Thread* thread) {
+    if (!uses_feedback(thread)) {
+        return thread->priority;
+    }
+    
+    /* Levels from before the last reset start over at the thread's priority */
+    if (thread->mlfq_epoch != mlfq_epoch) {
+        thread->mlfq_level = thread->priority;
+        thread->mlfq_slice_used = 0;
+        thread->mlfq_epoch = mlfq_epoch;
+    }
+    
+    return thread->mlfq_level;
+}
+
+/**
+ * @brief Get the time slice a thread may run for
+ */
+static uint64_t thread_time_slice(Thread* thread) {
+    if (!uses_feedback(thread)) {
+        return scheduler_state.time_slice;
+    }
+    
+    return level_time_slices[queue_priority(thread)];
+}
+
+/**
+ * @brief Charge a switched-out thread's runtime to its feedback level
+ *
+ * Threads that use their whole slice drop a level; threads that block
+ * before using it rise one, up to one level above their own priority.
+ */
+static void account_feedback(Thread* thread, uint64_t elapsed) {
+    if (!uses_feedback(thread)) {
+        return;
+    }
+    
+    PriorityLevel level = queue_priority(thread);
+    thread->mlfq_slice_used += elapsed;
+    
+    if (thread->state == THREAD_RUNNING && thread->mlfq_slice_used >= level_time_slices[level]) {
+        if (level > PRIORITY_LOWEST) {
+            thread->mlfq_level = (PriorityLevel)(level - 1);
+            scheduler_state.mlfq_demotions++;
+        }
+        thread->mlfq_slice_used = 0;
+    } else if (thread->state == THREAD_BLOCKED && thread->mlfq_slice_used < level_time_slices[level]) {
+        PriorityLevel ceiling = thread->priority < PRIORITY_HIGHEST ?
+                                (PriorityLevel)(thread->priority + 1) : PRIORITY_HIGHEST;
+        if (level < ceiling) {
+            thread->mlfq_level = (PriorityLevel)(level + 1);
+            thread->mlfq_slice_used = 0;
+            scheduler_state.mlfq_boosts++;
+        }
+    }
+}
+
+/**
+ * @brief Determine the number of CPUs to schedule from the HAL
+ */
+static uint32_t detect_cpu_count(void) {
+    const HalOperations* hal_ops = hal_get_operations();
+    if (!hal_ops || !hal_ops->get_processor_info) {
+        return 1;
+    }
+    
+    HalProcessorInfo info;
+    hal_ops->get_processor_info(&info);
+    
+    if (info.core_count == 0) {
+        return 1;
+    }
+    
+    return info.core_count < SCHEDULER_MAX_CPUS ? info.core_count : SCHEDULER_MAX_CPUS;
+}
+
+/**
+ * @brief Whether a thread is scheduled by its deadline reservation
+ */
+static bool uses_deadline(const Thread* thread) {
+    return scheduler_state.type == SCHEDULER_REALTIME && thread->rt_runtime != 0;
+}
+
+/**
+ * @brief Get a reservation's share of a CPU
+ */
+static uint64_t deadline_utilization(uint64_t runtime, uint64_t period) {
+    return runtime * SCHEDULER_UTILIZATION_SCALE / period;
+}
+
+/**
+ * @brief Store a thread at a deadline heap position
+ */
+static void heap_place(CpuRunqueue* rq, uint32_t index, Thread* thread) {
+    rq->deadline_heap[index] = thread;
+    thread->rt_heap_slot = index + 1;
+}
+
+/**
+ * @brief Restore heap order around one position
+ */
+static void heap_fix(CpuRunqueue* rq, uint32_t index) {
+    Thread* thread = rq->deadline_heap[index];
+    
+    /* Sift up towards earlier deadlines */
+    while (index > 0) {
+        uint32_t parent = (index - 1) / 2;
+        if (rq->deadline_heap[parent]->rt_abs_deadline <= thread->rt_abs_deadline) {
+            break;
+        }
+        heap_place(rq, index, rq->deadline_heap[parent]);
+        index = parent;
+    }
+    
+    /* Sift down past earlier deadlines */
+    for (;;) {
+        uint32_t child = index * 2 + 1;
+        if (child >= rq->deadline_queued) {
+            break;
+        }
+        if (child + 1 < rq->deadline_queued &&
+            rq->deadline_heap[child + 1]->rt_abs_deadline < rq->deadline_heap[child]->rt_abs_deadline) {
+            child++;
+        }
+        if (thread->rt_abs_deadline <= rq->deadline_heap[child]->rt_abs_deadline) {
+            break;
+        }
+        heap_place(rq, index, rq->deadline_heap[child]);
+        index = child;
+    }
+    
+    heap_place(rq, index, thread);
+}
+
+/**
+ * @brief Remove a thread from its CPU's deadline heap
+ */
+static void heap_remove(CpuRunqueue* rq, Thread* thread) {
+    uint32_t index = thread->rt_heap_slot - 1;
+    Thread* last = rq->deadline_heap[--rq->deadline_queued];
+    
+    thread->rt_heap_slot = 0;
+    if (last != thread) {
+        heap_place(rq, index, last);
+        heap_fix(rq, index);
+    }
+}
+
+/**
+ * @brief Derive a well-mixed 64-bit value from a seed (splitmix64)
+ */
+static uint64_t mix_seed(uint64_t seed) {
+    seed += 0x9E3779B97F4A7C15ULL;
+    seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+    return seed ^ (seed >> 31);
+}
+
+/**
+ * @brief Get the next random value of a CPU's generator (xorshift64*)
+ */
+static uint64_t next_random(uint32_t cpu) {
+    uint64_t x = cpu_random_state[cpu];
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    cpu_random_state[cpu] = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/**
+ * @brief Seed the random number generators of SCHEDULER_QUANTUM
+ */
+void scheduler_seed_random(uint64_t seed) {
+    for (uint32_t cpu = 0; cpu < SCHEDULER_MAX_CPUS; cpu++) {
+        /* xorshift must never be seeded with zero */
+        uint64_t state = mix_seed(seed + cpu);
+        cpu_random_state[cpu] = state ? state : 1;
+    }
+}
+
+/**
+ * @brief Get a queued thread's quantum sampling weight
+ */
+static uint64_t quantum_weight(const Thread* thread) {
+    double weight = thread->quantum_probability * (thread->run_priority + 1) * QUANTUM_WEIGHT_SCALE;
+    return weight > 0.0 ? (uint64_t)weight : 0;
+}
+
+/**
+ * @brief Add a weight change to a CPU's Fenwick tree
+ */
+static void quantum_tree_add(CpuRunqueue* rq, uint32_t slot, uint64_t old_weight, uint64_t new_weight) {
+    for (uint32_t i = slot + 1; i <= rq->quantum_capacity; i += i & (0u - i)) {
+        rq->quantum_tree[i - 1] += new_weight - old_weight;
+    }
+}
+
+/**
+ * @brief Grow a CPU's quantum sampling tree to twice its capacity
+ */
+static bool quantum_grow(CpuRunqueue* rq) {
+    uint32_t capacity = rq->quantum_capacity ? rq->quantum_capacity * 2 : 64;
+    
+    Thread** threads = (Thread**)realloc(rq->quantum_threads, capacity * sizeof(Thread*));
+    if (!threads) {
+        return false;
+    }
+    rq->quantum_threads = threads;
+    
+    uint64_t* weights = (uint64_t*)realloc(rq->quantum_weights, capacity * sizeof(uint64_t));
+    if (!weights) {
+        return false;
+    }
+    rq->quantum_weights = weights;
+    
+    uint64_t* tree = (uint64_t*)realloc(rq->quantum_tree, capacity * sizeof(uint64_t));
+    if (!tree) {
+        return false;
+    }
+    rq->quantum_tree = tree;
+    rq->quantum_capacity = capacity;
+    
+    /* Rebuild the tree for the new size in O(n) */
+    memset(tree, 0, capacity * sizeof(uint64_t));
+    for (uint32_t i = 0; i < rq->quantum_count; i++) {
+        tree[i] = weights[i];
+    }
+    for (uint32_t i = 1; i <= capacity; i++) {
+        uint32_t parent = i + (i & (0u - i));
+        if (parent <= capacity) {
+            tree[parent - 1] += tree[i - 1];
+        }
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Give a queued thread a slot in its CPU's quantum sampling tree
+ */
+static void quantum_insert(CpuRunqueue* rq, Thread* thread) {
+    if (rq->quantum_count == rq->quantum_capacity && !quantum_grow(rq)) {
+        /* Out of memory: the thread is still picked by priority as a fallback */
+        return;
+    }
+    
+    uint32_t slot = rq->quantum_count++;
+    uint64_t weight = quantum_weight(thread);
+    rq->quantum_threads[slot] = thread;
+    rq->quantum_weights[slot] = weight;
+    quantum_tree_add(rq, slot, 0, weight);
+    thread->quantum_slot = slot + 1;
+}
+
+/**
+ * @brief Remove a thread from its CPU's quantum sampling tree
+ */
+static void quantum_erase(CpuRunqueue* rq, Thread* thread) {
+    uint32_t slot = thread->quantum_slot - 1;
+    uint32_t last = --rq->quantum_count;
+    
+    /* Move the last slot's thread into the vacated slot */
+    quantum_tree_add(rq, slot, rq->quantum_weights[slot], rq->quantum_weights[last]);
+    quantum_tree_add(rq, last, rq->quantum_weights[last], 0);
+    if (slot != last) {
+        Thread* moved = rq->quantum_threads[last];
+        rq->quantum_threads[slot] = moved;
+        rq->quantum_weights[slot] = rq->quantum_weights[last];
+        moved->quantum_slot = slot + 1;
+    }
+    thread->quantum_slot = 0;
+}
+
+/**
+ * @brief Recompute a thread's weight after its probability changed
+ */
+static void quantum_update_weight(Thread* thread) {
+    if (thread->quantum_slot == 0) {
+        return;
+    }
+    
+    CpuRunqueue* rq = &cpu_runqueues[thread->run_cpu];
+    uint32_t slot = thread->quantum_slot - 1;
+    uint64_t weight = quantum_weight(thread);
+    quantum_tree_add(rq, slot, rq->quantum_weights[slot], weight);
+    rq->quantum_weights[slot] = weight;
+}
+
+/**
+ * @brief Pick a thread from a CPU's quantum sampling tree by weight
+ *
+ * @return Picked thread, or NULL if no thread has a positive weight
+ */
+static Thread* quantum_sample(uint32_t cpu) {
+    CpuRunqueue* rq = &cpu_runqueues[cpu];
+    if (rq->quantum_capacity == 0) {
+        return NULL;
+    }
+    
+    /* The root of a power-of-two sized tree holds the total weight */
+    uint64_t total = rq->quantum_tree[rq->quantum_capacity - 1];
+    if (total == 0) {
+        return NULL;
+    }
+    
+    /* Descend to the slot whose cumulative weight range holds the draw */
+    uint64_t remaining = next_random(cpu) % total;
+    uint32_t position = 0;
+    for (uint32_t step = rq->quantum_capacity; step > 0; step >>= 1) {
+        uint32_t next = position + step;
+        if (next <= rq->quantum_capacity && rq->quantum_tree[next - 1] <= remaining) {
+            position = next;
+            remaining -= rq->quantum_tree[next - 1];
+        }
+    }
+    
+    return rq->quantum_threads[position];
+}
+
+/**
+ * @brief Add a thread to the back of a priority queue on a CPU
+ *
+ * A thread that is already queued stays where it is. Deadline scheduled
+ * threads go to the deadline heap of the CPU that admitted them instead.
+ */
+static void add_to_queue(uint32_t cpu, Thread* thread, PriorityLevel priority) {
+    if (thread->run_queued) {
+        return;
+    }
+    
+    if (uses_deadline(thread)) {
+        /* A thread waking after its deadline starts a new period */
+        uint64_t now = get_timestamp_ns();
+        if (now >= thread->rt_abs_deadline) {
+            thread->rt_abs_deadline = now + thread->rt_deadline;
+            thread->rt_budget_used = 0;
+        }
+        
+        CpuRunqueue* rq = &cpu_runqueues[thread->rt_cpu];
+        heap_place(rq, rq->deadline_queued++, thread);
+        heap_fix(rq, thread->rt_heap_slot - 1);
+        
+        thread->run_cpu = thread->rt_cpu;
+        thread->run_queued = true;
+        return;
+    }
+    
+    /* Validate priority */
+    if (priority >= PRIORITY_QUEUE_COUNT) {
+        priority = PRIORITY_NORMAL;
+    }
+    
+    CpuRunqueue* rq = &cpu_runqueues[cpu];
+    ReadyQueue* queue = &rq->queues[priority];
+    thread->run_next = NULL;
+    thread->run_prev = queue->tail;
+    if (queue->tail) {
+        queue->tail->run_next = thread;
+    } else {
+        queue->head = thread;
+    }
+    queue->tail = thread;
+    
+    thread->run_priority = priority;
+    thread->run_cpu = cpu;
+    thread->run_queued = true;
+    rq->bitmap |= 1u << priority;
+    rq->queued++;
+    
+    if (scheduler_state.type == SCHEDULER_QUANTUM) {
+        quantum_insert(rq, thread);
+    }
+}
+
+/**
+ * @brief Remove a thread from its CPU's priority queue
+ */
+static bool remove_from_queues(Thread* thread) {
+    if (!thread->run_queued) {
+        return false;
+    }
+    
+    CpuRunqueue* rq = &cpu_runqueues[thread->run_cpu];
+    if (thread->rt_heap_slot != 0) {
+        heap_remove(rq, thread);
+        thread->run_queued = false;
+        return true;
+    }
+    
+    ReadyQueue* queue = &rq->queues[thread->run_priority];
+    if (thread->run_prev) {
+        thread->run_prev->run_next = thread->run_next;
+    } else {
+        queue->head = thread->run_next;
+    }
+    if (thread->run_next) {
+        thread->run_next->run_prev = thread->run_prev;
+    } else {
+        queue->tail = thread->run_prev;
+    }
+    
+    if (!queue->head) {
+        rq->bitmap &= ~(1u << thread->run_priority);
+    }
+    rq->queued--;
+    
+    if (thread->quantum_slot != 0) {
+        quantum_erase(rq, thread);
+    }
+    
+    thread->run_next = NULL;
+    thread->run_prev = NULL;
+    thread->run_queued = false;
+    
+    return true;
+}
+
+/**
+ * @brief Get the highest priority with a waiting thread on a CPU
+ *
+ * @return Priority level, or -1 if all of the CPU's queues are empty
+ */
+static int highest_ready_priority(const CpuRunqueue* rq) {
+    if (rq->bitmap == 0) {
+        return -1;
+    }
+    
+    return 31 - __builtin_clz(rq->bitmap);
+}
+
+/**
+ * @brief Get the CPU a thread is executing on
+ *
+ * @return CPU index, or -1 if the thread is not running
+ */
+static int find_running_cpu(ThreadId thread_id) {
+    for (uint32_t cpu = 0; cpu < cpu_count; cpu++) {
+        if (cpu_runqueues[cpu].current_thread == thread_id) {
+            return (int)cpu;
+        }
+    }
+    
+    return -1;
+}
+
+/**
+ * @brief Get a CPU's work, counting its running thread
+ */
+static uint32_t cpu_load(uint32_t cpu) {
+    const CpuRunqueue* rq = &cpu_runqueues[cpu];
+    return rq->queued + rq->deadline_queued + (rq->current_thread != 0 ? 1 : 0);
+}
+
+/**
+ * @brief Get the CPU with the least work, optionally only on one memory node
+ *
+ * @param node Memory node, or UINT32_MAX for any
+ * @return CPU index, or UINT32_MAX if the node has no CPUs
+ */
+static uint32_t least_loaded_cpu_on(uint32_t node) {
+    uint32_t best = UINT32_MAX;
+    uint32_t best_load = UINT32_MAX;
+    
+    for (uint32_t cpu = 0; cpu < cpu_count; cpu++) {
+        if (node != UINT32_MAX && cpu_node[cpu] != node) {
+            continue;
+        }
+        uint32_t load = cpu_load(cpu);
+        if (load < best_load) {
+            best = cpu;
+            best_load = load;
+        }
+    }
+    
+    return best;
+}
+
+/**
+ * @brief Get the CPU with the least work, counting its running thread
+ */
+static uint32_t least_loaded_cpu(void) {
+    return least_loaded_cpu_on(UINT32_MAX);
+}
+
+/**
+ * @brief Get the memory node a thread's stack lives on
+ *
+ * @return Node index, or UINT32_MAX if unknown
+ */
+static uint32_t thread_memory_node(const Thread* thread) {
+    MemoryRegion* region = thread->stack_base ? mm_get_region_info(thread->stack_base) : NULL;
+    return region ? region->node : UINT32_MAX;
+}
+
+/**
+ * @brief Get the CPU a thread without a CPU of its own should queue on
+ *
+ * Prefers the least loaded CPU on the thread's memory node while it is not
+ * much busier than the least loaded CPU overall.
+ */
+static uint32_t placement_cpu(const Thread* thread) {
+    uint32_t best = least_loaded_cpu();
+    uint32_t node = thread_memory_node(thread);
+    if (node == UINT32_MAX || cpu_node[best] == node) {
+        return best;
+    }
+    
+    uint32_t local = least_loaded_cpu_on(node);
+    if (local != UINT32_MAX && cpu_load(local) <= cpu_load(best) + SCHEDULER_NUMA_IMBALANCE) {
+        return local;
+    }
+    
+    return best;
+}
+
+/**
+ * @brief Get the CPU a waking thread should queue on
+ *
+ * Threads stay on the CPU they last ran on; threads whose CPU no longer
+ * exists go to the least loaded one.
+ */
+static uint32_t home_cpu(const Thread* thread) {
+    if (thread->rt_runtime != 0) {
+        return thread->rt_cpu;
+    }
+    
+    return thread->run_cpu < cpu_count ? thread->run_cpu : placement_cpu(thread);
+}
+
+/**
+ * @brief Whether a ready thread should preempt a CPU's running thread
+ */
+static bool should_preempt(Thread* thread, Thread* current) {
+    if (uses_deadline(current)) {
+        return uses_deadline(thread) && thread->rt_abs_deadline < current->rt_abs_deadline;
+    }
+    
+    return uses_deadline(thread) || queue_priority(thread) > queue_priority(current);
+}
+
+/**
+ * @brief Charge a switched-out thread's runtime to its deadline reservation
+ *
+ * A thread that uses up its runtime has its deadline moved to the next
+ * period, so it cannot delay other reservations; running past the runtime
+ * counts as an overrun. A thread still running after its deadline counts
+ * as a miss and starts a new period.
+ */
+static void account_deadline(Thread* thread, uint64_t elapsed, uint64_t now) {
+    if (!uses_deadline(thread)) {
+        return;
+    }
+    
+    thread->rt_budget_used += elapsed;
+    if (thread->rt_budget_used >= thread->rt_runtime) {
+        if (thread->rt_budget_used > thread->rt_runtime) {
+            scheduler_state.deadline_overruns++;
+        }
+        thread->rt_abs_deadline += thread->rt_period;
+        thread->rt_budget_used = 0;
+    }
+    
+    if (thread->state == THREAD_RUNNING && now > thread->rt_abs_deadline) {
+        scheduler_state.deadline_misses++;
+        thread->rt_abs_deadline = now + thread->rt_deadline;
+        thread->rt_budget_used = 0;
+    }
+}
+
+/**
+ * @brief Unlink a thread that the process manager is about to free
+ */
+static void release_thread(Thread* thread) {
+    remove_from_queues(thread);
+    
+    /* Give back the thread's deadline reservation */
+    if (thread->rt_runtime != 0) {
+        CpuRunqueue* rq = &cpu_runqueues[thread->rt_cpu];
+        rq->deadline_utilization -= deadline_utilization(thread->rt_runtime, thread->rt_period);
+        rq->deadline_threads--;
+        thread->rt_runtime = 0;
+    }
+    
+    int cpu = find_running_cpu(thread->id);
+    if (cpu >= 0) {
+        /* The CPU idles until its next context switch */
+        cpu_runqueues[cpu].current_thread = 0;
+        cpu_runqueues[cpu].current_process = 0;
+        if (cpu == 0) {
+            scheduler_state.current_thread = 0;
+            scheduler_state.current_process = 0;
+        }
+    }
 }
 
 /**
@@ -47,6 +743,7 @@ bool scheduler_init(SchedulerType type, uint64_t time_slice, bool preemption_ena
     }
     
     /* Initialize scheduler state */
+    memset(&scheduler_state, 0, sizeof(scheduler_state));
     scheduler_state.type = type;
     scheduler_state.current_process = 0;
     scheduler_state.current_thread = 0;
@@ -57,17 +754,32 @@ bool scheduler_init(SchedulerType type, uint64_t time_slice, bool preemption_ena
     scheduler_state.preemption_enabled = preemption_enabled;
     scheduler_state.resonance_level = NODE_ZERO_POINT;
     
-    /* Initialize ready queues */
+    /* One set of ready queues per logical CPU */
+    memset(cpu_runqueues, 0, sizeof(cpu_runqueues));
+    cpu_count = detect_cpu_count();
+    scheduler_state.cpu_count = cpu_count;
+    for (uint32_t cpu = 0; cpu < SCHEDULER_MAX_CPUS; cpu++) {
+        cpu_node[cpu] = mm_get_cpu_node(cpu);
+    }
+    last_balance = 0;
+    scheduler_seed_random((uint64_t)time(NULL));
+    
+    /* Feedback levels */
     for (int i = 0; i < PRIORITY_QUEUE_COUNT; i++) {
-        ready_queues[i] = NULL;
+        level_time_slices[i] = default_level_time_slice((PriorityLevel)i);
     }
+    mlfq_epoch++;
+    last_mlfq_reset = 0;
     
     /* Initialize superposition states */
     memset(superposition_states, 0, sizeof(superposition_states));
     
+    /* Unlink threads from the ready queues before they are freed */
+    pm_set_thread_release_hook(release_thread);
+    
     scheduler_initialized = true;
-    printf("Scheduler initialized (type: %d, time slice: %llu ns)\n", 
-           type, (unsigned long long)scheduler_state.time_slice);
+    printf("Scheduler initialized (type: %d, time slice: %llu ns, CPUs: %u)\n", 
+           type, (unsigned long long)scheduler_state.time_slice, cpu_count);
     
     return true;
 }
@@ -85,16 +797,31 @@ void scheduler_shutdown(void) {
         scheduler_stop();
     }
     
-    /* Free all queue entries */
-    for (int i = 0; i < PRIORITY_QUEUE_COUNT; i++) {
-        SchedulerQueueEntry* entry = ready_queues[i];
-        while (entry) {
-            SchedulerQueueEntry* next = entry->next;
-            free(entry);
-            entry = next;
+    /* Unlink all queued threads */
+    for (uint32_t cpu = 0; cpu < cpu_count; cpu++) {
+        for (int i = 0; i < PRIORITY_QUEUE_COUNT; i++) {
+            Thread* thread = cpu_runqueues[cpu].queues[i].head;
+            while (thread) {
+                Thread* next = thread->run_next;
+                thread->run_next = NULL;
+                thread->run_prev = NULL;
+                thread->run_queued = false;
+                thread = next;
+            }
+        }
+        for (uint32_t i = 0; i < cpu_runqueues[cpu].deadline_queued; i++) {
+            cpu_runqueues[cpu].deadline_heap[i]->rt_heap_slot = 0;
+            cpu_runqueues[cpu].deadline_heap[i]->run_queued = false;
         }
-        ready_queues[i] = NULL;
+        for (uint32_t i = 0; i < cpu_runqueues[cpu].quantum_count; i++) {
+            cpu_runqueues[cpu].quantum_threads[i]->quantum_slot = 0;
+        }
+        free(cpu_runqueues[cpu].quantum_threads);
+        free(cpu_runqueues[cpu].quantum_weights);
+        free(cpu_runqueues[cpu].quantum_tree);
     }
+    memset(cpu_runqueues, 0, sizeof(cpu_runqueues));
+    pm_set_thread_release_hook(NULL);
     
     /* Clear superposition states */
     memset(superposition_states, 0, sizeof(superposition_states));
@@ -104,208 +831,145 @@ void scheduler_shutdown(void) {
 }
 
 /**
- * @brief Add a thread to a priority queue
+ * @brief Take the next thread to run from a CPU's ready queues
  */
-static bool add_to_queue(ThreadId thread_id, PriorityLevel priority) {
-    /* Validate priority */
-    if (priority >= PRIORITY_QUEUE_COUNT) {
-        priority = PRIORITY_NORMAL;
-    }
-    
-    /* Get thread info */
-    Thread* thread = pm_get_thread(thread_id);
-    if (!thread) {
-        return false;
-    }
+static Thread* get_next_thread(uint32_t cpu) {
+    CpuRunqueue* rq = &cpu_runqueues[cpu];
     
-    /* Create a new queue entry */
-    SchedulerQueueEntry* entry = (SchedulerQueueEntry*)malloc(sizeof(SchedulerQueueEntry));
-    if (!entry) {
-        return false;
+    /* Implementation depends on scheduler type */
+    switch (scheduler_state.type) {
+        case SCHEDULER_ROUND_ROBIN:
+        case SCHEDULER_PRIORITY:
+        case SCHEDULER_MULTILEVEL_FEEDBACK:
+        case SCHEDULER_REALTIME: {
+            /* Deadline threads first, earliest deadline first */
+            if (rq->deadline_queued > 0) {
+                Thread* next = rq->deadline_heap[0];
+                remove_from_queues(next);
+                return next;
+            }
+            
+            /* Take the head of the highest non-empty queue */
+            int priority = highest_ready_priority(rq);
+            if (priority < 0) {
+                break;
+            }
+            
+            /* For multilevel feedback, the queues hold feedback levels */
+            Thread* next = rq->queues[priority].head;
+            remove_from_queues(next);
+            return next;
+        }
+            
+        case SCHEDULER_QUANTUM: {
+            /* Quantum scheduler considers superposition states */
+            /* Randomly select weighted by quantum probability and priority */
+            Thread* next = quantum_sample(cpu);
+            
+            /* Without positive weights, fall back to the highest priority */
+            if (!next) {
+                int priority = highest_ready_priority(rq);
+                if (priority < 0) {
+                    break;
+                }
+                next = rq->queues[priority].head;
+            }
+            
+            remove_from_queues(next);
+            return next;
+        }
     }
     
-    /* Initialize the entry */
-    entry->process_id = thread->process_id;
-    entry->thread_id = thread_id;
-    entry->priority = priority;
-    entry->quantum_probability = 1.0; /* Default to 100% execution probability */
-    entry->next = NULL;
+    return NULL; /* No thread found */
+}
+
+/**
+ * @brief Steal the most urgent waiting thread from the busiest other CPU
+ *
+ * CPUs on the same memory node are robbed before CPUs on other nodes.
+ */
+static Thread* steal_thread(uint32_t cpu) {
+    int victim = -1;
     
-    /* Check for superposition */
-    for (int i = 0; i < MAX_SUPERPOSITIONS; i++) {
-        if (superposition_states[i].thread_id == thread_id) {
-            entry->quantum_probability = superposition_states[i].probability;
-            break;
+    for (uint32_t i = 0; i < cpu_count; i++) {
+        if (i == cpu || cpu_runqueues[i].queued == 0) {
+            continue;
+        }
+        if (victim < 0) {
+            victim = (int)i;
+            continue;
+        }
+        bool local = cpu_node[i] == cpu_node[cpu];
+        bool victim_local = cpu_node[victim] == cpu_node[cpu];
+        if ((local && !victim_local) ||
+            (local == victim_local && cpu_runqueues[i].queued > cpu_runqueues[victim].queued)) {
+            victim = (int)i;
         }
     }
     
-    /* Add to the appropriate queue (at the end) */
-    if (ready_queues[priority] == NULL) {
-        ready_queues[priority] = entry;
-    } else {
-        SchedulerQueueEntry* current = ready_queues[priority];
-        while (current->next != NULL) {
-            current = current->next;
-        }
-        current->next = entry;
+    if (victim < 0) {
+        return NULL;
     }
     
-    return true;
+    CpuRunqueue* rq = &cpu_runqueues[victim];
+    Thread* thread = rq->queues[highest_ready_priority(rq)].head;
+    remove_from_queues(thread);
+    scheduler_state.threads_stolen++;
+    if (cpu_node[victim] != cpu_node[cpu]) {
+        scheduler_state.remote_steals++;
+    }
+    
+    return thread;
 }
 
 /**
- * @brief Remove a thread from priority queues
+ * @brief Even out ready queue lengths across CPUs
+ *
+ * Caller must hold the process manager lock.
  */
-static bool remove_from_queues(ThreadId thread_id) {
-    bool found = false;
+static uint32_t balance_load_locked(void) {
+    if (!scheduler_initialized) {
+        return 0;
+    }
     
-    /* Check all queues */
-    for (int i = 0; i < PRIORITY_QUEUE_COUNT; i++) {
-        SchedulerQueueEntry* prev = NULL;
-        SchedulerQueueEntry* current = ready_queues[i];
-        
-        while (current) {
-            if (current->thread_id == thread_id) {
-                /* Remove this entry */
-                if (prev) {
-                    prev->next = current->next;
-                } else {
-                    ready_queues[i] = current->next;
-                }
-                
-                free(current);
-                found = true;
-                break; /* Thread should only be in one queue */
+    uint32_t moved = 0;
+    
+    for (;;) {
+        uint32_t busiest = 0;
+        uint32_t idlest = 0;
+        for (uint32_t cpu = 1; cpu < cpu_count; cpu++) {
+            if (cpu_runqueues[cpu].queued > cpu_runqueues[busiest].queued) {
+                busiest = cpu;
+            }
+            if (cpu_runqueues[cpu].queued < cpu_runqueues[idlest].queued) {
+                idlest = cpu;
             }
-            
-            prev = current;
-            current = current->next;
         }
         
-        if (found) {
+        CpuRunqueue* from = &cpu_runqueues[busiest];
+        if (from->queued <= cpu_runqueues[idlest].queued + 1) {
             break;
         }
+        
+        /* Move the least urgent, most recently queued thread */
+        Thread* thread = from->queues[__builtin_ctz(from->bitmap)].tail;
+        remove_from_queues(thread);
+        add_to_queue(idlest, thread, thread->run_priority);
+        moved++;
     }
     
-    return found;
+    scheduler_state.threads_migrated += moved;
+    return moved;
 }
 
 /**
- * @brief Get the next thread to run from ready queues
+ * @brief Even out ready queue lengths across CPUs
  */
-static ThreadId get_next_thread(void) {
-    /* Implementation depends on scheduler type */
-    switch (scheduler_state.type) {
-        case SCHEDULER_ROUND_ROBIN:
-        case SCHEDULER_PRIORITY:
-        case SCHEDULER_MULTILEVEL_FEEDBACK:
-            /* Start with highest priority queue */
-            for (int i = PRIORITY_QUEUE_COUNT - 1; i >= 0; i--) {
-                if (ready_queues[i]) {
-                    /* Simple round-robin within priority level - take first thread and move to back */
-                    SchedulerQueueEntry* entry = ready_queues[i];
-                    ThreadId next_thread = entry->thread_id;
-                    
-                    /* Remove from front of queue */
-                    ready_queues[i] = entry->next;
-                    
-                    /* For multilevel feedback, adjust priority if using full time slice */
-                    if (scheduler_state.type == SCHEDULER_MULTILEVEL_FEEDBACK) {
-                        /* In a real implementation, we'd track time slice usage and adjust priority */
-                        /* For now, we'll just re-add at the same priority level */
-                    }
-                    
-                    /* Re-add to back of queue for round-robin */
-                    free(entry); /* Free old entry */
-                    add_to_queue(next_thread, i); /* Re-add to back of queue */
-                    
-                    return next_thread;
-                }
-            }
-            break;
-            
-        case SCHEDULER_REALTIME:
-            /* Real-time scheduler would have more sophisticated scheduling */
-            /* For now, just use priority scheduling */
-            for (int i = PRIORITY_QUEUE_COUNT - 1; i >= 0; i--) {
-                if (ready_queues[i]) {
-                    return ready_queues[i]->thread_id;
-                }
-            }
-            break;
-            
-        case SCHEDULER_QUANTUM:
-            /* Quantum scheduler considers superposition states */
-            /* Randomly select based on quantum probability */
-            
-            /* First, get all candidate threads with their probabilities */
-            ThreadId candidates[MAX_SUPERPOSITIONS * 2]; /* Allow for both superposition and normal threads */
-            double probabilities[MAX_SUPERPOSITIONS * 2];
-            int candidate_count = 0;
-            double total_probability = 0.0;
-            
-            /* Start with superposition threads */
-            for (int i = 0; i < MAX_SUPERPOSITIONS; i++) {
-                if (superposition_states[i].thread_id != 0) {
-                    candidates[candidate_count] = superposition_states[i].thread_id;
-                    probabilities[candidate_count] = superposition_states[i].probability;
-                    total_probability += probabilities[candidate_count];
-                    candidate_count++;
-                }
-            }
-            
-            /* Add normal threads from queues (prioritizing higher priority) */
-            for (int i = PRIORITY_QUEUE_COUNT - 1; i >= 0 && candidate_count < MAX_SUPERPOSITIONS * 2; i--) {
-                SchedulerQueueEntry* entry = ready_queues[i];
-                while (entry && candidate_count < MAX_SUPERPOSITIONS * 2) {
-                    /* Check if already in candidates (from superposition) */
-                    bool already_added = false;
-                    for (int j = 0; j < candidate_count; j++) {
-                        if (candidates[j] == entry->thread_id) {
-                            already_added = true;
-                            break;
-                        }
-                    }
-                    
-                    if (!already_added) {
-                        candidates[candidate_count] = entry->thread_id;
-                        probabilities[candidate_count] = entry->quantum_probability * (i + 1) / PRIORITY_QUEUE_COUNT;
-                        total_probability += probabilities[candidate_count];
-                        candidate_count++;
-                    }
-                    
-                    entry = entry->next;
-                }
-            }
-            
-            /* If no candidates, return 0 */
-            if (candidate_count == 0 || total_probability <= 0.0) {
-                return 0;
-            }
-            
-            /* Normalize probabilities */
-            for (int i = 0; i < candidate_count; i++) {
-                probabilities[i] /= total_probability;
-            }
-            
-            /* Select a thread based on probabilities */
-            double random_value = (double)rand() / RAND_MAX;
-            double cumulative_probability = 0.0;
-            
-            for (int i = 0; i < candidate_count; i++) {
-                cumulative_probability += probabilities[i];
-                if (random_value <= cumulative_probability) {
-                    return candidates[i];
-                }
-            }
-            
-            /* Fallback to first candidate if something went wrong */
-            return candidates[0];
-            
-            break;
-    }
-    
-    return 0; /* No thread found */
+uint32_t scheduler_balance_load(void) {
+    pm_lock();
+    uint32_t result = balance_load_locked();
+    pm_unlock();
+    return result;
 }
 
 /**
@@ -317,26 +981,53 @@ bool scheduler_start(void) {
     }
     
     /* Get initial timestamp */
-    scheduler_state.last_context_switch = get_timestamp_ns();
+    uint64_t now = get_timestamp_ns();
+    scheduler_state.last_context_switch = now;
+    last_balance = now;
+    last_mlfq_reset = now;
+    for (uint32_t cpu = 0; cpu < cpu_count; cpu++) {
+        cpu_runqueues[cpu].last_context_switch = now;
+    }
     
-    /* Initialize random seed for quantum scheduling */
+    /* Initialize random seed for quantum collapse */
     srand((unsigned int)time(NULL));
     
     scheduler_running = true;
     printf("Scheduler started\n");
     
-    /* Perform initial context switch */
-    return scheduler_context_switch(true);
+    /* Perform initial context switch on every CPU not already given a gang partner */
+    bool result = true;
+    for (uint32_t cpu = 0; cpu < cpu_count; cpu++) {
+        if (cpu_runqueues[cpu].current_thread == 0) {
+            result = scheduler_context_switch_cpu(cpu, true) && result;
+        }
+    }
+    
+    return result;
 }
 
 /**
  * @brief Stop the scheduler
+ *
+ * Caller must hold the process manager lock.
  */
-bool scheduler_stop(void) {
+static bool stop_locked(void) {
     if (!scheduler_initialized || !scheduler_running) {
         return false;
     }
     
+    /* Put running threads back at the tail of their CPU's queue */
+    for (uint32_t cpu = 0; cpu < cpu_count; cpu++) {
+        CpuRunqueue* rq = &cpu_runqueues[cpu];
+        Thread* current = rq->current_thread ? pm_get_thread(rq->current_thread) : NULL;
+        if (current && current->state == THREAD_RUNNING) {
+            current->state = THREAD_READY;
+            add_to_queue(cpu, current, queue_priority(current));
+        }
+        rq->current_thread = 0;
+        rq->current_process = 0;
+    }
+    
     scheduler_running = false;
     scheduler_state.current_process = 0;
     scheduler_state.current_thread = 0;
@@ -345,10 +1036,22 @@ bool scheduler_stop(void) {
     return true;
 }
 
+/**
+ * @brief Stop the scheduler
+ */
+bool scheduler_stop(void) {
+    pm_lock();
+    bool result = stop_locked();
+    pm_unlock();
+    return result;
+}
+
 /**
  * @brief Add a thread to the ready queue
+ *
+ * Caller must hold the process manager lock.
  */
-bool scheduler_add_thread(ThreadId thread_id) {
+static bool add_thread_locked(ThreadId thread_id) {
     if (!scheduler_initialized) {
         return false;
     }
@@ -359,33 +1062,66 @@ bool scheduler_add_thread(ThreadId thread_id) {
         return false;
     }
     
+    /* A running thread is requeued when it is switched out */
+    if (find_running_cpu(thread_id) >= 0) {
+        return true;
+    }
+    
     /* Remove from queues if already present */
-    remove_from_queues(thread_id);
+    remove_from_queues(thread);
     
     /* Update thread state */
-    if (thread->state != THREAD_RUNNING) {
-        thread->state = THREAD_READY;
-    }
+    thread->state = THREAD_READY;
     
-    /* Add to appropriate queue */
-    return add_to_queue(thread_id, thread->priority);
+    /* Place on the CPU with the least work, near the thread's memory */
+    add_to_queue(placement_cpu(thread), thread, queue_priority(thread));
+    return true;
+}
+
+/**
+ * @brief Add a thread to the ready queue
+ */
+bool scheduler_add_thread(ThreadId thread_id) {
+    pm_lock();
+    bool result = add_thread_locked(thread_id);
+    pm_unlock();
+    return result;
 }
 
 /**
  * @brief Remove a thread from the ready queue
+ *
+ * Caller must hold the process manager lock.
  */
-bool scheduler_remove_thread(ThreadId thread_id) {
+static bool remove_thread_locked(ThreadId thread_id) {
     if (!scheduler_initialized) {
         return false;
     }
     
-    return remove_from_queues(thread_id);
+    Thread* thread = pm_get_thread(thread_id);
+    if (!thread) {
+        return false;
+    }
+    
+    return remove_from_queues(thread);
+}
+
+/**
+ * @brief Remove a thread from the ready queue
+ */
+bool scheduler_remove_thread(ThreadId thread_id) {
+    pm_lock();
+    bool result = remove_thread_locked(thread_id);
+    pm_unlock();
+    return result;
 }
 
 /**
  * @brief Block a thread
+ *
+ * Caller must hold the process manager lock.
  */
-bool scheduler_block_thread(ThreadId thread_id) {
+static bool block_thread_locked(ThreadId thread_id) {
     if (!scheduler_initialized) {
         return false;
     }
@@ -397,23 +1133,37 @@ bool scheduler_block_thread(ThreadId thread_id) {
     }
     
     /* Remove from ready queues */
-    remove_from_queues(thread_id);
+    remove_from_queues(thread);
     
     /* Update thread state */
     thread->state = THREAD_BLOCKED;
+    pm_mark_process_dirty(thread->process_id);
     
-    /* If this is the current thread, force a context switch */
-    if (scheduler_running && thread_id == scheduler_state.current_thread) {
-        return scheduler_context_switch(true);
+    /* If the thread is running, force a context switch on its CPU */
+    int cpu = find_running_cpu(thread_id);
+    if (scheduler_running && cpu >= 0) {
+        return scheduler_context_switch_cpu((uint32_t)cpu, true);
     }
     
     return true;
 }
 
+/**
+ * @brief Block a thread
+ */
+bool scheduler_block_thread(ThreadId thread_id) {
+    pm_lock();
+    bool result = block_thread_locked(thread_id);
+    pm_unlock();
+    return result;
+}
+
 /**
  * @brief Unblock a thread
+ *
+ * Caller must hold the process manager lock.
  */
-bool scheduler_unblock_thread(ThreadId thread_id) {
+static bool unblock_thread_locked(ThreadId thread_id) {
     if (!scheduler_initialized) {
         return false;
     }
@@ -424,27 +1174,45 @@ bool scheduler_unblock_thread(ThreadId thread_id) {
         return false;
     }
     
+    if (find_running_cpu(thread_id) >= 0) {
+        return true;
+    }
+    
     /* Update thread state */
     thread->state = THREAD_READY;
+    pm_mark_process_dirty(thread->process_id);
     
-    /* Add to ready queue */
-    bool result = add_to_queue(thread_id, thread->priority);
+    /* Add to the ready queue of the CPU it last ran on */
+    uint32_t cpu = home_cpu(thread);
+    add_to_queue(cpu, thread, queue_priority(thread));
     
-    /* Consider context switch if higher priority than current thread */
-    if (result && scheduler_running && scheduler_state.preemption_enabled) {
-        Thread* current_thread = pm_get_thread(scheduler_state.current_thread);
-        if (current_thread && thread->priority > current_thread->priority) {
-            scheduler_context_switch(true);
+    /* Consider context switch if higher priority than that CPU's thread */
+    if (scheduler_running && scheduler_state.preemption_enabled) {
+        Thread* current_thread = pm_get_thread(cpu_runqueues[cpu].current_thread);
+        if (current_thread && should_preempt(thread, current_thread)) {
+            scheduler_context_switch_cpu(cpu, true);
         }
     }
     
+    return true;
+}
+
+/**
+ * @brief Unblock a thread
+ */
+bool scheduler_unblock_thread(ThreadId thread_id) {
+    pm_lock();
+    bool result = unblock_thread_locked(thread_id);
+    pm_unlock();
     return result;
 }
 
 /**
  * @brief Change thread priority
+ *
+ * Caller must hold the process manager lock.
  */
-bool scheduler_set_thread_priority(ThreadId thread_id, PriorityLevel priority) {
+static bool set_thread_priority_locked(ThreadId thread_id, PriorityLevel priority) {
     if (!scheduler_initialized) {
         return false;
     }
@@ -460,24 +1228,33 @@ bool scheduler_set_thread_priority(ThreadId thread_id, PriorityLevel priority) {
         return false;
     }
     
+    /* A new priority restarts the thread's feedback level */
+    Thread* thread = pm_get_thread(thread_id);
+    if (thread) {
+        thread->mlfq_epoch = 0;
+    }
+    
     /* If thread is in a ready queue, update its position */
-    if (remove_from_queues(thread_id)) {
-        add_to_queue(thread_id, priority);
+    if (thread && thread->run_queued) {
+        uint32_t cpu = thread->run_cpu;
+        remove_from_queues(thread);
+        add_to_queue(cpu, thread, queue_priority(thread));
     }
     
     /* Consider context switch if necessary */
-    if (scheduler_running && scheduler_state.preemption_enabled) {
-        if (scheduler_state.current_thread == thread_id) {
-            /* Current thread's priority changed - might need to yield to higher priority */
-            Thread* current_thread = pm_get_thread(thread_id);
-            if (current_thread && priority < current_thread->priority) {
-                scheduler_context_switch(true);
+    if (scheduler_running && scheduler_state.preemption_enabled && thread) {
+        int running_cpu = find_running_cpu(thread_id);
+        if (running_cpu >= 0) {
+            /* Running thread's priority dropped - yield to a higher priority waiter */
+            if (!uses_deadline(thread) &&
+                (int)queue_priority(thread) < highest_ready_priority(&cpu_runqueues[running_cpu])) {
+                scheduler_context_switch_cpu((uint32_t)running_cpu, true);
             }
-        } else {
-            /* Other thread's priority changed - might need to preempt current */
-            Thread* current_thread = pm_get_thread(scheduler_state.current_thread);
-            if (current_thread && priority > current_thread->priority) {
-                scheduler_context_switch(true);
+        } else if (thread->run_queued) {
+            /* Waiting thread's priority changed - might need to preempt its CPU */
+            Thread* current_thread = pm_get_thread(cpu_runqueues[thread->run_cpu].current_thread);
+            if (current_thread && should_preempt(thread, current_thread)) {
+                scheduler_context_switch_cpu(thread->run_cpu, true);
             }
         }
     }
@@ -485,10 +1262,22 @@ bool scheduler_set_thread_priority(ThreadId thread_id, PriorityLevel priority) {
     return true;
 }
 
+/**
+ * @brief Change thread priority
+ */
+bool scheduler_set_thread_priority(ThreadId thread_id, PriorityLevel priority) {
+    pm_lock();
+    bool result = set_thread_priority_locked(thread_id, priority);
+    pm_unlock();
+    return result;
+}
+
 /**
  * @brief Create a quantum superposition for a thread
+ *
+ * Caller must hold the process manager lock.
  */
-bool scheduler_create_superposition(ThreadId thread_id, NodeLevel resonance_level) {
+static bool create_superposition_locked(ThreadId thread_id, NodeLevel resonance_level) {
     if (!scheduler_initialized) {
         return false;
     }
@@ -535,17 +1324,9 @@ bool scheduler_create_superposition(ThreadId thread_id, NodeLevel resonance_leve
     /* Update scheduler stats */
     scheduler_state.superposition_count++;
     
-    /* If thread is in ready queue, update its probability */
-    for (int i = 0; i < PRIORITY_QUEUE_COUNT; i++) {
-        SchedulerQueueEntry* entry = ready_queues[i];
-        while (entry) {
-            if (entry->thread_id == thread_id) {
-                entry->quantum_probability = 0.5;
-                break;
-            }
-            entry = entry->next;
-        }
-    }
+    /* Lower the thread's execution probability while in superposition */
+    thread->quantum_probability = 0.5;
+    quantum_update_weight(thread);
     
     printf("Created quantum superposition for thread %llu with resonance level %d\n",
            (unsigned long long)thread_id, resonance_level);
@@ -553,10 +1334,22 @@ bool scheduler_create_superposition(ThreadId thread_id, NodeLevel resonance_leve
     return true;
 }
 
+/**
+ * @brief Create a quantum superposition for a thread
+ */
+bool scheduler_create_superposition(ThreadId thread_id, NodeLevel resonance_level) {
+    pm_lock();
+    bool result = create_superposition_locked(thread_id, resonance_level);
+    pm_unlock();
+    return result;
+}
+
 /**
  * @brief Collapse a thread's quantum superposition
+ *
+ * Caller must hold the process manager lock.
  */
-bool scheduler_collapse_superposition(ThreadId thread_id, double probability_bias) {
+static bool collapse_superposition_locked(ThreadId thread_id, double probability_bias) {
     if (!scheduler_initialized) {
         return false;
     }
@@ -602,23 +1395,11 @@ bool scheduler_collapse_superposition(ThreadId thread_id, double probability_bia
         /* Thread survived collapse, restore to READY state */
         thread->state = THREAD_READY;
         
-        /* Add to ready queue if not already there */
-        bool in_queue = false;
-        for (int i = 0; i < PRIORITY_QUEUE_COUNT; i++) {
-            SchedulerQueueEntry* entry = ready_queues[i];
-            while (entry) {
-                if (entry->thread_id == thread_id) {
-                    in_queue = true;
-                    entry->quantum_probability = 1.0; /* Restore normal probability */
-                    break;
-                }
-                entry = entry->next;
-            }
-            if (in_queue) break;
-        }
-        
-        if (!in_queue) {
-            add_to_queue(thread_id, thread->priority);
+        /* Restore normal probability and add to ready queue if not already there */
+        thread->quantum_probability = 1.0;
+        quantum_update_weight(thread);
+        if (find_running_cpu(thread_id) < 0) {
+            add_to_queue(home_cpu(thread), thread, queue_priority(thread));
         }
         
         printf("Thread %llu survived quantum collapse\n", (unsigned long long)thread_id);
@@ -636,90 +1417,536 @@ bool scheduler_collapse_superposition(ThreadId thread_id, double probability_bia
 }
 
 /**
- * @brief Perform context switch to next thread
+ * @brief Collapse a thread's quantum superposition
  */
-bool scheduler_context_switch(bool force) {
-    if (!scheduler_initialized || !scheduler_running) {
+bool scheduler_collapse_superposition(ThreadId thread_id, double probability_bias) {
+    pm_lock();
+    bool result = collapse_superposition_locked(thread_id, probability_bias);
+    pm_unlock();
+    return result;
+}
+
+/**
+ * @brief Charge a thread's time on the CPU when it is switched out
+ */
+static void account_current(Thread* current, uint64_t elapsed, uint64_t current_time) {
+    /* In a real implementation, this would save CPU context */
+    /* For simulation, just track execution time */
+    current->execution_time += elapsed;
+    account_feedback(current, elapsed);
+    account_deadline(current, elapsed, current_time);
+}
+
+/**
+ * @brief Take a CPU's running thread off the CPU
+ *
+ * The thread goes back to the tail of the CPU's ready queue if it is still
+ * runnable.
+ */
+static void requeue_current(uint32_t cpu) {
+    CpuRunqueue* rq = &cpu_runqueues[cpu];
+    
+    Thread* current = rq->current_thread ? pm_get_thread(rq->current_thread) : NULL;
+    if (current && current->state == THREAD_RUNNING) {
+        current->state = THREAD_READY;
+        add_to_queue(cpu, current, queue_priority(current));
+    }
+    rq->current_thread = 0;
+    rq->current_process = 0;
+}
+
+/**
+ * @brief Start a thread that has been taken off the ready queues on a CPU
+ */
+static void dispatch_thread(uint32_t cpu, Thread* next, Process* process, uint64_t current_time) {
+    CpuRunqueue* rq = &cpu_runqueues[cpu];
+    
+    /* Update thread and process state */
+    next->state = THREAD_RUNNING;
+    next->run_cpu = cpu;
+    next->last_scheduled = current_time;
+    if (process->state != PROCESS_RUNNING) {
+        process->state = PROCESS_RUNNING;
+    }
+    
+    /* Update CPU and scheduler state */
+    rq->current_process = next->process_id;
+    rq->current_thread = next->id;
+    rq->last_context_switch = current_time;
+    rq->context_switches++;
+    scheduler_state.total_context_switches++;
+    TRACE_EVENT_ON(cpu, TRACE_CONTEXT_SWITCH, TRACE_PHASE_INSTANT, next->id, next->process_id);
+    if (cpu == 0) {
+        scheduler_state.current_process = next->process_id;
+        scheduler_state.current_thread = next->id;
+        scheduler_state.last_context_switch = current_time;
+    }
+    
+    /* Load context (in a real implementation) */
+    /* For simulation, just report the switch */
+    printf("Context switch on CPU %u to thread %llu in process %llu\n", 
+           cpu, (unsigned long long)next->id, (unsigned long long)next->process_id);
+}
+
+/**
+ * @brief Get the CPU paired with a CPU for gang scheduling
+ *
+ * CPUs are paired as 0/1, 2/3 and so on; the last CPU of an odd count is
+ * paired with the one before it.
+ *
+ * @return Sibling CPU index, or -1 on a single CPU
+ */
+static int gang_sibling_cpu(uint32_t cpu) {
+    if (cpu_count < 2) {
+        return -1;
+    }
+    
+    uint32_t sibling = cpu ^ 1u;
+    return (int)(sibling < cpu_count ? sibling : cpu - 1);
+}
+
+/**
+ * @brief Run the partner of an execution-entangled process alongside it
+ *
+ * When a CPU picks a thread whose process is execution-entangled and the
+ * partner process is not running anywhere, the partner's first ready thread
+ * is started on the sibling CPU. The sibling's running thread is displaced
+ * only if it has no deadline reservation and does not outrank the partner.
+ */
+static void gang_dispatch(uint32_t cpu, Thread* next, uint64_t current_time) {
+    ProcessId partner_id = pm_get_execution_partner(next->process_id);
+    int sibling = gang_sibling_cpu(cpu);
+    if (partner_id == 0 || sibling < 0) {
+        return;
+    }
+    
+    for (uint32_t i = 0; i < cpu_count; i++) {
+        if (cpu_runqueues[i].current_process == partner_id) {
+            return;
+        }
+    }
+    
+    /* Deadline threads keep the CPU their reservation was admitted on */
+    Process* partner = pm_get_process(partner_id);
+    Thread* thread = partner ? partner->threads : NULL;
+    while (thread && (!thread->run_queued || uses_deadline(thread))) {
+        thread = thread->next;
+    }
+    if (!thread) {
+        return;
+    }
+    
+    CpuRunqueue* rq = &cpu_runqueues[sibling];
+    Thread* current = rq->current_thread ? pm_get_thread(rq->current_thread) : NULL;
+    if (current) {
+        if (uses_deadline(current) || queue_priority(current) > queue_priority(thread)) {
+            return;
+        }
+        account_current(current, current_time - rq->last_context_switch, current_time);
+    }
+    requeue_current((uint32_t)sibling);
+    
+    remove_from_queues(thread);
+    dispatch_thread((uint32_t)sibling, thread, partner, current_time);
+    scheduler_state.gang_dispatches++;
+}
+
+/**
+ * @brief Perform context switch to next thread on a CPU
+ *
+ * Caller must hold the process manager lock.
+ */
+static bool context_switch_cpu_locked(uint32_t cpu, bool force) {
+    if (!scheduler_initialized || !scheduler_running || cpu >= cpu_count) {
         return false;
     }
     
+    CpuRunqueue* rq = &cpu_runqueues[cpu];
+    
     /* Check if time slice has expired */
     uint64_t current_time = get_timestamp_ns();
-    uint64_t elapsed = current_time - scheduler_state.last_context_switch;
+    uint64_t elapsed = current_time - rq->last_context_switch;
+    
+    if (!force) {
+        Thread* current = rq->current_thread ? pm_get_thread(rq->current_thread) : NULL;
+        uint64_t time_slice = current ? thread_time_slice(current) : scheduler_state.time_slice;
+        if (elapsed < time_slice) {
+            return false; /* Time slice not expired yet */
+        }
+    }
     
-    if (!force && elapsed < scheduler_state.time_slice) {
-        return false; /* Time slice not expired yet */
+    /* Periodically even out the CPUs' ready queues */
+    if (cpu == 0 && current_time - last_balance >= SCHEDULER_BALANCE_SLICES * scheduler_state.time_slice) {
+        balance_load_locked();
+        last_balance = current_time;
+    }
+    
+    /* Periodically lift demoted threads back to their own priority */
+    if (cpu == 0 && scheduler_state.type == SCHEDULER_MULTILEVEL_FEEDBACK &&
+        current_time - last_mlfq_reset >= SCHEDULER_MLFQ_RESET_SLICES * scheduler_state.time_slice) {
+        scheduler_reset_feedback_levels();
     }
     
     /* Save current thread context if there is one */
-    if (scheduler_state.current_thread != 0) {
-        Thread* current = pm_get_thread(scheduler_state.current_thread);
+    if (rq->current_thread != 0) {
+        Thread* current = pm_get_thread(rq->current_thread);
         if (current) {
-            /* In a real implementation, this would save CPU context */
-            /* For simulation, just track execution time */
-            current->execution_time += elapsed;
+            account_current(current, elapsed, current_time);
             
-            /* Add back to ready queue if still runnable */
-            if (current->state == THREAD_RUNNING) {
-                current->state = THREAD_READY;
-                add_to_queue(scheduler_state.current_thread, current->priority);
+            /* Realtime threads run until they block or something more urgent is ready */
+            bool keep_running = false;
+            if (scheduler_state.type == SCHEDULER_REALTIME && current->state == THREAD_RUNNING) {
+                if (uses_deadline(current)) {
+                    keep_running = rq->deadline_queued == 0 ||
+                                   current->rt_abs_deadline <= rq->deadline_heap[0]->rt_abs_deadline;
+                } else {
+                    keep_running = rq->deadline_queued == 0 &&
+                                   (int)current->priority >= highest_ready_priority(rq);
+                }
+            }
+            if (keep_running) {
+                rq->last_context_switch = current_time;
+                if (cpu == 0) {
+                    scheduler_state.last_context_switch = current_time;
+                }
+                return true;
             }
         }
+        requeue_current(cpu);
     }
     
-    /* Select next thread to run */
-    ThreadId next_thread = get_next_thread();
-    
-    /* If no thread is ready, idle */
-    if (next_thread == 0) {
-        scheduler_state.current_process = 0;
-        scheduler_state.current_thread = 0;
-        scheduler_state.last_context_switch = current_time;
-        return true;
+    /* Select next thread to run, stealing from a busier CPU if idle */
+    Thread* next = get_next_thread(cpu);
+    if (!next) {
+        next = steal_thread(cpu);
     }
     
-    /* Get thread and process info */
-    Thread* next = pm_get_thread(next_thread);
+    /* If no thread is ready, idle */
     if (!next) {
-        /* Thread disappeared, try again */
-        return scheduler_context_switch(true);
+        rq->last_context_switch = current_time;
+        if (cpu == 0) {
+            scheduler_state.current_process = 0;
+            scheduler_state.current_thread = 0;
+            scheduler_state.last_context_switch = current_time;
+        }
+        return true;
     }
     
     Process* process = pm_get_process(next->process_id);
     if (!process) {
         /* Process disappeared, try again */
-        return scheduler_context_switch(true);
+        return context_switch_cpu_locked(cpu, true);
     }
     
-    /* Update thread and process state */
-    next->state = THREAD_RUNNING;
-    if (process->state != PROCESS_RUNNING) {
-        process->state = PROCESS_RUNNING;
+    dispatch_thread(cpu, next, process, current_time);
+    gang_dispatch(cpu, next, current_time);
+    
+    return true;
+}
+
+/**
+ * @brief Perform context switch to next thread on a CPU
+ */
+bool scheduler_context_switch_cpu(uint32_t cpu, bool force) {
+    pm_lock();
+    bool result = context_switch_cpu_locked(cpu, force);
+    pm_unlock();
+    return result;
+}
+
+/**
+ * @brief Perform context switch to next thread on CPU 0
+ */
+bool scheduler_context_switch(bool force) {
+    return scheduler_context_switch_cpu(0, force);
+}
+
+/**
+ * @brief Get the currently executing thread on CPU 0
+ */
+ThreadId scheduler_get_current_thread(void) {
+    return scheduler_get_cpu_thread(0);
+}
+
+/**
+ * @brief Get the thread executing on a CPU
+ */
+ThreadId scheduler_get_cpu_thread(uint32_t cpu) {
+    if (!scheduler_initialized || !scheduler_running || cpu >= cpu_count) {
+        return 0;
     }
     
-    /* Update scheduler state */
-    scheduler_state.current_process = next->process_id;
-    scheduler_state.current_thread = next_thread;
-    scheduler_state.last_context_switch = current_time;
-    scheduler_state.total_context_switches++;
+    return cpu_runqueues[cpu].current_thread;
+}
+
+/**
+ * @brief Get the state of one CPU
+ */
+bool scheduler_get_cpu_state(uint32_t cpu, SchedulerCpuState* state) {
+    if (!scheduler_initialized || !state || cpu >= cpu_count) {
+        return false;
+    }
     
-    /* Load context (in a real implementation) */
-    /* For simulation, just report the switch */
-    printf("Context switch to thread %llu in process %llu\n", 
-           (unsigned long long)next_thread, (unsigned long long)next->process_id);
+    const CpuRunqueue* rq = &cpu_runqueues[cpu];
+    state->cpu = cpu;
+    state->current_process = rq->current_process;
+    state->current_thread = rq->current_thread;
+    state->queued_threads = rq->queued + rq->deadline_queued;
+    state->last_context_switch = rq->last_context_switch;
+    state->context_switches = rq->context_switches;
+    state->deadline_threads = rq->deadline_threads;
+    state->deadline_utilization = rq->deadline_utilization;
     
     return true;
 }
 
 /**
- * @brief Get the currently executing thread
+ * @brief Get the number of CPUs being scheduled
  */
-ThreadId scheduler_get_current_thread(void) {
-    if (!scheduler_initialized || !scheduler_running) {
+uint32_t scheduler_get_cpu_count(void) {
+    return scheduler_initialized ? cpu_count : 0;
+}
+
+/**
+ * @brief Change the number of CPUs being scheduled
+ *
+ * Caller must hold the process manager lock.
+ */
+static bool set_cpu_count_locked(uint32_t count) {
+    if (!scheduler_initialized || scheduler_running) {
+        return false;
+    }
+    
+    if (count == 0 || count > SCHEDULER_MAX_CPUS) {
+        return false;
+    }
+    
+    /* Deadline reservations are tied to the CPU that admitted them */
+    for (uint32_t cpu = count; cpu < cpu_count; cpu++) {
+        if (cpu_runqueues[cpu].deadline_threads > 0) {
+            return false;
+        }
+    }
+    
+    /* Move threads queued on removed CPUs to the remaining ones */
+    uint32_t old_count = cpu_count;
+    cpu_count = count;
+    for (uint32_t cpu = count; cpu < old_count; cpu++) {
+        CpuRunqueue* rq = &cpu_runqueues[cpu];
+        for (int i = PRIORITY_QUEUE_COUNT - 1; i >= 0; i--) {
+            while (rq->queues[i].head) {
+                Thread* thread = rq->queues[i].head;
+                remove_from_queues(thread);
+                add_to_queue(placement_cpu(thread), thread, thread->run_priority);
+            }
+        }
+        free(rq->quantum_threads);
+        free(rq->quantum_weights);
+        free(rq->quantum_tree);
+        memset(rq, 0, sizeof(*rq));
+    }
+    
+    scheduler_state.cpu_count = cpu_count;
+    printf("Scheduler CPU count set to %u\n", cpu_count);
+    
+    return true;
+}
+
+/**
+ * @brief Change the number of CPUs being scheduled
+ */
+bool scheduler_set_cpu_count(uint32_t count) {
+    pm_lock();
+    bool result = set_cpu_count_locked(count);
+    pm_unlock();
+    return result;
+}
+
+/**
+ * @brief Give a thread a deadline reservation
+ *
+ * Caller must hold the process manager lock.
+ */
+static bool set_thread_deadline_locked(ThreadId thread_id, uint64_t runtime, uint64_t period, uint64_t deadline) {
+    if (!scheduler_initialized) {
+        return false;
+    }
+    
+    Thread* thread = pm_get_thread(thread_id);
+    if (!thread) {
+        return false;
+    }
+    
+    if (deadline == 0) {
+        deadline = period;
+    }
+    if (runtime != 0 && (period == 0 || runtime > deadline || deadline > period)) {
+        return false;
+    }
+    
+    /* Release the old reservation while the new one is admitted */
+    uint64_t old_utilization = 0;
+    if (thread->rt_runtime != 0) {
+        old_utilization = deadline_utilization(thread->rt_runtime, thread->rt_period);
+        cpu_runqueues[thread->rt_cpu].deadline_utilization -= old_utilization;
+        cpu_runqueues[thread->rt_cpu].deadline_threads--;
+    }
+    
+    /* Admit on the CPU with the most spare capacity */
+    uint32_t cpu = 0;
+    uint64_t utilization = 0;
+    bool admitted = true;
+    if (runtime != 0) {
+        utilization = deadline_utilization(runtime, period);
+        for (uint32_t i = 1; i < cpu_count; i++) {
+            if (cpu_runqueues[i].deadline_utilization < cpu_runqueues[cpu].deadline_utilization) {
+                cpu = i;
+            }
+        }
+        admitted = cpu_runqueues[cpu].deadline_utilization + utilization <= SCHEDULER_UTILIZATION_SCALE &&
+                   cpu_runqueues[cpu].deadline_threads < SCHEDULER_MAX_DEADLINE_THREADS;
+    }
+    
+    if (!admitted) {
+        /* Keep the old reservation */
+        if (thread->rt_runtime != 0) {
+            cpu_runqueues[thread->rt_cpu].deadline_utilization += old_utilization;
+            cpu_runqueues[thread->rt_cpu].deadline_threads++;
+        }
+        printf("Deadline reservation for thread %llu rejected: CPUs fully utilized\n",
+               (unsigned long long)thread_id);
+        return false;
+    }
+    
+    /* Take the thread out of its queue while its ordering changes */
+    bool queued = remove_from_queues(thread);
+    
+    thread->rt_runtime = runtime;
+    thread->rt_period = period;
+    thread->rt_deadline = deadline;
+    thread->rt_abs_deadline = 0;
+    thread->rt_budget_used = 0;
+    if (runtime != 0) {
+        thread->rt_cpu = cpu;
+        cpu_runqueues[cpu].deadline_utilization += utilization;
+        cpu_runqueues[cpu].deadline_threads++;
+    }
+    
+    if (queued) {
+        add_to_queue(home_cpu(thread), thread, queue_priority(thread));
+    }
+    
+    /* A running thread's new period starts now */
+    if (uses_deadline(thread) && find_running_cpu(thread_id) >= 0) {
+        thread->rt_abs_deadline = get_timestamp_ns() + deadline;
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Give a thread a deadline reservation
+ */
+bool scheduler_set_thread_deadline(ThreadId thread_id, uint64_t runtime, uint64_t period, uint64_t deadline) {
+    pm_lock();
+    bool result = set_thread_deadline_locked(thread_id, runtime, period, deadline);
+    pm_unlock();
+    return result;
+}
+
+/**
+ * @brief Set the time slice of a multilevel feedback level
+ */
+bool scheduler_set_level_time_slice(PriorityLevel level, uint64_t time_slice) {
+    if (!scheduler_initialized || level >= PRIORITY_QUEUE_COUNT) {
+        return false;
+    }
+    
+    level_time_slices[level] = (time_slice > 0) ? time_slice : default_level_time_slice(level);
+    return true;
+}
+
+/**
+ * @brief Get the time slice of a multilevel feedback level
+ */
+uint64_t scheduler_get_level_time_slice(PriorityLevel level) {
+    if (!scheduler_initialized || level >= PRIORITY_QUEUE_COUNT) {
         return 0;
     }
     
-    return scheduler_state.current_thread;
+    return level_time_slices[level];
+}
+
+/**
+ * @brief Requeue every waiting thread at its current queue priority
+ */
+static void requeue_all_threads(void) {
+    for (uint32_t cpu = 0; cpu < cpu_count; cpu++) {
+        CpuRunqueue* rq = &cpu_runqueues[cpu];
+        
+        /* Detach the queues, then relink from the most urgent down */
+        ReadyQueue queues[PRIORITY_QUEUE_COUNT];
+        memcpy(queues, rq->queues, sizeof(queues));
+        memset(rq->queues, 0, sizeof(rq->queues));
+        rq->bitmap = 0;
+        rq->queued = 0;
+        
+        for (uint32_t i = 0; i < rq->quantum_count; i++) {
+            rq->quantum_threads[i]->quantum_slot = 0;
+        }
+        rq->quantum_count = 0;
+        if (rq->quantum_tree) {
+            memset(rq->quantum_tree, 0, rq->quantum_capacity * sizeof(uint64_t));
+        }
+        
+        Thread* deadline_heap[SCHEDULER_MAX_DEADLINE_THREADS];
+        uint32_t deadline_queued = rq->deadline_queued;
+        memcpy(deadline_heap, rq->deadline_heap, deadline_queued * sizeof(Thread*));
+        rq->deadline_queued = 0;
+        
+        for (uint32_t i = 0; i < deadline_queued; i++) {
+            deadline_heap[i]->rt_heap_slot = 0;
+            deadline_heap[i]->run_queued = false;
+            add_to_queue(cpu, deadline_heap[i], queue_priority(deadline_heap[i]));
+        }
+        
+        for (int i = PRIORITY_QUEUE_COUNT - 1; i >= 0; i--) {
+            Thread* thread = queues[i].head;
+            while (thread) {
+                Thread* next = thread->run_next;
+                thread->run_queued = false;
+                add_to_queue(cpu, thread, queue_priority(thread));
+                thread = next;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Return every thread to the feedback level of its own priority
+ *
+ * Caller must hold the process manager lock.
+ */
+static void reset_feedback_levels_locked(void) {
+    if (!scheduler_initialized) {
+        return;
+    }
+    
+    /* Running and blocked threads pick up the new epoch when next queued */
+    mlfq_epoch++;
+    last_mlfq_reset = get_timestamp_ns();
+    scheduler_state.mlfq_resets++;
+    
+    requeue_all_threads();
+}
+
+/**
+ * @brief Return every thread to the feedback level of its own priority
+ */
+void scheduler_reset_feedback_levels(void) {
+    pm_lock();
+    reset_feedback_levels_locked();
+    pm_unlock();
 }
 
 /**
@@ -731,12 +1958,15 @@ void scheduler_get_state(SchedulerState* state) {
     }
     
     memcpy(state, &scheduler_state, sizeof(SchedulerState));
+    state->cpu_count = cpu_count;
 }
 
 /**
  * @brief Change the scheduler type
+ *
+ * Caller must hold the process manager lock.
  */
-bool scheduler_change_type(SchedulerType type) {
+static bool change_type_locked(SchedulerType type) {
     if (!scheduler_initialized) {
         return false;
     }
@@ -747,11 +1977,24 @@ bool scheduler_change_type(SchedulerType type) {
     }
     
     scheduler_state.type = type;
+    
+    /* Waiting threads move between priority and feedback queues */
+    requeue_all_threads();
     printf("Scheduler type changed to %d\n", type);
     
     return true;
 }
 
+/**
+ * @brief Change the scheduler type
+ */
+bool scheduler_change_type(SchedulerType type) {
+    pm_lock();
+    bool result = change_type_locked(type);
+    pm_unlock();
+    return result;
+}
+
 /**
  * @brief Set the scheduler's resonance level
  */
@@ -20,6 +20,31 @@
  */
 #define SCHEDULER_DEFAULT_QUANTUM     10000000  /* 10 ms */
 
+/**
+ * @brief Maximum number of logical CPUs the scheduler manages
+ */
+#define SCHEDULER_MAX_CPUS            64
+
+/**
+ * @brief Load balancer period, in time slices of CPU 0
+ */
+#define SCHEDULER_BALANCE_SLICES      4
+
+/**
+ * @brief Multilevel feedback priority reset period, in time slices of CPU 0
+ */
+#define SCHEDULER_MLFQ_RESET_SLICES   32
+
+/**
+ * @brief Maximum number of deadline reservations per CPU
+ */
+#define SCHEDULER_MAX_DEADLINE_THREADS 64
+
+/**
+ * @brief Fixed-point scale of deadline utilization (1000000 = one full CPU)
+ */
+#define SCHEDULER_UTILIZATION_SCALE   1000000
+
 /**
  * @brief Scheduler types
  */
@@ -36,26 +61,39 @@ typedef enum {
  */
 typedef struct {
     SchedulerType type;                /**< Scheduler type */
-    ProcessId current_process;         /**< Currently executing process */
-    ThreadId current_thread;           /**< Currently executing thread */
+    ProcessId current_process;         /**< Process executing on CPU 0 */
+    ThreadId current_thread;           /**< Thread executing on CPU 0 */
     uint64_t time_slice;               /**< Time slice in nanoseconds */
     uint64_t last_context_switch;      /**< Timestamp of last context switch */
     uint64_t total_context_switches;   /**< Total number of context switches */
     uint32_t superposition_count;      /**< Number of superposition states */
     bool preemption_enabled;           /**< Whether preemption is enabled */
     NodeLevel resonance_level;         /**< Scheduler resonance level */
+    uint32_t cpu_count;                /**< Number of logical CPUs scheduled */
+    uint64_t threads_stolen;           /**< Threads taken by idle CPUs from busy peers */
+    uint64_t remote_steals;            /**< Of those, threads taken from another memory node */
+    uint64_t threads_migrated;         /**< Threads moved by the load balancer */
+    uint64_t mlfq_demotions;           /**< Feedback demotions after a full time slice */
+    uint64_t mlfq_boosts;              /**< Feedback boosts after blocking early */
+    uint64_t mlfq_resets;              /**< Feedback priority resets */
+    uint64_t deadline_overruns;        /**< Deadline threads that ran past their per-period runtime */
+    uint64_t deadline_misses;          /**< Deadline threads still running after their deadline */
+    uint64_t gang_dispatches;          /**< Entangled partner threads started on a sibling CPU */
 } SchedulerState;
 
 /**
- * @brief Scheduler ready queue entry
+ * @brief Per-CPU scheduler state
  */
-typedef struct SchedulerQueueEntry {
-    ProcessId process_id;              /**< Process ID */
-    ThreadId thread_id;                /**< Thread ID */
-    PriorityLevel priority;            /**< Thread priority */
-    double quantum_probability;        /**< Quantum execution probability */
-    struct SchedulerQueueEntry* next;  /**< Next entry in queue */
-} SchedulerQueueEntry;
+typedef struct {
+    uint32_t cpu;                      /**< Logical CPU index */
+    ProcessId current_process;         /**< Process executing on this CPU */
+    ThreadId current_thread;           /**< Thread executing on this CPU (0 if idle) */
+    uint32_t queued_threads;           /**< Threads waiting in this CPU's ready queues */
+    uint64_t last_context_switch;      /**< Timestamp of last context switch */
+    uint64_t context_switches;         /**< Context switches on this CPU */
+    uint32_t deadline_threads;         /**< Deadline reservations admitted on this CPU */
+    uint64_t deadline_utilization;     /**< Reserved utilization, in SCHEDULER_UTILIZATION_SCALE units */
+} SchedulerCpuState;
 
 /**
  * @brief Initialize the scheduler
@@ -146,7 +184,7 @@ bool scheduler_create_superposition(ThreadId thread_id, NodeLevel resonance_leve
 bool scheduler_collapse_superposition(ThreadId thread_id, double probability_bias);
 
 /**
- * @brief Perform a context switch
+ * @brief Perform a context switch on CPU 0
  * 
  * @param force Whether to force a context switch even if time slice isn't expired
  * @return true if context switch succeeded, false otherwise
@@ -154,12 +192,137 @@ bool scheduler_collapse_superposition(ThreadId thread_id, double probability_bia
 bool scheduler_context_switch(bool force);
 
 /**
- * @brief Get the currently executing thread
+ * @brief Perform a context switch on a CPU
+ * 
+ * The outgoing thread goes back to the CPU's own ready queue. A CPU with
+ * nothing to run steals the most urgent waiting thread from the busiest
+ * peer before going idle.
+ * 
+ * Processes under ENTANGLE_EXECUTION are gang-scheduled: when one half of
+ * the pair is picked and the other is not running, the other's first ready
+ * thread is started on the sibling CPU (0/1, 2/3, ...).
+ * 
+ * @param cpu Logical CPU index
+ * @param force Whether to force a context switch even if time slice isn't expired
+ * @return true if context switch succeeded, false otherwise
+ */
+bool scheduler_context_switch_cpu(uint32_t cpu, bool force);
+
+/**
+ * @brief Get the thread executing on CPU 0
  * 
  * @return Currently executing thread ID or 0 if none
  */
 ThreadId scheduler_get_current_thread(void);
 
+/**
+ * @brief Get the thread executing on a CPU
+ * 
+ * @param cpu Logical CPU index
+ * @return Currently executing thread ID or 0 if none
+ */
+ThreadId scheduler_get_cpu_thread(uint32_t cpu);
+
+/**
+ * @brief Get the state of a CPU
+ * 
+ * @param cpu Logical CPU index
+ * @param state Pointer to SchedulerCpuState structure to fill
+ * @return true if the CPU exists, false otherwise
+ */
+bool scheduler_get_cpu_state(uint32_t cpu, SchedulerCpuState* state);
+
+/**
+ * @brief Get the number of logical CPUs scheduled
+ * 
+ * @return CPU count (sized from the HAL processor core count at init)
+ */
+uint32_t scheduler_get_cpu_count(void);
+
+/**
+ * @brief Change the number of logical CPUs scheduled
+ * 
+ * Threads queued on removed CPUs move to the remaining ones. Only allowed
+ * while the scheduler is stopped, and not while a removed CPU holds
+ * deadline reservations.
+ * 
+ * @param cpu_count New CPU count (1 to SCHEDULER_MAX_CPUS)
+ * @return true if change succeeded, false otherwise
+ */
+bool scheduler_set_cpu_count(uint32_t cpu_count);
+
+/**
+ * @brief Even out ready queue lengths across CPUs
+ * 
+ * Runs periodically from CPU 0's context switches; may also be called
+ * directly. Moves waiting threads, lowest priority first, from CPUs with
+ * more than their share to CPUs with less.
+ * 
+ * @return Number of threads moved
+ */
+uint32_t scheduler_balance_load(void);
+
+/**
+ * @brief Seed the random number generators of SCHEDULER_QUANTUM
+ * 
+ * Each CPU has its own generator, derived from the seed. The generators
+ * are seeded from the clock at initialization.
+ * 
+ * @param seed Seed value
+ */
+void scheduler_seed_random(uint64_t seed);
+
+/**
+ * @brief Give a thread a deadline reservation
+ * 
+ * The thread is guaranteed runtime nanoseconds of every period, finishing
+ * no later than deadline nanoseconds into the period. Under
+ * SCHEDULER_REALTIME, threads with a reservation run ahead of all priority
+ * scheduled threads, earliest absolute deadline first. A thread that uses
+ * up its runtime has its deadline moved to the next period.
+ * 
+ * The reservation is admitted on the CPU with the most spare capacity, and
+ * the thread stays on that CPU. A reservation that would take every CPU
+ * over full utilization is rejected.
+ * 
+ * @param thread_id ID of the thread
+ * @param runtime Runtime per period in nanoseconds (0 to remove the reservation)
+ * @param period Period in nanoseconds
+ * @param deadline Relative deadline in nanoseconds (0 for the period)
+ * @return true if the reservation was admitted, false otherwise
+ */
+bool scheduler_set_thread_deadline(ThreadId thread_id, uint64_t runtime, uint64_t period, uint64_t deadline);
+
+/**
+ * @brief Set the time slice of a multilevel feedback level
+ * 
+ * Under SCHEDULER_MULTILEVEL_FEEDBACK a thread that uses up its level's
+ * slice drops one level, and a thread that blocks before using it rises
+ * one level, up to one above its own priority. Levels above
+ * PRIORITY_HIGHEST are never changed by feedback.
+ * 
+ * @param level Feedback level
+ * @param time_slice Time slice in nanoseconds (0 for the level's default)
+ * @return true if change succeeded, false otherwise
+ */
+bool scheduler_set_level_time_slice(PriorityLevel level, uint64_t time_slice);
+
+/**
+ * @brief Get the time slice of a multilevel feedback level
+ * 
+ * @param level Feedback level
+ * @return Time slice in nanoseconds, or 0 if the level is invalid
+ */
+uint64_t scheduler_get_level_time_slice(PriorityLevel level);
+
+/**
+ * @brief Return every thread to the feedback level of its own priority
+ * 
+ * Runs periodically from CPU 0's context switches so demoted threads are
+ * not starved; may also be called directly.
+ */
+void scheduler_reset_feedback_levels(void);
+
 /**
  * @brief Get the scheduler state
  * 
@@ -0,0 +1,430 @@
+/**
+ * @file trace.c
+ * @brief Kernel-wide event tracing implementation
+ */
+
+/* clock_gettime, sysconf and stat under -std=c11 */
+#define _XOPEN_SOURCE 700
+
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdalign.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define TRACE_CACHE_LINE 64
+#define TRACE_READ_CHUNK 256
+#define TRACE_MAX_EVENTS_PER_CPU (1u << 20)
+
+/*
+ * Rings
+ *
+ * Every CPU has a ring of fixed-size slots. A writer reserves a position
+ * with one fetch-add on the ring head, so threads sharing a CPU never wait
+ * for each other, and the oldest events are overwritten once the ring is
+ * full. Each slot is published like a seqlock: its sequence is cleared,
+ * the fields are written, and the sequence is set to position + 1. A reader
+ * copies the fields between two loads of the sequence and drops the copy if
+ * the sequence changed, so it never blocks writers and never returns a
+ * torn event.
+ */
+typedef struct {
+    _Atomic uint64_t sequence;  /* position + 1 once published, 0 while written */
+    _Atomic uint64_t timestamp;
+    _Atomic uint64_t arg0;
+    _Atomic uint64_t header;    /* type | phase << 16 | cpu << 24 | arg1 << 32 */
+} TraceSlot;
+
+typedef struct {
+    alignas(TRACE_CACHE_LINE) _Atomic uint64_t head; /* Next position to reserve */
+    TraceSlot* slots;
+} TraceRing;
+
+/* Event type names, categories and argument names for Chrome traces */
+typedef struct {
+    const char* name;
+    const char* category;
+    const char* arg0;
+    const char* arg1;
+} TraceTypeInfo;
+
+static const TraceTypeInfo trace_types[TRACE_EVENT_TYPE_COUNT] = {
+    [TRACE_CONTEXT_SWITCH] = { "context_switch", "sched", "thread", "process" },
+    [TRACE_QBUS_ENQUEUE] = { "qbus_enqueue", "qbus", "message", "type" },
+    [TRACE_QBUS_DISPATCH] = { "qbus_dispatch", "qbus", "message", "type" },
+    [TRACE_MM_ALLOC] = { "mm_alloc", "mm", "address", "size" },
+    [TRACE_MM_FREE] = { "mm_free", "mm", "address", "size" },
+    [TRACE_ENTANGLEMENT_SYNC] = { "entanglement_sync", "qem", "batch", "count" },
+    [TRACE_OCULAR_STAGE] = { "ocular_stage", "ocular", "frame", "stage" },
+    [TRACE_OCULAR_PIPELINE] = { "ocular_pipeline", "ocular", "pipeline", "bytes" },
+    [TRACE_TELEPORT_PHASE] = { "teleport_phase", "teleport", "handle", "status" },
+};
+
+/* Trace state */
+atomic_bool trace_active = false;
+static bool trace_initialized = false;
+static TraceRing trace_rings[TRACE_MAX_CPUS];
+static TraceSlot* trace_slots = NULL;
+static uint32_t trace_ring_count = 0;
+static uint64_t trace_capacity = 0;
+
+/* Threads are spread over the rings round-robin */
+static atomic_uint trace_next_cpu = 0;
+static _Thread_local int trace_thread_cpu = -1;
+
+/**
+ * @brief Default trace clock
+ */
+static uint64_t monotonic_clock(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+static _Atomic(TraceClock) trace_clock = monotonic_clock;
+
+/**
+ * @brief Initialize tracing and start recording
+ */
+bool trace_init(uint32_t events_per_cpu) {
+    if (trace_initialized) {
+        return false;
+    }
+    
+    uint64_t capacity = 1;
+    uint64_t requested = events_per_cpu ? events_per_cpu : TRACE_DEFAULT_EVENTS_PER_CPU;
+    if (requested > TRACE_MAX_EVENTS_PER_CPU) {
+        printf("Trace rings are limited to %u events per CPU\n", TRACE_MAX_EVENTS_PER_CPU);
+        return false;
+    }
+    while (capacity < requested) {
+        capacity <<= 1;
+    }
+    
+    long cpus = sysconf(_SC_NPROCESSORS_CONF);
+    uint32_t ring_count = cpus < 1 ? 1 : cpus > TRACE_MAX_CPUS ? TRACE_MAX_CPUS : (uint32_t)cpus;
+    
+    TraceSlot* slots = aligned_alloc(TRACE_CACHE_LINE, ring_count * capacity * sizeof(TraceSlot));
+    if (!slots) {
+        printf("Failed to allocate trace rings\n");
+        return false;
+    }
+    memset(slots, 0, ring_count * capacity * sizeof(TraceSlot));
+    
+    for (uint32_t i = 0; i < ring_count; i++) {
+        atomic_init(&trace_rings[i].head, 0);
+        trace_rings[i].slots = slots + (uint64_t)i * capacity;
+    }
+    trace_slots = slots;
+    trace_ring_count = ring_count;
+    trace_capacity = capacity;
+    trace_initialized = true;
+    
+    /* Publishes the rings to writers, which load the flag with acquire */
+    atomic_store_explicit(&trace_active, true, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Stop tracing and free the rings
+ */
+void trace_shutdown(void) {
+    if (!trace_initialized) {
+        return;
+    }
+    
+    atomic_store(&trace_active, false);
+    free(trace_slots);
+    trace_slots = NULL;
+    memset(trace_rings, 0, sizeof(trace_rings));
+    trace_ring_count = 0;
+    trace_capacity = 0;
+    trace_initialized = false;
+}
+
+/**
+ * @brief Pause or resume recording
+ */
+bool trace_set_enabled(bool enabled) {
+    if (!trace_initialized) {
+        return false;
+    }
+    
+    atomic_store_explicit(&trace_active, enabled, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Install the trace clock
+ */
+void trace_set_clock(TraceClock clock) {
+    atomic_store(&trace_clock, clock ? clock : monotonic_clock);
+}
+
+/**
+ * @brief Read the trace clock
+ */
+uint64_t trace_now(void) {
+    return atomic_load_explicit(&trace_clock, memory_order_relaxed)();
+}
+
+/**
+ * @brief Write an event into a CPU's ring
+ *
+ * Caller must have seen tracing enabled.
+ */
+static void record_event(uint32_t cpu, TraceEventType type, TracePhase phase, uint64_t arg0, uint32_t arg1) {
+    uint64_t timestamp = trace_now();
+    TraceRing* ring = &trace_rings[cpu % trace_ring_count];
+    uint64_t position = atomic_fetch_add_explicit(&ring->head, 1, memory_order_relaxed);
+    TraceSlot* slot = &ring->slots[position & (trace_capacity - 1)];
+    
+    atomic_store_explicit(&slot->sequence, 0, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&slot->timestamp, timestamp, memory_order_relaxed);
+    atomic_store_explicit(&slot->arg0, arg0, memory_order_relaxed);
+    atomic_store_explicit(&slot->header,
+                          (uint64_t)(type & 0xffff) | (uint64_t)(phase & 0xff) << 16 |
+                          (uint64_t)(cpu & 0xff) << 24 | (uint64_t)arg1 << 32,
+                          memory_order_relaxed);
+    atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+}
+
+/**
+ * @brief Record an event on the calling thread's CPU
+ */
+void trace_emit(TraceEventType type, TracePhase phase, uint64_t arg0, uint32_t arg1) {
+    if (!atomic_load_explicit(&trace_active, memory_order_acquire)) {
+        return;
+    }
+    
+    if (trace_thread_cpu < 0) {
+        trace_thread_cpu = (int)(atomic_fetch_add(&trace_next_cpu, 1) % TRACE_MAX_CPUS);
+    }
+    record_event((uint32_t)trace_thread_cpu % trace_ring_count, type, phase, arg0, arg1);
+}
+
+/**
+ * @brief Record an event on a given CPU
+ */
+void trace_emit_on(uint32_t cpu, TraceEventType type, TracePhase phase, uint64_t arg0, uint32_t arg1) {
+    if (!atomic_load_explicit(&trace_active, memory_order_acquire)) {
+        return;
+    }
+    
+    record_event(cpu, type, phase, arg0, arg1);
+}
+
+/**
+ * @brief Read events recorded since a cursor last read
+ */
+uint32_t trace_read(TraceCursor* cursor, TraceEvent* events, uint32_t max_events) {
+    if (!trace_initialized || !cursor || !events) {
+        return 0;
+    }
+    
+    uint32_t count = 0;
+    for (uint32_t r = 0; r < trace_ring_count && count < max_events; r++) {
+        TraceRing* ring = &trace_rings[r];
+        uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        uint64_t position = cursor->positions[r];
+    
+        /* A cursor from before a restart, or one that fell a lap behind */
+        if (position > head) {
+            position = 0;
+        }
+        if (head > trace_capacity && position < head - trace_capacity) {
+            cursor->missed += head - trace_capacity - position;
+            position = head - trace_capacity;
+        }
+    
+        while (position < head && count < max_events) {
+            TraceSlot* slot = &ring->slots[position & (trace_capacity - 1)];
+            uint64_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+            if (sequence != position + 1) {
+                if (sequence > position + 1) {
+                    /* Already overwritten by a later lap */
+                    cursor->missed++;
+                    position++;
+                    continue;
+                }
+                /* Reserved but not yet published; pick it up next time */
+                break;
+            }
+    
+            uint64_t timestamp = atomic_load_explicit(&slot->timestamp, memory_order_relaxed);
+            uint64_t arg0 = atomic_load_explicit(&slot->arg0, memory_order_relaxed);
+            uint64_t header = atomic_load_explicit(&slot->header, memory_order_relaxed);
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load_explicit(&slot->sequence, memory_order_relaxed) != sequence) {
+                cursor->missed++;
+                position++;
+                continue;
+            }
+    
+            TraceEvent* event = &events[count++];
+            event->timestamp = timestamp;
+            event->arg0 = arg0;
+            event->arg1 = (uint32_t)(header >> 32);
+            event->type = (uint16_t)header;
+            event->phase = (uint8_t)(header >> 16);
+            event->cpu = (uint8_t)(header >> 24);
+            position++;
+        }
+        cursor->positions[r] = position;
+    }
+    
+    return count;
+}
+
+/**
+ * @brief Get the name of an event type
+ */
+const char* trace_event_name(TraceEventType type) {
+    if (type <= 0 || type >= TRACE_EVENT_TYPE_COUNT) {
+        return "unknown";
+    }
+    
+    return trace_types[type].name;
+}
+
+/**
+ * @brief Order events by timestamp
+ */
+static int compare_events(const void* a, const void* b) {
+    const TraceEvent* left = (const TraceEvent*)a;
+    const TraceEvent* right = (const TraceEvent*)b;
+    return (left->timestamp > right->timestamp) - (left->timestamp < right->timestamp);
+}
+
+/**
+ * @brief Write every event held in Chrome trace format
+ */
+bool trace_write_chrome_json(const char* path) {
+    if (!trace_initialized || !path) {
+        return false;
+    }
+    
+    uint64_t held = (uint64_t)trace_ring_count * trace_capacity;
+    TraceEvent* events = (TraceEvent*)malloc(held * sizeof(TraceEvent));
+    TraceCursor* cursor = (TraceCursor*)calloc(1, sizeof(TraceCursor));
+    if (!events || !cursor) {
+        free(events);
+        free(cursor);
+        return false;
+    }
+    uint32_t count = trace_read(cursor, events, (uint32_t)held);
+    free(cursor);
+    qsort(events, count, sizeof(TraceEvent), compare_events);
+    
+    char temp_path[512];
+    if (snprintf(temp_path, sizeof(temp_path), "%s.tmp", path) >= (int)sizeof(temp_path)) {
+        free(events);
+        return false;
+    }
+    
+    FILE* file = fopen(temp_path, "w");
+    if (!file) {
+        printf("Cannot write trace: failed to open %s\n", temp_path);
+        free(events);
+        return false;
+    }
+    
+    /* Each CPU is shown as a thread of one process */
+    bool seen[256] = { false };
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    bool first = true;
+    for (uint32_t i = 0; i < count; i++) {
+        if (!seen[events[i].cpu]) {
+            seen[events[i].cpu] = true;
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                    "\"args\":{\"name\":\"CPU %u\"}}",
+                    first ? "" : ",", events[i].cpu, events[i].cpu);
+            first = false;
+        }
+    }
+    
+    for (uint32_t i = 0; i < count; i++) {
+        const TraceEvent* event = &events[i];
+        TraceTypeInfo info = { "unknown", "unknown", "arg0", "arg1" };
+        if (event->type > 0 && event->type < TRACE_EVENT_TYPE_COUNT) {
+            info = trace_types[event->type];
+        }
+    
+        /* Begin and end may be on different CPUs, so spans are async events keyed by arg0 */
+        fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"%s\",", first ? "" : ",", info.name, info.category);
+        first = false;
+        if (event->phase == TRACE_PHASE_BEGIN || event->phase == TRACE_PHASE_END) {
+            fprintf(file, "\"ph\":\"%s\",\"id\":\"0x%llx\",",
+                    event->phase == TRACE_PHASE_BEGIN ? "b" : "e", (unsigned long long)event->arg0);
+        } else {
+            fprintf(file, "\"ph\":\"i\",\"s\":\"t\",");
+        }
+        fprintf(file, "\"ts\":%llu.%03u,\"pid\":1,\"tid\":%u,\"args\":{\"%s\":%llu,\"%s\":%u}}",
+                (unsigned long long)(event->timestamp / 1000), (unsigned)(event->timestamp % 1000),
+                event->cpu, info.arg0, (unsigned long long)event->arg0, info.arg1, event->arg1);
+    }
+    fprintf(file, "]}\n");
+    free(events);
+    
+    bool written = !ferror(file);
+    written = (fclose(file) == 0) && written;
+    
+    if (!written || rename(temp_path, path) != 0) {
+        printf("Cannot write trace: failed to replace %s\n", path);
+        remove(temp_path);
+        return false;
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Append events recorded since a cursor last read to a binary file
+ */
+int64_t trace_append_binary(const char* path, TraceCursor* cursor, uint64_t max_bytes) {
+    if (!trace_initialized || !path || !cursor) {
+        return -1;
+    }
+    
+    /* Start a new file once this one is full */
+    struct stat info;
+    if (max_bytes > 0 && stat(path, &info) == 0 && (uint64_t)info.st_size >= max_bytes) {
+        char old_path[512];
+        if (snprintf(old_path, sizeof(old_path), "%s.old", path) >= (int)sizeof(old_path) ||
+            rename(path, old_path) != 0) {
+            printf("Cannot rotate trace: failed to rename %s\n", path);
+            return -1;
+        }
+    }
+    
+    FILE* file = fopen(path, "ab");
+    if (!file) {
+        printf("Cannot write trace: failed to open %s\n", path);
+        return -1;
+    }
+    
+    /* Stop after one ring's worth per CPU, so busy writers cannot keep this going */
+    TraceEvent events[TRACE_READ_CHUNK];
+    int64_t appended = 0;
+    int64_t limit = (int64_t)(trace_ring_count * trace_capacity);
+    uint32_t count;
+    while (appended < limit && (count = trace_read(cursor, events, TRACE_READ_CHUNK)) > 0) {
+        if (fwrite(events, sizeof(TraceEvent), count, file) != count) {
+            break;
+        }
+        appended += count;
+    }
+    
+    bool written = !ferror(file);
+    written = (fclose(file) == 0) && written;
+    if (!written) {
+        printf("Cannot write trace: failed to append to %s\n", path);
+        return -1;
+    }
+    
+    return appended;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file trace.h
+ * @brief Kernel-wide event tracing for CTRLxT OS
+ *
+ * This file defines the interface for the trace facility, which records
+ * fixed-size binary events from every subsystem into per-CPU ring buffers.
+ * Events are timestamped with one clock, so latency spikes can be followed
+ * across the scheduler, the message bus, memory and the quantum components.
+ *
+ * Recording is lock-free and costs one predicted branch while tracing is
+ * disabled. Building with CTRLXT_NO_TRACE compiles every trace point out.
+ */
+
+#ifndef CTRLXT_TRACE_H
+#define CTRLXT_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/**
+ * @brief Maximum number of per-CPU rings
+ */
+#define TRACE_MAX_CPUS 64
+
+/**
+ * @brief Events kept per CPU when trace_init() is given 0
+ */
+#define TRACE_DEFAULT_EVENTS_PER_CPU 4096
+
+/**
+ * @brief Trace event types
+ */
+typedef enum {
+    TRACE_CONTEXT_SWITCH = 1,  /**< Thread dispatched on a CPU (arg0 thread, arg1 process) */
+    TRACE_QBUS_ENQUEUE,        /**< Message queued on the bus (arg0 message ID, arg1 message type) */
+    TRACE_QBUS_DISPATCH,       /**< Message taken off the bus (arg0 message ID, arg1 message type) */
+    TRACE_MM_ALLOC,            /**< Virtual memory allocated (arg0 address, arg1 size) */
+    TRACE_MM_FREE,             /**< Virtual memory freed (arg0 address, arg1 size if known) */
+    TRACE_ENTANGLEMENT_SYNC,   /**< Entanglement batch sync (arg0 batch, arg1 count, synced on end) */
+    TRACE_OCULAR_STAGE,        /**< Ocular frame reached a stage (arg0 frame, arg1 OcularFrameStage) */
+    TRACE_OCULAR_PIPELINE,     /**< Ocular pipeline run (arg0 pipeline, arg1 bytes) */
+    TRACE_TELEPORT_PHASE,      /**< Teleport phase (arg0 handle, 0 if synchronous, arg1 TeleportStatus) */
+    TRACE_EVENT_TYPE_COUNT
+} TraceEventType;
+
+/**
+ * @brief Trace event phases
+ *
+ * A begin and its end share a type and arg0, and may be recorded on
+ * different CPUs.
+ */
+typedef enum {
+    TRACE_PHASE_INSTANT,       /**< Point in time */
+    TRACE_PHASE_BEGIN,         /**< Start of a span */
+    TRACE_PHASE_END            /**< End of a span */
+} TracePhase;
+
+/**
+ * @brief Trace event, as read back and as stored in binary trace files
+ *
+ * Binary files hold these records back to back in host byte order.
+ */
+typedef struct {
+    uint64_t timestamp;        /**< Trace clock time in nanoseconds */
+    uint64_t arg0;             /**< First argument (see TraceEventType) */
+    uint32_t arg1;             /**< Second argument (see TraceEventType) */
+    uint16_t type;             /**< TraceEventType */
+    uint8_t phase;             /**< TracePhase */
+    uint8_t cpu;               /**< CPU the event was recorded on */
+} TraceEvent;
+
+_Static_assert(sizeof(TraceEvent) == 24, "TraceEvent is a 24-byte binary record");
+
+/**
+ * @brief Read position in every ring
+ *
+ * A zeroed cursor starts at the oldest events still held.
+ */
+typedef struct {
+    uint64_t positions[TRACE_MAX_CPUS]; /**< Next event to read per ring */
+    uint64_t missed;                    /**< Events overwritten before this cursor read them */
+} TraceCursor;
+
+/**
+ * @brief Trace clock, returning nanoseconds
+ */
+typedef uint64_t (*TraceClock)(void);
+
+/**
+ * @brief Whether trace points record (use the TRACE_EVENT macros instead)
+ */
+extern atomic_bool trace_active;
+
+#ifdef CTRLXT_NO_TRACE
+#define TRACE_EVENT(type, phase, arg0, arg1) \
+    do { (void)sizeof(arg0); (void)sizeof(arg1); } while (0)
+#define TRACE_EVENT_ON(cpu, type, phase, arg0, arg1) \
+    do { (void)sizeof(cpu); (void)sizeof(arg0); (void)sizeof(arg1); } while (0)
+#else
+/**
+ * @brief Record an event on the calling thread's CPU
+ *
+ * Arguments are only evaluated while tracing is enabled.
+ */
+#define TRACE_EVENT(type, phase, arg0, arg1) \
+    do { \
+        if (__builtin_expect(atomic_load_explicit(&trace_active, memory_order_relaxed), 0)) { \
+            trace_emit((type), (phase), (uint64_t)(arg0), (uint32_t)(arg1)); \
+        } \
+    } while (0)
+
+/**
+ * @brief Record an event on a given CPU
+ */
+#define TRACE_EVENT_ON(cpu, type, phase, arg0, arg1) \
+    do { \
+        if (__builtin_expect(atomic_load_explicit(&trace_active, memory_order_relaxed), 0)) { \
+            trace_emit_on((cpu), (type), (phase), (uint64_t)(arg0), (uint32_t)(arg1)); \
+        } \
+    } while (0)
+#endif
+
+/**
+ * @brief Initialize tracing and start recording
+ *
+ * @param events_per_cpu Events kept per CPU, rounded up to a power of two (0 for the default)
+ * @return true if initialization succeeded, false otherwise
+ */
+bool trace_init(uint32_t events_per_cpu);
+
+/**
+ * @brief Stop tracing and free the rings
+ *
+ * No thread may be recording while this runs.
+ */
+void trace_shutdown(void);
+
+/**
+ * @brief Pause or resume recording
+ *
+ * @param enabled Whether trace points record
+ * @return true if the state was set, false if tracing is not initialized
+ */
+bool trace_set_enabled(bool enabled);
+
+/**
+ * @brief Install the trace clock
+ *
+ * The kernel installs the HAL timestamp here; until then the trace clock
+ * is CLOCK_MONOTONIC.
+ *
+ * @param clock Clock function (NULL restores CLOCK_MONOTONIC)
+ */
+void trace_set_clock(TraceClock clock);
+
+/**
+ * @brief Read the trace clock
+ *
+ * @return Current time in nanoseconds
+ */
+uint64_t trace_now(void);
+
+/**
+ * @brief Record an event on the calling thread's CPU
+ *
+ * Threads are spread over the rings round-robin on first use.
+ *
+ * @param type Event type
+ * @param phase Event phase
+ * @param arg0 First argument
+ * @param arg1 Second argument
+ */
+void trace_emit(TraceEventType type, TracePhase phase, uint64_t arg0, uint32_t arg1);
+
+/**
+ * @brief Record an event on a given CPU
+ *
+ * @param cpu CPU to record on (taken modulo the number of rings)
+ * @param type Event type
+ * @param phase Event phase
+ * @param arg0 First argument
+ * @param arg1 Second argument
+ */
+void trace_emit_on(uint32_t cpu, TraceEventType type, TracePhase phase, uint64_t arg0, uint32_t arg1);
+
+/**
+ * @brief Read events recorded since a cursor last read
+ *
+ * Events come in order per CPU but not across CPUs. Readers do not block
+ * writers; events overwritten before they are read are counted in
+ * cursor->missed.
+ *
+ * @param cursor Read positions, advanced past the events returned
+ * @param events Buffer to fill
+ * @param max_events Capacity of the buffer
+ * @return Number of events read
+ */
+uint32_t trace_read(TraceCursor* cursor, TraceEvent* events, uint32_t max_events);
+
+/**
+ * @brief Get the name of an event type
+ *
+ * @param type Event type
+ * @return Name of the type, or "unknown"
+ */
+const char* trace_event_name(TraceEventType type);
+
+/**
+ * @brief Write every event held in Chrome trace format
+ *
+ * The file loads in chrome://tracing and Perfetto. It is replaced
+ * atomically, so readers never see partial output.
+ *
+ * @param path Output file path
+ * @return true if the file was written, false otherwise
+ */
+bool trace_write_chrome_json(const char* path);
+
+/**
+ * @brief Append events recorded since a cursor last read to a binary file
+ *
+ * Once the file reaches max_bytes it is renamed to "<path>.old" and a new
+ * one is started, so tailing readers can tell by its inode.
+ *
+ * @param path Output file path
+ * @param cursor Read positions, advanced past the events written
+ * @param max_bytes Size at which the file is rotated (0 for no limit)
+ * @return Number of events appended, or -1 on failure
+ */
+int64_t trace_append_binary(const char* path, TraceCursor* cursor, uint64_t max_bytes);
+
+#endif /* CTRLXT_TRACE_H */
@@ -3,42 +3,404 @@
  * @brief Implementation of Memex integration interface
  */
 
+/* strdup, clock_gettime and pthread_rwlock_t under -std=c11 */
+#define _XOPEN_SOURCE 700
+
 #include "memex_interface.h"
+#include "../search/search_engine.h"
+#include "../search/vector_index.h"
+#include "../search/result_cache.h"
+#include "../knowledge/knowledge_graph.h"
+#include "../storage/knowledge_store.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
 /* Forward declarations of internal components */
 static bool init_search_engine(const MemexInitOptions *options);
 static bool init_knowledge_graph(const MemexInitOptions *options);
 static bool init_context_engine(const MemexInitOptions *options);
+static bool init_storage(const MemexInitOptions *options);
+static bool init_result_cache(const MemexInitOptions *options);
+static bool checkpoint_storage(void);
 static bool register_with_quantum_bus(const MemexInitOptions *options);
 
 /* Memex state */
 static bool memex_initialized = false;
 static MemexInitOptions memex_options = {0};
 static MemexContext *current_contexts[MEMEX_CONTEXT_QUANTUM + 1] = {NULL};
+static pthread_rwlock_t context_lock = PTHREAD_RWLOCK_INITIALIZER;
 
-/* Next ID for items and relations */
-static uint64_t next_item_id = 1;
-static uint64_t next_relation_id = 1;
+/*
+ * Items and relations are spread over shards, each behind its own
+ * reader-writer lock. Slot s of shard k holds global slot
+ * s * MEMEX_SHARD_COUNT + k, so the shard of an ID is read straight off
+ * its low bits and IDs keep the unsharded layout on disk.
+ */
+#define MEMEX_SHARD_BITS 4
+#define MEMEX_SHARD_COUNT (1u << MEMEX_SHARD_BITS)
+#define MEMEX_SHARD_MASK (MEMEX_SHARD_COUNT - 1)
+#define MEMEX_SHARD_SLOTS (UINT32_MAX >> MEMEX_SHARD_BITS)
 
-/* In-memory storage for demonstration - would be persistent in a real implementation */
-#define MAX_ITEMS 1000
-#define MAX_RELATIONS 5000
-static MemexDataItem *items[MAX_ITEMS] = {NULL};
-static MemexRelation *relations[MAX_RELATIONS] = {NULL};
+/**
+ * @brief Growable map from IDs to stored pointers, for one shard
+ *
+ * An ID holds the slot's generation in its high 32 bits and the global
+ * slot index + 1 in its low 32 bits, so lookups index straight into the
+ * slot array. Freeing a slot bumps its generation, so stale IDs never
+ * resolve to a later occupant of the slot.
+ */
+typedef struct {
+    void **values;             /**< Stored pointer per slot (NULL if free) */
+    uint32_t *generations;     /**< Current generation per slot */
+    uint32_t *next_free;       /**< Free list links */
+    uint32_t capacity;         /**< Number of slots */
+    uint32_t count;            /**< Number of occupied slots */
+    uint32_t free_head;        /**< First free slot, or UINT32_MAX */
+    uint32_t shard;            /**< Shard the map belongs to */
+} MemexSlotMap;
 
 /**
- * @brief Create a deep copy of a data item
+ * @brief Stored item with its reference count
+ *
+ * The store holds one reference; memex_acquire_item() hands out more.
+ * Updating or deleting an item drops the store's reference, and the
+ * record is freed when the last borrower releases it.
  */
-static MemexDataItem *clone_data_item(const MemexDataItem *item) {
-    if (!item) return NULL;
+typedef struct {
+    MemexDataItem item;        /**< Item (first, so borrowed pointers convert back) */
+    _Atomic uint32_t references; /**< Outstanding references */
+    float *embedding;          /**< Embedding set by memex_set_item_embedding(), or NULL */
+    uint64_t version;          /**< Bumped on every change to the item or its relations */
+} MemexItemRecord;
+
+/**
+ * @brief IDs of the relations incident to one item
+ */
+typedef struct {
+    uint64_t *relation_ids;    /**< Relation IDs, unordered */
+    uint32_t count;            /**< Number of relations */
+    uint32_t capacity;         /**< Allocated entries */
+    uint32_t entangled;        /**< Number of them that are entanglements */
+} MemexAdjacency;
+
+/**
+ * @brief One shard of the item and relation registries
+ *
+ * The lock guards the maps, the relation lists and the item records'
+ * embeddings and versions. Operations that span shards lock them in
+ * ascending order.
+ */
+typedef struct {
+    pthread_rwlock_t lock;              /**< Shard lock */
+    MemexSlotMap items;                 /**< Items whose ID maps here */
+    MemexSlotMap relations;             /**< Relations whose ID maps here */
+    MemexAdjacency *item_relations;     /**< Relations per item, indexed like items' slots */
+    uint32_t item_relations_capacity;   /**< Entries in item_relations */
+} MemexShard;
+
+/**
+ * @brief Set of distinct shards locked together, ascending
+ */
+typedef struct {
+    uint32_t shards[3];        /**< Shard indexes */
+    uint32_t count;            /**< Number of shards */
+} MemexShardSet;
+
+/* Store record kinds; generation records use the MEMEX_GENERATIONS_* IDs */
+#define MEMEX_RECORD_ITEM 1
+#define MEMEX_RECORD_RELATION 2
+#define MEMEX_RECORD_GENERATIONS 3
+#define MEMEX_RECORD_EMBEDDING 4
+#define MEMEX_GENERATIONS_ITEMS 1
+#define MEMEX_GENERATIONS_RELATIONS 2
+
+/* Items and relations, persisted to the knowledge store with a data directory */
+static MemexShard memex_shards[MEMEX_SHARD_COUNT];
+static _Atomic uint32_t next_item_shard;
+static _Atomic uint32_t next_relation_shard;
+
+/*
+ * The log and the vector index are shared by every shard. Writers take
+ * the index lock after their shard locks; semantic searches take it alone.
+ */
+static pthread_mutex_t index_lock = PTHREAD_MUTEX_INITIALIZER;
+static KnowledgeStore *memex_store = NULL;
+static KnowledgeStoreBuffer memex_record = { NULL, 0, 0, false };
+
+/* Item embeddings for semantic search */
+static VectorIndex *memex_vectors = NULL;
+
+/* Candidate list size for semantic searches */
+#define MEMEX_SEMANTIC_EF 64
+
+/* Batch vector indexing splits embedding across up to this many threads */
+#define MEMEX_EMBED_THREADS 4
+#define MEMEX_EMBED_MIN_PER_THREAD 256
+
+/*
+ * Cached search results and summaries. Summaries are stamped with the
+ * version of each entity they cover; searches, which any stored or
+ * changed item could enter, with the corpus generation. The cache lock
+ * is never held while taking another lock.
+ */
+static ResultCache *memex_cache = NULL;
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static _Atomic uint64_t version_clock;
+static _Atomic uint64_t corpus_generation = 1;
+
+#define MEMEX_DEFAULT_CACHE_MB 16
+#define MEMEX_CACHE_SEARCH 1
+#define MEMEX_CACHE_SUMMARY 2
+
+/**
+ * @brief Grow a slot map to at least the given number of slots
+ *
+ * New slots start at generation 1 and are pushed onto the free list.
+ */
+static bool slot_map_grow(MemexSlotMap *map, uint32_t minimum) {
+    uint32_t capacity = map->capacity ? map->capacity : 64;
+    while (capacity < minimum && capacity <= MEMEX_SHARD_SLOTS / 2) {
+        capacity *= 2;
+    }
+    if (capacity < minimum || minimum > MEMEX_SHARD_SLOTS) {
+        return false;
+    }
+    if (capacity <= map->capacity) {
+        return true;
+    }
     
-    MemexDataItem *clone = (MemexDataItem *)malloc(sizeof(MemexDataItem));
-    if (!clone) return NULL;
+    void **values = (void **)realloc(map->values, capacity * sizeof(void *));
+    if (!values) {
+        return false;
+    }
+    map->values = values;
+    uint32_t *generations = (uint32_t *)realloc(map->generations, capacity * sizeof(uint32_t));
+    if (!generations) {
+        return false;
+    }
+    map->generations = generations;
+    uint32_t *next_free = (uint32_t *)realloc(map->next_free, capacity * sizeof(uint32_t));
+    if (!next_free) {
+        return false;
+    }
+    map->next_free = next_free;
+    
+    /* Chain the new slots so the lowest is used first */
+    for (uint32_t i = map->capacity; i < capacity; i++) {
+        map->values[i] = NULL;
+        map->generations[i] = 1;
+        map->next_free[i] = i + 1 < capacity ? i + 1 : map->free_head;
+    }
+    map->free_head = map->capacity;
+    map->capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief ID of a map's slot at its current generation
+ */
+static uint64_t slot_map_id(const MemexSlotMap *map, uint32_t slot) {
+    return ((uint64_t)map->generations[slot] << 32) | (((slot << MEMEX_SHARD_BITS) | map->shard) + 1);
+}
+
+/**
+ * @brief Slot an ID names within a map, or UINT32_MAX if it names another shard
+ */
+static uint32_t slot_map_slot(const MemexSlotMap *map, uint64_t id) {
+    uint32_t global = (uint32_t)id - 1;
+    if ((uint32_t)id == 0 || (global & MEMEX_SHARD_MASK) != map->shard) {
+        return UINT32_MAX;
+    }
+    return global >> MEMEX_SHARD_BITS;
+}
+
+/**
+ * @brief Insert a pointer into a slot map
+ *
+ * @return New ID, or 0 on allocation failure
+ */
+static uint64_t slot_map_insert(MemexSlotMap *map, void *value) {
+    if (map->free_head == UINT32_MAX && !slot_map_grow(map, map->capacity + 1)) {
+        return 0;
+    }
+    
+    uint32_t slot = map->free_head;
+    map->free_head = map->next_free[slot];
+    map->values[slot] = value;
+    map->count++;
+    return slot_map_id(map, slot);
+}
+
+/**
+ * @brief Put a pointer back under the ID it was stored with
+ *
+ * Used while loading; the free list is rebuilt afterwards.
+ *
+ * @return The pointer previously stored under the ID (NULL if none), or
+ *         value itself if the ID's slot cannot hold it
+ */
+static void *slot_map_restore(MemexSlotMap *map, uint64_t id, void *value) {
+    uint32_t slot = slot_map_slot(map, id);
+    uint32_t generation = (uint32_t)(id >> 32);
+    if (slot == UINT32_MAX || generation == 0 || !slot_map_grow(map, slot + 1) ||
+        (map->values[slot] && map->generations[slot] != generation)) {
+        return value;
+    }
     
+    void *previous = map->values[slot];
+    map->values[slot] = value;
+    map->generations[slot] = generation;
+    if (!previous) {
+        map->count++;
+    }
+    return previous;
+}
+
+/**
+ * @brief Relink a slot map's free slots, lowest first
+ */
+static void slot_map_rebuild_free_list(MemexSlotMap *map) {
+    map->free_head = UINT32_MAX;
+    for (uint32_t i = map->capacity; i-- > 0;) {
+        if (!map->values[i] && map->generations[i] != 0) {
+            map->next_free[i] = map->free_head;
+            map->free_head = i;
+        }
+    }
+}
+
+/**
+ * @brief Look up a slot index by ID
+ *
+ * @return Slot index, or UINT32_MAX if the ID is not live
+ */
+static uint32_t slot_map_find(const MemexSlotMap *map, uint64_t id) {
+    uint32_t slot = slot_map_slot(map, id);
+    if (slot >= map->capacity || !map->values[slot] ||
+        map->generations[slot] != (uint32_t)(id >> 32)) {
+        return UINT32_MAX;
+    }
+    return slot;
+}
+
+/**
+ * @brief Look up a stored pointer by ID
+ */
+static void *slot_map_get(const MemexSlotMap *map, uint64_t id) {
+    uint32_t slot = slot_map_find(map, id);
+    return slot == UINT32_MAX ? NULL : map->values[slot];
+}
+
+/**
+ * @brief Remove an ID from a slot map
+ *
+ * @return The pointer that was stored, or NULL if the ID was not live
+ */
+static void *slot_map_remove(MemexSlotMap *map, uint64_t id) {
+    uint32_t slot = slot_map_find(map, id);
+    if (slot == UINT32_MAX) {
+        return NULL;
+    }
+    
+    void *value = map->values[slot];
+    map->values[slot] = NULL;
+    
+    /* A slot whose generation would wrap is retired instead of reused */
+    if (++map->generations[slot] != 0) {
+        map->next_free[slot] = map->free_head;
+        map->free_head = slot;
+    }
+    map->count--;
+    return value;
+}
+
+/**
+ * @brief Release a slot map's arrays
+ */
+static void slot_map_destroy(MemexSlotMap *map) {
+    free(map->values);
+    free(map->generations);
+    free(map->next_free);
+    *map = (MemexSlotMap){ NULL, NULL, NULL, 0, 0, UINT32_MAX, map->shard };
+}
+
+/**
+ * @brief Shard an item or relation ID maps to
+ */
+static MemexShard *shard_of(uint64_t id) {
+    return &memex_shards[((uint32_t)id - 1) & MEMEX_SHARD_MASK];
+}
+
+/**
+ * @brief Shard for the next insert, taken in turn so writers spread out
+ */
+static MemexShard *next_shard(_Atomic uint32_t *counter) {
+    return &memex_shards[atomic_fetch_add(counter, 1) & MEMEX_SHARD_MASK];
+}
+
+/**
+ * @brief Write-lock up to three shards, each once, ascending
+ */
+static void lock_shards(MemexShardSet *set, MemexShard *const *shards, uint32_t count) {
+    set->count = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t shard = (uint32_t)(shards[i] - memex_shards);
+        uint32_t position = 0;
+        while (position < set->count && set->shards[position] < shard) {
+            position++;
+        }
+        if (position < set->count && set->shards[position] == shard) {
+            continue;
+        }
+        memmove(&set->shards[position + 1], &set->shards[position],
+                (set->count - position) * sizeof(uint32_t));
+        set->shards[position] = shard;
+        set->count++;
+    }
+    for (uint32_t i = 0; i < set->count; i++) {
+        pthread_rwlock_wrlock(&memex_shards[set->shards[i]].lock);
+    }
+}
+
+/**
+ * @brief Unlock shards locked with lock_shards()
+ */
+static void unlock_shards(const MemexShardSet *set) {
+    for (uint32_t i = set->count; i-- > 0;) {
+        pthread_rwlock_unlock(&memex_shards[set->shards[i]].lock);
+    }
+}
+
+/**
+ * @brief Lock every shard, ascending
+ */
+static void lock_all_shards(bool write) {
+    for (uint32_t k = 0; k < MEMEX_SHARD_COUNT; k++) {
+        if (write) {
+            pthread_rwlock_wrlock(&memex_shards[k].lock);
+        } else {
+            pthread_rwlock_rdlock(&memex_shards[k].lock);
+        }
+    }
+}
+
+/**
+ * @brief Unlock shards locked with lock_all_shards()
+ */
+static void unlock_all_shards(void) {
+    for (uint32_t k = MEMEX_SHARD_COUNT; k-- > 0;) {
+        pthread_rwlock_unlock(&memex_shards[k].lock);
+    }
+}
+
+/**
+ * @brief Deep-copy a data item into existing storage
+ */
+static bool copy_data_item(MemexDataItem *clone, const MemexDataItem *item) {
     /* Copy basic fields */
     clone->id = item->id;
     clone->type = item->type;
@@ -52,8 +414,7 @@ static MemexDataItem *clone_data_item(const MemexDataItem *item) {
     if (item->name) {
         clone->name = strdup(item->name);
         if (!clone->name) {
-            free(clone);
-            return NULL;
+            return false;
         }
     } else {
         clone->name = NULL;
@@ -64,8 +425,7 @@ static MemexDataItem *clone_data_item(const MemexDataItem *item) {
         clone->data = malloc(item->data_size);
         if (!clone->data) {
             free(clone->name);
-            free(clone);
-            return NULL;
+            return false;
         }
         memcpy(clone->data, item->data, item->data_size);
     } else {
@@ -78,16 +438,391 @@ static MemexDataItem *clone_data_item(const MemexDataItem *item) {
         if (!clone->metadata) {
             free(clone->data);
             free(clone->name);
-            free(clone);
-            return NULL;
+            return false;
         }
     } else {
         clone->metadata = NULL;
     }
     
+    return true;
+}
+
+/**
+ * @brief Create a deep copy of a data item
+ */
+static MemexDataItem *clone_data_item(const MemexDataItem *item) {
+    if (!item) return NULL;
+    
+    MemexDataItem *clone = (MemexDataItem *)malloc(sizeof(MemexDataItem));
+    if (!clone) return NULL;
+    
+    if (!copy_data_item(clone, item)) {
+        free(clone);
+        return NULL;
+    }
     return clone;
 }
 
+/**
+ * @brief Create a stored record holding a deep copy of an item
+ */
+static MemexItemRecord *create_item_record(const MemexDataItem *item) {
+    MemexItemRecord *record = (MemexItemRecord *)malloc(sizeof(MemexItemRecord));
+    if (!record) {
+        return NULL;
+    }
+    
+    if (!copy_data_item(&record->item, item)) {
+        free(record);
+        return NULL;
+    }
+    record->references = 1;
+    record->embedding = NULL;
+    record->version = 0;
+    return record;
+}
+
+/**
+ * @brief Drop a reference to a stored record, freeing it with the last one
+ */
+static void release_item_record(MemexItemRecord *record) {
+    if (atomic_fetch_sub(&record->references, 1) == 1) {
+        free(record->item.name);
+        free(record->item.data);
+        free(record->item.metadata);
+        free(record->embedding);
+        free(record);
+    }
+}
+
+/**
+ * @brief Find a stored item record by ID (the caller holds its shard lock)
+ */
+static MemexItemRecord *find_record(uint64_t id) {
+    return (MemexItemRecord *)slot_map_get(&shard_of(id)->items, id);
+}
+
+/**
+ * @brief Find a stored item by ID (the caller holds its shard lock)
+ */
+static MemexDataItem *find_item(uint64_t id) {
+    MemexItemRecord *record = find_record(id);
+    return record ? &record->item : NULL;
+}
+
+/**
+ * @brief Find a stored relation by ID (the caller holds its shard lock)
+ */
+static MemexRelation *find_relation(uint64_t id) {
+    return (MemexRelation *)slot_map_get(&shard_of(id)->relations, id);
+}
+
+/**
+ * @brief Whether an item exists
+ */
+static bool item_exists(uint64_t id) {
+    MemexShard *shard = shard_of(id);
+    pthread_rwlock_rdlock(&shard->lock);
+    bool exists = find_item(id) != NULL;
+    pthread_rwlock_unlock(&shard->lock);
+    return exists;
+}
+
+/**
+ * @brief Find the relation list of a stored item (the caller holds its shard lock)
+ *
+ * @param id Item ID
+ * @param create Whether to grow the adjacency table to cover the item
+ * @return Relation list, or NULL if the item does not exist (or has no
+ *         list yet and create is false, or allocation failed)
+ */
+static MemexAdjacency *find_adjacency(uint64_t id, bool create) {
+    MemexShard *shard = shard_of(id);
+    uint32_t slot = slot_map_find(&shard->items, id);
+    if (slot == UINT32_MAX) {
+        return NULL;
+    }
+    
+    if (slot >= shard->item_relations_capacity) {
+        if (!create) {
+            return NULL;
+        }
+        uint32_t capacity = shard->items.capacity;
+        MemexAdjacency *grown = (MemexAdjacency *)realloc(shard->item_relations,
+                                                          capacity * sizeof(MemexAdjacency));
+        if (!grown) {
+            return NULL;
+        }
+        memset(grown + shard->item_relations_capacity, 0,
+               (capacity - shard->item_relations_capacity) * sizeof(MemexAdjacency));
+        shard->item_relations = grown;
+        shard->item_relations_capacity = capacity;
+    }
+    return &shard->item_relations[slot];
+}
+
+/**
+ * @brief Append a relation to an item's relation list
+ */
+static bool adjacency_add(MemexAdjacency *adjacency, const MemexRelation *relation) {
+    if (adjacency->count == adjacency->capacity) {
+        uint32_t capacity = adjacency->capacity ? adjacency->capacity * 2 : 4;
+        uint64_t *ids = (uint64_t *)realloc(adjacency->relation_ids, capacity * sizeof(uint64_t));
+        if (!ids) {
+            return false;
+        }
+        adjacency->relation_ids = ids;
+        adjacency->capacity = capacity;
+    }
+    adjacency->relation_ids[adjacency->count++] = relation->id;
+    if (relation->type == MEMEX_RELATION_ENTANGLED) {
+        adjacency->entangled++;
+    }
+    return true;
+}
+
+/**
+ * @brief Drop a relation from an item's relation list
+ */
+static void adjacency_remove(MemexAdjacency *adjacency, const MemexRelation *relation) {
+    for (uint32_t i = 0; i < adjacency->count; i++) {
+        if (adjacency->relation_ids[i] == relation->id) {
+            adjacency->relation_ids[i] = adjacency->relation_ids[--adjacency->count];
+            if (relation->type == MEMEX_RELATION_ENTANGLED) {
+                adjacency->entangled--;
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Whether a relation has the wanted type (UNDEFINED matches any)
+ */
+static bool relation_matches(const MemexRelation *relation, MemexRelationType relation_type) {
+    return relation_type == MEMEX_RELATION_UNDEFINED || relation->type == relation_type;
+}
+
+/**
+ * @brief Whether an item takes part in an entanglement relation (the caller holds its shard lock)
+ */
+static bool is_entangled(uint64_t id) {
+    const MemexAdjacency *adjacency = find_adjacency(id, false);
+    return adjacency && adjacency->entangled > 0;
+}
+
+/**
+ * @brief Add or replace a stored item in the search index
+ *
+ * The name and, for text items, the content are searchable.
+ */
+static bool index_item(const MemexDataItem *item) {
+    SearchDocument document = {
+        .id = item->id,
+        .type = item->type == MEMEX_TYPE_QUANTUM_STATE ? RESULT_QUANTUM : RESULT_KNOWLEDGE,
+        .title = item->name,
+        .text = item->type == MEMEX_TYPE_TEXT ? (const char *)item->data : NULL,
+        .text_length = item->type == MEMEX_TYPE_TEXT ? item->data_size : 0,
+        .resonance_level = (uint32_t)item->resonance_level,
+        .is_quantum_entangled = is_entangled(item->id)
+    };
+    return memex_search_index_document(&document);
+}
+
+/**
+ * @brief Note a change to a stored item for the result cache
+ *
+ * @param record Changed item (NULL if it was deleted)
+ * @param searchable Whether the change can alter search results
+ */
+static void touch_item(MemexItemRecord *record, bool searchable) {
+    if (record) {
+        record->version = atomic_fetch_add(&version_clock, 1) + 1;
+    }
+    if (searchable) {
+        atomic_fetch_add(&corpus_generation, 1);
+    }
+}
+
+/**
+ * @brief Current version of an item, 0 if it does not exist
+ */
+static uint64_t item_version(uint64_t id) {
+    MemexShard *shard = shard_of(id);
+    pthread_rwlock_rdlock(&shard->lock);
+    const MemexItemRecord *record = find_record(id);
+    uint64_t version = record ? record->version : 0;
+    pthread_rwlock_unlock(&shard->lock);
+    return version;
+}
+
+/**
+ * @brief Compute the embedding of a stored item
+ *
+ * @return false if the item has no set embedding and no words
+ */
+static bool embed_item(const MemexItemRecord *record, float *embedding) {
+    if (record->embedding) {
+        memcpy(embedding, record->embedding, MEMEX_EMBEDDING_DIMENSIONS * sizeof(float));
+        return true;
+    }
+    const MemexDataItem *item = &record->item;
+    const char *texts[2] = {
+        item->name, item->type == MEMEX_TYPE_TEXT ? (const char *)item->data : NULL
+    };
+    size_t lengths[2] = {
+        item->name ? strlen(item->name) : 0,
+        item->type == MEMEX_TYPE_TEXT && item->data ? (size_t)item->data_size : 0
+    };
+    return vindex_embed_text(texts, lengths, 2, embedding, MEMEX_EMBEDDING_DIMENSIONS);
+}
+
+/**
+ * @brief Add or replace a stored item in the vector index
+ *
+ * Items with nothing to embed are left out.
+ */
+static bool index_vector(const MemexItemRecord *record) {
+    float embedding[MEMEX_EMBEDDING_DIMENSIONS];
+    if (!embed_item(record, embedding)) {
+        vindex_remove(memex_vectors, record->item.id);
+        return true;
+    }
+    VectorEntry entry = {
+        record->item.id, embedding, (uint32_t)record->item.resonance_level, (uint32_t)record->item.type
+    };
+    return vindex_insert(memex_vectors, &entry);
+}
+
+/**
+ * @brief Range of records whose embeddings one thread computes
+ */
+typedef struct {
+    MemexItemRecord *const *records;   /**< Records to embed */
+    VectorEntry *entries;              /**< Entry per record (vector NULL if it has nothing to embed) */
+    float *embeddings;                 /**< Embedding storage per record */
+    uint32_t begin;                    /**< First record */
+    uint32_t end;                      /**< One past the last record */
+} MemexEmbedJob;
+
+/**
+ * @brief Compute the embeddings of a range of records
+ */
+static void *embed_records(void *argument) {
+    const MemexEmbedJob *job = (const MemexEmbedJob *)argument;
+    for (uint32_t i = job->begin; i < job->end; i++) {
+        const MemexItemRecord *record = job->records[i];
+        float *embedding = job->embeddings + (size_t)i * MEMEX_EMBEDDING_DIMENSIONS;
+        job->entries[i] = (VectorEntry){
+            record->item.id, embed_item(record, embedding) ? embedding : NULL,
+            (uint32_t)record->item.resonance_level, (uint32_t)record->item.type
+        };
+    }
+    return NULL;
+}
+
+/**
+ * @brief Vector-index records in one batch, embedding them in parallel
+ *
+ * Records with nothing to embed are left out. Batches large enough to
+ * pay for the threads are split across MEMEX_EMBED_THREADS; a thread
+ * that fails to start has its range embedded by the caller.
+ *
+ * @return false if any record with an embedding failed to index
+ */
+static bool index_vectors(MemexItemRecord *const *records, uint32_t count) {
+    if (count == 0) {
+        return true;
+    }
+    VectorEntry *entries = (VectorEntry *)malloc(count * sizeof(VectorEntry));
+    float *embeddings = (float *)malloc((size_t)count * MEMEX_EMBEDDING_DIMENSIONS * sizeof(float));
+    if (!entries || !embeddings) {
+        free(entries);
+        free(embeddings);
+        return false;
+    }
+    
+    uint32_t thread_count = count / MEMEX_EMBED_MIN_PER_THREAD;
+    thread_count = thread_count < 1 ? 1 : thread_count > MEMEX_EMBED_THREADS ? MEMEX_EMBED_THREADS : thread_count;
+    MemexEmbedJob jobs[MEMEX_EMBED_THREADS];
+    pthread_t threads[MEMEX_EMBED_THREADS];
+    bool started[MEMEX_EMBED_THREADS] = { false };
+    for (uint32_t t = 0; t < thread_count; t++) {
+        jobs[t] = (MemexEmbedJob){
+            records, entries, embeddings,
+            (uint32_t)((uint64_t)count * t / thread_count), (uint32_t)((uint64_t)count * (t + 1) / thread_count)
+        };
+        started[t] = t > 0 && pthread_create(&threads[t], NULL, embed_records, &jobs[t]) == 0;
+    }
+    for (uint32_t t = 0; t < thread_count; t++) {
+        if (!started[t]) {
+            embed_records(&jobs[t]);
+        }
+    }
+    for (uint32_t t = 0; t < thread_count; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        }
+    }
+    
+    uint32_t embedded = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        embedded += entries[i].vector != NULL;
+    }
+    bool ok = embedded == 0 || vindex_insert_batch(memex_vectors, entries, count) == embedded;
+    free(entries);
+    free(embeddings);
+    return ok;
+}
+
+/**
+ * @brief Vector-index every stored item after a load, in one batch
+ */
+static bool index_loaded_vectors(void) {
+    uint32_t count = 0;
+    for (uint32_t k = 0; k < MEMEX_SHARD_COUNT; k++) {
+        count += memex_shards[k].items.count;
+    }
+    if (count == 0) {
+        return true;
+    }
+    MemexItemRecord **records = (MemexItemRecord **)malloc(count * sizeof(MemexItemRecord *));
+    if (!records) {
+        return false;
+    }
+    
+    uint32_t gathered = 0;
+    for (uint32_t k = 0; k < MEMEX_SHARD_COUNT; k++) {
+        const MemexSlotMap *items = &memex_shards[k].items;
+        for (uint32_t i = 0; i < items->capacity && gathered < count; i++) {
+            if (items->values[i]) {
+                records[gathered++] = (MemexItemRecord *)items->values[i];
+            }
+        }
+    }
+    
+    bool ok = index_vectors(records, gathered);
+    free(records);
+    return ok;
+}
+
+/**
+ * @brief Drop an item from the search and vector indexes
+ */
+static void unindex_item(uint64_t id) {
+    memex_search_remove_document(id);
+    vindex_remove(memex_vectors, id);
+}
+
+/**
+ * @brief Microseconds on the monotonic clock
+ */
+static uint64_t monotonic_microseconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000ULL + (uint64_t)now.tv_nsec / 1000;
+}
+
 /**
  * @brief Create a deep copy of a relation
  */
@@ -120,6 +855,398 @@ static MemexRelation *clone_relation(const MemexRelation *relation) {
     return clone;
 }
 
+/**
+ * @brief Encode an item record
+ */
+static void encode_item(KnowledgeStoreBuffer *buffer, const MemexDataItem *item) {
+    kstore_buffer_reset(buffer);
+    kstore_buffer_put_u32(buffer, (uint32_t)item->type);
+    kstore_buffer_put_u32(buffer, (uint32_t)item->resonance_level);
+    kstore_buffer_put_u64(buffer, item->creation_time);
+    kstore_buffer_put_u64(buffer, item->update_time);
+    kstore_buffer_put_f32(buffer, item->relevance);
+    kstore_buffer_put_string(buffer, item->name);
+    kstore_buffer_put_bytes(buffer, item->data, item->data ? item->data_size : 0);
+    kstore_buffer_put_string(buffer, item->metadata);
+}
+
+/**
+ * @brief Encode a relation record
+ */
+static void encode_relation(KnowledgeStoreBuffer *buffer, const MemexRelation *relation) {
+    kstore_buffer_reset(buffer);
+    kstore_buffer_put_u64(buffer, relation->source_id);
+    kstore_buffer_put_u64(buffer, relation->target_id);
+    kstore_buffer_put_u32(buffer, (uint32_t)relation->type);
+    kstore_buffer_put_f32(buffer, relation->weight);
+    kstore_buffer_put_u32(buffer, (uint32_t)relation->resonance_level);
+    kstore_buffer_put_u32(buffer, relation->is_bidirectional ? 1 : 0);
+    kstore_buffer_put_string(buffer, relation->metadata);
+}
+
+/**
+ * @brief Log an item put (no-op without a data directory)
+ */
+static bool log_item(const MemexDataItem *item) {
+    if (!memex_store) {
+        return true;
+    }
+    encode_item(&memex_record, item);
+    return !memex_record.failed &&
+           kstore_put(memex_store, MEMEX_RECORD_ITEM, item->id, memex_record.data,
+                      (uint32_t)memex_record.size);
+}
+
+/**
+ * @brief Log a relation put (no-op without a data directory)
+ */
+static bool log_relation(const MemexRelation *relation) {
+    if (!memex_store) {
+        return true;
+    }
+    encode_relation(&memex_record, relation);
+    return !memex_record.failed &&
+           kstore_put(memex_store, MEMEX_RECORD_RELATION, relation->id, memex_record.data,
+                      (uint32_t)memex_record.size);
+}
+
+/**
+ * @brief Log a delete (no-op without a data directory)
+ */
+static bool log_delete(uint32_t kind, uint64_t id) {
+    return !memex_store || kstore_delete(memex_store, kind, id);
+}
+
+/**
+ * @brief Encode an embedding record
+ */
+static void encode_embedding(KnowledgeStoreBuffer *buffer, const float *embedding) {
+    kstore_buffer_reset(buffer);
+    for (uint32_t i = 0; i < MEMEX_EMBEDDING_DIMENSIONS; i++) {
+        kstore_buffer_put_f32(buffer, embedding[i]);
+    }
+}
+
+/**
+ * @brief Log an item's set embedding, or its removal (no-op without a data directory)
+ */
+static bool log_embedding(const MemexItemRecord *record) {
+    if (!record->embedding) {
+        return log_delete(MEMEX_RECORD_EMBEDDING, record->item.id);
+    }
+    if (!memex_store) {
+        return true;
+    }
+    encode_embedding(&memex_record, record->embedding);
+    return !memex_record.failed &&
+           kstore_put(memex_store, MEMEX_RECORD_EMBEDDING, record->item.id, memex_record.data,
+                      (uint32_t)memex_record.size);
+}
+
+/**
+ * @brief Compact once the log has outgrown the snapshot
+ */
+static void maybe_checkpoint(void) {
+    if (!memex_store) {
+        return;
+    }
+    pthread_mutex_lock(&index_lock);
+    bool compact = kstore_should_compact(memex_store);
+    pthread_mutex_unlock(&index_lock);
+    if (compact) {
+        checkpoint_storage();
+    }
+}
+
+/**
+ * @brief Decode a stored item into a new record
+ */
+static MemexItemRecord *decode_item(const KnowledgeStoreRecord *stored) {
+    MemexItemRecord *record = (MemexItemRecord *)calloc(1, sizeof(MemexItemRecord));
+    if (!record) {
+        return NULL;
+    }
+    record->references = 1;
+    
+    MemexDataItem *item = &record->item;
+    KnowledgeStoreReader reader;
+    kstore_reader_init(&reader, stored);
+    item->id = stored->id;
+    item->type = (MemexDataType)kstore_read_u32(&reader);
+    item->resonance_level = (NodeLevel)kstore_read_u32(&reader);
+    item->creation_time = kstore_read_u64(&reader);
+    item->update_time = kstore_read_u64(&reader);
+    item->relevance = kstore_read_f32(&reader);
+    bool ok = kstore_read_string(&reader, &item->name);
+    const void *data = ok ? kstore_read_bytes(&reader, &item->data_size) : NULL;
+    if (ok && data && item->data_size > 0) {
+        item->data = malloc(item->data_size);
+        ok = item->data != NULL;
+        if (ok) {
+            memcpy(item->data, data, item->data_size);
+        }
+    }
+    ok = ok && !reader.failed && kstore_read_string(&reader, &item->metadata);
+    if (!ok) {
+        release_item_record(record);
+        return NULL;
+    }
+    return record;
+}
+
+/**
+ * @brief Decode a stored relation
+ */
+static MemexRelation *decode_relation(const KnowledgeStoreRecord *stored) {
+    MemexRelation *relation = (MemexRelation *)calloc(1, sizeof(MemexRelation));
+    if (!relation) {
+        return NULL;
+    }
+    
+    KnowledgeStoreReader reader;
+    kstore_reader_init(&reader, stored);
+    relation->id = stored->id;
+    relation->source_id = kstore_read_u64(&reader);
+    relation->target_id = kstore_read_u64(&reader);
+    relation->type = (MemexRelationType)kstore_read_u32(&reader);
+    relation->weight = kstore_read_f32(&reader);
+    relation->resonance_level = (NodeLevel)kstore_read_u32(&reader);
+    relation->is_bidirectional = kstore_read_u32(&reader) != 0;
+    if (!kstore_read_string(&reader, &relation->metadata)) {
+        free(relation);
+        return NULL;
+    }
+    return relation;
+}
+
+/**
+ * @brief Restore or clear the embedding set on a stored item
+ */
+static bool restore_embedding(KnowledgeStoreOp op, const KnowledgeStoreRecord *stored) {
+    MemexItemRecord *record = find_record(stored->id);
+    if (op == KSTORE_OP_DELETE) {
+        if (record) {
+            free(record->embedding);
+            record->embedding = NULL;
+        }
+        return true;
+    }
+    if (!record || stored->size != MEMEX_EMBEDDING_DIMENSIONS * sizeof(float)) {
+        return false;
+    }
+    
+    float *embedding = (float *)malloc(MEMEX_EMBEDDING_DIMENSIONS * sizeof(float));
+    if (!embedding) {
+        return false;
+    }
+    KnowledgeStoreReader reader;
+    kstore_reader_init(&reader, stored);
+    for (uint32_t i = 0; i < MEMEX_EMBEDDING_DIMENSIONS; i++) {
+        embedding[i] = kstore_read_f32(&reader);
+    }
+    free(record->embedding);
+    record->embedding = embedding;
+    return true;
+}
+
+/**
+ * @brief Item or relation map of a shard
+ */
+static MemexSlotMap *shard_map(MemexShard *shard, bool items) {
+    return items ? &shard->items : &shard->relations;
+}
+
+/**
+ * @brief Restore the generations of free slots, so their old IDs stay dead
+ *
+ * The record lists generations by global slot.
+ */
+static bool restore_generations(bool items, const KnowledgeStoreRecord *stored) {
+    uint32_t count = stored->size / sizeof(uint32_t);
+    for (uint32_t k = 0; k < MEMEX_SHARD_COUNT && k < count; k++) {
+        if (!slot_map_grow(shard_map(&memex_shards[k], items), ((count - k - 1) >> MEMEX_SHARD_BITS) + 1)) {
+            return false;
+        }
+    }
+    
+    KnowledgeStoreReader reader;
+    kstore_reader_init(&reader, stored);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t generation = kstore_read_u32(&reader);
+        MemexSlotMap *map = shard_map(&memex_shards[i & MEMEX_SHARD_MASK], items);
+        uint32_t slot = i >> MEMEX_SHARD_BITS;
+        if (!map->values[slot]) {
+            map->generations[slot] = generation;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Apply one stored record to the item and relation maps
+ *
+ * Relation endpoints and the search index are rebuilt once loading ends.
+ */
+static bool replay_record(KnowledgeStoreOp op, const KnowledgeStoreRecord *stored, void *context) {
+    (void)context;
+    
+    if (stored->kind == MEMEX_RECORD_GENERATIONS) {
+        return op == KSTORE_OP_PUT &&
+               (stored->id == MEMEX_GENERATIONS_ITEMS ? restore_generations(true, stored) :
+                stored->id == MEMEX_GENERATIONS_RELATIONS ? restore_generations(false, stored) :
+                false);
+    }
+    
+    if (stored->kind == MEMEX_RECORD_ITEM) {
+        MemexItemRecord *record = NULL;
+        if (op == KSTORE_OP_PUT) {
+            record = decode_item(stored);
+            if (!record) {
+                return false;
+            }
+            MemexItemRecord *previous =
+                (MemexItemRecord *)slot_map_restore(&shard_of(stored->id)->items, stored->id, record);
+            if (previous == record) {
+                release_item_record(record);
+                return false;
+            }
+            
+            /* A set embedding survives updates of the item */
+            if (previous) {
+                record->embedding = previous->embedding;
+                previous->embedding = NULL;
+            }
+            record = previous;
+        } else {
+            record = (MemexItemRecord *)slot_map_remove(&shard_of(stored->id)->items, stored->id);
+        }
+        if (record) {
+            release_item_record(record);
+        }
+        return true;
+    }
+    
+    if (stored->kind == MEMEX_RECORD_RELATION) {
+        MemexRelation *relation = NULL;
+        if (op == KSTORE_OP_PUT) {
+            relation = decode_relation(stored);
+            if (!relation) {
+                return false;
+            }
+            MemexRelation *previous =
+                (MemexRelation *)slot_map_restore(&shard_of(stored->id)->relations, stored->id, relation);
+            if (previous == relation) {
+                free(relation->metadata);
+                free(relation);
+                return false;
+            }
+            relation = previous;
+        } else {
+            relation = (MemexRelation *)slot_map_remove(&shard_of(stored->id)->relations, stored->id);
+        }
+        if (relation) {
+            free(relation->metadata);
+            free(relation);
+        }
+        return true;
+    }
+    
+    if (stored->kind == MEMEX_RECORD_EMBEDDING) {
+        return restore_embedding(op, stored);
+    }
+    return false;
+}
+
+/**
+ * @brief Rebuild relation endpoints and the search and vector indexes after loading
+ */
+static bool rebuild_loaded_state(void) {
+    for (uint32_t k = 0; k < MEMEX_SHARD_COUNT; k++) {
+        slot_map_rebuild_free_list(&memex_shards[k].items);
+        slot_map_rebuild_free_list(&memex_shards[k].relations);
+    }
+    
+    for (uint32_t k = 0; k < MEMEX_SHARD_COUNT; k++) {
+        const MemexSlotMap *relations = &memex_shards[k].relations;
+        for (uint32_t i = 0; i < relations->capacity; i++) {
+            const MemexRelation *relation = (const MemexRelation *)relations->values[i];
+            if (!relation) {
+                continue;
+            }
+            MemexAdjacency *source = find_adjacency(relation->source_id, true);
+            MemexAdjacency *target = find_adjacency(relation->target_id, true);
+            if (!source || !target || !adjacency_add(source, relation) ||
+                (target != source && !adjacency_add(target, relation))) {
+                printf("Memex relation %llu has a missing endpoint\n", (unsigned long long)relation->id);
+                return false;
+            }
+        }
+    }
+    
+    /* Indexed last so entanglement flags see every relation */
+    for (uint32_t k = 0; k < MEMEX_SHARD_COUNT; k++) {
+        const MemexSlotMap *items = &memex_shards[k].items;
+        for (uint32_t i = 0; i < items->capacity; i++) {
+            MemexItemRecord *record = (MemexItemRecord *)items->values[i];
+            if (record) {
+                touch_item(record, false);
+                if (!index_item(&record->item)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return index_loaded_vectors();
+}
+
+/**
+ * @brief Free every stored item and relation and close the store
+ */
+static void release_storage(void) {
+    for (uint32_t k = 0; k < MEMEX_SHARD_COUNT; k++) {
+        MemexShard *shard = &memex_shards[k];
+        
+        /* Drop the store's reference to every item */
+        for (uint32_t i = 0; i < shard->items.capacity; i++) {
+            if (shard->items.values[i]) {
+                release_item_record((MemexItemRecord *)shard->items.values[i]);
+            }
+        }
+        slot_map_destroy(&shard->items);
+        
+        /* Free all stored relations */
+        for (uint32_t i = 0; i < shard->relations.capacity; i++) {
+            MemexRelation *relation = (MemexRelation *)shard->relations.values[i];
+            if (relation) {
+                free(relation->metadata);
+                free(relation);
+            }
+        }
+        slot_map_destroy(&shard->relations);
+        for (uint32_t i = 0; i < shard->item_relations_capacity; i++) {
+            free(shard->item_relations[i].relation_ids);
+        }
+        free(shard->item_relations);
+        shard->item_relations = NULL;
+        shard->item_relations_capacity = 0;
+        pthread_rwlock_destroy(&shard->lock);
+    }
+    
+    kstore_close(memex_store);
+    memex_store = NULL;
+    kstore_buffer_free(&memex_record);
+    vindex_destroy(memex_vectors);
+    memex_vectors = NULL;
+}
+
+/**
+ * @brief Destroy the result cache
+ */
+static void release_result_cache(void) {
+    rcache_destroy(memex_cache);
+    memex_cache = NULL;
+}
+
 /**
  * @brief Free a context
  */
@@ -132,28 +1259,62 @@ static void free_context(MemexContext *context) {
 }
 
 /**
- * @brief Message handler for quantum bus messages
+ * @brief Resolve the notification Memex logs for a message type
+ *
+ * @return Notification text, or NULL for types Memex only records
  */
-void memex_handle_quantum_message(QMessage *message, void *context) {
-    if (!memex_initialized || !message) return;
-    
-    printf("Memex received quantum message: Type=%u\n", message->header.type);
-    
-    /* Process the message based on type */
-    switch (message->header.type) {
+static const char *quantum_message_notification(QMessageType type) {
+    switch (type) {
         case QMSG_SYSTEM_STARTUP:
             /* System is starting up */
-            printf("Memex: System startup notification received\n");
-            break;
+            return "System startup notification received";
             
         case QMSG_SYSTEM_SHUTDOWN:
             /* System is shutting down */
-            printf("Memex: System shutdown notification received\n");
-            break;
+            return "System shutdown notification received";
             
         default:
             /* Handle other message types as needed */
-            break;
+            return NULL;
+    }
+}
+
+/**
+ * @brief Process one quantum message whose type is already resolved
+ *
+ * Caller must have checked that Memex is initialized.
+ */
+static void process_quantum_message(const QMessage *message, const char *notification) {
+    printf("Memex received quantum message: Type=%u\n", message->header.type);
+    
+    if (notification) {
+        printf("Memex: %s\n", notification);
+    }
+}
+
+/**
+ * @brief Message handler for quantum bus messages
+ */
+void memex_handle_quantum_message(QMessage *message, void *context) {
+    (void)context;
+    if (!memex_initialized || !message) return;
+    
+    process_quantum_message(message, quantum_message_notification(message->header.type));
+}
+
+/**
+ * @brief Batch message handler for quantum bus messages
+ *
+ * Every message in a span shares its type, so the checks and the type
+ * dispatch run once per span.
+ */
+void memex_handle_quantum_message_batch(QMessage *const *messages, uint32_t count, void *context) {
+    (void)context;
+    if (!memex_initialized || !messages || count == 0) return;
+    
+    const char *notification = quantum_message_notification(messages[0]->header.type);
+    for (uint32_t i = 0; i < count; i++) {
+        process_quantum_message(messages[i], notification);
     }
 }
 
@@ -179,6 +1340,16 @@ bool memex_init(const MemexInitOptions *options) {
     memex_options.component_id = options->component_id;
     memex_options.custom_config = options->custom_config;
     
+    /* Empty shards; IDs are handed out from shard 0 on */
+    for (uint32_t k = 0; k < MEMEX_SHARD_COUNT; k++) {
+        MemexShard *shard = &memex_shards[k];
+        pthread_rwlock_init(&shard->lock, NULL);
+        shard->items = (MemexSlotMap){ NULL, NULL, NULL, 0, 0, UINT32_MAX, k };
+        shard->relations = (MemexSlotMap){ NULL, NULL, NULL, 0, 0, UINT32_MAX, k };
+    }
+    atomic_store(&next_item_shard, 0);
+    atomic_store(&next_relation_shard, 0);
+    
     /* Initialize components */
     if (!init_search_engine(options)) {
         printf("Failed to initialize Memex search engine\n");
@@ -190,8 +1361,18 @@ bool memex_init(const MemexInitOptions *options) {
         goto cleanup;
     }
     
-    if (!init_context_engine(options)) {
-        printf("Failed to initialize Memex context engine\n");
+    if (!init_context_engine(options)) {
+        printf("Failed to initialize Memex context engine\n");
+        goto cleanup;
+    }
+    
+    if (!init_storage(options)) {
+        printf("Failed to load Memex storage\n");
+        goto cleanup;
+    }
+    
+    if (!init_result_cache(options)) {
+        printf("Failed to initialize Memex result cache\n");
         goto cleanup;
     }
     
@@ -203,15 +1384,15 @@ bool memex_init(const MemexInitOptions *options) {
         }
     }
     
-    /* Initialize storage */
-    memset(items, 0, sizeof(items));
-    memset(relations, 0, sizeof(relations));
-    
     memex_initialized = true;
     printf("Memex subsystem initialized successfully\n");
     return true;
     
 cleanup:
+    release_result_cache();
+    release_storage();
+    kg_shutdown();
+    memex_search_shutdown();
     free(memex_options.data_directory);
     memex_options.data_directory = NULL;
     return false;
@@ -222,9 +1403,7 @@ cleanup:
  */
 static bool init_search_engine(const MemexInitOptions *options) {
     printf("Initializing Memex search engine...\n");
-    /* In a real implementation, this would initialize a sophisticated search engine */
-    /* For now, we'll just simulate success */
-    return true;
+    return memex_search_init();
 }
 
 /**
@@ -232,9 +1411,7 @@ static bool init_search_engine(const MemexInitOptions *options) {
  */
 static bool init_knowledge_graph(const MemexInitOptions *options) {
     printf("Initializing Memex knowledge graph...\n");
-    /* In a real implementation, this would initialize a knowledge graph database */
-    /* For now, we'll just simulate success */
-    return true;
+    return kg_init(options->data_directory, options->enable_quantum, options->max_resonance);
 }
 
 /**
@@ -249,6 +1426,159 @@ static bool init_context_engine(const MemexInitOptions *options) {
     return true;
 }
 
+/**
+ * @brief Create the vector index and load the persisted items and relations
+ *
+ * Without a data directory Memex keeps everything in memory.
+ */
+static bool init_storage(const MemexInitOptions *options) {
+    VectorIndexOptions vector_options = {
+        MEMEX_EMBEDDING_DIMENSIONS, VINDEX_METRIC_COSINE, 0, 0, VINDEX_KERNEL_AUTO
+    };
+    memex_vectors = vindex_create(&vector_options);
+    if (!memex_vectors) {
+        return false;
+    }
+    if (!options->data_directory) {
+        return true;
+    }
+    
+    printf("Loading Memex storage from %s...\n", options->data_directory);
+    memex_store = kstore_open(options->data_directory, "memex", false);
+    return memex_store && kstore_load(memex_store, replay_record, NULL) && rebuild_loaded_state();
+}
+
+/**
+ * @brief Create the result cache
+ */
+static bool init_result_cache(const MemexInitOptions *options) {
+    uint32_t megabytes = options->cache_size_mb ? options->cache_size_mb : MEMEX_DEFAULT_CACHE_MB;
+    memex_cache = rcache_create((size_t)megabytes * 1024 * 1024);
+    return memex_cache != NULL;
+}
+
+/**
+ * @brief Add every record of one shard to the snapshot being written
+ */
+static bool snapshot_shard(const MemexShard *shard) {
+    bool ok = true;
+    for (uint32_t i = 0; ok && i < shard->items.capacity; i++) {
+        const MemexItemRecord *record = (const MemexItemRecord *)shard->items.values[i];
+        if (record) {
+            encode_item(&memex_record, &record->item);
+            ok = !memex_record.failed &&
+                 kstore_snapshot_add(memex_store, MEMEX_RECORD_ITEM, record->item.id,
+                                     memex_record.data, (uint32_t)memex_record.size);
+        }
+    }
+    for (uint32_t i = 0; ok && i < shard->relations.capacity; i++) {
+        const MemexRelation *relation = (const MemexRelation *)shard->relations.values[i];
+        if (relation) {
+            encode_relation(&memex_record, relation);
+            ok = !memex_record.failed &&
+                 kstore_snapshot_add(memex_store, MEMEX_RECORD_RELATION, relation->id,
+                                     memex_record.data, (uint32_t)memex_record.size);
+        }
+    }
+    for (uint32_t i = 0; ok && i < shard->items.capacity; i++) {
+        const MemexItemRecord *record = (const MemexItemRecord *)shard->items.values[i];
+        if (record && record->embedding) {
+            encode_embedding(&memex_record, record->embedding);
+            ok = !memex_record.failed &&
+                 kstore_snapshot_add(memex_store, MEMEX_RECORD_EMBEDDING, record->item.id,
+                                     memex_record.data, (uint32_t)memex_record.size);
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Add the slot generations of the item or relation maps, by global slot
+ */
+static bool snapshot_generations(bool items) {
+    uint32_t capacity = 0;
+    for (uint32_t k = 0; k < MEMEX_SHARD_COUNT; k++) {
+        uint32_t shard_capacity = shard_map(&memex_shards[k], items)->capacity;
+        capacity = shard_capacity > capacity ? shard_capacity : capacity;
+    }
+    
+    kstore_buffer_reset(&memex_record);
+    for (uint32_t slot = 0; slot < capacity; slot++) {
+        for (uint32_t k = 0; k < MEMEX_SHARD_COUNT; k++) {
+            const MemexSlotMap *map = shard_map(&memex_shards[k], items);
+            kstore_buffer_put_u32(&memex_record, slot < map->capacity ? map->generations[slot] : 1);
+        }
+    }
+    return !memex_record.failed &&
+           kstore_snapshot_add(memex_store, MEMEX_RECORD_GENERATIONS,
+                               items ? MEMEX_GENERATIONS_ITEMS : MEMEX_GENERATIONS_RELATIONS,
+                               memex_record.data, (uint32_t)memex_record.size);
+}
+
+/**
+ * @brief Write a compacted snapshot of the stored items and relations
+ *
+ * Every shard is read-locked for the duration, so the snapshot sees no
+ * half-applied change.
+ */
+static bool checkpoint_storage(void) {
+    if (!memex_store) {
+        return true;
+    }
+    lock_all_shards(false);
+    pthread_mutex_lock(&index_lock);
+    
+    bool ok = kstore_begin_snapshot(memex_store);
+    bool started = ok;
+    for (uint32_t k = 0; ok && k < MEMEX_SHARD_COUNT; k++) {
+        ok = snapshot_shard(&memex_shards[k]);
+    }
+    ok = ok && snapshot_generations(true) && snapshot_generations(false);
+    bool ended = started && kstore_end_snapshot(memex_store, ok);
+    
+    pthread_mutex_unlock(&index_lock);
+    unlock_all_shards();
+    if (!ended || !ok) {
+        printf("Failed to checkpoint Memex storage\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Write compacted snapshots of Memex and its knowledge graph
+ */
+bool memex_checkpoint(void) {
+    if (!memex_initialized) {
+        return false;
+    }
+    
+    bool graph = kg_checkpoint();
+    return checkpoint_storage() && graph;
+}
+
+/**
+ * @brief Read the result cache statistics
+ */
+bool memex_get_cache_stats(MemexCacheStats *stats) {
+    if (!memex_initialized || !stats) {
+        return false;
+    }
+    
+    ResultCacheStats cache_stats;
+    pthread_mutex_lock(&cache_lock);
+    rcache_get_stats(memex_cache, &cache_stats);
+    pthread_mutex_unlock(&cache_lock);
+    stats->hits = cache_stats.hits;
+    stats->misses = cache_stats.misses;
+    stats->invalidations = cache_stats.invalidations;
+    stats->evictions = cache_stats.evictions;
+    stats->entries = cache_stats.entries;
+    stats->bytes = cache_stats.bytes;
+    stats->capacity = cache_stats.capacity;
+    return true;
+}
+
 /**
  * @brief Register with the quantum message bus
  */
@@ -275,7 +1605,8 @@ static bool register_with_quantum_bus(const MemexInitOptions *options) {
         .message_type = -1, /* All message types */
         .handler = memex_handle_quantum_message,
         .context = NULL,
-        .min_resonance = NODE_ZERO_POINT
+        .min_resonance = NODE_ZERO_POINT,
+        .batch_handler = memex_handle_quantum_message_batch
     };
     
     result = qbus_subscribe(&subscription);
@@ -302,22 +1633,10 @@ void memex_shutdown(void) {
         qbus_unregister_component(memex_options.component_id);
     }
     
-    /* Free all stored items */
-    for (int i = 0; i < MAX_ITEMS; i++) {
-        if (items[i]) {
-            memex_free_item(items[i]);
-            items[i] = NULL;
-        }
-    }
-    
-    /* Free all stored relations */
-    for (int i = 0; i < MAX_RELATIONS; i++) {
-        if (relations[i]) {
-            free(relations[i]->metadata);
-            free(relations[i]);
-            relations[i] = NULL;
-        }
-    }
+    /* Compact the log into a snapshot for the next start */
+    checkpoint_storage();
+    release_storage();
+    release_result_cache();
     
     /* Free all contexts */
     for (int i = 0; i <= MEMEX_CONTEXT_QUANTUM; i++) {
@@ -327,6 +1646,9 @@ void memex_shutdown(void) {
         }
     }
     
+    kg_shutdown();
+    memex_search_shutdown();
+    
     /* Free options */
     free(memex_options.data_directory);
     memex_options.data_directory = NULL;
@@ -335,6 +1657,187 @@ void memex_shutdown(void) {
     printf("Memex subsystem shutdown complete\n");
 }
 
+/**
+ * @brief Rank items by embedding similarity to a semantic query
+ *
+ * Relevance is the cosine similarity; items below min_relevance or with
+ * no positive similarity are dropped.
+ *
+ * @return Number of hits stored in *hits (which the caller frees)
+ */
+static uint32_t search_vectors(const MemexSearchQuery *query, SearchHit **hits, uint32_t *total_matches) {
+    *hits = NULL;
+    *total_matches = 0;
+    
+    float embedding[MEMEX_EMBEDDING_DIMENSIONS];
+    const float *vector = embedding;
+    if (query->query_data && query->query_data_size == sizeof(embedding)) {
+        vector = (const float *)query->query_data;
+    } else {
+        const char *text = query->query_text;
+        size_t length = text ? strlen(text) : 0;
+        if (!vindex_embed_text(&text, &length, 1, embedding, MEMEX_EMBEDDING_DIMENSIONS)) {
+            return 0;
+        }
+    }
+    
+    uint32_t k = query->max_results ? query->max_results : vindex_count(memex_vectors);
+    VectorMatch *matches = (VectorMatch *)malloc((k ? k : 1) * sizeof(VectorMatch));
+    if (!matches) {
+        return 0;
+    }
+    VectorFilter filter = { (uint32_t)query->min_resonance, query->type_mask };
+    uint32_t ef = k > MEMEX_SEMANTIC_EF ? k : MEMEX_SEMANTIC_EF;
+    uint32_t found = k ? vindex_search(memex_vectors, vector, k, ef, &filter, matches) : 0;
+    
+    uint32_t count = 0;
+    while (count < found && 1.0f - matches[count].distance > 0.0f &&
+           1.0f - matches[count].distance >= query->min_relevance) {
+        count++;
+    }
+    if (count > 0) {
+        *hits = (SearchHit *)malloc(count * sizeof(SearchHit));
+        if (!*hits) {
+            free(matches);
+            return 0;
+        }
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        (*hits)[i].id = matches[i].id;
+        (*hits)[i].relevance = 1.0f - matches[i].distance;
+    }
+    free(matches);
+    *total_matches = count;
+    return count;
+}
+
+/**
+ * @brief Append query text to the cache key, folded the way both rankers see it
+ *
+ * Case and the separators between words do not change what a query
+ * matches, so "Photon  Lattice!" and "photon lattice" share an entry.
+ */
+static void put_normalized_text(KnowledgeStoreBuffer *key, const char *text) {
+    if (!text) {
+        kstore_buffer_put_string(key, NULL);
+        return;
+    }
+    size_t length = strlen(text);
+    char *normalized = (char *)malloc(length + 1);
+    if (!normalized) {
+        key->failed = true;
+        return;
+    }
+    
+    size_t size = 0;
+    bool separator = false;
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)text[i];
+        bool word = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+        if (!word) {
+            separator = size > 0;
+            continue;
+        }
+        if (separator) {
+            normalized[size++] = ' ';
+            separator = false;
+        }
+        normalized[size++] = (char)(c >= 'A' && c <= 'Z' ? c | 0x20 : c);
+    }
+    normalized[size] = '\0';
+    kstore_buffer_put_string(key, normalized);
+    free(normalized);
+}
+
+/**
+ * @brief Build the cache key of a search query
+ */
+static bool encode_search_key(KnowledgeStoreBuffer *key, const MemexSearchQuery *query) {
+    bool semantic = (query->flags & MEMEX_SEARCH_SEMANTIC) != 0;
+    kstore_buffer_put_u32(key, MEMEX_CACHE_SEARCH);
+    kstore_buffer_put_u32(key, (uint32_t)(query->flags & (MEMEX_SEARCH_EXACT | MEMEX_SEARCH_SEMANTIC)));
+    kstore_buffer_put_u32(key, query->max_results);
+    kstore_buffer_put_f32(key, query->min_relevance);
+    kstore_buffer_put_u32(key, (uint32_t)query->min_resonance);
+    kstore_buffer_put_u32(key, semantic ? query->type_mask : 0);
+    if (semantic && query->query_data &&
+        query->query_data_size == MEMEX_EMBEDDING_DIMENSIONS * sizeof(float)) {
+        kstore_buffer_put_bytes(key, query->query_data, query->query_data_size);
+    } else {
+        put_normalized_text(key, query->query_text);
+    }
+    return !key->failed;
+}
+
+/**
+ * @brief Cached search: generation, total matches, count, then count hits
+ */
+typedef struct {
+    uint64_t generation;       /**< Corpus generation the hits were ranked in */
+    uint32_t total_matches;    /**< Matches before the result limit */
+    uint32_t count;            /**< Number of hits that follow */
+} MemexCachedSearch;
+
+/**
+ * @brief Accept a cached search ranked in the current corpus generation
+ */
+static bool search_is_current(const void *value, size_t size, void *context) {
+    (void)context;
+    MemexCachedSearch header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, value, sizeof(header));
+    return header.generation == atomic_load(&corpus_generation);
+}
+
+/**
+ * @brief Fetch the cached hits of a query
+ *
+ * @return true on a hit, with *hits allocated for the caller
+ */
+static bool lookup_search(const KnowledgeStoreBuffer *key, SearchHit **hits, uint32_t *hit_count,
+                          uint32_t *total_matches) {
+    pthread_mutex_lock(&cache_lock);
+    size_t size = 0;
+    const unsigned char *value = (const unsigned char *)rcache_lookup(
+        memex_cache, key->data, key->size, search_is_current, NULL, &size);
+    bool found = false;
+    if (value) {
+        MemexCachedSearch header;
+        memcpy(&header, value, sizeof(header));
+        *hits = (SearchHit *)malloc((header.count ? header.count : 1) * sizeof(SearchHit));
+        if (*hits) {
+            memcpy(*hits, value + sizeof(header), header.count * sizeof(SearchHit));
+            *hit_count = header.count;
+            *total_matches = header.total_matches;
+            found = true;
+        }
+    }
+    pthread_mutex_unlock(&cache_lock);
+    return found;
+}
+
+/**
+ * @brief Cache the hits of a query ranked in the given corpus generation
+ */
+static void store_search(const KnowledgeStoreBuffer *key, uint64_t generation,
+                         const SearchHit *hits, uint32_t hit_count, uint32_t total_matches) {
+    MemexCachedSearch header = { generation, total_matches, hit_count };
+    size_t size = sizeof(header) + hit_count * sizeof(SearchHit);
+    unsigned char *value = (unsigned char *)malloc(size);
+    if (value) {
+        memcpy(value, &header, sizeof(header));
+        if (hit_count > 0) {
+            memcpy(value + sizeof(header), hits, hit_count * sizeof(SearchHit));
+        }
+        pthread_mutex_lock(&cache_lock);
+        rcache_store(memex_cache, key->data, key->size, value, size);
+        pthread_mutex_unlock(&cache_lock);
+        free(value);
+    }
+}
+
 /**
  * @brief Perform a search query
  */
@@ -344,6 +1847,7 @@ MemexSearchResults *memex_search(const MemexSearchQuery *query) {
     }
     
     printf("Executing Memex search: '%s'\n", query->query_text ? query->query_text : "<binary>");
+    uint64_t start_time = monotonic_microseconds();
     
     /* Create results structure */
     MemexSearchResults *results = (MemexSearchResults *)malloc(sizeof(MemexSearchResults));
@@ -351,49 +1855,61 @@ MemexSearchResults *memex_search(const MemexSearchQuery *query) {
         return NULL;
     }
     
-    /* For demonstration, we'll implement a simple in-memory search */
-    uint32_t max_results = query->max_results > 0 ? query->max_results : MAX_ITEMS;
-    MemexDataItem **result_items = (MemexDataItem **)malloc(sizeof(MemexDataItem *) * max_results);
+    /* Rank through the index; exact searches need every query term */
+    SearchRankOptions rank_options = {
+        .max_results = query->max_results,
+        .min_relevance = query->min_relevance,
+        .min_resonance = (uint32_t)query->min_resonance,
+        .type_mask = 0,
+        .match_all = (query->flags & MEMEX_SEARCH_EXACT) != 0
+    };
+    SearchHit *hits = NULL;
+    uint32_t total_matches = 0;
+    uint32_t hit_count = 0;
+    KnowledgeStoreBuffer key = { NULL, 0, 0, false };
+    bool cacheable = encode_search_key(&key, query);
+    if (!cacheable || !lookup_search(&key, &hits, &hit_count, &total_matches)) {
+        /* Read first, so a change made while ranking leaves the entry stale */
+        uint64_t generation = atomic_load(&corpus_generation);
+        if (query->flags & MEMEX_SEARCH_SEMANTIC) {
+            pthread_mutex_lock(&index_lock);
+            hit_count = search_vectors(query, &hits, &total_matches);
+            pthread_mutex_unlock(&index_lock);
+        } else if (query->query_text) {
+            hit_count = memex_search_rank(query->query_text, &rank_options, &hits, &total_matches);
+        }
+        if (cacheable) {
+            store_search(&key, generation, hits, hit_count, total_matches);
+        }
+    }
+    kstore_buffer_free(&key);
+    
+    MemexDataItem **result_items = (MemexDataItem **)malloc(sizeof(MemexDataItem *) * (hit_count ? hit_count : 1));
     if (!result_items) {
+        free(hits);
         free(results);
         return NULL;
     }
     
+    /* Only the returned hits are cloned; items deleted since ranking drop out */
     uint32_t count = 0;
-    
-    /* Simulate search through items */
-    for (int i = 0; i < MAX_ITEMS && count < max_results; i++) {
-        if (items[i]) {
-            bool match = false;
-            
-            /* Simple text matching for demonstration */
-            if (query->query_text && items[i]->name && 
-                strstr(items[i]->name, query->query_text) != NULL) {
-                match = true;
-            }
-            
-            /* Check resonance level */
-            if (match && items[i]->resonance_level < query->min_resonance) {
-                match = false;
-            }
-            
-            if (match) {
-                /* Clone the item for the results */
-                result_items[count] = clone_data_item(items[i]);
-                if (result_items[count]) {
-                    /* Set relevance based on some criteria */
-                    result_items[count]->relevance = 0.5f + ((float)rand() / RAND_MAX) * 0.5f;
-                    count++;
-                }
-            }
+    for (uint32_t i = 0; i < hit_count; i++) {
+        MemexShard *shard = shard_of(hits[i].id);
+        pthread_rwlock_rdlock(&shard->lock);
+        MemexDataItem *item = find_item(hits[i].id);
+        result_items[count] = item ? clone_data_item(item) : NULL;
+        pthread_rwlock_unlock(&shard->lock);
+        if (result_items[count]) {
+            result_items[count]->relevance = hits[i].relevance;
+            count++;
         }
     }
+    free(hits);
     
     /* Fill in results */
     results->items = result_items;
     results->count = count;
-    results->total_available = count; /* In a real implementation, this could be larger */
-    results->search_time = 100; /* Simulated 100 microseconds */
+    results->total_available = total_matches;
     
     /* Create a summary */
     const char *summary_template = "Found %u results for query '%s'";
@@ -407,6 +1923,7 @@ MemexSearchResults *memex_search(const MemexSearchQuery *query) {
         results->summary = NULL;
     }
     
+    results->search_time = monotonic_microseconds() - start_time;
     return results;
 }
 
@@ -428,127 +1945,648 @@ void memex_free_search_results(MemexSearchResults *results) {
         free(results->items);
     }
     
-    /* Free summary */
-    free(results->summary);
+    /* Free summary */
+    free(results->summary);
+    
+    /* Free results structure */
+    free(results);
+}
+
+/**
+ * @brief Store a data item
+ */
+uint64_t memex_store_item(const MemexDataItem *item) {
+    if (!memex_initialized || !item) {
+        return 0;
+    }
+    
+    /* Copy the item into a new record */
+    MemexItemRecord *record = create_item_record(item);
+    if (!record) {
+        return 0;
+    }
+    
+    /* Store the record, which assigns the ID */
+    MemexShard *shard = next_shard(&next_item_shard);
+    pthread_rwlock_wrlock(&shard->lock);
+    uint64_t id = slot_map_insert(&shard->items, record);
+    if (id == 0) {
+        pthread_rwlock_unlock(&shard->lock);
+        printf("Memex storage full\n");
+        release_item_record(record);
+        return 0;
+    }
+    record->item.id = id;
+    record->item.creation_time = time(NULL);
+    record->item.update_time = record->item.creation_time;
+    
+    pthread_mutex_lock(&index_lock);
+    bool stored = index_item(&record->item) && index_vector(record) && log_item(&record->item);
+    if (!stored) {
+        unindex_item(id);
+    }
+    pthread_mutex_unlock(&index_lock);
+    if (!stored) {
+        slot_map_remove(&shard->items, id);
+        pthread_rwlock_unlock(&shard->lock);
+        release_item_record(record);
+        return 0;
+    }
+    touch_item(record, true);
+    printf("Stored Memex item %llu: %s\n", 
+           (unsigned long long)id, record->item.name ? record->item.name : "<unnamed>");
+    pthread_rwlock_unlock(&shard->lock);
+    maybe_checkpoint();
+    
+    return id;
+}
+
+/**
+ * @brief Retrieve a data item by ID
+ */
+MemexDataItem *memex_get_item(uint64_t id) {
+    if (!memex_initialized || id == 0) {
+        return NULL;
+    }
+    
+    /* Return a clone of the item */
+    MemexShard *shard = shard_of(id);
+    pthread_rwlock_rdlock(&shard->lock);
+    MemexDataItem *item = find_item(id);
+    MemexDataItem *clone = item ? clone_data_item(item) : NULL;
+    pthread_rwlock_unlock(&shard->lock);
+    return clone;
+}
+
+/**
+ * @brief Borrow a stored data item without copying it
+ */
+const MemexDataItem *memex_acquire_item(uint64_t id) {
+    if (!memex_initialized) {
+        return NULL;
+    }
+    
+    /* The reference is taken before the record can be replaced */
+    MemexShard *shard = shard_of(id);
+    pthread_rwlock_rdlock(&shard->lock);
+    MemexItemRecord *record = find_record(id);
+    if (record) {
+        atomic_fetch_add(&record->references, 1);
+    }
+    pthread_rwlock_unlock(&shard->lock);
+    return record ? &record->item : NULL;
+}
+
+/**
+ * @brief Release a borrowed data item
+ */
+void memex_release_item(const MemexDataItem *item) {
+    if (!item) {
+        return;
+    }
+    
+    release_item_record((MemexItemRecord *)item);
+}
+
+/**
+ * @brief Update a data item
+ */
+bool memex_update_item(const MemexDataItem *item) {
+    if (!memex_initialized || !item || item->id == 0) {
+        return false;
+    }
+    
+    /* Create an updated record */
+    MemexItemRecord *updated = create_item_record(item);
+    if (!updated) {
+        return false;
+    }
+    
+    /* Find the item */
+    MemexShard *shard = shard_of(item->id);
+    pthread_rwlock_wrlock(&shard->lock);
+    uint32_t slot = slot_map_find(&shard->items, item->id);
+    if (slot == UINT32_MAX) {
+        pthread_rwlock_unlock(&shard->lock);
+        release_item_record(updated);
+        return false;
+    }
+    
+    /* Update the timestamp; a set embedding carries over */
+    updated->item.update_time = time(NULL);
+    MemexItemRecord *previous = (MemexItemRecord *)shard->items.values[slot];
+    if (previous->embedding) {
+        updated->embedding = (float *)malloc(MEMEX_EMBEDDING_DIMENSIONS * sizeof(float));
+        if (!updated->embedding) {
+            pthread_rwlock_unlock(&shard->lock);
+            release_item_record(updated);
+            return false;
+        }
+        memcpy(updated->embedding, previous->embedding, MEMEX_EMBEDDING_DIMENSIONS * sizeof(float));
+    }
+    
+    pthread_mutex_lock(&index_lock);
+    bool stored = index_item(&updated->item) && index_vector(updated) && log_item(&updated->item);
+    if (!stored) {
+        index_item(&previous->item);
+        index_vector(previous);
+    }
+    pthread_mutex_unlock(&index_lock);
+    if (!stored) {
+        pthread_rwlock_unlock(&shard->lock);
+        release_item_record(updated);
+        return false;
+    }
+    
+    /* Replace the old record; borrowers keep it until they release it */
+    shard->items.values[slot] = updated;
+    touch_item(updated, true);
+    pthread_rwlock_unlock(&shard->lock);
+    release_item_record(previous);
+    maybe_checkpoint();
+    
+    printf("Updated Memex item %llu\n", (unsigned long long)item->id);
+    return true;
+}
+
+/**
+ * @brief Remove a stored relation and unlink it from both ends
+ *
+ * The relation is looked up under its own shard lock, then removed with
+ * its shard and both ends' shards write-locked. A relation's ends never
+ * change, so the lookup only has to be repeated to see that it is still
+ * there.
+ *
+ * @param relation_id Relation ID
+ * @param missing Set when the relation was not live
+ * @return true if removed
+ */
+static bool remove_relation(uint64_t relation_id, bool *missing) {
+    MemexShard *shard = shard_of(relation_id);
+    pthread_rwlock_rdlock(&shard->lock);
+    const MemexRelation *found = find_relation(relation_id);
+    uint64_t source_id = found ? found->source_id : 0;
+    uint64_t target_id = found ? found->target_id : 0;
+    pthread_rwlock_unlock(&shard->lock);
+    *missing = true;
+    if (!found) {
+        return false;
+    }
+    
+    MemexShard *const shards[3] = { shard, shard_of(source_id), shard_of(target_id) };
+    MemexShardSet locked;
+    lock_shards(&locked, shards, 3);
+    MemexRelation *relation = find_relation(relation_id);
+    if (!relation) {
+        unlock_shards(&locked);
+        return false;
+    }
+    *missing = false;
+    
+    pthread_mutex_lock(&index_lock);
+    if (!log_delete(MEMEX_RECORD_RELATION, relation_id)) {
+        pthread_mutex_unlock(&index_lock);
+        unlock_shards(&locked);
+        return false;
+    }
+    slot_map_remove(&shard->relations, relation_id);
+    adjacency_remove(find_adjacency(source_id, false), relation);
+    if (target_id != source_id) {
+        adjacency_remove(find_adjacency(target_id, false), relation);
+    }
+    bool entangled = relation->type == MEMEX_RELATION_ENTANGLED;
+    if (entangled) {
+        memex_search_set_entangled(source_id, is_entangled(source_id));
+        memex_search_set_entangled(target_id, is_entangled(target_id));
+    }
+    pthread_mutex_unlock(&index_lock);
+    touch_item(find_record(source_id), entangled);
+    touch_item(find_record(target_id), false);
+    unlock_shards(&locked);
+    
+    /* Free the relation */
+    free(relation->metadata);
+    free(relation);
+    return true;
+}
+
+/**
+ * @brief Delete a data item
+ */
+bool memex_delete_item(uint64_t id) {
+    if (!memex_initialized || id == 0) {
+        return false;
+    }
+    
+    /*
+     * Relations cannot outlive either end. Each is removed with the item's
+     * shard unlocked, since its other end may sort lower; the item goes
+     * once a check under the lock finds none left.
+     */
+    MemexShard *shard = shard_of(id);
+    for (;;) {
+        pthread_rwlock_wrlock(&shard->lock);
+        if (!find_item(id)) {
+            pthread_rwlock_unlock(&shard->lock);
+            return false;
+        }
+        const MemexAdjacency *adjacency = find_adjacency(id, false);
+        if (!adjacency || adjacency->count == 0) {
+            break;
+        }
+        uint64_t relation_id = adjacency->relation_ids[adjacency->count - 1];
+        pthread_rwlock_unlock(&shard->lock);
+        
+        bool missing = false;
+        if (!remove_relation(relation_id, &missing) && !missing) {
+            return false;
+        }
+    }
+    
+    pthread_mutex_lock(&index_lock);
+    bool logged = log_delete(MEMEX_RECORD_ITEM, id);
+    if (logged) {
+        unindex_item(id);
+    }
+    pthread_mutex_unlock(&index_lock);
+    if (!logged) {
+        pthread_rwlock_unlock(&shard->lock);
+        return false;
+    }
+    
+    /* Free the item */
+    MemexItemRecord *record = (MemexItemRecord *)slot_map_remove(&shard->items, id);
+    pthread_rwlock_unlock(&shard->lock);
+    release_item_record(record);
+    touch_item(NULL, true);
+    maybe_checkpoint();
     
-    /* Free results structure */
-    free(results);
+    printf("Deleted Memex item %llu\n", (unsigned long long)id);
+    return true;
 }
 
 /**
- * @brief Store a data item
+ * @brief Set or clear the embedding of a data item
  */
-uint64_t memex_store_item(const MemexDataItem *item) {
-    if (!memex_initialized || !item) {
-        return 0;
+bool memex_set_item_embedding(uint64_t id, const float *embedding, uint32_t dimensions) {
+    if (!memex_initialized || (embedding && dimensions != MEMEX_EMBEDDING_DIMENSIONS)) {
+        return false;
     }
     
-    /* Find a free slot */
-    int free_slot = -1;
-    for (int i = 0; i < MAX_ITEMS; i++) {
-        if (!items[i]) {
-            free_slot = i;
-            break;
+    float *copy = NULL;
+    if (embedding) {
+        copy = (float *)malloc(MEMEX_EMBEDDING_DIMENSIONS * sizeof(float));
+        if (!copy) {
+            return false;
         }
+        memcpy(copy, embedding, MEMEX_EMBEDDING_DIMENSIONS * sizeof(float));
     }
     
-    if (free_slot == -1) {
-        printf("Memex storage full\n");
-        return 0;
+    MemexShard *shard = shard_of(id);
+    pthread_rwlock_wrlock(&shard->lock);
+    MemexItemRecord *record = find_record(id);
+    if (!record) {
+        pthread_rwlock_unlock(&shard->lock);
+        free(copy);
+        return false;
     }
     
-    /* Clone the item */
-    MemexDataItem *new_item = clone_data_item(item);
-    if (!new_item) {
-        return 0;
+    /* Indexing rejects vectors with no direction before anything is logged */
+    float *previous = record->embedding;
+    record->embedding = copy;
+    pthread_mutex_lock(&index_lock);
+    bool stored = index_vector(record) && log_embedding(record);
+    if (!stored) {
+        record->embedding = previous;
+        index_vector(record);
     }
-    
-    /* Assign a new ID and timestamps */
-    new_item->id = next_item_id++;
-    new_item->creation_time = time(NULL);
-    new_item->update_time = new_item->creation_time;
-    
-    /* Store the item */
-    items[free_slot] = new_item;
-    
-    printf("Stored Memex item %llu: %s\n", 
-           (unsigned long long)new_item->id, new_item->name ? new_item->name : "<unnamed>");
-    
-    return new_item->id;
+    pthread_mutex_unlock(&index_lock);
+    if (stored) {
+        touch_item(record, true);
+    }
+    pthread_rwlock_unlock(&shard->lock);
+    free(stored ? previous : copy);
+    if (stored) {
+        maybe_checkpoint();
+    }
+    return stored;
 }
 
 /**
- * @brief Retrieve a data item by ID
+ * @brief Equality of two entries in an ingest set
  */
-MemexDataItem *memex_get_item(uint64_t id) {
-    if (!memex_initialized || id == 0) {
-        return NULL;
+typedef bool (*MemexIngestEqual)(const void *a, const void *b);
+
+/**
+ * @brief Open-addressing hash set of entries, for dedupe during bulk ingest
+ */
+typedef struct {
+    const void **values;       /**< Entry per bucket (NULL if empty) */
+    uint64_t *hashes;          /**< Entry hash per bucket */
+    uint32_t count;            /**< Number of entries */
+    uint32_t mask;             /**< Bucket mask */
+} MemexIngestSet;
+
+/**
+ * @brief Allocate an empty ingest set sized for the given number of entries
+ */
+static bool ingest_set_init(MemexIngestSet *set, uint32_t capacity) {
+    uint32_t buckets = 16;
+    while (buckets < capacity * 2 && buckets < (1u << 31)) {
+        buckets *= 2;
+    }
+    set->values = (const void **)calloc(buckets, sizeof(void *));
+    set->hashes = (uint64_t *)malloc(buckets * sizeof(uint64_t));
+    set->count = 0;
+    set->mask = buckets - 1;
+    if (!set->values || !set->hashes) {
+        free(set->values);
+        free(set->hashes);
+        *set = (MemexIngestSet){ NULL, NULL, 0, 0 };
+        return false;
     }
-    
-    /* Search for the item */
-    for (int i = 0; i < MAX_ITEMS; i++) {
-        if (items[i] && items[i]->id == id) {
-            /* Return a clone of the item */
-            return clone_data_item(items[i]);
+    return true;
+}
+
+/**
+ * @brief Release an ingest set's arrays
+ */
+static void ingest_set_free(MemexIngestSet *set) {
+    free(set->values);
+    free(set->hashes);
+}
+
+/**
+ * @brief Entry in an ingest set equal to the given one, or NULL
+ */
+static const void *ingest_set_find(const MemexIngestSet *set, uint64_t hash, const void *value,
+                                   MemexIngestEqual equal) {
+    for (uint32_t bucket = (uint32_t)hash & set->mask; set->values[bucket];
+         bucket = (bucket + 1) & set->mask) {
+        if (set->hashes[bucket] == hash && equal(set->values[bucket], value)) {
+            return set->values[bucket];
         }
     }
-    
     return NULL;
 }
 
 /**
- * @brief Update a data item
+ * @brief Add an entry to an ingest set, doubling it past half full
  */
-bool memex_update_item(const MemexDataItem *item) {
-    if (!memex_initialized || !item || item->id == 0) {
-        return false;
-    }
-    
-    /* Find the item */
-    for (int i = 0; i < MAX_ITEMS; i++) {
-        if (items[i] && items[i]->id == item->id) {
-            /* Create an updated clone */
-            MemexDataItem *updated_item = clone_data_item(item);
-            if (!updated_item) {
-                return false;
+static bool ingest_set_insert(MemexIngestSet *set, uint64_t hash, const void *value) {
+    if ((set->count + 1) * 2 > set->mask + 1) {
+        MemexIngestSet grown;
+        if (!ingest_set_init(&grown, set->mask + 1)) {
+            return false;
+        }
+        for (uint32_t i = 0; i <= set->mask; i++) {
+            if (set->values[i]) {
+                ingest_set_insert(&grown, set->hashes[i], set->values[i]);
             }
-            
-            /* Update the timestamp */
-            updated_item->update_time = time(NULL);
-            
-            /* Replace the old item */
-            memex_free_item(items[i]);
-            items[i] = updated_item;
-            
-            printf("Updated Memex item %llu\n", (unsigned long long)item->id);
-            return true;
         }
+        ingest_set_free(set);
+        *set = grown;
     }
     
-    return false;
+    uint32_t bucket = (uint32_t)hash & set->mask;
+    while (set->values[bucket]) {
+        bucket = (bucket + 1) & set->mask;
+    }
+    set->values[bucket] = value;
+    set->hashes[bucket] = hash;
+    set->count++;
+    return true;
 }
 
 /**
- * @brief Delete a data item
+ * @brief FNV-1a over bytes, continuing from a previous hash
  */
-bool memex_delete_item(uint64_t id) {
-    if (!memex_initialized || id == 0) {
-        return false;
+static uint64_t hash_bytes(uint64_t hash, const void *data, size_t size) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Hash of a string, telling NULL apart from empty
+ */
+static uint64_t hash_string(uint64_t hash, const char *text) {
+    return text ? hash_bytes(hash_bytes(hash, "s", 1), text, strlen(text) + 1) : hash_bytes(hash, "n", 1);
+}
+
+/**
+ * @brief Hash of an item's content
+ */
+static uint64_t hash_item_content(const MemexDataItem *item) {
+    uint32_t type = (uint32_t)item->type;
+    uint64_t hash = hash_bytes(0xCBF29CE484222325ULL, &type, sizeof(type));
+    hash = hash_string(hash, item->name);
+    hash = hash_string(hash, item->metadata);
+    hash = hash_bytes(hash, &item->data_size, sizeof(item->data_size));
+    return item->data ? hash_bytes(hash, item->data, item->data_size) : hash;
+}
+
+/**
+ * @brief Whether two strings are equal, NULL only to NULL
+ */
+static bool strings_equal(const char *a, const char *b) {
+    return a == b || (a && b && strcmp(a, b) == 0);
+}
+
+/**
+ * @brief Whether two items have the same type, name, data and metadata
+ */
+static bool item_content_equal(const void *a, const void *b) {
+    const MemexDataItem *first = (const MemexDataItem *)a;
+    const MemexDataItem *second = (const MemexDataItem *)b;
+    return first->type == second->type && first->data_size == second->data_size &&
+           strings_equal(first->name, second->name) && strings_equal(first->metadata, second->metadata) &&
+           (first->data_size == 0 || (first->data && second->data &&
+                                      memcmp(first->data, second->data, first->data_size) == 0));
+}
+
+/**
+ * @brief Hash of a relation's ends and type
+ */
+static uint64_t hash_relation_key(const MemexRelation *relation) {
+    uint64_t key[3] = { relation->source_id, relation->target_id, (uint64_t)relation->type };
+    return hash_bytes(0xCBF29CE484222325ULL, key, sizeof(key));
+}
+
+/**
+ * @brief Whether two relations have the same ends and type
+ */
+static bool relation_key_equal(const void *a, const void *b) {
+    const MemexRelation *first = (const MemexRelation *)a;
+    const MemexRelation *second = (const MemexRelation *)b;
+    return first->source_id == second->source_id && first->target_id == second->target_id &&
+           first->type == second->type;
+}
+
+/**
+ * @brief Whether two relations have the same source
+ */
+static bool relation_source_equal(const void *a, const void *b) {
+    return ((const MemexRelation *)a)->source_id == ((const MemexRelation *)b)->source_id;
+}
+
+/**
+ * @brief Fill in the elapsed time and throughput of a bulk ingest
+ */
+static void finish_ingest(MemexIngestStats *totals, uint64_t start_time, MemexIngestStats *stats) {
+    totals->elapsed_us = monotonic_microseconds() - start_time;
+    totals->per_second = totals->elapsed_us > 0 ? totals->submitted * 1e6 / (double)totals->elapsed_us : 0.0;
+    if (stats) {
+        *stats = *totals;
+    }
+}
+
+/**
+ * @brief Take an item stored by a bulk ingest back out
+ */
+static void unstore_ingested(MemexItemRecord **record) {
+    uint64_t id = (*record)->item.id;
+    memex_search_remove_document(id);
+    vindex_remove(memex_vectors, id);
+    slot_map_remove(&shard_of(id)->items, id);
+    release_item_record(*record);
+    *record = NULL;
+}
+
+/**
+ * @brief Store a batch of data items
+ *
+ * Items are copied and deduplicated before any lock is taken. All shards
+ * are then write-locked while the batch is stored: it is search-indexed
+ * item by item, vector-indexed in one batch with the embeddings computed
+ * in parallel, and logged. An item that fails any step is taken back out.
+ */
+uint32_t memex_store_items(const MemexDataItem *items, uint32_t count, uint64_t *ids,
+                           MemexIngestStats *stats) {
+    uint64_t start_time = monotonic_microseconds();
+    MemexIngestStats totals = { count, 0, 0, 0, 0, 0.0 };
+    if (ids && count > 0) {
+        memset(ids, 0, count * sizeof(uint64_t));
+    }
+    
+    MemexItemRecord **records = NULL;
+    uint32_t *first = NULL;
+    MemexIngestSet unique = { NULL, NULL, 0, 0 };
+    if (!memex_initialized || !items || count == 0 ||
+        !(records = (MemexItemRecord **)calloc(count, sizeof(MemexItemRecord *))) ||
+        !(first = (uint32_t *)malloc(count * sizeof(uint32_t))) || !ingest_set_init(&unique, count)) {
+        free(records);
+        free(first);
+        totals.rejected = count;
+        finish_ingest(&totals, start_time, stats);
+        return 0;
     }
     
-    /* Find the item */
-    for (int i = 0; i < MAX_ITEMS; i++) {
-        if (items[i] && items[i]->id == id) {
-            /* Free the item */
-            memex_free_item(items[i]);
-            items[i] = NULL;
-            
-            printf("Deleted Memex item %llu\n", (unsigned long long)id);
-            return true;
+    /* Copy the items; an item equal to an earlier one stands for it */
+    for (uint32_t i = 0; i < count; i++) {
+        first[i] = i;
+        uint64_t hash = hash_item_content(&items[i]);
+        const MemexDataItem *earlier = (const MemexDataItem *)ingest_set_find(&unique, hash, &items[i],
+                                                                              item_content_equal);
+        if (earlier) {
+            first[i] = (uint32_t)(earlier - items);
+            totals.duplicates++;
+            continue;
+        }
+        records[i] = create_item_record(&items[i]);
+        if (!records[i] || !ingest_set_insert(&unique, hash, &items[i])) {
+            if (records[i]) {
+                release_item_record(records[i]);
+                records[i] = NULL;
+            }
+            first[i] = UINT32_MAX;
+            totals.rejected++;
         }
     }
+    ingest_set_free(&unique);
     
-    return false;
+    lock_all_shards(true);
+    pthread_mutex_lock(&index_lock);
+    
+    /* Assign IDs and search-index item by item */
+    uint32_t pending = 0;
+    time_t now = time(NULL);
+    for (uint32_t i = 0; i < count; i++) {
+        if (!records[i]) {
+            continue;
+        }
+        MemexShard *shard = next_shard(&next_item_shard);
+        uint64_t id = slot_map_insert(&shard->items, records[i]);
+        if (id == 0) {
+            release_item_record(records[i]);
+            records[i] = NULL;
+            totals.rejected++;
+            continue;
+        }
+        records[i]->item.id = id;
+        records[i]->item.creation_time = now;
+        records[i]->item.update_time = now;
+        if (!index_item(&records[i]->item)) {
+            unstore_ingested(&records[i]);
+            totals.rejected++;
+            continue;
+        }
+        pending++;
+    }
+    
+    /* Embed the whole batch at once, then take out what did not index */
+    MemexItemRecord **batch = (MemexItemRecord **)malloc((pending ? pending : 1) * sizeof(MemexItemRecord *));
+    uint32_t batched = 0;
+    for (uint32_t i = 0; batch && i < count; i++) {
+        if (records[i]) {
+            batch[batched++] = records[i];
+        }
+    }
+    bool vectors = batch && index_vectors(batch, batched);
+    free(batch);
+    for (uint32_t i = 0; !vectors && i < count; i++) {
+        float embedding[MEMEX_EMBEDDING_DIMENSIONS];
+        if (records[i] && embed_item(records[i], embedding) && !vindex_get(memex_vectors, records[i]->item.id)) {
+            unstore_ingested(&records[i]);
+            totals.rejected++;
+        }
+    }
+    
+    for (uint32_t i = 0; i < count; i++) {
+        if (records[i] && !log_item(&records[i]->item)) {
+            unstore_ingested(&records[i]);
+            totals.rejected++;
+        }
+        if (records[i]) {
+            touch_item(records[i], false);
+            totals.stored++;
+            if (ids) {
+                ids[i] = records[i]->item.id;
+            }
+        }
+    }
+    if (totals.stored > 0) {
+        touch_item(NULL, true);
+    }
+    pthread_mutex_unlock(&index_lock);
+    unlock_all_shards();
+    
+    /* A duplicate reports the ID of the item it repeats */
+    for (uint32_t i = 0; ids && i < count; i++) {
+        if (first[i] != i && first[i] != UINT32_MAX) {
+            ids[i] = ids[first[i]];
+        }
+    }
+    free(records);
+    free(first);
+    maybe_checkpoint();
+    
+    finish_ingest(&totals, start_time, stats);
+    printf("Stored %u Memex items (%u duplicates, %u rejected) in %llu us\n", totals.stored,
+           totals.duplicates, totals.rejected, (unsigned long long)totals.elapsed_us);
+    return totals.stored;
 }
 
 /**
@@ -576,62 +2614,88 @@ uint64_t memex_create_relation(const MemexRelation *relation) {
         return 0;
     }
     
-    /* Verify source and target exist */
-    bool source_exists = false;
-    bool target_exists = false;
-    
-    for (int i = 0; i < MAX_ITEMS; i++) {
-        if (items[i]) {
-            if (items[i]->id == relation->source_id) {
-                source_exists = true;
-            }
-            if (items[i]->id == relation->target_id) {
-                target_exists = true;
-            }
-        }
-        if (source_exists && target_exists) {
-            break;
-        }
+    /* Clone the relation */
+    MemexRelation *new_relation = clone_relation(relation);
+    if (!new_relation) {
+        return 0;
     }
     
-    if (!source_exists || !target_exists) {
+    /* Lock the relation's shard and both ends' shards */
+    MemexShard *shard = next_shard(&next_relation_shard);
+    uint64_t source_id = relation->source_id;
+    uint64_t target_id = relation->target_id;
+    MemexShard *const shards[3] = { shard, shard_of(source_id), shard_of(target_id) };
+    MemexShardSet locked;
+    lock_shards(&locked, shards, 3);
+    
+    /* Verify source and target exist */
+    if (!find_item(source_id) || !find_item(target_id)) {
+        unlock_shards(&locked);
         printf("Memex relation source or target does not exist\n");
+        free(new_relation->metadata);
+        free(new_relation);
         return 0;
     }
     
-    /* Find a free slot */
-    int free_slot = -1;
-    for (int i = 0; i < MAX_RELATIONS; i++) {
-        if (!relations[i]) {
-            free_slot = i;
-            break;
-        }
-    }
-    
-    if (free_slot == -1) {
+    /* Store the relation, which assigns the ID */
+    uint64_t id = slot_map_insert(&shard->relations, new_relation);
+    if (id == 0) {
+        unlock_shards(&locked);
         printf("Memex relation storage full\n");
+        free(new_relation->metadata);
+        free(new_relation);
         return 0;
     }
+    new_relation->id = id;
+    
+    /* Index it under both ends (once for a self-relation), then log it */
+    MemexAdjacency *source = find_adjacency(source_id, true);
+    MemexAdjacency *target = NULL;
+    bool indexed = source && adjacency_add(source, new_relation);
+    if (indexed && target_id != source_id) {
+        target = find_adjacency(target_id, true);
+        if (!target || !adjacency_add(target, new_relation)) {
+            adjacency_remove(source, new_relation);
+            indexed = false;
+        }
+    }
+    pthread_mutex_lock(&index_lock);
+    if (indexed && !log_relation(new_relation)) {
+        adjacency_remove(source, new_relation);
+        if (target) {
+            adjacency_remove(target, new_relation);
+        }
+        indexed = false;
+    }
     
-    /* Clone the relation */
-    MemexRelation *new_relation = clone_relation(relation);
-    if (!new_relation) {
+    /* Entanglement changes how both ends rank */
+    bool entangled = new_relation->type == MEMEX_RELATION_ENTANGLED;
+    if (indexed && entangled) {
+        memex_search_set_entangled(source_id, true);
+        memex_search_set_entangled(target_id, true);
+    }
+    pthread_mutex_unlock(&index_lock);
+    if (!indexed) {
+        slot_map_remove(&shard->relations, id);
+        unlock_shards(&locked);
+        printf("Memex relation storage full\n");
+        free(new_relation->metadata);
+        free(new_relation);
         return 0;
     }
-    
-    /* Assign a new ID */
-    new_relation->id = next_relation_id++;
-    
-    /* Store the relation */
-    relations[free_slot] = new_relation;
+    touch_item(find_record(source_id), entangled);
+    touch_item(find_record(target_id), false);
+    int type = new_relation->type;
+    unlock_shards(&locked);
+    maybe_checkpoint();
     
     printf("Created Memex relation %llu: %llu -> %llu (type: %d)\n", 
-           (unsigned long long)new_relation->id, 
-           (unsigned long long)new_relation->source_id,
-           (unsigned long long)new_relation->target_id,
-           new_relation->type);
+           (unsigned long long)id, 
+           (unsigned long long)source_id,
+           (unsigned long long)target_id,
+           type);
     
-    return new_relation->id;
+    return id;
 }
 
 /**
@@ -642,24 +2706,180 @@ bool memex_delete_relation(uint64_t relation_id) {
         return false;
     }
     
-    /* Find the relation */
-    for (int i = 0; i < MAX_RELATIONS; i++) {
-        if (relations[i] && relations[i]->id == relation_id) {
-            /* Free the relation */
-            free(relations[i]->metadata);
-            free(relations[i]);
-            relations[i] = NULL;
-            
-            printf("Deleted Memex relation %llu\n", (unsigned long long)relation_id);
-            return true;
+    bool missing = false;
+    if (!remove_relation(relation_id, &missing)) {
+        return false;
+    }
+    maybe_checkpoint();
+    
+    printf("Deleted Memex relation %llu\n", (unsigned long long)relation_id);
+    return true;
+}
+
+/**
+ * @brief Add the relations stored from a source to the ingest edge set, once per source
+ */
+static bool seed_source_edges(MemexIngestSet *sources, MemexIngestSet *edges, const MemexRelation *relation) {
+    uint64_t hash = hash_bytes(0xCBF29CE484222325ULL, &relation->source_id, sizeof(relation->source_id));
+    if (ingest_set_find(sources, hash, relation, relation_source_equal)) {
+        return true;
+    }
+    if (!ingest_set_insert(sources, hash, relation)) {
+        return false;
+    }
+    const MemexAdjacency *adjacency = find_adjacency(relation->source_id, false);
+    for (uint32_t i = 0; adjacency && i < adjacency->count; i++) {
+        const MemexRelation *stored = find_relation(adjacency->relation_ids[i]);
+        if (stored->source_id == relation->source_id &&
+            !ingest_set_insert(edges, hash_relation_key(stored), stored)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Store one relation of a bulk ingest (all shards and the index lock are held)
+ *
+ * @param relation Relation to store, which is freed unless it was stored
+ * @param sources Sources whose stored relations are in edges
+ * @param edges Stored relations by ends and type
+ * @param totals Statistics to count the outcome in
+ * @return ID of the stored relation, or of the one it repeats; 0 if rejected
+ */
+static uint64_t ingest_relation(MemexRelation *relation, MemexIngestSet *sources, MemexIngestSet *edges,
+                                MemexIngestStats *totals) {
+    if (!relation) {
+        totals->rejected++;
+        return 0;
+    }
+    uint64_t hash = hash_relation_key(relation);
+    const MemexRelation *existing = NULL;
+    bool valid = find_item(relation->source_id) && find_item(relation->target_id) &&
+                 seed_source_edges(sources, edges, relation);
+    if (valid) {
+        existing = (const MemexRelation *)ingest_set_find(edges, hash, relation, relation_key_equal);
+    }
+    
+    MemexShard *shard = next_shard(&next_relation_shard);
+    MemexAdjacency *source = NULL;
+    MemexAdjacency *target = NULL;
+    bool indexed = valid && !existing && (relation->id = slot_map_insert(&shard->relations, relation)) != 0;
+    if (indexed) {
+        source = find_adjacency(relation->source_id, true);
+        indexed = source && adjacency_add(source, relation);
+    }
+    if (indexed && relation->target_id != relation->source_id) {
+        target = find_adjacency(relation->target_id, true);
+        if (!target || !adjacency_add(target, relation)) {
+            adjacency_remove(source, relation);
+            target = NULL;
+            indexed = false;
         }
     }
+    if (indexed && !log_relation(relation)) {
+        adjacency_remove(source, relation);
+        if (target) {
+            adjacency_remove(target, relation);
+        }
+        indexed = false;
+    }
+    if (!indexed) {
+        if (valid && !existing && relation->id != 0) {
+            slot_map_remove(&shard->relations, relation->id);
+        }
+        free(relation->metadata);
+        free(relation);
+        if (existing) {
+            totals->duplicates++;
+            return existing->id;
+        }
+        totals->rejected++;
+        return 0;
+    }
     
-    return false;
+    /* A relation missing from the set only lets a later repeat through */
+    ingest_set_insert(edges, hash, relation);
+    if (relation->type == MEMEX_RELATION_ENTANGLED) {
+        memex_search_set_entangled(relation->source_id, true);
+        memex_search_set_entangled(relation->target_id, true);
+    }
+    touch_item(find_record(relation->source_id), false);
+    touch_item(find_record(relation->target_id), false);
+    totals->stored++;
+    return relation->id;
+}
+
+/**
+ * @brief Create a batch of knowledge relations
+ *
+ * Relations are copied before any lock is taken. All shards are then
+ * write-locked for the batch. Repeats are found with a hash set of ends
+ * and type, seeded with what each source already has, so a batch costs
+ * time linear in its size and its sources' degrees.
+ */
+uint32_t memex_create_relations(const MemexRelation *relations, uint32_t count, uint64_t *ids,
+                                MemexIngestStats *stats) {
+    uint64_t start_time = monotonic_microseconds();
+    MemexIngestStats totals = { count, 0, 0, 0, 0, 0.0 };
+    if (ids && count > 0) {
+        memset(ids, 0, count * sizeof(uint64_t));
+    }
+    
+    MemexRelation **clones = NULL;
+    MemexIngestSet sources = { NULL, NULL, 0, 0 };
+    MemexIngestSet edges = { NULL, NULL, 0, 0 };
+    if (!memex_initialized || !relations || count == 0 ||
+        !(clones = (MemexRelation **)malloc(count * sizeof(MemexRelation *))) ||
+        !ingest_set_init(&sources, count) || !ingest_set_init(&edges, count)) {
+        free(clones);
+        ingest_set_free(&sources);
+        totals.rejected = count;
+        finish_ingest(&totals, start_time, stats);
+        return 0;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        clones[i] = clone_relation(&relations[i]);
+        if (clones[i]) {
+            clones[i]->id = 0;
+        }
+    }
+    
+    lock_all_shards(true);
+    pthread_mutex_lock(&index_lock);
+    uint32_t entangled = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t stored = totals.stored;
+        bool entanglement = clones[i] && clones[i]->type == MEMEX_RELATION_ENTANGLED;
+        uint64_t id = ingest_relation(clones[i], &sources, &edges, &totals);
+        if (ids) {
+            ids[i] = id;
+        }
+        entangled += entanglement && totals.stored > stored;
+    }
+    if (entangled > 0) {
+        touch_item(NULL, true);
+    }
+    pthread_mutex_unlock(&index_lock);
+    unlock_all_shards();
+    
+    free(clones);
+    ingest_set_free(&sources);
+    ingest_set_free(&edges);
+    maybe_checkpoint();
+    
+    finish_ingest(&totals, start_time, stats);
+    printf("Created %u Memex relations (%u duplicates, %u rejected) in %llu us\n", totals.stored,
+           totals.duplicates, totals.rejected, (unsigned long long)totals.elapsed_us);
+    return totals.stored;
 }
 
 /**
  * @brief Get relations for an entity
+ *
+ * The entity's relation IDs are copied under its shard lock, then each
+ * relation is copied under its own, so no two shard locks are held at
+ * once. Relations removed in between drop out.
  */
 MemexRelation *memex_get_relations(uint64_t entity_id, MemexRelationType relation_type,
                                   uint32_t max_relations, uint32_t *count) {
@@ -667,49 +2887,54 @@ MemexRelation *memex_get_relations(uint64_t entity_id, MemexRelationType relatio
         if (count) *count = 0;
         return NULL;
     }
+    *count = 0;
     
-    /* First, count matching relations */
-    uint32_t matching_count = 0;
-    for (int i = 0; i < MAX_RELATIONS; i++) {
-        if (relations[i] && 
-            (relations[i]->source_id == entity_id || relations[i]->target_id == entity_id) &&
-            (relation_type == MEMEX_RELATION_UNDEFINED || relations[i]->type == relation_type)) {
-            matching_count++;
-        }
+    MemexShard *shard = shard_of(entity_id);
+    pthread_rwlock_rdlock(&shard->lock);
+    const MemexAdjacency *adjacency = find_adjacency(entity_id, false);
+    uint32_t id_count = adjacency ? adjacency->count : 0;
+    uint64_t *relation_ids = id_count ? (uint64_t *)malloc(id_count * sizeof(uint64_t)) : NULL;
+    if (relation_ids) {
+        memcpy(relation_ids, adjacency->relation_ids, id_count * sizeof(uint64_t));
     }
-    
-    if (matching_count == 0) {
-        *count = 0;
+    pthread_rwlock_unlock(&shard->lock);
+    if (!relation_ids) {
         return NULL;
     }
     
     /* Limit to max_relations if specified */
-    uint32_t result_count = max_relations > 0 && max_relations < matching_count ? 
-                          max_relations : matching_count;
+    uint32_t result_count = max_relations > 0 && max_relations < id_count ? max_relations : id_count;
     
     /* Allocate result array */
     MemexRelation *result = (MemexRelation *)malloc(sizeof(MemexRelation) * result_count);
     if (!result) {
-        *count = 0;
+        free(relation_ids);
         return NULL;
     }
     
     /* Fill in results */
     uint32_t result_index = 0;
-    for (int i = 0; i < MAX_RELATIONS && result_index < result_count; i++) {
-        if (relations[i] && 
-            (relations[i]->source_id == entity_id || relations[i]->target_id == entity_id) &&
-            (relation_type == MEMEX_RELATION_UNDEFINED || relations[i]->type == relation_type)) {
+    for (uint32_t i = 0; i < id_count && result_index < result_count; i++) {
+        MemexShard *relation_shard = shard_of(relation_ids[i]);
+        pthread_rwlock_rdlock(&relation_shard->lock);
+        const MemexRelation *relation = find_relation(relation_ids[i]);
+        if (relation && relation_matches(relation, relation_type)) {
             /* Copy the relation */
-            MemexRelation *relation_copy = clone_relation(relations[i]);
+            MemexRelation *relation_copy = clone_relation(relation);
             if (relation_copy) {
                 memcpy(&result[result_index], relation_copy, sizeof(MemexRelation));
                 free(relation_copy); /* Just free the structure since we copied its contents */
                 result_index++;
             }
         }
+        pthread_rwlock_unlock(&relation_shard->lock);
     }
+    free(relation_ids);
     
+    if (result_index == 0) {
+        free(result);
+        return NULL;
+    }
     *count = result_index;
     return result;
 }
@@ -727,12 +2952,6 @@ bool memex_set_context(const MemexContext *context) {
         return false;
     }
     
-    /* Check if we already have a context of this type */
-    if (current_contexts[context->type]) {
-        /* Free the existing context */
-        free_context(current_contexts[context->type]);
-    }
-    
     /* Create a new context */
     MemexContext *new_context = (MemexContext *)malloc(sizeof(MemexContext));
     if (!new_context) {
@@ -769,8 +2988,14 @@ bool memex_set_context(const MemexContext *context) {
         new_context->data = NULL;
     }
     
-    /* Store the context */
+    /* Store the context, freeing any existing one of this type */
+    pthread_rwlock_wrlock(&context_lock);
+    MemexContext *previous = current_contexts[context->type];
     current_contexts[context->type] = new_context;
+    pthread_rwlock_unlock(&context_lock);
+    if (previous) {
+        free_context(previous);
+    }
     
     printf("Set Memex context: type=%d, name=%s\n", 
            context->type, context->name ? context->name : "<unnamed>");
@@ -792,28 +3017,33 @@ MemexContext *memex_get_context(MemexContextType context_type) {
     }
     
     /* Check if we have a context of this type */
-    if (!current_contexts[context_type]) {
+    pthread_rwlock_rdlock(&context_lock);
+    const MemexContext *current = current;
+    if (!current) {
+        pthread_rwlock_unlock(&context_lock);
         return NULL;
     }
     
     /* Create a copy of the context */
     MemexContext *context_copy = (MemexContext *)malloc(sizeof(MemexContext));
     if (!context_copy) {
+        pthread_rwlock_unlock(&context_lock);
         return NULL;
     }
     
     /* Copy basic fields */
-    context_copy->id = current_contexts[context_type]->id;
-    context_copy->type = current_contexts[context_type]->type;
-    context_copy->timestamp = current_contexts[context_type]->timestamp;
-    context_copy->relevance = current_contexts[context_type]->relevance;
-    context_copy->resonance_level = current_contexts[context_type]->resonance_level;
+    context_copy->id = current->id;
+    context_copy->type = current->type;
+    context_copy->timestamp = current->timestamp;
+    context_copy->relevance = current->relevance;
+    context_copy->resonance_level = current->resonance_level;
     
     /* Copy name if present */
-    if (current_contexts[context_type]->name) {
-        context_copy->name = strdup(current_contexts[context_type]->name);
+    if (current->name) {
+        context_copy->name = strdup(current->name);
         if (!context_copy->name) {
             free(context_copy);
+            pthread_rwlock_unlock(&context_lock);
             return NULL;
         }
     } else {
@@ -821,16 +3051,18 @@ MemexContext *memex_get_context(MemexContextType context_type) {
     }
     
     /* Copy data if present */
-    if (current_contexts[context_type]->data) {
-        context_copy->data = strdup(current_contexts[context_type]->data);
+    if (current->data) {
+        context_copy->data = strdup(current->data);
         if (!context_copy->data) {
             free(context_copy->name);
             free(context_copy);
+            pthread_rwlock_unlock(&context_lock);
             return NULL;
         }
     } else {
         context_copy->data = NULL;
     }
+    pthread_rwlock_unlock(&context_lock);
     
     return context_copy;
 }
@@ -887,24 +3119,7 @@ uint64_t memex_entangle_items(uint64_t item1_id, uint64_t item2_id, NodeLevel re
     }
     
     /* Check if both items exist */
-    bool item1_exists = false;
-    bool item2_exists = false;
-    
-    for (int i = 0; i < MAX_ITEMS; i++) {
-        if (items[i]) {
-            if (items[i]->id == item1_id) {
-                item1_exists = true;
-            }
-            if (items[i]->id == item2_id) {
-                item2_exists = true;
-            }
-        }
-        if (item1_exists && item2_exists) {
-            break;
-        }
-    }
-    
-    if (!item1_exists || !item2_exists) {
+    if (!item_exists(item1_id) || !item_exists(item2_id)) {
         printf("Cannot entangle: one or both items do not exist\n");
         return 0;
     }
@@ -933,6 +3148,86 @@ uint64_t memex_entangle_items(uint64_t item1_id, uint64_t item2_id, NodeLevel re
     return relation_id;
 }
 
+/**
+ * @brief Cached summary: header, entity versions, then the summary text
+ */
+typedef struct {
+    uint32_t count;            /**< Entities, each followed by its version */
+    uint32_t length;           /**< Summary bytes after the versions */
+} MemexCachedSummary;
+
+/**
+ * @brief Accept a cached summary if none of its entities changed since
+ *
+ * @param context Current entity versions, in the order the summary was keyed by
+ */
+static bool summary_is_current(const void *value, size_t size, void *context) {
+    const uint64_t *versions = (const uint64_t *)context;
+    const unsigned char *bytes = (const unsigned char *)value;
+    MemexCachedSummary header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, bytes, sizeof(header));
+    if (size != sizeof(header) + header.count * sizeof(uint64_t) + header.length) {
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < header.count; i++) {
+        uint64_t version;
+        memcpy(&version, bytes + sizeof(header) + i * sizeof(uint64_t), sizeof(version));
+        if (version != versions[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Fetch a cached summary whose entities are still at the given versions
+ *
+ * @return Copy of the summary, or NULL on a miss
+ */
+static char *lookup_summary(const KnowledgeStoreBuffer *key, const uint64_t *versions) {
+    pthread_mutex_lock(&cache_lock);
+    size_t size = 0;
+    const unsigned char *value = (const unsigned char *)rcache_lookup(
+        memex_cache, key->data, key->size, summary_is_current, (void *)versions, &size);
+    char *summary = NULL;
+    if (value) {
+        MemexCachedSummary header;
+        memcpy(&header, value, sizeof(header));
+        summary = (char *)malloc(header.length + 1);
+        if (summary) {
+            memcpy(summary, value + sizeof(header) + header.count * sizeof(uint64_t), header.length);
+            summary[header.length] = '\0';
+        }
+    }
+    pthread_mutex_unlock(&cache_lock);
+    return summary;
+}
+
+/**
+ * @brief Cache a summary stamped with the entity versions it was built from
+ */
+static void store_summary(const KnowledgeStoreBuffer *key, const uint64_t *versions,
+                          uint32_t entity_count, const char *summary) {
+    MemexCachedSummary header = { entity_count, (uint32_t)strlen(summary) };
+    size_t versions_size = entity_count * sizeof(uint64_t);
+    unsigned char *value = (unsigned char *)malloc(sizeof(header) + versions_size + header.length);
+    if (!value) {
+        return;
+    }
+    
+    memcpy(value, &header, sizeof(header));
+    memcpy(value + sizeof(header), versions, versions_size);
+    memcpy(value + sizeof(header) + versions_size, summary, header.length);
+    pthread_mutex_lock(&cache_lock);
+    rcache_store(memex_cache, key->data, key->size, value, sizeof(header) + versions_size + header.length);
+    pthread_mutex_unlock(&cache_lock);
+    free(value);
+}
+
 /**
  * @brief Generate a semantic summary of knowledge
  */
@@ -941,14 +3236,41 @@ char *memex_generate_summary(const uint64_t *entity_ids, uint32_t entity_count,
         return NULL;
     }
     
+    /*
+     * Summaries of unchanged entities are served from the cache. The
+     * versions are read before summarizing, so a change made meanwhile
+     * leaves the stored entry stale rather than wrongly current.
+     */
+    KnowledgeStoreBuffer key = { NULL, 0, 0, false };
+    kstore_buffer_put_u32(&key, MEMEX_CACHE_SUMMARY);
+    kstore_buffer_put_u32(&key, max_length);
+    kstore_buffer_put_u32(&key, entity_count);
+    for (uint32_t i = 0; i < entity_count; i++) {
+        kstore_buffer_put_u64(&key, entity_ids[i]);
+    }
+    uint64_t *versions = (uint64_t *)malloc(entity_count * sizeof(uint64_t));
+    bool cacheable = !key.failed && versions;
+    for (uint32_t i = 0; cacheable && i < entity_count; i++) {
+        versions[i] = item_version(entity_ids[i]);
+    }
+    char *summary = cacheable ? lookup_summary(&key, versions) : NULL;
+    if (summary) {
+        kstore_buffer_free(&key);
+        free(versions);
+        return summary;
+    }
+    
     /* In a real implementation, this would perform sophisticated summarization */
     /* For demonstration, we'll just create a simple summary */
     
     /* Allocate a buffer for the summary */
-    char *summary = (char *)malloc(max_length + 1);
+    summary = (char *)malloc(max_length + 1);
     if (!summary) {
+        kstore_buffer_free(&key);
+        free(versions);
         return NULL;
     }
+    summary[0] = '\0';
     
     /* Start with a header */
     int offset = snprintf(summary, max_length, "Summary of %u entities:\n", entity_count);
@@ -956,7 +3278,7 @@ char *memex_generate_summary(const uint64_t *entity_ids, uint32_t entity_count,
     /* Add information about each entity */
     for (uint32_t i = 0; i < entity_count && offset < max_length; i++) {
         /* Find the entity */
-        MemexDataItem *item = memex_get_item(entity_ids[i]);
+        const MemexDataItem *item = memex_acquire_item(entity_ids[i]);
         if (item) {
             /* Add entity information */
             offset += snprintf(summary + offset, max_length - offset, 
@@ -964,10 +3286,14 @@ char *memex_generate_summary(const uint64_t *entity_ids, uint32_t entity_count,
                              (unsigned long long)item->id,
                              item->name ? item->name : "<unnamed>");
             
-            /* Free the item */
-            memex_free_item(item);
+            memex_release_item(item);
         }
     }
     
+    if (cacheable) {
+        store_summary(&key, versions, entity_count, summary);
+    }
+    kstore_buffer_free(&key);
+    free(versions);
     return summary;
 }
\ No newline at end of file
@@ -5,6 +5,10 @@
  * This file defines the core interface for integrating Memex technology
  * with CTRLxT OS, providing advanced search, semantic analysis,
  * knowledge networking, and context-aware computing capabilities.
+ *
+ * Between memex_init() and memex_shutdown() the functions may be called
+ * from any thread. Reads run concurrently; writes contend only when they
+ * touch the same registry shard.
  */
 
 #ifndef CTRLXT_MEMEX_INTERFACE_H
@@ -16,6 +20,11 @@
 #include "../../quantum/resonance/resonant_frequencies.h"
 #include "../../quantum/messaging/quantum_message_bus.h"
 
+/**
+ * @brief Length of Memex item embeddings
+ */
+#define MEMEX_EMBEDDING_DIMENSIONS 256
+
 /**
  * @brief Memex search result relevance score
  */
@@ -88,6 +97,7 @@ typedef struct {
     MemexRelevance min_relevance; /**< Minimum relevance score (0.0 to 1.0) */
     NodeLevel min_resonance;   /**< Minimum resonance level */
     char *filter_metadata;     /**< JSON filter metadata */
+    uint32_t type_mask;        /**< Semantic searches: bit (1 << MemexDataType) per accepted type, 0 for all */
 } MemexSearchQuery;
 
 /**
@@ -148,14 +158,39 @@ typedef struct {
  * @brief Memex initialization options
  */
 typedef struct {
-    char *data_directory;      /**< Data storage directory */
-    uint32_t cache_size_mb;    /**< Cache size in megabytes */
+    char *data_directory;      /**< Data storage directory (NULL to keep data in memory only) */
+    uint32_t cache_size_mb;    /**< Result cache size in megabytes (0 for the default of 16) */
     bool enable_quantum;       /**< Whether to enable quantum features */
     NodeLevel max_resonance;   /**< Maximum resonance level to use */
     QComponentId component_id; /**< Quantum message bus component ID */
     void *custom_config;       /**< Custom configuration (if needed) */
 } MemexInitOptions;
 
+/**
+ * @brief Memex result cache statistics
+ */
+typedef struct {
+    uint64_t hits;             /**< Searches and summaries served from the cache */
+    uint64_t misses;           /**< Searches and summaries computed */
+    uint64_t invalidations;    /**< Cached results found stale and dropped */
+    uint64_t evictions;        /**< Cached results dropped to stay within the cache size */
+    uint32_t entries;          /**< Results currently cached */
+    uint64_t bytes;            /**< Bytes currently cached */
+    uint64_t capacity;         /**< Cache size in bytes */
+} MemexCacheStats;
+
+/**
+ * @brief Memex bulk ingest statistics
+ */
+typedef struct {
+    uint32_t submitted;        /**< Entries passed in */
+    uint32_t stored;           /**< Entries newly stored */
+    uint32_t duplicates;       /**< Entries skipped as repeats */
+    uint32_t rejected;         /**< Entries that were invalid or could not be stored */
+    uint64_t elapsed_us;       /**< Wall time in microseconds */
+    double per_second;         /**< Entries submitted per second */
+} MemexIngestStats;
+
 /**
  * @brief Initialize the Memex subsystem
  * 
@@ -169,9 +204,37 @@ bool memex_init(const MemexInitOptions *options);
  */
 void memex_shutdown(void);
 
+/**
+ * @brief Write compacted snapshots of the stored data and knowledge graph
+ *
+ * Runs automatically once a log outgrows its snapshot, and on shutdown.
+ *
+ * @return true on success (or when nothing is persisted), false otherwise
+ */
+bool memex_checkpoint(void);
+
+/**
+ * @brief Read the result cache statistics
+ * 
+ * Search results and summaries are cached by normalized query. Cached
+ * summaries are dropped when any entity they cover changes; cached
+ * searches are dropped when any change could alter their results.
+ * 
+ * @param stats Pointer to store the statistics
+ * @return true on success, false if Memex is not initialized
+ */
+bool memex_get_cache_stats(MemexCacheStats *stats);
+
 /**
  * @brief Perform a search query
  * 
+ * Text queries rank items by keyword. With MEMEX_SEARCH_SEMANTIC, items
+ * are instead ranked by the cosine similarity of their embedding to the
+ * query's, found through an approximate nearest-neighbor index. The
+ * query embedding is query_data when it holds exactly
+ * MEMEX_EMBEDDING_DIMENSIONS floats, and the text embedding of
+ * query_text otherwise.
+ * 
  * @param query Search query
  * @return Search results (must be freed with memex_free_search_results)
  */
@@ -192,6 +255,24 @@ void memex_free_search_results(MemexSearchResults *results);
  */
 uint64_t memex_store_item(const MemexDataItem *item);
 
+/**
+ * @brief Store a batch of data items
+ * 
+ * An item with the same type, name, data and metadata as an earlier one
+ * in the batch is stored once. The batch is indexed in one pass, with
+ * embeddings computed in parallel; other writers wait meanwhile. Large
+ * loads stream through by calling this once per batch.
+ * 
+ * @param items Items to store
+ * @param count Number of items
+ * @param ids Array of count entries to store each item's ID (or the ID
+ *            of the item it repeats; 0 if rejected), or NULL
+ * @param stats Pointer to store the statistics, or NULL
+ * @return Number of items newly stored
+ */
+uint32_t memex_store_items(const MemexDataItem *items, uint32_t count, uint64_t *ids,
+                           MemexIngestStats *stats);
+
 /**
  * @brief Retrieve a data item by ID
  * 
@@ -200,6 +281,24 @@ uint64_t memex_store_item(const MemexDataItem *item);
  */
 MemexDataItem *memex_get_item(uint64_t id);
 
+/**
+ * @brief Borrow a stored data item without copying it
+ * 
+ * The item must not be modified. It stays valid until released, even if
+ * it is updated or deleted meanwhile (the borrower keeps the old version).
+ * 
+ * @param id Item ID
+ * @return Borrowed item (release with memex_release_item) or NULL if not found
+ */
+const MemexDataItem *memex_acquire_item(uint64_t id);
+
+/**
+ * @brief Release an item borrowed with memex_acquire_item
+ * 
+ * @param item Borrowed item
+ */
+void memex_release_item(const MemexDataItem *item);
+
 /**
  * @brief Update a data item
  * 
@@ -216,6 +315,21 @@ bool memex_update_item(const MemexDataItem *item);
  */
 bool memex_delete_item(uint64_t id);
 
+/**
+ * @brief Set or clear the embedding of a data item
+ * 
+ * By default an item is embedded by hashing the words of its name and,
+ * for text items, its content. A set embedding (e.g. from a language
+ * model) replaces that until it is cleared, survives updates of the
+ * item, and is persisted with it.
+ * 
+ * @param id Item ID
+ * @param embedding MEMEX_EMBEDDING_DIMENSIONS floats, or NULL to go back to the text embedding
+ * @param dimensions Length of embedding (must be MEMEX_EMBEDDING_DIMENSIONS)
+ * @return true on success, false if the item does not exist or the embedding is invalid
+ */
+bool memex_set_item_embedding(uint64_t id, const float *embedding, uint32_t dimensions);
+
 /**
  * @brief Free a data item
  * 
@@ -231,6 +345,22 @@ void memex_free_item(MemexDataItem *item);
  */
 uint64_t memex_create_relation(const MemexRelation *relation);
 
+/**
+ * @brief Create a batch of knowledge relations
+ * 
+ * A relation with the same source, target and type as a stored relation
+ * or an earlier one in the batch is skipped.
+ * 
+ * @param relations Relations to create
+ * @param count Number of relations
+ * @param ids Array of count entries to store each relation's ID (or the
+ *            ID of the relation it repeats; 0 if rejected), or NULL
+ * @param stats Pointer to store the statistics, or NULL
+ * @return Number of relations newly created
+ */
+uint32_t memex_create_relations(const MemexRelation *relations, uint32_t count, uint64_t *ids,
+                                MemexIngestStats *stats);
+
 /**
  * @brief Delete a knowledge relation
  * 
@@ -307,4 +437,13 @@ char *memex_generate_summary(const uint64_t *entity_ids, uint32_t entity_count,
  */
 void memex_handle_quantum_message(QMessage *message, void *context);
 
+/**
+ * @brief Handle a batch of quantum messages (internal use)
+ * 
+ * @param messages Messages sharing a destination and message type
+ * @param count Number of messages
+ * @param context Context
+ */
+void memex_handle_quantum_message_batch(QMessage *const *messages, uint32_t count, void *context);
+
 #endif /* CTRLXT_MEMEX_INTERFACE_H */
\ No newline at end of file
@@ -0,0 +1,1973 @@
+/**
+ * @file knowledge_graph.c
+ * @brief Knowledge Graph implementation for Memex integration
+ *
+ * Nodes and relations live in slot arrays addressed by generational IDs.
+ * Traversals run over a compressed sparse row (CSR) snapshot of the
+ * relations, rebuilt on the first query after the graph changes: one
+ * forward adjacency for walking relations from source to target and one
+ * reverse adjacency for walking them backwards. Bidirectional relations
+ * appear in both directions in each.
+ *
+ * With a data directory, every mutation is appended to a knowledge store
+ * log and periodically compacted into a snapshot that the next kg_init()
+ * maps and replays. Records keep their IDs, and slot generations are
+ * stored too, so IDs deleted before a restart stay dead after it.
+ *
+ * Every node with words in its text, or with an embedding set through
+ * kg_set_node_embedding(), is also kept in an HNSW vector index for
+ * similarity search. Text embeddings are recomputed rather than stored.
+ *
+ * The graph is not thread-safe; callers serialize access, as with the
+ * rest of Memex. Large breadth-first frontiers are expanded by several
+ * threads internally.
+ */
+
+/* strdup and sysconf under -std=c11 */
+#define _XOPEN_SOURCE 700
+
+#include "knowledge_graph.h"
+#include "../search/vector_index.h"
+#include "../storage/knowledge_store.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+/* Sizing */
+#define KG_INITIAL_CAPACITY 256
+#define KG_NO_SLOT UINT32_MAX
+
+/* Frontier size from which a BFS level is split across threads */
+#define KG_PARALLEL_FRONTIER 4096
+#define KG_MAX_WORKERS 8
+
+/* Hops kg_semantic_reasoning() explores from its start node */
+#define KG_REASONING_DEPTH 3
+
+/* Candidate list size for kg_find_similar_nodes() */
+#define KG_SIMILARITY_EF 64
+
+/* Store record kinds; generation records use the KG_GENERATIONS_* IDs */
+#define KG_RECORD_NODE 1
+#define KG_RECORD_RELATION 2
+#define KG_RECORD_GENERATIONS 3
+#define KG_RECORD_EMBEDDING 4
+#define KG_GENERATIONS_NODES 1
+#define KG_GENERATIONS_RELATIONS 2
+
+/**
+ * @brief Node storage slot
+ */
+typedef struct {
+    KnowledgeNode node;        /**< Node data (id is 0 while free) */
+    float *embedding;          /**< Embedding set by kg_set_node_embedding(), or NULL */
+    uint32_t generation;       /**< Generation encoded in the slot's IDs */
+    uint32_t next_free;        /**< Free list link */
+} KgNodeSlot;
+
+/**
+ * @brief Relation storage slot
+ */
+typedef struct {
+    uint64_t id;               /**< Relation ID (0 while free) */
+    uint32_t source;           /**< Source node slot */
+    uint32_t target;           /**< Target node slot */
+    MemexRelationType type;    /**< Relation type */
+    bool bidirectional;        /**< Whether the relation can be walked backwards */
+    float weight;              /**< Relation weight (0.0 to 1.0) */
+    char *metadata;            /**< JSON metadata */
+    NodeLevel resonance_level; /**< Relation resonance level */
+    uint32_t generation;       /**< Generation encoded in the slot's IDs */
+    uint32_t next_free;        /**< Free list link */
+} KgRelationSlot;
+
+/**
+ * @brief CSR adjacency entry
+ */
+typedef struct {
+    uint32_t node;             /**< Node slot at the other end */
+    uint32_t relation;         /**< Relation slot */
+} KgEdge;
+
+/**
+ * @brief CSR adjacency: node n's entries are edges[offsets[n]..offsets[n + 1])
+ */
+typedef struct {
+    uint32_t *offsets;         /**< node_capacity + 1 offsets */
+    KgEdge *edges;             /**< Entries grouped by node */
+} KgAdjacency;
+
+/**
+ * @brief Per-node traversal state, valid when mark equals the current epoch
+ */
+typedef struct {
+    _Atomic uint32_t *mark;    /**< Epoch in which the node was reached */
+    uint32_t *depth;           /**< Hops from the side's root */
+    KgEdge *parent;            /**< Node and relation the node was reached through */
+} KgVisit;
+
+/**
+ * @brief Work for one thread expanding part of a BFS frontier
+ */
+typedef struct {
+    const KgAdjacency *adjacency; /**< Adjacency walked by this side */
+    KgVisit *visit;               /**< This side's visit state */
+    const KgVisit *other;         /**< Opposite side's visit state (NULL for one-sided BFS) */
+    const uint32_t *frontier;     /**< Frontier being expanded */
+    uint32_t begin;               /**< First frontier entry */
+    uint32_t end;                 /**< One past the last frontier entry */
+    uint32_t depth;               /**< Depth of the nodes reached */
+    uint32_t epoch;               /**< Current epoch */
+    NodeLevel min_resonance;      /**< Minimum node and relation resonance */
+    uint32_t *next;               /**< Nodes reached (owned by the task) */
+    uint32_t next_count;          /**< Number of nodes reached */
+    uint32_t next_capacity;       /**< Allocated next entries */
+    uint32_t meet_node;           /**< Best meeting node, or KG_NO_SLOT */
+    uint32_t meet_length;         /**< Path length through meet_node */
+    bool failed;                  /**< Allocation failure */
+} KgExpandTask;
+
+/**
+ * @brief Label in the weighted path search
+ */
+typedef struct {
+    double cost;               /**< Sum of -log(weight) from the start */
+    uint32_t node;             /**< Node slot */
+    uint32_t relation;         /**< Relation slot used to arrive */
+    uint32_t parent;           /**< Parent label, or KG_NO_SLOT at the start */
+    uint32_t hops;             /**< Relations from the start */
+} KgLabel;
+
+/* Graph state */
+static bool kg_initialized = false;
+static char *kg_data_directory = NULL;
+static bool kg_enable_quantum = false;
+static NodeLevel kg_max_resonance = NODE_ZERO_POINT;
+static KnowledgeStore *kg_store = NULL;
+static KnowledgeStoreBuffer kg_record = { NULL, 0, 0, false };
+static VectorIndex *kg_vectors = NULL;
+
+static KgNodeSlot *node_slots = NULL;
+static uint32_t node_capacity = 0;
+static uint32_t node_free_head = KG_NO_SLOT;
+static KgRelationSlot *relation_slots = NULL;
+static uint32_t relation_capacity = 0;
+static uint32_t relation_free_head = KG_NO_SLOT;
+
+/* CSR snapshot and traversal scratch, sized to node_capacity */
+static KgAdjacency forward_adjacency = { NULL, NULL };
+static KgAdjacency reverse_adjacency = { NULL, NULL };
+static bool adjacency_stale = true;
+static uint32_t scratch_capacity = 0;
+static KgVisit visits[2] = { { NULL, NULL, NULL }, { NULL, NULL, NULL } };
+static float *reach_strength = NULL;
+static uint32_t visit_epoch = 0;
+static uint32_t worker_limit = 1;
+
+/**
+ * @brief Build an ID from a slot and its generation
+ */
+static uint64_t make_id(uint32_t slot, uint32_t generation) {
+    return ((uint64_t)generation << 32) | (slot + 1);
+}
+
+/**
+ * @brief Look up a live node slot by ID
+ *
+ * @return Slot index, or KG_NO_SLOT if the ID is not live
+ */
+static uint32_t find_node_slot(uint64_t id) {
+    uint32_t slot = (uint32_t)id - 1;
+    if ((uint32_t)id == 0 || slot >= node_capacity || node_slots[slot].node.id != id) {
+        return KG_NO_SLOT;
+    }
+    return slot;
+}
+
+/**
+ * @brief Grow the node slot array to at least the given size
+ *
+ * New slots start at generation 1 and are pushed onto the free list.
+ */
+static bool grow_node_slots(uint32_t minimum) {
+    uint32_t capacity = node_capacity ? node_capacity : KG_INITIAL_CAPACITY;
+    while (capacity < minimum && capacity <= UINT32_MAX / 2) {
+        capacity *= 2;
+    }
+    if (capacity < minimum) {
+        return false;
+    }
+    if (capacity <= node_capacity) {
+        return true;
+    }
+
+    KgNodeSlot *slots = (KgNodeSlot *)realloc(node_slots, capacity * sizeof(KgNodeSlot));
+    if (!slots) {
+        return false;
+    }
+    memset(slots + node_capacity, 0, (capacity - node_capacity) * sizeof(KgNodeSlot));
+    for (uint32_t i = node_capacity; i < capacity; i++) {
+        slots[i].generation = 1;
+        slots[i].next_free = i + 1 < capacity ? i + 1 : node_free_head;
+    }
+    node_slots = slots;
+    node_free_head = node_capacity;
+    node_capacity = capacity;
+    adjacency_stale = true;
+    return true;
+}
+
+/**
+ * @brief Grow the relation slot array to at least the given size
+ */
+static bool grow_relation_slots(uint32_t minimum) {
+    uint32_t capacity = relation_capacity ? relation_capacity : KG_INITIAL_CAPACITY;
+    while (capacity < minimum && capacity <= UINT32_MAX / 2) {
+        capacity *= 2;
+    }
+    if (capacity < minimum) {
+        return false;
+    }
+    if (capacity <= relation_capacity) {
+        return true;
+    }
+
+    KgRelationSlot *slots = (KgRelationSlot *)realloc(relation_slots,
+                                                      capacity * sizeof(KgRelationSlot));
+    if (!slots) {
+        return false;
+    }
+    memset(slots + relation_capacity, 0, (capacity - relation_capacity) * sizeof(KgRelationSlot));
+    for (uint32_t i = relation_capacity; i < capacity; i++) {
+        slots[i].generation = 1;
+        slots[i].next_free = i + 1 < capacity ? i + 1 : relation_free_head;
+    }
+    relation_slots = slots;
+    relation_free_head = relation_capacity;
+    relation_capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Take a free node slot, growing the slot array if needed
+ *
+ * @return Slot index, or KG_NO_SLOT on allocation failure
+ */
+static uint32_t allocate_node_slot(void) {
+    if (node_free_head == KG_NO_SLOT && !grow_node_slots(node_capacity + 1)) {
+        return KG_NO_SLOT;
+    }
+
+    uint32_t slot = node_free_head;
+    node_free_head = node_slots[slot].next_free;
+    return slot;
+}
+
+/**
+ * @brief Take a free relation slot, growing the slot array if needed
+ *
+ * @return Slot index, or KG_NO_SLOT on allocation failure
+ */
+static uint32_t allocate_relation_slot(void) {
+    if (relation_free_head == KG_NO_SLOT && !grow_relation_slots(relation_capacity + 1)) {
+        return KG_NO_SLOT;
+    }
+
+    uint32_t slot = relation_free_head;
+    relation_free_head = relation_slots[slot].next_free;
+    return slot;
+}
+
+/**
+ * @brief Free a node slot's contents and return it to the free list
+ */
+static void release_node_slot(uint32_t slot) {
+    KgNodeSlot *entry = &node_slots[slot];
+    vindex_remove(kg_vectors, entry->node.id);
+    free(entry->node.label);
+    free(entry->node.description);
+    free(entry->node.properties);
+    free(entry->embedding);
+    memset(&entry->node, 0, sizeof(entry->node));
+    entry->embedding = NULL;
+
+    /* A slot whose generation would wrap is retired instead of reused */
+    if (++entry->generation != 0) {
+        entry->next_free = node_free_head;
+        node_free_head = slot;
+    }
+}
+
+/**
+ * @brief Free a relation slot's contents and return it to the free list
+ */
+static void release_relation_slot(uint32_t slot) {
+    KgRelationSlot *entry = &relation_slots[slot];
+    free(entry->metadata);
+    entry->metadata = NULL;
+    entry->id = 0;
+    adjacency_stale = true;
+
+    if (++entry->generation != 0) {
+        entry->next_free = relation_free_head;
+        relation_free_head = slot;
+    }
+}
+
+/**
+ * @brief Duplicate an optional string
+ *
+ * @return true on success (including a NULL input), false on allocation failure
+ */
+static bool copy_optional(char **copy, const char *value) {
+    *copy = value ? strdup(value) : NULL;
+    return !value || *copy;
+}
+
+/**
+ * @brief Embed a node's label, description and properties
+ *
+ * @return false if the node has no words
+ */
+static bool embed_node_text(const KnowledgeNode *node, float *embedding) {
+    const char *texts[3] = { node->label, node->description, node->properties };
+    size_t lengths[3];
+    for (int i = 0; i < 3; i++) {
+        lengths[i] = texts[i] ? strlen(texts[i]) : 0;
+    }
+    return vindex_embed_text(texts, lengths, 3, embedding, KG_EMBEDDING_DIMENSIONS);
+}
+
+/**
+ * @brief Put a node's current embedding and filter attributes into the vector index
+ *
+ * A node with no set embedding and no words is left out of the index.
+ */
+static bool index_node(uint32_t slot) {
+    const KgNodeSlot *entry = &node_slots[slot];
+    float text_embedding[KG_EMBEDDING_DIMENSIONS];
+    const float *embedding = entry->embedding;
+    if (!embedding) {
+        if (!embed_node_text(&entry->node, text_embedding)) {
+            vindex_remove(kg_vectors, entry->node.id);
+            return true;
+        }
+        embedding = text_embedding;
+    }
+
+    VectorEntry vector = {
+        entry->node.id, embedding, (uint32_t)entry->node.resonance_level, (uint32_t)entry->node.type
+    };
+    return vindex_insert(kg_vectors, &vector);
+}
+
+/**
+ * @brief Index every node after a load, in one batch
+ */
+static bool index_loaded_nodes(void) {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < node_capacity; i++) {
+        count += node_slots[i].node.id != 0;
+    }
+    if (count == 0) {
+        return true;
+    }
+
+    VectorEntry *entries = (VectorEntry *)malloc(count * sizeof(VectorEntry));
+    float *embeddings = (float *)malloc((size_t)count * KG_EMBEDDING_DIMENSIONS * sizeof(float));
+    if (!entries || !embeddings) {
+        free(entries);
+        free(embeddings);
+        return false;
+    }
+
+    uint32_t indexed = 0;
+    for (uint32_t i = 0; i < node_capacity; i++) {
+        const KgNodeSlot *entry = &node_slots[i];
+        if (entry->node.id == 0) {
+            continue;
+        }
+        float *embedding = embeddings + (size_t)indexed * KG_EMBEDDING_DIMENSIONS;
+        if (entry->embedding) {
+            memcpy(embedding, entry->embedding, KG_EMBEDDING_DIMENSIONS * sizeof(float));
+        } else if (!embed_node_text(&entry->node, embedding)) {
+            continue;
+        }
+        entries[indexed++] = (VectorEntry){
+            entry->node.id, embedding, (uint32_t)entry->node.resonance_level,
+            (uint32_t)entry->node.type
+        };
+    }
+
+    bool ok = indexed == 0 || vindex_insert_batch(kg_vectors, entries, indexed) == indexed;
+    free(entries);
+    free(embeddings);
+    return ok;
+}
+
+/**
+ * @brief Encode a node record
+ */
+static void encode_node(KnowledgeStoreBuffer *buffer, const KnowledgeNode *node) {
+    kstore_buffer_reset(buffer);
+    kstore_buffer_put_u32(buffer, (uint32_t)node->type);
+    kstore_buffer_put_u32(buffer, (uint32_t)node->resonance_level);
+    kstore_buffer_put_u64(buffer, node->creation_time);
+    kstore_buffer_put_string(buffer, node->label);
+    kstore_buffer_put_string(buffer, node->description);
+    kstore_buffer_put_string(buffer, node->properties);
+}
+
+/**
+ * @brief Encode a relation record
+ */
+static void encode_relation(KnowledgeStoreBuffer *buffer, const KgRelationSlot *relation) {
+    kstore_buffer_reset(buffer);
+    kstore_buffer_put_u64(buffer, node_slots[relation->source].node.id);
+    kstore_buffer_put_u64(buffer, node_slots[relation->target].node.id);
+    kstore_buffer_put_u32(buffer, (uint32_t)relation->type);
+    kstore_buffer_put_u32(buffer, relation->bidirectional ? 1 : 0);
+    kstore_buffer_put_f32(buffer, relation->weight);
+    kstore_buffer_put_u32(buffer, (uint32_t)relation->resonance_level);
+    kstore_buffer_put_string(buffer, relation->metadata);
+}
+
+/**
+ * @brief Log a node put (no-op without a store)
+ */
+static bool log_node(const KnowledgeNode *node) {
+    if (!kg_store) {
+        return true;
+    }
+    encode_node(&kg_record, node);
+    return !kg_record.failed &&
+           kstore_put(kg_store, KG_RECORD_NODE, node->id, kg_record.data, (uint32_t)kg_record.size);
+}
+
+/**
+ * @brief Log a relation put (no-op without a store)
+ */
+static bool log_relation(const KgRelationSlot *relation) {
+    if (!kg_store) {
+        return true;
+    }
+    encode_relation(&kg_record, relation);
+    return !kg_record.failed &&
+           kstore_put(kg_store, KG_RECORD_RELATION, relation->id, kg_record.data,
+                      (uint32_t)kg_record.size);
+}
+
+/**
+ * @brief Log a delete (no-op without a store)
+ */
+static bool log_delete(uint32_t kind, uint64_t id) {
+    return !kg_store || kstore_delete(kg_store, kind, id);
+}
+
+/**
+ * @brief Encode an embedding record
+ */
+static void encode_embedding(KnowledgeStoreBuffer *buffer, const float *embedding) {
+    kstore_buffer_reset(buffer);
+    for (uint32_t i = 0; i < KG_EMBEDDING_DIMENSIONS; i++) {
+        kstore_buffer_put_f32(buffer, embedding[i]);
+    }
+}
+
+/**
+ * @brief Log a node's set embedding, or its removal (no-op without a store)
+ */
+static bool log_embedding(const KgNodeSlot *entry) {
+    if (!entry->embedding) {
+        return log_delete(KG_RECORD_EMBEDDING, entry->node.id);
+    }
+    if (!kg_store) {
+        return true;
+    }
+    encode_embedding(&kg_record, entry->embedding);
+    return !kg_record.failed &&
+           kstore_put(kg_store, KG_RECORD_EMBEDDING, entry->node.id, kg_record.data,
+                      (uint32_t)kg_record.size);
+}
+
+/**
+ * @brief Restore a node at the slot and generation its ID names
+ */
+static bool restore_node(uint64_t id, const KnowledgeStoreRecord *record) {
+    uint32_t slot = (uint32_t)id - 1;
+    uint32_t generation = (uint32_t)(id >> 32);
+    if ((uint32_t)id == 0 || generation == 0 || !grow_node_slots(slot + 1)) {
+        return false;
+    }
+    KgNodeSlot *entry = &node_slots[slot];
+    if (entry->node.id != 0 && entry->node.id != id) {
+        return false;
+    }
+
+    KnowledgeStoreReader reader;
+    kstore_reader_init(&reader, record);
+    KnowledgeNode node = { 0 };
+    node.id = id;
+    node.type = (KnowledgeNodeType)kstore_read_u32(&reader);
+    node.resonance_level = (NodeLevel)kstore_read_u32(&reader);
+    node.creation_time = kstore_read_u64(&reader);
+    if (!kstore_read_string(&reader, &node.label) ||
+        !kstore_read_string(&reader, &node.description) ||
+        !kstore_read_string(&reader, &node.properties) || !node.label) {
+        free(node.label);
+        free(node.description);
+        free(node.properties);
+        return false;
+    }
+
+    free(entry->node.label);
+    free(entry->node.description);
+    free(entry->node.properties);
+    entry->node = node;
+    entry->generation = generation;
+    return true;
+}
+
+/**
+ * @brief Restore a relation at the slot and generation its ID names
+ */
+static bool restore_relation(uint64_t id, const KnowledgeStoreRecord *record) {
+    uint32_t slot = (uint32_t)id - 1;
+    uint32_t generation = (uint32_t)(id >> 32);
+    if ((uint32_t)id == 0 || generation == 0 || !grow_relation_slots(slot + 1)) {
+        return false;
+    }
+    KgRelationSlot *relation = &relation_slots[slot];
+    if (relation->id != 0 && relation->id != id) {
+        return false;
+    }
+
+    KnowledgeStoreReader reader;
+    kstore_reader_init(&reader, record);
+    uint32_t source = find_node_slot(kstore_read_u64(&reader));
+    uint32_t target = find_node_slot(kstore_read_u64(&reader));
+    MemexRelationType type = (MemexRelationType)kstore_read_u32(&reader);
+    bool bidirectional = kstore_read_u32(&reader) != 0;
+    float weight = kstore_read_f32(&reader);
+    NodeLevel resonance_level = (NodeLevel)kstore_read_u32(&reader);
+    char *metadata = NULL;
+    if (!kstore_read_string(&reader, &metadata) || source == KG_NO_SLOT || target == KG_NO_SLOT) {
+        free(metadata);
+        return false;
+    }
+
+    free(relation->metadata);
+    relation->id = id;
+    relation->source = source;
+    relation->target = target;
+    relation->type = type;
+    relation->bidirectional = bidirectional;
+    relation->weight = weight;
+    relation->metadata = metadata;
+    relation->resonance_level = resonance_level;
+    relation->generation = generation;
+    return true;
+}
+
+/**
+ * @brief Restore the embedding set on a node
+ */
+static bool restore_embedding(uint64_t id, const KnowledgeStoreRecord *record) {
+    uint32_t slot = find_node_slot(id);
+    if (slot == KG_NO_SLOT || record->size != KG_EMBEDDING_DIMENSIONS * sizeof(float)) {
+        return false;
+    }
+    float *embedding = (float *)malloc(KG_EMBEDDING_DIMENSIONS * sizeof(float));
+    if (!embedding) {
+        return false;
+    }
+
+    KnowledgeStoreReader reader;
+    kstore_reader_init(&reader, record);
+    for (uint32_t i = 0; i < KG_EMBEDDING_DIMENSIONS; i++) {
+        embedding[i] = kstore_read_f32(&reader);
+    }
+    free(node_slots[slot].embedding);
+    node_slots[slot].embedding = embedding;
+    return true;
+}
+
+/**
+ * @brief Restore the generations of free slots, so their old IDs stay dead
+ */
+static bool restore_generations(uint64_t id, const KnowledgeStoreRecord *record) {
+    bool nodes = id == KG_GENERATIONS_NODES;
+    uint32_t count = record->size / sizeof(uint32_t);
+    if ((!nodes && id != KG_GENERATIONS_RELATIONS) ||
+        !(nodes ? grow_node_slots(count) : grow_relation_slots(count))) {
+        return false;
+    }
+
+    KnowledgeStoreReader reader;
+    kstore_reader_init(&reader, record);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t generation = kstore_read_u32(&reader);
+        if (nodes && node_slots[i].node.id == 0) {
+            node_slots[i].generation = generation;
+        } else if (!nodes && relation_slots[i].id == 0) {
+            relation_slots[i].generation = generation;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Apply one stored record to the graph
+ */
+static bool replay_record(KnowledgeStoreOp op, const KnowledgeStoreRecord *record, void *context) {
+    (void)context;
+
+    if (op == KSTORE_OP_PUT) {
+        switch (record->kind) {
+            case KG_RECORD_NODE: return restore_node(record->id, record);
+            case KG_RECORD_RELATION: return restore_relation(record->id, record);
+            case KG_RECORD_GENERATIONS: return restore_generations(record->id, record);
+            case KG_RECORD_EMBEDDING: return restore_embedding(record->id, record);
+            default: return false;
+        }
+    }
+
+    if (record->kind == KG_RECORD_NODE) {
+        uint32_t slot = find_node_slot(record->id);
+        if (slot != KG_NO_SLOT) {
+            release_node_slot(slot);
+        }
+        return true;
+    }
+    if (record->kind == KG_RECORD_RELATION) {
+        uint32_t slot = (uint32_t)record->id - 1;
+        if ((uint32_t)record->id != 0 && slot < relation_capacity &&
+            relation_slots[slot].id == record->id) {
+            release_relation_slot(slot);
+        }
+        return true;
+    }
+    if (record->kind == KG_RECORD_EMBEDDING) {
+        uint32_t slot = find_node_slot(record->id);
+        if (slot != KG_NO_SLOT) {
+            free(node_slots[slot].embedding);
+            node_slots[slot].embedding = NULL;
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Rebuild both free lists after a load, lowest slot first
+ */
+static void rebuild_free_lists(void) {
+    node_free_head = KG_NO_SLOT;
+    for (uint32_t i = node_capacity; i-- > 0;) {
+        if (node_slots[i].node.id == 0 && node_slots[i].generation != 0) {
+            node_slots[i].next_free = node_free_head;
+            node_free_head = i;
+        }
+    }
+    relation_free_head = KG_NO_SLOT;
+    for (uint32_t i = relation_capacity; i-- > 0;) {
+        if (relation_slots[i].id == 0 && relation_slots[i].generation != 0) {
+            relation_slots[i].next_free = relation_free_head;
+            relation_free_head = i;
+        }
+    }
+}
+
+/**
+ * @brief Compact once the log has outgrown the snapshot
+ */
+static void maybe_checkpoint(void) {
+    if (kg_store && kstore_should_compact(kg_store)) {
+        kg_checkpoint();
+    }
+}
+
+/**
+ * @brief Fill one CSR adjacency from the live relations
+ *
+ * @param adjacency Adjacency to fill (offsets already sized)
+ * @param reverse Whether to index relations by target instead of source
+ */
+static bool fill_adjacency(KgAdjacency *adjacency, bool reverse) {
+    uint32_t *offsets = adjacency->offsets;
+    memset(offsets, 0, (node_capacity + 1) * sizeof(uint32_t));
+
+    /* Count entries per node, shifted by one for the prefix sum */
+    for (uint32_t r = 0; r < relation_capacity; r++) {
+        const KgRelationSlot *relation = &relation_slots[r];
+        if (relation->id == 0) {
+            continue;
+        }
+        offsets[(reverse ? relation->target : relation->source) + 1]++;
+        if (relation->bidirectional) {
+            offsets[(reverse ? relation->source : relation->target) + 1]++;
+        }
+    }
+    for (uint32_t n = 0; n < node_capacity; n++) {
+        offsets[n + 1] += offsets[n];
+    }
+
+    KgEdge *edges = (KgEdge *)realloc(adjacency->edges,
+                                      (offsets[node_capacity] + 1) * sizeof(KgEdge));
+    if (!edges) {
+        return false;
+    }
+    adjacency->edges = edges;
+
+    /* Place entries, using offsets[n] as node n's cursor, then shift back */
+    for (uint32_t r = 0; r < relation_capacity; r++) {
+        const KgRelationSlot *relation = &relation_slots[r];
+        if (relation->id == 0) {
+            continue;
+        }
+        uint32_t from = reverse ? relation->target : relation->source;
+        uint32_t to = reverse ? relation->source : relation->target;
+        edges[offsets[from]++] = (KgEdge){ to, r };
+        if (relation->bidirectional) {
+            edges[offsets[to]++] = (KgEdge){ from, r };
+        }
+    }
+    memmove(offsets + 1, offsets, node_capacity * sizeof(uint32_t));
+    offsets[0] = 0;
+    return true;
+}
+
+/**
+ * @brief Rebuild the CSR snapshot and scratch arrays if the graph changed
+ *
+ * @return true if the snapshot is current, false on allocation failure
+ */
+static bool refresh_adjacency(void) {
+    if (!adjacency_stale) {
+        return true;
+    }
+
+    if (scratch_capacity != node_capacity) {
+        uint32_t *forward_offsets = (uint32_t *)realloc(forward_adjacency.offsets,
+                                                        (node_capacity + 1) * sizeof(uint32_t));
+        if (!forward_offsets) {
+            return false;
+        }
+        forward_adjacency.offsets = forward_offsets;
+        uint32_t *reverse_offsets = (uint32_t *)realloc(reverse_adjacency.offsets,
+                                                        (node_capacity + 1) * sizeof(uint32_t));
+        if (!reverse_offsets) {
+            return false;
+        }
+        reverse_adjacency.offsets = reverse_offsets;
+
+        float *strength = (float *)realloc(reach_strength, node_capacity * sizeof(float));
+        if (!strength) {
+            return false;
+        }
+        reach_strength = strength;
+
+        for (int side = 0; side < 2; side++) {
+            _Atomic uint32_t *mark = (_Atomic uint32_t *)realloc(
+                (void *)visits[side].mark, node_capacity * sizeof(_Atomic uint32_t));
+            if (!mark) {
+                return false;
+            }
+            visits[side].mark = mark;
+            uint32_t *depth = (uint32_t *)realloc(visits[side].depth,
+                                                  node_capacity * sizeof(uint32_t));
+            if (!depth) {
+                return false;
+            }
+            visits[side].depth = depth;
+            KgEdge *parent = (KgEdge *)realloc(visits[side].parent,
+                                               node_capacity * sizeof(KgEdge));
+            if (!parent) {
+                return false;
+            }
+            visits[side].parent = parent;
+
+            /* Start every mark in the past so the epoch can restart at 1 */
+            for (uint32_t n = 0; n < node_capacity; n++) {
+                atomic_init(&visits[side].mark[n], 0);
+            }
+        }
+        visit_epoch = 0;
+        scratch_capacity = node_capacity;
+    }
+
+    if (!fill_adjacency(&forward_adjacency, false) || !fill_adjacency(&reverse_adjacency, true)) {
+        return false;
+    }
+    adjacency_stale = false;
+    return true;
+}
+
+/**
+ * @brief Start a traversal, invalidating all visit marks in O(1)
+ *
+ * @return Epoch to stamp reached nodes with
+ */
+static uint32_t begin_traversal(void) {
+    if (++visit_epoch == 0) {
+        for (int side = 0; side < 2; side++) {
+            for (uint32_t n = 0; n < scratch_capacity; n++) {
+                atomic_store_explicit(&visits[side].mark[n], 0, memory_order_relaxed);
+            }
+        }
+        visit_epoch = 1;
+    }
+    return visit_epoch;
+}
+
+/**
+ * @brief Whether a node was reached in the current traversal
+ */
+static bool visited(const KgVisit *visit, uint32_t node, uint32_t epoch) {
+    return atomic_load_explicit(&visit->mark[node], memory_order_relaxed) == epoch;
+}
+
+/**
+ * @brief Whether an edge may be walked under a resonance floor
+ */
+static bool edge_allowed(const KgEdge *edge, NodeLevel min_resonance) {
+    return relation_slots[edge->relation].resonance_level >= min_resonance &&
+           node_slots[edge->node].node.resonance_level >= min_resonance;
+}
+
+/**
+ * @brief Expand a range of a BFS frontier
+ *
+ * Each reached node is claimed with a compare-and-swap on its mark, so
+ * concurrent tasks never record the same node twice.
+ */
+static void expand_frontier(KgExpandTask *task) {
+    const KgAdjacency *adjacency = task->adjacency;
+    KgVisit *visit = task->visit;
+
+    for (uint32_t i = task->begin; i < task->end; i++) {
+        uint32_t node = task->frontier[i];
+        for (uint32_t e = adjacency->offsets[node]; e < adjacency->offsets[node + 1]; e++) {
+            const KgEdge *edge = &adjacency->edges[e];
+            if (!edge_allowed(edge, task->min_resonance)) {
+                continue;
+            }
+
+            uint32_t seen = atomic_load_explicit(&visit->mark[edge->node], memory_order_relaxed);
+            if (seen == task->epoch ||
+                !atomic_compare_exchange_strong_explicit(&visit->mark[edge->node], &seen,
+                                                         task->epoch, memory_order_relaxed,
+                                                         memory_order_relaxed)) {
+                continue;
+            }
+            visit->depth[edge->node] = task->depth;
+            visit->parent[edge->node] = (KgEdge){ node, edge->relation };
+
+            if (task->other && visited(task->other, edge->node, task->epoch)) {
+                uint32_t length = task->depth + task->other->depth[edge->node];
+                if (length < task->meet_length) {
+                    task->meet_length = length;
+                    task->meet_node = edge->node;
+                }
+            }
+
+            if (task->next_count == task->next_capacity) {
+                uint32_t capacity = task->next_capacity ? task->next_capacity * 2 : 64;
+                uint32_t *next = (uint32_t *)realloc(task->next, capacity * sizeof(uint32_t));
+                if (!next) {
+                    task->failed = true;
+                    return;
+                }
+                task->next = next;
+                task->next_capacity = capacity;
+            }
+            task->next[task->next_count++] = edge->node;
+        }
+    }
+}
+
+/**
+ * @brief Thread entry point for expand_frontier()
+ */
+static void *expand_frontier_main(void *arg) {
+    expand_frontier((KgExpandTask *)arg);
+    return NULL;
+}
+
+/**
+ * @brief Expand one BFS level, splitting large frontiers across threads
+ *
+ * @param prototype Task fields shared by all ranges (next/meet fields unused)
+ * @param frontier In: nodes at the current depth. Out: nodes at the next depth
+ * @param count In/out: number of frontier nodes
+ * @param meet_node Updated with the best meeting node found
+ * @param meet_length Updated with the path length through meet_node
+ * @return true on success, false on allocation failure
+ */
+static bool expand_level(const KgExpandTask *prototype, uint32_t **frontier, uint32_t *count,
+                         uint32_t *meet_node, uint32_t *meet_length) {
+    KgExpandTask tasks[KG_MAX_WORKERS];
+    pthread_t threads[KG_MAX_WORKERS];
+    bool started[KG_MAX_WORKERS] = { false };
+
+    uint32_t task_count = 1;
+    if (*count >= KG_PARALLEL_FRONTIER) {
+        task_count = *count / (KG_PARALLEL_FRONTIER / 2);
+        if (task_count > worker_limit) {
+            task_count = worker_limit;
+        }
+    }
+
+    for (uint32_t t = 0; t < task_count; t++) {
+        tasks[t] = *prototype;
+        tasks[t].frontier = *frontier;
+        tasks[t].begin = (uint32_t)((uint64_t)*count * t / task_count);
+        tasks[t].end = (uint32_t)((uint64_t)*count * (t + 1) / task_count);
+        tasks[t].next = NULL;
+        tasks[t].next_count = 0;
+        tasks[t].next_capacity = 0;
+        tasks[t].meet_node = KG_NO_SLOT;
+        tasks[t].meet_length = UINT32_MAX;
+        tasks[t].failed = false;
+    }
+
+    /* Ranges whose thread fails to start run on the calling thread */
+    for (uint32_t t = 1; t < task_count; t++) {
+        started[t] = pthread_create(&threads[t], NULL, expand_frontier_main, &tasks[t]) == 0;
+    }
+    expand_frontier(&tasks[0]);
+    for (uint32_t t = 1; t < task_count; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        } else {
+            expand_frontier(&tasks[t]);
+        }
+    }
+
+    /* Concatenate the reached nodes into the next frontier */
+    bool ok = true;
+    uint32_t total = 0;
+    for (uint32_t t = 0; t < task_count; t++) {
+        ok = ok && !tasks[t].failed;
+        total += tasks[t].next_count;
+        if (tasks[t].meet_length < *meet_length) {
+            *meet_length = tasks[t].meet_length;
+            *meet_node = tasks[t].meet_node;
+        }
+    }
+    if (ok && task_count == 1) {
+        free(*frontier);
+        *frontier = tasks[0].next;
+        *count = total;
+        return true;
+    }
+
+    uint32_t *next = ok ? (uint32_t *)malloc((total + 1) * sizeof(uint32_t)) : NULL;
+    uint32_t offset = 0;
+    for (uint32_t t = 0; t < task_count; t++) {
+        if (next) {
+            memcpy(next + offset, tasks[t].next, tasks[t].next_count * sizeof(uint32_t));
+            offset += tasks[t].next_count;
+        }
+        free(tasks[t].next);
+    }
+    if (!next) {
+        return false;
+    }
+    free(*frontier);
+    *frontier = next;
+    *count = total;
+    return true;
+}
+
+/**
+ * @brief Allocate a path with its node and relation arrays in one block
+ */
+static KnowledgePath *allocate_path(uint32_t length) {
+    KnowledgePath *path = (KnowledgePath *)malloc(sizeof(KnowledgePath) +
+                                                  (2 * (size_t)length + 1) * sizeof(uint64_t));
+    if (!path) {
+        return NULL;
+    }
+    path->node_ids = (uint64_t *)(path + 1);
+    path->relation_ids = path->node_ids + length + 1;
+    path->length = length;
+    path->relevance = 1.0f;
+    return path;
+}
+
+/**
+ * @brief Free every node, relation and traversal buffer
+ */
+static void release_graph(void) {
+    for (uint32_t i = 0; i < node_capacity; i++) {
+        free(node_slots[i].node.label);
+        free(node_slots[i].node.description);
+        free(node_slots[i].node.properties);
+        free(node_slots[i].embedding);
+    }
+    for (uint32_t i = 0; i < relation_capacity; i++) {
+        free(relation_slots[i].metadata);
+    }
+    free(node_slots);
+    free(relation_slots);
+    node_slots = NULL;
+    relation_slots = NULL;
+    node_capacity = 0;
+    relation_capacity = 0;
+    node_free_head = KG_NO_SLOT;
+    relation_free_head = KG_NO_SLOT;
+
+    free(forward_adjacency.offsets);
+    free(forward_adjacency.edges);
+    free(reverse_adjacency.offsets);
+    free(reverse_adjacency.edges);
+    forward_adjacency = (KgAdjacency){ NULL, NULL };
+    reverse_adjacency = (KgAdjacency){ NULL, NULL };
+    for (int side = 0; side < 2; side++) {
+        free((void *)visits[side].mark);
+        free(visits[side].depth);
+        free(visits[side].parent);
+        visits[side] = (KgVisit){ NULL, NULL, NULL };
+    }
+    free(reach_strength);
+    reach_strength = NULL;
+    scratch_capacity = 0;
+    visit_epoch = 0;
+    adjacency_stale = true;
+
+    vindex_destroy(kg_vectors);
+    kg_vectors = NULL;
+    kstore_close(kg_store);
+    kg_store = NULL;
+    kstore_buffer_free(&kg_record);
+    free(kg_data_directory);
+    kg_data_directory = NULL;
+}
+
+/**
+ * @brief Initialize the Knowledge Graph component
+ */
+bool kg_init(const char *data_directory, bool enable_quantum, NodeLevel max_resonance) {
+    if (kg_initialized) {
+        printf("Knowledge graph already initialized\n");
+        return false;
+    }
+
+    if (!copy_optional(&kg_data_directory, data_directory)) {
+        return false;
+    }
+    kg_enable_quantum = enable_quantum;
+    kg_max_resonance = max_resonance;
+
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    worker_limit = processors < 1 ? 1 : processors > KG_MAX_WORKERS ? KG_MAX_WORKERS
+                                                                    : (uint32_t)processors;
+
+    VectorIndexOptions vector_options = {
+        KG_EMBEDDING_DIMENSIONS, VINDEX_METRIC_COSINE, 0, 64, VINDEX_KERNEL_AUTO
+    };
+    kg_vectors = vindex_create(&vector_options);
+    if (!kg_vectors) {
+        release_graph();
+        return false;
+    }
+
+    /* Map the last snapshot and replay the log written since */
+    if (data_directory) {
+        kg_store = kstore_open(data_directory, "knowledge_graph", false);
+        if (!kg_store || !kstore_load(kg_store, replay_record, NULL)) {
+            printf("Failed to load knowledge graph from %s\n", data_directory);
+            release_graph();
+            return false;
+        }
+        rebuild_free_lists();
+        if (!index_loaded_nodes()) {
+            printf("Failed to index knowledge graph from %s\n", data_directory);
+            release_graph();
+            return false;
+        }
+    }
+
+    adjacency_stale = true;
+    kg_initialized = true;
+    return true;
+}
+
+/**
+ * @brief Shutdown the Knowledge Graph component
+ */
+void kg_shutdown(void) {
+    if (!kg_initialized) {
+        return;
+    }
+
+    if (kg_store) {
+        kg_checkpoint();
+    }
+    release_graph();
+    kg_initialized = false;
+}
+
+/**
+ * @brief Write a compacted snapshot of the graph
+ */
+bool kg_checkpoint(void) {
+    if (!kg_initialized) {
+        return false;
+    }
+    if (!kg_store) {
+        return true;
+    }
+    if (!kstore_begin_snapshot(kg_store)) {
+        return false;
+    }
+
+    bool ok = true;
+    for (uint32_t i = 0; ok && i < node_capacity; i++) {
+        const KnowledgeNode *node = &node_slots[i].node;
+        if (node->id != 0) {
+            encode_node(&kg_record, node);
+            ok = !kg_record.failed && kstore_snapshot_add(kg_store, KG_RECORD_NODE, node->id,
+                                                          kg_record.data, (uint32_t)kg_record.size);
+        }
+    }
+    for (uint32_t i = 0; ok && i < relation_capacity; i++) {
+        const KgRelationSlot *relation = &relation_slots[i];
+        if (relation->id != 0) {
+            encode_relation(&kg_record, relation);
+            ok = !kg_record.failed && kstore_snapshot_add(kg_store, KG_RECORD_RELATION, relation->id,
+                                                          kg_record.data, (uint32_t)kg_record.size);
+        }
+    }
+    for (uint32_t i = 0; ok && i < node_capacity; i++) {
+        const KgNodeSlot *entry = &node_slots[i];
+        if (entry->node.id != 0 && entry->embedding) {
+            encode_embedding(&kg_record, entry->embedding);
+            ok = !kg_record.failed && kstore_snapshot_add(kg_store, KG_RECORD_EMBEDDING, entry->node.id,
+                                                          kg_record.data, (uint32_t)kg_record.size);
+        }
+    }
+
+    kstore_buffer_reset(&kg_record);
+    for (uint32_t i = 0; i < node_capacity; i++) {
+        kstore_buffer_put_u32(&kg_record, node_slots[i].generation);
+    }
+    ok = ok && !kg_record.failed &&
+         kstore_snapshot_add(kg_store, KG_RECORD_GENERATIONS, KG_GENERATIONS_NODES,
+                             kg_record.data, (uint32_t)kg_record.size);
+    kstore_buffer_reset(&kg_record);
+    for (uint32_t i = 0; i < relation_capacity; i++) {
+        kstore_buffer_put_u32(&kg_record, relation_slots[i].generation);
+    }
+    ok = ok && !kg_record.failed &&
+         kstore_snapshot_add(kg_store, KG_RECORD_GENERATIONS, KG_GENERATIONS_RELATIONS,
+                             kg_record.data, (uint32_t)kg_record.size);
+
+    if (!kstore_end_snapshot(kg_store, ok) || !ok) {
+        printf("Failed to checkpoint knowledge graph\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Create a new knowledge node
+ */
+uint64_t kg_create_node(KnowledgeNodeType type, const char *label, const char *description,
+                       const char *properties, NodeLevel resonance_level) {
+    if (!kg_initialized || !label) {
+        return 0;
+    }
+    if (resonance_level > kg_max_resonance) {
+        printf("Knowledge node resonance %d exceeds the graph maximum %d\n",
+               resonance_level, kg_max_resonance);
+        return 0;
+    }
+
+    KnowledgeNode node = { 0 };
+    if (!copy_optional(&node.label, label) ||
+        !copy_optional(&node.description, description) ||
+        !copy_optional(&node.properties, properties)) {
+        free(node.label);
+        free(node.description);
+        return 0;
+    }
+
+    uint32_t slot = allocate_node_slot();
+    if (slot == KG_NO_SLOT) {
+        free(node.label);
+        free(node.description);
+        free(node.properties);
+        return 0;
+    }
+
+    node.id = make_id(slot, node_slots[slot].generation);
+    node.type = type;
+    node.resonance_level = resonance_level;
+    node.creation_time = (uint64_t)time(NULL);
+    node_slots[slot].node = node;
+    if (!index_node(slot) || !log_node(&node)) {
+        release_node_slot(slot);
+        return 0;
+    }
+    maybe_checkpoint();
+    return node.id;
+}
+
+/**
+ * @brief Get a knowledge node by ID
+ */
+KnowledgeNode *kg_get_node(uint64_t node_id) {
+    if (!kg_initialized) {
+        return NULL;
+    }
+    uint32_t slot = find_node_slot(node_id);
+    if (slot == KG_NO_SLOT) {
+        return NULL;
+    }
+
+    const KnowledgeNode *node = &node_slots[slot].node;
+    KnowledgeNode *copy = (KnowledgeNode *)malloc(sizeof(KnowledgeNode));
+    if (!copy) {
+        return NULL;
+    }
+    *copy = *node;
+    copy->label = NULL;
+    copy->description = NULL;
+    copy->properties = NULL;
+    if (!copy_optional(&copy->label, node->label) ||
+        !copy_optional(&copy->description, node->description) ||
+        !copy_optional(&copy->properties, node->properties)) {
+        kg_free_node(copy);
+        return NULL;
+    }
+    return copy;
+}
+
+/**
+ * @brief Update a knowledge node
+ */
+bool kg_update_node(uint64_t node_id, const char *label, const char *description,
+                   const char *properties, int resonance_level) {
+    if (!kg_initialized) {
+        return false;
+    }
+    uint32_t slot = find_node_slot(node_id);
+    if (slot == KG_NO_SLOT) {
+        return false;
+    }
+    if (resonance_level >= 0 && resonance_level > (int)kg_max_resonance) {
+        printf("Knowledge node resonance %d exceeds the graph maximum %d\n",
+               resonance_level, kg_max_resonance);
+        return false;
+    }
+
+    /* Copy everything first so a failed update leaves the node untouched */
+    char *new_label = NULL;
+    char *new_description = NULL;
+    char *new_properties = NULL;
+    if (!copy_optional(&new_label, label) ||
+        !copy_optional(&new_description, description) ||
+        !copy_optional(&new_properties, properties)) {
+        free(new_label);
+        free(new_description);
+        return false;
+    }
+
+    KnowledgeNode *node = &node_slots[slot].node;
+    KnowledgeNode updated = *node;
+    if (label) updated.label = new_label;
+    if (description) updated.description = new_description;
+    if (properties) updated.properties = new_properties;
+    if (resonance_level >= 0) updated.resonance_level = (NodeLevel)resonance_level;
+    if (!log_node(&updated)) {
+        free(new_label);
+        free(new_description);
+        free(new_properties);
+        return false;
+    }
+
+    if (label) {
+        free(node->label);
+        node->label = new_label;
+    }
+    if (description) {
+        free(node->description);
+        node->description = new_description;
+    }
+    if (properties) {
+        free(node->properties);
+        node->properties = new_properties;
+    }
+    if (resonance_level >= 0) {
+        node->resonance_level = (NodeLevel)resonance_level;
+    }
+    if (!index_node(slot)) {
+        printf("Failed to re-index knowledge node %llu\n", (unsigned long long)node_id);
+    }
+    maybe_checkpoint();
+    return true;
+}
+
+/**
+ * @brief Delete a knowledge node
+ */
+bool kg_delete_node(uint64_t node_id, bool delete_relations) {
+    if (!kg_initialized) {
+        return false;
+    }
+    uint32_t slot = find_node_slot(node_id);
+    if (slot == KG_NO_SLOT || !refresh_adjacency()) {
+        return false;
+    }
+
+    /* Every relation touching the node is in its forward or reverse entries */
+    const KgAdjacency *sides[2] = { &forward_adjacency, &reverse_adjacency };
+    bool has_relations = false;
+    for (int side = 0; side < 2; side++) {
+        has_relations = has_relations || sides[side]->offsets[slot] != sides[side]->offsets[slot + 1];
+    }
+    if (has_relations && !delete_relations) {
+        printf("Knowledge node %llu still has relations\n", (unsigned long long)node_id);
+        return false;
+    }
+
+    for (int side = 0; side < 2; side++) {
+        for (uint32_t e = sides[side]->offsets[slot]; e < sides[side]->offsets[slot + 1]; e++) {
+            uint32_t relation = sides[side]->edges[e].relation;
+            if (relation_slots[relation].id != 0) {
+                if (!log_delete(KG_RECORD_RELATION, relation_slots[relation].id)) {
+                    return false;
+                }
+                release_relation_slot(relation);
+            }
+        }
+    }
+    if (!log_delete(KG_RECORD_NODE, node_id)) {
+        return false;
+    }
+    release_node_slot(slot);
+    maybe_checkpoint();
+    return true;
+}
+
+/**
+ * @brief Free a knowledge node
+ */
+void kg_free_node(KnowledgeNode *node) {
+    if (!node) {
+        return;
+    }
+    free(node->label);
+    free(node->description);
+    free(node->properties);
+    free(node);
+}
+
+/**
+ * @brief Create a relation between two nodes
+ */
+uint64_t kg_create_relation(uint64_t source_id, uint64_t target_id, MemexRelationType relation_type,
+                           bool bidirectional, float weight, const char *metadata,
+                           NodeLevel resonance_level) {
+    if (!kg_initialized) {
+        return 0;
+    }
+    uint32_t source = find_node_slot(source_id);
+    uint32_t target = find_node_slot(target_id);
+    if (source == KG_NO_SLOT || target == KG_NO_SLOT) {
+        printf("Knowledge relation source or target does not exist\n");
+        return 0;
+    }
+    if (resonance_level > kg_max_resonance) {
+        printf("Knowledge relation resonance %d exceeds the graph maximum %d\n",
+               resonance_level, kg_max_resonance);
+        return 0;
+    }
+
+    char *metadata_copy = NULL;
+    if (!copy_optional(&metadata_copy, metadata)) {
+        return 0;
+    }
+    uint32_t slot = allocate_relation_slot();
+    if (slot == KG_NO_SLOT) {
+        free(metadata_copy);
+        return 0;
+    }
+
+    /* Clamp weight to valid range */
+    if (!(weight >= 0.0f)) weight = 0.0f;
+    if (weight > 1.0f) weight = 1.0f;
+
+    KgRelationSlot *relation = &relation_slots[slot];
+    relation->id = make_id(slot, relation->generation);
+    relation->source = source;
+    relation->target = target;
+    relation->type = relation_type;
+    relation->bidirectional = bidirectional;
+    relation->weight = weight;
+    relation->metadata = metadata_copy;
+    relation->resonance_level = resonance_level;
+    adjacency_stale = true;
+    if (!log_relation(relation)) {
+        release_relation_slot(slot);
+        return 0;
+    }
+    maybe_checkpoint();
+    return relation->id;
+}
+
+/**
+ * @brief Find the shortest path between two nodes
+ *
+ * Bidirectional BFS: each round expands whichever side has the smaller
+ * frontier, forwards over the forward adjacency from the start or
+ * backwards over the reverse adjacency from the end, until the two
+ * searches meet.
+ */
+KnowledgePath *kg_find_path(uint64_t start_node_id, uint64_t end_node_id,
+                          uint32_t max_depth, NodeLevel min_resonance_level) {
+    if (!kg_initialized) {
+        return NULL;
+    }
+    uint32_t start = find_node_slot(start_node_id);
+    uint32_t end = find_node_slot(end_node_id);
+    if (start == KG_NO_SLOT || end == KG_NO_SLOT ||
+        node_slots[start].node.resonance_level < min_resonance_level ||
+        node_slots[end].node.resonance_level < min_resonance_level ||
+        !refresh_adjacency()) {
+        return NULL;
+    }
+    if (max_depth == 0) {
+        max_depth = UINT32_MAX;
+    }
+
+    uint32_t epoch = begin_traversal();
+    uint32_t roots[2] = { start, end };
+    uint32_t *frontiers[2] = { NULL, NULL };
+    uint32_t counts[2] = { 1, 1 };
+    uint32_t depths[2] = { 0, 0 };
+    for (int side = 0; side < 2; side++) {
+        frontiers[side] = (uint32_t *)malloc(sizeof(uint32_t));
+        if (!frontiers[side]) {
+            free(frontiers[0]);
+            return NULL;
+        }
+        frontiers[side][0] = roots[side];
+        atomic_store_explicit(&visits[side].mark[roots[side]], epoch, memory_order_relaxed);
+        visits[side].depth[roots[side]] = 0;
+        visits[side].parent[roots[side]] = (KgEdge){ KG_NO_SLOT, KG_NO_SLOT };
+    }
+
+    uint32_t meet_node = start == end ? start : KG_NO_SLOT;
+    uint32_t meet_length = start == end ? 0 : UINT32_MAX;
+    bool ok = true;
+    while (meet_node == KG_NO_SLOT && counts[0] > 0 && counts[1] > 0 &&
+           depths[0] + depths[1] < max_depth) {
+        int side = counts[0] <= counts[1] ? 0 : 1;
+        KgExpandTask prototype = {
+            .adjacency = side == 0 ? &forward_adjacency : &reverse_adjacency,
+            .visit = &visits[side],
+            .other = &visits[1 - side],
+            .depth = ++depths[side],
+            .epoch = epoch,
+            .min_resonance = min_resonance_level
+        };
+        if (!expand_level(&prototype, &frontiers[side], &counts[side], &meet_node, &meet_length)) {
+            ok = false;
+            break;
+        }
+    }
+    free(frontiers[0]);
+    free(frontiers[1]);
+    if (!ok || meet_node == KG_NO_SLOT) {
+        return NULL;
+    }
+
+    KnowledgePath *path = allocate_path(meet_length);
+    if (!path) {
+        return NULL;
+    }
+
+    /* Forward half: walk parents from the meeting node back to the start */
+    uint32_t index = visits[0].depth[meet_node];
+    uint32_t node = meet_node;
+    path->node_ids[index] = node_slots[node].node.id;
+    while (index > 0) {
+        const KgEdge *parent = &visits[0].parent[node];
+        path->relation_ids[--index] = relation_slots[parent->relation].id;
+        path->relevance *= relation_slots[parent->relation].weight;
+        node = parent->node;
+        path->node_ids[index] = node_slots[node].node.id;
+    }
+
+    /* Backward half: parents lead from the meeting node to the end */
+    index = visits[0].depth[meet_node];
+    node = meet_node;
+    while (index < meet_length) {
+        const KgEdge *parent = &visits[1].parent[node];
+        path->relation_ids[index++] = relation_slots[parent->relation].id;
+        path->relevance *= relation_slots[parent->relation].weight;
+        node = parent->node;
+        path->node_ids[index] = node_slots[node].node.id;
+    }
+    return path;
+}
+
+/**
+ * @brief Whether label a is cheaper than label b
+ */
+static bool label_before(const KgLabel *labels, uint32_t a, uint32_t b) {
+    return labels[a].cost < labels[b].cost;
+}
+
+/**
+ * @brief Find the highest-relevance path between two nodes
+ *
+ * Dijkstra over labels (node, hops) with cost -log(weight), so the
+ * cheapest path maximizes the product of relation weights. With a depth
+ * limit a node can be settled more than once, each time with fewer hops
+ * than before, which keeps the search exact under the limit.
+ */
+KnowledgePath *kg_find_weighted_path(uint64_t start_node_id, uint64_t end_node_id,
+                                   uint32_t max_depth, NodeLevel min_resonance_level) {
+    if (!kg_initialized) {
+        return NULL;
+    }
+    uint32_t start = find_node_slot(start_node_id);
+    uint32_t end = find_node_slot(end_node_id);
+    if (start == KG_NO_SLOT || end == KG_NO_SLOT ||
+        node_slots[start].node.resonance_level < min_resonance_level ||
+        node_slots[end].node.resonance_level < min_resonance_level ||
+        !refresh_adjacency()) {
+        return NULL;
+    }
+    bool limited = max_depth != 0;
+
+    /* Settled hops per node live in the forward visit state */
+    uint32_t epoch = begin_traversal();
+    KgVisit *settled = &visits[0];
+
+    uint32_t label_capacity = 64;
+    uint32_t label_count = 1;
+    uint32_t heap_count = 1;
+    KgLabel *labels = (KgLabel *)malloc(label_capacity * sizeof(KgLabel));
+    uint32_t *heap = (uint32_t *)malloc(label_capacity * sizeof(uint32_t));
+    if (!labels || !heap) {
+        free(labels);
+        free(heap);
+        return NULL;
+    }
+    labels[0] = (KgLabel){ 0.0, start, KG_NO_SLOT, KG_NO_SLOT, 0 };
+    heap[0] = 0;
+
+    uint32_t found = KG_NO_SLOT;
+    bool ok = true;
+    while (heap_count > 0 && found == KG_NO_SLOT) {
+        /* Pop the cheapest label */
+        uint32_t current = heap[0];
+        heap[0] = heap[--heap_count];
+        for (uint32_t i = 0;;) {
+            uint32_t child = 2 * i + 1;
+            if (child >= heap_count) break;
+            if (child + 1 < heap_count && label_before(labels, heap[child + 1], heap[child])) child++;
+            if (!label_before(labels, heap[child], heap[i])) break;
+            uint32_t swap = heap[i];
+            heap[i] = heap[child];
+            heap[child] = swap;
+            i = child;
+        }
+
+        KgLabel label = labels[current];
+        if (visited(settled, label.node, epoch) &&
+            (!limited || settled->depth[label.node] <= label.hops)) {
+            continue; /* Dominated by an earlier label */
+        }
+        atomic_store_explicit(&settled->mark[label.node], epoch, memory_order_relaxed);
+        settled->depth[label.node] = label.hops;
+        if (label.node == end) {
+            found = current;
+            break;
+        }
+        if (limited && label.hops == max_depth) {
+            continue;
+        }
+
+        for (uint32_t e = forward_adjacency.offsets[label.node];
+             e < forward_adjacency.offsets[label.node + 1]; e++) {
+            const KgEdge *edge = &forward_adjacency.edges[e];
+            float weight = relation_slots[edge->relation].weight;
+            if (weight <= 0.0f || !edge_allowed(edge, min_resonance_level) ||
+                (visited(settled, edge->node, epoch) &&
+                 (!limited || settled->depth[edge->node] <= label.hops + 1))) {
+                continue;
+            }
+
+            if (label_count == label_capacity) {
+                label_capacity *= 2;
+                KgLabel *grown_labels = (KgLabel *)realloc(labels, label_capacity * sizeof(KgLabel));
+                if (grown_labels) labels = grown_labels;
+                uint32_t *grown_heap = (uint32_t *)realloc(heap, label_capacity * sizeof(uint32_t));
+                if (grown_heap) heap = grown_heap;
+                if (!grown_labels || !grown_heap) {
+                    ok = false;
+                    break;
+                }
+            }
+            labels[label_count] = (KgLabel){
+                label.cost - log((double)weight), edge->node, edge->relation, current, label.hops + 1
+            };
+
+            /* Push and sift up */
+            uint32_t i = heap_count++;
+            heap[i] = label_count++;
+            while (i > 0 && label_before(labels, heap[i], heap[(i - 1) / 2])) {
+                uint32_t parent = (i - 1) / 2;
+                uint32_t swap = heap[i];
+                heap[i] = heap[parent];
+                heap[parent] = swap;
+                i = parent;
+            }
+        }
+        if (!ok) {
+            break;
+        }
+    }
+    free(heap);
+
+    KnowledgePath *path = ok && found != KG_NO_SLOT ? allocate_path(labels[found].hops) : NULL;
+    if (path) {
+        path->relevance = (float)exp(-labels[found].cost);
+        for (uint32_t label = found; label != KG_NO_SLOT; label = labels[label].parent) {
+            uint32_t hops = labels[label].hops;
+            path->node_ids[hops] = node_slots[labels[label].node].node.id;
+            if (hops > 0) {
+                path->relation_ids[hops - 1] = relation_slots[labels[label].relation].id;
+            }
+        }
+    }
+    free(labels);
+    return path;
+}
+
+/**
+ * @brief Free a knowledge path
+ */
+void kg_free_path(KnowledgePath *path) {
+    /* Node and relation arrays share the path's allocation */
+    free(path);
+}
+
+/**
+ * @brief Find related nodes based on node ID and relation type
+ */
+uint64_t *kg_find_related_nodes(uint64_t node_id, MemexRelationType relation_type,
+                               uint32_t max_nodes, uint32_t *count) {
+    if (count) {
+        *count = 0;
+    }
+    if (!kg_initialized || !count) {
+        return NULL;
+    }
+    uint32_t slot = find_node_slot(node_id);
+    if (slot == KG_NO_SLOT || !refresh_adjacency()) {
+        return NULL;
+    }
+
+    const KgAdjacency *sides[2] = { &forward_adjacency, &reverse_adjacency };
+    uint32_t degree = 0;
+    for (int side = 0; side < 2; side++) {
+        degree += sides[side]->offsets[slot + 1] - sides[side]->offsets[slot];
+    }
+    if (degree == 0) {
+        return NULL;
+    }
+    uint32_t limit = max_nodes > 0 && max_nodes < degree ? max_nodes : degree;
+    uint64_t *related = (uint64_t *)malloc(limit * sizeof(uint64_t));
+    if (!related) {
+        return NULL;
+    }
+
+    /* Mark reported neighbours so several relations report a node once */
+    uint32_t epoch = begin_traversal();
+    atomic_store_explicit(&visits[0].mark[slot], epoch, memory_order_relaxed);
+    uint32_t found = 0;
+    for (int side = 0; side < 2 && found < limit; side++) {
+        for (uint32_t e = sides[side]->offsets[slot];
+             e < sides[side]->offsets[slot + 1] && found < limit; e++) {
+            const KgEdge *edge = &sides[side]->edges[e];
+            if ((relation_type != MEMEX_RELATION_UNDEFINED &&
+                 relation_slots[edge->relation].type != relation_type) ||
+                visited(&visits[0], edge->node, epoch)) {
+                continue;
+            }
+            atomic_store_explicit(&visits[0].mark[edge->node], epoch, memory_order_relaxed);
+            related[found++] = node_slots[edge->node].node.id;
+        }
+    }
+
+    if (found == 0) {
+        free(related);
+        return NULL;
+    }
+    *count = found;
+    return related;
+}
+
+/**
+ * @brief Create a quantum-entangled node pair
+ */
+uint64_t kg_create_entangled_nodes(const char *label1, const char *label2,
+                                  const char *description, NodeLevel resonance_level,
+                                  uint64_t *node1_id, uint64_t *node2_id) {
+    if (!kg_initialized || !kg_enable_quantum) {
+        return 0;
+    }
+
+    uint64_t first = kg_create_node(KG_NODE_QUANTUM, label1, description, NULL, resonance_level);
+    uint64_t second = first ? kg_create_node(KG_NODE_QUANTUM, label2, description, NULL,
+                                             resonance_level) : 0;
+    uint64_t relation = second ? kg_create_relation(first, second, MEMEX_RELATION_ENTANGLED,
+                                                    true, 1.0f, NULL, resonance_level) : 0;
+    if (!relation) {
+        if (second) kg_delete_node(second, true);
+        if (first) kg_delete_node(first, true);
+        return 0;
+    }
+
+    if (node1_id) *node1_id = first;
+    if (node2_id) *node2_id = second;
+    return relation;
+}
+
+/**
+ * @brief Convert a knowledge node to a Memex data item
+ */
+MemexDataItem *kg_node_to_data_item(const KnowledgeNode *node) {
+    if (!node) {
+        return NULL;
+    }
+
+    MemexDataItem *item = (MemexDataItem *)calloc(1, sizeof(MemexDataItem));
+    if (!item) {
+        return NULL;
+    }
+    item->id = node->id;
+    item->type = MEMEX_TYPE_KNOWLEDGE_NODE;
+    item->creation_time = node->creation_time;
+    item->update_time = node->creation_time;
+    item->resonance_level = node->resonance_level;
+    if (!copy_optional(&item->name, node->label) ||
+        !copy_optional((char **)&item->data, node->description) ||
+        !copy_optional(&item->metadata, node->properties)) {
+        memex_free_item(item);
+        return NULL;
+    }
+    item->data_size = node->description ? strlen(node->description) : 0;
+    return item;
+}
+
+/**
+ * @brief Set or clear the embedding of a knowledge node
+ */
+bool kg_set_node_embedding(uint64_t node_id, const float *embedding, uint32_t dimensions) {
+    if (!kg_initialized) {
+        return false;
+    }
+    uint32_t slot = find_node_slot(node_id);
+    if (slot == KG_NO_SLOT || (embedding && dimensions != KG_EMBEDDING_DIMENSIONS)) {
+        return false;
+    }
+
+    float *copy = NULL;
+    if (embedding) {
+        copy = (float *)malloc(KG_EMBEDDING_DIMENSIONS * sizeof(float));
+        if (!copy) {
+            return false;
+        }
+        memcpy(copy, embedding, KG_EMBEDDING_DIMENSIONS * sizeof(float));
+    }
+
+    /* Indexing rejects vectors with no direction before anything is logged */
+    KgNodeSlot *entry = &node_slots[slot];
+    float *previous = entry->embedding;
+    entry->embedding = copy;
+    if (!index_node(slot) || !log_embedding(entry)) {
+        entry->embedding = previous;
+        free(copy);
+        index_node(slot);
+        return false;
+    }
+    free(previous);
+    maybe_checkpoint();
+    return true;
+}
+
+/**
+ * @brief Find the nodes most similar to a query across the whole graph
+ */
+uint64_t *kg_find_similar_nodes(const char *query_text, const float *embedding,
+                               NodeLevel min_resonance_level, uint32_t type_mask,
+                               uint32_t max_results, uint32_t *count) {
+    if (count) {
+        *count = 0;
+    }
+    if (!kg_initialized || !count || max_results == 0) {
+        return NULL;
+    }
+
+    float query[KG_EMBEDDING_DIMENSIONS];
+    if (!embedding) {
+        size_t length = query_text ? strlen(query_text) : 0;
+        if (!vindex_embed_text(&query_text, &length, 1, query, KG_EMBEDDING_DIMENSIONS)) {
+            return NULL;
+        }
+        embedding = query;
+    }
+
+    VectorMatch *matches = (VectorMatch *)malloc(max_results * sizeof(VectorMatch));
+    uint64_t *results = (uint64_t *)malloc(max_results * sizeof(uint64_t));
+    if (!matches || !results) {
+        free(matches);
+        free(results);
+        return NULL;
+    }
+    VectorFilter filter = { (uint32_t)min_resonance_level, type_mask };
+    uint32_t ef = max_results > KG_SIMILARITY_EF ? max_results : KG_SIMILARITY_EF;
+    uint32_t found = vindex_search(kg_vectors, embedding, max_results, ef, &filter, matches);
+
+    /* Only nodes with positive cosine similarity count as similar */
+    uint32_t result_count = 0;
+    while (result_count < found && matches[result_count].distance < 1.0f) {
+        results[result_count] = matches[result_count].id;
+        result_count++;
+    }
+    free(matches);
+    if (result_count == 0) {
+        free(results);
+        return NULL;
+    }
+    *count = result_count;
+    return results;
+}
+
+/**
+ * @brief Perform semantic reasoning on the knowledge graph
+ *
+ * Walks up to KG_REASONING_DEPTH relations out from the start node and
+ * ranks the nodes reached by the cosine similarity of their embedding to
+ * the query's text embedding, scaled by the product of relation weights
+ * along the way. Nodes with no positive similarity are dropped. With no
+ * query words, nodes rank by that product alone.
+ */
+uint64_t *kg_semantic_reasoning(uint64_t start_node_id, const char *query_text,
+                               uint32_t max_results, uint32_t *count) {
+    if (count) {
+        *count = 0;
+    }
+    if (!kg_initialized || !count || max_results == 0) {
+        return NULL;
+    }
+    uint32_t start = find_node_slot(start_node_id);
+    if (start == KG_NO_SLOT || !refresh_adjacency()) {
+        return NULL;
+    }
+
+    float query[KG_EMBEDDING_DIMENSIONS];
+    size_t query_length = query_text ? strlen(query_text) : 0;
+    bool has_query = vindex_embed_text(&query_text, &query_length, 1, query, KG_EMBEDDING_DIMENSIONS);
+
+    /* Breadth-first walk recording the strength of the path to each node */
+    uint32_t epoch = begin_traversal();
+    uint32_t *frontier = (uint32_t *)malloc(sizeof(uint32_t));
+    uint32_t frontier_count = 1;
+    uint32_t reached_capacity = 64;
+    uint32_t reached_count = 0;
+    uint32_t *reached = (uint32_t *)malloc(reached_capacity * sizeof(uint32_t));
+    if (!frontier || !reached) {
+        free(frontier);
+        free(reached);
+        return NULL;
+    }
+    frontier[0] = start;
+    atomic_store_explicit(&visits[0].mark[start], epoch, memory_order_relaxed);
+    reach_strength[start] = 1.0f;
+
+    bool ok = true;
+    for (uint32_t depth = 1; depth <= KG_REASONING_DEPTH && frontier_count > 0 && ok; depth++) {
+        KgExpandTask prototype = {
+            .adjacency = &forward_adjacency,
+            .visit = &visits[0],
+            .other = NULL,
+            .depth = depth,
+            .epoch = epoch,
+            .min_resonance = NODE_ZERO_POINT
+        };
+        uint32_t unused_node = KG_NO_SLOT;
+        uint32_t unused_length = UINT32_MAX;
+        ok = expand_level(&prototype, &frontier, &frontier_count, &unused_node, &unused_length);
+        for (uint32_t i = 0; ok && i < frontier_count; i++) {
+            uint32_t node = frontier[i];
+            const KgEdge *parent = &visits[0].parent[node];
+            reach_strength[node] = reach_strength[parent->node] *
+                                   relation_slots[parent->relation].weight;
+            if (reached_count == reached_capacity) {
+                reached_capacity *= 2;
+                uint32_t *grown = (uint32_t *)realloc(reached, reached_capacity * sizeof(uint32_t));
+                if (!grown) {
+                    ok = false;
+                    break;
+                }
+                reached = grown;
+            }
+            reached[reached_count++] = node;
+        }
+    }
+    free(frontier);
+
+    /* Score reached nodes, reusing reach_strength for the final score */
+    uint32_t scored = 0;
+    for (uint32_t i = 0; ok && i < reached_count; i++) {
+        float similarity = 1.0f;
+        if (has_query) {
+            float distance = 1.0f;
+            vindex_distance_to(kg_vectors, query, node_slots[reached[i]].node.id, &distance);
+            similarity = distance < 1.0f ? 1.0f - distance : 0.0f;
+        }
+        reach_strength[reached[i]] *= similarity;
+        if (reach_strength[reached[i]] > 0.0f) {
+            reached[scored++] = reached[i];
+        }
+    }
+
+    /* Partial selection sort of the best max_results */
+    uint32_t result_count = scored < max_results ? scored : max_results;
+    if (!ok) {
+        result_count = 0;
+    }
+    uint64_t *results = result_count > 0 ? (uint64_t *)malloc(result_count * sizeof(uint64_t)) : NULL;
+    for (uint32_t i = 0; results && i < result_count; i++) {
+        uint32_t best = i;
+        for (uint32_t j = i + 1; j < scored; j++) {
+            if (reach_strength[reached[j]] > reach_strength[reached[best]]) {
+                best = j;
+            }
+        }
+        uint32_t swap = reached[i];
+        reached[i] = reached[best];
+        reached[best] = swap;
+        results[i] = node_slots[reached[i]].node.id;
+    }
+    free(reached);
+
+    if (results) {
+        *count = result_count;
+    }
+    return results;
+}
@@ -15,6 +15,11 @@
 #include "../interface/memex_interface.h"
 #include "../../quantum/resonance/resonant_frequencies.h"
 
+/**
+ * @brief Length of knowledge node embeddings
+ */
+#define KG_EMBEDDING_DIMENSIONS 256
+
 /**
  * @brief Knowledge node types
  */
@@ -53,7 +58,10 @@ typedef struct {
 /**
  * @brief Initialize the Knowledge Graph component
  * 
- * @param data_directory Data directory for storage
+ * When data_directory is set, the graph is loaded from and persisted to
+ * knowledge_graph.snap / knowledge_graph.wal in that directory.
+ *
+ * @param data_directory Data directory for storage (NULL to keep the graph in memory only)
  * @param enable_quantum Whether to enable quantum operations
  * @param max_resonance Maximum resonance level
  * @return true if initialization succeeded, false otherwise
@@ -65,6 +73,15 @@ bool kg_init(const char *data_directory, bool enable_quantum, NodeLevel max_reso
  */
 void kg_shutdown(void);
 
+/**
+ * @brief Write a compacted snapshot of the graph and empty its log
+ *
+ * Runs automatically once the log outgrows the snapshot, and on shutdown.
+ *
+ * @return true on success (or when the graph is not persisted), false otherwise
+ */
+bool kg_checkpoint(void);
+
 /**
  * @brief Create a new knowledge node
  * 
@@ -134,15 +151,34 @@ uint64_t kg_create_relation(uint64_t source_id, uint64_t target_id, MemexRelatio
 /**
  * @brief Find the shortest path between two nodes
  * 
+ * Shortest means fewest relations. Relations are followed from source to
+ * target, and in both directions if bidirectional. The path's relevance
+ * is the product of its relation weights.
+ * 
  * @param start_node_id Start node ID
  * @param end_node_id End node ID
- * @param max_depth Maximum path depth to search
+ * @param max_depth Maximum path depth to search (0 for no limit)
  * @param min_resonance_level Minimum resonance level for nodes and relations
  * @return Path structure (must be freed with kg_free_path) or NULL if no path found
  */
 KnowledgePath *kg_find_path(uint64_t start_node_id, uint64_t end_node_id, 
                           uint32_t max_depth, NodeLevel min_resonance_level);
 
+/**
+ * @brief Find the highest-relevance path between two nodes
+ * 
+ * Like kg_find_path, but picks the path whose product of relation
+ * weights is largest. Relations with weight 0 are not followed.
+ * 
+ * @param start_node_id Start node ID
+ * @param end_node_id End node ID
+ * @param max_depth Maximum path depth to search (0 for no limit)
+ * @param min_resonance_level Minimum resonance level for nodes and relations
+ * @return Path structure (must be freed with kg_free_path) or NULL if no path found
+ */
+KnowledgePath *kg_find_weighted_path(uint64_t start_node_id, uint64_t end_node_id,
+                                   uint32_t max_depth, NodeLevel min_resonance_level);
+
 /**
  * @brief Free a knowledge path
  * 
@@ -185,9 +221,46 @@ uint64_t kg_create_entangled_nodes(const char *label1, const char *label2,
  */
 MemexDataItem *kg_node_to_data_item(const KnowledgeNode *node);
 
+/**
+ * @brief Set or clear the embedding of a knowledge node
+ * 
+ * By default a node is embedded by hashing the words of its label,
+ * description and properties. A set embedding (e.g. from a language
+ * model) replaces that until it is cleared, and is persisted with the
+ * node.
+ * 
+ * @param node_id Node ID
+ * @param embedding KG_EMBEDDING_DIMENSIONS floats, or NULL to go back to the text embedding
+ * @param dimensions Length of embedding (must be KG_EMBEDDING_DIMENSIONS)
+ * @return true on success, false if the node does not exist or the embedding is invalid
+ */
+bool kg_set_node_embedding(uint64_t node_id, const float *embedding, uint32_t dimensions);
+
+/**
+ * @brief Find the nodes most similar to a query across the whole graph
+ * 
+ * An approximate nearest-neighbor search over node embeddings by cosine
+ * similarity. Only nodes with positive similarity are returned.
+ * 
+ * @param query_text Query text, embedded like node text (ignored if embedding is set)
+ * @param embedding Query embedding of KG_EMBEDDING_DIMENSIONS floats (NULL to use query_text)
+ * @param min_resonance_level Minimum resonance level of returned nodes
+ * @param type_mask Bit (1 << KnowledgeNodeType) per accepted node type, 0 for all
+ * @param max_results Maximum number of results
+ * @param count Pointer to store the number of results
+ * @return Array of node IDs, most similar first (must be freed by caller), or NULL if none found
+ */
+uint64_t *kg_find_similar_nodes(const char *query_text, const float *embedding,
+                               NodeLevel min_resonance_level, uint32_t type_mask,
+                               uint32_t max_results, uint32_t *count);
+
 /**
  * @brief Perform semantic reasoning on the knowledge graph
  * 
+ * Nodes reachable within a few relations of the start node are ranked by
+ * the similarity of their embedding to the query's, scaled by the weights
+ * of the relations leading to them.
+ * 
  * @param start_node_id Starting node ID
  * @param query_text Natural language query
  * @param max_results Maximum number of results
@@ -4,13 +4,34 @@
  *
  * This file implements the Memex Knowledge Networking integration with CTRLxT OS,
  * combined with quantum entanglement principles.
+ *
+ * The registries are split into shards by slot, each behind its own
+ * reader-writer lock. A node lives in the shard its ID maps to and a
+ * relation in its source node's shard, so writers touching different
+ * shards do not contend and readers only exclude writers of their shard.
  */
 
+/* strdup, clock_gettime and pthread_rwlock_t under -std=c11 */
+#define _XOPEN_SOURCE 700
+
 #include "knowledge_network.h"
+#include "../search/search_engine.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+/**
+ * @brief Adjacency entry for one relation incident to a node
+ */
+typedef struct {
+    uint32_t relation_slot;            /**< Relation registry slot */
+    uint32_t neighbor_slot;            /**< Node registry slot of the other end */
+    KnowledgeRelationType type;        /**< Relation type */
+    bool outgoing;                     /**< Whether this node is the source */
+} KnowledgeEdge;
 
 /**
  * @brief Internal knowledge node structure
@@ -21,7 +42,10 @@ typedef struct {
     void *private_data;                /**< Private implementation data */
     uint64_t create_time;              /**< Creation timestamp */
     uint64_t update_time;              /**< Last update timestamp */
-    uint32_t access_count;             /**< Access counter */
+    _Atomic uint32_t access_count;     /**< Access counter, bumped by readers */
+    KnowledgeEdge *edges;              /**< Incident relations, in creation order */
+    uint32_t edge_count;               /**< Number of incident relations */
+    uint32_t edge_capacity;            /**< Allocated adjacency entries */
 } KnowledgeNodeInternal;
 
 /**
@@ -35,29 +59,173 @@ typedef struct {
     uint32_t traverse_count;           /**< Traversal counter */
 } KnowledgeRelationInternal;
 
+/* Registry slot s belongs to shard s % KNOWLEDGE_SHARD_COUNT */
+#define KNOWLEDGE_SHARD_COUNT 16
+
+/**
+ * @brief One shard of the node and relation registries
+ *
+ * The lock guards the shard's registry slots and its ID index.
+ */
+typedef struct {
+    pthread_rwlock_t lock;             /**< Shard lock */
+    int32_t *node_index;               /**< Open-addressing node ID -> slot (-1 marks an empty bucket) */
+    uint32_t node_index_mask;          /**< Bucket mask */
+} KnowledgeShard;
+
 /* Static variables */
 static KnowledgeNodeInternal *node_registry = NULL;
 static KnowledgeRelationInternal *relation_registry = NULL;
 static uint32_t max_nodes = 1000;          // Default max nodes
-static uint32_t active_nodes = 0;
+static _Atomic uint32_t active_nodes = 0;
 static uint32_t max_relations = 5000;      // Default max relations
-static uint32_t active_relations = 0;
-static uint64_t next_node_id = 1;
-static uint64_t next_relation_id = 1;
+static _Atomic uint32_t active_relations = 0;
+static _Atomic uint64_t next_node_id = 1;
+static _Atomic uint64_t next_relation_id = 1;
 static bool use_quantum_by_default = false;
 static bool is_initialized = false;
+static KnowledgeShard knowledge_shards[KNOWLEDGE_SHARD_COUNT];
+
+/**
+ * @brief Allocate an empty ID index with room for capacity entries
+ * 
+ * @param capacity Maximum number of entries
+ * @param mask Pointer to store the bucket mask
+ * @return Bucket array, or NULL if allocation failed
+ */
+static int32_t *create_id_index(uint32_t capacity, uint32_t *mask) {
+    // Keep the load factor at or below one half
+    uint32_t buckets = 16;
+    while (buckets < capacity * 2) {
+        buckets *= 2;
+    }
+    
+    int32_t *index = (int32_t*)malloc(buckets * sizeof(int32_t));
+    if (index == NULL) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < buckets; i++) {
+        index[i] = -1;
+    }
+    *mask = buckets - 1;
+    return index;
+}
+
+/**
+ * @brief First bucket to probe for an ID
+ */
+static uint32_t id_bucket(uint64_t id, uint32_t mask) {
+    return (uint32_t)((id * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+}
+
+/**
+ * @brief Record an ID's slot in an ID index
+ * 
+ * Node IDs are never reused and nodes are never removed, so plain linear
+ * probing needs no tombstones.
+ */
+static void id_index_insert(int32_t *index, uint32_t mask, uint64_t id, int32_t slot) {
+    uint32_t bucket = id_bucket(id, mask);
+    while (index[bucket] >= 0) {
+        bucket = (bucket + 1) & mask;
+    }
+    index[bucket] = slot;
+}
+
+/**
+ * @brief Ensure a node has room for more relations
+ * 
+ * Grows both the adjacency list and the public related_nodes array.
+ * 
+ * @param node Node to grow
+ * @param extra Number of relations about to be added
+ * @return true if that many can be appended, false on allocation failure
+ */
+static bool reserve_links(KnowledgeNodeInternal *node, uint32_t extra) {
+    if (node->edge_count + extra > node->edge_capacity) {
+        uint32_t capacity = node->edge_capacity ? node->edge_capacity * 2 : 4;
+        if (capacity < node->edge_count + extra) {
+            capacity = node->edge_count + extra;
+        }
+        KnowledgeEdge *edges = (KnowledgeEdge*)realloc(node->edges, capacity * sizeof(KnowledgeEdge));
+        if (edges == NULL) {
+            return false;
+        }
+        node->edges = edges;
+        node->edge_capacity = capacity;
+    }
+    
+    uint64_t *related = (uint64_t*)realloc(node->public_data.related_nodes,
+        (node->public_data.related_node_count + extra) * sizeof(uint64_t));
+    if (related == NULL) {
+        return false;
+    }
+    node->public_data.related_nodes = related;
+    return true;
+}
+
+/**
+ * @brief Index a relation under both of its nodes, which have room reserved
+ */
+static void link_relation(uint32_t slot, uint32_t source_slot, uint32_t target_slot) {
+    const KnowledgeRelationInternal *relation = &relation_registry[slot];
+    KnowledgeNodeInternal *source_node = &node_registry[source_slot];
+    KnowledgeNodeInternal *target_node = &node_registry[target_slot];
+    KnowledgeRelationType type = relation->public_data.type;
+    
+    source_node->edges[source_node->edge_count++] = (KnowledgeEdge){
+        slot, target_slot, type, true
+    };
+    target_node->edges[target_node->edge_count++] = (KnowledgeEdge){
+        slot, source_slot, type, false
+    };
+    
+    // Both ends list each other (for bidirectional access)
+    source_node->public_data.related_nodes[source_node->public_data.related_node_count++] =
+        target_node->public_data.id;
+    target_node->public_data.related_nodes[target_node->public_data.related_node_count++] =
+        source_node->public_data.id;
+    source_node->update_time = relation->create_time;
+    target_node->update_time = relation->create_time;
+}
+
+/**
+ * @brief Shard a node ID maps to
+ */
+static uint32_t node_shard(uint64_t node_id) {
+    return (uint32_t)((node_id - 1) % KNOWLEDGE_SHARD_COUNT);
+}
 
 /**
- * @brief Get available slot in node registry
+ * @brief Write-lock every shard, ascending
+ */
+static void lock_all_shards(void) {
+    for (uint32_t k = 0; k < KNOWLEDGE_SHARD_COUNT; k++) {
+        pthread_rwlock_wrlock(&knowledge_shards[k].lock);
+    }
+}
+
+/**
+ * @brief Unlock shards locked with lock_all_shards()
+ */
+static void unlock_all_shards(void) {
+    for (uint32_t k = KNOWLEDGE_SHARD_COUNT; k-- > 0;) {
+        pthread_rwlock_unlock(&knowledge_shards[k].lock);
+    }
+}
+
+/**
+ * @brief Get available slot in a shard of the node registry
  * 
+ * @param shard Shard index (the caller holds its write lock)
  * @return Index of available slot, or -1 if none available
  */
-static int32_t get_available_node_slot() {
+static int32_t get_available_node_slot(uint32_t shard) {
     if (!is_initialized || node_registry == NULL) {
         return -1;
     }
     
-    for (uint32_t i = 0; i < max_nodes; i++) {
+    for (uint32_t i = shard; i < max_nodes; i += KNOWLEDGE_SHARD_COUNT) {
         if (!node_registry[i].is_active) {
             return i;
         }
@@ -67,16 +235,17 @@ static int32_t get_available_node_slot() {
 }
 
 /**
- * @brief Get available slot in relation registry
+ * @brief Get available slot in a shard of the relation registry
  * 
+ * @param shard Shard index (the caller holds its write lock)
  * @return Index of available slot, or -1 if none available
  */
-static int32_t get_available_relation_slot() {
+static int32_t get_available_relation_slot(uint32_t shard) {
     if (!is_initialized || relation_registry == NULL) {
         return -1;
     }
     
-    for (uint32_t i = 0; i < max_relations; i++) {
+    for (uint32_t i = shard; i < max_relations; i += KNOWLEDGE_SHARD_COUNT) {
         if (!relation_registry[i].is_active) {
             return i;
         }
@@ -88,18 +257,22 @@ static int32_t get_available_relation_slot() {
 /**
  * @brief Find a node in the registry by ID
  * 
- * @param node_id Node ID to find
+ * @param node_id Node ID to find (the caller holds its shard's lock)
  * @return Index in registry, or -1 if not found
  */
 static int32_t find_node(uint64_t node_id) {
-    if (!is_initialized || node_registry == NULL) {
+    if (!is_initialized || node_registry == NULL || node_id == 0) {
         return -1;
     }
     
-    for (uint32_t i = 0; i < max_nodes; i++) {
-        if (node_registry[i].is_active && 
-            node_registry[i].public_data.id == node_id) {
-            return i;
+    const KnowledgeShard *shard = &knowledge_shards[node_shard(node_id)];
+    for (uint32_t bucket = id_bucket(node_id, shard->node_index_mask);
+         shard->node_index[bucket] >= 0;
+         bucket = (bucket + 1) & shard->node_index_mask) {
+        int32_t slot = shard->node_index[bucket];
+        if (node_registry[slot].is_active && 
+            node_registry[slot].public_data.id == node_id) {
+            return slot;
         }
     }
     
@@ -130,7 +303,7 @@ static int32_t find_relation(uint64_t relation_id) {
 /**
  * @brief Check if a relation exists between two nodes
  * 
- * @param source_id Source node ID
+ * @param source_id Source node ID (the caller holds its shard's lock)
  * @param target_id Target node ID
  * @param relation_type Relation type (-1 for any type)
  * @return Relation ID if exists, 0 otherwise
@@ -140,22 +313,131 @@ static uint64_t relation_exists(uint64_t source_id, uint64_t target_id, int rela
         return 0;
     }
     
-    for (uint32_t i = 0; i < max_relations; i++) {
-        if (relation_registry[i].is_active && 
-            relation_registry[i].public_data.source_node_id == source_id &&
-            relation_registry[i].public_data.target_node_id == target_id) {
-            
-            // Check relation type if specified
-            if (relation_type < 0 || 
-                relation_registry[i].public_data.type == (KnowledgeRelationType)relation_type) {
-                return relation_registry[i].public_data.id;
-            }
+    int32_t source_slot = find_node(source_id);
+    if (source_slot < 0) {
+        return 0;
+    }
+    
+    // Only the source's own relations can match
+    const KnowledgeNodeInternal *source = &node_registry[source_slot];
+    for (uint32_t i = 0; i < source->edge_count; i++) {
+        const KnowledgeEdge *edge = &source->edges[i];
+        if (edge->outgoing &&
+            node_registry[edge->neighbor_slot].public_data.id == target_id &&
+            (relation_type < 0 || edge->type == (KnowledgeRelationType)relation_type)) {
+            return relation_registry[edge->relation_slot].public_data.id;
         }
     }
     
     return 0; // Not found
 }
 
+/**
+ * @brief Create the memory entanglement of a node or relation
+ * 
+ * @param address Address of the entangled data
+ * @param qubits Number of qubits to use
+ * @return Entanglement, or NULL if none was created
+ */
+static EntanglementId *create_entanglement(uint64_t address, uint32_t qubits) {
+    EntanglementId entanglement = qem_create_entanglement(
+        ENTANGLE_MEMORY,
+        address,
+        0,  // No target yet
+        qubits
+    );
+    
+    // Store entanglement if successful
+    if (!entanglement.is_active) {
+        return NULL;
+    }
+    EntanglementId *stored = (EntanglementId*)malloc(sizeof(EntanglementId));
+    if (stored != NULL) {
+        *stored = entanglement;
+    }
+    return stored;
+}
+
+/**
+ * @brief Fill in and activate a free node slot
+ * 
+ * @param node Free registry slot (the caller holds its shard's write lock)
+ * @return true on success, false if memory allocation failed
+ */
+static bool init_node(KnowledgeNodeInternal *node, uint64_t node_id, KnowledgeNodeType type,
+                      const char *name, const char *description, bool use_quantum) {
+    // Set basic properties
+    node->public_data.id = node_id;
+    node->public_data.type = type;
+    
+    // Copy name
+    node->public_data.name = strdup(name);
+    if (node->public_data.name == NULL) {
+        return false;
+    }
+    
+    // Copy description if provided
+    if (description != NULL) {
+        node->public_data.description = strdup(description);
+        if (node->public_data.description == NULL) {
+            // Free name if description allocation fails
+            free(node->public_data.name);
+            return false;
+        }
+    } else {
+        node->public_data.description = NULL;
+    }
+    
+    // Initialize related nodes array (empty)
+    node->public_data.related_nodes = NULL;
+    node->public_data.related_node_count = 0;
+    
+    // Set up quantum entanglement if requested (4 qubits per node)
+    node->public_data.entanglement = use_quantum ?
+        create_entanglement((uint64_t)&node->public_data, 4) : NULL;
+    
+    // Set tracking data
+    node->is_active = true;
+    node->private_data = NULL; // No private data yet
+    node->create_time = (uint64_t)time(NULL);
+    node->update_time = node->create_time;
+    node->access_count = 0;
+    node->edges = NULL;
+    node->edge_count = 0;
+    node->edge_capacity = 0;
+    return true;
+}
+
+/**
+ * @brief Fill in and activate a free relation slot
+ * 
+ * @param relation Free registry slot (the caller holds its shard's write lock)
+ */
+static void init_relation(KnowledgeRelationInternal *relation, KnowledgeRelationType type,
+                          uint64_t source_node_id, uint64_t target_node_id,
+                          float strength, bool use_quantum) {
+    // Set basic properties
+    relation->public_data.id = atomic_fetch_add(&next_relation_id, 1);
+    relation->public_data.type = type;
+    relation->public_data.source_node_id = source_node_id;
+    relation->public_data.target_node_id = target_node_id;
+    
+    // Clamp strength to valid range
+    if (strength < 0.0f) strength = 0.0f;
+    if (strength > 1.0f) strength = 1.0f;
+    relation->public_data.strength = strength;
+    
+    // Set up quantum entanglement if requested (2 qubits per relation)
+    relation->public_data.entanglement = use_quantum ?
+        create_entanglement((uint64_t)&relation->public_data, 2) : NULL;
+    
+    // Set tracking data
+    relation->is_active = true;
+    relation->create_time = (uint64_t)time(NULL);
+    relation->update_time = relation->create_time;
+    relation->traverse_count = 0;
+}
+
 /**
  * @brief Initialize the Memex Knowledge Network integration
  * 
@@ -182,6 +464,24 @@ bool memex_knowledge_init(bool use_quantum) {
         return false;
     }
     
+    // Allocate each shard's node ID index
+    for (uint32_t k = 0; k < KNOWLEDGE_SHARD_COUNT; k++) {
+        uint32_t capacity = max_nodes / KNOWLEDGE_SHARD_COUNT + 1;
+        knowledge_shards[k].node_index = create_id_index(capacity, &knowledge_shards[k].node_index_mask);
+        if (knowledge_shards[k].node_index == NULL) {
+            while (k-- > 0) {
+                free(knowledge_shards[k].node_index);
+                knowledge_shards[k].node_index = NULL;
+            }
+            free(node_registry);
+            free(relation_registry);
+            node_registry = NULL;
+            relation_registry = NULL;
+            return false;
+        }
+        pthread_rwlock_init(&knowledge_shards[k].lock, NULL);
+    }
+    
     // Initialize registries
     for (uint32_t i = 0; i < max_nodes; i++) {
         node_registry[i].is_active = false;
@@ -229,75 +529,35 @@ KnowledgeNode memex_knowledge_create_node(KnowledgeNodeType type,
         return empty_node;
     }
     
+    // IDs are handed out in turn, which spreads nodes across the shards
+    uint64_t node_id = atomic_fetch_add(&next_node_id, 1);
+    KnowledgeShard *shard = &knowledge_shards[node_shard(node_id)];
+    pthread_rwlock_wrlock(&shard->lock);
+    
     // Get available slot
-    int32_t slot = get_available_node_slot();
+    int32_t slot = get_available_node_slot(node_shard(node_id));
     if (slot < 0) {
+        pthread_rwlock_unlock(&shard->lock);
         return empty_node; // No slots available
     }
     
     // Initialize node
     KnowledgeNodeInternal *node = &node_registry[slot];
-    
-    // Set basic properties
-    node->public_data.id = next_node_id++;
-    node->public_data.type = type;
-    
-    // Copy name
-    node->public_data.name = strdup(name);
-    if (node->public_data.name == NULL) {
+    if (!init_node(node, node_id, type, name, description, use_quantum)) {
+        pthread_rwlock_unlock(&shard->lock);
         return empty_node; // Memory allocation failed
     }
+    id_index_insert(shard->node_index, shard->node_index_mask, node->public_data.id, slot);
+    KnowledgeNode created = node->public_data;
+    pthread_rwlock_unlock(&shard->lock);
     
-    // Copy description if provided
-    if (description != NULL) {
-        node->public_data.description = strdup(description);
-        if (node->public_data.description == NULL) {
-            // Free name if description allocation fails
-            free(node->public_data.name);
-            return empty_node;
-        }
-    } else {
-        node->public_data.description = NULL;
-    }
-    
-    // Initialize related nodes array (empty)
-    node->public_data.related_nodes = NULL;
-    node->public_data.related_node_count = 0;
-    
-    // Set up quantum entanglement if requested
-    if (use_quantum) {
-        // Create a node entanglement
-        EntanglementId entanglement = qem_create_entanglement(
-            ENTANGLE_MEMORY,
-            (uint64_t)&node->public_data,
-            0,  // No target yet
-            4    // Use 4 qubits
-        );
-        
-        // Store entanglement if successful
-        if (entanglement.is_active) {
-            node->public_data.entanglement = (EntanglementId*)malloc(sizeof(EntanglementId));
-            if (node->public_data.entanglement != NULL) {
-                *node->public_data.entanglement = entanglement;
-            }
-        } else {
-            node->public_data.entanglement = NULL;
-        }
-    } else {
-        node->public_data.entanglement = NULL;
-    }
-    
-    // Set tracking data
-    node->is_active = true;
-    node->private_data = NULL; // No private data yet
-    node->create_time = (uint64_t)time(NULL);
-    node->update_time = node->create_time;
-    node->access_count = 0;
+    // Offer the label for autocomplete
+    memex_search_add_suggestion(created.name);
     
     // Increment active nodes count
-    active_nodes++;
+    atomic_fetch_add(&active_nodes, 1);
     
-    return node->public_data;
+    return created;
 }
 
 /**
@@ -328,101 +588,353 @@ KnowledgeRelation memex_knowledge_create_relation(KnowledgeRelationType type,
         return empty_relation;
     }
     
+    // Lock both nodes' shards, lower first; the relation lives in the source's
+    uint32_t source_shard = node_shard(source_node_id);
+    uint32_t target_shard = node_shard(target_node_id);
+    pthread_rwlock_t *first = &knowledge_shards[source_shard < target_shard ? source_shard : target_shard].lock;
+    pthread_rwlock_t *second = &knowledge_shards[source_shard < target_shard ? target_shard : source_shard].lock;
+    pthread_rwlock_wrlock(first);
+    if (second != first) {
+        pthread_rwlock_wrlock(second);
+    }
+    
     // Ensure both nodes exist
     int32_t source_slot = find_node(source_node_id);
     int32_t target_slot = find_node(target_node_id);
-    if (source_slot < 0 || target_slot < 0) {
-        return empty_relation; // One or both nodes don't exist
+    int32_t slot = -1;
+    if (source_slot >= 0 && target_slot >= 0 &&
+        !relation_exists(source_node_id, target_node_id, type)) {
+        slot = get_available_relation_slot(source_shard);
     }
     
-    // Check if relation already exists
-    if (relation_exists(source_node_id, target_node_id, type)) {
-        return empty_relation; // Relation already exists
+    // Make room in both adjacency lists up front so indexing cannot fail
+    KnowledgeNodeInternal *source_node = source_slot >= 0 ? &node_registry[source_slot] : NULL;
+    KnowledgeNodeInternal *target_node = target_slot >= 0 ? &node_registry[target_slot] : NULL;
+    if (slot < 0 || !reserve_links(source_node, 1) || !reserve_links(target_node, 1)) {
+        // Missing node, existing relation, no free slot or no memory
+        if (second != first) {
+            pthread_rwlock_unlock(second);
+        }
+        pthread_rwlock_unlock(first);
+        return empty_relation;
     }
     
-    // Get available slot
-    int32_t slot = get_available_relation_slot();
-    if (slot < 0) {
-        return empty_relation; // No slots available
+    // Initialize relation and index it under both nodes
+    KnowledgeRelationInternal *relation = &relation_registry[slot];
+    init_relation(relation, type, source_node_id, target_node_id, strength, use_quantum);
+    link_relation((uint32_t)slot, (uint32_t)source_slot, (uint32_t)target_slot);
+    
+    KnowledgeRelation created = relation->public_data;
+    if (second != first) {
+        pthread_rwlock_unlock(second);
     }
+    pthread_rwlock_unlock(first);
     
-    // Initialize relation
-    KnowledgeRelationInternal *relation = &relation_registry[slot];
+    // Increment active relations count
+    atomic_fetch_add(&active_relations, 1);
     
-    // Set basic properties
-    relation->public_data.id = next_relation_id++;
-    relation->public_data.type = type;
-    relation->public_data.source_node_id = source_node_id;
-    relation->public_data.target_node_id = target_node_id;
+    return created;
+}
+
+/**
+ * @brief Microseconds on the monotonic clock
+ */
+static uint64_t monotonic_microseconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000ULL + (uint64_t)now.tv_nsec / 1000;
+}
+
+/**
+ * @brief Fill in the elapsed time and throughput of a bulk ingest
+ */
+static void finish_ingest(KnowledgeIngestStats *totals, uint64_t start_time, KnowledgeIngestStats *stats) {
+    totals->elapsed_us = monotonic_microseconds() - start_time;
+    totals->per_second = totals->elapsed_us > 0 ? totals->submitted * 1e6 / (double)totals->elapsed_us : 0.0;
+    if (stats != NULL) {
+        *stats = *totals;
+    }
+}
+
+/**
+ * @brief FNV-1a over a string, with NULL distinct from empty
+ */
+static uint64_t hash_text(uint64_t hash, const char *text) {
+    if (text == NULL) {
+        return (hash ^ 0xFF) * 0x100000001B3ULL;
+    }
+    for (const unsigned char *c = (const unsigned char *)text; ; c++) {
+        hash = (hash ^ *c) * 0x100000001B3ULL;
+        if (*c == '\0') {
+            return hash;
+        }
+    }
+}
+
+/**
+ * @brief Whether two node specs have the same type, name and description
+ */
+static bool node_specs_equal(const KnowledgeNodeSpec *a, const KnowledgeNodeSpec *b) {
+    return a->type == b->type && strcmp(a->name, b->name) == 0 &&
+           (a->description == b->description ||
+            (a->description != NULL && b->description != NULL && strcmp(a->description, b->description) == 0));
+}
+
+/**
+ * @brief First bucket to probe for a relation's ends and type
+ */
+static uint32_t relation_bucket(uint64_t source_id, uint64_t target_id, KnowledgeRelationType type,
+                                uint32_t mask) {
+    return id_bucket(source_id ^ (target_id * 0xC2B2AE3D27D4EB4FULL) ^ ((uint64_t)type << 56), mask);
+}
+
+/**
+ * @brief Create a batch of knowledge nodes
+ */
+uint32_t memex_knowledge_create_nodes(const KnowledgeNodeSpec *nodes, uint32_t count,
+                                      uint64_t *ids, KnowledgeIngestStats *stats) {
+    uint64_t start_time = monotonic_microseconds();
+    KnowledgeIngestStats totals = { count, 0, 0, 0, 0, 0.0 };
+    if (ids != NULL && count > 0) {
+        memset(ids, 0, count * sizeof(uint64_t));
+    }
     
-    // Clamp strength to valid range
-    if (strength < 0.0f) strength = 0.0f;
-    if (strength > 1.0f) strength = 1.0f;
-    relation->public_data.strength = strength;
+    uint32_t mask = 0;
+    int32_t *unique = NULL;
+    int32_t *first = NULL;
+    if (!is_initialized || nodes == NULL || count == 0 || count > (uint32_t)INT32_MAX / 2 ||
+        (unique = create_id_index(count, &mask)) == NULL ||
+        (first = (int32_t*)malloc(count * sizeof(int32_t))) == NULL) {
+        free(unique);
+        totals.rejected = count;
+        finish_ingest(&totals, start_time, stats);
+        return 0;
+    }
     
-    // Set up quantum entanglement if requested
-    if (use_quantum) {
-        // Create a relation entanglement
-        EntanglementId entanglement = qem_create_entanglement(
-            ENTANGLE_MEMORY,
-            (uint64_t)&relation->public_data,
-            0,  // No target yet
-            2    // Use 2 qubits
-        );
-        
-        // Store entanglement if successful
-        if (entanglement.is_active) {
-            relation->public_data.entanglement = (EntanglementId*)malloc(sizeof(EntanglementId));
-            if (relation->public_data.entanglement != NULL) {
-                *relation->public_data.entanglement = entanglement;
-            }
-        } else {
-            relation->public_data.entanglement = NULL;
+    // Find repeats before taking any lock
+    uint32_t unique_count = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (nodes[i].name == NULL) {
+            first[i] = -1;
+            totals.rejected++;
+            continue;
         }
-    } else {
-        relation->public_data.entanglement = NULL;
+        uint64_t hash = hash_text(hash_text(0xCBF29CE484222325ULL ^ nodes[i].type, nodes[i].name),
+                                  nodes[i].description);
+        uint32_t bucket = (uint32_t)(hash >> 32) & mask;
+        while (unique[bucket] >= 0 && !node_specs_equal(&nodes[unique[bucket]], &nodes[i])) {
+            bucket = (bucket + 1) & mask;
+        }
+        if (unique[bucket] >= 0) {
+            first[i] = unique[bucket];
+            totals.duplicates++;
+            continue;
+        }
+        unique[bucket] = (int32_t)i;
+        first[i] = (int32_t)i;
+        unique_count++;
     }
+    free(unique);
     
-    // Set tracking data
-    relation->is_active = true;
-    relation->create_time = (uint64_t)time(NULL);
-    relation->update_time = relation->create_time;
-    relation->traverse_count = 0;
+    // One block of IDs for the batch; each shard's free slots are walked once
+    uint64_t node_id = atomic_fetch_add(&next_node_id, unique_count);
+    uint32_t cursors[KNOWLEDGE_SHARD_COUNT];
+    for (uint32_t k = 0; k < KNOWLEDGE_SHARD_COUNT; k++) {
+        cursors[k] = k;
+    }
+    lock_all_shards();
+    for (uint32_t i = 0; i < count; i++) {
+        if (first[i] != (int32_t)i) {
+            continue;
+        }
+        uint64_t id = node_id++;
+        uint32_t k = node_shard(id);
+        while (cursors[k] < max_nodes && node_registry[cursors[k]].is_active) {
+            cursors[k] += KNOWLEDGE_SHARD_COUNT;
+        }
+        if (cursors[k] >= max_nodes ||
+            !init_node(&node_registry[cursors[k]], id, nodes[i].type, nodes[i].name,
+                       nodes[i].description, nodes[i].use_quantum)) {
+            first[i] = -1;
+            totals.rejected++;
+            continue;
+        }
+        id_index_insert(knowledge_shards[k].node_index, knowledge_shards[k].node_index_mask, id,
+                        (int32_t)cursors[k]);
+        if (ids != NULL) {
+            ids[i] = id;
+        }
+        totals.created++;
+    }
+    unlock_all_shards();
+    
+    // Offer the labels for autocomplete; repeats report the node they repeat
+    for (uint32_t i = 0; i < count; i++) {
+        if (first[i] == (int32_t)i) {
+            memex_search_add_suggestion(nodes[i].name);
+        } else if (first[i] >= 0 && ids != NULL) {
+            ids[i] = ids[first[i]];
+        }
+    }
+    free(first);
+    atomic_fetch_add(&active_nodes, totals.created);
     
-    // Update the related_nodes arrays in both nodes
-    KnowledgeNodeInternal *source_node = &node_registry[source_slot];
-    KnowledgeNodeInternal *target_node = &node_registry[target_slot];
+    finish_ingest(&totals, start_time, stats);
+    return totals.created;
+}
+
+/**
+ * @brief Create a batch of relations between knowledge nodes
+ */
+uint32_t memex_knowledge_create_relations(const KnowledgeRelationSpec *relations, uint32_t count,
+                                          uint64_t *ids, KnowledgeIngestStats *stats) {
+    uint64_t start_time = monotonic_microseconds();
+    KnowledgeIngestStats totals = { count, 0, 0, 0, 0, 0.0 };
+    if (ids != NULL && count > 0) {
+        memset(ids, 0, count * sizeof(uint64_t));
+    }
+    
+    int32_t *ends = NULL;
+    uint32_t *additions = NULL;
+    bool *seeded = NULL;
+    if (!is_initialized || relations == NULL || count == 0 || count > (uint32_t)INT32_MAX / 4 ||
+        (ends = (int32_t*)malloc(count * 3 * sizeof(int32_t))) == NULL ||
+        (additions = (uint32_t*)calloc(max_nodes, sizeof(uint32_t))) == NULL ||
+        (seeded = (bool*)calloc(max_nodes, sizeof(bool))) == NULL) {
+        free(ends);
+        free(additions);
+        totals.rejected = count;
+        finish_ingest(&totals, start_time, stats);
+        return 0;
+    }
     
-    // Update source node's related_nodes array
-    uint32_t new_count = source_node->public_data.related_node_count + 1;
-    uint64_t *new_related = (uint64_t*)realloc(
-        source_node->public_data.related_nodes,
-        new_count * sizeof(uint64_t));
+    // ends holds the source, target and relation slot of each entry (-1 once dropped)
+    lock_all_shards();
+    uint32_t capacity = count;
+    for (uint32_t i = 0; i < count; i++) {
+        const KnowledgeRelationSpec *spec = &relations[i];
+        int32_t *entry = &ends[i * 3];
+        entry[0] = entry[1] = entry[2] = -1;
+        if (spec->source_node_id == 0 || spec->target_node_id == 0 ||
+            spec->source_node_id == spec->target_node_id) {
+            continue;
+        }
+        entry[0] = find_node(spec->source_node_id);
+        entry[1] = find_node(spec->target_node_id);
+        if (entry[0] >= 0 && entry[1] >= 0 && !seeded[entry[0]]) {
+            seeded[entry[0]] = true;
+            capacity += node_registry[entry[0]].edge_count;
+        }
+    }
+    
+    // Index what the batch's sources already have, so repeats cost one probe
+    uint32_t mask = 0;
+    int32_t *index = capacity <= (uint32_t)INT32_MAX / 2 ? create_id_index(capacity, &mask) : NULL;
+    for (uint32_t n = 0; index != NULL && n < max_nodes; n++) {
+        const KnowledgeNodeInternal *node = &node_registry[n];
+        for (uint32_t e = 0; seeded[n] && e < node->edge_count; e++) {
+            const KnowledgeEdge *edge = &node->edges[e];
+            if (edge->outgoing) {
+                uint32_t bucket = relation_bucket(node->public_data.id,
+                                                  node_registry[edge->neighbor_slot].public_data.id,
+                                                  edge->type, mask);
+                while (index[bucket] >= 0) {
+                    bucket = (bucket + 1) & mask;
+                }
+                index[bucket] = (int32_t)edge->relation_slot;
+            }
+        }
+    }
+    
+    // Store the relations; adjacency is appended afterwards
+    uint32_t cursors[KNOWLEDGE_SHARD_COUNT];
+    for (uint32_t k = 0; k < KNOWLEDGE_SHARD_COUNT; k++) {
+        cursors[k] = k;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        const KnowledgeRelationSpec *spec = &relations[i];
+        int32_t *entry = &ends[i * 3];
+        if (index == NULL || entry[0] < 0 || entry[1] < 0) {
+            entry[0] = -1;
+            totals.rejected++;
+            continue;
+        }
         
-    if (new_related != NULL) {
-        new_related[source_node->public_data.related_node_count] = target_node_id;
-        source_node->public_data.related_nodes = new_related;
-        source_node->public_data.related_node_count = new_count;
-        source_node->update_time = relation->create_time;
-    }
-    
-    // Update target node's related_nodes array (for bidirectional access)
-    new_count = target_node->public_data.related_node_count + 1;
-    new_related = (uint64_t*)realloc(
-        target_node->public_data.related_nodes,
-        new_count * sizeof(uint64_t));
+        uint32_t bucket = relation_bucket(spec->source_node_id, spec->target_node_id, spec->type, mask);
+        while (index[bucket] >= 0) {
+            const KnowledgeRelation *existing = &relation_registry[index[bucket]].public_data;
+            if (existing->source_node_id == spec->source_node_id &&
+                existing->target_node_id == spec->target_node_id && existing->type == spec->type) {
+                break;
+            }
+            bucket = (bucket + 1) & mask;
+        }
+        if (index[bucket] >= 0) {
+            if (ids != NULL) {
+                ids[i] = relation_registry[index[bucket]].public_data.id;
+            }
+            entry[0] = -1;
+            totals.duplicates++;
+            continue;
+        }
         
-    if (new_related != NULL) {
-        new_related[target_node->public_data.related_node_count] = source_node_id;
-        target_node->public_data.related_nodes = new_related;
-        target_node->public_data.related_node_count = new_count;
-        target_node->update_time = relation->create_time;
+        // Relations live in their source's shard
+        uint32_t k = node_shard(spec->source_node_id);
+        while (cursors[k] < max_relations && relation_registry[cursors[k]].is_active) {
+            cursors[k] += KNOWLEDGE_SHARD_COUNT;
+        }
+        if (cursors[k] >= max_relations) {
+            entry[0] = -1;
+            totals.rejected++;
+            continue;
+        }
+        init_relation(&relation_registry[cursors[k]], spec->type, spec->source_node_id,
+                      spec->target_node_id, spec->strength, spec->use_quantum);
+        index[bucket] = (int32_t)cursors[k];
+        entry[2] = (int32_t)cursors[k];
+        additions[entry[0]]++;
+        additions[entry[1]]++;
+        totals.created++;
     }
     
-    // Increment active relations count
-    active_relations++;
+    // Grow each node's arrays once; relations on a node that cannot grow are dropped
+    for (uint32_t n = 0; n < max_nodes; n++) {
+        if (additions[n] > 0 && !reserve_links(&node_registry[n], additions[n])) {
+            seeded[n] = false;
+            additions[n] = UINT32_MAX;
+        }
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        const int32_t *entry = &ends[i * 3];
+        if (entry[0] < 0) {
+            continue;
+        }
+        KnowledgeRelationInternal *relation = &relation_registry[entry[2]];
+        if (additions[entry[0]] == UINT32_MAX || additions[entry[1]] == UINT32_MAX) {
+            if (relation->public_data.entanglement != NULL) {
+                qem_destroy_entanglement(relation->public_data.entanglement->id);
+                free(relation->public_data.entanglement);
+            }
+            relation->is_active = false;
+            totals.created--;
+            totals.rejected++;
+            continue;
+        }
+        link_relation((uint32_t)entry[2], (uint32_t)entry[0], (uint32_t)entry[1]);
+        if (ids != NULL) {
+            ids[i] = relation->public_data.id;
+        }
+    }
+    unlock_all_shards();
+    
+    free(index);
+    free(ends);
+    free(additions);
+    free(seeded);
+    atomic_fetch_add(&active_relations, totals.created);
     
-    return relation->public_data;
+    finish_ingest(&totals, start_time, stats);
+    return totals.created;
 }
 
 /**
@@ -454,9 +966,14 @@ KnowledgeNode *memex_knowledge_find_nodes(const char *query,
     
     uint32_t found_count = 0;
     
-    // Simple substring search in node names and descriptions
-    for (uint32_t i = 0; i < max_nodes && found_count < max_results; i++) {
-        if (node_registry[i].is_active) {
+    // Simple substring search in node names and descriptions, a shard at a time
+    for (uint32_t k = 0; k < KNOWLEDGE_SHARD_COUNT && found_count < max_results; k++) {
+        pthread_rwlock_rdlock(&knowledge_shards[k].lock);
+        for (uint32_t i = k; i < max_nodes && found_count < max_results; i += KNOWLEDGE_SHARD_COUNT) {
+            if (!node_registry[i].is_active) {
+                continue;
+            }
+            
             bool match = false;
             
             // Check name
@@ -476,11 +993,16 @@ KnowledgeNode *memex_knowledge_find_nodes(const char *query,
                 results[found_count] = node_registry[i].public_data;
                 
                 // Update node access count
-                node_registry[i].access_count++;
-                
+                atomic_fetch_add(&node_registry[i].access_count, 1);
                 found_count++;
             }
         }
+        pthread_rwlock_unlock(&knowledge_shards[k].lock);
+    }
+    
+    // Names never change, so the copies can be boosted unlocked
+    for (uint32_t i = 0; i < found_count; i++) {
+        memex_search_boost_suggestion(results[i].name, 1);
     }
     
     // Set result count
@@ -526,9 +1048,12 @@ KnowledgeNode *memex_knowledge_get_related(uint64_t node_id,
         return NULL;
     }
     
-    // Find the source node
+    // Copy the node's relations under its shard lock
+    KnowledgeShard *shard = &knowledge_shards[node_shard(node_id)];
+    pthread_rwlock_rdlock(&shard->lock);
     int32_t node_slot = find_node(node_id);
     if (node_slot < 0) {
+        pthread_rwlock_unlock(&shard->lock);
         return NULL; // Node not found
     }
     
@@ -536,54 +1061,55 @@ KnowledgeNode *memex_knowledge_get_related(uint64_t node_id,
     KnowledgeNodeInternal *node = &node_registry[node_slot];
     
     // If node has no relations, return NULL
-    if (node->public_data.related_node_count == 0) {
-        return NULL;
+    uint32_t edge_count = node->edge_count;
+    KnowledgeEdge *edges = edge_count ? (KnowledgeEdge*)malloc(edge_count * sizeof(KnowledgeEdge)) : NULL;
+    if (edges != NULL) {
+        memcpy(edges, node->edges, edge_count * sizeof(KnowledgeEdge));
     }
     
     // Update access count
-    node->access_count++;
+    atomic_fetch_add(&node->access_count, 1);
+    const char *name = node->public_data.name;
+    pthread_rwlock_unlock(&shard->lock);
+    if (edges == NULL) {
+        return NULL;
+    }
+    memex_search_boost_suggestion(name, 1);
     
     // Allocate array for results
     KnowledgeNode *results = (KnowledgeNode*)malloc(max_results * sizeof(KnowledgeNode));
     if (results == NULL) {
+        free(edges);
         return NULL; // Memory allocation failed
     }
     
     uint32_t found_count = 0;
     
-    // Iterate through the node's related nodes
-    for (uint32_t i = 0; i < node->public_data.related_node_count && found_count < max_results; i++) {
-        uint64_t related_id = node->public_data.related_nodes[i];
+    // Walk the node's relations in either direction; nodes are never
+    // removed, so each neighbor is read under its own shard lock alone
+    for (uint32_t i = 0; i < edge_count && found_count < max_results; i++) {
+        const KnowledgeEdge *edge = &edges[i];
         
-        // Check if there's a relation of the requested type
-        bool include = (relation_type < 0); // Include all types if relation_type is -1
-        
-        if (!include) {
-            // Check if relation of specified type exists
-            uint64_t relation_id = relation_exists(node_id, related_id, relation_type);
-            include = (relation_id != 0);
-            
-            // If not found in one direction, try the other direction
-            if (!include) {
-                relation_id = relation_exists(related_id, node_id, relation_type);
-                include = (relation_id != 0);
-            }
+        // Include all types if relation_type is -1
+        if (relation_type >= 0 && edge->type != (KnowledgeRelationType)relation_type) {
+            continue;
         }
         
-        if (include) {
-            // Find the related node
-            int32_t related_slot = find_node(related_id);
-            if (related_slot >= 0) {
-                // Copy node data to results
-                results[found_count] = node_registry[related_slot].public_data;
-                
-                // Update node access count
-                node_registry[related_slot].access_count++;
-                
-                found_count++;
-            }
-        }
+        KnowledgeNodeInternal *related = &node_registry[edge->neighbor_slot];
+        pthread_rwlock_t *lock = &knowledge_shards[edge->neighbor_slot % KNOWLEDGE_SHARD_COUNT].lock;
+        
+        // Copy node data to results
+        pthread_rwlock_rdlock(lock);
+        results[found_count] = related->public_data;
+        pthread_rwlock_unlock(lock);
+        
+        // Update node access count
+        atomic_fetch_add(&related->access_count, 1);
+        memex_search_boost_suggestion(results[found_count].name, 1);
+        
+        found_count++;
     }
+    free(edges);
     
     // Set result count
     *result_count = found_count;
@@ -618,6 +1144,7 @@ void memex_knowledge_shutdown(void) {
         if (node_registry[i].is_active) {
             // Free name
             if (node_registry[i].public_data.name != NULL) {
+                memex_search_remove_suggestion(node_registry[i].public_data.name);
                 free(node_registry[i].public_data.name);
             }
             
@@ -626,10 +1153,11 @@ void memex_knowledge_shutdown(void) {
                 free(node_registry[i].public_data.description);
             }
             
-            // Free related nodes array
+            // Free related nodes array and adjacency
             if (node_registry[i].public_data.related_nodes != NULL) {
                 free(node_registry[i].public_data.related_nodes);
             }
+            free(node_registry[i].edges);
             
             // Destroy entanglement
             if (node_registry[i].public_data.entanglement != NULL) {
@@ -662,6 +1190,11 @@ void memex_knowledge_shutdown(void) {
     // Free registries
     free(node_registry);
     free(relation_registry);
+    for (uint32_t k = 0; k < KNOWLEDGE_SHARD_COUNT; k++) {
+        free(knowledge_shards[k].node_index);
+        knowledge_shards[k].node_index = NULL;
+        pthread_rwlock_destroy(&knowledge_shards[k].lock);
+    }
     
     // Reset state
     node_registry = NULL;
@@ -4,6 +4,9 @@
  *
  * This file defines the interface for integrating Memex's knowledge networking
  * capabilities with CTRLxT OS, combined with quantum entanglement principles.
+ *
+ * Between memex_knowledge_init() and memex_knowledge_shutdown() the
+ * functions may be called from any thread.
  */
 
 #ifndef CTRLXT_MEMEX_KNOWLEDGE_H
@@ -60,6 +63,39 @@ typedef struct {
     EntanglementId *entanglement;    /**< Quantum entanglement (if applicable) */
 } KnowledgeRelation;
 
+/**
+ * @brief Knowledge node to create in a batch
+ */
+typedef struct {
+    KnowledgeNodeType type;       /**< Type of node */
+    const char *name;             /**< Node name */
+    const char *description;      /**< Node description (may be NULL) */
+    bool use_quantum;             /**< Whether to create quantum entanglement */
+} KnowledgeNodeSpec;
+
+/**
+ * @brief Knowledge relation to create in a batch
+ */
+typedef struct {
+    KnowledgeRelationType type;      /**< Type of relation */
+    uint64_t source_node_id;         /**< Source node ID */
+    uint64_t target_node_id;         /**< Target node ID */
+    float strength;                  /**< Relation strength (0.0 to 1.0) */
+    bool use_quantum;                /**< Whether to create quantum entanglement */
+} KnowledgeRelationSpec;
+
+/**
+ * @brief Knowledge network bulk ingest statistics
+ */
+typedef struct {
+    uint32_t submitted;              /**< Entries passed in */
+    uint32_t created;                /**< Entries newly created */
+    uint32_t duplicates;             /**< Entries skipped as repeats */
+    uint32_t rejected;               /**< Entries that were invalid or could not be created */
+    uint64_t elapsed_us;             /**< Wall time in microseconds */
+    double per_second;               /**< Entries submitted per second */
+} KnowledgeIngestStats;
+
 /**
  * @brief Initialize the Memex Knowledge Network integration
  * 
@@ -98,6 +134,41 @@ KnowledgeRelation memex_knowledge_create_relation(KnowledgeRelationType type,
                                                 float strength,
                                                 bool use_quantum);
 
+/**
+ * @brief Create a batch of knowledge nodes
+ * 
+ * A node with the same type, name and description as an earlier one in
+ * the batch is created once. Free slots are found in a single pass over
+ * the registry; other writers wait meanwhile.
+ * 
+ * @param nodes Nodes to create
+ * @param count Number of nodes
+ * @param ids Array of count entries to store each node's ID (or the ID
+ *            of the node it repeats; 0 if rejected), or NULL
+ * @param stats Pointer to store the statistics, or NULL
+ * @return Number of nodes newly created
+ */
+uint32_t memex_knowledge_create_nodes(const KnowledgeNodeSpec *nodes, uint32_t count,
+                                      uint64_t *ids, KnowledgeIngestStats *stats);
+
+/**
+ * @brief Create a batch of relations between knowledge nodes
+ * 
+ * As with memex_knowledge_create_relation(), a relation with the same
+ * source, target and type as an existing one is skipped; repeats are
+ * found through a hash index rather than per-relation scans, and each
+ * node's relation arrays grow once for the batch.
+ * 
+ * @param relations Relations to create
+ * @param count Number of relations
+ * @param ids Array of count entries to store each relation's ID (or the
+ *            ID of the relation it repeats; 0 if rejected), or NULL
+ * @param stats Pointer to store the statistics, or NULL
+ * @return Number of relations newly created
+ */
+uint32_t memex_knowledge_create_relations(const KnowledgeRelationSpec *relations, uint32_t count,
+                                          uint64_t *ids, KnowledgeIngestStats *stats);
+
 /**
  * @brief Find knowledge nodes matching a query
  * 
@@ -0,0 +1,290 @@
+/**
+ * @file result_cache.c
+ * @brief Bounded LRU cache of query results
+ *
+ * Entries hang off a chained hash table for lookup and a doubly-linked
+ * list in recency order for eviction. Each entry is one allocation
+ * holding its key bytes followed by its value bytes, and is charged its
+ * full size against the budget.
+ */
+
+#include "result_cache.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define RCACHE_INITIAL_BUCKETS 64
+
+/**
+ * @brief Cached entry; key and value bytes follow the header
+ */
+typedef struct ResultCacheEntry {
+    struct ResultCacheEntry *chain;    /**< Next entry in the bucket */
+    struct ResultCacheEntry *newer;    /**< Toward the most recently used */
+    struct ResultCacheEntry *older;    /**< Toward the least recently used */
+    uint64_t hash;                     /**< Key hash */
+    size_t key_size;                   /**< Key bytes */
+    size_t value_size;                 /**< Value bytes */
+    unsigned char bytes[];             /**< Key, then value */
+} ResultCacheEntry;
+
+/**
+ * @brief Cache state
+ */
+struct ResultCache {
+    ResultCacheEntry **buckets;        /**< Hash chains */
+    uint32_t bucket_count;             /**< Power of two */
+    ResultCacheEntry *newest;          /**< Most recently used */
+    ResultCacheEntry *oldest;          /**< Least recently used */
+    ResultCacheStats stats;            /**< Counters and occupancy */
+};
+
+/**
+ * @brief FNV-1a over key bytes
+ */
+static uint64_t hash_key(const void *key, size_t size) {
+    const unsigned char *bytes = (const unsigned char *)key;
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Bytes an entry is charged
+ */
+static size_t entry_cost(const ResultCacheEntry *entry) {
+    return sizeof(ResultCacheEntry) + entry->key_size + entry->value_size;
+}
+
+/**
+ * @brief Find the chain link pointing at an entry with the given key
+ */
+static ResultCacheEntry **find_link(ResultCache *cache, const void *key, size_t key_size,
+                                    uint64_t hash) {
+    ResultCacheEntry **link = &cache->buckets[hash & (cache->bucket_count - 1)];
+    while (*link && ((*link)->hash != hash || (*link)->key_size != key_size ||
+                     memcmp((*link)->bytes, key, key_size) != 0)) {
+        link = &(*link)->chain;
+    }
+    return link;
+}
+
+/**
+ * @brief Take an entry off the recency list
+ */
+static void unlink_recency(ResultCache *cache, ResultCacheEntry *entry) {
+    if (entry->newer) {
+        entry->newer->older = entry->older;
+    } else {
+        cache->newest = entry->older;
+    }
+    if (entry->older) {
+        entry->older->newer = entry->newer;
+    } else {
+        cache->oldest = entry->newer;
+    }
+}
+
+/**
+ * @brief Put an entry at the most recently used end
+ */
+static void push_newest(ResultCache *cache, ResultCacheEntry *entry) {
+    entry->newer = NULL;
+    entry->older = cache->newest;
+    if (cache->newest) {
+        cache->newest->newer = entry;
+    } else {
+        cache->oldest = entry;
+    }
+    cache->newest = entry;
+}
+
+/**
+ * @brief Unlink and free the entry a chain link points at
+ */
+static void remove_entry(ResultCache *cache, ResultCacheEntry **link) {
+    ResultCacheEntry *entry = *link;
+    *link = entry->chain;
+    unlink_recency(cache, entry);
+    cache->stats.entries--;
+    cache->stats.bytes -= entry_cost(entry);
+    free(entry);
+}
+
+/**
+ * @brief Evict the least recently used entry
+ */
+static void evict_oldest(ResultCache *cache) {
+    ResultCacheEntry *entry = cache->oldest;
+    ResultCacheEntry **link = &cache->buckets[entry->hash & (cache->bucket_count - 1)];
+    while (*link != entry) {
+        link = &(*link)->chain;
+    }
+    remove_entry(cache, link);
+    cache->stats.evictions++;
+}
+
+/**
+ * @brief Double the bucket table once chains get long
+ */
+static void grow_buckets(ResultCache *cache) {
+    uint32_t count = cache->bucket_count * 2;
+    ResultCacheEntry **buckets = (ResultCacheEntry **)calloc(count, sizeof(ResultCacheEntry *));
+    if (!buckets) {
+        return;
+    }
+    for (uint32_t i = 0; i < cache->bucket_count; i++) {
+        ResultCacheEntry *entry = cache->buckets[i];
+        while (entry) {
+            ResultCacheEntry *next = entry->chain;
+            entry->chain = buckets[entry->hash & (count - 1)];
+            buckets[entry->hash & (count - 1)] = entry;
+            entry = next;
+        }
+    }
+    free(cache->buckets);
+    cache->buckets = buckets;
+    cache->bucket_count = count;
+}
+
+/**
+ * @brief Create a cache
+ */
+ResultCache *rcache_create(size_t capacity) {
+    ResultCache *cache = (ResultCache *)calloc(1, sizeof(ResultCache));
+    if (!cache) {
+        return NULL;
+    }
+    cache->buckets = (ResultCacheEntry **)calloc(RCACHE_INITIAL_BUCKETS, sizeof(ResultCacheEntry *));
+    if (!cache->buckets) {
+        free(cache);
+        return NULL;
+    }
+    cache->bucket_count = RCACHE_INITIAL_BUCKETS;
+    cache->stats.capacity = capacity;
+    return cache;
+}
+
+/**
+ * @brief Destroy a cache
+ */
+void rcache_destroy(ResultCache *cache) {
+    if (!cache) {
+        return;
+    }
+    rcache_clear(cache);
+    free(cache->buckets);
+    free(cache);
+}
+
+/**
+ * @brief Look up a value and mark it most recently used
+ */
+const void *rcache_lookup(ResultCache *cache, const void *key, size_t key_size,
+                          ResultCacheValidator validator, void *context, size_t *size) {
+    if (!cache || !key || !size) {
+        return NULL;
+    }
+
+    ResultCacheEntry **link = find_link(cache, key, key_size, hash_key(key, key_size));
+    ResultCacheEntry *entry = *link;
+    if (!entry) {
+        cache->stats.misses++;
+        return NULL;
+    }
+    const void *value = entry->bytes + entry->key_size;
+    if (validator && !validator(value, entry->value_size, context)) {
+        remove_entry(cache, link);
+        cache->stats.invalidations++;
+        cache->stats.misses++;
+        return NULL;
+    }
+
+    unlink_recency(cache, entry);
+    push_newest(cache, entry);
+    cache->stats.hits++;
+    *size = entry->value_size;
+    return value;
+}
+
+/**
+ * @brief Insert or replace a value, evicting older entries to make room
+ */
+bool rcache_store(ResultCache *cache, const void *key, size_t key_size,
+                  const void *value, size_t size) {
+    if (!cache || !key || (!value && size > 0)) {
+        return false;
+    }
+    size_t cost = sizeof(ResultCacheEntry) + key_size + size;
+    if (key_size > cache->stats.capacity || size > cache->stats.capacity ||
+        cost > cache->stats.capacity) {
+        return false;
+    }
+
+    uint64_t hash = hash_key(key, key_size);
+    ResultCacheEntry **link = find_link(cache, key, key_size, hash);
+    if (*link) {
+        remove_entry(cache, link);
+    }
+    while (cache->stats.bytes + cost > cache->stats.capacity) {
+        evict_oldest(cache);
+    }
+
+    ResultCacheEntry *entry = (ResultCacheEntry *)malloc(cost);
+    if (!entry) {
+        return false;
+    }
+    entry->hash = hash;
+    entry->key_size = key_size;
+    entry->value_size = size;
+    memcpy(entry->bytes, key, key_size);
+    if (size > 0) {
+        memcpy(entry->bytes + key_size, value, size);
+    }
+
+    if (cache->stats.entries >= cache->bucket_count) {
+        grow_buckets(cache);
+    }
+    ResultCacheEntry **bucket = &cache->buckets[hash & (cache->bucket_count - 1)];
+    entry->chain = *bucket;
+    *bucket = entry;
+    push_newest(cache, entry);
+    cache->stats.entries++;
+    cache->stats.bytes += cost;
+    return true;
+}
+
+/**
+ * @brief Drop every entry
+ */
+void rcache_clear(ResultCache *cache) {
+    if (!cache) {
+        return;
+    }
+    ResultCacheEntry *entry = cache->newest;
+    while (entry) {
+        ResultCacheEntry *older = entry->older;
+        free(entry);
+        entry = older;
+    }
+    memset(cache->buckets, 0, cache->bucket_count * sizeof(ResultCacheEntry *));
+    cache->newest = NULL;
+    cache->oldest = NULL;
+    cache->stats.entries = 0;
+    cache->stats.bytes = 0;
+}
+
+/**
+ * @brief Read the cache statistics
+ */
+void rcache_get_stats(const ResultCache *cache, ResultCacheStats *stats) {
+    if (!stats) {
+        return;
+    }
+    if (!cache) {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+    *stats = cache->stats;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file result_cache.h
+ * @brief Bounded LRU cache of query results
+ *
+ * Maps opaque key bytes to opaque value bytes within a byte budget,
+ * evicting the least recently used entries first. The cache does not
+ * know what makes a value stale; lookups take a validator that the
+ * owner uses to check the version stamps it encoded into the value, and
+ * entries that fail it are dropped.
+ *
+ * A cache is not thread-safe; callers serialize access.
+ */
+
+#ifndef CTRLXT_MEMEX_RESULT_CACHE_H
+#define CTRLXT_MEMEX_RESULT_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Opaque cache handle
+ */
+typedef struct ResultCache ResultCache;
+
+/**
+ * @brief Cache statistics
+ */
+typedef struct {
+    uint64_t hits;             /**< Lookups answered from the cache */
+    uint64_t misses;           /**< Lookups that found nothing usable */
+    uint64_t invalidations;    /**< Entries dropped because the validator rejected them */
+    uint64_t evictions;        /**< Entries dropped to stay within the budget */
+    uint32_t entries;          /**< Entries currently cached */
+    size_t bytes;              /**< Bytes currently charged, including entry overhead */
+    size_t capacity;           /**< Byte budget */
+} ResultCacheStats;
+
+/**
+ * @brief Validator called on a found entry before it is returned
+ *
+ * @param value Cached value
+ * @param size Value size in bytes
+ * @param context Validator context
+ * @return true if the value is still current
+ */
+typedef bool (*ResultCacheValidator)(const void *value, size_t size, void *context);
+
+/**
+ * @brief Create a cache
+ *
+ * @param capacity Byte budget (0 disables caching)
+ * @return Cache, or NULL on allocation failure
+ */
+ResultCache *rcache_create(size_t capacity);
+
+/**
+ * @brief Destroy a cache
+ *
+ * @param cache Cache (may be NULL)
+ */
+void rcache_destroy(ResultCache *cache);
+
+/**
+ * @brief Look up a value and mark it most recently used
+ *
+ * @param cache Cache
+ * @param key Key bytes
+ * @param key_size Key size
+ * @param validator Validator (NULL to accept any found value)
+ * @param context Validator context
+ * @param size Pointer to store the value size
+ * @return Value, valid until the cache next changes, or NULL on a miss
+ */
+const void *rcache_lookup(ResultCache *cache, const void *key, size_t key_size,
+                          ResultCacheValidator validator, void *context, size_t *size);
+
+/**
+ * @brief Insert or replace a value, evicting older entries to make room
+ *
+ * @param cache Cache
+ * @param key Key bytes
+ * @param key_size Key size
+ * @param value Value bytes
+ * @param size Value size
+ * @return true if stored, false if the entry exceeds the whole budget or
+ *         allocation failed
+ */
+bool rcache_store(ResultCache *cache, const void *key, size_t key_size,
+                  const void *value, size_t size);
+
+/**
+ * @brief Drop every entry (statistics are kept)
+ *
+ * @param cache Cache
+ */
+void rcache_clear(ResultCache *cache);
+
+/**
+ * @brief Read the cache statistics
+ *
+ * @param cache Cache
+ * @param stats Pointer to store the statistics
+ */
+void rcache_get_stats(const ResultCache *cache, ResultCacheStats *stats);
+
+#endif /* CTRLXT_MEMEX_RESULT_CACHE_H */
@@ -0,0 +1,1602 @@
+/**
+ * @file search_engine.c
+ * @brief Implementation of the Memex Search Engine
+ *
+ * Documents are tokenized into lowercase terms and kept in an inverted
+ * index. Each term's posting list is a byte stream of variable-length
+ * (document delta, term frequency) pairs in document order, so indexing
+ * only ever appends. Queries are scored with BM25 one document at a time
+ * across all query terms, and the best hits are kept in a bounded min-heap.
+ *
+ * Updates and removals leave dead postings behind; once they outnumber the
+ * live ones the posting lists are compacted in place.
+ *
+ * Autocomplete suggestions come from a separate radix trie of phrases
+ * (document titles and knowledge node labels), kept up to date as they are
+ * added and removed.
+ *
+ * One reader-writer lock guards the index and the trie: queries and
+ * suggestion lookups share it, changes take it exclusively.
+ */
+
+/* strdup and pthread_rwlock_t under -std=c11 */
+#define _XOPEN_SOURCE 700
+
+#include "search_engine.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+
+#define SEARCH_MAX_TERM_LENGTH  64      /**< Longer tokens are truncated */
+#define SEARCH_MAX_QUERY_TERMS  32      /**< Further query terms are ignored */
+#define SEARCH_COMPACT_MIN      1024    /**< Dead postings tolerated before compacting */
+#define SEARCH_BM25_K1          1.2f
+#define SEARCH_BM25_B           0.75f
+#define SEARCH_NO_DOCUMENT      UINT32_MAX
+
+/**
+ * @brief Indexed term
+ */
+typedef struct {
+    char *text;                    /**< Term text */
+    uint32_t document_frequency;   /**< Live documents containing the term */
+    uint32_t posting_count;        /**< Postings in the list, live or dead */
+    uint32_t last_document;        /**< Document of the last posting */
+    uint8_t *postings;             /**< Encoded posting list */
+    uint32_t postings_size;        /**< Bytes used */
+    uint32_t postings_capacity;    /**< Bytes allocated */
+} SearchTerm;
+
+/**
+ * @brief Indexed document
+ *
+ * Documents are numbered in indexing order; the number is what posting
+ * lists refer to. Replacing a document gives it a new number.
+ */
+typedef struct {
+    uint64_t id;                   /**< Document identifier */
+    char *title;                   /**< Copy of the title */
+    SearchResultType type;         /**< Result type */
+    uint32_t resonance_level;      /**< Resonance level */
+    bool is_quantum_entangled;     /**< Whether the document is entangled */
+    bool live;                     /**< False once replaced or removed */
+    uint32_t length;               /**< Number of tokens */
+    uint32_t *terms;               /**< Distinct terms of the document */
+    uint32_t term_count;           /**< Number of distinct terms */
+} SearchEntry;
+
+/**
+ * @brief Document ID table slot
+ */
+typedef struct {
+    uint64_t id;                   /**< Document identifier (0 for an empty slot) */
+    uint32_t document;             /**< Current document number, or SEARCH_NO_DOCUMENT */
+} SearchIdSlot;
+
+/**
+ * @brief Posting list cursor used while ranking
+ */
+typedef struct {
+    const uint8_t *next;           /**< Next encoded posting */
+    const uint8_t *end;            /**< End of the posting list */
+    uint32_t document;             /**< Current document, or SEARCH_NO_DOCUMENT when exhausted */
+    uint32_t frequency;            /**< Term frequency in the current document */
+    float idf;                     /**< Inverse document frequency of the term */
+} SearchCursor;
+
+/* Search engine state */
+static bool search_initialized = false;
+static pthread_rwlock_t search_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+/* Term dictionary: open addressing over term index + 1 */
+static SearchTerm *search_terms = NULL;
+static uint32_t search_term_count = 0;
+static uint32_t search_term_capacity = 0;
+static uint32_t *search_term_table = NULL;
+static uint32_t search_term_table_size = 0;
+
+/* Documents and the ID lookup table */
+static SearchEntry *search_documents = NULL;
+static uint32_t search_document_count = 0;
+static uint32_t search_document_capacity = 0;
+static SearchIdSlot *search_id_table = NULL;
+static uint32_t search_id_table_size = 0;
+static uint32_t search_id_count = 0;
+
+/* Totals over live documents, for BM25 and compaction */
+static uint32_t search_live_documents = 0;
+static uint64_t search_total_length = 0;
+static uint64_t search_live_postings = 0;
+static uint64_t search_dead_postings = 0;
+
+/**
+ * @brief Hash a term (FNV-1a)
+ */
+static uint32_t hash_term(const char *text, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief Hash a document ID
+ */
+static uint32_t hash_id(uint64_t id) {
+    id ^= id >> 33;
+    id *= 0xff51afd7ed558ccdULL;
+    id ^= id >> 33;
+    return (uint32_t)id;
+}
+
+/**
+ * @brief Whether a byte belongs to a token
+ */
+static bool is_token_byte(uint8_t c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+}
+
+/**
+ * @brief Read the next token from a text
+ *
+ * @param text Text to tokenize
+ * @param length Length of the text
+ * @param position Read position, advanced past the token
+ * @param token Buffer of SEARCH_MAX_TERM_LENGTH bytes for the folded token
+ * @return Token length, or 0 at the end of the text
+ */
+static size_t next_token(const char *text, size_t length, size_t *position, char *token) {
+    size_t i = *position;
+    while (i < length && !is_token_byte((uint8_t)text[i])) {
+        i++;
+    }
+
+    size_t token_length = 0;
+    while (i < length && is_token_byte((uint8_t)text[i])) {
+        uint8_t c = (uint8_t)text[i];
+        if (c >= 'A' && c <= 'Z') {
+            c = (uint8_t)(c - 'A' + 'a');
+        }
+        if (token_length < SEARCH_MAX_TERM_LENGTH) {
+            token[token_length++] = (char)c;
+        }
+        i++;
+    }
+
+    *position = i;
+    return token_length;
+}
+
+/**
+ * @brief Suggestion trie node
+ *
+ * A radix trie over normalized phrases: edges carry whole label strings and
+ * nodes only branch where phrases diverge. Every node also records the
+ * highest weight below it, so the heaviest completions of a prefix are
+ * found without visiting the rest of its subtree.
+ */
+typedef struct SuggestionNode {
+    char *label;                       /**< Edge label from the parent */
+    uint32_t label_length;             /**< Length of the label */
+    struct SuggestionNode **children;  /**< Children, one per distinct first label byte */
+    uint32_t child_count;              /**< Number of children */
+    char *display;                     /**< Phrase as first added, NULL if none ends here */
+    uint32_t references;               /**< Number of times the phrase was added */
+    uint32_t boosts;                   /**< Accesses credited to the phrase */
+    uint64_t max_weight;               /**< Highest phrase weight in the subtree */
+} SuggestionNode;
+
+/**
+ * @brief Best-first queue entry used while collecting suggestions
+ */
+typedef struct {
+    const SuggestionNode *node;        /**< Node to expand or phrase to emit */
+    uint64_t weight;                   /**< Subtree or phrase weight */
+    bool phrase;                       /**< Whether to emit the node's phrase */
+} SuggestionCandidate;
+
+/* Deepest phrase the trie tracks, in normalized bytes */
+#define SUGGESTION_MAX_LENGTH 256
+
+/* Suggestion trie root (a node with an empty label) */
+static SuggestionNode *suggestion_root = NULL;
+
+/**
+ * @brief Normalize a phrase to its tokens separated by single spaces
+ *
+ * @param text Phrase to normalize
+ * @param out Buffer of SUGGESTION_MAX_LENGTH bytes
+ * @param keep_trailing Keep a separator the phrase ends with
+ * @return Normalized length (phrases are cut at a token boundary)
+ */
+static size_t normalize_phrase(const char *text, char *out, bool keep_trailing) {
+    size_t length = strlen(text);
+    size_t position = 0;
+    size_t normalized = 0;
+    char token[SEARCH_MAX_TERM_LENGTH];
+    size_t token_length;
+
+    while ((token_length = next_token(text, length, &position, token)) > 0) {
+        size_t needed = token_length + (normalized ? 1 : 0);
+        if (normalized + needed > SUGGESTION_MAX_LENGTH) {
+            break;
+        }
+        if (normalized) {
+            out[normalized++] = ' ';
+        }
+        memcpy(out + normalized, token, token_length);
+        normalized += token_length;
+    }
+
+    if (keep_trailing && normalized > 0 && normalized < SUGGESTION_MAX_LENGTH &&
+        length > 0 && !is_token_byte((uint8_t)text[length - 1])) {
+        out[normalized++] = ' ';
+    }
+    return normalized;
+}
+
+/**
+ * @brief Weight of the phrase ending at a node
+ */
+static uint64_t suggestion_weight(const SuggestionNode *node) {
+    return node->references ? (uint64_t)node->references + node->boosts : 0;
+}
+
+/**
+ * @brief Recompute a node's subtree maximum from its phrase and children
+ */
+static void suggestion_update_max(SuggestionNode *node) {
+    uint64_t max = suggestion_weight(node);
+    for (uint32_t i = 0; i < node->child_count; i++) {
+        if (node->children[i]->max_weight > max) {
+            max = node->children[i]->max_weight;
+        }
+    }
+    node->max_weight = max;
+}
+
+/**
+ * @brief Free a suggestion subtree
+ */
+static void suggestion_free(SuggestionNode *node) {
+    if (!node) {
+        return;
+    }
+    for (uint32_t i = 0; i < node->child_count; i++) {
+        suggestion_free(node->children[i]);
+    }
+    free(node->children);
+    free(node->label);
+    free(node->display);
+    free(node);
+}
+
+/**
+ * @brief Create a suggestion node with a copy of a label
+ */
+static SuggestionNode *suggestion_create(const char *label, size_t length) {
+    SuggestionNode *node = (SuggestionNode *)calloc(1, sizeof(SuggestionNode));
+    if (!node) {
+        return NULL;
+    }
+    node->label = (char *)malloc(length + 1);
+    if (!node->label) {
+        free(node);
+        return NULL;
+    }
+    memcpy(node->label, label, length);
+    node->label[length] = '\0';
+    node->label_length = (uint32_t)length;
+    return node;
+}
+
+/**
+ * @brief Find the child whose label starts with a byte
+ */
+static uint32_t suggestion_child(const SuggestionNode *node, char first) {
+    for (uint32_t i = 0; i < node->child_count; i++) {
+        if (node->children[i]->label[0] == first) {
+            return i;
+        }
+    }
+    return UINT32_MAX;
+}
+
+/**
+ * @brief Add a child to a node
+ */
+static bool suggestion_attach(SuggestionNode *node, SuggestionNode *child) {
+    SuggestionNode **children = (SuggestionNode **)realloc(node->children,
+                                                           (node->child_count + 1) * sizeof(SuggestionNode *));
+    if (!children) {
+        return false;
+    }
+    node->children = children;
+    node->children[node->child_count++] = child;
+    return true;
+}
+
+/**
+ * @brief Walk to the node of a normalized phrase
+ *
+ * @param key Normalized phrase
+ * @param length Length of the phrase
+ * @param path Filled with the nodes from the root (SUGGESTION_MAX_LENGTH + 1 entries)
+ * @param depth Set to the number of nodes in the path
+ * @param create Create missing nodes, splitting edges as needed
+ * @return Node of the phrase, or NULL if absent (or on allocation failure)
+ */
+static SuggestionNode *suggestion_walk(const char *key, size_t length, SuggestionNode **path,
+                                       uint32_t *depth, bool create) {
+    SuggestionNode *node = suggestion_root;
+    size_t position = 0;
+    *depth = 0;
+    path[(*depth)++] = node;
+
+    while (position < length) {
+        uint32_t index = suggestion_child(node, key[position]);
+        if (index == UINT32_MAX) {
+            if (!create) {
+                return NULL;
+            }
+            SuggestionNode *leaf = suggestion_create(key + position, length - position);
+            if (!leaf || !suggestion_attach(node, leaf)) {
+                suggestion_free(leaf);
+                return NULL;
+            }
+            path[(*depth)++] = leaf;
+            return leaf;
+        }
+
+        SuggestionNode *child = node->children[index];
+        uint32_t common = 0;
+        while (common < child->label_length && position + common < length &&
+               child->label[common] == key[position + common]) {
+            common++;
+        }
+
+        if (common < child->label_length) {
+            if (!create) {
+                return NULL;
+            }
+            /* Split the edge where the phrase leaves it */
+            SuggestionNode *split = suggestion_create(child->label, common);
+            char *rest = split ? (char *)malloc(child->label_length - common + 1) : NULL;
+            if (!rest || !suggestion_attach(split, child)) {
+                free(rest);
+                suggestion_free(split);
+                return NULL;
+            }
+            memcpy(rest, child->label + common, child->label_length - common + 1);
+            free(child->label);
+            child->label = rest;
+            child->label_length -= common;
+            split->max_weight = child->max_weight;
+            node->children[index] = split;
+            child = split;
+        }
+
+        node = child;
+        position += common;
+        path[(*depth)++] = node;
+    }
+
+    return node;
+}
+
+/**
+ * @brief Fold a child into a node that has no phrase and one child
+ */
+static void suggestion_merge(SuggestionNode *node) {
+    SuggestionNode *child = node->children[0];
+    char *label = (char *)malloc(node->label_length + child->label_length + 1);
+    if (!label) {
+        return;
+    }
+    memcpy(label, node->label, node->label_length);
+    memcpy(label + node->label_length, child->label, child->label_length + 1);
+
+    free(node->label);
+    free(node->children);
+    node->label = label;
+    node->label_length += child->label_length;
+    node->children = child->children;
+    node->child_count = child->child_count;
+    node->display = child->display;
+    node->references = child->references;
+    node->boosts = child->boosts;
+    node->max_weight = child->max_weight;
+
+    free(child->label);
+    free(child);
+}
+
+/**
+ * @brief Add a reference to a suggestion phrase
+ *
+ * @return false on allocation failure
+ */
+static bool suggestion_add(const char *phrase) {
+    char key[SUGGESTION_MAX_LENGTH];
+    size_t length = normalize_phrase(phrase, key, false);
+    if (length == 0) {
+        return true;
+    }
+
+    SuggestionNode *path[SUGGESTION_MAX_LENGTH + 1];
+    uint32_t depth;
+    SuggestionNode *node = suggestion_walk(key, length, path, &depth, true);
+    if (!node) {
+        return false;
+    }
+    if (!node->display) {
+        node->display = strdup(phrase);
+        if (!node->display) {
+            return false;
+        }
+    }
+    node->references++;
+
+    while (depth > 0) {
+        suggestion_update_max(path[--depth]);
+    }
+    return true;
+}
+
+/**
+ * @brief Drop a reference to a suggestion phrase
+ */
+static bool suggestion_remove(const char *phrase) {
+    char key[SUGGESTION_MAX_LENGTH];
+    size_t length = normalize_phrase(phrase, key, false);
+    SuggestionNode *path[SUGGESTION_MAX_LENGTH + 1];
+    uint32_t depth;
+    SuggestionNode *node = length ? suggestion_walk(key, length, path, &depth, false) : NULL;
+    if (!node || node->references == 0) {
+        return false;
+    }
+
+    if (--node->references == 0) {
+        free(node->display);
+        node->display = NULL;
+        node->boosts = 0;
+
+        /* Prune the emptied leaf, then fold any pass-through node left behind */
+        SuggestionNode *parent = path[depth - 2];
+        if (node->child_count == 0) {
+            uint32_t index = suggestion_child(parent, node->label[0]);
+            parent->children[index] = parent->children[--parent->child_count];
+            suggestion_free(node);
+            depth--;
+            if (parent != suggestion_root && !parent->display && parent->child_count == 1) {
+                suggestion_merge(parent);
+            }
+        } else if (node->child_count == 1) {
+            suggestion_merge(node);
+        }
+    }
+
+    while (depth > 0) {
+        suggestion_update_max(path[--depth]);
+    }
+    return true;
+}
+
+/**
+ * @brief Push a candidate onto the best-first queue (a max-heap)
+ */
+static bool suggestion_push(SuggestionCandidate **queue, uint32_t *count, uint32_t *capacity,
+                            SuggestionCandidate candidate) {
+    if (*count == *capacity) {
+        uint32_t grown = *capacity ? *capacity * 2 : 64;
+        SuggestionCandidate *resized = (SuggestionCandidate *)realloc(*queue, grown * sizeof(SuggestionCandidate));
+        if (!resized) {
+            return false;
+        }
+        *queue = resized;
+        *capacity = grown;
+    }
+
+    /* Phrases go ahead of subtrees of the same weight */
+    uint32_t slot = (*count)++;
+    while (slot > 0) {
+        uint32_t parent = (slot - 1) / 2;
+        SuggestionCandidate *above = &(*queue)[parent];
+        if (above->weight > candidate.weight ||
+            (above->weight == candidate.weight && (above->phrase || !candidate.phrase))) {
+            break;
+        }
+        (*queue)[slot] = *above;
+        slot = parent;
+    }
+    (*queue)[slot] = candidate;
+    return true;
+}
+
+/**
+ * @brief Pop the best candidate from the best-first queue
+ */
+static SuggestionCandidate suggestion_pop(SuggestionCandidate *queue, uint32_t *count) {
+    SuggestionCandidate best = queue[0];
+    SuggestionCandidate last = queue[--(*count)];
+    uint32_t slot = 0;
+
+    for (;;) {
+        uint32_t child = 2 * slot + 1;
+        if (child >= *count) {
+            break;
+        }
+        if (child + 1 < *count &&
+            (queue[child + 1].weight > queue[child].weight ||
+             (queue[child + 1].weight == queue[child].weight && queue[child + 1].phrase && !queue[child].phrase))) {
+            child++;
+        }
+        if (last.weight > queue[child].weight ||
+            (last.weight == queue[child].weight && (last.phrase || !queue[child].phrase))) {
+            break;
+        }
+        queue[slot] = queue[child];
+        slot = child;
+    }
+    if (*count > 0) {
+        queue[slot] = last;
+    }
+    return best;
+}
+
+/**
+ * @brief Find a term in the dictionary
+ *
+ * @return Term index, or SEARCH_NO_DOCUMENT if the term is not indexed
+ */
+static uint32_t find_term(const char *text, size_t length) {
+    if (search_term_table_size == 0) {
+        return SEARCH_NO_DOCUMENT;
+    }
+
+    uint32_t mask = search_term_table_size - 1;
+    for (uint32_t slot = hash_term(text, length) & mask; search_term_table[slot]; slot = (slot + 1) & mask) {
+        SearchTerm *term = &search_terms[search_term_table[slot] - 1];
+        if (strncmp(term->text, text, length) == 0 && term->text[length] == '\0') {
+            return search_term_table[slot] - 1;
+        }
+    }
+    return SEARCH_NO_DOCUMENT;
+}
+
+/**
+ * @brief Grow the term dictionary's hash table
+ */
+static bool grow_term_table(void) {
+    uint32_t size = search_term_table_size ? search_term_table_size * 2 : 1024;
+    uint32_t *table = (uint32_t *)calloc(size, sizeof(uint32_t));
+    if (!table) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < search_term_count; i++) {
+        const char *text = search_terms[i].text;
+        uint32_t slot = hash_term(text, strlen(text)) & (size - 1);
+        while (table[slot]) {
+            slot = (slot + 1) & (size - 1);
+        }
+        table[slot] = i + 1;
+    }
+
+    free(search_term_table);
+    search_term_table = table;
+    search_term_table_size = size;
+    return true;
+}
+
+/**
+ * @brief Find a term in the dictionary, adding it if needed
+ *
+ * @return Term index, or SEARCH_NO_DOCUMENT on allocation failure
+ */
+static uint32_t intern_term(const char *text, size_t length) {
+    uint32_t index = find_term(text, length);
+    if (index != SEARCH_NO_DOCUMENT) {
+        return index;
+    }
+
+    /* Keep the table at most half full */
+    if ((search_term_count + 1) * 2 > search_term_table_size && !grow_term_table()) {
+        return SEARCH_NO_DOCUMENT;
+    }
+    if (search_term_count == search_term_capacity) {
+        uint32_t capacity = search_term_capacity ? search_term_capacity * 2 : 1024;
+        SearchTerm *terms = (SearchTerm *)realloc(search_terms, capacity * sizeof(SearchTerm));
+        if (!terms) {
+            return SEARCH_NO_DOCUMENT;
+        }
+        search_terms = terms;
+        search_term_capacity = capacity;
+    }
+
+    SearchTerm *term = &search_terms[search_term_count];
+    memset(term, 0, sizeof(SearchTerm));
+    term->text = (char *)malloc(length + 1);
+    if (!term->text) {
+        return SEARCH_NO_DOCUMENT;
+    }
+    memcpy(term->text, text, length);
+    term->text[length] = '\0';
+
+    uint32_t mask = search_term_table_size - 1;
+    uint32_t slot = hash_term(text, length) & mask;
+    while (search_term_table[slot]) {
+        slot = (slot + 1) & mask;
+    }
+    search_term_table[slot] = search_term_count + 1;
+
+    return search_term_count++;
+}
+
+/**
+ * @brief Encode a variable-length integer
+ *
+ * @return Number of bytes written (at most 5)
+ */
+static uint32_t put_varint(uint8_t *out, uint32_t value) {
+    uint32_t count = 0;
+    while (value >= 0x80) {
+        out[count++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[count++] = (uint8_t)value;
+    return count;
+}
+
+/**
+ * @brief Decode a variable-length integer
+ */
+static const uint8_t *get_varint(const uint8_t *in, uint32_t *value) {
+    uint32_t result = 0;
+    uint32_t shift = 0;
+    while (*in & 0x80) {
+        result |= (uint32_t)(*in++ & 0x7F) << shift;
+        shift += 7;
+    }
+    *value = result | ((uint32_t)*in++ << shift);
+    return in;
+}
+
+/**
+ * @brief Append a posting to a term's list
+ */
+static bool append_posting(SearchTerm *term, uint32_t document, uint32_t frequency) {
+    if (term->postings_size + 10 > term->postings_capacity) {
+        uint32_t capacity = term->postings_capacity ? term->postings_capacity * 2 : 16;
+        uint8_t *postings = (uint8_t *)realloc(term->postings, capacity);
+        if (!postings) {
+            return false;
+        }
+        term->postings = postings;
+        term->postings_capacity = capacity;
+    }
+
+    term->postings_size += put_varint(term->postings + term->postings_size, document - term->last_document);
+    term->postings_size += put_varint(term->postings + term->postings_size, frequency);
+    term->last_document = document;
+    term->posting_count++;
+    return true;
+}
+
+/**
+ * @brief Find a document ID's slot in the ID table
+ *
+ * @return Slot holding the ID, or the empty slot where it would go
+ */
+static SearchIdSlot *id_slot(uint64_t id) {
+    uint32_t mask = search_id_table_size - 1;
+    uint32_t slot = hash_id(id) & mask;
+    while (search_id_table[slot].id != 0 && search_id_table[slot].id != id) {
+        slot = (slot + 1) & mask;
+    }
+    return &search_id_table[slot];
+}
+
+/**
+ * @brief Look up the current document number of an ID
+ */
+static uint32_t find_document(uint64_t id) {
+    if (search_id_table_size == 0 || id == 0) {
+        return SEARCH_NO_DOCUMENT;
+    }
+    SearchIdSlot *slot = id_slot(id);
+    return slot->id == id ? slot->document : SEARCH_NO_DOCUMENT;
+}
+
+/**
+ * @brief Rebuild the ID table from the live documents
+ *
+ * IDs of removed documents keep their slot until the table is rebuilt.
+ */
+static bool rebuild_id_table(uint32_t size) {
+    SearchIdSlot *table = (SearchIdSlot *)calloc(size, sizeof(SearchIdSlot));
+    if (!table) {
+        return false;
+    }
+
+    free(search_id_table);
+    search_id_table = table;
+    search_id_table_size = size;
+    search_id_count = 0;
+    for (uint32_t i = 0; i < search_document_count; i++) {
+        if (search_documents[i].live) {
+            SearchIdSlot *slot = id_slot(search_documents[i].id);
+            slot->id = search_documents[i].id;
+            slot->document = i;
+            search_id_count++;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Release a document's copies and mark it dead
+ */
+static void retire_document(SearchEntry *entry) {
+    for (uint32_t i = 0; i < entry->term_count; i++) {
+        search_terms[entry->terms[i]].document_frequency--;
+    }
+    search_live_postings -= entry->term_count;
+    search_dead_postings += entry->term_count;
+    search_total_length -= entry->length;
+    search_live_documents--;
+
+    if (entry->title) {
+        suggestion_remove(entry->title);
+    }
+    free(entry->title);
+    free(entry->terms);
+    entry->title = NULL;
+    entry->terms = NULL;
+    entry->live = false;
+}
+
+/**
+ * @brief Drop dead postings and renumber the live documents
+ *
+ * Renumbering keeps document order, so every delta shrinks or stays the
+ * same and each list can be rewritten in place.
+ */
+static void compact_index(void) {
+    uint32_t *renumber = (uint32_t *)malloc((search_document_count ? search_document_count : 1) * sizeof(uint32_t));
+    if (!renumber) {
+        return;
+    }
+
+    uint32_t live = 0;
+    for (uint32_t i = 0; i < search_document_count; i++) {
+        renumber[i] = search_documents[i].live ? live++ : SEARCH_NO_DOCUMENT;
+    }
+
+    for (uint32_t t = 0; t < search_term_count; t++) {
+        SearchTerm *term = &search_terms[t];
+        const uint8_t *in = term->postings;
+        const uint8_t *end = term->postings + term->postings_size;
+        uint8_t *out = term->postings;
+        uint32_t document = 0;
+        uint32_t last = 0;
+        uint32_t count = 0;
+
+        while (in < end) {
+            uint32_t delta, frequency;
+            in = get_varint(in, &delta);
+            in = get_varint(in, &frequency);
+            document += delta;
+            if (renumber[document] != SEARCH_NO_DOCUMENT) {
+                out += put_varint(out, renumber[document] - last);
+                out += put_varint(out, frequency);
+                last = renumber[document];
+                count++;
+            }
+        }
+
+        term->postings_size = (uint32_t)(out - term->postings);
+        term->posting_count = count;
+        term->last_document = last;
+    }
+
+    for (uint32_t i = 0; i < search_document_count; i++) {
+        if (renumber[i] != SEARCH_NO_DOCUMENT) {
+            search_documents[renumber[i]] = search_documents[i];
+        }
+    }
+    search_document_count = live;
+    search_dead_postings = 0;
+    free(renumber);
+
+    /* On failure the old table stays, which still maps every live ID */
+    uint32_t size = search_id_table_size;
+    while (size > 1024 && live * 4 < size) {
+        size /= 2;
+    }
+    if (!rebuild_id_table(size)) {
+        for (uint32_t i = 0; i < search_id_table_size; i++) {
+            search_id_table[i].document = SEARCH_NO_DOCUMENT;
+        }
+        for (uint32_t i = 0; i < search_document_count; i++) {
+            id_slot(search_documents[i].id)->document = i;
+        }
+    }
+}
+
+/**
+ * @brief Compare term indices
+ */
+static int compare_terms(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+/**
+ * @brief Tokenize a text into term indices, interning new terms
+ *
+ * @return false on allocation failure
+ */
+static bool collect_terms(const char *text, size_t length, uint32_t **tokens, uint32_t *count, uint32_t *capacity) {
+    char token[SEARCH_MAX_TERM_LENGTH];
+    size_t position = 0;
+    size_t token_length;
+
+    while ((token_length = next_token(text, length, &position, token)) > 0) {
+        if (*count == *capacity) {
+            uint32_t grown = *capacity ? *capacity * 2 : 64;
+            uint32_t *resized = (uint32_t *)realloc(*tokens, grown * sizeof(uint32_t));
+            if (!resized) {
+                return false;
+            }
+            *tokens = resized;
+            *capacity = grown;
+        }
+        uint32_t term = intern_term(token, token_length);
+        if (term == SEARCH_NO_DOCUMENT) {
+            return false;
+        }
+        (*tokens)[(*count)++] = term;
+    }
+    return true;
+}
+
+/**
+ * @brief Initialize the Memex Search Engine integration
+ */
+bool memex_search_init(void) {
+    if (search_initialized) {
+        return true;
+    }
+
+    search_term_count = 0;
+    search_document_count = 0;
+    search_live_documents = 0;
+    search_total_length = 0;
+    search_live_postings = 0;
+    search_dead_postings = 0;
+    suggestion_root = suggestion_create("", 0);
+    if (!suggestion_root || !grow_term_table() || !rebuild_id_table(1024)) {
+        printf("Failed to allocate search index\n");
+        suggestion_free(suggestion_root);
+        suggestion_root = NULL;
+        free(search_term_table);
+        search_term_table = NULL;
+        search_term_table_size = 0;
+        return false;
+    }
+
+    search_initialized = true;
+    return true;
+}
+
+/**
+ * @brief Shutdown the Memex Search Engine integration
+ */
+void memex_search_shutdown(void) {
+    if (!search_initialized) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < search_term_count; i++) {
+        free(search_terms[i].text);
+        free(search_terms[i].postings);
+    }
+    for (uint32_t i = 0; i < search_document_count; i++) {
+        free(search_documents[i].title);
+        free(search_documents[i].terms);
+    }
+    free(search_terms);
+    free(search_term_table);
+    free(search_documents);
+    free(search_id_table);
+    suggestion_free(suggestion_root);
+
+    search_terms = NULL;
+    search_term_count = 0;
+    search_term_capacity = 0;
+    search_term_table = NULL;
+    search_term_table_size = 0;
+    search_documents = NULL;
+    search_document_count = 0;
+    search_document_capacity = 0;
+    search_id_table = NULL;
+    search_id_table_size = 0;
+    search_id_count = 0;
+    suggestion_root = NULL;
+
+    search_initialized = false;
+}
+
+/**
+ * @brief Add a document to the search index, under the search lock
+ */
+static bool index_document(const SearchDocument *document) {
+    if (!search_initialized || !document || document->id == 0) {
+        return false;
+    }
+
+    /* Gather the document's tokens, then count each distinct term */
+    uint32_t *tokens = NULL;
+    uint32_t token_count = 0;
+    uint32_t token_capacity = 0;
+    bool collected = true;
+    if (document->title) {
+        collected = collect_terms(document->title, strlen(document->title), &tokens, &token_count, &token_capacity);
+    }
+    if (collected && document->text) {
+        collected = collect_terms(document->text, document->text_length, &tokens, &token_count, &token_capacity);
+    }
+    if (!collected) {
+        free(tokens);
+        printf("Failed to tokenize search document\n");
+        return false;
+    }
+    qsort(tokens, token_count, sizeof(uint32_t), compare_terms);
+
+    /* tokens[0..distinct) becomes the term list, frequencies go alongside */
+    uint32_t distinct = 0;
+    uint32_t *frequencies = (uint32_t *)malloc((token_count ? token_count : 1) * sizeof(uint32_t));
+    if (!frequencies) {
+        free(tokens);
+        return false;
+    }
+    for (uint32_t i = 0; i < token_count; i++) {
+        if (distinct > 0 && tokens[distinct - 1] == tokens[i]) {
+            frequencies[distinct - 1]++;
+        } else {
+            tokens[distinct] = tokens[i];
+            frequencies[distinct++] = 1;
+        }
+    }
+
+    if (search_document_count == search_document_capacity) {
+        uint32_t capacity = search_document_capacity ? search_document_capacity * 2 : 1024;
+        SearchEntry *documents = (SearchEntry *)realloc(search_documents, capacity * sizeof(SearchEntry));
+        if (!documents) {
+            free(frequencies);
+            free(tokens);
+            return false;
+        }
+        search_documents = documents;
+        search_document_capacity = capacity;
+    }
+
+    /* Keep the ID table at most half full, counting IDs of removed documents */
+    if ((search_id_count + 1) * 2 > search_id_table_size && !rebuild_id_table(search_id_table_size * 2)) {
+        free(frequencies);
+        free(tokens);
+        return false;
+    }
+
+    char *title = document->title ? strdup(document->title) : NULL;
+    if (document->title && !title) {
+        free(frequencies);
+        free(tokens);
+        return false;
+    }
+
+    /* The replaced copy goes only once the new one is in place */
+    uint32_t replaced = find_document(document->id);
+    uint32_t number = search_document_count;
+    for (uint32_t i = 0; i < distinct; i++) {
+        if (!append_posting(&search_terms[tokens[i]], number, frequencies[i])) {
+            /* Postings already written belong to a document that never goes live */
+            for (uint32_t j = 0; j < i; j++) {
+                search_terms[tokens[j]].document_frequency--;
+                search_dead_postings++;
+            }
+            search_documents[search_document_count++] = (SearchEntry){ .id = document->id, .live = false };
+            free(title);
+            free(frequencies);
+            free(tokens);
+            printf("Failed to append search posting\n");
+            return false;
+        }
+        search_terms[tokens[i]].document_frequency++;
+    }
+    free(frequencies);
+
+    SearchEntry *entry = &search_documents[search_document_count++];
+    entry->id = document->id;
+    entry->title = title;
+    entry->type = document->type;
+    entry->resonance_level = document->resonance_level;
+    entry->is_quantum_entangled = document->is_quantum_entangled;
+    entry->live = true;
+    entry->length = token_count;
+    entry->terms = (uint32_t *)realloc(tokens, (distinct ? distinct : 1) * sizeof(uint32_t));
+    if (!entry->terms) {
+        entry->terms = tokens;
+    }
+    entry->term_count = distinct;
+
+    search_live_documents++;
+    search_total_length += token_count;
+    search_live_postings += distinct;
+
+    SearchIdSlot *slot = id_slot(document->id);
+    if (slot->id == 0) {
+        slot->id = document->id;
+        search_id_count++;
+    }
+    slot->document = number;
+
+    /* Titles double as suggestions; a missing suggestion does not fail indexing */
+    if (title) {
+        suggestion_add(title);
+    }
+
+    if (replaced != SEARCH_NO_DOCUMENT) {
+        retire_document(&search_documents[replaced]);
+        if (search_dead_postings > SEARCH_COMPACT_MIN && search_dead_postings > search_live_postings) {
+            compact_index();
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Add a document to the search index
+ */
+bool memex_search_index_document(const SearchDocument *document) {
+    pthread_rwlock_wrlock(&search_lock);
+    bool indexed = index_document(document);
+    pthread_rwlock_unlock(&search_lock);
+    return indexed;
+}
+
+/**
+ * @brief Remove a document from the search index, under the search lock
+ */
+static bool remove_document(uint64_t id) {
+    if (!search_initialized) {
+        return false;
+    }
+
+    uint32_t number = find_document(id);
+    if (number == SEARCH_NO_DOCUMENT) {
+        return false;
+    }
+
+    retire_document(&search_documents[number]);
+    id_slot(id)->document = SEARCH_NO_DOCUMENT;
+
+    if (search_dead_postings > SEARCH_COMPACT_MIN && search_dead_postings > search_live_postings) {
+        compact_index();
+    }
+    return true;
+}
+
+/**
+ * @brief Remove a document from the search index
+ */
+bool memex_search_remove_document(uint64_t id) {
+    pthread_rwlock_wrlock(&search_lock);
+    bool removed = remove_document(id);
+    pthread_rwlock_unlock(&search_lock);
+    return removed;
+}
+
+/**
+ * @brief Set whether an indexed document is quantum-entangled, under the search lock
+ */
+static bool set_entangled(uint64_t id, bool entangled) {
+    if (!search_initialized) {
+        return false;
+    }
+
+    uint32_t number = find_document(id);
+    if (number == SEARCH_NO_DOCUMENT) {
+        return false;
+    }
+
+    search_documents[number].is_quantum_entangled = entangled;
+    return true;
+}
+
+/**
+ * @brief Set whether an indexed document is quantum-entangled
+ */
+bool memex_search_set_entangled(uint64_t id, bool entangled) {
+    pthread_rwlock_wrlock(&search_lock);
+    bool found = set_entangled(id, entangled);
+    pthread_rwlock_unlock(&search_lock);
+    return found;
+}
+
+/**
+ * @brief Whether hit a ranks below hit b (lower relevance, then higher ID)
+ */
+static bool hit_below(const SearchHit *a, const SearchHit *b) {
+    return a->relevance < b->relevance || (a->relevance == b->relevance && a->id > b->id);
+}
+
+/**
+ * @brief Restore the min-heap property below a slot
+ */
+static void heap_sift_down(SearchHit *heap, uint32_t count, uint32_t slot) {
+    for (;;) {
+        uint32_t lowest = slot;
+        uint32_t left = 2 * slot + 1;
+        uint32_t right = left + 1;
+        if (left < count && hit_below(&heap[left], &heap[lowest])) {
+            lowest = left;
+        }
+        if (right < count && hit_below(&heap[right], &heap[lowest])) {
+            lowest = right;
+        }
+        if (lowest == slot) {
+            return;
+        }
+        SearchHit swap = heap[slot];
+        heap[slot] = heap[lowest];
+        heap[lowest] = swap;
+        slot = lowest;
+    }
+}
+
+/**
+ * @brief Restore the min-heap property above a slot
+ */
+static void heap_sift_up(SearchHit *heap, uint32_t slot) {
+    while (slot > 0) {
+        uint32_t parent = (slot - 1) / 2;
+        if (!hit_below(&heap[slot], &heap[parent])) {
+            return;
+        }
+        SearchHit swap = heap[slot];
+        heap[slot] = heap[parent];
+        heap[parent] = swap;
+        slot = parent;
+    }
+}
+
+/**
+ * @brief Order hits by decreasing relevance
+ */
+static int compare_hits(const void *a, const void *b) {
+    const SearchHit *x = (const SearchHit *)a;
+    const SearchHit *y = (const SearchHit *)b;
+    if (hit_below(x, y)) {
+        return 1;
+    }
+    return hit_below(y, x) ? -1 : 0;
+}
+
+/**
+ * @brief Move a cursor to its next posting
+ */
+static void advance_cursor(SearchCursor *cursor) {
+    if (cursor->next >= cursor->end) {
+        cursor->document = SEARCH_NO_DOCUMENT;
+        return;
+    }
+
+    uint32_t delta;
+    cursor->next = get_varint(cursor->next, &delta);
+    cursor->next = get_varint(cursor->next, &cursor->frequency);
+    cursor->document = (cursor->document == SEARCH_NO_DOCUMENT ? 0 : cursor->document) + delta;
+}
+
+/**
+ * @brief Rank indexed documents against a query with BM25, under the search lock
+ */
+static uint32_t rank(const char *query, const SearchRankOptions *options,
+                     SearchHit **hits, uint32_t *total_matches) {
+    if (hits) {
+        *hits = NULL;
+    }
+    if (total_matches) {
+        *total_matches = 0;
+    }
+    if (!search_initialized || !query || !options || !hits || search_live_documents == 0) {
+        return 0;
+    }
+
+    /* Look up the distinct query terms */
+    SearchCursor cursors[SEARCH_MAX_QUERY_TERMS];
+    uint32_t terms[SEARCH_MAX_QUERY_TERMS];
+    uint32_t term_count = 0;
+    uint32_t unknown_terms = 0;
+    char token[SEARCH_MAX_TERM_LENGTH];
+    size_t position = 0;
+    size_t token_length;
+    size_t query_length = strlen(query);
+    while (term_count < SEARCH_MAX_QUERY_TERMS &&
+           (token_length = next_token(query, query_length, &position, token)) > 0) {
+        uint32_t term = find_term(token, token_length);
+        if (term == SEARCH_NO_DOCUMENT || search_terms[term].document_frequency == 0) {
+            unknown_terms++;
+            continue;
+        }
+        bool seen = false;
+        for (uint32_t i = 0; i < term_count; i++) {
+            seen = seen || terms[i] == term;
+        }
+        if (!seen) {
+            terms[term_count++] = term;
+        }
+    }
+    if (term_count == 0 || (options->match_all && unknown_terms > 0)) {
+        return 0;
+    }
+
+    /* A term contributes at most idf * (k1 + 1), however often it occurs */
+    float live = (float)search_live_documents;
+    float average_length = (float)search_total_length / live;
+    if (average_length <= 0.0f) {
+        average_length = 1.0f;
+    }
+    float max_score = 0.0f;
+    for (uint32_t i = 0; i < term_count; i++) {
+        SearchTerm *term = &search_terms[terms[i]];
+        float frequency = (float)term->document_frequency;
+        cursors[i].next = term->postings;
+        cursors[i].end = term->postings + term->postings_size;
+        cursors[i].document = SEARCH_NO_DOCUMENT;
+        cursors[i].idf = logf(1.0f + (live - frequency + 0.5f) / (frequency + 0.5f));
+        advance_cursor(&cursors[i]);
+        max_score += cursors[i].idf * (SEARCH_BM25_K1 + 1.0f);
+    }
+
+    /* Every live document fits, so only a max_results limit can fill the heap */
+    uint32_t capacity = options->max_results && options->max_results < search_live_documents ?
+                        options->max_results : search_live_documents;
+    SearchHit *heap = (SearchHit *)malloc(capacity * sizeof(SearchHit));
+    if (!heap) {
+        return 0;
+    }
+    uint32_t count = 0;
+    uint32_t matches = 0;
+
+    /* Score one document at a time across all cursors */
+    for (;;) {
+        uint32_t document = SEARCH_NO_DOCUMENT;
+        for (uint32_t i = 0; i < term_count; i++) {
+            if (cursors[i].document < document) {
+                document = cursors[i].document;
+            }
+        }
+        if (document == SEARCH_NO_DOCUMENT) {
+            break;
+        }
+
+        const SearchEntry *entry = &search_documents[document];
+        float norm = SEARCH_BM25_K1 * (1.0f - SEARCH_BM25_B + SEARCH_BM25_B * (float)entry->length / average_length);
+        float score = 0.0f;
+        uint32_t matched = 0;
+        for (uint32_t i = 0; i < term_count; i++) {
+            if (cursors[i].document == document) {
+                float frequency = (float)cursors[i].frequency;
+                score += cursors[i].idf * frequency * (SEARCH_BM25_K1 + 1.0f) / (frequency + norm);
+                matched++;
+                advance_cursor(&cursors[i]);
+            }
+        }
+
+        if (!entry->live || (options->match_all && matched < term_count) ||
+            entry->resonance_level < options->min_resonance ||
+            (options->type_mask && !(options->type_mask & (1u << entry->type)))) {
+            continue;
+        }
+
+        SearchHit hit = { entry->id, score / max_score };
+        if (hit.relevance < options->min_relevance) {
+            continue;
+        }
+        matches++;
+
+        if (count == capacity) {
+            if (hit_below(&heap[0], &hit)) {
+                heap[0] = hit;
+                heap_sift_down(heap, count, 0);
+            }
+            continue;
+        }
+        heap[count] = hit;
+        heap_sift_up(heap, count++);
+    }
+
+    if (count == 0) {
+        free(heap);
+        return 0;
+    }
+
+    qsort(heap, count, sizeof(SearchHit), compare_hits);
+    *hits = heap;
+    if (total_matches) {
+        *total_matches = matches;
+    }
+    return count;
+}
+
+/**
+ * @brief Rank indexed documents against a query with BM25
+ */
+uint32_t memex_search_rank(const char *query, const SearchRankOptions *options,
+                           SearchHit **hits, uint32_t *total_matches) {
+    pthread_rwlock_rdlock(&search_lock);
+    uint32_t count = rank(query, options, hits, total_matches);
+    pthread_rwlock_unlock(&search_lock);
+    return count;
+}
+
+/**
+ * @brief Perform a search using Memex's advanced search capabilities, under the search lock
+ */
+static SearchResult *query_results(const char *query, SearchOptions options,
+                                   uint32_t *result_count) {
+    if (result_count) {
+        *result_count = 0;
+    }
+    if (!search_initialized || !query || !result_count) {
+        return NULL;
+    }
+
+    SearchRankOptions rank_options = {
+        .max_results = options.max_results,
+        .min_relevance = 0.0f,
+        .min_resonance = 0,
+        .type_mask = 0,
+        .match_all = false
+    };
+    if (options.include_files) rank_options.type_mask |= 1u << RESULT_FILE;
+    if (options.include_apps) rank_options.type_mask |= 1u << RESULT_APP;
+    if (options.include_contacts) rank_options.type_mask |= 1u << RESULT_CONTACT;
+    if (options.include_web) rank_options.type_mask |= 1u << RESULT_WEB;
+    if (options.include_knowledge) rank_options.type_mask |= (1u << RESULT_KNOWLEDGE) | (1u << RESULT_QUANTUM);
+
+    SearchHit *hits;
+    uint32_t count = rank(query, &rank_options, &hits, NULL);
+    if (count == 0) {
+        return NULL;
+    }
+
+    SearchResult *results = (SearchResult *)calloc(count, sizeof(SearchResult));
+    if (!results) {
+        free(hits);
+        return NULL;
+    }
+
+    /* Entangled results go first, each group keeping its ranking */
+    uint32_t filled = 0;
+    for (int pass = options.quantum_prioritize ? 0 : 1; pass < 2; pass++) {
+        for (uint32_t i = 0; i < count; i++) {
+            const SearchEntry *entry = &search_documents[find_document(hits[i].id)];
+            if (options.quantum_prioritize && entry->is_quantum_entangled != (pass == 0)) {
+                continue;
+            }
+
+            SearchResult *result = &results[filled++];
+            char uri[48];
+            snprintf(uri, sizeof(uri), "memex://item/%llu", (unsigned long long)entry->id);
+            result->id = entry->id;
+            result->type = entry->type;
+            result->title = entry->title ? strdup(entry->title) : NULL;
+            result->description = NULL;
+            result->uri = strdup(uri);
+            result->relevance = hits[i].relevance;
+            result->is_quantum_entangled = entry->is_quantum_entangled;
+        }
+    }
+    free(hits);
+
+    *result_count = count;
+    return results;
+}
+
+/**
+ * @brief Perform a search using Memex's advanced search capabilities
+ */
+SearchResult *memex_search_query(const char *query, SearchOptions options,
+                               uint32_t *result_count) {
+    pthread_rwlock_rdlock(&search_lock);
+    SearchResult *results = query_results(query, options, result_count);
+    pthread_rwlock_unlock(&search_lock);
+    return results;
+}
+
+/**
+ * @brief Free search results memory
+ */
+void memex_search_free_results(SearchResult *results, uint32_t result_count) {
+    if (!results) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < result_count; i++) {
+        free(results[i].title);
+        free(results[i].description);
+        free(results[i].uri);
+    }
+    free(results);
+}
+
+/**
+ * @brief Get suggested search queries based on a partial query, under the search lock
+ *
+ * Suggestions are the added phrases (item titles and knowledge node labels)
+ * that start with the partial query, heaviest first. Matching ignores case
+ * and punctuation; a trailing separator asks for the next word.
+ */
+static char **get_suggestions(const char *partial_query, uint32_t max_suggestions,
+                              uint32_t *suggestion_count) {
+    if (suggestion_count) {
+        *suggestion_count = 0;
+    }
+    if (!search_initialized || !partial_query || max_suggestions == 0 || !suggestion_count) {
+        return NULL;
+    }
+
+    char key[SUGGESTION_MAX_LENGTH];
+    size_t length = normalize_phrase(partial_query, key, true);
+    if (length == 0) {
+        return NULL;
+    }
+
+    /* Walk down to the subtree of phrases that start with the prefix */
+    const SuggestionNode *node = suggestion_root;
+    size_t position = 0;
+    while (position < length) {
+        uint32_t index = suggestion_child(node, key[position]);
+        if (index == UINT32_MAX) {
+            return NULL;
+        }
+        node = node->children[index];
+        uint32_t compared = node->label_length < length - position ? node->label_length : (uint32_t)(length - position);
+        if (memcmp(node->label, key + position, compared) != 0) {
+            return NULL;
+        }
+        position += compared;
+    }
+    if (node->max_weight == 0) {
+        return NULL;
+    }
+
+    char **suggestions = (char **)malloc(max_suggestions * sizeof(char *));
+    SuggestionCandidate *queue = NULL;
+    uint32_t queued = 0;
+    uint32_t capacity = 0;
+    uint32_t count = 0;
+    if (!suggestions || !suggestion_push(&queue, &queued, &capacity,
+                                         (SuggestionCandidate){ node, node->max_weight, false })) {
+        free(suggestions);
+        return NULL;
+    }
+
+    /* Everything still queued weighs at most what was popped */
+    while (queued > 0 && count < max_suggestions) {
+        SuggestionCandidate candidate = suggestion_pop(queue, &queued);
+        if (candidate.phrase) {
+            char *suggestion = strdup(candidate.node->display);
+            if (suggestion) {
+                suggestions[count++] = suggestion;
+            }
+            continue;
+        }
+
+        bool pushed = true;
+        if (candidate.node->references > 0) {
+            pushed = suggestion_push(&queue, &queued, &capacity,
+                                     (SuggestionCandidate){ candidate.node, suggestion_weight(candidate.node), true });
+        }
+        for (uint32_t i = 0; pushed && i < candidate.node->child_count; i++) {
+            const SuggestionNode *child = candidate.node->children[i];
+            if (child->max_weight > 0) {
+                pushed = suggestion_push(&queue, &queued, &capacity,
+                                         (SuggestionCandidate){ child, child->max_weight, false });
+            }
+        }
+        if (!pushed) {
+            break;
+        }
+    }
+    free(queue);
+
+    if (count == 0) {
+        free(suggestions);
+        return NULL;
+    }
+
+    *suggestion_count = count;
+    return suggestions;
+}
+
+/**
+ * @brief Get suggested search queries based on a partial query
+ */
+char **memex_search_get_suggestions(const char *partial_query,
+                                  uint32_t max_suggestions,
+                                  uint32_t *suggestion_count) {
+    pthread_rwlock_rdlock(&search_lock);
+    char **suggestions = get_suggestions(partial_query, max_suggestions, suggestion_count);
+    pthread_rwlock_unlock(&search_lock);
+    return suggestions;
+}
+
+/**
+ * @brief Add a suggestion phrase
+ */
+bool memex_search_add_suggestion(const char *phrase) {
+    if (!search_initialized || !phrase) {
+        return false;
+    }
+    pthread_rwlock_wrlock(&search_lock);
+    bool added = suggestion_add(phrase);
+    pthread_rwlock_unlock(&search_lock);
+    return added;
+}
+
+/**
+ * @brief Remove a suggestion phrase
+ */
+bool memex_search_remove_suggestion(const char *phrase) {
+    if (!search_initialized || !phrase) {
+        return false;
+    }
+    pthread_rwlock_wrlock(&search_lock);
+    bool removed = suggestion_remove(phrase);
+    pthread_rwlock_unlock(&search_lock);
+    return removed;
+}
+
+/**
+ * @brief Credit accesses to a suggestion phrase, under the search lock
+ */
+static bool boost_suggestion(const char *phrase, uint32_t amount) {
+    if (!search_initialized || !phrase) {
+        return false;
+    }
+
+    char key[SUGGESTION_MAX_LENGTH];
+    size_t length = normalize_phrase(phrase, key, false);
+    SuggestionNode *path[SUGGESTION_MAX_LENGTH + 1];
+    uint32_t depth;
+    SuggestionNode *node = length ? suggestion_walk(key, length, path, &depth, false) : NULL;
+    if (!node || node->references == 0) {
+        return false;
+    }
+
+    node->boosts = node->boosts > UINT32_MAX - amount ? UINT32_MAX : node->boosts + amount;
+    while (depth > 0) {
+        suggestion_update_max(path[--depth]);
+    }
+    return true;
+}
+
+/**
+ * @brief Credit accesses to a suggestion phrase
+ */
+bool memex_search_boost_suggestion(const char *phrase, uint32_t amount) {
+    pthread_rwlock_wrlock(&search_lock);
+    bool boosted = boost_suggestion(phrase, amount);
+    pthread_rwlock_unlock(&search_lock);
+    return boosted;
+}
@@ -4,6 +4,9 @@
  *
  * This file defines the interface for integrating Memex's advanced search
  * capabilities with CTRLxT OS.
+ *
+ * Between memex_search_init() and memex_search_shutdown() the functions
+ * may be called from any thread; queries run concurrently with each other.
  */
 
 #ifndef CTRLXT_MEMEX_SEARCH_H
@@ -51,6 +54,41 @@ typedef struct {
     char *language;            /**< Preferred language for results */
 } SearchOptions;
 
+/**
+ * @brief Document handed to the search index
+ *
+ * The title and text are tokenized together. Tokens are runs of letters,
+ * digits and non-ASCII bytes, folded to lowercase.
+ */
+typedef struct {
+    uint64_t id;               /**< Unique identifier */
+    SearchResultType type;     /**< Type of result the document produces */
+    const char *title;         /**< Document title (may be NULL) */
+    const char *text;          /**< Document text (may be NULL, need not be terminated) */
+    uint64_t text_length;      /**< Length of the text in bytes */
+    uint32_t resonance_level;  /**< Resonance level used for filtering */
+    bool is_quantum_entangled; /**< Whether the document is quantum-entangled */
+} SearchDocument;
+
+/**
+ * @brief Ranking options for memex_search_rank()
+ */
+typedef struct {
+    uint32_t max_results;      /**< Maximum number of hits to return (0 for no limit) */
+    float min_relevance;       /**< Minimum relevance of a hit (0.0 to 1.0) */
+    uint32_t min_resonance;    /**< Minimum resonance level of a hit */
+    uint32_t type_mask;        /**< Bit (1 << SearchResultType) per accepted type, 0 for all */
+    bool match_all;            /**< Require every query term instead of any */
+} SearchRankOptions;
+
+/**
+ * @brief Ranked search hit
+ */
+typedef struct {
+    uint64_t id;               /**< Document identifier */
+    float relevance;           /**< Relevance score (0.0 to 1.0) */
+} SearchHit;
+
 /**
  * @brief Initialize the Memex Search Engine integration
  * 
@@ -94,4 +132,77 @@ char **memex_search_get_suggestions(const char *partial_query,
  */
 void memex_search_shutdown(void);
 
+/**
+ * @brief Add a document to the search index
+ * 
+ * A document already indexed under the same ID is replaced.
+ * 
+ * @param document Document to index
+ * @return true if the document was indexed, false otherwise
+ */
+bool memex_search_index_document(const SearchDocument *document);
+
+/**
+ * @brief Remove a document from the search index
+ * 
+ * @param id Document identifier
+ * @return true if the document was removed, false if it was not indexed
+ */
+bool memex_search_remove_document(uint64_t id);
+
+/**
+ * @brief Set whether an indexed document is quantum-entangled
+ * 
+ * @param id Document identifier
+ * @param entangled Whether the document is entangled
+ * @return true if the document was updated, false if it was not indexed
+ */
+bool memex_search_set_entangled(uint64_t id, bool entangled);
+
+/**
+ * @brief Add a suggestion phrase
+ * 
+ * Each indexed document's title is added automatically. Adding a phrase
+ * again raises its weight; phrases differing only in case and punctuation
+ * are the same suggestion.
+ * 
+ * @param phrase Phrase to suggest
+ * @return true if the phrase was added, false otherwise
+ */
+bool memex_search_add_suggestion(const char *phrase);
+
+/**
+ * @brief Remove one addition of a suggestion phrase
+ * 
+ * @param phrase Phrase previously added
+ * @return true if the phrase was found, false otherwise
+ */
+bool memex_search_remove_suggestion(const char *phrase);
+
+/**
+ * @brief Credit accesses to a suggestion phrase, raising its weight
+ * 
+ * @param phrase Phrase previously added
+ * @param amount Number of accesses
+ * @return true if the phrase was found, false otherwise
+ */
+bool memex_search_boost_suggestion(const char *phrase, uint32_t amount);
+
+/**
+ * @brief Rank indexed documents against a query with BM25
+ * 
+ * Relevance is the BM25 score divided by the highest score the query's
+ * terms can reach, so it stays between 0.0 and 1.0 and is comparable
+ * across queries. Hits are sorted by decreasing relevance.
+ * 
+ * @param query Query text
+ * @param options Ranking options
+ * @param hits Set to the array of hits (must be freed by the caller, NULL if none)
+ * @param total_matches Pointer to store the number of matching documents
+ *        before max_results is applied (may be NULL)
+ * @return Number of hits
+ */
+uint32_t memex_search_rank(const char *query, const SearchRankOptions *options,
+                           SearchHit **hits, uint32_t *total_matches);
+
 #endif /* CTRLXT_MEMEX_SEARCH_H */
\ No newline at end of file
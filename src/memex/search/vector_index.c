@@ -0,0 +1,1052 @@
+/**
+ * @file vector_index.c
+ * @brief HNSW approximate nearest-neighbor index
+ *
+ * Nodes live in parallel arrays indexed by insertion order. Vectors are
+ * stored zero-padded to a multiple of 16 floats in one 64-byte aligned
+ * block, so every kernel runs whole SIMD iterations. Layer 0 links are a
+ * fixed-size block per node ([count, links...] with 2 * M slots); nodes
+ * above layer 0 also own one M-slot block per extra layer.
+ *
+ * Removed and replaced entries stay in the graph as tombstones so the
+ * links through them keep working; they are never returned, and the graph
+ * is rebuilt once tombstones outnumber live entries.
+ */
+
+#include "vector_index.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define VINDEX_HAVE_X86 1
+#endif
+
+/* Defaults and limits */
+#define VINDEX_DEFAULT_NEIGHBORS 16
+#define VINDEX_DEFAULT_EF_CONSTRUCTION 200
+#define VINDEX_MAX_LEVEL 16
+#define VINDEX_LANES 16
+#define VINDEX_ALIGNMENT 64
+#define VINDEX_INITIAL_CAPACITY 64
+#define VINDEX_NONE UINT32_MAX
+
+/* Tombstones tolerated before a rebuild, beyond the live entry count */
+#define VINDEX_REBUILD_SLACK 64
+
+typedef float (*VectorKernelFunction)(const float *a, const float *b, uint32_t length);
+
+/**
+ * @brief Per-node attributes
+ */
+typedef struct {
+    uint64_t id;               /**< Caller's identifier */
+    uint32_t resonance_level;  /**< Filter resonance */
+    uint32_t type;             /**< Filter type */
+    uint8_t level;             /**< Highest layer the node is linked on */
+    bool deleted;              /**< Tombstone */
+} VectorNode;
+
+/**
+ * @brief Node and its distance to the current query
+ */
+typedef struct {
+    float distance;
+    uint32_t node;
+} VectorCandidate;
+
+/**
+ * @brief Binary heap of candidates
+ */
+typedef struct {
+    VectorCandidate *items;
+    uint32_t count;
+    uint32_t capacity;
+    bool max_first;            /**< Farthest on top (results) instead of nearest (frontier) */
+} VectorHeap;
+
+/**
+ * @brief Index state
+ */
+struct VectorIndex {
+    uint32_t dimensions;                  /**< Caller's vector length */
+    uint32_t stride;                      /**< Stored vector length (padded) */
+    VectorMetric metric;                  /**< Distance metric */
+    VectorKernel kernel;                  /**< Kernel in use */
+    VectorKernelFunction dot;             /**< Dot product kernel */
+    VectorKernelFunction l2;              /**< Squared distance kernel */
+    uint32_t max_neighbors;               /**< M: links per upper layer */
+    uint32_t max_neighbors0;              /**< Links on layer 0 (2 * M) */
+    uint32_t ef_construction;             /**< Candidate list size while inserting */
+    double level_multiplier;              /**< 1 / ln(M) */
+    uint64_t random_state;                /**< Level generator state */
+
+    VectorNode *nodes;                    /**< Node attributes */
+    float *vectors;                       /**< capacity * stride floats */
+    uint32_t *links0;                     /**< capacity * (max_neighbors0 + 1) */
+    uint32_t **upper_links;               /**< Per node: level * (max_neighbors + 1), or NULL */
+    uint32_t node_count;                  /**< Nodes including tombstones */
+    uint32_t node_capacity;               /**< Allocated nodes */
+    uint32_t live_count;                  /**< Nodes that are not tombstones */
+    uint32_t entry_point;                 /**< Entry node, or VINDEX_NONE when empty */
+    uint32_t max_level;                   /**< Entry node's level */
+
+    uint32_t *id_slots;                   /**< Open-addressing ID map (node + 1, 0 if empty) */
+    uint32_t id_capacity;                 /**< Power of two */
+
+    uint32_t *visited;                    /**< Per-node visit epoch */
+    uint32_t visit_epoch;                 /**< Current epoch */
+    float *query;                         /**< Padded, normalized query scratch */
+    VectorHeap frontier;                  /**< Search scratch */
+    VectorHeap results;                   /**< Search scratch */
+    VectorCandidate *selection;           /**< Neighbor selection scratch */
+    uint32_t selection_capacity;          /**< Allocated selection entries */
+};
+
+/**
+ * @brief Portable dot product over whole 16-float blocks
+ */
+static float dot_scalar(const float *a, const float *b, uint32_t length) {
+    float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    for (uint32_t i = 0; i < length; i += 4) {
+        sum[0] += a[i] * b[i];
+        sum[1] += a[i + 1] * b[i + 1];
+        sum[2] += a[i + 2] * b[i + 2];
+        sum[3] += a[i + 3] * b[i + 3];
+    }
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+/**
+ * @brief Portable squared distance over whole 16-float blocks
+ */
+static float l2_scalar(const float *a, const float *b, uint32_t length) {
+    float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    for (uint32_t i = 0; i < length; i += 4) {
+        for (int lane = 0; lane < 4; lane++) {
+            float difference = a[i + lane] - b[i + lane];
+            sum[lane] += difference * difference;
+        }
+    }
+    return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+#ifdef VINDEX_HAVE_X86
+/**
+ * @brief Sum the lanes of an AVX register
+ */
+__attribute__((target("avx2,fma")))
+static float sum_avx2(__m256 value) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+}
+
+__attribute__((target("avx2,fma")))
+static float dot_avx2(const float *a, const float *b, uint32_t length) {
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    for (uint32_t i = 0; i < length; i += 16) {
+        sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+        sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), sum1);
+    }
+    return sum_avx2(_mm256_add_ps(sum0, sum1));
+}
+
+__attribute__((target("avx2,fma")))
+static float l2_avx2(const float *a, const float *b, uint32_t length) {
+    __m256 sum0 = _mm256_setzero_ps();
+    __m256 sum1 = _mm256_setzero_ps();
+    for (uint32_t i = 0; i < length; i += 16) {
+        __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+        sum0 = _mm256_fmadd_ps(d0, d0, sum0);
+        sum1 = _mm256_fmadd_ps(d1, d1, sum1);
+    }
+    return sum_avx2(_mm256_add_ps(sum0, sum1));
+}
+
+__attribute__((target("avx512f")))
+static float dot_avx512(const float *a, const float *b, uint32_t length) {
+    __m512 sum = _mm512_setzero_ps();
+    for (uint32_t i = 0; i < length; i += 16) {
+        sum = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), sum);
+    }
+    return _mm512_reduce_add_ps(sum);
+}
+
+__attribute__((target("avx512f")))
+static float l2_avx512(const float *a, const float *b, uint32_t length) {
+    __m512 sum = _mm512_setzero_ps();
+    for (uint32_t i = 0; i < length; i += 16) {
+        __m512 difference = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        sum = _mm512_fmadd_ps(difference, difference, sum);
+    }
+    return _mm512_reduce_add_ps(sum);
+}
+#endif
+
+/**
+ * @brief Install the requested kernel, resolving AUTO
+ *
+ * @return false if the CPU cannot run the kernel
+ */
+static bool select_kernel(VectorIndex *index, VectorKernel kernel) {
+#ifdef VINDEX_HAVE_X86
+    __builtin_cpu_init();
+    bool has_avx512 = __builtin_cpu_supports("avx512f");
+    bool has_avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    if (kernel == VINDEX_KERNEL_AUTO) {
+        kernel = has_avx512 ? VINDEX_KERNEL_AVX512 : has_avx2 ? VINDEX_KERNEL_AVX2
+                                                              : VINDEX_KERNEL_SCALAR;
+    }
+    if (kernel == VINDEX_KERNEL_AVX512 && has_avx512) {
+        index->dot = dot_avx512;
+        index->l2 = l2_avx512;
+    } else if (kernel == VINDEX_KERNEL_AVX2 && has_avx2) {
+        index->dot = dot_avx2;
+        index->l2 = l2_avx2;
+    } else if (kernel == VINDEX_KERNEL_SCALAR) {
+        index->dot = dot_scalar;
+        index->l2 = l2_scalar;
+    } else {
+        return false;
+    }
+#else
+    if (kernel == VINDEX_KERNEL_AUTO) {
+        kernel = VINDEX_KERNEL_SCALAR;
+    }
+    if (kernel != VINDEX_KERNEL_SCALAR) {
+        return false;
+    }
+    index->dot = dot_scalar;
+    index->l2 = l2_scalar;
+#endif
+    index->kernel = kernel;
+    return true;
+}
+
+/**
+ * @brief Distance between two padded vectors under the index metric
+ */
+static float distance(const VectorIndex *index, const float *a, const float *b) {
+    return index->metric == VINDEX_METRIC_COSINE ? 1.0f - index->dot(a, b, index->stride)
+                                                 : index->l2(a, b, index->stride);
+}
+
+/**
+ * @brief Stored vector of a node
+ */
+static float *node_vector(const VectorIndex *index, uint32_t node) {
+    return index->vectors + (size_t)node * index->stride;
+}
+
+/**
+ * @brief Link block of a node on a layer: [count, links...]
+ */
+static uint32_t *node_links(const VectorIndex *index, uint32_t node, uint32_t level) {
+    if (level == 0) {
+        return index->links0 + (size_t)node * (index->max_neighbors0 + 1);
+    }
+    return index->upper_links[node] + (size_t)(level - 1) * (index->max_neighbors + 1);
+}
+
+/**
+ * @brief Link capacity on a layer
+ */
+static uint32_t level_capacity(const VectorIndex *index, uint32_t level) {
+    return level == 0 ? index->max_neighbors0 : index->max_neighbors;
+}
+
+/**
+ * @brief Whether a heap entry belongs above another
+ */
+static bool heap_before(const VectorHeap *heap, const VectorCandidate *a, const VectorCandidate *b) {
+    return heap->max_first ? a->distance > b->distance : a->distance < b->distance;
+}
+
+static bool heap_push(VectorHeap *heap, float distance, uint32_t node) {
+    if (heap->count == heap->capacity) {
+        uint32_t capacity = heap->capacity ? heap->capacity * 2 : 64;
+        VectorCandidate *items = (VectorCandidate *)realloc(heap->items,
+                                                            capacity * sizeof(VectorCandidate));
+        if (!items) {
+            return false;
+        }
+        heap->items = items;
+        heap->capacity = capacity;
+    }
+
+    uint32_t i = heap->count++;
+    VectorCandidate item = { distance, node };
+    while (i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if (!heap_before(heap, &item, &heap->items[parent])) {
+            break;
+        }
+        heap->items[i] = heap->items[parent];
+        i = parent;
+    }
+    heap->items[i] = item;
+    return true;
+}
+
+static VectorCandidate heap_pop(VectorHeap *heap) {
+    VectorCandidate top = heap->items[0];
+    VectorCandidate last = heap->items[--heap->count];
+    uint32_t i = 0;
+    for (;;) {
+        uint32_t child = 2 * i + 1;
+        if (child >= heap->count) {
+            break;
+        }
+        if (child + 1 < heap->count && heap_before(heap, &heap->items[child + 1], &heap->items[child])) {
+            child++;
+        }
+        if (!heap_before(heap, &heap->items[child], &last)) {
+            break;
+        }
+        heap->items[i] = heap->items[child];
+        i = child;
+    }
+    if (heap->count > 0) {
+        heap->items[i] = last;
+    }
+    return top;
+}
+
+/**
+ * @brief Start a new visit epoch
+ */
+static uint32_t begin_visit(VectorIndex *index) {
+    if (++index->visit_epoch == 0) {
+        memset(index->visited, 0, index->node_capacity * sizeof(uint32_t));
+        index->visit_epoch = 1;
+    }
+    return index->visit_epoch;
+}
+
+/**
+ * @brief Whether a node may be returned to the caller
+ */
+static bool node_accepted(const VectorNode *node, const VectorFilter *filter) {
+    if (node->deleted) {
+        return false;
+    }
+    if (!filter) {
+        return true;
+    }
+    return node->resonance_level >= filter->min_resonance &&
+           (filter->type_mask == 0 || (node->type < 32 && (filter->type_mask & (1u << node->type))));
+}
+
+/**
+ * @brief Best-first search of one layer
+ *
+ * Leaves up to ef nodes nearest the query in index->results (a max-heap).
+ * With accepted_only, only nodes passing the filter enter the results,
+ * while every node can still be walked through.
+ */
+static bool search_layer(VectorIndex *index, const float *query, uint32_t entry, uint32_t ef,
+                         uint32_t level, bool accepted_only, const VectorFilter *filter) {
+    VectorHeap *frontier = &index->frontier;
+    VectorHeap *results = &index->results;
+    frontier->count = 0;
+    results->count = 0;
+
+    uint32_t epoch = begin_visit(index);
+    float entry_distance = distance(index, query, node_vector(index, entry));
+    index->visited[entry] = epoch;
+    if (!heap_push(frontier, entry_distance, entry)) {
+        return false;
+    }
+    if ((!accepted_only || node_accepted(&index->nodes[entry], filter)) &&
+        !heap_push(results, entry_distance, entry)) {
+        return false;
+    }
+
+    while (frontier->count > 0) {
+        VectorCandidate nearest = heap_pop(frontier);
+        if (results->count >= ef && nearest.distance > results->items[0].distance) {
+            break;
+        }
+
+        const uint32_t *links = node_links(index, nearest.node, level);
+        for (uint32_t i = 1; i <= links[0]; i++) {
+            uint32_t neighbor = links[i];
+            if (index->visited[neighbor] == epoch) {
+                continue;
+            }
+            index->visited[neighbor] = epoch;
+            float neighbor_distance = distance(index, query, node_vector(index, neighbor));
+            if (results->count < ef || neighbor_distance < results->items[0].distance) {
+                if (!heap_push(frontier, neighbor_distance, neighbor)) {
+                    return false;
+                }
+                if (!accepted_only || node_accepted(&index->nodes[neighbor], filter)) {
+                    if (!heap_push(results, neighbor_distance, neighbor)) {
+                        return false;
+                    }
+                    if (results->count > ef) {
+                        heap_pop(results);
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Greedy descent from the entry point to the given layer
+ */
+static uint32_t descend(const VectorIndex *index, const float *query, uint32_t target_level) {
+    uint32_t current = index->entry_point;
+    float current_distance = distance(index, query, node_vector(index, current));
+    for (uint32_t level = index->max_level; level > target_level; level--) {
+        bool moved = true;
+        while (moved) {
+            moved = false;
+            const uint32_t *links = node_links(index, current, level);
+            for (uint32_t i = 1; i <= links[0]; i++) {
+                float d = distance(index, query, node_vector(index, links[i]));
+                if (d < current_distance) {
+                    current_distance = d;
+                    current = links[i];
+                    moved = true;
+                }
+            }
+        }
+    }
+    return current;
+}
+
+/**
+ * @brief Choose up to limit diverse neighbors from candidates sorted nearest first
+ *
+ * A candidate is kept when it is closer to the base node than to any
+ * neighbor already kept; leftover room is filled with the nearest of the
+ * rest, so sparse regions stay connected.
+ */
+static uint32_t select_neighbors(const VectorIndex *index, VectorCandidate *candidates,
+                                 uint32_t count, uint32_t limit, uint32_t *selected) {
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < count && kept < limit; i++) {
+        const float *vector = node_vector(index, candidates[i].node);
+        bool diverse = true;
+        for (uint32_t j = 0; j < kept && diverse; j++) {
+            diverse = distance(index, vector, node_vector(index, selected[j])) >= candidates[i].distance;
+        }
+        if (diverse) {
+            selected[kept++] = candidates[i].node;
+            candidates[i].node = VINDEX_NONE;
+        }
+    }
+    for (uint32_t i = 0; i < count && kept < limit; i++) {
+        if (candidates[i].node != VINDEX_NONE) {
+            selected[kept++] = candidates[i].node;
+        }
+    }
+    return kept;
+}
+
+/**
+ * @brief Ensure the selection scratch can hold a number of candidates
+ */
+static bool reserve_selection(VectorIndex *index, uint32_t count) {
+    if (count <= index->selection_capacity) {
+        return true;
+    }
+    VectorCandidate *selection = (VectorCandidate *)realloc(index->selection,
+                                                            count * sizeof(VectorCandidate));
+    if (!selection) {
+        return false;
+    }
+    index->selection = selection;
+    index->selection_capacity = count;
+    return true;
+}
+
+/**
+ * @brief Add a back link from a neighbor to a new node
+ *
+ * A full neighbor swaps its farthest link for the new node if the new
+ * node is closer. Re-running the diversity heuristic here gives slightly
+ * better graphs but costs a quadratic number of distances per link.
+ */
+static void link_back(VectorIndex *index, uint32_t neighbor, uint32_t node, uint32_t level) {
+    uint32_t *links = node_links(index, neighbor, level);
+    if (links[0] < level_capacity(index, level)) {
+        links[++links[0]] = node;
+        return;
+    }
+
+    const float *base = node_vector(index, neighbor);
+    uint32_t farthest = 0;
+    float farthest_distance = distance(index, base, node_vector(index, node));
+    for (uint32_t i = 1; i <= links[0]; i++) {
+        float d = distance(index, base, node_vector(index, links[i]));
+        if (d > farthest_distance) {
+            farthest = i;
+            farthest_distance = d;
+        }
+    }
+    if (farthest != 0) {
+        links[farthest] = node;
+    }
+}
+
+/**
+ * @brief Draw a node level from the geometric distribution
+ */
+static uint32_t random_level(VectorIndex *index) {
+    /* xorshift64* */
+    index->random_state ^= index->random_state >> 12;
+    index->random_state ^= index->random_state << 25;
+    index->random_state ^= index->random_state >> 27;
+    uint64_t bits = index->random_state * 0x2545F4914F6CDD1DULL;
+    double uniform = ((double)(bits >> 11) + 1.0) / 9007199254740993.0;
+    double level = -log(uniform) * index->level_multiplier;
+    return level >= VINDEX_MAX_LEVEL ? VINDEX_MAX_LEVEL : (uint32_t)level;
+}
+
+/**
+ * @brief Hash an ID for the open-addressing map
+ */
+static uint32_t id_hash(uint64_t id) {
+    id ^= id >> 33;
+    id *= 0xFF51AFD7ED558CCDULL;
+    id ^= id >> 33;
+    return (uint32_t)id;
+}
+
+/**
+ * @brief Find the map slot holding an ID, or the empty slot where it would go
+ */
+static uint32_t id_slot(const VectorIndex *index, uint64_t id) {
+    uint32_t mask = index->id_capacity - 1;
+    uint32_t slot = id_hash(id) & mask;
+    while (index->id_slots[slot] != 0 && index->nodes[index->id_slots[slot] - 1].id != id) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/**
+ * @brief Live node holding an ID, or VINDEX_NONE
+ */
+static uint32_t find_node(const VectorIndex *index, uint64_t id) {
+    if (index->id_capacity == 0) {
+        return VINDEX_NONE;
+    }
+    uint32_t slot = id_slot(index, id);
+    if (index->id_slots[slot] == 0) {
+        return VINDEX_NONE;
+    }
+    uint32_t node = index->id_slots[slot] - 1;
+    return index->nodes[node].deleted ? VINDEX_NONE : node;
+}
+
+/**
+ * @brief Rebuild the ID map at a capacity holding every node at half load
+ */
+static bool rebuild_id_map(VectorIndex *index, uint32_t nodes) {
+    uint32_t capacity = 64;
+    while (capacity < nodes * 2) {
+        capacity *= 2;
+    }
+    uint32_t *slots = (uint32_t *)calloc(capacity, sizeof(uint32_t));
+    if (!slots) {
+        return false;
+    }
+    free(index->id_slots);
+    index->id_slots = slots;
+    index->id_capacity = capacity;
+
+    for (uint32_t node = 0; node < index->node_count; node++) {
+        if (!index->nodes[node].deleted) {
+            index->id_slots[id_slot(index, index->nodes[node].id)] = node + 1;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Grow node storage to hold at least the given number of nodes
+ */
+static bool reserve_nodes(VectorIndex *index, uint32_t nodes) {
+    if (nodes > index->node_capacity) {
+        uint32_t capacity = index->node_capacity ? index->node_capacity : VINDEX_INITIAL_CAPACITY;
+        while (capacity < nodes) {
+            capacity *= 2;
+        }
+
+        size_t vector_bytes = (size_t)capacity * index->stride * sizeof(float);
+        float *vectors = (float *)aligned_alloc(VINDEX_ALIGNMENT, vector_bytes);
+        VectorNode *node_array = (VectorNode *)realloc(index->nodes, capacity * sizeof(VectorNode));
+        if (node_array) {
+            index->nodes = node_array;
+        }
+        uint32_t *links0 = node_array ? (uint32_t *)realloc(
+            index->links0, (size_t)capacity * (index->max_neighbors0 + 1) * sizeof(uint32_t)) : NULL;
+        if (links0) {
+            index->links0 = links0;
+        }
+        uint32_t **upper = links0 ? (uint32_t **)realloc(index->upper_links,
+                                                         capacity * sizeof(uint32_t *)) : NULL;
+        if (upper) {
+            index->upper_links = upper;
+        }
+        uint32_t *visited = upper ? (uint32_t *)realloc(index->visited,
+                                                        capacity * sizeof(uint32_t)) : NULL;
+        if (visited) {
+            index->visited = visited;
+        }
+        if (!vectors || !visited) {
+            free(vectors);
+            return false;
+        }
+
+        if (index->vectors) {
+            memcpy(vectors, index->vectors, (size_t)index->node_count * index->stride * sizeof(float));
+            free(index->vectors);
+        }
+        index->vectors = vectors;
+        memset(index->visited + index->node_capacity, 0,
+               (capacity - index->node_capacity) * sizeof(uint32_t));
+        index->node_capacity = capacity;
+    }
+
+    if (nodes * 2 > index->id_capacity && !rebuild_id_map(index, nodes)) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Copy a caller's vector into padded storage
+ *
+ * @return false for a cosine vector with no direction
+ */
+static bool load_vector(const VectorIndex *index, const float *vector, float *padded) {
+    memcpy(padded, vector, index->dimensions * sizeof(float));
+    memset(padded + index->dimensions, 0, (index->stride - index->dimensions) * sizeof(float));
+    if (index->metric != VINDEX_METRIC_COSINE) {
+        return true;
+    }
+
+    float norm = sqrtf(dot_scalar(padded, padded, index->stride));
+    if (!(norm > 0.0f) || !isfinite(norm)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < index->dimensions; i++) {
+        padded[i] /= norm;
+    }
+    return true;
+}
+
+
+/**
+ * @brief Insert one vector into reserved storage
+ */
+static bool insert_node(VectorIndex *index, const VectorEntry *entry) {
+    uint32_t node = index->node_count;
+    float *vector = node_vector(index, node);
+    if (!load_vector(index, entry->vector, vector)) {
+        return false;
+    }
+
+    uint32_t level = random_level(index);
+    index->upper_links[node] = NULL;
+    if (level > 0) {
+        index->upper_links[node] = (uint32_t *)malloc((size_t)level * (index->max_neighbors + 1) *
+                                                      sizeof(uint32_t));
+        if (!index->upper_links[node]) {
+            return false;
+        }
+    }
+    index->nodes[node] = (VectorNode){
+        entry->id, entry->resonance_level, entry->type, (uint8_t)level, false
+    };
+    for (uint32_t l = 0; l <= level; l++) {
+        node_links(index, node, l)[0] = 0;
+    }
+
+    /* Link the node into each layer it shares with the graph */
+    bool linked = false;
+    if (index->entry_point != VINDEX_NONE) {
+        uint32_t top = level < index->max_level ? level : index->max_level;
+        uint32_t current = descend(index, vector, top);
+        for (uint32_t l = top + 1; l-- > 0;) {
+            if (!search_layer(index, vector, current, index->ef_construction, l, false, NULL)) {
+                goto abandon;
+            }
+
+            VectorHeap *results = &index->results;
+            uint32_t count = results->count;
+            if (!reserve_selection(index, count)) {
+                goto abandon;
+            }
+            for (uint32_t i = count; i-- > 0;) {
+                index->selection[i] = heap_pop(results);
+            }
+            current = index->selection[0].node;
+
+            uint32_t *links = node_links(index, node, l);
+            links[0] = select_neighbors(index, index->selection, count, index->max_neighbors, links + 1);
+            for (uint32_t i = 1; i <= links[0]; i++) {
+                link_back(index, links[i], node, l);
+            }
+            linked = linked || links[0] > 0;
+        }
+    }
+
+    /* The node is committed; retire any older entry with the same ID */
+    uint32_t slot = id_slot(index, entry->id);
+    if (index->id_slots[slot] != 0 && !index->nodes[index->id_slots[slot] - 1].deleted) {
+        index->nodes[index->id_slots[slot] - 1].deleted = true;
+        index->live_count--;
+    }
+    index->id_slots[slot] = node + 1;
+    index->node_count++;
+    index->live_count++;
+    if (index->entry_point == VINDEX_NONE || level > index->max_level) {
+        index->entry_point = node;
+        index->max_level = level;
+    }
+    return true;
+
+abandon:
+    /* Once other nodes link to it the node has to stay, as a tombstone */
+    if (linked) {
+        index->nodes[node].deleted = true;
+        index->node_count++;
+    } else {
+        free(index->upper_links[node]);
+        index->upper_links[node] = NULL;
+    }
+    return false;
+}
+
+/**
+ * @brief Rebuild the graph from the live entries, dropping tombstones
+ */
+static bool rebuild(VectorIndex *index) {
+    uint32_t live = index->live_count;
+    VectorEntry *entries = (VectorEntry *)malloc((live ? live : 1) * sizeof(VectorEntry));
+    float *vectors = (float *)malloc(((size_t)live ? live : 1) * index->stride * sizeof(float));
+    if (!entries || !vectors) {
+        free(entries);
+        free(vectors);
+        return false;
+    }
+
+    uint32_t count = 0;
+    for (uint32_t node = 0; node < index->node_count; node++) {
+        if (!index->nodes[node].deleted) {
+            memcpy(vectors + (size_t)count * index->stride, node_vector(index, node),
+                   index->stride * sizeof(float));
+            entries[count] = (VectorEntry){
+                index->nodes[node].id, vectors + (size_t)count * index->stride,
+                index->nodes[node].resonance_level, index->nodes[node].type
+            };
+            count++;
+        }
+        free(index->upper_links[node]);
+        index->upper_links[node] = NULL;
+    }
+
+    index->node_count = 0;
+    index->live_count = 0;
+    index->entry_point = VINDEX_NONE;
+    index->max_level = 0;
+    memset(index->id_slots, 0, index->id_capacity * sizeof(uint32_t));
+
+    bool ok = true;
+    for (uint32_t i = 0; i < count && ok; i++) {
+        ok = insert_node(index, &entries[i]);
+    }
+    free(entries);
+    free(vectors);
+    return ok;
+}
+
+/**
+ * @brief Rebuild once tombstones outnumber live entries
+ */
+static void collect_tombstones(VectorIndex *index) {
+    if (index->node_count - index->live_count > index->live_count + VINDEX_REBUILD_SLACK &&
+        !rebuild(index)) {
+        printf("Vector index rebuild failed\n");
+    }
+}
+
+/**
+ * @brief Create an index
+ */
+VectorIndex *vindex_create(const VectorIndexOptions *options) {
+    if (!options || options->dimensions == 0 || options->dimensions > (1u << 20) ||
+        (options->metric != VINDEX_METRIC_COSINE && options->metric != VINDEX_METRIC_L2)) {
+        return NULL;
+    }
+
+    VectorIndex *index = (VectorIndex *)calloc(1, sizeof(VectorIndex));
+    if (!index) {
+        return NULL;
+    }
+    if (!select_kernel(index, options->kernel)) {
+        free(index);
+        return NULL;
+    }
+
+    index->dimensions = options->dimensions;
+    index->stride = (options->dimensions + VINDEX_LANES - 1) / VINDEX_LANES * VINDEX_LANES;
+    index->metric = options->metric;
+    index->max_neighbors = options->max_neighbors >= 2 ? options->max_neighbors
+                                                        : VINDEX_DEFAULT_NEIGHBORS;
+    index->max_neighbors0 = index->max_neighbors * 2;
+    index->ef_construction = options->ef_construction ? options->ef_construction
+                                                      : VINDEX_DEFAULT_EF_CONSTRUCTION;
+    index->level_multiplier = 1.0 / log((double)index->max_neighbors);
+    index->random_state = 0x9E3779B97F4A7C15ULL;
+    index->entry_point = VINDEX_NONE;
+    index->frontier.max_first = false;
+    index->results.max_first = true;
+
+    index->query = (float *)aligned_alloc(VINDEX_ALIGNMENT,
+                                          (index->stride * sizeof(float) + VINDEX_ALIGNMENT - 1) /
+                                          VINDEX_ALIGNMENT * VINDEX_ALIGNMENT);
+    if (!index->query || !reserve_nodes(index, 1)) {
+        vindex_destroy(index);
+        return NULL;
+    }
+    return index;
+}
+
+/**
+ * @brief Destroy an index
+ */
+void vindex_destroy(VectorIndex *index) {
+    if (!index) {
+        return;
+    }
+    for (uint32_t node = 0; node < index->node_count; node++) {
+        free(index->upper_links[node]);
+    }
+    free(index->nodes);
+    free(index->vectors);
+    free(index->links0);
+    free(index->upper_links);
+    free(index->id_slots);
+    free(index->visited);
+    free(index->query);
+    free(index->frontier.items);
+    free(index->results.items);
+    free(index->selection);
+    free(index);
+}
+
+/**
+ * @brief Name of the distance kernel an index uses
+ */
+const char *vindex_kernel_name(const VectorIndex *index) {
+    if (!index) {
+        return NULL;
+    }
+    switch (index->kernel) {
+        case VINDEX_KERNEL_AVX512: return "avx512";
+        case VINDEX_KERNEL_AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+/**
+ * @brief Number of live entries
+ */
+uint32_t vindex_count(const VectorIndex *index) {
+    return index ? index->live_count : 0;
+}
+
+/**
+ * @brief Insert or replace one vector
+ */
+bool vindex_insert(VectorIndex *index, const VectorEntry *entry) {
+    return vindex_insert_batch(index, entry, 1) == 1;
+}
+
+/**
+ * @brief Insert or replace several vectors
+ */
+uint32_t vindex_insert_batch(VectorIndex *index, const VectorEntry *entries, uint32_t count) {
+    if (!index || !entries || count == 0 || count > UINT32_MAX / 2 - index->node_count ||
+        !reserve_nodes(index, index->node_count + count)) {
+        return 0;
+    }
+
+    uint32_t inserted = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (entries[i].vector && insert_node(index, &entries[i])) {
+            inserted++;
+        }
+    }
+    collect_tombstones(index);
+    return inserted;
+}
+
+/**
+ * @brief Remove a vector
+ */
+bool vindex_remove(VectorIndex *index, uint64_t id) {
+    uint32_t node = index ? find_node(index, id) : VINDEX_NONE;
+    if (node == VINDEX_NONE) {
+        return false;
+    }
+    index->nodes[node].deleted = true;
+    index->live_count--;
+    collect_tombstones(index);
+    return true;
+}
+
+/**
+ * @brief Stored copy of a vector
+ */
+const float *vindex_get(const VectorIndex *index, uint64_t id) {
+    uint32_t node = index ? find_node(index, id) : VINDEX_NONE;
+    return node == VINDEX_NONE ? NULL : node_vector(index, node);
+}
+
+/**
+ * @brief Distance from a query to one stored vector
+ */
+bool vindex_distance_to(VectorIndex *index, const float *query, uint64_t id, float *result) {
+    uint32_t node = index && query && result ? find_node(index, id) : VINDEX_NONE;
+    if (node == VINDEX_NONE || !load_vector(index, query, index->query)) {
+        return false;
+    }
+    *result = distance(index, index->query, node_vector(index, node));
+    return true;
+}
+
+/**
+ * @brief Exhaustive filtered search
+ */
+static uint32_t scan(VectorIndex *index, uint32_t k, const VectorFilter *filter, VectorMatch *matches) {
+    VectorHeap *results = &index->results;
+    results->count = 0;
+    for (uint32_t node = 0; node < index->node_count; node++) {
+        if (!node_accepted(&index->nodes[node], filter)) {
+            continue;
+        }
+        float d = distance(index, index->query, node_vector(index, node));
+        if (results->count < k) {
+            if (!heap_push(results, d, node)) {
+                return 0;
+            }
+        } else if (d < results->items[0].distance) {
+            heap_pop(results);
+            heap_push(results, d, node);
+        }
+    }
+
+    uint32_t count = results->count;
+    for (uint32_t i = count; i-- > 0;) {
+        VectorCandidate candidate = heap_pop(results);
+        matches[i] = (VectorMatch){ index->nodes[candidate.node].id, candidate.distance };
+    }
+    return count;
+}
+
+/**
+ * @brief Find the nearest stored vectors to a query
+ */
+uint32_t vindex_search(VectorIndex *index, const float *query, uint32_t k, uint32_t ef,
+                       const VectorFilter *filter, VectorMatch *matches) {
+    if (!index || !query || !matches || k == 0 || index->live_count == 0 ||
+        !load_vector(index, query, index->query)) {
+        return 0;
+    }
+    if (ef < k) {
+        ef = k;
+    }
+
+    uint32_t entry = descend(index, index->query, 0);
+    if (!search_layer(index, index->query, entry, ef, 0, true, filter)) {
+        return 0;
+    }
+
+    /* Keep the k nearest of the ef found */
+    VectorHeap *results = &index->results;
+    while (results->count > k) {
+        heap_pop(results);
+    }
+    uint32_t count = results->count;
+    if (count < k && count < index->live_count) {
+        return scan(index, k, filter, matches);
+    }
+    for (uint32_t i = count; i-- > 0;) {
+        VectorCandidate candidate = heap_pop(results);
+        matches[i] = (VectorMatch){ index->nodes[candidate.node].id, candidate.distance };
+    }
+    return count;
+}
+
+/**
+ * @brief Whether a byte is part of a word
+ */
+static bool is_word_byte(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c >= 0x80;
+}
+
+/**
+ * @brief Embed text by hashing its words
+ */
+bool vindex_embed_text(const char *const *texts, const size_t *lengths, uint32_t count,
+                       float *embedding, uint32_t dimensions) {
+    if (!embedding || dimensions == 0) {
+        return false;
+    }
+    memset(embedding, 0, dimensions * sizeof(float));
+
+    bool any = false;
+    for (uint32_t t = 0; texts && lengths && t < count; t++) {
+        const unsigned char *text = (const unsigned char *)texts[t];
+        size_t length = text ? lengths[t] : 0;
+        size_t i = 0;
+        while (i < length) {
+            while (i < length && !is_word_byte(text[i])) i++;
+            if (i == length) {
+                break;
+            }
+
+            /* FNV-1a over the lowercased word */
+            uint64_t hash = 0xCBF29CE484222325ULL;
+            while (i < length && is_word_byte(text[i])) {
+                unsigned char c = text[i++];
+                if (c >= 'A' && c <= 'Z') c = (unsigned char)(c | 0x20);
+                hash = (hash ^ c) * 0x100000001B3ULL;
+            }
+            hash ^= hash >> 29;
+            embedding[(hash >> 1) % dimensions] += (hash & 1) ? -1.0f : 1.0f;
+            any = true;
+        }
+    }
+    if (!any) {
+        return false;
+    }
+
+    float norm = 0.0f;
+    for (uint32_t i = 0; i < dimensions; i++) {
+        norm += embedding[i] * embedding[i];
+    }
+    norm = sqrtf(norm);
+    if (!(norm > 0.0f)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < dimensions; i++) {
+        embedding[i] /= norm;
+    }
+    return true;
+}
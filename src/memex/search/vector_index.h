@@ -0,0 +1,196 @@
+/**
+ * @file vector_index.h
+ * @brief Approximate nearest-neighbor index over Memex embeddings
+ *
+ * A hierarchical navigable small world (HNSW) graph over fixed-size float
+ * vectors. Searches walk the sparse upper layers to a good entry point,
+ * then run a best-first search over the dense bottom layer, so queries
+ * touch a small fraction of the vectors. Each vector carries a resonance
+ * level and a type so searches can be filtered.
+ *
+ * Distance kernels use AVX-512 or AVX2 when the CPU supports them and a
+ * portable scalar loop otherwise.
+ *
+ * An index is not thread-safe; callers serialize access.
+ */
+
+#ifndef CTRLXT_MEMEX_VECTOR_INDEX_H
+#define CTRLXT_MEMEX_VECTOR_INDEX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Opaque index handle
+ */
+typedef struct VectorIndex VectorIndex;
+
+/**
+ * @brief Distance metrics
+ */
+typedef enum {
+    VINDEX_METRIC_COSINE,   /**< 1 - cosine similarity (vectors are normalized on insert) */
+    VINDEX_METRIC_L2        /**< Squared Euclidean distance */
+} VectorMetric;
+
+/**
+ * @brief Distance kernels
+ */
+typedef enum {
+    VINDEX_KERNEL_AUTO,     /**< Best kernel the CPU supports */
+    VINDEX_KERNEL_SCALAR,   /**< Portable C */
+    VINDEX_KERNEL_AVX2,     /**< AVX2 + FMA */
+    VINDEX_KERNEL_AVX512    /**< AVX-512F */
+} VectorKernel;
+
+/**
+ * @brief Index options
+ */
+typedef struct {
+    uint32_t dimensions;       /**< Vector length */
+    VectorMetric metric;       /**< Distance metric */
+    uint32_t max_neighbors;    /**< Links per node per layer (0 for the default of 16) */
+    uint32_t ef_construction;  /**< Candidate list size while inserting (0 for the default of 200) */
+    VectorKernel kernel;       /**< Distance kernel */
+} VectorIndexOptions;
+
+/**
+ * @brief Vector to insert
+ */
+typedef struct {
+    uint64_t id;               /**< Caller's identifier (inserting an existing ID replaces it) */
+    const float *vector;       /**< dimensions floats */
+    uint32_t resonance_level;  /**< Resonance level used for filtering */
+    uint32_t type;             /**< Type used for filtering (below 32) */
+} VectorEntry;
+
+/**
+ * @brief Search filter
+ */
+typedef struct {
+    uint32_t min_resonance;    /**< Minimum resonance level of a match */
+    uint32_t type_mask;        /**< Bit (1 << type) per accepted type, 0 for all */
+} VectorFilter;
+
+/**
+ * @brief Search match
+ */
+typedef struct {
+    uint64_t id;               /**< Matched entry */
+    float distance;            /**< Distance under the index metric */
+} VectorMatch;
+
+/**
+ * @brief Create an index
+ *
+ * @param options Index options
+ * @return Index, or NULL if the options are invalid, the requested kernel
+ *         is not supported by this CPU, or allocation failed
+ */
+VectorIndex *vindex_create(const VectorIndexOptions *options);
+
+/**
+ * @brief Destroy an index
+ *
+ * @param index Index (may be NULL)
+ */
+void vindex_destroy(VectorIndex *index);
+
+/**
+ * @brief Name of the distance kernel an index uses ("scalar", "avx2" or "avx512")
+ */
+const char *vindex_kernel_name(const VectorIndex *index);
+
+/**
+ * @brief Number of live entries
+ */
+uint32_t vindex_count(const VectorIndex *index);
+
+/**
+ * @brief Insert or replace one vector
+ *
+ * @param index Index
+ * @param entry Entry (cosine indexes reject all-zero vectors)
+ * @return true on success, false on invalid input or allocation failure
+ */
+bool vindex_insert(VectorIndex *index, const VectorEntry *entry);
+
+/**
+ * @brief Insert or replace several vectors
+ *
+ * Storage is grown once for the whole batch.
+ *
+ * @param index Index
+ * @param entries Entries
+ * @param count Number of entries
+ * @return Number of entries inserted (those rejected by vindex_insert are skipped)
+ */
+uint32_t vindex_insert_batch(VectorIndex *index, const VectorEntry *entries, uint32_t count);
+
+/**
+ * @brief Remove a vector
+ *
+ * @param index Index
+ * @param id Entry ID
+ * @return true if the entry existed
+ */
+bool vindex_remove(VectorIndex *index, uint64_t id);
+
+/**
+ * @brief Stored copy of a vector
+ *
+ * @param index Index
+ * @param id Entry ID
+ * @return dimensions floats (normalized for cosine indexes), valid until
+ *         the index next changes, or NULL if the ID is not present
+ */
+const float *vindex_get(const VectorIndex *index, uint64_t id);
+
+/**
+ * @brief Distance from a query to one stored vector
+ *
+ * @param index Index
+ * @param query dimensions floats
+ * @param id Entry ID
+ * @param distance Pointer to store the distance
+ * @return true if the entry exists and the query is valid
+ */
+bool vindex_distance_to(VectorIndex *index, const float *query, uint64_t id, float *distance);
+
+/**
+ * @brief Find the nearest stored vectors to a query
+ *
+ * If the graph search finds fewer than k filtered matches, the index is
+ * scanned exhaustively, so restrictive filters still get exact results.
+ *
+ * @param index Index
+ * @param query dimensions floats
+ * @param k Maximum number of matches
+ * @param ef Candidate list size; larger is slower and more accurate (raised to k)
+ * @param filter Filter (NULL for none)
+ * @param matches Array of at least k matches, filled nearest first
+ * @return Number of matches
+ */
+uint32_t vindex_search(VectorIndex *index, const float *query, uint32_t k, uint32_t ef,
+                       const VectorFilter *filter, VectorMatch *matches);
+
+/**
+ * @brief Embed text by hashing its words
+ *
+ * A signed bag-of-words feature hash over all the given texts,
+ * L2-normalized: texts sharing words have positive cosine similarity.
+ * Used when no model embedding is given. Words are runs of letters,
+ * digits and non-ASCII bytes, folded to lowercase.
+ *
+ * @param texts Texts (entries may be NULL; need not be terminated)
+ * @param lengths Length of each text in bytes
+ * @param count Number of texts
+ * @param embedding Output of dimensions floats
+ * @param dimensions Embedding length
+ * @return true if the texts had at least one word (otherwise the embedding is all zero)
+ */
+bool vindex_embed_text(const char *const *texts, const size_t *lengths, uint32_t count,
+                       float *embedding, uint32_t dimensions);
+
+#endif /* CTRLXT_MEMEX_VECTOR_INDEX_H */
@@ -0,0 +1,828 @@
+/**
+ * @file knowledge_store.c
+ * @brief Persistent record store for Memex knowledge
+ *
+ * Log file: a KnowledgeStoreLogHeader, then records of a
+ * KnowledgeStoreLogRecord header followed by the payload. Each record's
+ * CRC covers everything after its crc field, so a torn append is
+ * detected and cut off on the next load.
+ *
+ * Snapshot file: a KnowledgeStoreSnapshotHeader, the payloads (each
+ * starting on an 8-byte boundary), then the index. Both files carry the
+ * snapshot generation: a new snapshot is written to a temporary file and
+ * renamed into place before the log is reset, so a log whose generation
+ * is older than the snapshot's is already contained in it.
+ */
+
+/* strdup, fdatasync and O_DIRECTORY under -std=c11 */
+#define _XOPEN_SOURCE 700
+
+#include "knowledge_store.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define KSTORE_FORMAT_VERSION 1
+#define KSTORE_ALIGNMENT 8
+
+/* The log is compacted once it is this large and larger than the snapshot */
+#define KSTORE_COMPACT_MIN_BYTES (1024 * 1024)
+
+static const char KSTORE_LOG_MAGIC[8] = { 'K', 'S', 'T', 'L', 'O', 'G', '0', '1' };
+static const char KSTORE_SNAPSHOT_MAGIC[8] = { 'K', 'S', 'T', 'S', 'N', 'A', 'P', '1' };
+
+/**
+ * @brief Log file header
+ */
+typedef struct {
+    char magic[8];             /**< KSTORE_LOG_MAGIC */
+    uint32_t version;          /**< KSTORE_FORMAT_VERSION */
+    uint32_t reserved;         /**< Zero */
+    uint64_t generation;       /**< Snapshot generation the log follows */
+    uint64_t reserved2;        /**< Zero */
+} KnowledgeStoreLogHeader;
+
+/**
+ * @brief Log record header (payload follows)
+ */
+typedef struct {
+    uint32_t size;             /**< Payload size */
+    uint32_t crc;              /**< CRC-32 of the rest of the header and the payload */
+    uint32_t op;               /**< KnowledgeStoreOp */
+    uint32_t kind;             /**< Record kind */
+    uint64_t id;               /**< Record ID */
+} KnowledgeStoreLogRecord;
+
+/**
+ * @brief Snapshot file header
+ */
+typedef struct {
+    char magic[8];             /**< KSTORE_SNAPSHOT_MAGIC */
+    uint32_t version;          /**< KSTORE_FORMAT_VERSION */
+    uint32_t header_size;      /**< sizeof(KnowledgeStoreSnapshotHeader) */
+    uint64_t generation;       /**< Snapshot generation (1 for the first) */
+    uint64_t record_count;     /**< Index entries */
+    uint64_t index_offset;     /**< File offset of the index */
+    uint64_t file_size;        /**< Total file size */
+    uint64_t reserved[2];      /**< Zero */
+} KnowledgeStoreSnapshotHeader;
+
+/**
+ * @brief Snapshot index entry, sorted by (kind, id)
+ */
+typedef struct {
+    uint32_t kind;             /**< Record kind */
+    uint32_t size;             /**< Payload size */
+    uint64_t id;               /**< Record ID */
+    uint64_t offset;           /**< File offset of the payload */
+} KnowledgeStoreIndexEntry;
+
+/**
+ * @brief Store state
+ */
+struct KnowledgeStore {
+    char *directory;                          /**< Data directory */
+    char *log_path;                           /**< <name>.wal */
+    char *snapshot_path;                      /**< <name>.snap */
+    char *temp_path;                          /**< <name>.snap.tmp */
+    int log_fd;                               /**< Log file (O_APPEND) */
+    bool sync_writes;                         /**< Flush every append */
+    bool loaded;                              /**< Whether kstore_load has run */
+    uint64_t generation;                      /**< Current snapshot generation */
+    uint64_t log_bytes;                       /**< Record bytes in the log */
+
+    /* Mapped snapshot */
+    void *map;                                /**< Mapping, or NULL without a snapshot */
+    size_t map_size;                          /**< Mapping size */
+    const KnowledgeStoreIndexEntry *index;    /**< Index inside the mapping */
+    uint64_t record_count;                    /**< Index entries */
+
+    /* Snapshot being written */
+    FILE *writer;                             /**< Temporary snapshot file */
+    KnowledgeStoreIndexEntry *pending;        /**< Index of records written so far */
+    uint64_t pending_count;                   /**< Records written */
+    uint64_t pending_capacity;                /**< Allocated index entries */
+    uint64_t write_offset;                    /**< Next payload offset */
+    bool write_failed;                        /**< Set on a write error */
+};
+
+static uint32_t crc_table[256];
+static bool crc_table_ready = false;
+
+/**
+ * @brief CRC-32 (IEEE 802.3), continuing from a previous value
+ */
+static uint32_t crc32_update(uint32_t crc, const void *data, size_t size) {
+    if (!crc_table_ready) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; bit++) {
+                value = (value >> 1) ^ (0xEDB88320u & (0u - (value & 1)));
+            }
+            crc_table[i] = value;
+        }
+        crc_table_ready = true;
+    }
+
+    const uint8_t *bytes = (const uint8_t *)data;
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) {
+        crc = crc_table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/**
+ * @brief CRC of a log record: header fields after crc, then the payload
+ */
+static uint32_t record_crc(const KnowledgeStoreLogRecord *record, const void *payload) {
+    uint32_t crc = crc32_update(0, &record->op,
+                                sizeof(*record) - offsetof(KnowledgeStoreLogRecord, op));
+    return crc32_update(crc, payload, record->size);
+}
+
+/**
+ * @brief Join a directory and a file name
+ */
+static char *join_path(const char *directory, const char *name, const char *suffix) {
+    size_t length = strlen(directory) + strlen(name) + strlen(suffix) + 2;
+    char *path = (char *)malloc(length);
+    if (path) {
+        snprintf(path, length, "%s/%s%s", directory, name, suffix);
+    }
+    return path;
+}
+
+/**
+ * @brief Write a whole buffer, retrying short writes
+ */
+static bool write_all(int fd, const void *data, size_t size) {
+    const uint8_t *bytes = (const uint8_t *)data;
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+/**
+ * @brief Read a whole buffer at an offset
+ *
+ * @return true if size bytes were read, false at end of file or on error
+ */
+static bool read_all(int fd, void *data, size_t size, uint64_t offset) {
+    uint8_t *bytes = (uint8_t *)data;
+    while (size > 0) {
+        ssize_t got = pread(fd, bytes, size, (off_t)offset);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+        bytes += got;
+        size -= (size_t)got;
+        offset += (uint64_t)got;
+    }
+    return true;
+}
+
+/**
+ * @brief Make a rename in the data directory durable
+ */
+static void sync_directory(const char *directory) {
+    int fd = open(directory, O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+/**
+ * @brief Empty the log and stamp it with the current generation
+ */
+static bool reset_log(KnowledgeStore *store) {
+    KnowledgeStoreLogHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, KSTORE_LOG_MAGIC, sizeof(header.magic));
+    header.version = KSTORE_FORMAT_VERSION;
+    header.generation = store->generation;
+
+    if (ftruncate(store->log_fd, 0) != 0 ||
+        !write_all(store->log_fd, &header, sizeof(header)) ||
+        fdatasync(store->log_fd) != 0) {
+        printf("Failed to reset knowledge store log %s\n", store->log_path);
+        return false;
+    }
+    store->log_bytes = 0;
+    return true;
+}
+
+/**
+ * @brief Drop the current snapshot mapping
+ */
+static void unmap_snapshot(KnowledgeStore *store) {
+    if (store->map) {
+        munmap(store->map, store->map_size);
+    }
+    store->map = NULL;
+    store->map_size = 0;
+    store->index = NULL;
+    store->record_count = 0;
+}
+
+/**
+ * @brief Map and validate the snapshot file, if there is one
+ *
+ * Only the header and index are checked; payloads are not read.
+ */
+static bool map_snapshot(KnowledgeStore *store) {
+    int fd = open(store->snapshot_path, O_RDONLY);
+    if (fd < 0) {
+        store->generation = 0;
+        return errno == ENOENT;
+    }
+
+    struct stat info;
+    bool ok = fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(KnowledgeStoreSnapshotHeader);
+    void *map = ok ? mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (map == MAP_FAILED) {
+        printf("Failed to map knowledge store snapshot %s\n", store->snapshot_path);
+        return false;
+    }
+
+    const KnowledgeStoreSnapshotHeader *header = (const KnowledgeStoreSnapshotHeader *)map;
+    uint64_t size = (uint64_t)info.st_size;
+    ok = memcmp(header->magic, KSTORE_SNAPSHOT_MAGIC, sizeof(header->magic)) == 0 &&
+         header->version == KSTORE_FORMAT_VERSION &&
+         header->header_size == sizeof(KnowledgeStoreSnapshotHeader) &&
+         header->file_size == size &&
+         header->index_offset >= sizeof(KnowledgeStoreSnapshotHeader) &&
+         header->index_offset % KSTORE_ALIGNMENT == 0 &&
+         header->index_offset <= size &&
+         header->record_count <= (size - header->index_offset) / sizeof(KnowledgeStoreIndexEntry) &&
+         header->index_offset + header->record_count * sizeof(KnowledgeStoreIndexEntry) == size;
+
+    const KnowledgeStoreIndexEntry *index =
+        (const KnowledgeStoreIndexEntry *)((const uint8_t *)map + (ok ? header->index_offset : 0));
+    for (uint64_t i = 0; ok && i < header->record_count; i++) {
+        ok = index[i].offset >= sizeof(KnowledgeStoreSnapshotHeader) &&
+             index[i].offset <= header->index_offset &&
+             index[i].size <= header->index_offset - index[i].offset;
+    }
+    if (!ok) {
+        printf("Knowledge store snapshot %s is corrupt\n", store->snapshot_path);
+        munmap(map, (size_t)size);
+        return false;
+    }
+
+    store->map = map;
+    store->map_size = (size_t)size;
+    store->index = index;
+    store->record_count = header->record_count;
+    store->generation = header->generation;
+    return true;
+}
+
+/**
+ * @brief Open or create a store
+ */
+KnowledgeStore *kstore_open(const char *directory, const char *name, bool sync_writes) {
+    if (!directory || !name) {
+        return NULL;
+    }
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST) {
+        printf("Failed to create knowledge store directory %s\n", directory);
+        return NULL;
+    }
+
+    KnowledgeStore *store = (KnowledgeStore *)calloc(1, sizeof(KnowledgeStore));
+    if (!store) {
+        return NULL;
+    }
+    store->log_fd = -1;
+    store->sync_writes = sync_writes;
+    store->directory = strdup(directory);
+    store->log_path = join_path(directory, name, ".wal");
+    store->snapshot_path = join_path(directory, name, ".snap");
+    store->temp_path = join_path(directory, name, ".snap.tmp");
+    if (!store->directory || !store->log_path || !store->snapshot_path || !store->temp_path ||
+        !map_snapshot(store)) {
+        kstore_close(store);
+        return NULL;
+    }
+
+    store->log_fd = open(store->log_path, O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (store->log_fd < 0) {
+        printf("Failed to open knowledge store log %s\n", store->log_path);
+        kstore_close(store);
+        return NULL;
+    }
+
+    /* A missing, empty or superseded log starts over */
+    KnowledgeStoreLogHeader header;
+    if (!read_all(store->log_fd, &header, sizeof(header), 0) ||
+        (memcmp(header.magic, KSTORE_LOG_MAGIC, sizeof(header.magic)) == 0 &&
+         header.version == KSTORE_FORMAT_VERSION && header.generation < store->generation)) {
+        if (!reset_log(store)) {
+            kstore_close(store);
+            return NULL;
+        }
+    } else if (memcmp(header.magic, KSTORE_LOG_MAGIC, sizeof(header.magic)) != 0 ||
+               header.version != KSTORE_FORMAT_VERSION ||
+               header.generation != store->generation) {
+        printf("Knowledge store log %s does not match its snapshot\n", store->log_path);
+        kstore_close(store);
+        return NULL;
+    }
+    return store;
+}
+
+/**
+ * @brief Replay the store's contents
+ */
+bool kstore_load(KnowledgeStore *store, KnowledgeStoreReplay replay, void *context) {
+    if (!store || !replay || store->loaded) {
+        return false;
+    }
+
+    /* Snapshot records are used straight from the mapping */
+    for (uint64_t i = 0; i < store->record_count; i++) {
+        const KnowledgeStoreIndexEntry *entry = &store->index[i];
+        KnowledgeStoreRecord record = {
+            entry->kind, entry->id, (const uint8_t *)store->map + entry->offset, entry->size
+        };
+        if (!replay(KSTORE_OP_PUT, &record, context)) {
+            return false;
+        }
+    }
+
+    /* Then the log, up to the first incomplete or damaged record */
+    struct stat info;
+    if (fstat(store->log_fd, &info) != 0) {
+        printf("Failed to stat knowledge store log %s\n", store->log_path);
+        return false;
+    }
+    uint64_t log_size = (uint64_t)info.st_size;
+    uint64_t offset = sizeof(KnowledgeStoreLogHeader);
+    uint8_t *payload = NULL;
+    uint32_t payload_capacity = 0;
+    bool ok = true;
+    for (;;) {
+        KnowledgeStoreLogRecord header;
+        if (!read_all(store->log_fd, &header, sizeof(header), offset) ||
+            (header.op != KSTORE_OP_PUT && header.op != KSTORE_OP_DELETE)) {
+            break;
+        }
+
+        /* A size running past the file is a damaged header, not a record to allocate for */
+        if (offset + sizeof(header) + header.size > log_size) {
+            break;
+        }
+        if (header.size > payload_capacity) {
+            uint8_t *grown = (uint8_t *)realloc(payload, header.size);
+            if (!grown) {
+                ok = false;
+                break;
+            }
+            payload = grown;
+            payload_capacity = header.size;
+        }
+        if (!read_all(store->log_fd, payload, header.size, offset + sizeof(header)) ||
+            record_crc(&header, payload) != header.crc) {
+            break;
+        }
+
+        KnowledgeStoreRecord record = { header.kind, header.id, payload, header.size };
+        if (!replay((KnowledgeStoreOp)header.op, &record, context)) {
+            ok = false;
+            break;
+        }
+        offset += sizeof(header) + header.size;
+    }
+    free(payload);
+    if (!ok) {
+        return false;
+    }
+
+    /* Cut off a torn tail so new appends follow the last good record */
+    if (log_size > offset) {
+        printf("Discarding %llu damaged bytes at the end of %s\n",
+               (unsigned long long)(log_size - offset), store->log_path);
+        if (ftruncate(store->log_fd, (off_t)offset) != 0) {
+            return false;
+        }
+    }
+    store->log_bytes = offset - sizeof(KnowledgeStoreLogHeader);
+    store->loaded = true;
+    return true;
+}
+
+/**
+ * @brief Append one record to the log
+ */
+static bool append_record(KnowledgeStore *store, KnowledgeStoreOp op, uint32_t kind, uint64_t id,
+                          const void *data, uint32_t size) {
+    if (!store || !store->loaded) {
+        return false;
+    }
+
+    KnowledgeStoreLogRecord header = { size, 0, (uint32_t)op, kind, id };
+    header.crc = record_crc(&header, data);
+
+    /* One write per record so a crash tears at most the last one */
+    uint8_t stack_buffer[512];
+    size_t total = sizeof(header) + size;
+    uint8_t *buffer = total <= sizeof(stack_buffer) ? stack_buffer : (uint8_t *)malloc(total);
+    if (!buffer) {
+        return false;
+    }
+    memcpy(buffer, &header, sizeof(header));
+    if (size > 0) {
+        memcpy(buffer + sizeof(header), data, size);
+    }
+
+    bool ok = write_all(store->log_fd, buffer, total) &&
+              (!store->sync_writes || fdatasync(store->log_fd) == 0);
+    if (buffer != stack_buffer) {
+        free(buffer);
+    }
+    if (!ok) {
+        /* Drop a partial record rather than leave it before later appends */
+        printf("Failed to append to knowledge store log %s\n", store->log_path);
+        if (ftruncate(store->log_fd, (off_t)(sizeof(KnowledgeStoreLogHeader) + store->log_bytes)) != 0) {
+            printf("Failed to roll back knowledge store log %s\n", store->log_path);
+        }
+        return false;
+    }
+    store->log_bytes += total;
+    return true;
+}
+
+/**
+ * @brief Append a put to the log
+ */
+bool kstore_put(KnowledgeStore *store, uint32_t kind, uint64_t id, const void *data, uint32_t size) {
+    return (data || size == 0) && append_record(store, KSTORE_OP_PUT, kind, id, data, size);
+}
+
+/**
+ * @brief Append a delete to the log
+ */
+bool kstore_delete(KnowledgeStore *store, uint32_t kind, uint64_t id) {
+    return append_record(store, KSTORE_OP_DELETE, kind, id, NULL, 0);
+}
+
+/**
+ * @brief Flush the log to disk
+ */
+bool kstore_sync(KnowledgeStore *store) {
+    return store && fdatasync(store->log_fd) == 0;
+}
+
+/**
+ * @brief Whether the log has outgrown the snapshot enough to compact
+ */
+bool kstore_should_compact(const KnowledgeStore *store) {
+    return store && !store->writer && store->log_bytes >= KSTORE_COMPACT_MIN_BYTES &&
+           store->log_bytes >= store->map_size;
+}
+
+/**
+ * @brief Start writing a new snapshot
+ */
+bool kstore_begin_snapshot(KnowledgeStore *store) {
+    if (!store || !store->loaded || store->writer) {
+        return false;
+    }
+
+    store->writer = fopen(store->temp_path, "wb");
+    if (!store->writer) {
+        printf("Failed to create knowledge store snapshot %s\n", store->temp_path);
+        return false;
+    }
+
+    /* The header is filled in on commit */
+    KnowledgeStoreSnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    store->write_failed = fwrite(&header, sizeof(header), 1, store->writer) != 1;
+    store->write_offset = sizeof(header);
+    store->pending_count = 0;
+    return !store->write_failed;
+}
+
+/**
+ * @brief Add a record to the snapshot being written
+ */
+bool kstore_snapshot_add(KnowledgeStore *store, uint32_t kind, uint64_t id,
+                         const void *data, uint32_t size) {
+    if (!store || !store->writer || store->write_failed || (!data && size > 0)) {
+        return false;
+    }
+
+    if (store->pending_count == store->pending_capacity) {
+        uint64_t capacity = store->pending_capacity ? store->pending_capacity * 2 : 256;
+        KnowledgeStoreIndexEntry *grown = (KnowledgeStoreIndexEntry *)realloc(
+            store->pending, capacity * sizeof(KnowledgeStoreIndexEntry));
+        if (!grown) {
+            store->write_failed = true;
+            return false;
+        }
+        store->pending = grown;
+        store->pending_capacity = capacity;
+    }
+
+    static const uint8_t padding[KSTORE_ALIGNMENT] = { 0 };
+    uint32_t pad = (KSTORE_ALIGNMENT - size % KSTORE_ALIGNMENT) % KSTORE_ALIGNMENT;
+    if ((size > 0 && fwrite(data, size, 1, store->writer) != 1) ||
+        (pad > 0 && fwrite(padding, pad, 1, store->writer) != 1)) {
+        store->write_failed = true;
+        return false;
+    }
+
+    store->pending[store->pending_count++] = (KnowledgeStoreIndexEntry){
+        kind, size, id, store->write_offset
+    };
+    store->write_offset += size + pad;
+    return true;
+}
+
+/**
+ * @brief Order index entries by (kind, id)
+ */
+static int compare_index_entries(const void *a, const void *b) {
+    const KnowledgeStoreIndexEntry *left = (const KnowledgeStoreIndexEntry *)a;
+    const KnowledgeStoreIndexEntry *right = (const KnowledgeStoreIndexEntry *)b;
+    if (left->kind != right->kind) {
+        return left->kind < right->kind ? -1 : 1;
+    }
+    return left->id < right->id ? -1 : left->id > right->id ? 1 : 0;
+}
+
+/**
+ * @brief Publish the snapshot being written and empty the log
+ */
+bool kstore_end_snapshot(KnowledgeStore *store, bool commit) {
+    if (!store || !store->writer) {
+        return false;
+    }
+
+    bool ok = commit && !store->write_failed;
+    if (ok) {
+        qsort(store->pending, store->pending_count, sizeof(KnowledgeStoreIndexEntry),
+              compare_index_entries);
+        for (uint64_t i = 1; ok && i < store->pending_count; i++) {
+            ok = compare_index_entries(&store->pending[i - 1], &store->pending[i]) != 0;
+        }
+        if (!ok) {
+            printf("Knowledge store snapshot has duplicate records\n");
+        }
+    }
+
+    KnowledgeStoreSnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, KSTORE_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = KSTORE_FORMAT_VERSION;
+    header.header_size = sizeof(header);
+    header.generation = store->generation + 1;
+    header.record_count = store->pending_count;
+    header.index_offset = store->write_offset;
+    header.file_size = store->write_offset + store->pending_count * sizeof(KnowledgeStoreIndexEntry);
+
+    ok = ok &&
+         (store->pending_count == 0 ||
+          fwrite(store->pending, sizeof(KnowledgeStoreIndexEntry), store->pending_count,
+                 store->writer) == store->pending_count) &&
+         fseek(store->writer, 0, SEEK_SET) == 0 &&
+         fwrite(&header, sizeof(header), 1, store->writer) == 1 &&
+         fflush(store->writer) == 0 &&
+         fsync(fileno(store->writer)) == 0;
+    ok = fclose(store->writer) == 0 && ok;
+    store->writer = NULL;
+    store->pending_count = 0;
+
+    if (!ok) {
+        remove(store->temp_path);
+        return !commit;
+    }
+
+    /* Publish, then switch to the new mapping and start an empty log */
+    if (rename(store->temp_path, store->snapshot_path) != 0) {
+        printf("Failed to publish knowledge store snapshot %s\n", store->snapshot_path);
+        remove(store->temp_path);
+        return false;
+    }
+    sync_directory(store->directory);
+    unmap_snapshot(store);
+    if (!map_snapshot(store)) {
+        return false;
+    }
+    return reset_log(store);
+}
+
+/**
+ * @brief Look up a record in the mapped snapshot
+ */
+const void *kstore_snapshot_find(const KnowledgeStore *store, uint32_t kind, uint64_t id,
+                                 uint32_t *size) {
+    if (!store || !store->map) {
+        return NULL;
+    }
+
+    KnowledgeStoreIndexEntry key = { kind, 0, id, 0 };
+    const KnowledgeStoreIndexEntry *entry = (const KnowledgeStoreIndexEntry *)bsearch(
+        &key, store->index, store->record_count, sizeof(KnowledgeStoreIndexEntry),
+        compare_index_entries);
+    if (!entry) {
+        return NULL;
+    }
+    if (size) {
+        *size = entry->size;
+    }
+    return (const uint8_t *)store->map + entry->offset;
+}
+
+/**
+ * @brief Flush and close a store
+ */
+void kstore_close(KnowledgeStore *store) {
+    if (!store) {
+        return;
+    }
+    if (store->writer) {
+        kstore_end_snapshot(store, false);
+    }
+    if (store->log_fd >= 0) {
+        fdatasync(store->log_fd);
+        close(store->log_fd);
+    }
+    unmap_snapshot(store);
+    free(store->pending);
+    free(store->directory);
+    free(store->log_path);
+    free(store->snapshot_path);
+    free(store->temp_path);
+    free(store);
+}
+
+/**
+ * @brief Ensure room for more bytes in an encode buffer
+ */
+static uint8_t *buffer_reserve(KnowledgeStoreBuffer *buffer, uint64_t size) {
+    if (buffer->failed) {
+        return NULL;
+    }
+    if (buffer->size + size > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity : 256;
+        while (capacity < buffer->size + size) {
+            capacity *= 2;
+        }
+        uint8_t *data = (uint8_t *)realloc(buffer->data, capacity);
+        if (!data) {
+            buffer->failed = true;
+            return NULL;
+        }
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+    uint8_t *position = buffer->data + buffer->size;
+    buffer->size += size;
+    return position;
+}
+
+/**
+ * @brief Empty an encode buffer, keeping its allocation
+ */
+void kstore_buffer_reset(KnowledgeStoreBuffer *buffer) {
+    buffer->size = 0;
+    buffer->failed = false;
+}
+
+/**
+ * @brief Release an encode buffer
+ */
+void kstore_buffer_free(KnowledgeStoreBuffer *buffer) {
+    free(buffer->data);
+    memset(buffer, 0, sizeof(*buffer));
+}
+
+void kstore_buffer_put_u32(KnowledgeStoreBuffer *buffer, uint32_t value) {
+    uint8_t *position = buffer_reserve(buffer, sizeof(value));
+    if (position) memcpy(position, &value, sizeof(value));
+}
+
+void kstore_buffer_put_u64(KnowledgeStoreBuffer *buffer, uint64_t value) {
+    uint8_t *position = buffer_reserve(buffer, sizeof(value));
+    if (position) memcpy(position, &value, sizeof(value));
+}
+
+void kstore_buffer_put_f32(KnowledgeStoreBuffer *buffer, float value) {
+    uint8_t *position = buffer_reserve(buffer, sizeof(value));
+    if (position) memcpy(position, &value, sizeof(value));
+}
+
+void kstore_buffer_put_bytes(KnowledgeStoreBuffer *buffer, const void *data, uint64_t size) {
+    kstore_buffer_put_u64(buffer, size);
+    uint8_t *position = size > 0 ? buffer_reserve(buffer, size) : NULL;
+    if (position) memcpy(position, data, size);
+}
+
+void kstore_buffer_put_string(KnowledgeStoreBuffer *buffer, const char *value) {
+    /* UINT32_MAX marks a NULL string */
+    uint32_t length = value ? (uint32_t)strlen(value) : UINT32_MAX;
+    kstore_buffer_put_u32(buffer, length);
+    uint8_t *position = value && length > 0 ? buffer_reserve(buffer, length) : NULL;
+    if (position) memcpy(position, value, length);
+}
+
+/**
+ * @brief Start decoding a record's payload
+ */
+void kstore_reader_init(KnowledgeStoreReader *reader, const KnowledgeStoreRecord *record) {
+    reader->data = (const uint8_t *)record->data;
+    reader->size = record->size;
+    reader->offset = 0;
+    reader->failed = false;
+}
+
+/**
+ * @brief Consume bytes from a reader
+ *
+ * @return Pointer to the bytes, or NULL (and failed set) past the end
+ */
+static const uint8_t *reader_take(KnowledgeStoreReader *reader, uint64_t size) {
+    if (reader->failed || size > reader->size - reader->offset) {
+        reader->failed = true;
+        return NULL;
+    }
+    const uint8_t *position = reader->data + reader->offset;
+    reader->offset += size;
+    return position;
+}
+
+uint32_t kstore_read_u32(KnowledgeStoreReader *reader) {
+    uint32_t value = 0;
+    const uint8_t *position = reader_take(reader, sizeof(value));
+    if (position) memcpy(&value, position, sizeof(value));
+    return value;
+}
+
+uint64_t kstore_read_u64(KnowledgeStoreReader *reader) {
+    uint64_t value = 0;
+    const uint8_t *position = reader_take(reader, sizeof(value));
+    if (position) memcpy(&value, position, sizeof(value));
+    return value;
+}
+
+float kstore_read_f32(KnowledgeStoreReader *reader) {
+    float value = 0.0f;
+    const uint8_t *position = reader_take(reader, sizeof(value));
+    if (position) memcpy(&value, position, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Read a byte string written by kstore_buffer_put_bytes
+ */
+const void *kstore_read_bytes(KnowledgeStoreReader *reader, uint64_t *size) {
+    uint64_t length = kstore_read_u64(reader);
+    const uint8_t *position = reader_take(reader, length);
+    *size = position ? length : 0;
+    return position;
+}
+
+/**
+ * @brief Read a string written by kstore_buffer_put_string
+ */
+bool kstore_read_string(KnowledgeStoreReader *reader, char **value) {
+    *value = NULL;
+    uint32_t length = kstore_read_u32(reader);
+    if (reader->failed || length == UINT32_MAX) {
+        return !reader->failed;
+    }
+
+    const uint8_t *position = reader_take(reader, length);
+    if (!position) {
+        return false;
+    }
+    *value = (char *)malloc((size_t)length + 1);
+    if (!*value) {
+        return false;
+    }
+    memcpy(*value, position, length);
+    (*value)[length] = '\0';
+    return true;
+}
@@ -0,0 +1,232 @@
+/**
+ * @file knowledge_store.h
+ * @brief Persistent record store for Memex knowledge
+ *
+ * A store keeps (kind, id) -> bytes records in two files inside a data
+ * directory: an append-only write-ahead log of puts and deletes, and a
+ * compacted snapshot. The snapshot is laid out to be memory-mapped and
+ * read in place: a header, the 8-byte aligned record payloads, then an
+ * index sorted by (kind, id). Opening a store maps the snapshot and
+ * replays only the log written after it.
+ *
+ * Records are opaque to the store; owners encode them with the
+ * KnowledgeStoreBuffer / KnowledgeStoreReader helpers. All integers are
+ * stored in host byte order, since the snapshot is used as mapped.
+ */
+
+#ifndef CTRLXT_MEMEX_KNOWLEDGE_STORE_H
+#define CTRLXT_MEMEX_KNOWLEDGE_STORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Opaque store handle
+ */
+typedef struct KnowledgeStore KnowledgeStore;
+
+/**
+ * @brief Record operations
+ */
+typedef enum {
+    KSTORE_OP_PUT = 1,    /**< Record created or replaced */
+    KSTORE_OP_DELETE = 2  /**< Record removed (no payload) */
+} KnowledgeStoreOp;
+
+/**
+ * @brief Record passed to replay callbacks
+ *
+ * The payload points into the mapped snapshot or the log read buffer and
+ * is only valid during the callback.
+ */
+typedef struct {
+    uint32_t kind;        /**< Owner-defined record kind */
+    uint64_t id;          /**< Record ID within its kind */
+    const void *data;     /**< Payload */
+    uint32_t size;        /**< Payload size in bytes */
+} KnowledgeStoreRecord;
+
+/**
+ * @brief Replay callback
+ *
+ * @param op Operation
+ * @param record Record (payload empty for deletes)
+ * @param context Callback context
+ * @return true to continue, false to abort loading
+ */
+typedef bool (*KnowledgeStoreReplay)(KnowledgeStoreOp op, const KnowledgeStoreRecord *record,
+                                     void *context);
+
+/**
+ * @brief Growable encode buffer
+ */
+typedef struct {
+    uint8_t *data;        /**< Encoded bytes */
+    size_t size;          /**< Bytes written */
+    size_t capacity;      /**< Allocated bytes */
+    bool failed;          /**< Set if an allocation failed */
+} KnowledgeStoreBuffer;
+
+/**
+ * @brief Bounds-checked decode cursor
+ */
+typedef struct {
+    const uint8_t *data;  /**< Encoded bytes */
+    size_t size;          /**< Total bytes */
+    size_t offset;        /**< Read position */
+    bool failed;          /**< Set if a read ran past the end */
+} KnowledgeStoreReader;
+
+/**
+ * @brief Open or create a store
+ *
+ * Creates <directory>/<name>.wal and, on compaction, <directory>/<name>.snap.
+ *
+ * @param directory Data directory (created if missing)
+ * @param name File name prefix
+ * @param sync_writes Whether every log append is flushed to disk before returning
+ * @return Store handle or NULL on failure
+ */
+KnowledgeStore *kstore_open(const char *directory, const char *name, bool sync_writes);
+
+/**
+ * @brief Replay the store's contents
+ *
+ * Snapshot records are reported as puts in (kind, id) order, followed by
+ * the log tail in the order it was written. A torn record at the end of
+ * the log (from a crash mid-append) is discarded.
+ *
+ * @param store Store
+ * @param replay Callback for each record
+ * @param context Callback context
+ * @return true if everything was replayed, false on corruption or callback abort
+ */
+bool kstore_load(KnowledgeStore *store, KnowledgeStoreReplay replay, void *context);
+
+/**
+ * @brief Append a put to the log
+ *
+ * @param store Store
+ * @param kind Record kind
+ * @param id Record ID
+ * @param data Payload
+ * @param size Payload size in bytes
+ * @return true on success, false on I/O failure
+ */
+bool kstore_put(KnowledgeStore *store, uint32_t kind, uint64_t id, const void *data, uint32_t size);
+
+/**
+ * @brief Append a delete to the log
+ *
+ * @param store Store
+ * @param kind Record kind
+ * @param id Record ID
+ * @return true on success, false on I/O failure
+ */
+bool kstore_delete(KnowledgeStore *store, uint32_t kind, uint64_t id);
+
+/**
+ * @brief Flush the log to disk
+ *
+ * @param store Store
+ * @return true on success, false on I/O failure
+ */
+bool kstore_sync(KnowledgeStore *store);
+
+/**
+ * @brief Whether the log has outgrown the snapshot enough to compact
+ *
+ * @param store Store
+ * @return true if the owner should write a new snapshot
+ */
+bool kstore_should_compact(const KnowledgeStore *store);
+
+/**
+ * @brief Start writing a new snapshot
+ *
+ * The owner adds every live record, then commits. Until the commit the
+ * old snapshot and log stay authoritative.
+ *
+ * @param store Store
+ * @return true on success, false on I/O failure
+ */
+bool kstore_begin_snapshot(KnowledgeStore *store);
+
+/**
+ * @brief Add a record to the snapshot being written
+ *
+ * @param store Store
+ * @param kind Record kind
+ * @param id Record ID (unique within its kind)
+ * @param data Payload
+ * @param size Payload size in bytes
+ * @return true on success, false on I/O failure
+ */
+bool kstore_snapshot_add(KnowledgeStore *store, uint32_t kind, uint64_t id,
+                         const void *data, uint32_t size);
+
+/**
+ * @brief Publish the snapshot being written and empty the log
+ *
+ * @param store Store
+ * @param commit true to publish, false to discard the new snapshot
+ * @return true if the snapshot was published (or discarded on request)
+ */
+bool kstore_end_snapshot(KnowledgeStore *store, bool commit);
+
+/**
+ * @brief Look up a record in the mapped snapshot
+ *
+ * Only the snapshot is searched; changes logged since are not reflected.
+ *
+ * @param store Store
+ * @param kind Record kind
+ * @param id Record ID
+ * @param size Pointer to store the payload size
+ * @return Payload inside the mapping, or NULL if the snapshot has no such record
+ */
+const void *kstore_snapshot_find(const KnowledgeStore *store, uint32_t kind, uint64_t id,
+                                 uint32_t *size);
+
+/**
+ * @brief Flush and close a store
+ *
+ * @param store Store (may be NULL)
+ */
+void kstore_close(KnowledgeStore *store);
+
+/* Encoding helpers */
+void kstore_buffer_reset(KnowledgeStoreBuffer *buffer);
+void kstore_buffer_free(KnowledgeStoreBuffer *buffer);
+void kstore_buffer_put_u32(KnowledgeStoreBuffer *buffer, uint32_t value);
+void kstore_buffer_put_u64(KnowledgeStoreBuffer *buffer, uint64_t value);
+void kstore_buffer_put_f32(KnowledgeStoreBuffer *buffer, float value);
+void kstore_buffer_put_bytes(KnowledgeStoreBuffer *buffer, const void *data, uint64_t size);
+void kstore_buffer_put_string(KnowledgeStoreBuffer *buffer, const char *value);
+
+/* Decoding helpers */
+void kstore_reader_init(KnowledgeStoreReader *reader, const KnowledgeStoreRecord *record);
+uint32_t kstore_read_u32(KnowledgeStoreReader *reader);
+uint64_t kstore_read_u64(KnowledgeStoreReader *reader);
+float kstore_read_f32(KnowledgeStoreReader *reader);
+
+/**
+ * @brief Read a byte string written by kstore_buffer_put_bytes
+ *
+ * @param reader Reader
+ * @param size Pointer to store the length
+ * @return Pointer into the record (not terminated), or NULL past the end
+ */
+const void *kstore_read_bytes(KnowledgeStoreReader *reader, uint64_t *size);
+
+/**
+ * @brief Read a string written by kstore_buffer_put_string
+ *
+ * @param reader Reader
+ * @param value Pointer to store a new copy (NULL if a NULL string was written)
+ * @return true on success, false past the end or on allocation failure
+ */
+bool kstore_read_string(KnowledgeStoreReader *reader, char **value);
+
+#endif /* CTRLXT_MEMEX_KNOWLEDGE_STORE_H */
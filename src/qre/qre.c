@@ -7,12 +7,46 @@
  * multi-dimensional data visualization.
  */
 
+/* strdup and clock_gettime under -std=c11 */
+#define _XOPEN_SOURCE 700
+
 #include "qre.h"
+#include "qre_scene.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
 #include <time.h>
+#include <math.h>
+#include <pthread.h>
+
+/*
+ * Change tracking
+ *
+ * Every space keeps a flag per object and a list of the objects changed
+ * since its last sync, filled by qre_create_object and qre_modify_object.
+ * A sync hands only the entanglements of those objects to the
+ * entanglement manager, in one batch, so its cost follows the number of
+ * changes rather than the size of the space. Batches large enough to pay
+ * for the threads are split across QRE_SYNC_THREADS.
+ */
+#define QRE_SYNC_THREADS 4
+#define QRE_SYNC_MIN_PER_THREAD 4096
+
+/*
+ * Rendering
+ *
+ * Every space keeps a scene with the bounding box of each object's
+ * geometry, read as packed x, y, z float triples. A frame culls the scene
+ * against the space's camera, picks each visible object's level of
+ * detail from its projected size under the space's LOD policy, and writes
+ * a draw command per object, splitting large frames across threads like
+ * a sync. Frame cost follows what is visible, not the size of the space.
+ */
+#define QRE_RENDER_MIN_PER_THREAD 2048
+
+/* Object IDs are space_id * QRE_OBJECT_ID_BASE + index + 1 */
+#define QRE_OBJECT_ID_BASE 1000
 
 /* Internal structures */
 
@@ -24,11 +58,61 @@ typedef struct {
     bool is_active;                 /**< Whether this space is active */
     void *private_data;             /**< Private implementation data */
     uint64_t owner_id;              /**< Owner/creator ID */
-    uint64_t last_update_time;      /**< Last update timestamp */
-    uint64_t last_render_time;      /**< Last render timestamp */
+    uint64_t last_update_time;      /**< Last update, in monotonic nanoseconds */
+    uint64_t last_render_time;      /**< Last render, in monotonic nanoseconds */
     uint64_t frame_count;           /**< Rendered frame count */
+    uint32_t object_capacity;       /**< Objects the per-object arrays hold */
+    bool *object_dirty;             /**< Per object, whether it changed since the last sync */
+    uint32_t *dirty_objects;        /**< Indexes of the changed objects */
+    uint32_t dirty_count;           /**< Number of changed objects */
+    uint64_t *sync_ids;             /**< Scratch batch of entanglement IDs for a sync */
+    QREScene *scene;                /**< Object bounds and visibility */
+    QSceneVisible *visible;         /**< Scratch list of the objects a frame sees */
+    QRECamera camera;               /**< Camera frames are rendered from */
+    bool has_camera;                /**< Whether a camera is set (frames cull nothing without one) */
+    QREFrameStats frame_stats;      /**< Timing and culling of rendered frames */
 } SpaceNode;
 
+/**
+ * @brief Range of a batch handled by one thread
+ */
+typedef struct {
+    void (*run)(void *context, uint32_t begin, uint32_t end);
+    void *context;                   /**< Batch shared by every range */
+    uint32_t begin;                  /**< First item */
+    uint32_t end;                    /**< One past the last item */
+} QREJob;
+
+/**
+ * @brief Level of detail policy of a visualization dimension type
+ *
+ * An object is drawn at the first level whose threshold its projected
+ * size reaches, as a fraction of the viewport height, and at the last
+ * level when it reaches none. Each level draws half the vertices of the
+ * one before.
+ */
+typedef struct {
+    uint32_t levels;                 /**< Levels of detail */
+    float thresholds[3];             /**< Smallest size drawn at each level but the last */
+} LodPolicy;
+
+static const LodPolicy lod_policies[] = {
+    [DIM_2D] = { 1, { 0.0f } },                       /* Flat views are always drawn in full */
+    [DIM_3D] = { 3, { 0.25f, 0.06f } },
+    [DIM_4D] = { 3, { 0.3f, 0.08f } },                /* Time steps multiply the work per object */
+    [DIM_MULTI] = { 4, { 0.3f, 0.1f, 0.03f } },
+    [DIM_QUANTUM] = { 4, { 0.4f, 0.12f, 0.04f } }     /* Superposed states draw every object several times */
+};
+
+/**
+ * @brief Command generation shared by every range of a frame
+ */
+typedef struct {
+    const SpaceNode *space_node;     /**< Space being rendered */
+    const LodPolicy *policy;         /**< LOD policy of the space */
+    QRERenderCommand *commands;      /**< Caller's command buffer */
+} RenderBatch;
+
 /**
  * @brief Internal object data container
  */
@@ -89,6 +173,271 @@ static int32_t find_space(uint64_t space_id) {
     return -1; // Not found
 }
 
+/**
+ * @brief Nanoseconds on the monotonic clock
+ */
+static uint64_t monotonic_nanoseconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Grow a space's object array and change tracking arrays
+ * 
+ * @param space_node Space to grow
+ * @param capacity Number of objects the arrays must hold
+ * @return true if the arrays hold capacity objects, false on allocation failure
+ */
+static bool reserve_objects(SpaceNode *space_node, uint32_t capacity) {
+    if (capacity <= space_node->object_capacity) {
+        return true;
+    }
+    uint32_t grown = space_node->object_capacity < 8 ? 8 : space_node->object_capacity * 2;
+    capacity = grown > capacity ? grown : capacity;
+    
+    // Each array is kept as soon as it grows, so a failure part way leaves them all usable
+    RealityObject **objects = (RealityObject**)realloc(space_node->space_data.objects,
+                                                       capacity * sizeof(RealityObject*));
+    if (objects == NULL) {
+        return false;
+    }
+    space_node->space_data.objects = objects;
+    
+    bool *object_dirty = (bool*)realloc(space_node->object_dirty, capacity * sizeof(bool));
+    if (object_dirty == NULL) {
+        return false;
+    }
+    space_node->object_dirty = object_dirty;
+    
+    uint32_t *dirty_objects = (uint32_t*)realloc(space_node->dirty_objects, capacity * sizeof(uint32_t));
+    if (dirty_objects == NULL) {
+        return false;
+    }
+    space_node->dirty_objects = dirty_objects;
+    
+    uint64_t *sync_ids = (uint64_t*)realloc(space_node->sync_ids, capacity * sizeof(uint64_t));
+    if (sync_ids == NULL) {
+        return false;
+    }
+    space_node->sync_ids = sync_ids;
+    
+    QSceneVisible *visible = (QSceneVisible*)realloc(space_node->visible, capacity * sizeof(QSceneVisible));
+    if (visible == NULL || !qscene_resize(space_node->scene, capacity)) {
+        space_node->visible = visible ? visible : space_node->visible;
+        return false;
+    }
+    space_node->visible = visible;
+    
+    space_node->object_capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief Record that an object changed since the last sync
+ * 
+ * @param space_node Space holding the object
+ * @param index Index of the object in the space
+ */
+static void mark_object_dirty(SpaceNode *space_node, uint32_t index) {
+    if (!space_node->object_dirty[index]) {
+        space_node->object_dirty[index] = true;
+        space_node->dirty_objects[space_node->dirty_count++] = index;
+    }
+}
+
+/**
+ * @brief Forget the changes recorded for a space
+ * 
+ * @param space_node Space to clear
+ */
+static void clear_dirty_objects(SpaceNode *space_node) {
+    for (uint32_t i = 0; i < space_node->dirty_count; i++) {
+        space_node->object_dirty[space_node->dirty_objects[i]] = false;
+    }
+    space_node->dirty_count = 0;
+}
+
+/**
+ * @brief Find an object in a space by ID
+ * 
+ * @param space_node Space to search
+ * @param object_id Object ID
+ * @return Index of the object, or -1 if the space holds no such object
+ */
+static int64_t find_object(const SpaceNode *space_node, uint64_t object_id) {
+    uint64_t first_id = space_node->space_data.id * QRE_OBJECT_ID_BASE + 1;
+    if (object_id < first_id || object_id - first_id >= space_node->space_data.object_count) {
+        return -1;
+    }
+    
+    uint32_t index = (uint32_t)(object_id - first_id);
+    RealityObject *object = space_node->space_data.objects[index];
+    return (object != NULL && object->id == object_id) ? (int64_t)index : -1;
+}
+
+/**
+ * @brief Run one thread's range of a batch
+ */
+static void *run_job(void *argument) {
+    const QREJob *job = (const QREJob *)argument;
+    job->run(job->context, job->begin, job->end);
+    return NULL;
+}
+
+/**
+ * @brief Run a batch, split across threads when it is large
+ * 
+ * A thread that fails to start has its range run by the caller.
+ * 
+ * @param run Function handling a range of the batch
+ * @param context Batch passed to every range
+ * @param count Number of items
+ * @param min_per_thread Fewest items worth a thread
+ */
+static void run_parallel(void (*run)(void *context, uint32_t begin, uint32_t end),
+                         void *context, uint32_t count, uint32_t min_per_thread) {
+    uint32_t thread_count = count / min_per_thread;
+    thread_count = thread_count < 1 ? 1 : thread_count > QRE_SYNC_THREADS ? QRE_SYNC_THREADS : thread_count;
+    QREJob jobs[QRE_SYNC_THREADS];
+    pthread_t threads[QRE_SYNC_THREADS];
+    bool started[QRE_SYNC_THREADS] = { false };
+    for (uint32_t t = 0; t < thread_count; t++) {
+        jobs[t] = (QREJob){
+            run, context,
+            (uint32_t)((uint64_t)count * t / thread_count), (uint32_t)((uint64_t)count * (t + 1) / thread_count)
+        };
+        started[t] = t > 0 && pthread_create(&threads[t], NULL, run_job, &jobs[t]) == 0;
+    }
+    for (uint32_t t = 0; t < thread_count; t++) {
+        if (!started[t]) {
+            run_job(&jobs[t]);
+        }
+    }
+    for (uint32_t t = 0; t < thread_count; t++) {
+        if (started[t]) {
+            pthread_join(threads[t], NULL);
+        }
+    }
+}
+
+/**
+ * @brief Synchronize a range of a batch of entanglement IDs
+ */
+static void sync_range(void *context, uint32_t begin, uint32_t end) {
+    const uint64_t *ids = (const uint64_t *)context;
+    qem_sync_entanglements(ids + begin, end - begin);
+}
+
+/**
+ * @brief Compute the bounding box of an object's geometry
+ * 
+ * @param object Object
+ * @param min Lowest corner
+ * @param max Highest corner
+ * @return true if the geometry holds at least one finite vertex
+ */
+static bool geometry_bounds(const RealityObject *object, float min[3], float max[3]) {
+    uint64_t vertex_count = object->geometry_data ? object->geometry_size / (3 * sizeof(float)) : 0;
+    const float *vertices = (const float *)object->geometry_data;
+    bool found = false;
+    for (uint64_t v = 0; v < vertex_count; v++) {
+        const float *vertex = &vertices[v * 3];
+        if (!isfinite(vertex[0]) || !isfinite(vertex[1]) || !isfinite(vertex[2])) {
+            continue;
+        }
+        for (int axis = 0; axis < 3; axis++) {
+            min[axis] = (!found || vertex[axis] < min[axis]) ? vertex[axis] : min[axis];
+            max[axis] = (!found || vertex[axis] > max[axis]) ? vertex[axis] : max[axis];
+        }
+        found = true;
+    }
+    return found;
+}
+
+/**
+ * @brief Give the scene an object's current geometry bounds
+ * 
+ * @param space_node Space holding the object
+ * @param index Index of the object in the space
+ */
+static void update_object_bounds(SpaceNode *space_node, uint32_t index) {
+    float min[3], max[3];
+    bool has_bounds = geometry_bounds(space_node->space_data.objects[index], min, max);
+    qscene_set_bounds(space_node->scene, index, has_bounds ? min : NULL, max);
+}
+
+/**
+ * @brief Level of detail for a projected size
+ */
+static uint32_t select_lod(const LodPolicy *policy, float screen_size) {
+    uint32_t lod = 0;
+    while (lod + 1 < policy->levels && screen_size < policy->thresholds[lod]) {
+        lod++;
+    }
+    return lod;
+}
+
+/**
+ * @brief Write the draw commands of a range of a frame's visible objects
+ */
+static void render_range(void *context, uint32_t begin, uint32_t end) {
+    const RenderBatch *batch = (const RenderBatch *)context;
+    for (uint32_t i = begin; i < end; i++) {
+        const QSceneVisible *visible = &batch->space_node->visible[i];
+        const RealityObject *object = batch->space_node->space_data.objects[visible->slot];
+        uint32_t lod = select_lod(batch->policy, visible->screen_size);
+        uint64_t vertices = object->geometry_size / (3 * sizeof(float));
+        uint64_t drawn = vertices >> lod;
+        batch->commands[i] = (QRERenderCommand){
+            object->id, lod, (uint32_t)(drawn > 0 ? drawn : 1), visible->depth, visible->screen_size
+        };
+    }
+}
+
+/**
+ * @brief Render a frame of a space and record its timing
+ * 
+ * @param space_node Space to render
+ * @param commands Buffer for the draw commands, roughly nearest first (NULL to only cull)
+ * @param max_commands Commands the buffer holds
+ * @return Number of visible objects (commands beyond max_commands are dropped)
+ */
+static uint32_t render_frame(SpaceNode *space_node, QRERenderCommand *commands, uint32_t max_commands) {
+    uint64_t start = monotonic_nanoseconds();
+    
+    QSceneCullStats cull_stats;
+    uint32_t visible_count = qscene_cull(space_node->scene,
+                                         space_node->has_camera ? &space_node->camera : NULL,
+                                         space_node->visible, &cull_stats);
+    
+    uint32_t command_count = visible_count < max_commands ? visible_count : max_commands;
+    if (commands != NULL && command_count > 0) {
+        uint32_t dimensions = (uint32_t)space_node->space_data.dimensions;
+        RenderBatch batch = {
+            space_node,
+            &lod_policies[dimensions < sizeof(lod_policies) / sizeof(lod_policies[0]) ? dimensions : DIM_3D],
+            commands
+        };
+        run_parallel(render_range, &batch, command_count, QRE_RENDER_MIN_PER_THREAD);
+    }
+    
+    // Update rendering statistics
+    uint64_t now = monotonic_nanoseconds();
+    QREFrameStats *stats = &space_node->frame_stats;
+    stats->last_frame_time = now - start;
+    stats->max_frame_time = stats->last_frame_time > stats->max_frame_time ? stats->last_frame_time : stats->max_frame_time;
+    stats->total_frame_time += stats->last_frame_time;
+    stats->visible_objects = visible_count;
+    stats->frustum_culled = cull_stats.frustum_culled;
+    stats->occluded_objects = cull_stats.occluded;
+    space_node->last_render_time = now;
+    space_node->frame_count++;
+    stats->frame_count = space_node->frame_count;
+    
+    return visible_count;
+}
+
 /**
  * @brief Allocate memory for an object's geometry and material data
  * 
@@ -206,8 +555,14 @@ RealitySpace qre_create_space(RealityModeType mode,
         return empty_space; // No slots available
     }
     
-    // Initialize space data
+    // Create the scene first, so a failure leaves nothing to undo
     SpaceNode *space_node = &space_registry[slot];
+    space_node->scene = qscene_create();
+    if (space_node->scene == NULL) {
+        return empty_space;
+    }
+    
+    // Initialize space data
     space_node->space_data.id = next_space_id++;
     space_node->space_data.mode = mode;
     space_node->space_data.dimensions = dimensions;
@@ -222,7 +577,7 @@ RealitySpace qre_create_space(RealityModeType mode,
         EntanglementId entanglement = qem_create_entanglement(
             ENTANGLE_MEMORY,
             (uint64_t)&space_node->space_data,
-            0,  // No target yet
+            space_node->space_data.id,  // No remote target yet; the manager needs a nonzero one
             4    // Use 4 qubits
         );
         
@@ -245,6 +600,14 @@ RealitySpace qre_create_space(RealityModeType mode,
     space_node->last_update_time = 0;
     space_node->last_render_time = 0;
     space_node->frame_count = 0;
+    space_node->object_capacity = 0;
+    space_node->object_dirty = NULL;
+    space_node->dirty_objects = NULL;
+    space_node->dirty_count = 0;
+    space_node->sync_ids = NULL;
+    space_node->visible = NULL;
+    space_node->has_camera = false;
+    memset(&space_node->frame_stats, 0, sizeof(space_node->frame_stats));
     
     // Allocate private data structure
     space_node->private_data = calloc(1, sizeof(ObjectInternalData));
@@ -296,7 +659,7 @@ RealityObject qre_create_object(uint64_t space_id,
     
     // Create new object
     RealityObject new_object;
-    new_object.id = space_id * 1000 + space_node->space_data.object_count + 1; // Generate ID
+    new_object.id = space_id * QRE_OBJECT_ID_BASE + space_node->space_data.object_count + 1; // Generate ID
     
     // Copy name
     if (name != NULL) {
@@ -327,7 +690,7 @@ RealityObject qre_create_object(uint64_t space_id,
         EntanglementId entanglement = qem_create_entanglement(
             ENTANGLE_MEMORY,
             (uint64_t)&new_object,
-            0,  // No target yet
+            new_object.id,  // No remote target yet; the manager needs a nonzero one
             2    // Use 2 qubits
         );
         
@@ -354,11 +717,7 @@ RealityObject qre_create_object(uint64_t space_id,
     
     // Add object to space
     uint32_t new_count = space_node->space_data.object_count + 1;
-    RealityObject **new_objects = (RealityObject**)realloc(
-        space_node->space_data.objects,
-        new_count * sizeof(RealityObject*));
-        
-    if (new_objects == NULL) {
+    if (!reserve_objects(space_node, new_count)) {
         // Free resources on failure
         if (new_object.name != NULL) {
             free(new_object.name);
@@ -399,17 +758,105 @@ RealityObject qre_create_object(uint64_t space_id,
     // Copy object to heap
     *heap_object = new_object;
     
-    // Update space with new object
-    space_node->space_data.objects = new_objects;
+    // Update space with new object, which the next sync picks up
     space_node->space_data.objects[space_node->space_data.object_count] = heap_object;
+    space_node->object_dirty[space_node->space_data.object_count] = false;
+    mark_object_dirty(space_node, space_node->space_data.object_count);
+    update_object_bounds(space_node, space_node->space_data.object_count);
     space_node->space_data.object_count = new_count;
     
     // Update space timestamp
-    space_node->last_update_time = (uint64_t)time(NULL);
+    space_node->last_update_time = monotonic_nanoseconds();
     
     return new_object;
 }
 
+/**
+ * @brief Modify an object in a reality space
+ * 
+ * @param space_id Space ID holding the object
+ * @param object_id Object ID
+ * @param geometry_data New geometry data (NULL to keep the current data)
+ * @param geometry_size New geometry data size (0 to drop the geometry)
+ * @param material_data New material data (NULL to keep the current data)
+ * @param material_size New material data size (0 to drop the material)
+ * @return true if the object was modified, false otherwise
+ */
+bool qre_modify_object(uint64_t space_id,
+                       uint64_t object_id,
+                       const void *geometry_data,
+                       uint64_t geometry_size,
+                       const void *material_data,
+                       uint64_t material_size) {
+    // Check initialization
+    if (!is_initialized) {
+        return false;
+    }
+    
+    // Find the space and the object
+    int32_t slot = find_space(space_id);
+    if (slot < 0) {
+        return false; // Space not found
+    }
+    SpaceNode *space_node = &space_registry[slot];
+    int64_t index = find_object(space_node, object_id);
+    if (index < 0) {
+        return false; // Object not found
+    }
+    RealityObject *object = space_node->space_data.objects[index];
+    
+    // Copy the new data first, so a failed allocation leaves the object as it was
+    void *new_geometry = NULL;
+    void *new_material = NULL;
+    if (geometry_data != NULL && geometry_size > 0) {
+        new_geometry = malloc(geometry_size);
+        if (new_geometry == NULL) {
+            return false;
+        }
+        memcpy(new_geometry, geometry_data, geometry_size);
+    }
+    if (material_data != NULL && material_size > 0) {
+        new_material = malloc(material_size);
+        if (new_material == NULL) {
+            free(new_geometry);
+            return false;
+        }
+        memcpy(new_material, material_data, material_size);
+    }
+    
+    // Swap in the new data
+    if (geometry_data != NULL) {
+        free(object->geometry_data);
+        object->geometry_data = new_geometry;
+        object->geometry_size = new_geometry ? geometry_size : 0;
+    }
+    if (material_data != NULL) {
+        free(object->material_data);
+        object->material_data = new_material;
+        object->material_size = new_material ? material_size : 0;
+    }
+    
+    // The next sync and frame pick up the change
+    if (geometry_data != NULL) {
+        update_object_bounds(space_node, (uint32_t)index);
+    }
+    mark_object_dirty(space_node, (uint32_t)index);
+    space_node->last_update_time = monotonic_nanoseconds();
+    
+    return true;
+}
+
+/**
+ * @brief Get the number of objects changed since a space's last sync
+ * 
+ * @param space_id Space ID
+ * @return Number of changed objects (0 if the space does not exist)
+ */
+uint32_t qre_pending_changes(uint64_t space_id) {
+    int32_t slot = find_space(space_id);
+    return slot < 0 ? 0 : space_registry[slot].dirty_count;
+}
+
 /**
  * @brief Synchronize a reality space across entangled devices
  * 
@@ -436,26 +883,36 @@ bool qre_sync_space(uint64_t space_id) {
         !space_node->space_data.entanglement->is_active) {
         // No active entanglement, but we'll pretend the sync was successful
         // for testing purposes (since this is a simulation)
-        space_node->last_update_time = (uint64_t)time(NULL);
+        clear_dirty_objects(space_node);
+        space_node->last_update_time = monotonic_nanoseconds();
+        return true;
+    }
+    
+    // Nothing changed since the last sync
+    if (space_node->dirty_count == 0) {
+        space_node->last_update_time = monotonic_nanoseconds();
         return true;
     }
     
     // Synchronize the entanglement
     bool sync_success = qem_sync_entanglement(space_node->space_data.entanglement->id);
     
-    // If space sync was successful, try to sync each object
+    // If space sync was successful, sync the changed objects in one batch
     if (sync_success) {
-        for (uint32_t i = 0; i < space_node->space_data.object_count; i++) {
-            RealityObject *obj = space_node->space_data.objects[i];
+        uint32_t batch_count = 0;
+        for (uint32_t i = 0; i < space_node->dirty_count; i++) {
+            RealityObject *obj = space_node->space_data.objects[space_node->dirty_objects[i]];
             if (obj != NULL && obj->entanglement != NULL && obj->entanglement->is_active) {
-                qem_sync_entanglement(obj->entanglement->id);
+                space_node->sync_ids[batch_count++] = obj->entanglement->id;
             }
         }
+        run_parallel(sync_range, space_node->sync_ids, batch_count, QRE_SYNC_MIN_PER_THREAD);
+        clear_dirty_objects(space_node);
     }
     
     // Update space timestamp
     if (sync_success) {
-        space_node->last_update_time = (uint64_t)time(NULL);
+        space_node->last_update_time = monotonic_nanoseconds();
     }
     
     return sync_success;
@@ -484,27 +941,109 @@ bool qre_render_space(uint64_t space_id, void *output_buffer, uint64_t buffer_si
     // Get space node
     SpaceNode *space_node = &space_registry[slot];
     
-    // Simple placeholder rendering - in a real implementation, this would
-    // invoke complex rendering logic based on space mode and dimensions
+    // Cull the space and summarize the frame
+    uint32_t visible_count = render_frame(space_node, NULL, 0);
     char *render_output = (char *)output_buffer;
-    
-    // Format a simple JSON-like representation of the space
     int written = snprintf(render_output, buffer_size,
-        "{\"space_id\":%llu,\"mode\":%d,\"dimensions\":%d,\"object_count\":%u}",
+        "{\"space_id\":%llu,\"mode\":%d,\"dimensions\":%d,\"object_count\":%u,\"visible\":%u}",
         (unsigned long long)space_node->space_data.id,
         space_node->space_data.mode,
         space_node->space_data.dimensions,
-        space_node->space_data.object_count);
+        space_node->space_data.object_count,
+        visible_count);
     
     // Check if output was truncated
     if (written < 0 || (uint64_t)written >= buffer_size) {
         return false;
     }
     
-    // Update rendering statistics
-    space_node->last_render_time = (uint64_t)time(NULL);
-    space_node->frame_count++;
+    return true;
+}
+
+/**
+ * @brief Render a reality space into draw commands
+ * 
+ * @param space_id Space ID to render
+ * @param commands Buffer for the draw commands
+ * @param max_commands Commands the buffer holds
+ * @param command_count Pointer to store the number of commands written
+ * @return true if rendering succeeded, false otherwise
+ */
+bool qre_render_commands(uint64_t space_id, QRERenderCommand *commands, uint32_t max_commands,
+                         uint32_t *command_count) {
+    // Check initialization and parameters
+    if (!is_initialized || (commands == NULL && max_commands > 0) || command_count == NULL) {
+        return false;
+    }
     
+    // Find the space
+    int32_t slot = find_space(space_id);
+    if (slot < 0) {
+        return false; // Space not found
+    }
+    
+    uint32_t visible_count = render_frame(&space_registry[slot], commands, max_commands);
+    *command_count = visible_count < max_commands ? visible_count : max_commands;
+    return true;
+}
+
+/**
+ * @brief Set the camera a reality space is rendered from
+ * 
+ * @param space_id Space ID
+ * @param camera Camera (NULL to render every object without culling)
+ * @return true if set, false if the space does not exist or the camera is unusable
+ */
+bool qre_set_camera(uint64_t space_id, const QRECamera *camera) {
+    int32_t slot = find_space(space_id);
+    if (slot < 0 || (camera != NULL && !qscene_camera_valid(camera))) {
+        return false;
+    }
+    
+    SpaceNode *space_node = &space_registry[slot];
+    space_node->has_camera = camera != NULL;
+    if (camera != NULL) {
+        space_node->camera = *camera;
+    }
+    return true;
+}
+
+/**
+ * @brief Mark whether an object is solid and hides what lies behind it
+ * 
+ * @param space_id Space ID holding the object
+ * @param object_id Object ID
+ * @param occluder Whether the object occludes
+ * @return true if set, false if the object does not exist
+ */
+bool qre_set_occluder(uint64_t space_id, uint64_t object_id, bool occluder) {
+    int32_t slot = find_space(space_id);
+    if (slot < 0) {
+        return false;
+    }
+    
+    int64_t index = find_object(&space_registry[slot], object_id);
+    if (index < 0) {
+        return false;
+    }
+    qscene_set_occluder(space_registry[slot].scene, (uint32_t)index, occluder);
+    return true;
+}
+
+/**
+ * @brief Get the rendering statistics of a reality space
+ * 
+ * @param space_id Space ID
+ * @param stats Pointer to store the statistics
+ * @return true if the space exists, false otherwise
+ */
+bool qre_get_frame_stats(uint64_t space_id, QREFrameStats *stats) {
+    int32_t slot = find_space(space_id);
+    if (slot < 0 || stats == NULL) {
+        return false;
+    }
+    
+    *stats = space_registry[slot].frame_stats;
     return true;
 }
 
@@ -569,6 +1108,15 @@ void qre_shutdown(void) {
                 free(space_registry[i].private_data);
             }
             
+            // Free change tracking
+            free(space_registry[i].object_dirty);
+            free(space_registry[i].dirty_objects);
+            free(space_registry[i].sync_ids);
+            
+            // Free rendering state
+            qscene_destroy(space_registry[i].scene);
+            free(space_registry[i].visible);
+            
             // Mark as inactive
             space_registry[i].is_active = false;
         }
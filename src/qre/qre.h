@@ -64,6 +64,43 @@ typedef struct {
     EntanglementId *entanglement;    /**< Quantum entanglement (if applicable) */
 } RealitySpace;
 
+/**
+ * @brief Perspective camera a space is rendered from
+ */
+typedef struct {
+    float position[3];               /**< Eye position */
+    float forward[3];                /**< View direction (need not be unit length) */
+    float up[3];                     /**< Up direction (must not be parallel to forward) */
+    float fov_y;                     /**< Vertical field of view, in radians */
+    float aspect;                    /**< Viewport width over height */
+    float near_plane;                /**< Near clipping distance */
+    float far_plane;                 /**< Far clipping distance */
+} QRECamera;
+
+/**
+ * @brief Draw command for one visible object
+ */
+typedef struct {
+    uint64_t object_id;              /**< Object to draw */
+    uint32_t lod;                    /**< Level of detail (0 is full detail) */
+    uint32_t vertex_count;           /**< Vertices to draw at that level */
+    float depth;                     /**< View-space depth of the object's center */
+    float screen_size;               /**< Projected size as a fraction of the viewport height */
+} QRERenderCommand;
+
+/**
+ * @brief Rendering statistics of a space
+ */
+typedef struct {
+    uint64_t frame_count;            /**< Frames rendered */
+    uint64_t last_frame_time;        /**< Time spent on the last frame, in nanoseconds */
+    uint64_t max_frame_time;         /**< Longest frame, in nanoseconds */
+    uint64_t total_frame_time;       /**< Time spent on all frames, in nanoseconds */
+    uint32_t visible_objects;        /**< Objects drawn in the last frame */
+    uint32_t frustum_culled;         /**< Objects outside the view in the last frame */
+    uint32_t occluded_objects;       /**< Objects hidden behind occluders in the last frame */
+} QREFrameStats;
+
 /**
  * @brief Initialize the Unified Quantum Reality Engine
  * 
@@ -110,9 +147,42 @@ RealityObject qre_create_object(uint64_t space_id,
                               bool use_quantum,
                               uint64_t knowledge_node_id);
 
+/**
+ * @brief Modify an object in a reality space
+ * 
+ * The object is synchronized by the next qre_sync_space. With both data
+ * pointers NULL, only marks the object changed, for callers that edited
+ * its data in place.
+ * 
+ * @param space_id Space ID holding the object
+ * @param object_id Object ID
+ * @param geometry_data New geometry data (NULL to keep the current data)
+ * @param geometry_size New geometry data size (0 to drop the geometry)
+ * @param material_data New material data (NULL to keep the current data)
+ * @param material_size New material data size (0 to drop the material)
+ * @return true if the object was modified, false otherwise
+ */
+bool qre_modify_object(uint64_t space_id,
+                       uint64_t object_id,
+                       const void *geometry_data,
+                       uint64_t geometry_size,
+                       const void *material_data,
+                       uint64_t material_size);
+
+/**
+ * @brief Get the number of objects changed since a space's last sync
+ * 
+ * @param space_id Space ID
+ * @return Number of changed objects (0 if the space does not exist)
+ */
+uint32_t qre_pending_changes(uint64_t space_id);
+
 /**
  * @brief Synchronize a reality space across entangled devices
  * 
+ * Only the objects created or modified since the last sync are
+ * synchronized, in one batch split across threads when it is large.
+ * 
  * @param space_id Space ID to synchronize
  * @return true if synchronization succeeded, false otherwise
  */
@@ -121,6 +191,9 @@ bool qre_sync_space(uint64_t space_id);
 /**
  * @brief Render a reality space
  * 
+ * Culls the space from its camera and writes a JSON summary of the frame
+ * with the number of visible objects.
+ * 
  * @param space_id Space ID to render
  * @param output_buffer Output buffer for rendering
  * @param buffer_size Output buffer size
@@ -128,6 +201,56 @@ bool qre_sync_space(uint64_t space_id);
  */
 bool qre_render_space(uint64_t space_id, void *output_buffer, uint64_t buffer_size);
 
+/**
+ * @brief Render a reality space into draw commands
+ * 
+ * Objects are culled against the space's camera frustum and occluders,
+ * and each visible one gets a command at the level of detail its
+ * projected size calls for under the space's visualization dimensions.
+ * Objects with no geometry are never drawn. Commands come roughly
+ * nearest first; when more objects are visible than the buffer holds,
+ * the farthest are dropped.
+ * 
+ * @param space_id Space ID to render
+ * @param commands Buffer for the draw commands
+ * @param max_commands Commands the buffer holds
+ * @param command_count Pointer to store the number of commands written
+ * @return true if rendering succeeded, false otherwise
+ */
+bool qre_render_commands(uint64_t space_id, QRERenderCommand *commands, uint32_t max_commands,
+                         uint32_t *command_count);
+
+/**
+ * @brief Set the camera a reality space is rendered from
+ * 
+ * @param space_id Space ID
+ * @param camera Camera (NULL to render every object without culling)
+ * @return true if set, false if the space does not exist or the camera is unusable
+ */
+bool qre_set_camera(uint64_t space_id, const QRECamera *camera);
+
+/**
+ * @brief Mark whether an object is solid and hides what lies behind it
+ * 
+ * Occluders let rendering skip the objects behind them. An occluder is
+ * taken to fill its geometry's bounding box.
+ * 
+ * @param space_id Space ID holding the object
+ * @param object_id Object ID
+ * @param occluder Whether the object occludes
+ * @return true if set, false if the object does not exist
+ */
+bool qre_set_occluder(uint64_t space_id, uint64_t object_id, bool occluder);
+
+/**
+ * @brief Get the rendering statistics of a reality space
+ * 
+ * @param space_id Space ID
+ * @param stats Pointer to store the statistics
+ * @return true if the space exists, false otherwise
+ */
+bool qre_get_frame_stats(uint64_t space_id, QREFrameStats *stats);
+
 /**
  * @brief Shutdown the Unified Quantum Reality Engine
  */
@@ -0,0 +1,682 @@
+/**
+ * @file qre_scene.c
+ * @brief Bounding volume hierarchy and visibility culling for reality spaces
+ *
+ * The hierarchy is a flat array of nodes in depth-first order: a node's
+ * left child follows it and its right child is stored by index, so a
+ * backwards pass sees children before parents when refitting. Every node
+ * covers a contiguous range of the tree-ordered slot array, split at the
+ * median center along the widest axis.
+ *
+ * Culling keeps a mask of the frustum planes a node straddles; children
+ * of a node wholly inside a plane skip that plane. The occlusion grid
+ * covers the viewport in QSCENE_GRID_WIDTH by QSCENE_GRID_HEIGHT tiles,
+ * each holding the farthest depth known to be hidden there.
+ */
+
+#include "qre_scene.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define QSCENE_LEAF_ITEMS 4
+#define QSCENE_STACK_DEPTH 128
+#define QSCENE_GRID_WIDTH 64
+#define QSCENE_GRID_HEIGHT 32
+
+/* Fraction of an occluder's inscribed sphere radius its grid footprint
+ * spans, leaving room for the perspective stretching of the silhouette */
+#define QSCENE_OCCLUDER_FOOTPRINT 0.5f
+
+#define QSCENE_ALL_PLANES 0x3Fu
+
+enum {
+    SCENE_HAS_BOUNDS = 1,
+    SCENE_OCCLUDER = 2
+};
+
+/**
+ * @brief Hierarchy node
+ */
+typedef struct {
+    float min[3];
+    float max[3];
+    uint32_t first;                    /**< First tree position covered */
+    uint32_t count;                    /**< Tree positions covered */
+    uint32_t right;                    /**< Right child, or 0 for a leaf */
+} SceneNode;
+
+/**
+ * @brief Scene state
+ */
+struct QREScene {
+    uint32_t count;                    /**< Item slots */
+    uint32_t capacity;
+    float *bounds;                     /**< Min then max corner, six per slot */
+    uint8_t *flags;                    /**< SCENE_* per slot */
+
+    SceneNode *nodes;
+    uint32_t node_count;
+    uint32_t *order;                   /**< Slot at each tree position */
+    uint32_t order_count;              /**< Items in the tree */
+    bool rebuild;                      /**< Items gained or lost a box */
+    bool refit;                        /**< Boxes moved */
+
+    float grid[QSCENE_GRID_WIDTH * QSCENE_GRID_HEIGHT];
+    bool grid_used;                    /**< Whether any occluder was drawn this cull */
+};
+
+/**
+ * @brief Camera basis and frustum planes
+ */
+typedef struct {
+    float position[3];
+    float forward[3];
+    float right[3];
+    float up[3];
+    float tan_half_y;
+    float tan_half_x;
+    float near_plane;
+    float planes[6][4];                /**< Normal and offset; inside where positive */
+} SceneView;
+
+/**
+ * @brief Dot product
+ */
+static float dot3(const float *a, const float *b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+/**
+ * @brief Cross product
+ */
+static void cross3(const float *a, const float *b, float *out) {
+    out[0] = a[1] * b[2] - a[2] * b[1];
+    out[1] = a[2] * b[0] - a[0] * b[2];
+    out[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+/**
+ * @brief Scale a vector to unit length
+ *
+ * @return false if it has no usable length
+ */
+static bool normalize3(float *v) {
+    float length = sqrtf(dot3(v, v));
+    if (!(length > 1e-12f) || !isfinite(length)) {
+        return false;
+    }
+    for (int axis = 0; axis < 3; axis++) {
+        v[axis] /= length;
+    }
+    return true;
+}
+
+/**
+ * @brief Derive the camera basis, or fail if the camera is unusable
+ */
+static bool make_view(const QRECamera *camera, SceneView *view) {
+    if (!(camera->fov_y > 0.0f && camera->fov_y < 3.1f) || !(camera->aspect > 0.0f) ||
+        !(camera->near_plane > 0.0f) || !(camera->far_plane > camera->near_plane)) {
+        return false;
+    }
+    memcpy(view->position, camera->position, sizeof(view->position));
+    memcpy(view->forward, camera->forward, sizeof(view->forward));
+    if (!normalize3(view->forward)) {
+        return false;
+    }
+    cross3(view->forward, camera->up, view->right);
+    if (!normalize3(view->right)) {
+        return false;
+    }
+    cross3(view->right, view->forward, view->up);
+    view->tan_half_y = tanf(camera->fov_y * 0.5f);
+    view->tan_half_x = view->tan_half_y * camera->aspect;
+    view->near_plane = camera->near_plane;
+
+    /* Near, far, then the four sides, each through the eye */
+    const float *f = view->forward;
+    for (int axis = 0; axis < 3; axis++) {
+        view->planes[0][axis] = f[axis];
+        view->planes[1][axis] = -f[axis];
+        view->planes[2][axis] = f[axis] * view->tan_half_x - view->right[axis];
+        view->planes[3][axis] = f[axis] * view->tan_half_x + view->right[axis];
+        view->planes[4][axis] = f[axis] * view->tan_half_y - view->up[axis];
+        view->planes[5][axis] = f[axis] * view->tan_half_y + view->up[axis];
+    }
+    float eye = dot3(f, view->position);
+    view->planes[0][3] = -eye - camera->near_plane;
+    view->planes[1][3] = eye + camera->far_plane;
+    for (int p = 2; p < 6; p++) {
+        view->planes[p][3] = -dot3(view->planes[p], view->position);
+    }
+    return true;
+}
+
+/**
+ * @brief Whether a camera can be rendered from
+ */
+bool qscene_camera_valid(const QRECamera *camera) {
+    SceneView view;
+    return camera != NULL && make_view(camera, &view);
+}
+
+/**
+ * @brief View-space depth of a point
+ */
+static float view_depth(const SceneView *view, const float *point) {
+    float offset[3] = {
+        point[0] - view->position[0], point[1] - view->position[1], point[2] - view->position[2]
+    };
+    return dot3(offset, view->forward);
+}
+
+/**
+ * @brief Test a box against the planes still in the mask
+ *
+ * Planes the box lies wholly inside are cleared from the mask.
+ *
+ * @return false if the box is outside any plane
+ */
+static bool inside_frustum(const SceneView *view, const float *min, const float *max, uint32_t *mask) {
+    for (int p = 0; p < 6; p++) {
+        if (!(*mask & (1u << p))) {
+            continue;
+        }
+        const float *plane = view->planes[p];
+        float far_corner = plane[3];
+        float near_corner = plane[3];
+        for (int axis = 0; axis < 3; axis++) {
+            bool positive = plane[axis] >= 0.0f;
+            far_corner += plane[axis] * (positive ? max[axis] : min[axis]);
+            near_corner += plane[axis] * (positive ? min[axis] : max[axis]);
+        }
+        if (far_corner < 0.0f) {
+            return false;
+        }
+        if (near_corner >= 0.0f) {
+            *mask &= ~(1u << p);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Grid column or row of a normalized screen coordinate, clamped
+ */
+static int grid_cell(float coordinate, int cells) {
+    int cell = (int)floorf((coordinate + 1.0f) * 0.5f * (float)cells);
+    return cell < 0 ? 0 : cell >= cells ? cells - 1 : cell;
+}
+
+/**
+ * @brief Whether a box lies wholly behind the occlusion grid
+ */
+static bool occluded(const QREScene *scene, const SceneView *view, const float *min, const float *max) {
+    if (!scene->grid_used) {
+        return false;
+    }
+
+    float low_x = INFINITY, high_x = -INFINITY, low_y = INFINITY, high_y = -INFINITY;
+    float nearest = INFINITY;
+    for (int corner = 0; corner < 8; corner++) {
+        float point[3] = {
+            (corner & 1) ? max[0] : min[0], (corner & 2) ? max[1] : min[1], (corner & 4) ? max[2] : min[2]
+        };
+        float offset[3] = {
+            point[0] - view->position[0], point[1] - view->position[1], point[2] - view->position[2]
+        };
+        float z = dot3(offset, view->forward);
+        if (z <= view->near_plane) {
+            return false;
+        }
+        float x = dot3(offset, view->right) / (z * view->tan_half_x);
+        float y = dot3(offset, view->up) / (z * view->tan_half_y);
+        low_x = x < low_x ? x : low_x;
+        high_x = x > high_x ? x : high_x;
+        low_y = y < low_y ? y : low_y;
+        high_y = y > high_y ? y : high_y;
+        nearest = z < nearest ? z : nearest;
+    }
+
+    int x0 = grid_cell(low_x, QSCENE_GRID_WIDTH), x1 = grid_cell(high_x, QSCENE_GRID_WIDTH);
+    int y0 = grid_cell(low_y, QSCENE_GRID_HEIGHT), y1 = grid_cell(high_y, QSCENE_GRID_HEIGHT);
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            if (scene->grid[y * QSCENE_GRID_WIDTH + x] >= nearest) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Record what an occluder hides in the grid
+ *
+ * Only cells wholly inside a disk well within the silhouette of the
+ * sphere inscribed in the box are written, with the sphere's far depth.
+ */
+static void draw_occluder(QREScene *scene, const SceneView *view, const float *min, const float *max) {
+    float center[3], radius = INFINITY;
+    for (int axis = 0; axis < 3; axis++) {
+        center[axis] = 0.5f * (min[axis] + max[axis]);
+        float half = 0.5f * (max[axis] - min[axis]);
+        radius = half < radius ? half : radius;
+    }
+    float z = view_depth(view, center);
+    if (!(radius > 0.0f) || z - radius <= view->near_plane) {
+        return;
+    }
+
+    float offset[3] = {
+        center[0] - view->position[0], center[1] - view->position[1], center[2] - view->position[2]
+    };
+    float x = dot3(offset, view->right) / (z * view->tan_half_x);
+    float y = dot3(offset, view->up) / (z * view->tan_half_y);
+    float half_x = QSCENE_OCCLUDER_FOOTPRINT * radius / (z * view->tan_half_x);
+    float half_y = QSCENE_OCCLUDER_FOOTPRINT * radius / (z * view->tan_half_y);
+
+    /* Cells whose whole extent lies in the footprint */
+    int x0 = (int)ceilf((x - half_x + 1.0f) * 0.5f * QSCENE_GRID_WIDTH);
+    int x1 = (int)floorf((x + half_x + 1.0f) * 0.5f * QSCENE_GRID_WIDTH) - 1;
+    int y0 = (int)ceilf((y - half_y + 1.0f) * 0.5f * QSCENE_GRID_HEIGHT);
+    int y1 = (int)floorf((y + half_y + 1.0f) * 0.5f * QSCENE_GRID_HEIGHT) - 1;
+    x0 = x0 < 0 ? 0 : x0;
+    y0 = y0 < 0 ? 0 : y0;
+    x1 = x1 >= QSCENE_GRID_WIDTH ? QSCENE_GRID_WIDTH - 1 : x1;
+    y1 = y1 >= QSCENE_GRID_HEIGHT ? QSCENE_GRID_HEIGHT - 1 : y1;
+
+    float hidden = z + radius;
+    for (int row = y0; row <= y1; row++) {
+        for (int column = x0; column <= x1; column++) {
+            float *cell = &scene->grid[row * QSCENE_GRID_WIDTH + column];
+            *cell = hidden < *cell ? hidden : *cell;
+            scene->grid_used = true;
+        }
+    }
+}
+
+/**
+ * @brief Grow a box to cover a slot's box
+ */
+static void cover_slot(const QREScene *scene, uint32_t slot, float *min, float *max) {
+    const float *bounds = &scene->bounds[slot * 6];
+    for (int axis = 0; axis < 3; axis++) {
+        min[axis] = bounds[axis] < min[axis] ? bounds[axis] : min[axis];
+        max[axis] = bounds[3 + axis] > max[axis] ? bounds[3 + axis] : max[axis];
+    }
+}
+
+/**
+ * @brief Recompute a node's box from its items
+ */
+static void fit_leaf(QREScene *scene, SceneNode *node) {
+    for (int axis = 0; axis < 3; axis++) {
+        node->min[axis] = INFINITY;
+        node->max[axis] = -INFINITY;
+    }
+    for (uint32_t i = node->first; i < node->first + node->count; i++) {
+        cover_slot(scene, scene->order[i], node->min, node->max);
+    }
+}
+
+/**
+ * @brief Swap two tree positions and their centers
+ */
+static void swap_positions(QREScene *scene, float *centers, uint32_t a, uint32_t b) {
+    for (int axis = 0; axis < 3; axis++) {
+        float value = centers[a * 3 + axis];
+        centers[a * 3 + axis] = centers[b * 3 + axis];
+        centers[b * 3 + axis] = value;
+    }
+    uint32_t slot = scene->order[a];
+    scene->order[a] = scene->order[b];
+    scene->order[b] = slot;
+}
+
+/**
+ * @brief Move the k-th smallest center along an axis to position k
+ *
+ * Three-way partitioning keeps scenes with many identical centers
+ * linear rather than quadratic.
+ */
+static void select_position(QREScene *scene, float *centers, uint32_t lo, uint32_t hi, uint32_t k, int axis) {
+    while (hi - lo > 1) {
+        float pivot = centers[(lo + (hi - lo) / 2) * 3 + axis];
+        uint32_t less = lo, equal = lo, greater = hi;
+        while (equal < greater) {
+            float value = centers[equal * 3 + axis];
+            if (value < pivot) {
+                swap_positions(scene, centers, less++, equal++);
+            } else if (value > pivot) {
+                swap_positions(scene, centers, equal, --greater);
+            } else {
+                equal++;
+            }
+        }
+        if (k < less) {
+            hi = less;
+        } else if (k >= greater) {
+            lo = greater;
+        } else {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Build the subtree over a range of tree positions
+ *
+ * @return Index of the subtree's root
+ */
+static uint32_t build_node(QREScene *scene, float *centers, uint32_t lo, uint32_t hi) {
+    uint32_t index = scene->node_count++;
+    SceneNode *node = &scene->nodes[index];
+    node->first = lo;
+    node->count = hi - lo;
+    node->right = 0;
+    fit_leaf(scene, node);
+    if (hi - lo <= QSCENE_LEAF_ITEMS) {
+        return index;
+    }
+
+    float low[3] = { INFINITY, INFINITY, INFINITY };
+    float high[3] = { -INFINITY, -INFINITY, -INFINITY };
+    for (uint32_t i = lo; i < hi; i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            float value = centers[i * 3 + axis];
+            low[axis] = value < low[axis] ? value : low[axis];
+            high[axis] = value > high[axis] ? value : high[axis];
+        }
+    }
+    int axis = 0;
+    for (int candidate = 1; candidate < 3; candidate++) {
+        if (high[candidate] - low[candidate] > high[axis] - low[axis]) {
+            axis = candidate;
+        }
+    }
+
+    uint32_t mid = lo + (hi - lo) / 2;
+    select_position(scene, centers, lo, hi, mid, axis);
+    build_node(scene, centers, lo, mid);
+    uint32_t right = build_node(scene, centers, mid, hi);
+    scene->nodes[index].right = right;
+    return index;
+}
+
+/**
+ * @brief Rebuild the hierarchy over every item with a box
+ */
+static bool build_tree(QREScene *scene) {
+    uint32_t count = 0;
+    for (uint32_t slot = 0; slot < scene->count; slot++) {
+        count += (scene->flags[slot] & SCENE_HAS_BOUNDS) != 0;
+    }
+
+    SceneNode *nodes = count ? (SceneNode *)realloc(scene->nodes, (size_t)count * 2 * sizeof(SceneNode)) : scene->nodes;
+    uint32_t *order = count ? (uint32_t *)realloc(scene->order, (size_t)count * sizeof(uint32_t)) : scene->order;
+    float *centers = (float *)malloc((size_t)(count ? count : 1) * 3 * sizeof(float));
+    if (nodes) {
+        scene->nodes = nodes;
+    }
+    if (order) {
+        scene->order = order;
+    }
+    if ((count && (!nodes || !order)) || !centers) {
+        free(centers);
+        scene->node_count = 0;
+        scene->order_count = 0;
+        return false;
+    }
+
+    uint32_t position = 0;
+    for (uint32_t slot = 0; slot < scene->count; slot++) {
+        if (scene->flags[slot] & SCENE_HAS_BOUNDS) {
+            const float *bounds = &scene->bounds[slot * 6];
+            for (int axis = 0; axis < 3; axis++) {
+                centers[position * 3 + axis] = 0.5f * (bounds[axis] + bounds[3 + axis]);
+            }
+            scene->order[position++] = slot;
+        }
+    }
+
+    scene->node_count = 0;
+    scene->order_count = count;
+    if (count > 0) {
+        build_node(scene, centers, 0, count);
+    }
+    free(centers);
+    scene->rebuild = false;
+    scene->refit = false;
+    return true;
+}
+
+/**
+ * @brief Recompute every node's box after items moved
+ */
+static void refit_tree(QREScene *scene) {
+    for (uint32_t i = scene->node_count; i-- > 0;) {
+        SceneNode *node = &scene->nodes[i];
+        if (node->right == 0) {
+            fit_leaf(scene, node);
+            continue;
+        }
+        const SceneNode *left = &scene->nodes[i + 1];
+        const SceneNode *right = &scene->nodes[node->right];
+        for (int axis = 0; axis < 3; axis++) {
+            node->min[axis] = left->min[axis] < right->min[axis] ? left->min[axis] : right->min[axis];
+            node->max[axis] = left->max[axis] > right->max[axis] ? left->max[axis] : right->max[axis];
+        }
+    }
+    scene->refit = false;
+}
+
+/**
+ * @brief Create an empty scene
+ */
+QREScene *qscene_create(void) {
+    return (QREScene *)calloc(1, sizeof(QREScene));
+}
+
+/**
+ * @brief Destroy a scene
+ */
+void qscene_destroy(QREScene *scene) {
+    if (!scene) {
+        return;
+    }
+    free(scene->bounds);
+    free(scene->flags);
+    free(scene->nodes);
+    free(scene->order);
+    free(scene);
+}
+
+/**
+ * @brief Set the number of item slots
+ */
+bool qscene_resize(QREScene *scene, uint32_t count) {
+    if (!scene) {
+        return false;
+    }
+    if (count > scene->capacity) {
+        uint32_t capacity = scene->capacity < 8 ? 8 : scene->capacity;
+        while (capacity < count) {
+            capacity *= 2;
+        }
+        float *bounds = (float *)realloc(scene->bounds, (size_t)capacity * 6 * sizeof(float));
+        if (!bounds) {
+            return false;
+        }
+        scene->bounds = bounds;
+        uint8_t *flags = (uint8_t *)realloc(scene->flags, capacity);
+        if (!flags) {
+            return false;
+        }
+        scene->flags = flags;
+        scene->capacity = capacity;
+    }
+
+    for (uint32_t slot = scene->count; slot < count; slot++) {
+        scene->flags[slot] = 0;
+    }
+    for (uint32_t slot = count; slot < scene->count; slot++) {
+        scene->rebuild |= (scene->flags[slot] & SCENE_HAS_BOUNDS) != 0;
+    }
+    scene->count = count;
+    return true;
+}
+
+/**
+ * @brief Set or clear an item's box
+ */
+void qscene_set_bounds(QREScene *scene, uint32_t slot, const float min[3], const float max[3]) {
+    if (!scene || slot >= scene->count) {
+        return;
+    }
+    bool had_bounds = (scene->flags[slot] & SCENE_HAS_BOUNDS) != 0;
+    if (!min || !max) {
+        scene->flags[slot] &= (uint8_t)~SCENE_HAS_BOUNDS;
+        scene->rebuild |= had_bounds;
+        return;
+    }
+
+    float *bounds = &scene->bounds[slot * 6];
+    for (int axis = 0; axis < 3; axis++) {
+        bounds[axis] = min[axis] < max[axis] ? min[axis] : max[axis];
+        bounds[3 + axis] = min[axis] < max[axis] ? max[axis] : min[axis];
+    }
+    scene->flags[slot] |= SCENE_HAS_BOUNDS;
+    scene->rebuild |= !had_bounds;
+    scene->refit |= had_bounds;
+}
+
+/**
+ * @brief Mark whether an item is solid and hides what lies behind it
+ */
+void qscene_set_occluder(QREScene *scene, uint32_t slot, bool occluder) {
+    if (!scene || slot >= scene->count) {
+        return;
+    }
+    if (occluder) {
+        scene->flags[slot] |= SCENE_OCCLUDER;
+    } else {
+        scene->flags[slot] &= (uint8_t)~SCENE_OCCLUDER;
+    }
+}
+
+/**
+ * @brief Find the items a camera sees
+ */
+uint32_t qscene_cull(QREScene *scene, const QRECamera *camera, QSceneVisible *visible,
+                     QSceneCullStats *stats) {
+    QSceneCullStats counters = { 0, 0, 0 };
+    if (stats) {
+        *stats = counters;
+    }
+    if (!scene || !visible) {
+        return 0;
+    }
+
+    uint32_t found = 0;
+    if (!camera) {
+        for (uint32_t slot = 0; slot < scene->count; slot++) {
+            if (scene->flags[slot] & SCENE_HAS_BOUNDS) {
+                visible[found++] = (QSceneVisible){ slot, 0.0f, 1.0f };
+            }
+        }
+        return found;
+    }
+
+    SceneView view;
+    if (!make_view(camera, &view)) {
+        return 0;
+    }
+    if (scene->rebuild && !build_tree(scene)) {
+        return 0;
+    }
+    if (scene->refit) {
+        refit_tree(scene);
+    }
+    if (scene->node_count == 0) {
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < QSCENE_GRID_WIDTH * QSCENE_GRID_HEIGHT; i++) {
+        scene->grid[i] = INFINITY;
+    }
+    scene->grid_used = false;
+
+    /* Depth-first, nearer child first, so occluders are drawn before what they hide */
+    uint32_t stack_nodes[QSCENE_STACK_DEPTH];
+    uint32_t stack_masks[QSCENE_STACK_DEPTH];
+    uint32_t depth = 0;
+    stack_nodes[depth] = 0;
+    stack_masks[depth++] = QSCENE_ALL_PLANES;
+    while (depth > 0) {
+        depth--;
+        const SceneNode *node = &scene->nodes[stack_nodes[depth]];
+        uint32_t mask = stack_masks[depth];
+        counters.nodes_visited++;
+
+        if (mask && !inside_frustum(&view, node->min, node->max, &mask)) {
+            counters.frustum_culled += node->count;
+            continue;
+        }
+        if (occluded(scene, &view, node->min, node->max)) {
+            counters.occluded += node->count;
+            continue;
+        }
+
+        if (node->right != 0) {
+            uint32_t left_index = stack_nodes[depth] + 1;
+            uint32_t right_index = node->right;
+            float left_center[3], right_center[3];
+            for (int axis = 0; axis < 3; axis++) {
+                left_center[axis] = 0.5f * (scene->nodes[left_index].min[axis] + scene->nodes[left_index].max[axis]);
+                right_center[axis] = 0.5f * (scene->nodes[right_index].min[axis] + scene->nodes[right_index].max[axis]);
+            }
+            bool left_first = view_depth(&view, left_center) <= view_depth(&view, right_center);
+            stack_nodes[depth] = left_first ? right_index : left_index;
+            stack_masks[depth++] = mask;
+            stack_nodes[depth] = left_first ? left_index : right_index;
+            stack_masks[depth++] = mask;
+            continue;
+        }
+
+        for (uint32_t i = node->first; i < node->first + node->count; i++) {
+            uint32_t slot = scene->order[i];
+            const float *min = &scene->bounds[slot * 6];
+            const float *max = min + 3;
+            uint32_t item_mask = mask;
+            if (item_mask && !inside_frustum(&view, min, max, &item_mask)) {
+                counters.frustum_culled++;
+                continue;
+            }
+            if (occluded(scene, &view, min, max)) {
+                counters.occluded++;
+                continue;
+            }
+
+            float center[3], extent[3];
+            for (int axis = 0; axis < 3; axis++) {
+                center[axis] = 0.5f * (min[axis] + max[axis]);
+                extent[axis] = 0.5f * (max[axis] - min[axis]);
+            }
+            float z = view_depth(&view, center);
+            float clamped = z > view.near_plane ? z : view.near_plane;
+            visible[found++] = (QSceneVisible){
+                slot, z, sqrtf(dot3(extent, extent)) / (clamped * view.tan_half_y)
+            };
+            if (scene->flags[slot] & SCENE_OCCLUDER) {
+                draw_occluder(scene, &view, min, max);
+            }
+        }
+    }
+
+    if (stats) {
+        *stats = counters;
+    }
+    return found;
+}
@@ -0,0 +1,119 @@
+/**
+ * @file qre_scene.h
+ * @brief Bounding volume hierarchy and visibility culling for reality spaces
+ *
+ * A scene holds an axis-aligned box per item and keeps a bounding volume
+ * hierarchy over them. Culling walks the hierarchy front to back,
+ * dropping whole subtrees outside the camera's frustum or hidden behind
+ * occluders, so its cost follows what is visible rather than the number
+ * of items.
+ *
+ * Occlusion is conservative. Items marked as occluders are taken to be
+ * solid; each one drawn writes the depth of the sphere inscribed in its
+ * box into a coarse screen-space depth grid, and later boxes lying wholly
+ * behind the grid are hidden. Nothing visible is ever culled, though some
+ * hidden items may be reported.
+ *
+ * The hierarchy is rebuilt on the next cull after items gain or lose a
+ * box, and refitted in place when boxes only move. A scene is not
+ * thread-safe; callers serialize access.
+ */
+
+#ifndef CTRLXT_QRE_SCENE_H
+#define CTRLXT_QRE_SCENE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "qre.h"
+
+/**
+ * @brief Opaque scene handle
+ */
+typedef struct QREScene QREScene;
+
+/**
+ * @brief Item that survived culling
+ */
+typedef struct {
+    uint32_t slot;                   /**< Item slot */
+    float depth;                     /**< View-space depth of the box's center */
+    float screen_size;               /**< Projected size as a fraction of the viewport height */
+} QSceneVisible;
+
+/**
+ * @brief Counters of one cull
+ */
+typedef struct {
+    uint32_t nodes_visited;          /**< Hierarchy nodes tested */
+    uint32_t frustum_culled;         /**< Items outside the frustum */
+    uint32_t occluded;               /**< Items hidden behind occluders */
+} QSceneCullStats;
+
+/**
+ * @brief Whether a camera can be rendered from
+ *
+ * @param camera Camera
+ * @return true if the field of view, aspect, clipping planes and axes are usable
+ */
+bool qscene_camera_valid(const QRECamera *camera);
+
+/**
+ * @brief Create an empty scene
+ *
+ * @return Scene, or NULL on allocation failure
+ */
+QREScene *qscene_create(void);
+
+/**
+ * @brief Destroy a scene
+ *
+ * @param scene Scene (may be NULL)
+ */
+void qscene_destroy(QREScene *scene);
+
+/**
+ * @brief Set the number of item slots
+ *
+ * New slots have no box. Slots past a smaller count are dropped.
+ *
+ * @param scene Scene
+ * @param count Number of slots
+ * @return true if resized, false on allocation failure (the scene is unchanged)
+ */
+bool qscene_resize(QREScene *scene, uint32_t count);
+
+/**
+ * @brief Set or clear an item's box
+ *
+ * @param scene Scene
+ * @param slot Item slot
+ * @param min Lowest corner (NULL to clear the box; the item is then never visible)
+ * @param max Highest corner
+ */
+void qscene_set_bounds(QREScene *scene, uint32_t slot, const float min[3], const float max[3]);
+
+/**
+ * @brief Mark whether an item is solid and hides what lies behind it
+ *
+ * @param scene Scene
+ * @param slot Item slot
+ * @param occluder Whether the item occludes
+ */
+void qscene_set_occluder(QREScene *scene, uint32_t slot, bool occluder);
+
+/**
+ * @brief Find the items a camera sees
+ *
+ * Items are reported roughly nearest first. With no camera every item
+ * with a box is reported, in slot order, with a depth of 0 and a size of 1.
+ *
+ * @param scene Scene
+ * @param camera Camera (NULL for no culling; must be valid otherwise)
+ * @param visible Array with room for every slot
+ * @param stats Pointer to store the cull's counters (may be NULL)
+ * @return Number of visible items, or 0 if the hierarchy could not be built
+ */
+uint32_t qscene_cull(QREScene *scene, const QRECamera *camera, QSceneVisible *visible,
+                     QSceneCullStats *stats);
+
+#endif /* CTRLXT_QRE_SCENE_H */
@@ -1,11 +1,43 @@
+// POSIX clocks, condition variable clocks and sched_yield
+#define _XOPEN_SOURCE 700
+
 #include "quantum_ai.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
 #include <curl/curl.h>
 #include <json-c/json.h>
 
+// Cloud synchronization timing
+#define QAI_SYNC_POLL_MS 1000
+#define QAI_SYNC_TIMEOUT_MS 30000
+
+// Queued inference request; lives on the caller's stack until completed
+typedef struct AIRequest {
+    const void* input_data;
+    size_t input_size;
+    void* output_data;
+    size_t output_size;
+    AIProcessingMode mode;
+    uint64_t submitted_ns;
+    bool done;
+    bool success;
+    pthread_cond_t done_cond;
+    struct AIRequest* next;
+} AIRequest;
+
+// Immutable model snapshot; updates replace it as a whole
+typedef struct {
+    AIModelType model_type;
+    uint64_t version;
+    size_t param_size;
+    unsigned char parameters[];
+} AIModelSnapshot;
+
 // Static variables
 static AIConfig current_config;
 static AIState current_state;
@@ -13,13 +45,71 @@ static pthread_mutex_t ai_mutex = PTHREAD_MUTEX_INITIALIZER;
 static CURL* curl_handle = NULL;
 static bool api_connected = false;
 
+// Request queue and worker pool, guarded by queue_mutex
+static pthread_mutex_t queue_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_cond;
+static AIRequest* queue_head = NULL;
+static AIRequest* queue_tail = NULL;
+static uint32_t queue_depth = 0;
+static uint32_t urgent_requests = 0;
+static AIProcessingMode queue_mode = AI_MODE_REAL_TIME;
+static uint32_t max_batch_size = QAI_DEFAULT_BATCH_SIZE;
+static uint64_t max_batch_latency_ns = QAI_DEFAULT_BATCH_LATENCY_US * 1000ULL;
+static bool accepting_requests = false;
+static bool workers_running = false;
+static pthread_t workers[QAI_MAX_WORKERS];
+static uint32_t worker_count = 0;
+static uint32_t active_batches = 0;
+
+// Throughput and latency counters, guarded by queue_mutex
+static uint64_t started_ns = 0;
+static uint64_t completed_requests = 0;
+static uint64_t failed_requests = 0;
+static uint64_t batch_count = 0;
+static uint64_t batched_requests = 0;
+static uint64_t total_latency_ns = 0;
+static uint64_t max_latency_ns = 0;
+
+// Model snapshots, read without locking: each worker advertises the epoch it
+// started reading in, and a replaced snapshot is freed only once every worker
+// that may still hold it has moved on. Updates are serialized by model_mutex.
+static _Atomic(AIModelSnapshot*) active_model = NULL;
+static atomic_uint_fast64_t model_epoch = 1;
+static atomic_uint_fast64_t reader_epochs[QAI_MAX_WORKERS];
+static pthread_mutex_t model_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Cloud synchronization, driven by one thread on a reused multi handle.
+// Only that thread touches the handles; other threads hand it payloads.
+static pthread_mutex_t sync_mutex = PTHREAD_MUTEX_INITIALIZER;
+static CURLM* multi_handle = NULL;
+static CURL* sync_handle = NULL;
+static struct curl_slist* sync_headers = NULL;
+static pthread_t sync_thread;
+static bool sync_running = false;
+static bool sync_in_flight = false;
+static char* pending_body = NULL;
+static char* active_body = NULL;
+static char sync_endpoint[256];
+static char sync_api_key[64];
+static uint64_t cloud_syncs = 0;
+static uint64_t cloud_sync_failures = 0;
+
 // Internal function prototypes
 static bool initialize_quantum_processor(void);
 static bool initialize_neural_network(void);
 static bool validate_config(const AIConfig* config);
 static size_t write_callback(void* contents, size_t size, size_t nmemb, void* userp);
-static bool process_quantum_data(const void* input_data, size_t input_size, void* output_data, size_t output_size);
-static bool process_classical_data(const void* input_data, size_t input_size, void* output_data, size_t output_size);
+static bool process_quantum_data(const AIModelSnapshot* model, const void* input_data, size_t input_size, void* output_data, size_t output_size);
+static bool process_classical_data(const AIModelSnapshot* model, const void* input_data, size_t input_size, void* output_data, size_t output_size);
+static uint64_t monotonic_ns(void);
+static bool start_workers(uint32_t thread_count);
+static void stop_workers(void);
+static void* batch_worker(void* arg);
+static bool replace_model(AIModelType model_type, const void* parameters, size_t param_size);
+static bool start_cloud_sync(void);
+static void stop_cloud_sync(void);
+static void* cloud_sync_worker(void* arg);
+static void stop_engine(void);
 
 // Initialize the AI system
 bool qai_init(const AIConfig* config) {
@@ -29,6 +119,11 @@ bool qai_init(const AIConfig* config) {
 
     pthread_mutex_lock(&ai_mutex);
 
+    if (current_state.is_initialized) {
+        pthread_mutex_unlock(&ai_mutex);
+        return false;
+    }
+
     // Initialize state
     memset(&current_state, 0, sizeof(AIState));
     memcpy(&current_config, config, sizeof(AIConfig));
@@ -37,6 +132,7 @@ bool qai_init(const AIConfig* config) {
     curl_global_init(CURL_GLOBAL_DEFAULT);
     curl_handle = curl_easy_init();
     if (!curl_handle) {
+        curl_global_cleanup();
         pthread_mutex_unlock(&ai_mutex);
         return false;
     }
@@ -44,6 +140,7 @@ bool qai_init(const AIConfig* config) {
     // Initialize quantum processor if enabled
     if (config->enable_quantum_acceleration) {
         if (!initialize_quantum_processor()) {
+            stop_engine();
             pthread_mutex_unlock(&ai_mutex);
             return false;
         }
@@ -51,70 +148,97 @@ bool qai_init(const AIConfig* config) {
 
     // Initialize neural network
     if (!initialize_neural_network()) {
+        stop_engine();
+        pthread_mutex_unlock(&ai_mutex);
+        return false;
+    }
+
+    // Publish the first model snapshot, then start inference and cloud sync
+    pthread_mutex_lock(&model_mutex);
+    bool model_ready = replace_model(config->model_type, NULL, 0);
+    pthread_mutex_unlock(&model_mutex);
+    if (!model_ready || !start_workers(config->max_processing_threads) || !start_cloud_sync()) {
+        stop_engine();
         pthread_mutex_unlock(&ai_mutex);
         return false;
     }
 
+    current_state.is_initialized = true;
+    pthread_mutex_unlock(&ai_mutex);
+
     // Connect to API if endpoint is provided
     if (strlen(config->api_endpoint) > 0) {
         if (!qai_connect_api(config->api_endpoint, config->api_key)) {
-            pthread_mutex_unlock(&ai_mutex);
+            qai_shutdown();
             return false;
         }
     }
 
-    current_state.is_initialized = true;
-    pthread_mutex_unlock(&ai_mutex);
     return true;
 }
 
 // Process input data through the AI model
 bool qai_process_data(const void* input_data, size_t input_size, void* output_data, size_t output_size) {
-    if (!current_state.is_initialized || !input_data || !output_data) {
+    if (!input_data || !output_data) {
         return false;
     }
 
-    pthread_mutex_lock(&ai_mutex);
-    current_state.is_processing = true;
+    AIRequest request = {
+        .input_data = input_data,
+        .input_size = input_size,
+        .output_data = output_data,
+        .output_size = output_size
+    };
+    pthread_cond_init(&request.done_cond, NULL);
+
+    pthread_mutex_lock(&queue_mutex);
+    if (!accepting_requests) {
+        pthread_mutex_unlock(&queue_mutex);
+        pthread_cond_destroy(&request.done_cond);
+        return false;
+    }
 
-    bool success = false;
-    switch (current_config.processing_mode) {
-        case AI_MODE_QUANTUM_ACCELERATED:
-            success = process_quantum_data(input_data, input_size, output_data, output_size);
-            break;
-        case AI_MODE_REAL_TIME:
-        case AI_MODE_BATCH:
-            success = process_classical_data(input_data, input_size, output_data, output_size);
-            break;
-        case AI_MODE_HYBRID_PROCESSING:
-            // Implement hybrid processing logic
-            break;
-        default:
-            success = false;
+    request.mode = queue_mode;
+    request.submitted_ns = monotonic_ns();
+    if (queue_tail) {
+        queue_tail->next = &request;
+    } else {
+        queue_head = &request;
     }
+    queue_tail = &request;
+    queue_depth++;
 
-    if (success) {
-        current_state.processed_requests++;
+    // Only batch-mode requests wait for others to join them
+    if (request.mode != AI_MODE_BATCH) {
+        urgent_requests++;
+    }
+    if (queue_depth == 1 || queue_depth >= max_batch_size || request.mode != AI_MODE_BATCH) {
+        pthread_cond_signal(&queue_cond);
     }
 
-    current_state.is_processing = false;
-    pthread_mutex_unlock(&ai_mutex);
+    while (!request.done) {
+        pthread_cond_wait(&request.done_cond, &queue_mutex);
+    }
+    bool success = request.success;
+    pthread_mutex_unlock(&queue_mutex);
+
+    pthread_cond_destroy(&request.done_cond);
     return success;
 }
 
 // Update AI model parameters
 bool qai_update_model(const void* new_parameters, size_t param_size) {
-    if (!current_state.is_initialized || !new_parameters) {
+    if (!new_parameters) {
         return false;
     }
 
-    pthread_mutex_lock(&ai_mutex);
+    pthread_mutex_lock(&model_mutex);
 
-    // Implement model parameter update logic
-    // This would typically involve updating weights, biases, or other model parameters
+    AIModelSnapshot* current = atomic_load(&active_model);
+    bool success = current && replace_model(current->model_type, new_parameters, param_size);
 
-    pthread_mutex_unlock(&ai_mutex);
-    return true;
+    pthread_mutex_unlock(&model_mutex);
+    return success;
 }
 
 // Get current AI state
@@ -125,6 +249,10 @@ bool qai_get_state(AIState* state) {
 
     pthread_mutex_lock(&ai_mutex);
     memcpy(state, &current_state, sizeof(AIState));
+    pthread_mutex_lock(&queue_mutex);
+    state->processed_requests = completed_requests;
+    state->is_processing = active_batches > 0 || queue_depth > 0;
+    pthread_mutex_unlock(&queue_mutex);
     pthread_mutex_unlock(&ai_mutex);
     return true;
 }
@@ -137,6 +265,9 @@ bool qai_set_processing_mode(AIProcessingMode mode) {
 
     pthread_mutex_lock(&ai_mutex);
     current_config.processing_mode = mode;
+    pthread_mutex_lock(&queue_mutex);
+    queue_mode = mode;
+    pthread_mutex_unlock(&queue_mutex);
     pthread_mutex_unlock(&ai_mutex);
     return true;
 }
@@ -144,14 +275,14 @@ bool qai_set_processing_mode(AIProcessingMode mode) {
 // Enable/disable quantum acceleration
 bool qai_set_quantum_acceleration(bool enable) {
     pthread_mutex_lock(&ai_mutex);
-    
+
     if (enable && !current_config.enable_quantum_acceleration) {
         if (!initialize_quantum_processor()) {
             pthread_mutex_unlock(&ai_mutex);
             return false;
         }
     }
-    
+
     current_config.enable_quantum_acceleration = enable;
     pthread_mutex_unlock(&ai_mutex);
     return true;
@@ -166,23 +297,68 @@ bool qai_get_statistics(float* accuracy, float* quantum_integrity, uint64_t* pro
     pthread_mutex_lock(&ai_mutex);
     *accuracy = current_state.current_accuracy;
     *quantum_integrity = current_state.quantum_state_integrity;
-    *processed_count = current_state.processed_requests;
+    pthread_mutex_lock(&queue_mutex);
+    *processed_count = completed_requests;
+    pthread_mutex_unlock(&queue_mutex);
     pthread_mutex_unlock(&ai_mutex);
     return true;
 }
 
+// Get throughput, latency and cloud synchronization statistics
+bool qai_get_batch_statistics(AIBatchStatistics* stats) {
+    if (!stats) {
+        return false;
+    }
+
+    memset(stats, 0, sizeof(AIBatchStatistics));
+
+    pthread_mutex_lock(&queue_mutex);
+    uint64_t finished = completed_requests + failed_requests;
+    uint64_t elapsed_ns = started_ns ? monotonic_ns() - started_ns : 0;
+    stats->completed_requests = completed_requests;
+    stats->failed_requests = failed_requests;
+    stats->batches = batch_count;
+    stats->average_batch_size = batch_count ? (float)batched_requests / (float)batch_count : 0.0f;
+    stats->requests_per_second = elapsed_ns ? (double)completed_requests * 1e9 / (double)elapsed_ns : 0.0;
+    stats->average_latency_us = finished ? (double)total_latency_ns / 1000.0 / (double)finished : 0.0;
+    stats->max_latency_us = (double)max_latency_ns / 1000.0;
+    stats->queue_depth = queue_depth;
+    stats->active_batches = active_batches;
+    pthread_mutex_unlock(&queue_mutex);
+
+    pthread_mutex_lock(&model_mutex);
+    AIModelSnapshot* model = atomic_load(&active_model);
+    stats->model_version = model ? model->version : 0;
+    pthread_mutex_unlock(&model_mutex);
+
+    pthread_mutex_lock(&sync_mutex);
+    stats->cloud_syncs = cloud_syncs;
+    stats->cloud_sync_failures = cloud_sync_failures;
+    stats->cloud_sync_pending = pending_body != NULL || sync_in_flight;
+    pthread_mutex_unlock(&sync_mutex);
+    return true;
+}
+
+// Configure micro-batching
+bool qai_set_batching(uint32_t batch_size, uint32_t max_latency_us) {
+    if (batch_size == 0 || batch_size > QAI_MAX_BATCH_SIZE) {
+        return false;
+    }
+
+    pthread_mutex_lock(&queue_mutex);
+    max_batch_size = batch_size;
+    max_batch_latency_ns = (uint64_t)max_latency_us * 1000ULL;
+    pthread_cond_broadcast(&queue_cond);
+    pthread_mutex_unlock(&queue_mutex);
+    return true;
+}
+
 // Shutdown AI system
 void qai_shutdown(void) {
     pthread_mutex_lock(&ai_mutex);
 
-    if (api_connected) {
-        qai_disconnect_api();
-    }
-
-    if (curl_handle) {
-        curl_easy_cleanup(curl_handle);
-        curl_global_cleanup();
-    }
+    api_connected = false;
+    stop_engine();
 
     current_state.is_initialized = false;
     pthread_mutex_unlock(&ai_mutex);
@@ -225,7 +401,13 @@ bool qai_switch_model(AIModelType model_type) {
     pthread_mutex_lock(&ai_mutex);
     current_config.model_type = model_type;
     pthread_mutex_unlock(&ai_mutex);
-    return true;
+
+    // A running system swaps snapshots, keeping the current parameters
+    pthread_mutex_lock(&model_mutex);
+    AIModelSnapshot* current = atomic_load(&active_model);
+    bool success = !current || replace_model(model_type, current->parameters, current->param_size);
+    pthread_mutex_unlock(&model_mutex);
+    return success;
 }
 
 // Quantum-specific functions
@@ -270,8 +452,10 @@ bool qai_connect_api(const char* endpoint, const char* api_key) {
 
     pthread_mutex_lock(&ai_mutex);
 
-    if (api_connected) {
-        qai_disconnect_api();
+    api_connected = false;
+    if (!curl_handle) {
+        pthread_mutex_unlock(&ai_mutex);
+        return false;
     }
 
     strncpy(current_config.api_endpoint, endpoint, sizeof(current_config.api_endpoint) - 1);
@@ -279,11 +463,15 @@ bool qai_connect_api(const char* endpoint, const char* api_key) {
 
     // Test API connection
     CURLcode res;
+    struct curl_slist* headers = curl_slist_append(NULL, "Content-Type: application/json");
     curl_easy_setopt(curl_handle, CURLOPT_URL, endpoint);
-    curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, "Content-Type: application/json");
-    
+    curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, headers);
+    curl_easy_setopt(curl_handle, CURLOPT_WRITEFUNCTION, write_callback);
+
     res = curl_easy_perform(curl_handle);
     api_connected = (res == CURLE_OK);
+    curl_easy_setopt(curl_handle, CURLOPT_HTTPHEADER, NULL);
+    curl_slist_free_all(headers);
 
     pthread_mutex_unlock(&ai_mutex);
     return api_connected;
@@ -297,13 +485,51 @@ bool qai_disconnect_api(void) {
 }
 
 bool qai_sync_with_cloud(void) {
+    pthread_mutex_lock(&ai_mutex);
     if (!api_connected) {
+        pthread_mutex_unlock(&ai_mutex);
         return false;
     }
 
-    pthread_mutex_lock(&ai_mutex);
-    // Implement cloud synchronization logic
+    // Capture the payload here so the sync thread never waits on ai_mutex
+    char endpoint[sizeof(sync_endpoint)];
+    char api_key[sizeof(sync_api_key)];
+    snprintf(endpoint, sizeof(endpoint), "%s", current_config.api_endpoint);
+    snprintf(api_key, sizeof(api_key), "%s", current_config.api_key);
+    json_object* payload = json_object_new_object();
+    json_object_object_add(payload, "model_type", json_object_new_int64(current_config.model_type));
+    json_object_object_add(payload, "accuracy", json_object_new_double(current_state.current_accuracy));
+    json_object_object_add(payload, "quantum_state_integrity",
+                           json_object_new_double(current_state.quantum_state_integrity));
     pthread_mutex_unlock(&ai_mutex);
+
+    AIBatchStatistics stats;
+    qai_get_batch_statistics(&stats);
+    json_object_object_add(payload, "model_version", json_object_new_int64((int64_t)stats.model_version));
+    json_object_object_add(payload, "processed_requests", json_object_new_int64((int64_t)stats.completed_requests));
+    json_object_object_add(payload, "failed_requests", json_object_new_int64((int64_t)stats.failed_requests));
+    json_object_object_add(payload, "requests_per_second", json_object_new_double(stats.requests_per_second));
+    json_object_object_add(payload, "average_latency_us", json_object_new_double(stats.average_latency_us));
+    const char* json = json_object_to_json_string(payload);
+    char* body = json ? strdup(json) : NULL;
+    json_object_put(payload);
+    if (!body) {
+        return false;
+    }
+
+    // A newer payload replaces one the sync thread has not picked up yet
+    pthread_mutex_lock(&sync_mutex);
+    if (!multi_handle) {
+        pthread_mutex_unlock(&sync_mutex);
+        free(body);
+        return false;
+    }
+    free(pending_body);
+    pending_body = body;
+    memcpy(sync_endpoint, endpoint, sizeof(sync_endpoint));
+    memcpy(sync_api_key, api_key, sizeof(sync_api_key));
+    curl_multi_wakeup(multi_handle);
+    pthread_mutex_unlock(&sync_mutex);
     return true;
 }
 
@@ -323,7 +549,7 @@ static bool validate_config(const AIConfig* config) {
         return false;
     }
 
-    if (config->model_type >= AI_MODEL_MAX || 
+    if (config->model_type >= AI_MODEL_MAX ||
         config->processing_mode >= AI_MODE_MAX) {
         return false;
     }
@@ -337,12 +563,391 @@ static size_t write_callback(void* contents, size_t size, size_t nmemb, void* us
     return realsize;
 }
 
-static bool process_quantum_data(const void* input_data, size_t input_size, void* output_data, size_t output_size) {
+static bool process_quantum_data(const AIModelSnapshot* model, const void* input_data, size_t input_size, void* output_data, size_t output_size) {
     // Implement quantum data processing
     return true;
 }
 
-static bool process_classical_data(const void* input_data, size_t input_size, void* output_data, size_t output_size) {
+static bool process_classical_data(const AIModelSnapshot* model, const void* input_data, size_t input_size, void* output_data, size_t output_size) {
     // Implement classical data processing
     return true;
-} 
\ No newline at end of file
+}
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Start the worker pool and open the queue; called with ai_mutex held
+static bool start_workers(uint32_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = QAI_DEFAULT_WORKERS;
+    }
+    if (thread_count > QAI_MAX_WORKERS) {
+        thread_count = QAI_MAX_WORKERS;
+    }
+
+    // Batch deadlines are measured on the monotonic clock
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&queue_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    pthread_mutex_lock(&queue_mutex);
+    queue_mode = current_config.processing_mode;
+    started_ns = monotonic_ns();
+    completed_requests = 0;
+    failed_requests = 0;
+    batch_count = 0;
+    batched_requests = 0;
+    total_latency_ns = 0;
+    max_latency_ns = 0;
+    workers_running = true;
+    pthread_mutex_unlock(&queue_mutex);
+
+    for (worker_count = 0; worker_count < thread_count; worker_count++) {
+        atomic_store(&reader_epochs[worker_count], 0);
+        if (pthread_create(&workers[worker_count], NULL, batch_worker,
+                           (void*)(uintptr_t)worker_count) != 0) {
+            break;
+        }
+    }
+    if (worker_count == 0) {
+        workers_running = false;
+        pthread_cond_destroy(&queue_cond);
+        return false;
+    }
+
+    pthread_mutex_lock(&queue_mutex);
+    accepting_requests = true;
+    pthread_mutex_unlock(&queue_mutex);
+    return true;
+}
+
+// Stop the worker pool, failing requests still waiting; called with ai_mutex held
+static void stop_workers(void) {
+    if (worker_count == 0) {
+        return;
+    }
+
+    pthread_mutex_lock(&queue_mutex);
+    accepting_requests = false;
+    workers_running = false;
+    pthread_cond_broadcast(&queue_cond);
+    pthread_mutex_unlock(&queue_mutex);
+
+    for (uint32_t i = 0; i < worker_count; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    worker_count = 0;
+
+    pthread_mutex_lock(&queue_mutex);
+    while (queue_head) {
+        AIRequest* request = queue_head;
+        queue_head = request->next;
+        request->success = false;
+        request->done = true;
+        failed_requests++;
+        pthread_cond_signal(&request->done_cond);
+    }
+    queue_tail = NULL;
+    queue_depth = 0;
+    urgent_requests = 0;
+    pthread_mutex_unlock(&queue_mutex);
+
+    pthread_cond_destroy(&queue_cond);
+}
+
+// Run one request against a model snapshot
+static bool run_request(const AIModelSnapshot* model, const AIRequest* request) {
+    switch (request->mode) {
+        case AI_MODE_QUANTUM_ACCELERATED:
+            return process_quantum_data(model, request->input_data, request->input_size,
+                                        request->output_data, request->output_size);
+        case AI_MODE_REAL_TIME:
+        case AI_MODE_BATCH:
+            return process_classical_data(model, request->input_data, request->input_size,
+                                          request->output_data, request->output_size);
+        case AI_MODE_HYBRID_PROCESSING:
+            // Classical pass first, then quantum refinement of its output in place
+            return process_classical_data(model, request->input_data, request->input_size,
+                                          request->output_data, request->output_size) &&
+                   process_quantum_data(model, request->output_data, request->output_size,
+                                        request->output_data, request->output_size);
+        default:
+            return false;
+    }
+}
+
+// Worker: coalesce queued requests into micro-batches and run them
+static void* batch_worker(void* arg) {
+    uint32_t reader = (uint32_t)(uintptr_t)arg;
+    AIRequest* batch[QAI_MAX_BATCH_SIZE];
+
+    pthread_mutex_lock(&queue_mutex);
+    while (workers_running) {
+        if (queue_depth == 0) {
+            pthread_cond_wait(&queue_cond, &queue_mutex);
+            continue;
+        }
+
+        // Wait for a full batch until the oldest request's deadline, unless
+        // a request that should not wait is queued
+        uint64_t deadline = queue_head->submitted_ns + max_batch_latency_ns;
+        if (queue_depth < max_batch_size && urgent_requests == 0 && monotonic_ns() < deadline) {
+            struct timespec ts = {
+                .tv_sec = (time_t)(deadline / 1000000000ULL),
+                .tv_nsec = (long)(deadline % 1000000000ULL)
+            };
+            pthread_cond_timedwait(&queue_cond, &queue_mutex, &ts);
+            continue;
+        }
+
+        uint32_t count = 0;
+        while (queue_head && count < max_batch_size) {
+            AIRequest* request = queue_head;
+            queue_head = request->next;
+            if (request->mode != AI_MODE_BATCH) {
+                urgent_requests--;
+            }
+            batch[count++] = request;
+        }
+        if (!queue_head) {
+            queue_tail = NULL;
+        }
+        queue_depth -= count;
+        if (queue_depth > 0) {
+            pthread_cond_signal(&queue_cond);
+        }
+        active_batches++;
+        pthread_mutex_unlock(&queue_mutex);
+
+        // The whole batch runs against one snapshot, read without locking
+        atomic_store(&reader_epochs[reader], atomic_load(&model_epoch));
+        const AIModelSnapshot* model = atomic_load(&active_model);
+        for (uint32_t i = 0; i < count; i++) {
+            batch[i]->success = model && run_request(model, batch[i]);
+        }
+        atomic_store_explicit(&reader_epochs[reader], 0, memory_order_release);
+
+        pthread_mutex_lock(&queue_mutex);
+        uint64_t now = monotonic_ns();
+        for (uint32_t i = 0; i < count; i++) {
+            uint64_t latency = now - batch[i]->submitted_ns;
+            total_latency_ns += latency;
+            if (latency > max_latency_ns) {
+                max_latency_ns = latency;
+            }
+            if (batch[i]->success) {
+                completed_requests++;
+            } else {
+                failed_requests++;
+            }
+            batch[i]->done = true;
+            pthread_cond_signal(&batch[i]->done_cond);
+        }
+        batch_count++;
+        batched_requests += count;
+        active_batches--;
+    }
+    pthread_mutex_unlock(&queue_mutex);
+    return NULL;
+}
+
+// Publish a new model snapshot and free the old one once no worker can hold
+// it; called with model_mutex held
+static bool replace_model(AIModelType model_type, const void* parameters, size_t param_size) {
+    AIModelSnapshot* current = atomic_load(&active_model);
+    AIModelSnapshot* next = malloc(sizeof(AIModelSnapshot) + param_size);
+    if (!next) {
+        return false;
+    }
+
+    next->model_type = model_type;
+    next->version = current ? current->version + 1 : 1;
+    next->param_size = param_size;
+    if (param_size > 0) {
+        memcpy(next->parameters, parameters, param_size);
+    }
+    atomic_store(&active_model, next);
+
+    if (current) {
+        // Workers that started reading before the swap may still use it
+        uint_fast64_t epoch = atomic_fetch_add(&model_epoch, 1) + 1;
+        for (uint32_t i = 0; i < QAI_MAX_WORKERS; i++) {
+            uint_fast64_t seen;
+            while ((seen = atomic_load(&reader_epochs[i])) != 0 && seen < epoch) {
+                sched_yield();
+            }
+        }
+        free(current);
+    }
+    return true;
+}
+
+// Create the reused sync handles and start the sync thread; called with ai_mutex held
+static bool start_cloud_sync(void) {
+    pthread_mutex_lock(&sync_mutex);
+    multi_handle = curl_multi_init();
+    sync_handle = curl_easy_init();
+    cloud_syncs = 0;
+    cloud_sync_failures = 0;
+    sync_running = multi_handle && sync_handle;
+    pthread_mutex_unlock(&sync_mutex);
+
+    if (!sync_running || pthread_create(&sync_thread, NULL, cloud_sync_worker, NULL) != 0) {
+        sync_running = false;
+        stop_cloud_sync();
+        return false;
+    }
+    return true;
+}
+
+// Stop the sync thread, abandoning a pending sync; called with ai_mutex held
+static void stop_cloud_sync(void) {
+    pthread_mutex_lock(&sync_mutex);
+    bool was_running = sync_running;
+    sync_running = false;
+    if (multi_handle) {
+        curl_multi_wakeup(multi_handle);
+    }
+    pthread_mutex_unlock(&sync_mutex);
+
+    if (was_running) {
+        pthread_join(sync_thread, NULL);
+    }
+
+    pthread_mutex_lock(&sync_mutex);
+    if (sync_in_flight) {
+        curl_multi_remove_handle(multi_handle, sync_handle);
+        sync_in_flight = false;
+    }
+    if (sync_handle) {
+        curl_easy_cleanup(sync_handle);
+        sync_handle = NULL;
+    }
+    if (multi_handle) {
+        curl_multi_cleanup(multi_handle);
+        multi_handle = NULL;
+    }
+    curl_slist_free_all(sync_headers);
+    sync_headers = NULL;
+    free(pending_body);
+    pending_body = NULL;
+    free(active_body);
+    active_body = NULL;
+    pthread_mutex_unlock(&sync_mutex);
+}
+
+// Start a transfer for the pending payload on the reused easy handle
+static void begin_cloud_sync(void) {
+    pthread_mutex_lock(&sync_mutex);
+    free(active_body);
+    active_body = pending_body;
+    pending_body = NULL;
+    char endpoint[sizeof(sync_endpoint)];
+    char api_key[sizeof(sync_api_key)];
+    memcpy(endpoint, sync_endpoint, sizeof(endpoint));
+    memcpy(api_key, sync_api_key, sizeof(api_key));
+    pthread_mutex_unlock(&sync_mutex);
+
+    curl_slist_free_all(sync_headers);
+    sync_headers = curl_slist_append(NULL, "Content-Type: application/json");
+    if (sync_headers && api_key[0] != '\0') {
+        char authorization[sizeof(api_key) + 32];
+        snprintf(authorization, sizeof(authorization), "Authorization: Bearer %s", api_key);
+        sync_headers = curl_slist_append(sync_headers, authorization);
+    }
+
+    // Resetting keeps the handle's connections alive for the next sync
+    curl_easy_reset(sync_handle);
+    curl_easy_setopt(sync_handle, CURLOPT_URL, endpoint);
+    curl_easy_setopt(sync_handle, CURLOPT_HTTPHEADER, sync_headers);
+    curl_easy_setopt(sync_handle, CURLOPT_POSTFIELDS, active_body);
+    curl_easy_setopt(sync_handle, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(sync_handle, CURLOPT_TIMEOUT_MS, (long)QAI_SYNC_TIMEOUT_MS);
+    curl_easy_setopt(sync_handle, CURLOPT_NOSIGNAL, 1L);
+
+    bool started = curl_multi_add_handle(multi_handle, sync_handle) == CURLM_OK;
+    pthread_mutex_lock(&sync_mutex);
+    sync_in_flight = started;
+    if (!started) {
+        cloud_sync_failures++;
+    }
+    pthread_mutex_unlock(&sync_mutex);
+}
+
+// Record finished transfers
+static void finish_cloud_syncs(void) {
+    CURLMsg* message;
+    int remaining = 0;
+    while ((message = curl_multi_info_read(multi_handle, &remaining)) != NULL) {
+        if (message->msg != CURLMSG_DONE) {
+            continue;
+        }
+
+        long status = 0;
+        curl_easy_getinfo(message->easy_handle, CURLINFO_RESPONSE_CODE, &status);
+        bool success = message->data.result == CURLE_OK && status < 400;
+        curl_multi_remove_handle(multi_handle, message->easy_handle);
+
+        pthread_mutex_lock(&sync_mutex);
+        sync_in_flight = false;
+        if (success) {
+            cloud_syncs++;
+        } else {
+            cloud_sync_failures++;
+        }
+        pthread_mutex_unlock(&sync_mutex);
+    }
+}
+
+// Sync thread: start queued syncs and drive transfers until stopped
+static void* cloud_sync_worker(void* arg) {
+    (void)arg;
+
+    for (;;) {
+        pthread_mutex_lock(&sync_mutex);
+        bool running = sync_running;
+        bool start = pending_body != NULL && !sync_in_flight;
+        pthread_mutex_unlock(&sync_mutex);
+        if (!running) {
+            break;
+        }
+
+        if (start) {
+            begin_cloud_sync();
+        }
+
+        int transfers = 0;
+        curl_multi_perform(multi_handle, &transfers);
+        finish_cloud_syncs();
+
+        // A payload queued during the last transfer starts right away
+        pthread_mutex_lock(&sync_mutex);
+        bool waiting = pending_body != NULL && !sync_in_flight;
+        pthread_mutex_unlock(&sync_mutex);
+        if (!waiting) {
+            curl_multi_poll(multi_handle, NULL, 0, QAI_SYNC_POLL_MS, NULL);
+        }
+    }
+    return NULL;
+}
+
+// Release everything qai_init set up; called with ai_mutex held
+static void stop_engine(void) {
+    stop_cloud_sync();
+    stop_workers();
+
+    pthread_mutex_lock(&model_mutex);
+    free(atomic_exchange(&active_model, NULL));
+    pthread_mutex_unlock(&model_mutex);
+
+    if (curl_handle) {
+        curl_easy_cleanup(curl_handle);
+        curl_handle = NULL;
+        curl_global_cleanup();
+    }
+}
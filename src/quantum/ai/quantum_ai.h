@@ -2,8 +2,16 @@
 #define QUANTUM_AI_H
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+// Request batching limits
+#define QAI_MAX_BATCH_SIZE 256
+#define QAI_MAX_WORKERS 32
+#define QAI_DEFAULT_WORKERS 4
+#define QAI_DEFAULT_BATCH_SIZE 32
+#define QAI_DEFAULT_BATCH_LATENCY_US 2000
+
 // AI Model Types
 typedef enum {
     AI_MODEL_QUANTUM = 0,
@@ -48,15 +56,35 @@ typedef struct {
     char last_error[256];
 } AIState;
 
+// AI Throughput and Latency Statistics
+typedef struct {
+    uint64_t completed_requests;     // Requests processed successfully
+    uint64_t failed_requests;        // Requests that failed or were dropped at shutdown
+    uint64_t batches;                // Micro-batches run
+    float average_batch_size;        // Requests per micro-batch
+    double requests_per_second;      // Successful requests per second since initialization
+    double average_latency_us;       // Mean time from submission to completion
+    double max_latency_us;           // Longest time from submission to completion
+    uint32_t queue_depth;            // Requests waiting for a worker
+    uint32_t active_batches;         // Micro-batches being processed
+    uint64_t model_version;          // Version of the active model snapshot
+    uint64_t cloud_syncs;            // Completed cloud synchronizations
+    uint64_t cloud_sync_failures;    // Failed cloud synchronizations
+    bool cloud_sync_pending;         // Whether a synchronization is queued or in flight
+} AIBatchStatistics;
+
 // Function Prototypes
 
 // Initialize the AI system
 bool qai_init(const AIConfig* config);
 
 // Process input data through the AI model
+// Requests from concurrent callers are coalesced into micro-batches and run on
+// the worker pool; the call returns once its request has been processed
 bool qai_process_data(const void* input_data, size_t input_size, void* output_data, size_t output_size);
 
 // Update AI model parameters
+// Publishes a new model snapshot; batches already running finish on the old one
 bool qai_update_model(const void* new_parameters, size_t param_size);
 
 // Get current AI state
@@ -71,6 +99,13 @@ bool qai_set_quantum_acceleration(bool enable);
 // Get AI model statistics
 bool qai_get_statistics(float* accuracy, float* quantum_integrity, uint64_t* processed_count);
 
+// Get throughput, latency and cloud synchronization statistics
+bool qai_get_batch_statistics(AIBatchStatistics* stats);
+
+// Configure micro-batching: batches hold up to max_batch_size requests, and a
+// batch-mode request waits at most max_latency_us for others to join it
+bool qai_set_batching(uint32_t max_batch_size, uint32_t max_latency_us);
+
 // Shutdown AI system
 void qai_shutdown(void);
 
@@ -90,6 +125,7 @@ bool qai_apply_quantum_correction(float correction_factor);
 // API Integration
 bool qai_connect_api(const char* endpoint, const char* api_key);
 bool qai_disconnect_api(void);
+// Queue an asynchronous synchronization; repeated calls while one is pending coalesce
 bool qai_sync_with_cloud(void);
 
 #endif // QUANTUM_AI_H 
\ No newline at end of file
@@ -6,27 +6,45 @@
  * entangled states between processes, devices, memory regions, and files in CTRLxT OS.
  */
 
+/* pthread_rwlock_t under -std=c11 */
+#define _XOPEN_SOURCE 700
+
 #include "entanglement_manager.h"
+#include "entanglement_registry.h"
+#include "../../kernel/trace/trace.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <pthread.h>
 
 /**
  * @brief Structure for storing entanglement information internally
+ *
+ * Records are payloads of QEREG_KIND_SPACE entries in the shared
+ * entanglement registry, which finds them by ID in constant time.
  */
 typedef struct {
     EntanglementId id_info;        /**< Public entanglement information */
     void* source_state;             /**< Pointer to source state */
     void* target_state;             /**< Pointer to target state */
     uint32_t state_size;            /**< Size of the state in bytes */
-    bool is_valid;                  /**< Whether this slot is valid */
+    pthread_mutex_t sync_lock;      /**< Serializes synchronizations of this entanglement */
 } EntanglementRecord;
 
+_Static_assert(sizeof(EntanglementRecord) <= QEREG_PAYLOAD_SIZE, "record must fit a registry payload");
+
+/*
+ * Locking
+ *
+ * Creation needs no lock of its own; a record is filled in before the
+ * registry publishes it. Synchronization and info reads hold the read
+ * side of qem_lock, so different entanglements sync in parallel, and
+ * destruction holds the write side while it unpublishes a record, so its
+ * states are never freed under a reader.
+ */
+static pthread_rwlock_t qem_lock = PTHREAD_RWLOCK_INITIALIZER;
+
 /* Static variables */
-static EntanglementRecord* entanglement_registry = NULL;
-static uint32_t max_entanglements = 0;
-static uint32_t current_entanglements = 0;
-static uint64_t next_entanglement_id = 1;
 static bool is_initialized = false;
 
 /**
@@ -44,57 +62,36 @@ bool qem_init(uint32_t max_entanglements_count) {
         return false; // Invalid parameter
     }
     
-    entanglement_registry = (EntanglementRecord*)calloc(max_entanglements_count, sizeof(EntanglementRecord));
-    if (entanglement_registry == NULL) {
-        return false; // Memory allocation failed
-    }
-    
-    max_entanglements = max_entanglements_count;
-    current_entanglements = 0;
-    next_entanglement_id = 1;
+    qereg_set_limit(QEREG_KIND_SPACE, max_entanglements_count);
     is_initialized = true;
     
     return true;
 }
 
 /**
- * @brief Get an available slot in the entanglement registry
+ * @brief Find an entanglement in the registry by ID
  * 
- * @return Index of an available slot, or -1 if no slots are available
+ * @param entanglement_id The ID to search for
+ * @return Record, or NULL if not found
  */
-static int32_t get_available_slot() {
+static EntanglementRecord* find_entanglement(uint64_t entanglement_id) {
     if (!is_initialized) {
-        return -1;
+        return NULL;
     }
     
-    for (uint32_t i = 0; i < max_entanglements; i++) {
-        if (!entanglement_registry[i].is_valid) {
-            return i;
-        }
-    }
-    
-    return -1; // No slots available
+    return (EntanglementRecord*)qereg_find(QEREG_KIND_SPACE, entanglement_id);
 }
 
 /**
- * @brief Find an entanglement in the registry by ID
+ * @brief Free a record's states
  * 
- * @param entanglement_id The ID to search for
- * @return Index in the registry, or -1 if not found
+ * @param payload Record
  */
-static int32_t find_entanglement(uint64_t entanglement_id) {
-    if (!is_initialized) {
-        return -1;
-    }
-    
-    for (uint32_t i = 0; i < max_entanglements; i++) {
-        if (entanglement_registry[i].is_valid && 
-            entanglement_registry[i].id_info.id == entanglement_id) {
-            return i;
-        }
-    }
-    
-    return -1; // Not found
+static void release_record(void* payload) {
+    EntanglementRecord* record = (EntanglementRecord*)payload;
+    free(record->source_state);
+    free(record->target_state);
+    pthread_mutex_destroy(&record->sync_lock);
 }
 
 /**
@@ -120,9 +117,10 @@ EntanglementId qem_create_entanglement(EntanglementType type, uint64_t source_id
         return invalid_result;
     }
     
-    // Check for available slots
-    int32_t slot = get_available_slot();
-    if (slot < 0) {
+    // Reserve a registry entry, unless the limit is reached
+    EntanglementRecord* record = NULL;
+    uint64_t entanglement_id = qereg_reserve(QEREG_KIND_SPACE, (void**)&record);
+    if (entanglement_id == 0) {
         return invalid_result;
     }
     
@@ -137,6 +135,7 @@ EntanglementId qem_create_entanglement(EntanglementType type, uint64_t source_id
         // Clean up on failure
         if (source_state) free(source_state);
         if (target_state) free(target_state);
+        qereg_remove(QEREG_KIND_SPACE, entanglement_id);
         return invalid_result;
     }
     
@@ -146,23 +145,22 @@ EntanglementId qem_create_entanglement(EntanglementType type, uint64_t source_id
     memset(target_state, 0, state_size);
     
     // Create actual entanglement record
-    EntanglementRecord new_record;
-    new_record.id_info.id = next_entanglement_id++;
-    new_record.id_info.type = type;
-    new_record.id_info.source_id = source_id;
-    new_record.id_info.target_id = target_id;
-    new_record.id_info.qubit_count = qubit_count;
-    new_record.id_info.is_active = true;
-    new_record.source_state = source_state;
-    new_record.target_state = target_state;
-    new_record.state_size = state_size;
-    new_record.is_valid = true;
+    record->id_info.id = entanglement_id;
+    record->id_info.type = type;
+    record->id_info.source_id = source_id;
+    record->id_info.target_id = target_id;
+    record->id_info.qubit_count = qubit_count;
+    record->id_info.is_active = true;
+    record->source_state = source_state;
+    record->target_state = target_state;
+    record->state_size = state_size;
+    pthread_mutex_init(&record->sync_lock, NULL);
     
     // Store the record
-    entanglement_registry[slot] = new_record;
-    current_entanglements++;
+    EntanglementId result = record->id_info;
+    qereg_publish(entanglement_id);
     
-    return new_record.id_info;
+    return result;
 }
 
 /**
@@ -176,22 +174,40 @@ bool qem_destroy_entanglement(uint64_t entanglement_id) {
         return false;
     }
     
-    int32_t slot = find_entanglement(entanglement_id);
-    if (slot < 0) {
-        return false;
+    // With the write side held, no synchronization is using the record
+    pthread_rwlock_wrlock(&qem_lock);
+    EntanglementRecord* record = find_entanglement(entanglement_id);
+    if (record != NULL) {
+        // Free allocated memory and clear the record
+        release_record(record);
+        qereg_remove(QEREG_KIND_SPACE, entanglement_id);
     }
+    pthread_rwlock_unlock(&qem_lock);
     
-    // Free allocated memory
-    free(entanglement_registry[slot].source_state);
-    free(entanglement_registry[slot].target_state);
-    
-    // Clear record
-    entanglement_registry[slot].is_valid = false;
-    entanglement_registry[slot].source_state = NULL;
-    entanglement_registry[slot].target_state = NULL;
-    entanglement_registry[slot].id_info.is_active = false;
+    return record != NULL;
+}
+
+/**
+ * @brief Copy a record's source state to its target
+ * 
+ * Caller must hold qem_lock.
+ * 
+ * @param record Record (may be NULL)
+ * @return true if the record is active and was synchronized
+ */
+static bool sync_record(EntanglementRecord* record) {
+    // Ensure the entanglement is active
+    if (record == NULL || !record->id_info.is_active) {
+        return false;
+    }
     
-    current_entanglements--;
+    // For a real quantum system, this would involve complex quantum operations
+    // Here we simulate the synchronization with a simple memory copy
+    pthread_mutex_lock(&record->sync_lock);
+    memcpy(record->target_state, 
+           record->source_state, 
+           record->state_size);
+    pthread_mutex_unlock(&record->sync_lock);
     return true;
 }
 
@@ -202,27 +218,32 @@ bool qem_destroy_entanglement(uint64_t entanglement_id) {
  * @return true if synchronization succeeded, false otherwise
  */
 bool qem_sync_entanglement(uint64_t entanglement_id) {
-    if (!is_initialized) {
-        return false;
-    }
-    
-    int32_t slot = find_entanglement(entanglement_id);
-    if (slot < 0) {
-        return false;
+    return qem_sync_entanglements(&entanglement_id, 1) == 1;
+}
+
+/**
+ * @brief Synchronize state across a batch of entanglements
+ * 
+ * @param entanglement_ids IDs of the entanglements to synchronize
+ * @param count Number of IDs
+ * @return Number of entanglements synchronized
+ */
+uint32_t qem_sync_entanglements(const uint64_t* entanglement_ids, uint32_t count) {
+    if (!is_initialized || entanglement_ids == NULL) {
+        return 0;
     }
     
-    // Ensure the entanglement is active
-    if (!entanglement_registry[slot].id_info.is_active) {
-        return false;
+    /* Batches may sync concurrently, so each span is keyed by its ID array */
+    TRACE_EVENT(TRACE_ENTANGLEMENT_SYNC, TRACE_PHASE_BEGIN, (uintptr_t)entanglement_ids, count);
+    uint32_t synced = 0;
+    pthread_rwlock_rdlock(&qem_lock);
+    for (uint32_t i = 0; i < count; i++) {
+        synced += sync_record(find_entanglement(entanglement_ids[i]));
     }
+    pthread_rwlock_unlock(&qem_lock);
+    TRACE_EVENT(TRACE_ENTANGLEMENT_SYNC, TRACE_PHASE_END, (uintptr_t)entanglement_ids, synced);
     
-    // For a real quantum system, this would involve complex quantum operations
-    // Here we simulate the synchronization with a simple memory copy
-    memcpy(entanglement_registry[slot].target_state, 
-           entanglement_registry[slot].source_state, 
-           entanglement_registry[slot].state_size);
-    
-    return true;
+    return synced;
 }
 
 /**
@@ -239,12 +260,12 @@ EntanglementId qem_get_entanglement_info(uint64_t entanglement_id) {
         return invalid_result;
     }
     
-    int32_t slot = find_entanglement(entanglement_id);
-    if (slot < 0) {
-        return invalid_result;
-    }
+    pthread_rwlock_rdlock(&qem_lock);
+    EntanglementRecord* record = find_entanglement(entanglement_id);
+    EntanglementId result = record ? record->id_info : invalid_result;
+    pthread_rwlock_unlock(&qem_lock);
     
-    return entanglement_registry[slot].id_info;
+    return result;
 }
 
 /**
@@ -256,20 +277,9 @@ void qem_shutdown(void) {
     }
     
     // Clean up all active entanglements
-    for (uint32_t i = 0; i < max_entanglements; i++) {
-        if (entanglement_registry[i].is_valid) {
-            free(entanglement_registry[i].source_state);
-            free(entanglement_registry[i].target_state);
-            entanglement_registry[i].is_valid = false;
-        }
-    }
-    
-    // Free the registry itself
-    free(entanglement_registry);
-    entanglement_registry = NULL;
-    
-    max_entanglements = 0;
-    current_entanglements = 0;
-    next_entanglement_id = 1;
+    pthread_rwlock_wrlock(&qem_lock);
+    qereg_clear(QEREG_KIND_SPACE, release_record);
+    qereg_set_limit(QEREG_KIND_SPACE, 0);
     is_initialized = false;
-}
\ No newline at end of file
+    pthread_rwlock_unlock(&qem_lock);
+}
@@ -5,6 +5,10 @@
  * This file defines the interface for the Quantum Entanglement Manager,
  * which is responsible for creating and managing entangled states
  * across devices and processes in CTRLxT OS.
+ *
+ * Entanglements are kept in the shared entanglement registry, so IDs are
+ * opaque and lookups take constant time. Every function except qem_init
+ * and qem_shutdown may be called from any thread.
  */
 
 #ifndef CTRLXT_ENTANGLEMENT_MANAGER_H
@@ -71,6 +75,19 @@ bool qem_destroy_entanglement(uint64_t entanglement_id);
  */
 bool qem_sync_entanglement(uint64_t entanglement_id);
 
+/**
+ * @brief Synchronize state across a batch of entanglements
+ * 
+ * Same as calling qem_sync_entanglement for each ID, with the manager's
+ * lock taken once for the whole batch. Batches may run on several
+ * threads at once.
+ * 
+ * @param entanglement_ids IDs of the entanglements to synchronize
+ * @param count Number of IDs
+ * @return Number of entanglements synchronized (unknown and inactive IDs are skipped)
+ */
+uint32_t qem_sync_entanglements(const uint64_t* entanglement_ids, uint32_t count);
+
 /**
  * @brief Get information about an entanglement
  * 
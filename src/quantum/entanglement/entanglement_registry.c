@@ -0,0 +1,237 @@
+/**
+ * @file entanglement_registry.c
+ * @brief Implementation of the shared entanglement registry
+ *
+ * Entries live in fixed chunks reached through a directory that only
+ * grows. An ID packs a serial, the entry's kind and its slot plus one,
+ * from the high bits down; the slot's published ID is stored atomically,
+ * so a lookup decodes the slot, loads its chunk and compares IDs without
+ * a lock. Everything else is guarded by one mutex held only for a few
+ * instructions.
+ */
+
+#include "entanglement_registry.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define QEREG_CHUNK_ENTRIES 256
+#define QEREG_MAX_CHUNKS (QEREG_MAX_ENTRIES / QEREG_CHUNK_ENTRIES)
+#define QEREG_SLOT_BITS 17
+#define QEREG_SLOT_MASK ((1ULL << QEREG_SLOT_BITS) - 1)
+#define QEREG_KIND_BITS 2
+#define QEREG_SERIAL_SHIFT (QEREG_SLOT_BITS + QEREG_KIND_BITS)
+
+_Static_assert(QEREG_MAX_ENTRIES < (1 << QEREG_SLOT_BITS), "slot does not fit in an ID");
+_Static_assert(QEREG_KIND_COUNT <= (1 << QEREG_KIND_BITS), "kind does not fit in an ID");
+
+/**
+ * @brief One registry slot
+ */
+typedef struct {
+    _Atomic uint64_t published_id;                 /**< ID lookups match (0 if not published) */
+    uint64_t id;                                   /**< ID while reserved or published (0 if free) */
+    uint32_t next_free;                            /**< Next slot on the free list, plus one */
+    _Alignas(max_align_t) unsigned char payload[QEREG_PAYLOAD_SIZE]; /**< Owner's structure */
+} QERegEntry;
+
+/**
+ * @brief A fixed block of slots; never moved or freed
+ */
+typedef struct {
+    QERegEntry entries[QEREG_CHUNK_ENTRIES];
+} QERegChunk;
+
+/* Directory of chunks, filled in order */
+static _Atomic(QERegChunk *) chunks[QEREG_MAX_CHUNKS];
+
+/* Everything below is guarded by registry_lock */
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t chunk_count = 0;
+static uint32_t free_head = 0;                     /* Top slot of the free list, plus one */
+static uint64_t next_serial = 1;
+static uint32_t limits[QEREG_KIND_COUNT];
+static _Atomic uint32_t counts[QEREG_KIND_COUNT];
+
+/**
+ * @brief Entry for a slot, or NULL if its chunk does not exist
+ */
+static QERegEntry *entry_at(uint64_t slot) {
+    if (slot >= (uint64_t)QEREG_MAX_CHUNKS * QEREG_CHUNK_ENTRIES) {
+        return NULL;
+    }
+    QERegChunk *chunk = atomic_load_explicit(&chunks[slot / QEREG_CHUNK_ENTRIES], memory_order_acquire);
+    return chunk ? &chunk->entries[slot % QEREG_CHUNK_ENTRIES] : NULL;
+}
+
+/**
+ * @brief Kind an ID was issued for
+ */
+static uint32_t kind_of(uint64_t id) {
+    return (uint32_t)(id >> QEREG_SLOT_BITS) & ((1u << QEREG_KIND_BITS) - 1);
+}
+
+/**
+ * @brief Entry an ID of a kind names, or NULL if the ID cannot name one
+ */
+static QERegEntry *entry_for(QERegKind kind, uint64_t id) {
+    if ((id & QEREG_SLOT_MASK) == 0 || kind_of(id) != (uint32_t)kind) {
+        return NULL;
+    }
+    return entry_at((id & QEREG_SLOT_MASK) - 1);
+}
+
+/**
+ * @brief Append a chunk and put its slots on the free list, lowest on top
+ *
+ * Caller must hold registry_lock.
+ */
+static bool add_chunk(void) {
+    if (chunk_count >= QEREG_MAX_CHUNKS) {
+        return false;
+    }
+    QERegChunk *chunk = calloc(1, sizeof(QERegChunk));
+    if (!chunk) {
+        return false;
+    }
+
+    uint32_t base = chunk_count * QEREG_CHUNK_ENTRIES;
+    for (uint32_t i = QEREG_CHUNK_ENTRIES; i-- > 0;) {
+        chunk->entries[i].next_free = free_head;
+        free_head = base + i + 1;
+    }
+    atomic_store_explicit(&chunks[chunk_count], chunk, memory_order_release);
+    chunk_count++;
+    return true;
+}
+
+/**
+ * @brief Put an entry back on the free list
+ *
+ * Caller must hold registry_lock.
+ */
+static void free_entry(QERegEntry *entry) {
+    uint64_t slot = (entry->id & QEREG_SLOT_MASK) - 1;
+    atomic_fetch_sub_explicit(&counts[kind_of(entry->id)], 1, memory_order_relaxed);
+    atomic_store_explicit(&entry->published_id, 0, memory_order_release);
+    entry->id = 0;
+    entry->next_free = free_head;
+    free_head = (uint32_t)slot + 1;
+}
+
+/**
+ * @brief Limit the number of entries of a kind
+ */
+bool qereg_set_limit(QERegKind kind, uint32_t limit) {
+    if ((unsigned)kind >= QEREG_KIND_COUNT) {
+        return false;
+    }
+    pthread_mutex_lock(&registry_lock);
+    limits[kind] = limit;
+    pthread_mutex_unlock(&registry_lock);
+    return true;
+}
+
+/**
+ * @brief Reserve an entry
+ */
+uint64_t qereg_reserve(QERegKind kind, void **payload) {
+    if ((unsigned)kind >= QEREG_KIND_COUNT || !payload) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&registry_lock);
+    uint32_t count = atomic_load_explicit(&counts[kind], memory_order_relaxed);
+    if ((limits[kind] != 0 && count >= limits[kind]) || (free_head == 0 && !add_chunk())) {
+        pthread_mutex_unlock(&registry_lock);
+        return 0;
+    }
+
+    uint32_t slot = free_head - 1;
+    QERegEntry *entry = entry_at(slot);
+    free_head = entry->next_free;
+    entry->id = (next_serial++ << QEREG_SERIAL_SHIFT) | ((uint64_t)kind << QEREG_SLOT_BITS) | (slot + 1);
+    atomic_fetch_add_explicit(&counts[kind], 1, memory_order_relaxed);
+    uint64_t id = entry->id;
+    pthread_mutex_unlock(&registry_lock);
+
+    /* The slot is ours until published, so it is cleared outside the lock */
+    memset(entry->payload, 0, QEREG_PAYLOAD_SIZE);
+    *payload = entry->payload;
+    return id;
+}
+
+/**
+ * @brief Make a reserved entry visible to lookups
+ */
+void qereg_publish(uint64_t id) {
+    QERegEntry *entry = entry_for((QERegKind)kind_of(id), id);
+    if (entry) {
+        atomic_store_explicit(&entry->published_id, id, memory_order_release);
+    }
+}
+
+/**
+ * @brief Find a published entry
+ */
+void *qereg_find(QERegKind kind, uint64_t id) {
+    QERegEntry *entry = entry_for(kind, id);
+    if (!entry || atomic_load_explicit(&entry->published_id, memory_order_acquire) != id) {
+        return NULL;
+    }
+    return entry->payload;
+}
+
+/**
+ * @brief Remove an entry, published or only reserved
+ */
+bool qereg_remove(QERegKind kind, uint64_t id) {
+    QERegEntry *entry = entry_for(kind, id);
+    if (!entry) {
+        return false;
+    }
+
+    pthread_mutex_lock(&registry_lock);
+    bool removed = entry->id == id;
+    if (removed) {
+        free_entry(entry);
+    }
+    pthread_mutex_unlock(&registry_lock);
+    return removed;
+}
+
+/**
+ * @brief Remove every entry of a kind
+ */
+uint32_t qereg_clear(QERegKind kind, void (*release)(void *payload)) {
+    if ((unsigned)kind >= QEREG_KIND_COUNT) {
+        return 0;
+    }
+
+    uint32_t removed = 0;
+    pthread_mutex_lock(&registry_lock);
+    for (uint32_t slot = 0; slot < chunk_count * QEREG_CHUNK_ENTRIES; slot++) {
+        QERegEntry *entry = entry_at(slot);
+        if (entry->id != 0 && kind_of(entry->id) == (uint32_t)kind) {
+            if (release) {
+                release(entry->payload);
+            }
+            free_entry(entry);
+            removed++;
+        }
+    }
+    pthread_mutex_unlock(&registry_lock);
+    return removed;
+}
+
+/**
+ * @brief Number of entries of a kind, published or reserved
+ */
+uint32_t qereg_count(QERegKind kind) {
+    if ((unsigned)kind >= QEREG_KIND_COUNT) {
+        return 0;
+    }
+    return atomic_load_explicit(&counts[kind], memory_order_relaxed);
+}
@@ -0,0 +1,120 @@
+/**
+ * @file entanglement_registry.h
+ * @brief Registry of entanglements shared by every subsystem
+ *
+ * The entanglement manager, the memory manager and the process manager
+ * keep their entanglements in this one registry. Each entry has a kind,
+ * naming the subsystem that owns it, and a payload of up to
+ * QEREG_PAYLOAD_SIZE bytes that the owner lays out as its own structure.
+ *
+ * An ID names its slot, so a lookup takes constant time and no lock; a
+ * serial in the upper bits keeps a reused slot from matching an old ID.
+ * Slots come from a free list, and the registry grows a chunk at a time
+ * without moving entries, so a payload pointer stays valid until its
+ * entry is removed.
+ *
+ * Creating an entry takes two steps: qereg_reserve hands out an ID and
+ * zeroed payload storage that lookups do not see yet, and qereg_publish
+ * makes the entry visible once the payload is filled in.
+ *
+ * Every call is thread-safe. The registry does not guard payload
+ * contents; each owner serializes access to its own entries.
+ */
+
+#ifndef CTRLXT_ENTANGLEMENT_REGISTRY_H
+#define CTRLXT_ENTANGLEMENT_REGISTRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Largest payload an entry holds, in bytes
+ */
+#define QEREG_PAYLOAD_SIZE 128
+
+/**
+ * @brief Largest number of entries across all kinds
+ */
+#define QEREG_MAX_ENTRIES 65536
+
+/**
+ * @brief Subsystem owning an entry
+ */
+typedef enum {
+    QEREG_KIND_SPACE,      /**< Entanglement manager entries, used by spaces, portals and devices */
+    QEREG_KIND_MEMORY,     /**< Memory manager region entanglements */
+    QEREG_KIND_PROCESS,    /**< Process manager entanglements */
+    QEREG_KIND_COUNT       /**< Number of kinds */
+} QERegKind;
+
+/**
+ * @brief Limit the number of entries of a kind
+ *
+ * Entries already present are kept when the limit drops below their count.
+ *
+ * @param kind Entry kind
+ * @param limit Maximum number of entries (0 for no limit beyond QEREG_MAX_ENTRIES)
+ * @return true if set, false if the kind is invalid
+ */
+bool qereg_set_limit(QERegKind kind, uint32_t limit);
+
+/**
+ * @brief Reserve an entry
+ *
+ * The entry is not found by lookups until it is published.
+ *
+ * @param kind Entry kind
+ * @param payload Pointer to store the entry's zeroed payload
+ * @return Entry ID, or 0 if the kind's limit is reached or allocation failed
+ */
+uint64_t qereg_reserve(QERegKind kind, void **payload);
+
+/**
+ * @brief Make a reserved entry visible to lookups
+ *
+ * Writes to the payload before this call are seen by any thread that
+ * finds the entry.
+ *
+ * @param id Entry ID from qereg_reserve
+ */
+void qereg_publish(uint64_t id);
+
+/**
+ * @brief Find a published entry
+ *
+ * @param kind Entry kind
+ * @param id Entry ID
+ * @return Payload, or NULL if no published entry of this kind has the ID
+ */
+void *qereg_find(QERegKind kind, uint64_t id);
+
+/**
+ * @brief Remove an entry, published or only reserved
+ *
+ * The payload may be handed out again as soon as this returns.
+ *
+ * @param kind Entry kind
+ * @param id Entry ID
+ * @return true if removed, false if no entry of this kind has the ID
+ */
+bool qereg_remove(QERegKind kind, uint64_t id);
+
+/**
+ * @brief Remove every entry of a kind
+ *
+ * @param kind Entry kind
+ * @param release Called with each entry's payload before it is removed
+ *                (may be NULL). It must not call back into the registry.
+ * @return Number of entries removed
+ */
+uint32_t qereg_clear(QERegKind kind, void (*release)(void *payload));
+
+/**
+ * @brief Number of entries of a kind, published or reserved
+ *
+ * @param kind Entry kind
+ * @return Entry count
+ */
+uint32_t qereg_count(QERegKind kind);
+
+#endif /* CTRLXT_ENTANGLEMENT_REGISTRY_H */
@@ -0,0 +1,884 @@
+/**
+ * @file quantum_bus_transport.c
+ * @brief Implementation of the Quantum Message Bus federation transport
+ *
+ * Each peer has a sender thread that owns its TCP connection. Messages are
+ * encoded into the peer's pending frame by the caller and handed over by
+ * swapping the pending and in-flight buffers, so the message pump only ever
+ * copies bytes under a short lock. The sender lingers briefly after the
+ * first message of a frame to coalesce small messages, then writes the
+ * whole frame at once. A listener thread accepts peer connections and runs
+ * one receiver thread per connection, which decodes frames and queues the
+ * messages on the local bus.
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include "quantum_bus_transport.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+/* Send a frame without lingering once this much is queued */
+#define COALESCE_BYTES (16 * 1024)
+
+/* How long the sender waits for more messages before writing a small frame */
+#define LINGER_NS 500000L
+
+#define MAX_CONNECTIONS 32
+
+/* Longest a sender waits for a peer to accept a connection */
+#define CONNECT_TIMEOUT_MS 5000
+
+/* Interval at which a pending connect checks for a stop request */
+#define CONNECT_POLL_MS 50
+
+/* Wire record flags */
+#define WIRE_FLAG_REQUIRES_RESPONSE 0x01
+
+/**
+ * @brief Frame buffer: frame header space followed by encoded records
+ */
+typedef struct {
+    uint8_t* bytes;
+    size_t length;                  /* Bytes used, including the frame header */
+    uint32_t count;                 /* Records in the frame */
+} FrameBuffer;
+
+/**
+ * @brief Remote peer and its sender thread
+ */
+typedef struct {
+    bool in_use;
+    bool stopping;                  /* Removed, sender not yet joined; slot not reusable */
+    uint64_t remote_bus_id;
+    char host[64];
+    uint16_t port;
+
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    FrameBuffer pending;            /* Filled by qbus_transport_send */
+    FrameBuffer in_flight;          /* Written by the sender thread */
+    bool sending;
+    bool stop;
+    int fd;
+    pthread_t thread;
+} TransportPeer;
+
+/**
+ * @brief Accepted connection and its receiver thread
+ */
+typedef struct {
+    bool in_use;
+    int fd;
+    atomic_bool finished;
+    pthread_t thread;
+} TransportConnection;
+
+/* Transport state */
+static bool transport_initialized = false;
+static uint64_t local_bus_id = 0;
+static int listen_fd = -1;
+static uint16_t listen_port = 0;
+static atomic_bool listener_stop;
+static pthread_t listener_thread;
+
+static pthread_mutex_t peers_lock = PTHREAD_MUTEX_INITIALIZER;
+static TransportPeer peers[QBUS_TRANSPORT_MAX_PEERS];
+
+static pthread_mutex_t connections_lock = PTHREAD_MUTEX_INITIALIZER;
+static TransportConnection connections[MAX_CONNECTIONS];
+
+static struct {
+    _Atomic uint64_t messages_sent;
+    _Atomic uint64_t messages_received;
+    _Atomic uint64_t frames_sent;
+    _Atomic uint64_t frames_received;
+    _Atomic uint64_t bytes_sent;
+    _Atomic uint64_t bytes_received;
+    _Atomic uint64_t messages_dropped;
+    _Atomic uint64_t connect_failures;
+} transport_stats;
+
+/* Little-endian field access */
+static void put_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void put_u64(uint8_t* p, uint64_t v) {
+    put_u32(p, (uint32_t)v);
+    put_u32(p + 4, (uint32_t)(v >> 32));
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t get_u64(const uint8_t* p) {
+    return (uint64_t)get_u32(p) | ((uint64_t)get_u32(p + 4) << 32);
+}
+
+/**
+ * @brief Encode a message as a wire record
+ */
+size_t qbus_wire_encode_message(const QMessage* message, uint8_t* out, size_t capacity) {
+    if (!message || !out) {
+        return 0;
+    }
+
+    const QMessageHeader* header = &message->header;
+    uint32_t data_size = message->data ? header->data_size : 0;
+    size_t total = QBUS_WIRE_RECORD_HEADER + (size_t)data_size;
+    if (total > capacity) {
+        return 0;
+    }
+
+    put_u64(out + 0, header->message_id);
+    put_u64(out + 8, header->timestamp);
+    put_u64(out + 16, header->response_to);
+    put_u32(out + 24, (uint32_t)header->type);
+    put_u32(out + 28, (uint32_t)header->source);
+    put_u32(out + 32, (uint32_t)header->destination);
+    put_u32(out + 36, data_size);
+    out[40] = (uint8_t)header->priority;
+    out[41] = (uint8_t)header->resonance_level;
+    out[42] = header->requires_response ? WIRE_FLAG_REQUIRES_RESPONSE : 0;
+    out[43] = 0;
+
+    if (data_size > 0) {
+        memcpy(out + QBUS_WIRE_RECORD_HEADER, message->data, data_size);
+    }
+
+    return total;
+}
+
+/**
+ * @brief Decode a wire record
+ */
+size_t qbus_wire_decode_message(const uint8_t* in, size_t length, QMessageHeader* header, const uint8_t** data) {
+    if (!in || !header || length < QBUS_WIRE_RECORD_HEADER) {
+        return 0;
+    }
+
+    uint32_t data_size = get_u32(in + 36);
+    if (length - QBUS_WIRE_RECORD_HEADER < data_size) {
+        return 0;
+    }
+
+    header->message_id = get_u64(in + 0);
+    header->timestamp = get_u64(in + 8);
+    header->response_to = get_u64(in + 16);
+    header->type = (QMessageType)get_u32(in + 24);
+    header->source = (QComponentId)get_u32(in + 28);
+    header->destination = (QComponentId)get_u32(in + 32);
+    header->data_size = data_size;
+    header->priority = (QMessagePriority)in[40];
+    header->resonance_level = (NodeLevel)in[41];
+    header->requires_response = (in[42] & WIRE_FLAG_REQUIRES_RESPONSE) != 0;
+
+    if (data) {
+        *data = data_size > 0 ? in + QBUS_WIRE_RECORD_HEADER : NULL;
+    }
+
+    return QBUS_WIRE_RECORD_HEADER + (size_t)data_size;
+}
+
+/**
+ * @brief Write a whole buffer to a socket
+ */
+static bool send_all(int fd, const uint8_t* bytes, size_t length) {
+    while (length > 0) {
+        ssize_t written = send(fd, bytes, length, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        length -= (size_t)written;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Read exactly length bytes from a socket
+ */
+static bool recv_all(int fd, uint8_t* bytes, size_t length) {
+    while (length > 0) {
+        ssize_t received = recv(fd, bytes, length, 0);
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            return false;
+        }
+        bytes += received;
+        length -= (size_t)received;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Check whether a peer has been asked to stop
+ */
+static bool peer_stopping(TransportPeer* peer) {
+    pthread_mutex_lock(&peer->lock);
+    bool stop = peer->stop;
+    pthread_mutex_unlock(&peer->lock);
+
+    return stop;
+}
+
+/**
+ * @brief Connect a socket without blocking past a stop request
+ *
+ * The connect is started non-blocking and polled in short slices, so
+ * stop_peer() never waits on an unreachable host.
+ */
+static bool connect_interruptible(TransportPeer* peer, int fd, const struct sockaddr* address,
+                                  socklen_t address_length) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) != 0) {
+        return false;
+    }
+
+    bool connected = connect(fd, address, address_length) == 0;
+    if (!connected && errno == EINPROGRESS) {
+        struct pollfd pending = { fd, POLLOUT, 0 };
+        for (int waited = 0; waited < CONNECT_TIMEOUT_MS && !peer_stopping(peer); waited += CONNECT_POLL_MS) {
+            int ready = poll(&pending, 1, CONNECT_POLL_MS);
+            if (ready < 0 && errno != EINTR) {
+                break;
+            }
+            if (ready > 0) {
+                int error = 0;
+                socklen_t error_length = sizeof(error);
+                connected = getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &error_length) == 0 && error == 0;
+                break;
+            }
+        }
+    }
+
+    /* Frames are written with blocking sends */
+    return connected && fcntl(fd, F_SETFL, flags) == 0;
+}
+
+/**
+ * @brief Open a TCP connection to a peer
+ */
+static int connect_peer(TransportPeer* peer) {
+    char port_string[8];
+    snprintf(port_string, sizeof(port_string), "%u", (unsigned)peer->port);
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    struct addrinfo* addresses = NULL;
+    if (getaddrinfo(peer->host, port_string, &hints, &addresses) != 0) {
+        return -1;
+    }
+
+    int fd = -1;
+    for (struct addrinfo* address = addresses; address && !peer_stopping(peer); address = address->ai_next) {
+        fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (connect_interruptible(peer, fd, address->ai_addr, address->ai_addrlen)) {
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(addresses);
+
+    if (fd >= 0) {
+        /* Frames are already coalesced; don't let Nagle delay them further */
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    return fd;
+}
+
+/**
+ * @brief Reset a frame buffer to an empty frame
+ */
+static void frame_reset(FrameBuffer* frame) {
+    frame->length = QBUS_WIRE_FRAME_HEADER;
+    frame->count = 0;
+}
+
+/**
+ * @brief Add nanoseconds to the current real time
+ */
+static struct timespec deadline_after(long nanoseconds) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_nsec += nanoseconds;
+    while (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_nsec -= 1000000000L;
+        deadline.tv_sec++;
+    }
+
+    return deadline;
+}
+
+/**
+ * @brief Sender thread: coalesces queued messages into frames and writes them
+ */
+static void* peer_sender_main(void* arg) {
+    TransportPeer* peer = (TransportPeer*)arg;
+
+    pthread_mutex_lock(&peer->lock);
+    for (;;) {
+        while (peer->pending.count == 0 && !peer->stop) {
+            pthread_cond_wait(&peer->wake, &peer->lock);
+        }
+        if (peer->stop) {
+            break;
+        }
+
+        /* Linger for more messages unless the frame is already large */
+        struct timespec deadline = deadline_after(LINGER_NS);
+        while (peer->pending.length < COALESCE_BYTES && !peer->stop) {
+            if (pthread_cond_timedwait(&peer->wake, &peer->lock, &deadline) == ETIMEDOUT) {
+                break;
+            }
+        }
+        if (peer->stop) {
+            break;
+        }
+
+        /* Swap buffers so producers keep filling while this frame is written */
+        FrameBuffer frame = peer->pending;
+        peer->pending = peer->in_flight;
+        peer->in_flight = frame;
+        frame_reset(&peer->pending);
+        peer->sending = true;
+        int fd = peer->fd;
+        pthread_mutex_unlock(&peer->lock);
+
+        if (fd < 0) {
+            fd = connect_peer(peer);
+            if (fd < 0) {
+                atomic_fetch_add(&transport_stats.connect_failures, 1);
+            } else {
+                /* Publish the socket so stop_peer() can interrupt a blocked send */
+                pthread_mutex_lock(&peer->lock);
+                peer->fd = fd;
+                if (peer->stop) {
+                    shutdown(fd, SHUT_RDWR);
+                }
+                pthread_mutex_unlock(&peer->lock);
+            }
+        }
+
+        put_u32(frame.bytes + 0, QBUS_WIRE_MAGIC);
+        put_u32(frame.bytes + 4, (uint32_t)(frame.length - QBUS_WIRE_FRAME_HEADER));
+        put_u32(frame.bytes + 8, frame.count);
+        put_u32(frame.bytes + 12, 0);
+        put_u64(frame.bytes + 16, local_bus_id);
+
+        bool sent = fd >= 0 && send_all(fd, frame.bytes, frame.length);
+        if (sent) {
+            atomic_fetch_add(&transport_stats.frames_sent, 1);
+            atomic_fetch_add(&transport_stats.messages_sent, frame.count);
+            atomic_fetch_add(&transport_stats.bytes_sent, frame.length);
+        } else {
+            atomic_fetch_add(&transport_stats.messages_dropped, frame.count);
+        }
+
+        pthread_mutex_lock(&peer->lock);
+        if (!sent && fd >= 0) {
+            /* Drop the broken connection; the next frame reconnects */
+            close(fd);
+            peer->fd = -1;
+        }
+        peer->sending = false;
+    }
+    pthread_mutex_unlock(&peer->lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Receiver thread: decodes frames from one peer connection
+ */
+static void* connection_receiver_main(void* arg) {
+    TransportConnection* connection = (TransportConnection*)arg;
+    uint8_t frame_header[QBUS_WIRE_FRAME_HEADER];
+    uint8_t* body = malloc(QBUS_TRANSPORT_MAX_FRAME);
+
+    while (body && recv_all(connection->fd, frame_header, sizeof(frame_header))) {
+        uint32_t magic = get_u32(frame_header + 0);
+        uint32_t body_length = get_u32(frame_header + 4);
+        uint32_t count = get_u32(frame_header + 8);
+
+        if (magic != QBUS_WIRE_MAGIC || body_length > QBUS_TRANSPORT_MAX_FRAME) {
+            printf("QBus Transport: Invalid frame from peer, closing connection\n");
+            break;
+        }
+        if (!recv_all(connection->fd, body, body_length)) {
+            break;
+        }
+
+        atomic_fetch_add(&transport_stats.frames_received, 1);
+        atomic_fetch_add(&transport_stats.bytes_received, QBUS_WIRE_FRAME_HEADER + (uint64_t)body_length);
+
+        size_t offset = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            QMessageHeader header;
+            const uint8_t* data = NULL;
+            size_t used = qbus_wire_decode_message(body + offset, body_length - offset, &header, &data);
+            if (used == 0) {
+                printf("QBus Transport: Truncated record in frame, dropping remainder\n");
+                atomic_fetch_add(&transport_stats.messages_dropped, count - i);
+                break;
+            }
+            offset += used;
+
+            if (qbus_deliver_remote_message(&header, data)) {
+                atomic_fetch_add(&transport_stats.messages_received, 1);
+            } else {
+                atomic_fetch_add(&transport_stats.messages_dropped, 1);
+            }
+        }
+    }
+
+    free(body);
+    atomic_store(&connection->finished, true);
+    return NULL;
+}
+
+/**
+ * @brief Join a finished receiver and release its slot
+ *
+ * Caller must hold connections_lock.
+ */
+static void release_connection(TransportConnection* connection) {
+    pthread_join(connection->thread, NULL);
+    close(connection->fd);
+    connection->fd = -1;
+    connection->in_use = false;
+}
+
+/**
+ * @brief Listener thread: accepts peer connections
+ */
+static void* listener_main(void* arg) {
+    (void)arg;
+
+    while (!atomic_load(&listener_stop)) {
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            break;
+        }
+
+        pthread_mutex_lock(&connections_lock);
+        TransportConnection* slot = NULL;
+        for (uint32_t i = 0; i < MAX_CONNECTIONS && !slot; i++) {
+            if (connections[i].in_use && atomic_load(&connections[i].finished)) {
+                release_connection(&connections[i]);
+            }
+            if (!connections[i].in_use) {
+                slot = &connections[i];
+            }
+        }
+
+        if (slot && !atomic_load(&listener_stop)) {
+            slot->fd = fd;
+            atomic_store(&slot->finished, false);
+            if (pthread_create(&slot->thread, NULL, connection_receiver_main, slot) == 0) {
+                slot->in_use = true;
+                fd = -1;
+            }
+        }
+        pthread_mutex_unlock(&connections_lock);
+
+        if (fd >= 0) {
+            printf("QBus Transport: Rejecting peer connection, no free connection slots\n");
+            close(fd);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Forwarder registered with the message bus
+ */
+static void transport_forward(uint64_t remote_bus_id, const QMessage* message, void* context) {
+    (void)context;
+    qbus_transport_send(remote_bus_id, message);
+}
+
+/**
+ * @brief Ask a peer's sender thread to stop
+ */
+static void signal_peer_stop(TransportPeer* peer) {
+    pthread_mutex_lock(&peer->lock);
+    peer->stop = true;
+    if (peer->fd >= 0) {
+        shutdown(peer->fd, SHUT_RDWR);
+    }
+    pthread_cond_signal(&peer->wake);
+    pthread_mutex_unlock(&peer->lock);
+}
+
+/**
+ * @brief Join a stopped peer's sender thread and release its buffers
+ *
+ * The slot itself is cleared by the caller under peers_lock.
+ */
+static void release_peer(TransportPeer* peer) {
+    pthread_join(peer->thread, NULL);
+
+    if (peer->fd >= 0) {
+        close(peer->fd);
+    }
+    atomic_fetch_add(&transport_stats.messages_dropped, peer->pending.count);
+    free(peer->pending.bytes);
+    free(peer->in_flight.bytes);
+    pthread_cond_destroy(&peer->wake);
+    pthread_mutex_destroy(&peer->lock);
+}
+
+/**
+ * @brief Find a peer by remote bus ID
+ *
+ * Caller must hold peers_lock.
+ */
+static TransportPeer* find_peer(uint64_t remote_bus_id) {
+    for (uint32_t i = 0; i < QBUS_TRANSPORT_MAX_PEERS; i++) {
+        if (peers[i].in_use && peers[i].remote_bus_id == remote_bus_id) {
+            return &peers[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Initialize the transport and start listening for peers
+ */
+bool qbus_transport_init(uint64_t bus_id, uint16_t port) {
+    if (transport_initialized) {
+        return true;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        printf("QBus Transport: Failed to create listening socket\n");
+        return false;
+    }
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+
+    socklen_t address_length = sizeof(address);
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(fd, MAX_CONNECTIONS) != 0 ||
+        getsockname(fd, (struct sockaddr*)&address, &address_length) != 0) {
+        printf("QBus Transport: Failed to listen on port %u\n", (unsigned)port);
+        close(fd);
+        return false;
+    }
+
+    memset(peers, 0, sizeof(peers));
+    memset(connections, 0, sizeof(connections));
+    memset(&transport_stats, 0, sizeof(transport_stats));
+
+    local_bus_id = bus_id;
+    listen_fd = fd;
+    listen_port = ntohs(address.sin_port);
+    atomic_store(&listener_stop, false);
+
+    if (pthread_create(&listener_thread, NULL, listener_main, NULL) != 0) {
+        printf("QBus Transport: Failed to start listener thread\n");
+        close(fd);
+        listen_fd = -1;
+        return false;
+    }
+
+    transport_initialized = true;
+    qbus_set_remote_forwarder(transport_forward, NULL);
+
+    printf("QBus Transport: Bus %llu listening on port %u\n",
+           (unsigned long long)local_bus_id, (unsigned)listen_port);
+
+    return true;
+}
+
+/**
+ * @brief Shut down the transport
+ */
+void qbus_transport_shutdown(void) {
+    if (!transport_initialized) {
+        return;
+    }
+
+    /* Stop forwarding first so the pump no longer reaches into the peers */
+    qbus_set_remote_forwarder(NULL, NULL);
+
+    pthread_mutex_lock(&peers_lock);
+    for (uint32_t i = 0; i < QBUS_TRANSPORT_MAX_PEERS; i++) {
+        if (peers[i].in_use) {
+            signal_peer_stop(&peers[i]);
+            release_peer(&peers[i]);
+            memset(&peers[i], 0, sizeof(peers[i]));
+        }
+    }
+    pthread_mutex_unlock(&peers_lock);
+
+    atomic_store(&listener_stop, true);
+    shutdown(listen_fd, SHUT_RDWR);
+    pthread_join(listener_thread, NULL);
+    close(listen_fd);
+    listen_fd = -1;
+    listen_port = 0;
+
+    pthread_mutex_lock(&connections_lock);
+    for (uint32_t i = 0; i < MAX_CONNECTIONS; i++) {
+        if (connections[i].in_use) {
+            shutdown(connections[i].fd, SHUT_RDWR);
+            release_connection(&connections[i]);
+        }
+    }
+    pthread_mutex_unlock(&connections_lock);
+
+    transport_initialized = false;
+
+    printf("QBus Transport: Shutdown complete\n");
+}
+
+/**
+ * @brief Get the port the transport is listening on
+ */
+uint16_t qbus_transport_get_port(void) {
+    return transport_initialized ? listen_port : 0;
+}
+
+/**
+ * @brief Add a peer bus reachable over TCP
+ */
+bool qbus_transport_add_peer(uint64_t remote_bus_id, const char* host, uint16_t port) {
+    if (!transport_initialized || !host || strlen(host) >= sizeof(peers[0].host)) {
+        return false;
+    }
+
+    pthread_mutex_lock(&peers_lock);
+
+    if (find_peer(remote_bus_id)) {
+        pthread_mutex_unlock(&peers_lock);
+        printf("QBus Transport: Peer for bus %llu already exists\n", (unsigned long long)remote_bus_id);
+        return false;
+    }
+
+    TransportPeer* peer = NULL;
+    for (uint32_t i = 0; i < QBUS_TRANSPORT_MAX_PEERS; i++) {
+        if (!peers[i].in_use && !peers[i].stopping) {
+            peer = &peers[i];
+            break;
+        }
+    }
+    if (!peer) {
+        pthread_mutex_unlock(&peers_lock);
+        printf("QBus Transport: Maximum number of peers reached\n");
+        return false;
+    }
+
+    size_t capacity = QBUS_WIRE_FRAME_HEADER + QBUS_TRANSPORT_MAX_FRAME;
+    peer->pending.bytes = malloc(capacity);
+    peer->in_flight.bytes = malloc(capacity);
+    if (!peer->pending.bytes || !peer->in_flight.bytes) {
+        free(peer->pending.bytes);
+        free(peer->in_flight.bytes);
+        memset(peer, 0, sizeof(*peer));
+        pthread_mutex_unlock(&peers_lock);
+        return false;
+    }
+    frame_reset(&peer->pending);
+    frame_reset(&peer->in_flight);
+
+    peer->remote_bus_id = remote_bus_id;
+    strcpy(peer->host, host);
+    peer->port = port;
+    peer->fd = -1;
+    peer->sending = false;
+    peer->stop = false;
+    pthread_mutex_init(&peer->lock, NULL);
+    pthread_cond_init(&peer->wake, NULL);
+
+    if (pthread_create(&peer->thread, NULL, peer_sender_main, peer) != 0) {
+        pthread_cond_destroy(&peer->wake);
+        pthread_mutex_destroy(&peer->lock);
+        free(peer->pending.bytes);
+        free(peer->in_flight.bytes);
+        memset(peer, 0, sizeof(*peer));
+        pthread_mutex_unlock(&peers_lock);
+        return false;
+    }
+    peer->in_use = true;
+
+    pthread_mutex_unlock(&peers_lock);
+
+    printf("QBus Transport: Added peer bus %llu at %s:%u\n",
+           (unsigned long long)remote_bus_id, host, (unsigned)port);
+
+    return true;
+}
+
+/**
+ * @brief Remove a peer bus
+ */
+bool qbus_transport_remove_peer(uint64_t remote_bus_id) {
+    if (!transport_initialized) {
+        return false;
+    }
+
+    /* Unpublish the peer, then join its sender without holding peers_lock */
+    pthread_mutex_lock(&peers_lock);
+    TransportPeer* peer = find_peer(remote_bus_id);
+    if (peer) {
+        peer->in_use = false;
+        peer->stopping = true;
+        signal_peer_stop(peer);
+    }
+    pthread_mutex_unlock(&peers_lock);
+
+    if (!peer) {
+        return false;
+    }
+
+    release_peer(peer);
+
+    pthread_mutex_lock(&peers_lock);
+    memset(peer, 0, sizeof(*peer));
+    pthread_mutex_unlock(&peers_lock);
+
+    return true;
+}
+
+/**
+ * @brief Queue a message for a peer bus
+ */
+bool qbus_transport_send(uint64_t remote_bus_id, const QMessage* message) {
+    if (!transport_initialized || !message) {
+        return false;
+    }
+
+    pthread_mutex_lock(&peers_lock);
+    TransportPeer* peer = find_peer(remote_bus_id);
+    if (!peer) {
+        pthread_mutex_unlock(&peers_lock);
+        atomic_fetch_add(&transport_stats.messages_dropped, 1);
+        return false;
+    }
+
+    pthread_mutex_lock(&peer->lock);
+    size_t capacity = QBUS_WIRE_FRAME_HEADER + QBUS_TRANSPORT_MAX_FRAME;
+    size_t before = peer->pending.length;
+    size_t used = qbus_wire_encode_message(message, peer->pending.bytes + before, capacity - before);
+    if (used > 0) {
+        peer->pending.length += used;
+        peer->pending.count++;
+
+        /* Wake the sender for the first record and when the frame is large enough */
+        if (peer->pending.count == 1 ||
+            (before < COALESCE_BYTES && peer->pending.length >= COALESCE_BYTES)) {
+            pthread_cond_signal(&peer->wake);
+        }
+    }
+    pthread_mutex_unlock(&peer->lock);
+    pthread_mutex_unlock(&peers_lock);
+
+    if (used == 0) {
+        atomic_fetch_add(&transport_stats.messages_dropped, 1);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Wait until all queued messages have been written to their peers
+ */
+bool qbus_transport_flush(uint32_t timeout_ms) {
+    if (!transport_initialized) {
+        return false;
+    }
+
+    struct timespec pause = { 0, 1000000L };
+    for (uint32_t waited = 0; ; waited++) {
+        bool idle = true;
+
+        pthread_mutex_lock(&peers_lock);
+        for (uint32_t i = 0; i < QBUS_TRANSPORT_MAX_PEERS && idle; i++) {
+            if (!peers[i].in_use) {
+                continue;
+            }
+            pthread_mutex_lock(&peers[i].lock);
+            idle = peers[i].pending.count == 0 && !peers[i].sending;
+            pthread_mutex_unlock(&peers[i].lock);
+        }
+        pthread_mutex_unlock(&peers_lock);
+
+        if (idle) {
+            return true;
+        }
+        if (waited >= timeout_ms) {
+            return false;
+        }
+        nanosleep(&pause, NULL);
+    }
+}
+
+/**
+ * @brief Get transport statistics
+ */
+bool qbus_transport_get_stats(QTransportStats* stats) {
+    if (!stats) {
+        return false;
+    }
+
+    stats->messages_sent = atomic_load(&transport_stats.messages_sent);
+    stats->messages_received = atomic_load(&transport_stats.messages_received);
+    stats->frames_sent = atomic_load(&transport_stats.frames_sent);
+    stats->frames_received = atomic_load(&transport_stats.frames_received);
+    stats->bytes_sent = atomic_load(&transport_stats.bytes_sent);
+    stats->bytes_received = atomic_load(&transport_stats.bytes_received);
+    stats->messages_dropped = atomic_load(&transport_stats.messages_dropped);
+    stats->connect_failures = atomic_load(&transport_stats.connect_failures);
+
+    return true;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file quantum_bus_transport.h
+ * @brief Cross-Node Transport for Quantum Message Bus Federation
+ *
+ * This file defines the network transport that carries messages between
+ * entangled Quantum Message Buses running on different nodes. Messages are
+ * encoded in a compact binary wire format, coalesced into frames and sent
+ * asynchronously over TCP so local delivery never waits on the network.
+ */
+
+#ifndef CTRLXT_QUANTUM_BUS_TRANSPORT_H
+#define CTRLXT_QUANTUM_BUS_TRANSPORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "quantum_message_bus.h"
+
+/**
+ * @brief Wire format constants
+ *
+ * All integers are little-endian. A frame is a frame header followed by
+ * message_count records, each a record header followed by its payload.
+ */
+#define QBUS_WIRE_MAGIC          0x31464251u   /**< "QBF1" */
+#define QBUS_WIRE_FRAME_HEADER   24            /**< magic, body length, count, reserved, source bus */
+#define QBUS_WIRE_RECORD_HEADER  44            /**< Encoded QMessageHeader size */
+#define QBUS_TRANSPORT_MAX_FRAME (256 * 1024)  /**< Largest frame body a peer will accept */
+#define QBUS_TRANSPORT_MAX_PEERS 16
+
+/**
+ * @brief Transport statistics
+ */
+typedef struct {
+    uint64_t messages_sent;        /**< Messages written to peers */
+    uint64_t messages_received;    /**< Messages received and queued on the local bus */
+    uint64_t frames_sent;          /**< Frames written to peers */
+    uint64_t frames_received;      /**< Frames read from peers */
+    uint64_t bytes_sent;           /**< Bytes written to peers */
+    uint64_t bytes_received;       /**< Bytes read from peers */
+    uint64_t messages_dropped;     /**< Messages dropped (send buffer full, unknown peer, lost connection) */
+    uint64_t connect_failures;     /**< Failed connection attempts */
+} QTransportStats;
+
+/**
+ * @brief Initialize the transport and start listening for peers
+ *
+ * Registers the transport as the bus's remote forwarder, so every
+ * entanglement created with qbus_create_entanglement() is carried to the
+ * peer added for its remote bus ID.
+ *
+ * @param local_bus_id ID of the local bus, sent in every frame
+ * @param listen_port TCP port to listen on (0 for an ephemeral port)
+ * @return true if the transport was initialized, false otherwise
+ */
+bool qbus_transport_init(uint64_t local_bus_id, uint16_t listen_port);
+
+/**
+ * @brief Shut down the transport
+ *
+ * Closes all connections and stops the transport threads. Messages not yet
+ * written to a peer are discarded; call qbus_transport_flush() first to
+ * send them.
+ */
+void qbus_transport_shutdown(void);
+
+/**
+ * @brief Get the port the transport is listening on
+ *
+ * @return Listening port, or 0 if the transport is not initialized
+ */
+uint16_t qbus_transport_get_port(void);
+
+/**
+ * @brief Add a peer bus reachable over TCP
+ *
+ * The connection is opened lazily by the peer's sender thread and
+ * re-established after failures.
+ *
+ * @param remote_bus_id ID of the remote bus
+ * @param host IPv4 address or host name of the remote node
+ * @param port TCP port of the remote transport
+ * @return true if the peer was added, false otherwise
+ */
+bool qbus_transport_add_peer(uint64_t remote_bus_id, const char* host, uint16_t port);
+
+/**
+ * @brief Remove a peer bus
+ *
+ * @param remote_bus_id ID of the remote bus
+ * @return true if the peer was removed, false otherwise
+ */
+bool qbus_transport_remove_peer(uint64_t remote_bus_id);
+
+/**
+ * @brief Queue a message for a peer bus
+ *
+ * The message is encoded immediately and written by the peer's sender
+ * thread together with any other messages queued meanwhile. Never blocks
+ * on the network.
+ *
+ * @param remote_bus_id ID of the remote bus
+ * @param message Message to send
+ * @return true if the message was queued, false if it was dropped
+ */
+bool qbus_transport_send(uint64_t remote_bus_id, const QMessage* message);
+
+/**
+ * @brief Wait until all queued messages have been written to their peers
+ *
+ * @param timeout_ms Maximum time to wait in milliseconds
+ * @return true if all queues drained, false on timeout
+ */
+bool qbus_transport_flush(uint32_t timeout_ms);
+
+/**
+ * @brief Get transport statistics
+ *
+ * @param stats Pointer to store statistics
+ * @return true if statistics were retrieved, false otherwise
+ */
+bool qbus_transport_get_stats(QTransportStats* stats);
+
+/**
+ * @brief Encode a message as a wire record
+ *
+ * @param message Message to encode
+ * @param out Output buffer
+ * @param capacity Size of the output buffer
+ * @return Number of bytes written, or 0 if the buffer is too small
+ */
+size_t qbus_wire_encode_message(const QMessage* message, uint8_t* out, size_t capacity);
+
+/**
+ * @brief Decode a wire record
+ *
+ * @param in Input buffer
+ * @param length Number of bytes available
+ * @param header Decoded header
+ * @param data Set to the payload within the input buffer (NULL if empty)
+ * @return Number of bytes consumed, or 0 if the record is truncated
+ */
+size_t qbus_wire_decode_message(const uint8_t* in, size_t length, QMessageHeader* header, const uint8_t** data);
+
+#endif /* CTRLXT_QUANTUM_BUS_TRANSPORT_H */
@@ -3,12 +3,20 @@
  * @brief Quantum Message Bus implementation
  */
 
+/* POSIX threads and clocks under -std=c11 */
+#define _XOPEN_SOURCE 700
+
 #include "quantum_message_bus.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <stdatomic.h>
+#include <stdalign.h>
+#include <stddef.h>
+#include <pthread.h>
 #include "../entanglement/entanglement_manager.h"
+#include "../../kernel/trace/trace.h"
 
 /* Maximum number of registered components */
 #define MAX_COMPONENTS 64
@@ -19,12 +27,48 @@
 /* Maximum number of remote bus entanglements */
 #define MAX_BUS_ENTANGLEMENTS 16
 
-/* Maximum queue size for pending messages */
+/* Maximum queue size for pending messages per priority level (power of two) */
 #define MAX_PENDING_MESSAGES 1024
 
+/* Number of priority levels, one pending ring per level */
+#define QMSG_PRIORITY_LEVELS (QMSG_PRIORITY_QUANTUM + 1)
+
+/* Cache line size used to keep producer and consumer cursors apart */
+#define QBUS_CACHE_LINE 64
+
+/* Maximum number of subscriptions across all components */
+#define MAX_TOTAL_SUBSCRIPTIONS (MAX_COMPONENTS * MAX_SUBSCRIPTIONS_PER_COMPONENT)
+
+/* Dispatch index bucket table size (power of two, at least 2x distinct types) */
+#define DISPATCH_TABLE_SIZE (2 * MAX_TOTAL_SUBSCRIPTIONS)
+
+/* Number of inline payload size classes for pooled messages */
+#define MESSAGE_SIZE_CLASSES 4
+
+/* Number of message blocks carved from each pool slab */
+#define MESSAGE_SLAB_BLOCKS 64
+
+/* Size class marker for messages whose payload is too large to pool */
+#define MESSAGE_CLASS_HEAP MESSAGE_SIZE_CLASSES
+
+/* Maximum number of messages grouped per batch drain window */
+#define QBUS_BATCH_WINDOW 256
+
+/* Group table size for batch drains (power of two, at least 2x the window) */
+#define QBUS_BATCH_GROUP_TABLE (2 * QBUS_BATCH_WINDOW)
+
+/* Maximum number of delivery worker threads */
+#define QBUS_MAX_WORKERS 64
+
+/* Default per-component inbox capacity in worker mode */
+#define QBUS_DEFAULT_INBOX_CAPACITY 256
+
+/* How long an idle worker sleeps before looking for work to steal */
+#define QBUS_WORKER_IDLE_WAIT_NS 1000000L
+
 /* Message bus state */
 static bool qbus_initialized = false;
-static uint64_t next_message_id = 1;
+static _Atomic uint64_t next_message_id = 1;
 
 /* Component tracking */
 typedef struct {
@@ -32,10 +76,124 @@ typedef struct {
     bool registered;
     uint32_t subscription_count;
     QSubscription subscriptions[MAX_SUBSCRIPTIONS_PER_COMPONENT];
+    int32_t worker_affinity;       /* Pinned worker, or -1 to assign by slot */
+    bool reentrant;                /* Handlers may run on several workers at once */
 } ComponentEntry;
 
 static ComponentEntry components[MAX_COMPONENTS];
 
+/*
+ * Registry lock
+ *
+ * Serializes changes to the component table and dispatch index against the
+ * message pump. Recursive so handlers running inline on the pump thread can
+ * still subscribe and unsubscribe.
+ */
+static pthread_once_t registry_lock_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t registry_lock;
+
+/*
+ * Broadcast dispatch index
+ *
+ * Rebuilt whenever subscriptions change. Subscriptions for each message type
+ * are stored contiguously in dispatch_entries, with a type-keyed open
+ * addressing table pointing at each run. Wildcard subscriptions live in their
+ * own run. The order key records (component slot, subscription index) so a
+ * broadcast can merge the typed and wildcard runs and deliver in the same
+ * order as a scan of the component table would.
+ */
+typedef struct {
+    QMessageHandler handler;
+    QMessageBatchHandler batch_handler;
+    void* context;
+    NodeLevel min_resonance;
+    QComponentId component_id;
+    uint32_t slot;
+    uint32_t order;
+} DispatchEntry;
+
+typedef struct {
+    QMessageType type;
+    bool used;
+    uint32_t first;
+    uint32_t count;
+} DispatchBucket;
+
+static DispatchEntry dispatch_entries[MAX_TOTAL_SUBSCRIPTIONS];
+static DispatchBucket dispatch_table[DISPATCH_TABLE_SIZE];
+static uint32_t dispatch_wildcard_first = 0;
+static uint32_t dispatch_wildcard_count = 0;
+
+/* Deferred rebuild for subscription changes made from inside a handler */
+static uint32_t dispatch_depth = 0;
+static bool dispatch_dirty = false;
+
+/* Batch drain scratch space (consumer only) */
+typedef struct {
+    QComponentId destination;
+    QMessageType type;
+    uint32_t group;
+    bool used;
+} BatchGroupKey;
+
+static QMessage* batch_window[QBUS_BATCH_WINDOW];
+static QMessage* batch_sorted[QBUS_BATCH_WINDOW];
+static QMessage* batch_span[QBUS_BATCH_WINDOW];
+static uint32_t batch_group_of[QBUS_BATCH_WINDOW];
+static uint32_t batch_group_offset[QBUS_BATCH_WINDOW + 1];
+static BatchGroupKey batch_group_table[QBUS_BATCH_GROUP_TABLE];
+
+/*
+ * Worker pool
+ *
+ * In worker mode the pump only routes: it matches subscriptions and appends
+ * one delivery per matched subscription to the inbox of the receiving
+ * component. Each component slot is owned by exactly one worker, which runs
+ * that component's deliveries in order. Idle workers may steal deliveries
+ * from the inboxes of reentrant components owned by other workers.
+ * Inboxes and ready queues are protected by the owning worker's lock.
+ */
+typedef struct {
+    QMessage* message;
+    QMessageHandler handler;
+    QMessageBatchHandler batch_handler;
+    void* context;
+    uint32_t slot;                 /* Receiving component slot */
+} DeliveryItem;
+
+typedef struct {
+    DeliveryItem* items;
+    uint32_t head;
+    uint32_t count;
+    uint32_t worker;
+    bool queued;                   /* Present in the owning worker's ready queue */
+} ComponentInbox;
+
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t work_available;
+    pthread_cond_t space_available;
+    uint32_t ready[MAX_COMPONENTS];
+    uint32_t ready_head;
+    uint32_t ready_count;
+    _Atomic uint32_t pending;      /* Deliveries queued across owned inboxes */
+    bool running;
+} BusWorker;
+
+static bool workers_active = false;
+static QWorkerPoolConfig worker_config;
+static BusWorker* bus_workers = NULL;
+static ComponentInbox component_inboxes[MAX_COMPONENTS];
+static DeliveryItem* inbox_storage = NULL;
+static _Atomic uint32_t worker_inflight = 0;
+static pthread_mutex_t worker_idle_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t worker_idle = PTHREAD_COND_INITIALIZER;
+
+/* Deliveries routed by the pump while holding the registry lock */
+static DeliveryItem routed_items[MAX_TOTAL_SUBSCRIPTIONS];
+static uint32_t routed_count = 0;
+
 /* Bus entanglement tracking */
 typedef struct {
     uint64_t id;
@@ -46,17 +204,361 @@ typedef struct {
 
 static BusEntanglement bus_entanglements[MAX_BUS_ENTANGLEMENTS];
 
-/* Pending message queue */
-static QMessage* pending_messages[MAX_PENDING_MESSAGES];
-static uint32_t pending_message_count = 0;
+/* Transport that carries messages to entangled remote buses */
+static QRemoteForwarder remote_forwarder = NULL;
+static void* remote_forwarder_context = NULL;
+
+/*
+ * Pending message queue
+ *
+ * Each priority level has a bounded multi-producer/single-consumer ring.
+ * Every cell carries a sequence number: a producer may claim a cell when its
+ * sequence equals the enqueue position, and the consumer may take it once the
+ * producer has published position + 1. Producers only contend on a single
+ * compare-and-swap of the enqueue cursor; the consumer never writes to it.
+ */
+typedef struct {
+    _Atomic uint64_t sequence;
+    QMessage* message;
+} PendingCell;
+
+typedef struct {
+    PendingCell cells[MAX_PENDING_MESSAGES];
+    _Alignas(QBUS_CACHE_LINE) _Atomic uint64_t enqueue_pos;
+    _Alignas(QBUS_CACHE_LINE) uint64_t dequeue_pos;  /* Consumer only */
+} PendingRing;
+
+static PendingRing pending_rings[QMSG_PRIORITY_LEVELS];
+static _Atomic uint32_t pending_message_count = 0;
+
+/*
+ * Statistics
+ *
+ * Every counter is a relaxed atomic so producers, the pump and the workers
+ * record without taking a lock. Message types get a slot in a fixed open
+ * addressing table the first time they are seen; the key is the type plus
+ * one so zero can mark a free slot. Component statistics are indexed by
+ * component slot and reset when a component registers.
+ */
+typedef struct {
+    _Atomic uint64_t count;
+    _Atomic uint64_t sum_ns;
+    _Atomic uint64_t max_ns;
+    _Atomic uint64_t buckets[QBUS_LATENCY_BUCKETS];
+} LatencyRecorder;
+
+typedef struct {
+    _Atomic uint64_t enqueued;
+    _Atomic uint64_t dispatched;
+    _Atomic uint64_t dropped;
+    _Atomic uint32_t depth;
+    _Atomic uint32_t depth_high_water;
+    LatencyRecorder latency;
+} PriorityRecorder;
+
+typedef struct {
+    _Atomic uint32_t key;
+    _Atomic uint64_t enqueued;
+    _Atomic uint64_t dispatched;
+    _Atomic uint64_t dropped;
+    LatencyRecorder latency;
+} TypeRecorder;
+
+typedef struct {
+    _Atomic uint32_t component_id;
+    _Atomic uint64_t invocations;
+    _Atomic uint64_t inbox_dropped;
+    LatencyRecorder handler_time;
+} ComponentRecorder;
+
+_Static_assert(QBUS_STATS_MAX_COMPONENTS == MAX_COMPONENTS, "one statistics slot per component slot");
+_Static_assert((QBUS_STATS_MAX_TYPES & (QBUS_STATS_MAX_TYPES - 1)) == 0, "type table size must be a power of two");
+
+static PriorityRecorder priority_stats[QMSG_PRIORITY_LEVELS];
+static TypeRecorder type_stats[QBUS_STATS_MAX_TYPES];
+static ComponentRecorder component_stats[MAX_COMPONENTS];
+static _Atomic uint64_t untracked_type_count = 0;
+static _Atomic uint32_t pending_high_water = 0;
+
+/*
+ * Message pool
+ *
+ * A message and its payload share one block. Blocks come from per-class
+ * slabs and are recycled through a free list, so steady-state traffic does
+ * not allocate. Payloads larger than the biggest class get a single heap
+ * block instead. Slabs are kept for the lifetime of the process so messages
+ * still held by callers remain valid across qbus_shutdown.
+ */
+typedef struct PooledMessage {
+    QMessage message;               /* Must be first */
+    _Atomic uint32_t refs;          /* Owner plus outstanding worker deliveries */
+    uint32_t size_class;
+    bool remote_origin;             /* Received from an entangled remote bus */
+    uint64_t enqueue_ns;            /* Monotonic time the message was queued */
+    struct PooledMessage* next_free;
+    alignas(max_align_t) unsigned char payload[];
+} PooledMessage;
+
+typedef struct {
+    uint32_t payload_size;
+    PooledMessage* free_list;
+    pthread_mutex_t lock;
+} MessageSizeClass;
+
+static MessageSizeClass message_classes[MESSAGE_SIZE_CLASSES] = {
+    { .payload_size = 64,   .free_list = NULL, .lock = PTHREAD_MUTEX_INITIALIZER },
+    { .payload_size = 256,  .free_list = NULL, .lock = PTHREAD_MUTEX_INITIALIZER },
+    { .payload_size = 1024, .free_list = NULL, .lock = PTHREAD_MUTEX_INITIALIZER },
+    { .payload_size = 4096, .free_list = NULL, .lock = PTHREAD_MUTEX_INITIALIZER }
+};
+
+/* Reference-counted payload buffer */
+struct QMessageBuffer {
+    _Atomic uint32_t refcount;
+    uint32_t size;
+    void* data;
+    QBufferReleaseFn release;
+    void* release_context;
+    alignas(max_align_t) unsigned char inline_data[];
+};
+
+/**
+ * @brief Get the block size for a message size class
+ */
+static size_t message_block_size(uint32_t size_class) {
+    size_t size = sizeof(PooledMessage) + message_classes[size_class].payload_size;
+    return (size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+}
+
+/**
+ * @brief Carve a new slab of blocks onto a size class free list
+ *
+ * Caller must hold the class lock.
+ */
+static bool grow_message_class(uint32_t size_class) {
+    size_t block_size = message_block_size(size_class);
+    unsigned char* slab = (unsigned char*)malloc(block_size * MESSAGE_SLAB_BLOCKS);
+    if (!slab) {
+        return false;
+    }
+    
+    MessageSizeClass* cls = &message_classes[size_class];
+    for (uint32_t i = 0; i < MESSAGE_SLAB_BLOCKS; i++) {
+        PooledMessage* block = (PooledMessage*)(slab + i * block_size);
+        block->size_class = size_class;
+        block->next_free = cls->free_list;
+        cls->free_list = block;
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Allocate a message block with room for an inline payload
+ */
+static PooledMessage* alloc_message_block(uint32_t payload_size) {
+    for (uint32_t c = 0; c < MESSAGE_SIZE_CLASSES; c++) {
+        MessageSizeClass* cls = &message_classes[c];
+        if (payload_size > cls->payload_size) {
+            continue;
+        }
+        
+        pthread_mutex_lock(&cls->lock);
+        if (!cls->free_list && !grow_message_class(c)) {
+            pthread_mutex_unlock(&cls->lock);
+            return NULL;
+        }
+        
+        PooledMessage* block = cls->free_list;
+        cls->free_list = block->next_free;
+        pthread_mutex_unlock(&cls->lock);
+        
+        block->next_free = NULL;
+        atomic_init(&block->refs, 1);
+        return block;
+    }
+    
+    /* Too large for any class: one heap block for message and payload */
+    PooledMessage* block = (PooledMessage*)malloc(sizeof(PooledMessage) + payload_size);
+    if (!block) {
+        return NULL;
+    }
+    
+    block->size_class = MESSAGE_CLASS_HEAP;
+    block->next_free = NULL;
+    atomic_init(&block->refs, 1);
+    return block;
+}
+
+/**
+ * @brief Return a message block to its size class
+ */
+static void free_message_block(PooledMessage* block) {
+    if (block->size_class == MESSAGE_CLASS_HEAP) {
+        free(block);
+        return;
+    }
+    
+    MessageSizeClass* cls = &message_classes[block->size_class];
+    pthread_mutex_lock(&cls->lock);
+    block->next_free = cls->free_list;
+    cls->free_list = block;
+    pthread_mutex_unlock(&cls->lock);
+}
+
+/**
+ * @brief Create the recursive registry lock
+ */
+static void init_registry_lock(void) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&registry_lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+/**
+ * @brief Acquire the registry lock
+ */
+static void lock_registry(void) {
+    pthread_once(&registry_lock_once, init_registry_lock);
+    pthread_mutex_lock(&registry_lock);
+}
+
+/**
+ * @brief Release the registry lock
+ */
+static void unlock_registry(void) {
+    pthread_mutex_unlock(&registry_lock);
+}
 
 /**
  * @brief Get current timestamp in nanoseconds
  */
 static uint64_t get_timestamp_ns(void) {
-    /* In a real implementation, this would use a high-precision timer */
-    /* For simulation, we'll just use time() and convert to nanoseconds */
-    return (uint64_t)time(NULL) * 1000000000ULL;
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Get monotonic time in nanoseconds for measuring intervals
+ */
+static uint64_t get_monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Map a latency onto its histogram bucket
+ */
+static uint32_t latency_bucket(uint64_t ns) {
+    if (ns < 4) {
+        return (uint32_t)ns;
+    }
+    
+    uint32_t exponent = 63 - (uint32_t)__builtin_clzll(ns);
+    uint32_t sub = (uint32_t)(ns >> (exponent - 2)) & 3;
+    uint32_t bucket = (exponent - 1) * 4 + sub;
+    
+    return bucket < QBUS_LATENCY_BUCKETS ? bucket : QBUS_LATENCY_BUCKETS - 1;
+}
+
+/**
+ * @brief Largest latency that maps onto a histogram bucket
+ */
+static uint64_t latency_bucket_limit(uint32_t bucket) {
+    if (bucket < 4) {
+        return bucket;
+    }
+    if (bucket >= QBUS_LATENCY_BUCKETS - 1) {
+        return UINT64_MAX;
+    }
+    
+    uint32_t exponent = bucket / 4 + 1;
+    uint64_t lower = (uint64_t)(4 + bucket % 4) << (exponent - 2);
+    
+    return lower + ((uint64_t)1 << (exponent - 2)) - 1;
+}
+
+/**
+ * @brief Raise an atomic high-water mark
+ */
+static void raise_high_water_u32(_Atomic uint32_t* mark, uint32_t value) {
+    uint32_t current = atomic_load_explicit(mark, memory_order_relaxed);
+    while (value > current &&
+           !atomic_compare_exchange_weak_explicit(mark, &current, value,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Record a latency sample
+ */
+static void record_latency(LatencyRecorder* recorder, uint64_t ns) {
+    atomic_fetch_add_explicit(&recorder->count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&recorder->sum_ns, ns, memory_order_relaxed);
+    atomic_fetch_add_explicit(&recorder->buckets[latency_bucket(ns)], 1, memory_order_relaxed);
+    
+    uint64_t current = atomic_load_explicit(&recorder->max_ns, memory_order_relaxed);
+    while (ns > current &&
+           !atomic_compare_exchange_weak_explicit(&recorder->max_ns, &current, ns,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Find or claim the statistics slot for a message type
+ *
+ * @return Type recorder, or NULL if the table is full
+ */
+static TypeRecorder* type_recorder(QMessageType type) {
+    uint32_t key = (uint32_t)type + 1;
+    uint32_t index = (key * 2654435761u) & (QBUS_STATS_MAX_TYPES - 1);
+    
+    for (uint32_t probe = 0; probe < QBUS_STATS_MAX_TYPES; probe++) {
+        TypeRecorder* recorder = &type_stats[index];
+        uint32_t current = atomic_load_explicit(&recorder->key, memory_order_acquire);
+        
+        if (current == key) {
+            return recorder;
+        }
+        if (current == 0) {
+            uint32_t expected = 0;
+            if (atomic_compare_exchange_strong_explicit(&recorder->key, &expected, key,
+                                                        memory_order_acq_rel, memory_order_acquire) ||
+                expected == key) {
+                return recorder;
+            }
+        }
+        
+        index = (index + 1) & (QBUS_STATS_MAX_TYPES - 1);
+    }
+    
+    atomic_fetch_add_explicit(&untracked_type_count, 1, memory_order_relaxed);
+    return NULL;
+}
+
+/**
+ * @brief Record handler execution time for a component slot
+ */
+static void record_handler_time(uint32_t slot, uint64_t ns, uint32_t messages) {
+    ComponentRecorder* recorder = &component_stats[slot];
+    atomic_fetch_add_explicit(&recorder->invocations, messages, memory_order_relaxed);
+    record_latency(&recorder->handler_time, ns);
+}
+
+/**
+ * @brief Snapshot a latency recorder
+ */
+static void snapshot_latency(const LatencyRecorder* recorder, QLatencyHistogram* out) {
+    out->count = atomic_load_explicit(&recorder->count, memory_order_relaxed);
+    out->sum_ns = atomic_load_explicit(&recorder->sum_ns, memory_order_relaxed);
+    out->max_ns = atomic_load_explicit(&recorder->max_ns, memory_order_relaxed);
+    for (uint32_t i = 0; i < QBUS_LATENCY_BUCKETS; i++) {
+        out->buckets[i] = atomic_load_explicit(&recorder->buckets[i], memory_order_relaxed);
+    }
 }
 
 /**
@@ -112,68 +614,332 @@ static BusEntanglement* find_free_entanglement_slot(void) {
 }
 
 /**
- * @brief Add a message to the pending queue
+ * @brief Hash a message type into the dispatch table
  */
-static bool add_to_pending_queue(QMessage* message) {
-    if (pending_message_count >= MAX_PENDING_MESSAGES) {
-        return false;
+static uint32_t dispatch_hash(QMessageType type) {
+    return ((uint32_t)type * 2654435761u) & (DISPATCH_TABLE_SIZE - 1);
+}
+
+/**
+ * @brief Find the dispatch bucket for a message type
+ *
+ * @param create Whether to claim an empty bucket if the type is not present
+ */
+static DispatchBucket* dispatch_lookup(QMessageType type, bool create) {
+    uint32_t index = dispatch_hash(type);
+    
+    for (uint32_t probe = 0; probe < DISPATCH_TABLE_SIZE; probe++) {
+        DispatchBucket* bucket = &dispatch_table[index];
+        
+        if (!bucket->used) {
+            if (!create) {
+                return NULL;
+            }
+            bucket->used = true;
+            bucket->type = type;
+            bucket->first = 0;
+            bucket->count = 0;
+            return bucket;
+        }
+        
+        if (bucket->type == type) {
+            return bucket;
+        }
+        
+        index = (index + 1) & (DISPATCH_TABLE_SIZE - 1);
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief Rebuild the broadcast dispatch index from the component table
+ */
+static void rebuild_dispatch_index(void) {
+    if (dispatch_depth > 0) {
+        /* A broadcast is iterating the index, rebuild once it finishes */
+        dispatch_dirty = true;
+        return;
     }
     
-    /* Find insertion point based on priority */
-    int insert_index = pending_message_count;
+    memset(dispatch_table, 0, sizeof(dispatch_table));
+    dispatch_wildcard_count = 0;
     
-    /* Priority queue - higher priority messages go to the front */
-    for (int i = 0; i < pending_message_count; i++) {
-        if (message->header.priority > pending_messages[i]->header.priority) {
-            insert_index = i;
-            break;
+    /* First pass: count subscriptions per type */
+    for (int i = 0; i < MAX_COMPONENTS; i++) {
+        if (!components[i].registered) {
+            continue;
+        }
+        
+        for (uint32_t j = 0; j < components[i].subscription_count; j++) {
+            QSubscription* sub = &components[i].subscriptions[j];
+            if (!sub->handler && !sub->batch_handler) {
+                continue;
+            }
+            
+            if (sub->message_type == (QMessageType)-1) {
+                dispatch_wildcard_count++;
+            } else {
+                dispatch_lookup(sub->message_type, true)->count++;
+            }
+        }
+    }
+    
+    /* Assign contiguous runs, wildcard run first */
+    uint32_t offset = dispatch_wildcard_count;
+    dispatch_wildcard_first = 0;
+    for (uint32_t b = 0; b < DISPATCH_TABLE_SIZE; b++) {
+        if (dispatch_table[b].used) {
+            dispatch_table[b].first = offset;
+            offset += dispatch_table[b].count;
+            dispatch_table[b].count = 0;
+        }
+    }
+    
+    /* Second pass: fill runs in component table order */
+    uint32_t wildcard_fill = 0;
+    for (int i = 0; i < MAX_COMPONENTS; i++) {
+        if (!components[i].registered) {
+            continue;
+        }
+        
+        for (uint32_t j = 0; j < components[i].subscription_count; j++) {
+            QSubscription* sub = &components[i].subscriptions[j];
+            if (!sub->handler && !sub->batch_handler) {
+                continue;
+            }
+            
+            DispatchEntry* entry;
+            if (sub->message_type == (QMessageType)-1) {
+                entry = &dispatch_entries[dispatch_wildcard_first + wildcard_fill++];
+            } else {
+                DispatchBucket* bucket = dispatch_lookup(sub->message_type, false);
+                entry = &dispatch_entries[bucket->first + bucket->count++];
+            }
+            
+            entry->handler = sub->handler;
+            entry->batch_handler = sub->batch_handler;
+            entry->context = sub->context;
+            entry->min_resonance = sub->min_resonance;
+            entry->component_id = components[i].info.id;
+            entry->slot = (uint32_t)i;
+            entry->order = (uint32_t)i * MAX_SUBSCRIPTIONS_PER_COMPONENT + j;
         }
     }
     
-    /* Shift messages to make room */
-    for (int i = pending_message_count; i > insert_index; i--) {
-        pending_messages[i] = pending_messages[i - 1];
+    dispatch_dirty = false;
+}
+
+/**
+ * @brief Reset a pending ring to the empty state
+ */
+static void reset_pending_ring(PendingRing* ring) {
+    for (uint64_t i = 0; i < MAX_PENDING_MESSAGES; i++) {
+        ring->cells[i].message = NULL;
+        atomic_store_explicit(&ring->cells[i].sequence, i, memory_order_relaxed);
     }
     
-    /* Insert the message */
-    pending_messages[insert_index] = message;
-    pending_message_count++;
+    atomic_store_explicit(&ring->enqueue_pos, 0, memory_order_relaxed);
+    ring->dequeue_pos = 0;
+}
+
+/**
+ * @brief Map a message priority onto a ring index
+ */
+static uint32_t priority_ring_index(QMessagePriority priority) {
+    if ((uint32_t)priority >= QMSG_PRIORITY_LEVELS) {
+        return QMSG_PRIORITY_LEVELS - 1;
+    }
     
-    return true;
+    return (uint32_t)priority;
+}
+
+/**
+ * @brief Add a message to the pending queue
+ *
+ * Safe to call concurrently from any number of producer threads.
+ */
+static bool add_to_pending_queue(QMessage* message) {
+    uint32_t level = priority_ring_index(message->header.priority);
+    PendingRing* ring = &pending_rings[level];
+    PriorityRecorder* priority = &priority_stats[level];
+    TypeRecorder* type = type_recorder(message->header.type);
+    uint64_t pos = atomic_load_explicit(&ring->enqueue_pos, memory_order_relaxed);
+    
+    ((PooledMessage*)message)->enqueue_ns = get_monotonic_ns();
+    
+    for (;;) {
+        PendingCell* cell = &ring->cells[pos & (MAX_PENDING_MESSAGES - 1)];
+        uint64_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        int64_t diff = (int64_t)(seq - pos);
+        
+        if (diff == 0) {
+            /* Cell is free at this position, try to claim it */
+            if (atomic_compare_exchange_weak_explicit(&ring->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                cell->message = message;
+                atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+                uint32_t pending = atomic_fetch_add_explicit(&pending_message_count, 1, memory_order_relaxed) + 1;
+                
+                uint32_t depth = atomic_fetch_add_explicit(&priority->depth, 1, memory_order_relaxed) + 1;
+                raise_high_water_u32(&priority->depth_high_water, depth);
+                raise_high_water_u32(&pending_high_water, pending);
+                atomic_fetch_add_explicit(&priority->enqueued, 1, memory_order_relaxed);
+                if (type) {
+                    atomic_fetch_add_explicit(&type->enqueued, 1, memory_order_relaxed);
+                }
+                TRACE_EVENT(TRACE_QBUS_ENQUEUE, TRACE_PHASE_INSTANT,
+                            message->header.message_id, message->header.type);
+                return true;
+            }
+            /* CAS failure reloaded pos, retry */
+        } else if (diff < 0) {
+            /* Ring for this priority level is full */
+            atomic_fetch_add_explicit(&priority->dropped, 1, memory_order_relaxed);
+            if (type) {
+                atomic_fetch_add_explicit(&type->dropped, 1, memory_order_relaxed);
+            }
+            return false;
+        } else {
+            /* Another producer claimed this cell, catch up */
+            pos = atomic_load_explicit(&ring->enqueue_pos, memory_order_relaxed);
+        }
+    }
+}
+
+/**
+ * @brief Remove and return the next message from a single ring
+ */
+static QMessage* dequeue_from_ring(PendingRing* ring) {
+    uint64_t pos = ring->dequeue_pos;
+    PendingCell* cell = &ring->cells[pos & (MAX_PENDING_MESSAGES - 1)];
+    uint64_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+    
+    if ((int64_t)(seq - (pos + 1)) < 0) {
+        /* Empty, or the producer has not yet published this cell */
+        return NULL;
+    }
+    
+    QMessage* message = cell->message;
+    cell->message = NULL;
+    atomic_store_explicit(&cell->sequence, pos + MAX_PENDING_MESSAGES, memory_order_release);
+    ring->dequeue_pos = pos + 1;
+    
+    return message;
 }
 
 /**
  * @brief Remove and return the next message from the pending queue
+ *
+ * Drains the highest priority level first. Messages of equal priority are
+ * returned in the order they were enqueued. Must only be called by the
+ * single consumer (the thread running qbus_process_messages).
  */
 static QMessage* remove_from_pending_queue(void) {
-    if (pending_message_count == 0) {
-        return NULL;
+    for (int level = QMSG_PRIORITY_LEVELS - 1; level >= 0; level--) {
+        QMessage* message = dequeue_from_ring(&pending_rings[level]);
+        if (message) {
+            atomic_fetch_sub_explicit(&pending_message_count, 1, memory_order_relaxed);
+            
+            /* Record enqueue to dispatch latency */
+            uint64_t waited = get_monotonic_ns() - ((PooledMessage*)message)->enqueue_ns;
+            PriorityRecorder* priority = &priority_stats[level];
+            atomic_fetch_sub_explicit(&priority->depth, 1, memory_order_relaxed);
+            atomic_fetch_add_explicit(&priority->dispatched, 1, memory_order_relaxed);
+            record_latency(&priority->latency, waited);
+            
+            TypeRecorder* type = type_recorder(message->header.type);
+            if (type) {
+                atomic_fetch_add_explicit(&type->dispatched, 1, memory_order_relaxed);
+                record_latency(&type->latency, waited);
+            }
+            TRACE_EVENT(TRACE_QBUS_DISPATCH, TRACE_PHASE_INSTANT,
+                        message->header.message_id, message->header.type);
+            return message;
+        }
     }
     
-    /* Get the next message (highest priority) */
-    QMessage* message = pending_messages[0];
+    return NULL;
+}
+
+/**
+ * @brief Invoke one subscriber for a group of messages
+ *
+ * Messages below the subscriber's resonance threshold, and broadcasts from
+ * the subscriber's own component, are filtered out. When batched is set and
+ * the subscriber has a batch handler, it receives the remaining messages as
+ * one span; otherwise each message goes to the handler on its own.
+ */
+static bool invoke_subscriber(QMessageHandler handler, QMessageBatchHandler batch_handler,
+                              void* context, NodeLevel min_resonance, QComponentId component_id,
+                              uint32_t slot, QMessage* const* messages, uint32_t count, bool batched) {
+    bool use_batch = batch_handler && (batched || !handler) && !workers_active;
+    uint32_t matched = 0;
+    
+    for (uint32_t i = 0; i < count; i++) {
+        QMessage* message = messages[i];
+        
+        /* Skip source component for broadcasts (remote sources are different components) */
+        if (message->header.destination == 0 && message->header.source == component_id &&
+            !((PooledMessage*)message)->remote_origin) {
+            continue;
+        }
+        
+        if (min_resonance > message->header.resonance_level) {
+            continue;
+        }
+        
+        if (workers_active) {
+            /* Route to the component's worker once the registry is unlocked */
+            if (routed_count < MAX_TOTAL_SUBSCRIPTIONS) {
+                atomic_fetch_add_explicit(&((PooledMessage*)message)->refs, 1, memory_order_relaxed);
+                routed_items[routed_count].message = message;
+                routed_items[routed_count].handler = handler;
+                routed_items[routed_count].batch_handler = batch_handler;
+                routed_items[routed_count].context = context;
+                routed_items[routed_count].slot = slot;
+                routed_count++;
+                matched++;
+            }
+        } else if (use_batch) {
+            batch_span[matched++] = message;
+        } else {
+            uint64_t started = get_monotonic_ns();
+            handler(message, context);
+            record_handler_time(slot, get_monotonic_ns() - started, 1);
+            matched++;
+        }
+    }
     
-    /* Shift remaining messages */
-    for (int i = 0; i < pending_message_count - 1; i++) {
-        pending_messages[i] = pending_messages[i + 1];
+    if (use_batch && matched > 0) {
+        uint64_t started = get_monotonic_ns();
+        batch_handler(batch_span, matched, context);
+        record_handler_time(slot, get_monotonic_ns() - started, matched);
     }
     
-    pending_message_count--;
-    return message;
+    return matched > 0;
 }
 
 /**
- * @brief Deliver a message to its destination(s)
+ * @brief Deliver a group of messages to their destination(s)
+ *
+ * All messages in the group share a destination and message type.
  */
-static bool deliver_message(const QMessage* message) {
+static bool deliver_group(QMessage* const* messages, uint32_t count, bool batched) {
     bool delivered = false;
+    QComponentId destination = messages[0]->header.destination;
+    QMessageType type = messages[0]->header.type;
+    
+    dispatch_depth++;
     
     /* Get destination component */
-    if (message->header.destination != 0) {
+    if (destination != 0) {
         /* Targeted message */
-        ComponentEntry* dest = find_component_entry(message->header.destination);
+        ComponentEntry* dest = find_component_entry(destination);
         if (!dest) {
-            printf("Cannot deliver message: destination component %u not found\n", message->header.destination);
+            printf("Cannot deliver message: destination component %u not found\n", destination);
+            dispatch_depth--;
             return false;
         }
         
@@ -181,51 +947,350 @@ static bool deliver_message(const QMessage* message) {
         for (uint32_t i = 0; i < dest->subscription_count; i++) {
             QSubscription* sub = &dest->subscriptions[i];
             
-            if ((sub->message_type == -1 || sub->message_type == message->header.type) &&
-                sub->min_resonance <= message->header.resonance_level) {
-                /* Call handler */
-                if (sub->handler) {
-                    /* Need to cast away const to match handler signature */
-                    sub->handler((QMessage*)message, sub->context);
-                    delivered = true;
-                }
+            if ((sub->message_type == -1 || sub->message_type == type) &&
+                (sub->handler || sub->batch_handler)) {
+                delivered |= invoke_subscriber(sub->handler, sub->batch_handler, sub->context,
+                                               sub->min_resonance, dest->info.id,
+                                               (uint32_t)(dest - components),
+                                               messages, count, batched);
             }
         }
     } else {
-        /* Broadcast message */
-        for (int i = 0; i < MAX_COMPONENTS; i++) {
-            if (components[i].registered) {
-                ComponentEntry* comp = &components[i];
-                
-                /* Skip source component */
-                if (comp->info.id == message->header.source) {
-                    continue;
-                }
-                
-                /* Check subscriptions */
-                for (uint32_t j = 0; j < comp->subscription_count; j++) {
-                    QSubscription* sub = &comp->subscriptions[j];
-                    
-                    if ((sub->message_type == -1 || sub->message_type == message->header.type) &&
-                        sub->min_resonance <= message->header.resonance_level) {
-                        /* Call handler */
-                        if (sub->handler) {
-                            /* Need to cast away const to match handler signature */
-                            sub->handler((QMessage*)message, sub->context);
-                            delivered = true;
-                        }
-                    }
-                }
+        /* Broadcast message: merge the typed and wildcard runs by order key */
+        const DispatchEntry* typed = NULL;
+        uint32_t typed_count = 0;
+        DispatchBucket* bucket = dispatch_lookup(type, false);
+        if (bucket) {
+            typed = &dispatch_entries[bucket->first];
+            typed_count = bucket->count;
+        }
+        
+        const DispatchEntry* wildcard = &dispatch_entries[dispatch_wildcard_first];
+        uint32_t wildcard_count = dispatch_wildcard_count;
+        uint32_t t = 0;
+        uint32_t w = 0;
+        
+        while (t < typed_count || w < wildcard_count) {
+            const DispatchEntry* entry;
+            if (w >= wildcard_count || (t < typed_count && typed[t].order < wildcard[w].order)) {
+                entry = &typed[t++];
+            } else {
+                entry = &wildcard[w++];
             }
+            
+            delivered |= invoke_subscriber(entry->handler, entry->batch_handler, entry->context,
+                                           entry->min_resonance, entry->component_id, entry->slot,
+                                           messages, count, batched);
         }
     }
     
-    /* Propagate to entangled buses */
-    /* In a real implementation, this would send the message to remote buses */
+    dispatch_depth--;
+    if (dispatch_depth == 0 && dispatch_dirty) {
+        rebuild_dispatch_index();
+    }
+    
+    /* Propagate locally originated messages to entangled buses */
+    if (remote_forwarder) {
+        for (uint32_t e = 0; e < MAX_BUS_ENTANGLEMENTS; e++) {
+            BusEntanglement* entanglement = &bus_entanglements[e];
+            if (entanglement->id == 0 || !entanglement->is_synchronized) {
+                continue;
+            }
+            
+            for (uint32_t i = 0; i < count; i++) {
+                if (!((PooledMessage*)messages[i])->remote_origin &&
+                    messages[i]->header.resonance_level >= entanglement->resonance_level) {
+                    remote_forwarder(entanglement->remote_bus_id, messages[i], remote_forwarder_context);
+                }
+            }
+        }
+    }
     
     return delivered;
 }
 
+/**
+ * @brief Deliver a message to its destination(s)
+ */
+static bool deliver_message(QMessage* message) {
+    return deliver_group(&message, 1, false);
+}
+
+/**
+ * @brief Group a window of messages by destination and type
+ *
+ * Performs a stable counting sort of batch_window into batch_sorted and
+ * fills batch_group_offset with the start of each group.
+ *
+ * @return Number of groups
+ */
+static uint32_t group_batch_window(uint32_t count) {
+    uint32_t group_count = 0;
+    
+    memset(batch_group_table, 0, sizeof(batch_group_table));
+    memset(batch_group_offset, 0, sizeof(batch_group_offset));
+    
+    /* Assign group IDs in order of first appearance */
+    for (uint32_t i = 0; i < count; i++) {
+        QMessageHeader* header = &batch_window[i]->header;
+        uint32_t slot = (((uint32_t)header->destination * 31u + (uint32_t)header->type) * 2654435761u) &
+                        (QBUS_BATCH_GROUP_TABLE - 1);
+        
+        while (batch_group_table[slot].used &&
+               (batch_group_table[slot].destination != header->destination ||
+                batch_group_table[slot].type != header->type)) {
+            slot = (slot + 1) & (QBUS_BATCH_GROUP_TABLE - 1);
+        }
+        
+        if (!batch_group_table[slot].used) {
+            batch_group_table[slot].used = true;
+            batch_group_table[slot].destination = header->destination;
+            batch_group_table[slot].type = header->type;
+            batch_group_table[slot].group = group_count++;
+        }
+        
+        batch_group_of[i] = batch_group_table[slot].group;
+        batch_group_offset[batch_group_of[i] + 1]++;
+    }
+    
+    /* Prefix sum into group start offsets, then scatter */
+    for (uint32_t g = 0; g < group_count; g++) {
+        batch_group_offset[g + 1] += batch_group_offset[g];
+    }
+    
+    uint32_t fill[QBUS_BATCH_WINDOW];
+    memcpy(fill, batch_group_offset, group_count * sizeof(uint32_t));
+    for (uint32_t i = 0; i < count; i++) {
+        batch_sorted[fill[batch_group_of[i]]++] = batch_window[i];
+    }
+    
+    return group_count;
+}
+
+/**
+ * @brief Get the worker that owns a component slot
+ */
+static uint32_t component_worker(uint32_t slot) {
+    int32_t affinity = components[slot].worker_affinity;
+    if (affinity >= 0) {
+        return (uint32_t)affinity % worker_config.worker_count;
+    }
+    
+    return slot % worker_config.worker_count;
+}
+
+/**
+ * @brief Account for a finished or dropped delivery
+ */
+static void finish_delivery(DeliveryItem* item) {
+    qbus_free_message(item->message);
+    
+    if (atomic_fetch_sub_explicit(&worker_inflight, 1, memory_order_acq_rel) == 1) {
+        pthread_mutex_lock(&worker_idle_lock);
+        pthread_cond_broadcast(&worker_idle);
+        pthread_mutex_unlock(&worker_idle_lock);
+    }
+}
+
+/**
+ * @brief Pop the oldest delivery from an inbox
+ *
+ * Caller must hold the owning worker's lock.
+ */
+static void pop_inbox(ComponentInbox* inbox, BusWorker* worker, DeliveryItem* out) {
+    *out = inbox->items[inbox->head];
+    inbox->head = (inbox->head + 1) % worker_config.inbox_capacity;
+    inbox->count--;
+    atomic_fetch_sub_explicit(&worker->pending, 1, memory_order_relaxed);
+    pthread_cond_broadcast(&worker->space_available);
+}
+
+/**
+ * @brief Queue a delivery on a component's inbox, applying back-pressure
+ */
+static void enqueue_delivery(uint32_t slot, DeliveryItem* item) {
+    ComponentInbox* inbox = &component_inboxes[slot];
+    BusWorker* worker = &bus_workers[inbox->worker];
+    
+    atomic_fetch_add_explicit(&worker_inflight, 1, memory_order_relaxed);
+    pthread_mutex_lock(&worker->lock);
+    
+    while (inbox->count >= worker_config.inbox_capacity) {
+        if (worker_config.backpressure == QBUS_BACKPRESSURE_DROP_OLDEST) {
+            DeliveryItem oldest;
+            pop_inbox(inbox, worker, &oldest);
+            pthread_mutex_unlock(&worker->lock);
+            atomic_fetch_add_explicit(&component_stats[slot].inbox_dropped, 1, memory_order_relaxed);
+            finish_delivery(&oldest);
+            pthread_mutex_lock(&worker->lock);
+        } else if (worker_config.backpressure == QBUS_BACKPRESSURE_BLOCK && worker->running) {
+            pthread_cond_wait(&worker->space_available, &worker->lock);
+        } else {
+            /* Drop the incoming delivery */
+            pthread_mutex_unlock(&worker->lock);
+            atomic_fetch_add_explicit(&component_stats[slot].inbox_dropped, 1, memory_order_relaxed);
+            finish_delivery(item);
+            return;
+        }
+    }
+    
+    inbox->items[(inbox->head + inbox->count) % worker_config.inbox_capacity] = *item;
+    inbox->count++;
+    atomic_fetch_add_explicit(&worker->pending, 1, memory_order_relaxed);
+    
+    if (!inbox->queued) {
+        worker->ready[(worker->ready_head + worker->ready_count) % MAX_COMPONENTS] = slot;
+        worker->ready_count++;
+        inbox->queued = true;
+    }
+    
+    pthread_cond_signal(&worker->work_available);
+    pthread_mutex_unlock(&worker->lock);
+}
+
+/**
+ * @brief Hand deliveries routed by the pump to the workers
+ */
+static void flush_routed_deliveries(void) {
+    for (uint32_t i = 0; i < routed_count; i++) {
+        enqueue_delivery(routed_items[i].slot, &routed_items[i]);
+    }
+    
+    routed_count = 0;
+}
+
+/**
+ * @brief Take the next delivery from a worker's own components
+ */
+static bool take_own_delivery(BusWorker* worker, DeliveryItem* out) {
+    pthread_mutex_lock(&worker->lock);
+    
+    while (worker->ready_count > 0) {
+        uint32_t slot = worker->ready[worker->ready_head];
+        worker->ready_head = (worker->ready_head + 1) % MAX_COMPONENTS;
+        worker->ready_count--;
+        
+        ComponentInbox* inbox = &component_inboxes[slot];
+        if (inbox->count == 0) {
+            /* Emptied by a thief or by unregistration */
+            inbox->queued = false;
+            continue;
+        }
+        
+        pop_inbox(inbox, worker, out);
+        
+        /* Rotate so components sharing this worker take turns */
+        if (inbox->count > 0) {
+            worker->ready[(worker->ready_head + worker->ready_count) % MAX_COMPONENTS] = slot;
+            worker->ready_count++;
+        } else {
+            inbox->queued = false;
+        }
+        
+        pthread_mutex_unlock(&worker->lock);
+        return true;
+    }
+    
+    pthread_mutex_unlock(&worker->lock);
+    return false;
+}
+
+/**
+ * @brief Steal a delivery for a reentrant component from the busiest peer
+ */
+static bool steal_delivery(BusWorker* self, DeliveryItem* out) {
+    BusWorker* victim = NULL;
+    uint32_t most_pending = 0;
+    
+    for (uint32_t w = 0; w < worker_config.worker_count; w++) {
+        uint32_t pending = atomic_load_explicit(&bus_workers[w].pending, memory_order_relaxed);
+        if (&bus_workers[w] != self && pending > most_pending) {
+            most_pending = pending;
+            victim = &bus_workers[w];
+        }
+    }
+    
+    if (!victim || pthread_mutex_trylock(&victim->lock) != 0) {
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < victim->ready_count; i++) {
+        uint32_t slot = victim->ready[(victim->ready_head + i) % MAX_COMPONENTS];
+        ComponentInbox* inbox = &component_inboxes[slot];
+        
+        if (components[slot].reentrant && inbox->count > 0) {
+            pop_inbox(inbox, victim, out);
+            pthread_mutex_unlock(&victim->lock);
+            return true;
+        }
+    }
+    
+    pthread_mutex_unlock(&victim->lock);
+    return false;
+}
+
+/**
+ * @brief Delivery worker thread
+ */
+static void* bus_worker_main(void* arg) {
+    BusWorker* self = (BusWorker*)arg;
+    DeliveryItem item;
+    
+    for (;;) {
+        if (take_own_delivery(self, &item) || steal_delivery(self, &item)) {
+            uint64_t started = get_monotonic_ns();
+            if (item.handler) {
+                item.handler(item.message, item.context);
+            } else {
+                item.batch_handler(&item.message, 1, item.context);
+            }
+            record_handler_time(item.slot, get_monotonic_ns() - started, 1);
+            
+            finish_delivery(&item);
+            continue;
+        }
+        
+        pthread_mutex_lock(&self->lock);
+        if (!self->running && self->ready_count == 0) {
+            pthread_mutex_unlock(&self->lock);
+            break;
+        }
+        
+        if (self->ready_count == 0) {
+            /* Sleep briefly, then look for work to steal again */
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += QBUS_WORKER_IDLE_WAIT_NS;
+            if (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&self->work_available, &self->lock, &deadline);
+        }
+        pthread_mutex_unlock(&self->lock);
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief Discard the queued deliveries of a component slot
+ */
+static void discard_inbox(uint32_t slot) {
+    ComponentInbox* inbox = &component_inboxes[slot];
+    BusWorker* worker = &bus_workers[inbox->worker];
+    
+    pthread_mutex_lock(&worker->lock);
+    while (inbox->count > 0) {
+        DeliveryItem item;
+        pop_inbox(inbox, worker, &item);
+        pthread_mutex_unlock(&worker->lock);
+        finish_delivery(&item);
+        pthread_mutex_lock(&worker->lock);
+    }
+    pthread_mutex_unlock(&worker->lock);
+}
+
 /**
  * @brief Initialize the Quantum Message Bus
  */
@@ -236,13 +1301,23 @@ bool qbus_init(void) {
     
     /* Initialize component table */
     memset(components, 0, sizeof(components));
+    for (int i = 0; i < MAX_COMPONENTS; i++) {
+        components[i].worker_affinity = -1;
+    }
+    
+    /* Initialize dispatch index */
+    dispatch_depth = 0;
+    rebuild_dispatch_index();
     
     /* Initialize bus entanglement table */
     memset(bus_entanglements, 0, sizeof(bus_entanglements));
     
     /* Initialize pending message queue */
-    memset(pending_messages, 0, sizeof(pending_messages));
-    pending_message_count = 0;
+    for (int level = 0; level < QMSG_PRIORITY_LEVELS; level++) {
+        reset_pending_ring(&pending_rings[level]);
+    }
+    atomic_store(&pending_message_count, 0);
+    qbus_reset_stats();
     
     qbus_initialized = true;
     printf("Quantum Message Bus initialized\n");
@@ -258,16 +1333,25 @@ void qbus_shutdown(void) {
         return;
     }
     
+    /* Let workers finish queued deliveries */
+    qbus_stop_workers();
+    
     /* Free all pending messages */
-    for (uint32_t i = 0; i < pending_message_count; i++) {
-        qbus_free_message(pending_messages[i]);
+    QMessage* pending;
+    while ((pending = remove_from_pending_queue()) != NULL) {
+        qbus_free_message(pending);
     }
     
     /* Reset state */
     memset(components, 0, sizeof(components));
     memset(bus_entanglements, 0, sizeof(bus_entanglements));
-    memset(pending_messages, 0, sizeof(pending_messages));
-    pending_message_count = 0;
+    dispatch_depth = 0;
+    rebuild_dispatch_index();
+    for (int level = 0; level < QMSG_PRIORITY_LEVELS; level++) {
+        reset_pending_ring(&pending_rings[level]);
+        atomic_store(&priority_stats[level].depth, 0);
+    }
+    atomic_store(&pending_message_count, 0);
     
     qbus_initialized = false;
     printf("Quantum Message Bus shutdown complete\n");
@@ -275,8 +1359,10 @@ void qbus_shutdown(void) {
 
 /**
  * @brief Register a component with the message bus
+ *
+ * Caller must hold the registry lock.
  */
-bool qbus_register_component(const QComponentInfo* info) {
+static bool register_component_locked(const QComponentInfo* info) {
     if (!qbus_initialized || !info) {
         return false;
     }
@@ -299,6 +1385,19 @@ bool qbus_register_component(const QComponentInfo* info) {
     slot->info = *info;
     slot->registered = true;
     slot->subscription_count = 0;
+    slot->worker_affinity = -1;
+    slot->reentrant = false;
+    
+    /* Start the slot's handler statistics afresh */
+    ComponentRecorder* recorder = &component_stats[slot - components];
+    memset(&recorder->handler_time, 0, sizeof(recorder->handler_time));
+    atomic_store_explicit(&recorder->invocations, 0, memory_order_relaxed);
+    atomic_store_explicit(&recorder->inbox_dropped, 0, memory_order_relaxed);
+    atomic_store_explicit(&recorder->component_id, (uint32_t)info->id, memory_order_relaxed);
+    
+    if (workers_active) {
+        component_inboxes[slot - components].worker = component_worker((uint32_t)(slot - components));
+    }
     
     printf("Registered component: %s (ID: %u)\n", info->name, info->id);
     
@@ -314,10 +1413,23 @@ bool qbus_register_component(const QComponentInfo* info) {
     return true;
 }
 
+/**
+ * @brief Register a component with the message bus
+ */
+bool qbus_register_component(const QComponentInfo* info) {
+    lock_registry();
+    bool result = register_component_locked(info);
+    unlock_registry();
+    
+    return result;
+}
+
 /**
  * @brief Unregister a component from the message bus
+ *
+ * Caller must hold the registry lock.
  */
-bool qbus_unregister_component(QComponentId component_id) {
+static bool unregister_component_locked(QComponentId component_id) {
     if (!qbus_initialized) {
         return false;
     }
@@ -340,16 +1452,36 @@ bool qbus_unregister_component(QComponentId component_id) {
     /* Mark as unregistered */
     component->registered = false;
     component->subscription_count = 0;
+    rebuild_dispatch_index();
+    atomic_store_explicit(&component_stats[component - components].component_id, QCOMP_UNKNOWN,
+                          memory_order_relaxed);
+    
+    if (workers_active) {
+        discard_inbox((uint32_t)(component - components));
+    }
     
     printf("Unregistered component: %s (ID: %u)\n", component->info.name, component_id);
     
     return true;
 }
 
+/**
+ * @brief Unregister a component from the message bus
+ */
+bool qbus_unregister_component(QComponentId component_id) {
+    lock_registry();
+    bool result = unregister_component_locked(component_id);
+    unlock_registry();
+    
+    return result;
+}
+
 /**
  * @brief Subscribe to message types
+ *
+ * Caller must hold the registry lock.
  */
-bool qbus_subscribe(const QSubscription* subscription) {
+static bool subscribe_locked(const QSubscription* subscription) {
     if (!qbus_initialized || !subscription) {
         return false;
     }
@@ -370,14 +1502,28 @@ bool qbus_subscribe(const QSubscription* subscription) {
     /* Add the subscription */
     component->subscriptions[component->subscription_count] = *subscription;
     component->subscription_count++;
+    rebuild_dispatch_index();
     
     return true;
 }
 
+/**
+ * @brief Subscribe to message types
+ */
+bool qbus_subscribe(const QSubscription* subscription) {
+    lock_registry();
+    bool result = subscribe_locked(subscription);
+    unlock_registry();
+    
+    return result;
+}
+
 /**
  * @brief Unsubscribe from message types
+ *
+ * Caller must hold the registry lock.
  */
-bool qbus_unsubscribe(QComponentId component_id, QMessageType message_type, QMessageHandler handler) {
+static bool unsubscribe_locked(QComponentId component_id, QMessageType message_type, QMessageHandler handler) {
     if (!qbus_initialized) {
         return false;
     }
@@ -407,9 +1553,24 @@ bool qbus_unsubscribe(QComponentId component_id, QMessageType message_type, QMes
         }
     }
     
+    if (found) {
+        rebuild_dispatch_index();
+    }
+    
     return found;
 }
 
+/**
+ * @brief Unsubscribe from message types
+ */
+bool qbus_unsubscribe(QComponentId component_id, QMessageType message_type, QMessageHandler handler) {
+    lock_registry();
+    bool result = unsubscribe_locked(component_id, message_type, handler);
+    unlock_registry();
+    
+    return result;
+}
+
 /**
  * @brief Send a message
  */
@@ -418,16 +1579,32 @@ bool qbus_send_message(const QMessage* message) {
         return false;
     }
     
-    /* Create a copy of the message */
-    QMessage* message_copy = qbus_create_message(
-        message->header.type,
-        message->header.source,
-        message->header.destination,
-        message->data,
-        message->header.data_size,
-        message->header.priority,
-        message->header.requires_response
-    );
+    /* Create a copy of the message, sharing the payload if it is buffer-backed */
+    QMessage* message_copy;
+    if (message->buffer) {
+        message_copy = qbus_create_buffer_message(
+            message->header.type,
+            message->header.source,
+            message->header.destination,
+            qbus_buffer_retain(message->buffer),
+            message->header.priority,
+            message->header.requires_response
+        );
+        
+        if (!message_copy) {
+            qbus_buffer_release(message->buffer);
+        }
+    } else {
+        message_copy = qbus_create_message(
+            message->header.type,
+            message->header.source,
+            message->header.destination,
+            message->data,
+            message->header.data_size,
+            message->header.priority,
+            message->header.requires_response
+        );
+    }
     
     if (!message_copy) {
         return false;
@@ -446,29 +1623,41 @@ bool qbus_send_message(const QMessage* message) {
 }
 
 /**
- * @brief Create a new message
+ * @brief Allocate and initialize a message header
  */
-QMessage* qbus_create_message(QMessageType type, QComponentId source, QComponentId destination,
-                           const void* data, uint32_t data_size, QMessagePriority priority,
-                           bool requires_response) {
+static QMessage* init_message(QMessageType type, QComponentId source, QComponentId destination,
+                              uint32_t payload_size, QMessagePriority priority,
+                              bool requires_response) {
     if (!qbus_initialized) {
         return NULL;
     }
     
-    /* Validate source component */
-    if (source != 0 && !find_component_entry(source)) {
-        printf("Cannot create message: source component %u not registered\n", source);
-        return NULL;
+    /* Validate source component, copying its level out while the entry is stable */
+    NodeLevel resonance_level = NODE_ZERO_POINT;
+    if (source != 0) {
+        lock_registry();
+        ComponentEntry* source_comp = find_component_entry(source);
+        if (source_comp) {
+            resonance_level = source_comp->info.resonance_level;
+        }
+        unlock_registry();
+        
+        if (!source_comp) {
+            printf("Cannot create message: source component %u not registered\n", source);
+            return NULL;
+        }
     }
     
-    /* Allocate message structure */
-    QMessage* message = (QMessage*)malloc(sizeof(QMessage));
-    if (!message) {
+    /* Allocate message block */
+    PooledMessage* block = alloc_message_block(payload_size);
+    if (!block) {
         return NULL;
     }
     
+    QMessage* message = &block->message;
+    
     /* Initialize message header */
-    message->header.message_id = next_message_id++;
+    message->header.message_id = atomic_fetch_add_explicit(&next_message_id, 1, memory_order_relaxed);
     message->header.type = type;
     message->header.source = source;
     message->header.destination = destination;
@@ -476,114 +1665,385 @@ QMessage* qbus_create_message(QMessageType type, QComponentId source, QComponent
     message->header.timestamp = get_timestamp_ns();
     message->header.requires_response = requires_response;
     message->header.response_to = 0;
-    message->header.data_size = data_size;
+    message->header.data_size = 0;
+    message->data = NULL;
+    message->buffer = NULL;
+    block->remote_origin = false;
     
     /* Set resonance level based on source component */
-    if (source != 0) {
-        ComponentEntry* source_comp = find_component_entry(source);
-        message->header.resonance_level = source_comp->info.resonance_level;
-    } else {
-        message->header.resonance_level = NODE_ZERO_POINT;
-    }
-    
-    /* Allocate and copy data if provided */
-    if (data && data_size > 0) {
-        message->data = malloc(data_size);
-        if (!message->data) {
-            free(message);
-            return NULL;
-        }
-        
-        memcpy(message->data, data, data_size);
-    } else {
-        message->data = NULL;
-    }
+    message->header.resonance_level = resonance_level;
     
     return message;
 }
 
 /**
- * @brief Create a response message
+ * @brief Create a new message
  */
-QMessage* qbus_create_response(const QMessage* original_message, const void* data,
-                             uint32_t data_size, QMessagePriority priority) {
-    if (!qbus_initialized || !original_message) {
+QMessage* qbus_create_message(QMessageType type, QComponentId source, QComponentId destination,
+                           const void* data, uint32_t data_size, QMessagePriority priority,
+                           bool requires_response) {
+    uint32_t payload_size = (data && data_size > 0) ? data_size : 0;
+    QMessage* message = init_message(type, source, destination, payload_size, priority,
+                                     requires_response);
+    if (!message) {
         return NULL;
     }
     
-    /* Create a new message */
-    QMessage* response = qbus_create_message(
-        original_message->header.type,
-        original_message->header.destination, /* Swap source and destination */
-        original_message->header.source,       /* Swap source and destination */
-        data,
-        data_size,
-        priority,
-        false /* Response doesn't require another response */
-    );
+    message->header.data_size = data_size;
     
-    if (!response) {
-        return NULL;
+    /* Copy data into the inline payload if provided */
+    if (payload_size > 0) {
+        message->data = ((PooledMessage*)message)->payload;
+        memcpy(message->data, data, data_size);
     }
     
-    /* Set response_to to the original message ID */
-    response->header.response_to = original_message->header.message_id;
-    
-    return response;
+    return message;
 }
 
 /**
- * @brief Free a message
+ * @brief Create a message that references a shared buffer
  */
-void qbus_free_message(QMessage* message) {
-    if (!message) {
-        return;
+QMessage* qbus_create_buffer_message(QMessageType type, QComponentId source, QComponentId destination,
+                                   QMessageBuffer* buffer, QMessagePriority priority,
+                                   bool requires_response) {
+    if (!buffer) {
+        return NULL;
     }
     
-    /* Free data if present */
-    if (message->data) {
-        free(message->data);
+    QMessage* message = init_message(type, source, destination, 0, priority, requires_response);
+    if (!message) {
+        return NULL;
     }
     
-    /* Free message structure */
-    free(message);
+    message->buffer = buffer;
+    message->data = buffer->data;
+    message->header.data_size = buffer->size;
+    
+    return message;
 }
 
 /**
- * @brief Process pending messages
+ * @brief Queue a message received from an entangled remote bus
  */
-uint32_t qbus_process_messages(uint32_t max_messages) {
-    if (!qbus_initialized) {
-        return 0;
+bool qbus_deliver_remote_message(const QMessageHeader* header, const void* data) {
+    if (!qbus_initialized || !header) {
+        return false;
     }
     
-    uint32_t processed = 0;
-    uint32_t limit = (max_messages > 0) ? max_messages : pending_message_count;
+    uint32_t payload_size = (data && header->data_size > 0) ? header->data_size : 0;
+    PooledMessage* block = alloc_message_block(payload_size);
+    if (!block) {
+        return false;
+    }
     
-    while (processed < limit && pending_message_count > 0) {
-        /* Get the next message */
-        QMessage* message = remove_from_pending_queue();
-        if (!message) {
-            break;
-        }
-        
-        /* Deliver the message */
-        deliver_message(message);
-        
-        /* Free the message */
+    /* Keep the remote header as sent; the source is not a local component */
+    QMessage* message = &block->message;
+    message->header = *header;
+    message->header.data_size = payload_size;
+    message->data = NULL;
+    message->buffer = NULL;
+    block->remote_origin = true;
+    
+    if (payload_size > 0) {
+        message->data = block->payload;
+        memcpy(message->data, data, payload_size);
+    }
+    
+    if (!add_to_pending_queue(message)) {
         qbus_free_message(message);
-        
-        processed++;
+        return false;
     }
     
-    return processed;
+    return true;
 }
 
 /**
- * @brief Find a component by ID
+ * @brief Check whether a message arrived from an entangled remote bus
  */
-bool qbus_find_component(QComponentId component_id, QComponentInfo* info) {
-    if (!qbus_initialized || !info) {
+bool qbus_message_is_remote(const QMessage* message) {
+    return message && ((const PooledMessage*)message)->remote_origin;
+}
+
+/**
+ * @brief Set the transport used to reach entangled remote buses
+ */
+void qbus_set_remote_forwarder(QRemoteForwarder forwarder, void* context) {
+    lock_registry();
+    remote_forwarder = forwarder;
+    remote_forwarder_context = context;
+    unlock_registry();
+}
+
+/**
+ * @brief Send several messages
+ */
+uint32_t qbus_send_batch(const QMessage* const* messages, uint32_t count) {
+    if (!qbus_initialized || !messages) {
+        return 0;
+    }
+    
+    uint32_t sent = 0;
+    while (sent < count && qbus_send_message(messages[sent])) {
+        sent++;
+    }
+    
+    return sent;
+}
+
+/**
+ * @brief Send a shared buffer without copying its contents
+ */
+bool qbus_send_buffer(QMessageType type, QComponentId source, QComponentId destination,
+                      QMessageBuffer* buffer, QMessagePriority priority, bool requires_response) {
+    QMessage* message = qbus_create_buffer_message(type, source, destination, buffer, priority,
+                                                 requires_response);
+    if (!message) {
+        return false;
+    }
+    
+    if (!add_to_pending_queue(message)) {
+        /* Hand the reference back to the caller */
+        message->buffer = NULL;
+        qbus_free_message(message);
+        return false;
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Create a response message
+ */
+QMessage* qbus_create_response(const QMessage* original_message, const void* data,
+                             uint32_t data_size, QMessagePriority priority) {
+    if (!qbus_initialized || !original_message) {
+        return NULL;
+    }
+    
+    /* Create a new message */
+    QMessage* response = qbus_create_message(
+        original_message->header.type,
+        original_message->header.destination, /* Swap source and destination */
+        original_message->header.source,       /* Swap source and destination */
+        data,
+        data_size,
+        priority,
+        false /* Response doesn't require another response */
+    );
+    
+    if (!response) {
+        return NULL;
+    }
+    
+    /* Set response_to to the original message ID */
+    response->header.response_to = original_message->header.message_id;
+    
+    return response;
+}
+
+/**
+ * @brief Free a message
+ */
+void qbus_free_message(QMessage* message) {
+    if (!message) {
+        return;
+    }
+    
+    /* Workers may still hold deliveries of this message */
+    if (atomic_fetch_sub_explicit(&((PooledMessage*)message)->refs, 1, memory_order_acq_rel) != 1) {
+        return;
+    }
+    
+    /* Drop the shared buffer reference; inline payloads go with the block */
+    if (message->buffer) {
+        qbus_buffer_release(message->buffer);
+    }
+    
+    /* Return the message block to its pool */
+    free_message_block((PooledMessage*)message);
+}
+
+/**
+ * @brief Allocate a reference-counted payload buffer
+ */
+QMessageBuffer* qbus_buffer_create(uint32_t size) {
+    QMessageBuffer* buffer = (QMessageBuffer*)malloc(sizeof(QMessageBuffer) + size);
+    if (!buffer) {
+        return NULL;
+    }
+    
+    atomic_init(&buffer->refcount, 1);
+    buffer->size = size;
+    buffer->data = buffer->inline_data;
+    buffer->release = NULL;
+    buffer->release_context = NULL;
+    
+    return buffer;
+}
+
+/**
+ * @brief Wrap caller-owned memory in a reference-counted payload buffer
+ */
+QMessageBuffer* qbus_buffer_wrap(void* data, uint32_t size, QBufferReleaseFn release, void* context) {
+    if (!data && size > 0) {
+        return NULL;
+    }
+    
+    QMessageBuffer* buffer = (QMessageBuffer*)malloc(sizeof(QMessageBuffer));
+    if (!buffer) {
+        return NULL;
+    }
+    
+    atomic_init(&buffer->refcount, 1);
+    buffer->size = size;
+    buffer->data = data;
+    buffer->release = release;
+    buffer->release_context = context;
+    
+    return buffer;
+}
+
+/**
+ * @brief Add a reference to a payload buffer
+ */
+QMessageBuffer* qbus_buffer_retain(QMessageBuffer* buffer) {
+    if (buffer) {
+        atomic_fetch_add_explicit(&buffer->refcount, 1, memory_order_relaxed);
+    }
+    
+    return buffer;
+}
+
+/**
+ * @brief Drop a reference to a payload buffer, freeing it on the last one
+ */
+void qbus_buffer_release(QMessageBuffer* buffer) {
+    if (!buffer) {
+        return;
+    }
+    
+    if (atomic_fetch_sub_explicit(&buffer->refcount, 1, memory_order_acq_rel) != 1) {
+        return;
+    }
+    
+    if (buffer->release) {
+        buffer->release(buffer->data, buffer->release_context);
+    }
+    
+    free(buffer);
+}
+
+/**
+ * @brief Get the memory of a payload buffer
+ */
+void* qbus_buffer_data(const QMessageBuffer* buffer) {
+    return buffer ? buffer->data : NULL;
+}
+
+/**
+ * @brief Get the size of a payload buffer
+ */
+uint32_t qbus_buffer_size(const QMessageBuffer* buffer) {
+    return buffer ? buffer->size : 0;
+}
+
+/**
+ * @brief Process pending messages
+ */
+uint32_t qbus_process_messages(uint32_t max_messages) {
+    if (!qbus_initialized) {
+        return 0;
+    }
+    
+    uint32_t processed = 0;
+    uint32_t limit = (max_messages > 0) ? max_messages
+                                        : atomic_load_explicit(&pending_message_count, memory_order_relaxed);
+    
+    while (processed < limit) {
+        /* Get the next message */
+        QMessage* message = remove_from_pending_queue();
+        if (!message) {
+            break;
+        }
+        
+        /* Deliver the message, or route it to the workers */
+        lock_registry();
+        deliver_message(message);
+        unlock_registry();
+        flush_routed_deliveries();
+        
+        /* Free the message */
+        qbus_free_message(message);
+        
+        processed++;
+    }
+    
+    return processed;
+}
+
+/**
+ * @brief Process pending messages in batches
+ */
+uint32_t qbus_process_message_batches(uint32_t max_messages) {
+    if (!qbus_initialized) {
+        return 0;
+    }
+    
+    /* Workers receive deliveries one message at a time */
+    if (workers_active) {
+        return qbus_process_messages(max_messages);
+    }
+    
+    uint32_t processed = 0;
+    uint32_t limit = (max_messages > 0) ? max_messages
+                                        : atomic_load_explicit(&pending_message_count, memory_order_relaxed);
+    
+    while (processed < limit) {
+        /* Fill a window in priority order */
+        uint32_t window = 0;
+        uint32_t want = limit - processed;
+        if (want > QBUS_BATCH_WINDOW) {
+            want = QBUS_BATCH_WINDOW;
+        }
+        
+        while (window < want) {
+            QMessage* message = remove_from_pending_queue();
+            if (!message) {
+                break;
+            }
+            batch_window[window++] = message;
+        }
+        
+        if (window == 0) {
+            break;
+        }
+        
+        /* Deliver one group at a time */
+        uint32_t group_count = group_batch_window(window);
+        lock_registry();
+        for (uint32_t g = 0; g < group_count; g++) {
+            uint32_t first = batch_group_offset[g];
+            deliver_group(&batch_sorted[first], batch_group_offset[g + 1] - first, true);
+        }
+        unlock_registry();
+        
+        for (uint32_t i = 0; i < window; i++) {
+            qbus_free_message(batch_sorted[i]);
+        }
+        
+        processed += window;
+    }
+    
+    return processed;
+}
+
+/**
+ * @brief Find a component by ID
+ *
+ * Caller must hold the registry lock.
+ */
+static bool find_component_locked(QComponentId component_id, QComponentInfo* info) {
+    if (!qbus_initialized || !info) {
         return false;
     }
     
@@ -598,10 +2058,23 @@ bool qbus_find_component(QComponentId component_id, QComponentInfo* info) {
     return true;
 }
 
+/**
+ * @brief Find a component by ID
+ */
+bool qbus_find_component(QComponentId component_id, QComponentInfo* info) {
+    lock_registry();
+    bool result = find_component_locked(component_id, info);
+    unlock_registry();
+    
+    return result;
+}
+
 /**
  * @brief Set a component's resonance level
+ *
+ * Caller must hold the registry lock.
  */
-bool qbus_set_component_resonance(QComponentId component_id, NodeLevel resonance_level) {
+static bool set_component_resonance_locked(QComponentId component_id, NodeLevel resonance_level) {
     if (!qbus_initialized) {
         return false;
     }
@@ -617,10 +2090,208 @@ bool qbus_set_component_resonance(QComponentId component_id, NodeLevel resonance
     return true;
 }
 
+/**
+ * @brief Set a component's resonance level
+ */
+bool qbus_set_component_resonance(QComponentId component_id, NodeLevel resonance_level) {
+    lock_registry();
+    bool result = set_component_resonance_locked(component_id, resonance_level);
+    unlock_registry();
+    
+    return result;
+}
+
+/**
+ * @brief Start delivering messages on a pool of worker threads
+ */
+bool qbus_start_workers(const QWorkerPoolConfig* config) {
+    if (!qbus_initialized || !config || config->worker_count == 0 ||
+        config->worker_count > QBUS_MAX_WORKERS) {
+        return false;
+    }
+    
+    lock_registry();
+    if (workers_active || bus_workers) {
+        /* Already running, or still being stopped */
+        unlock_registry();
+        return false;
+    }
+    
+    worker_config = *config;
+    if (worker_config.inbox_capacity == 0) {
+        worker_config.inbox_capacity = QBUS_DEFAULT_INBOX_CAPACITY;
+    }
+    
+    bus_workers = (BusWorker*)calloc(worker_config.worker_count, sizeof(BusWorker));
+    inbox_storage = (DeliveryItem*)calloc((size_t)MAX_COMPONENTS * worker_config.inbox_capacity,
+                                          sizeof(DeliveryItem));
+    if (!bus_workers || !inbox_storage) {
+        free(bus_workers);
+        free(inbox_storage);
+        bus_workers = NULL;
+        inbox_storage = NULL;
+        unlock_registry();
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < MAX_COMPONENTS; i++) {
+        component_inboxes[i].items = &inbox_storage[(size_t)i * worker_config.inbox_capacity];
+        component_inboxes[i].head = 0;
+        component_inboxes[i].count = 0;
+        component_inboxes[i].queued = false;
+        component_inboxes[i].worker = component_worker(i);
+    }
+    
+    uint32_t started = 0;
+    for (; started < worker_config.worker_count; started++) {
+        BusWorker* worker = &bus_workers[started];
+        pthread_mutex_init(&worker->lock, NULL);
+        pthread_cond_init(&worker->work_available, NULL);
+        pthread_cond_init(&worker->space_available, NULL);
+        atomic_init(&worker->pending, 0);
+        worker->running = true;
+        
+        if (pthread_create(&worker->thread, NULL, bus_worker_main, worker) != 0) {
+            break;
+        }
+    }
+    
+    if (started < worker_config.worker_count) {
+        /* Unwind the workers that did start */
+        worker_config.worker_count = started;
+        workers_active = true;
+        unlock_registry();
+        qbus_stop_workers();
+        return false;
+    }
+    
+    workers_active = true;
+    unlock_registry();
+    
+    printf("Quantum Message Bus started %u delivery workers\n", worker_config.worker_count);
+    return true;
+}
+
+/**
+ * @brief Stop the worker pool, finishing all queued deliveries
+ */
+void qbus_stop_workers(void) {
+    lock_registry();
+    if (!workers_active) {
+        unlock_registry();
+        return;
+    }
+    
+    /* New deliveries run inline from here on */
+    workers_active = false;
+    for (uint32_t w = 0; w < worker_config.worker_count; w++) {
+        BusWorker* worker = &bus_workers[w];
+        pthread_mutex_lock(&worker->lock);
+        worker->running = false;
+        pthread_cond_broadcast(&worker->work_available);
+        pthread_cond_broadcast(&worker->space_available);
+        pthread_mutex_unlock(&worker->lock);
+    }
+    unlock_registry();
+    
+    /* Join unlocked, since handlers still finishing may call back into the registry */
+    for (uint32_t w = 0; w < worker_config.worker_count; w++) {
+        pthread_join(bus_workers[w].thread, NULL);
+    }
+    
+    /* Release anything the workers did not drain */
+    lock_registry();
+    for (uint32_t i = 0; i < MAX_COMPONENTS; i++) {
+        ComponentInbox* inbox = &component_inboxes[i];
+        while (inbox->count > 0) {
+            DeliveryItem item = inbox->items[inbox->head];
+            inbox->head = (inbox->head + 1) % worker_config.inbox_capacity;
+            inbox->count--;
+            finish_delivery(&item);
+        }
+        inbox->items = NULL;
+    }
+    
+    for (uint32_t w = 0; w < worker_config.worker_count; w++) {
+        pthread_mutex_destroy(&bus_workers[w].lock);
+        pthread_cond_destroy(&bus_workers[w].work_available);
+        pthread_cond_destroy(&bus_workers[w].space_available);
+    }
+    
+    free(bus_workers);
+    free(inbox_storage);
+    bus_workers = NULL;
+    inbox_storage = NULL;
+    unlock_registry();
+}
+
+/**
+ * @brief Wait until the workers have finished every queued delivery
+ */
+void qbus_wait_workers_idle(void) {
+    pthread_mutex_lock(&worker_idle_lock);
+    while (atomic_load_explicit(&worker_inflight, memory_order_acquire) > 0) {
+        pthread_cond_wait(&worker_idle, &worker_idle_lock);
+    }
+    pthread_mutex_unlock(&worker_idle_lock);
+}
+
+/**
+ * @brief Pin a component to a delivery worker
+ */
+bool qbus_set_component_affinity(QComponentId component_id, uint32_t worker) {
+    if (!qbus_initialized) {
+        return false;
+    }
+    
+    lock_registry();
+    ComponentEntry* component = find_component_entry(component_id);
+    if (!component || workers_active) {
+        unlock_registry();
+        return false;
+    }
+    
+    component->worker_affinity = (int32_t)worker;
+    unlock_registry();
+    
+    return true;
+}
+
+/**
+ * @brief Mark a component's handlers as safe to run concurrently
+ */
+bool qbus_set_component_reentrant(QComponentId component_id, bool reentrant) {
+    if (!qbus_initialized) {
+        return false;
+    }
+    
+    lock_registry();
+    ComponentEntry* component = find_component_entry(component_id);
+    if (!component) {
+        unlock_registry();
+        return false;
+    }
+    
+    if (workers_active) {
+        /* Thieves read the flag under the owning worker's lock */
+        BusWorker* worker = &bus_workers[component_inboxes[component - components].worker];
+        pthread_mutex_lock(&worker->lock);
+        component->reentrant = reentrant;
+        pthread_mutex_unlock(&worker->lock);
+    } else {
+        component->reentrant = reentrant;
+    }
+    unlock_registry();
+    
+    return true;
+}
+
 /**
  * @brief Create a quantum entanglement between message buses
+ *
+ * Caller must hold the registry lock.
  */
-uint64_t qbus_create_entanglement(uint64_t remote_bus_id, NodeLevel resonance_level) {
+static uint64_t create_entanglement_locked(uint64_t remote_bus_id, NodeLevel resonance_level) {
     if (!qbus_initialized) {
         return 0;
     }
@@ -645,10 +2316,23 @@ uint64_t qbus_create_entanglement(uint64_t remote_bus_id, NodeLevel resonance_le
     return slot->id;
 }
 
+/**
+ * @brief Create a quantum entanglement between message buses
+ */
+uint64_t qbus_create_entanglement(uint64_t remote_bus_id, NodeLevel resonance_level) {
+    lock_registry();
+    uint64_t result = create_entanglement_locked(remote_bus_id, resonance_level);
+    unlock_registry();
+    
+    return result;
+}
+
 /**
  * @brief Break a quantum entanglement between message buses
+ *
+ * Caller must hold the registry lock.
  */
-bool qbus_break_entanglement(uint64_t entanglement_id) {
+static bool break_entanglement_locked(uint64_t entanglement_id) {
     if (!qbus_initialized) {
         return false;
     }
@@ -666,5 +2350,262 @@ bool qbus_break_entanglement(uint64_t entanglement_id) {
     printf("Broke entanglement (ID: %llu) with remote bus %llu\n",
            (unsigned long long)entanglement_id, (unsigned long long)remote_id);
     
+    return true;
+}
+
+/**
+ * @brief Break a quantum entanglement between message buses
+ */
+bool qbus_break_entanglement(uint64_t entanglement_id) {
+    lock_registry();
+    bool result = break_entanglement_locked(entanglement_id);
+    unlock_registry();
+    
+    return result;
+}
+
+/**
+ * @brief Get a snapshot of message bus statistics
+ */
+bool qbus_get_stats(QBusStats* stats) {
+    if (!stats) {
+        return false;
+    }
+    
+    memset(stats, 0, sizeof(*stats));
+    
+    for (uint32_t level = 0; level < QMSG_PRIORITY_LEVELS; level++) {
+        const PriorityRecorder* recorder = &priority_stats[level];
+        QPriorityStats* out = &stats->priorities[level];
+        
+        out->enqueued = atomic_load_explicit(&recorder->enqueued, memory_order_relaxed);
+        out->dispatched = atomic_load_explicit(&recorder->dispatched, memory_order_relaxed);
+        out->dropped = atomic_load_explicit(&recorder->dropped, memory_order_relaxed);
+        out->depth = atomic_load_explicit(&recorder->depth, memory_order_relaxed);
+        out->depth_high_water = atomic_load_explicit(&recorder->depth_high_water, memory_order_relaxed);
+        snapshot_latency(&recorder->latency, &out->latency);
+        
+        stats->messages_enqueued += out->enqueued;
+        stats->messages_dispatched += out->dispatched;
+        stats->messages_dropped += out->dropped;
+    }
+    
+    for (uint32_t i = 0; i < QBUS_STATS_MAX_TYPES; i++) {
+        const TypeRecorder* recorder = &type_stats[i];
+        uint32_t key = atomic_load_explicit(&recorder->key, memory_order_acquire);
+        if (key == 0) {
+            continue;
+        }
+        
+        QTypeStats* out = &stats->types[stats->type_count++];
+        out->type = (QMessageType)(key - 1);
+        out->enqueued = atomic_load_explicit(&recorder->enqueued, memory_order_relaxed);
+        out->dispatched = atomic_load_explicit(&recorder->dispatched, memory_order_relaxed);
+        out->dropped = atomic_load_explicit(&recorder->dropped, memory_order_relaxed);
+        snapshot_latency(&recorder->latency, &out->latency);
+    }
+    
+    for (uint32_t slot = 0; slot < MAX_COMPONENTS; slot++) {
+        const ComponentRecorder* recorder = &component_stats[slot];
+        uint32_t component_id = atomic_load_explicit(&recorder->component_id, memory_order_relaxed);
+        if (component_id == QCOMP_UNKNOWN) {
+            continue;
+        }
+        
+        QComponentStats* out = &stats->components[stats->component_count++];
+        out->component_id = (QComponentId)component_id;
+        out->invocations = atomic_load_explicit(&recorder->invocations, memory_order_relaxed);
+        out->inbox_dropped = atomic_load_explicit(&recorder->inbox_dropped, memory_order_relaxed);
+        snapshot_latency(&recorder->handler_time, &out->handler_time);
+    }
+    
+    stats->untracked_types = atomic_load_explicit(&untracked_type_count, memory_order_relaxed);
+    stats->pending_depth = atomic_load_explicit(&pending_message_count, memory_order_relaxed);
+    stats->pending_high_water = atomic_load_explicit(&pending_high_water, memory_order_relaxed);
+    
+    return true;
+}
+
+/**
+ * @brief Reset all message bus statistics
+ */
+void qbus_reset_stats(void) {
+    /* Keep live queue depths and component ownership; clear everything else */
+    for (uint32_t level = 0; level < QMSG_PRIORITY_LEVELS; level++) {
+        PriorityRecorder* recorder = &priority_stats[level];
+        uint32_t depth = atomic_load_explicit(&recorder->depth, memory_order_relaxed);
+        
+        memset(&recorder->latency, 0, sizeof(recorder->latency));
+        atomic_store_explicit(&recorder->enqueued, 0, memory_order_relaxed);
+        atomic_store_explicit(&recorder->dispatched, 0, memory_order_relaxed);
+        atomic_store_explicit(&recorder->dropped, 0, memory_order_relaxed);
+        atomic_store_explicit(&recorder->depth_high_water, depth, memory_order_relaxed);
+    }
+    
+    for (uint32_t i = 0; i < QBUS_STATS_MAX_TYPES; i++) {
+        TypeRecorder* recorder = &type_stats[i];
+        memset(&recorder->latency, 0, sizeof(recorder->latency));
+        atomic_store_explicit(&recorder->enqueued, 0, memory_order_relaxed);
+        atomic_store_explicit(&recorder->dispatched, 0, memory_order_relaxed);
+        atomic_store_explicit(&recorder->dropped, 0, memory_order_relaxed);
+    }
+    
+    for (uint32_t slot = 0; slot < MAX_COMPONENTS; slot++) {
+        ComponentRecorder* recorder = &component_stats[slot];
+        memset(&recorder->handler_time, 0, sizeof(recorder->handler_time));
+        atomic_store_explicit(&recorder->invocations, 0, memory_order_relaxed);
+        atomic_store_explicit(&recorder->inbox_dropped, 0, memory_order_relaxed);
+    }
+    
+    atomic_store_explicit(&untracked_type_count, 0, memory_order_relaxed);
+    atomic_store_explicit(&pending_high_water,
+                          atomic_load_explicit(&pending_message_count, memory_order_relaxed),
+                          memory_order_relaxed);
+}
+
+/**
+ * @brief Estimate a percentile from a latency histogram
+ */
+uint64_t qbus_histogram_percentile(const QLatencyHistogram* histogram, double percentile) {
+    if (!histogram || histogram->count == 0) {
+        return 0;
+    }
+    
+    if (percentile < 0.0) {
+        percentile = 0.0;
+    } else if (percentile > 100.0) {
+        percentile = 100.0;
+    }
+    
+    uint64_t rank = (uint64_t)((double)histogram->count * percentile / 100.0 + 0.5);
+    if (rank == 0) {
+        rank = 1;
+    }
+    
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < QBUS_LATENCY_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= rank) {
+            /* Never report beyond the largest sample actually seen */
+            uint64_t limit = latency_bucket_limit(i);
+            return limit < histogram->max_ns ? limit : histogram->max_ns;
+        }
+    }
+    
+    return histogram->max_ns;
+}
+
+/**
+ * @brief Write a histogram summary as a JSON object
+ */
+static void write_histogram_json(FILE* file, const QLatencyHistogram* histogram) {
+    fprintf(file, "{\"count\":%llu,\"meanNs\":%llu,\"p50Ns\":%llu,\"p90Ns\":%llu,\"p99Ns\":%llu,\"maxNs\":%llu}",
+            (unsigned long long)histogram->count,
+            (unsigned long long)(histogram->count ? histogram->sum_ns / histogram->count : 0),
+            (unsigned long long)qbus_histogram_percentile(histogram, 50.0),
+            (unsigned long long)qbus_histogram_percentile(histogram, 90.0),
+            (unsigned long long)qbus_histogram_percentile(histogram, 99.0),
+            (unsigned long long)histogram->max_ns);
+}
+
+/**
+ * @brief Write a statistics summary as JSON for the dashboard
+ */
+bool qbus_write_stats_json(const char* path) {
+    if (!path) {
+        return false;
+    }
+    
+    QBusStats* stats = (QBusStats*)malloc(sizeof(QBusStats));
+    if (!stats) {
+        return false;
+    }
+    qbus_get_stats(stats);
+    
+    char temp_path[512];
+    if (snprintf(temp_path, sizeof(temp_path), "%s.tmp", path) >= (int)sizeof(temp_path)) {
+        free(stats);
+        return false;
+    }
+    
+    FILE* file = fopen(temp_path, "w");
+    if (!file) {
+        printf("Cannot write bus statistics: failed to open %s\n", temp_path);
+        free(stats);
+        return false;
+    }
+    
+    fprintf(file, "{\"timestamp\":%llu,\"messagesEnqueued\":%llu,\"messagesDispatched\":%llu,"
+            "\"messagesDropped\":%llu,\"untrackedTypes\":%llu,\"pendingDepth\":%u,\"pendingHighWater\":%u,",
+            (unsigned long long)(get_timestamp_ns() / 1000000ULL),
+            (unsigned long long)stats->messages_enqueued,
+            (unsigned long long)stats->messages_dispatched,
+            (unsigned long long)stats->messages_dropped,
+            (unsigned long long)stats->untracked_types,
+            stats->pending_depth, stats->pending_high_water);
+    
+    fprintf(file, "\"priorities\":[");
+    for (uint32_t level = 0; level < QMSG_PRIORITY_LEVELS; level++) {
+        const QPriorityStats* priority = &stats->priorities[level];
+        fprintf(file, "%s{\"priority\":%u,\"enqueued\":%llu,\"dispatched\":%llu,\"dropped\":%llu,"
+                "\"depth\":%u,\"depthHighWater\":%u,\"latency\":",
+                level ? "," : "", level,
+                (unsigned long long)priority->enqueued,
+                (unsigned long long)priority->dispatched,
+                (unsigned long long)priority->dropped,
+                priority->depth, priority->depth_high_water);
+        write_histogram_json(file, &priority->latency);
+        fprintf(file, "}");
+    }
+    
+    fprintf(file, "],\"types\":[");
+    for (uint32_t i = 0; i < stats->type_count; i++) {
+        const QTypeStats* type = &stats->types[i];
+        fprintf(file, "%s{\"type\":%u,\"enqueued\":%llu,\"dispatched\":%llu,\"dropped\":%llu,\"latency\":",
+                i ? "," : "", (unsigned)type->type,
+                (unsigned long long)type->enqueued,
+                (unsigned long long)type->dispatched,
+                (unsigned long long)type->dropped);
+        write_histogram_json(file, &type->latency);
+        fprintf(file, "}");
+    }
+    
+    fprintf(file, "],\"components\":[");
+    for (uint32_t i = 0; i < stats->component_count; i++) {
+        const QComponentStats* component = &stats->components[i];
+        QComponentInfo info;
+        if (!qbus_find_component(component->component_id, &info)) {
+            strcpy(info.name, "unregistered");
+        }
+        
+        /* Component names are plain identifiers; drop anything that would need escaping */
+        char name[sizeof(info.name)];
+        size_t length = 0;
+        for (size_t c = 0; info.name[c] && length < sizeof(name) - 1; c++) {
+            if (info.name[c] != '"' && info.name[c] != '\\' && (unsigned char)info.name[c] >= 0x20) {
+                name[length++] = info.name[c];
+            }
+        }
+        name[length] = '\0';
+        
+        fprintf(file, "%s{\"id\":%u,\"name\":\"%s\",\"invocations\":%llu,\"inboxDropped\":%llu,\"handlerTime\":",
+                i ? "," : "", (unsigned)component->component_id, name,
+                (unsigned long long)component->invocations,
+                (unsigned long long)component->inbox_dropped);
+        write_histogram_json(file, &component->handler_time);
+        fprintf(file, "}");
+    }
+    fprintf(file, "]}\n");
+    
+    bool written = !ferror(file);
+    written = (fclose(file) == 0) && written;
+    free(stats);
+    
+    if (!written || rename(temp_path, path) != 0) {
+        printf("Cannot write bus statistics: failed to replace %s\n", path);
+        remove(temp_path);
+        return false;
+    }
+    
     return true;
 }
\ No newline at end of file
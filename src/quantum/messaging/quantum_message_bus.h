@@ -112,11 +112,29 @@ typedef enum {
  */
 typedef struct QMessage QMessage;
 
+/**
+ * @brief Reference-counted message payload buffer (opaque)
+ */
+typedef struct QMessageBuffer QMessageBuffer;
+
+/**
+ * @brief Release callback for caller-provided buffer memory
+ */
+typedef void (*QBufferReleaseFn)(void* data, void* context);
+
 /**
  * @brief Message handler function type
  */
 typedef void (*QMessageHandler)(QMessage* message, void* context);
 
+/**
+ * @brief Batch message handler function type
+ * 
+ * Receives a span of messages that share a destination and message type.
+ * The span and the messages are only valid for the duration of the call.
+ */
+typedef void (*QMessageBatchHandler)(QMessage* const* messages, uint32_t count, void* context);
+
 /**
  * @brief Subscription structure
  */
@@ -126,6 +144,7 @@ typedef struct {
     QMessageHandler handler;       /**< Message handler function */
     void* context;                 /**< Context to pass to handler */
     NodeLevel min_resonance;       /**< Minimum resonance level for messages */
+    QMessageBatchHandler batch_handler; /**< Batch handler used by qbus_process_message_batches (optional) */
 } QSubscription;
 
 /**
@@ -150,8 +169,114 @@ typedef struct {
 struct QMessage {
     QMessageHeader header;         /**< Message header */
     void* data;                    /**< Message data */
+    QMessageBuffer* buffer;        /**< Shared buffer backing data (NULL if data is owned by the message) */
 };
 
+/**
+ * @brief Back-pressure policy when a component's inbox is full (worker mode)
+ */
+typedef enum {
+    QBUS_BACKPRESSURE_BLOCK = 0,   /**< Block the pump until the inbox has room */
+    QBUS_BACKPRESSURE_DROP_NEWEST, /**< Drop the delivery being queued */
+    QBUS_BACKPRESSURE_DROP_OLDEST  /**< Drop the oldest queued delivery to make room */
+} QBackpressurePolicy;
+
+/**
+ * @brief Worker pool configuration
+ */
+typedef struct {
+    uint32_t worker_count;             /**< Number of delivery threads */
+    uint32_t inbox_capacity;           /**< Queued deliveries per component (0 for default) */
+    QBackpressurePolicy backpressure;  /**< Policy when a component's inbox is full */
+} QWorkerPoolConfig;
+
+/**
+ * @brief Number of buckets in a latency histogram
+ * 
+ * Buckets are log-linear: four sub-buckets per power of two, so each bucket
+ * spans at most 25% of its lower bound. Values above ~8.6 s land in the last
+ * bucket.
+ */
+#define QBUS_LATENCY_BUCKETS 128
+
+/**
+ * @brief Maximum number of message types tracked individually in statistics
+ */
+#define QBUS_STATS_MAX_TYPES 128
+
+/**
+ * @brief Maximum number of components tracked in statistics
+ */
+#define QBUS_STATS_MAX_COMPONENTS 64
+
+/**
+ * @brief Latency histogram snapshot (nanoseconds)
+ */
+typedef struct {
+    uint64_t count;                /**< Number of samples */
+    uint64_t sum_ns;               /**< Sum of all samples */
+    uint64_t max_ns;               /**< Largest sample */
+    uint64_t buckets[QBUS_LATENCY_BUCKETS]; /**< Samples per bucket */
+} QLatencyHistogram;
+
+/**
+ * @brief Statistics for one priority level
+ */
+typedef struct {
+    uint64_t enqueued;             /**< Messages queued */
+    uint64_t dispatched;           /**< Messages taken off the queue for delivery */
+    uint64_t dropped;              /**< Messages rejected because the queue was full */
+    uint32_t depth;                /**< Current queue depth */
+    uint32_t depth_high_water;     /**< Largest queue depth seen */
+    QLatencyHistogram latency;     /**< Enqueue to dispatch latency */
+} QPriorityStats;
+
+/**
+ * @brief Statistics for one message type
+ */
+typedef struct {
+    QMessageType type;             /**< Message type */
+    uint64_t enqueued;             /**< Messages queued */
+    uint64_t dispatched;           /**< Messages taken off the queue for delivery */
+    uint64_t dropped;              /**< Messages rejected because the queue was full */
+    QLatencyHistogram latency;     /**< Enqueue to dispatch latency */
+} QTypeStats;
+
+/**
+ * @brief Handler statistics for one component
+ */
+typedef struct {
+    QComponentId component_id;     /**< Component ID */
+    uint64_t invocations;          /**< Messages handled */
+    uint64_t inbox_dropped;        /**< Worker-mode deliveries dropped by back-pressure */
+    QLatencyHistogram handler_time; /**< Handler execution time per call */
+} QComponentStats;
+
+/**
+ * @brief Message bus statistics snapshot
+ */
+typedef struct {
+    uint64_t messages_enqueued;    /**< Messages queued across all priorities */
+    uint64_t messages_dispatched;  /**< Messages taken off the queue for delivery */
+    uint64_t messages_dropped;     /**< Messages rejected because a queue was full */
+    uint64_t untracked_types;      /**< Messages whose type did not fit in the type table */
+    uint32_t pending_depth;        /**< Current pending message count */
+    uint32_t pending_high_water;   /**< Largest pending message count seen */
+    QPriorityStats priorities[QMSG_PRIORITY_QUANTUM + 1]; /**< Indexed by QMessagePriority */
+    uint32_t type_count;           /**< Number of valid entries in types */
+    QTypeStats types[QBUS_STATS_MAX_TYPES]; /**< Per-type statistics */
+    uint32_t component_count;      /**< Number of valid entries in components */
+    QComponentStats components[QBUS_STATS_MAX_COMPONENTS]; /**< Per-component handler statistics */
+} QBusStats;
+
+/**
+ * @brief Transport callback that carries a message to an entangled remote bus
+ * 
+ * Called from the message pump for every locally originated message whose
+ * resonance level reaches the entanglement's. Must not block.
+ */
+typedef void (*QRemoteForwarder)(uint64_t remote_bus_id, const QMessage* message, void* context);
+
 /**
  * @brief Component registration information
  */
@@ -211,14 +336,51 @@ bool qbus_unsubscribe(QComponentId component_id, QMessageType message_type, QMes
 /**
  * @brief Send a message
  * 
+ * The message is copied into the pending ring for its priority level. May be
+ * called concurrently from multiple threads without external locking.
+ * 
  * @param message Message to send
- * @return true if send succeeded, false otherwise
+ * @return true if send succeeded, false otherwise (including when the ring
+ *         for the message's priority level is full)
  */
 bool qbus_send_message(const QMessage* message);
 
+/**
+ * @brief Send several messages
+ * 
+ * Messages are queued in array order. Sending stops at the first message
+ * that cannot be queued so the caller can retry the remainder.
+ * 
+ * @param messages Messages to send
+ * @param count Number of messages
+ * @return Number of messages queued
+ */
+uint32_t qbus_send_batch(const QMessage* const* messages, uint32_t count);
+
+/**
+ * @brief Send a shared buffer without copying its contents
+ * 
+ * The queued message references the buffer instead of copying it, so every
+ * subscriber of a broadcast sees the same memory. Handlers that need the
+ * payload after returning can keep it alive with qbus_buffer_retain.
+ * 
+ * @param type Message type
+ * @param source Source component ID
+ * @param destination Destination component ID (0 for broadcast)
+ * @param buffer Payload buffer; one reference is transferred to the bus on success
+ * @param priority Message priority
+ * @param requires_response Whether message requires a response
+ * @return true if send succeeded, false otherwise (caller keeps its reference)
+ */
+bool qbus_send_buffer(QMessageType type, QComponentId source, QComponentId destination,
+                      QMessageBuffer* buffer, QMessagePriority priority, bool requires_response);
+
 /**
  * @brief Create a new message
  * 
+ * Messages and small payloads are carved from pooled size classes, so
+ * creating and freeing a message does not normally touch the heap.
+ * 
  * @param type Message type
  * @param source Source component ID
  * @param destination Destination component ID (0 for broadcast)
@@ -244,6 +406,21 @@ QMessage* qbus_create_message(QMessageType type, QComponentId source, QComponent
 QMessage* qbus_create_response(const QMessage* original_message, const void* data,
                              uint32_t data_size, QMessagePriority priority);
 
+/**
+ * @brief Create a message that references a shared buffer
+ * 
+ * @param type Message type
+ * @param source Source component ID
+ * @param destination Destination component ID (0 for broadcast)
+ * @param buffer Payload buffer; one reference is transferred to the message on success
+ * @param priority Message priority
+ * @param requires_response Whether message requires a response
+ * @return New message or NULL on failure (must be freed with qbus_free_message)
+ */
+QMessage* qbus_create_buffer_message(QMessageType type, QComponentId source, QComponentId destination,
+                                   QMessageBuffer* buffer, QMessagePriority priority,
+                                   bool requires_response);
+
 /**
  * @brief Free a message
  * 
@@ -251,14 +428,83 @@ QMessage* qbus_create_response(const QMessage* original_message, const void* dat
  */
 void qbus_free_message(QMessage* message);
 
+/**
+ * @brief Allocate a reference-counted payload buffer
+ * 
+ * @param size Size of the buffer in bytes
+ * @return New buffer with a reference count of one, or NULL on failure
+ */
+QMessageBuffer* qbus_buffer_create(uint32_t size);
+
+/**
+ * @brief Wrap caller-owned memory in a reference-counted payload buffer
+ * 
+ * @param data Memory to wrap; ownership passes to the buffer
+ * @param size Size of the memory in bytes
+ * @param release Called with data and context when the last reference is dropped (may be NULL)
+ * @param context Context passed to release
+ * @return New buffer with a reference count of one, or NULL on failure
+ */
+QMessageBuffer* qbus_buffer_wrap(void* data, uint32_t size, QBufferReleaseFn release, void* context);
+
+/**
+ * @brief Add a reference to a payload buffer
+ * 
+ * @param buffer Buffer to retain
+ * @return The same buffer
+ */
+QMessageBuffer* qbus_buffer_retain(QMessageBuffer* buffer);
+
+/**
+ * @brief Drop a reference to a payload buffer, freeing it on the last one
+ * 
+ * @param buffer Buffer to release
+ */
+void qbus_buffer_release(QMessageBuffer* buffer);
+
+/**
+ * @brief Get the memory of a payload buffer
+ * 
+ * @param buffer Buffer
+ * @return Pointer to the buffer contents
+ */
+void* qbus_buffer_data(const QMessageBuffer* buffer);
+
+/**
+ * @brief Get the size of a payload buffer
+ * 
+ * @param buffer Buffer
+ * @return Size in bytes
+ */
+uint32_t qbus_buffer_size(const QMessageBuffer* buffer);
+
 /**
  * @brief Process pending messages
  * 
+ * Drains the highest priority level first; messages of equal priority are
+ * delivered in the order they were sent. Only one thread may process
+ * messages at a time.
+ * 
  * @param max_messages Maximum number of messages to process (0 for all pending)
  * @return Number of messages processed
  */
 uint32_t qbus_process_messages(uint32_t max_messages);
 
+/**
+ * @brief Process pending messages in batches
+ * 
+ * Drains pending messages in priority order, groups them by destination
+ * and message type, and delivers each group with one call per subscriber.
+ * Subscribers with a batch handler receive the whole group as a span;
+ * others receive the group's messages one by one. Message order within a
+ * group is preserved; groups are delivered in the order of their first
+ * message. Only one thread may process messages at a time.
+ * 
+ * @param max_messages Maximum number of messages to process (0 for all pending)
+ * @return Number of messages processed
+ */
+uint32_t qbus_process_message_batches(uint32_t max_messages);
+
 /**
  * @brief Find a component by ID
  * 
@@ -277,6 +523,57 @@ bool qbus_find_component(QComponentId component_id, QComponentInfo* info);
  */
 bool qbus_set_component_resonance(QComponentId component_id, NodeLevel resonance_level);
 
+/**
+ * @brief Start delivering messages on a pool of worker threads
+ * 
+ * While the pool runs, qbus_process_messages only routes: each matched
+ * subscription becomes a delivery queued on the receiving component's inbox.
+ * Every component is owned by one worker, so its handlers run in order and
+ * never concurrently, unless it is marked reentrant, in which case idle
+ * workers may steal its deliveries.
+ * 
+ * @param config Worker pool configuration
+ * @return true if the pool started, false otherwise
+ */
+bool qbus_start_workers(const QWorkerPoolConfig* config);
+
+/**
+ * @brief Stop the worker pool
+ * 
+ * Queued deliveries are completed before the workers exit. Message delivery
+ * returns to running handlers inline in qbus_process_messages.
+ */
+void qbus_stop_workers(void);
+
+/**
+ * @brief Wait until the workers have finished every queued delivery
+ */
+void qbus_wait_workers_idle(void);
+
+/**
+ * @brief Pin a component to a delivery worker
+ * 
+ * Must be called while the worker pool is stopped. Components without an
+ * explicit affinity are spread across workers by registration slot.
+ * 
+ * @param component_id Component ID
+ * @param worker Worker index (taken modulo the worker count)
+ * @return true if the affinity was set, false otherwise
+ */
+bool qbus_set_component_affinity(QComponentId component_id, uint32_t worker);
+
+/**
+ * @brief Mark a component's handlers as safe to run concurrently
+ * 
+ * Deliveries for reentrant components may be stolen by idle workers and
+ * therefore run out of order and in parallel.
+ * 
+ * @param component_id Component ID
+ * @param reentrant Whether the component's handlers are reentrant
+ * @return true if the flag was set, false otherwise
+ */
+bool qbus_set_component_reentrant(QComponentId component_id, bool reentrant);
+
 /**
  * @brief Create a quantum entanglement between message buses
  * 
@@ -294,4 +591,70 @@ uint64_t qbus_create_entanglement(uint64_t remote_bus_id, NodeLevel resonance_le
  */
 bool qbus_break_entanglement(uint64_t entanglement_id);
 
+/**
+ * @brief Set the transport used to reach entangled remote buses
+ * 
+ * @param forwarder Forwarding callback (NULL to stop propagating)
+ * @param context Context passed to the callback
+ */
+void qbus_set_remote_forwarder(QRemoteForwarder forwarder, void* context);
+
+/**
+ * @brief Queue a message received from an entangled remote bus
+ * 
+ * The header is kept as sent by the remote bus, including its source
+ * component and message ID. Remote messages are delivered locally but never
+ * propagated again, so entangled buses cannot loop messages between them.
+ * 
+ * @param header Message header as received
+ * @param data Message payload (header->data_size bytes, may be NULL)
+ * @return true if the message was queued, false otherwise
+ */
+bool qbus_deliver_remote_message(const QMessageHeader* header, const void* data);
+
+/**
+ * @brief Check whether a message arrived from an entangled remote bus
+ * 
+ * @param message Message created by the bus
+ * @return true if the message is of remote origin, false otherwise
+ */
+bool qbus_message_is_remote(const QMessage* message);
+
+/**
+ * @brief Get a snapshot of message bus statistics
+ * 
+ * Statistics are recorded with relaxed atomic counters and may be read at
+ * any time from any thread. Counters written concurrently with the snapshot
+ * may be off by the messages in flight.
+ * 
+ * @param stats Pointer to store statistics
+ * @return true if statistics were retrieved, false otherwise
+ */
+bool qbus_get_stats(QBusStats* stats);
+
+/**
+ * @brief Reset all message bus statistics
+ */
+void qbus_reset_stats(void);
+
+/**
+ * @brief Estimate a percentile from a latency histogram
+ * 
+ * @param histogram Histogram snapshot
+ * @param percentile Percentile in the range 0-100
+ * @return Upper bound of the bucket containing the percentile, in nanoseconds
+ */
+uint64_t qbus_histogram_percentile(const QLatencyHistogram* histogram, double percentile);
+
+/**
+ * @brief Write a statistics summary as JSON for the dashboard
+ * 
+ * The file is replaced atomically, so readers never see partial output.
+ * Histograms are summarized as count, mean, p50, p90, p99 and max.
+ * 
+ * @param path Output file path
+ * @return true if the file was written, false otherwise
+ */
+bool qbus_write_stats_json(const char* path);
+
 #endif /* CTRLXT_QUANTUM_MESSAGE_BUS_H */
\ No newline at end of file
@@ -0,0 +1,365 @@
+/**
+ * @file frame_ring.c
+ * @brief Preallocated ring of ocular frames shared without copying
+ *
+ * All slot memory is one aligned block carved at creation. A slot is
+ * free, being written, or published; a published slot returns to free
+ * once it has been had by every consumer (borrowed or skipped) and holds
+ * no references, or when the drop policy reclaims it. One mutex guards
+ * the slot states; frames are only ever touched whole, so it is taken a
+ * handful of times per frame, never per byte.
+ */
+
+/* clock_gettime under -std=c11 */
+#define _XOPEN_SOURCE 700
+
+#include "frame_ring.h"
+#include "../../kernel/trace/trace.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#define OFRAME_ALIGNMENT 64
+
+/**
+ * @brief Slot states
+ */
+typedef enum {
+    SLOT_FREE,
+    SLOT_WRITING,
+    SLOT_PUBLISHED
+} OcularSlotState;
+
+/**
+ * @brief Ring slot; the frame comes first so a frame pointer is a slot pointer
+ */
+typedef struct {
+    OcularFrame frame;
+    OcularFrameRing *ring;
+    OcularSlotState state;
+    uint32_t references;               /**< Outstanding borrows and retains */
+    uint32_t reads;                    /**< Consumers that have had the frame */
+} OcularSlot;
+
+/**
+ * @brief Ring state
+ */
+struct OcularFrameRing {
+    OcularSlot *slots;
+    uint32_t slot_count;
+    uint32_t consumers;
+    OcularFrameDropPolicy policy;
+    uint8_t *memory;                   /**< Every slot's data */
+    uint64_t next_sequence;
+    pthread_mutex_t lock;
+    pthread_cond_t freed;              /**< Signalled when a slot becomes free */
+    OcularFrameRingStats stats;
+    uint64_t latency_sum[OFRAME_STAGE_COUNT];
+    uint64_t latency_count[OFRAME_STAGE_COUNT];
+};
+
+/**
+ * @brief Nanoseconds on the monotonic clock
+ */
+static uint64_t monotonic_nanoseconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Stamp a frame with the current time for a stage, and trace it
+ *
+ * Acquiring starts the frame's trace span and releasing ends it.
+ */
+static void stamp_stage(OcularFrame *frame, OcularFrameStage stage) {
+    frame->timestamps[stage] = monotonic_nanoseconds();
+    TRACE_EVENT(TRACE_OCULAR_STAGE,
+                stage == OFRAME_STAGE_ACQUIRED ? TRACE_PHASE_BEGIN :
+                stage == OFRAME_STAGE_RELEASED ? TRACE_PHASE_END : TRACE_PHASE_INSTANT,
+                (uintptr_t)frame, stage);
+}
+
+/**
+ * @brief Return a published slot to the free list, recording its latencies
+ */
+static void retire_slot(OcularFrameRing *ring, OcularSlot *slot) {
+    OcularFrame *frame = &slot->frame;
+    stamp_stage(frame, OFRAME_STAGE_RELEASED);
+    for (int stage = 0; stage < OFRAME_STAGE_COUNT; stage++) {
+        if (frame->timestamps[stage] != 0) {
+            ring->latency_sum[stage] += frame->timestamps[stage] - frame->timestamps[OFRAME_STAGE_ACQUIRED];
+            ring->latency_count[stage]++;
+        }
+    }
+    ring->stats.retired++;
+    slot->state = SLOT_FREE;
+    pthread_cond_broadcast(&ring->freed);
+}
+
+/**
+ * @brief Retire a published slot once it is no longer wanted
+ */
+static void retire_if_done(OcularFrameRing *ring, OcularSlot *slot) {
+    if (slot->state == SLOT_PUBLISHED && slot->references == 0 && slot->reads >= ring->consumers) {
+        retire_slot(ring, slot);
+    }
+}
+
+/**
+ * @brief Find a slot for the producer (caller holds the lock)
+ */
+static OcularSlot *take_slot(OcularFrameRing *ring) {
+    OcularSlot *oldest = NULL;
+    for (uint32_t i = 0; i < ring->slot_count; i++) {
+        OcularSlot *slot = &ring->slots[i];
+        if (slot->state == SLOT_FREE) {
+            return slot;
+        }
+        if (slot->state == SLOT_PUBLISHED && slot->references == 0 &&
+            (!oldest || slot->frame.sequence < oldest->frame.sequence)) {
+            oldest = slot;
+        }
+    }
+    if (ring->policy != OFRAME_DROP_OLDEST || !oldest) {
+        return NULL;
+    }
+    if (oldest->reads < ring->consumers) {
+        ring->stats.dropped++;
+    }
+    retire_slot(ring, oldest);
+    return oldest;
+}
+
+/**
+ * @brief Create a frame ring
+ */
+OcularFrameRing *ofring_create(uint32_t slots, uint32_t frame_capacity, uint32_t consumers,
+                               OcularFrameDropPolicy policy) {
+    if (slots < 2 || frame_capacity == 0 || policy > OFRAME_BLOCK) {
+        return NULL;
+    }
+    size_t stride = ((size_t)frame_capacity + OFRAME_ALIGNMENT - 1) & ~(size_t)(OFRAME_ALIGNMENT - 1);
+    OcularFrameRing *ring = (OcularFrameRing *)calloc(1, sizeof(OcularFrameRing));
+    if (!ring) {
+        return NULL;
+    }
+    ring->slots = (OcularSlot *)calloc(slots, sizeof(OcularSlot));
+    ring->memory = (uint8_t *)aligned_alloc(OFRAME_ALIGNMENT, stride * slots);
+    if (!ring->slots || !ring->memory) {
+        free(ring->slots);
+        free(ring->memory);
+        free(ring);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < slots; i++) {
+        ring->slots[i].frame.data = ring->memory + stride * i;
+        ring->slots[i].frame.capacity = frame_capacity;
+        ring->slots[i].ring = ring;
+    }
+    ring->slot_count = slots;
+    ring->consumers = consumers;
+    ring->policy = policy;
+    pthread_mutex_init(&ring->lock, NULL);
+    pthread_cond_init(&ring->freed, NULL);
+    return ring;
+}
+
+/**
+ * @brief Destroy a frame ring
+ */
+void ofring_destroy(OcularFrameRing *ring) {
+    if (!ring) {
+        return;
+    }
+    pthread_mutex_destroy(&ring->lock);
+    pthread_cond_destroy(&ring->freed);
+    free(ring->memory);
+    free(ring->slots);
+    free(ring);
+}
+
+/**
+ * @brief Take a slot to fill
+ */
+OcularFrame *ofring_acquire(OcularFrameRing *ring) {
+    if (!ring) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&ring->lock);
+    OcularSlot *slot = take_slot(ring);
+    if (!slot && ring->policy == OFRAME_BLOCK) {
+        ring->stats.waits++;
+        while (!(slot = take_slot(ring))) {
+            pthread_cond_wait(&ring->freed, &ring->lock);
+        }
+    }
+    if (!slot) {
+        ring->stats.refused++;
+        pthread_mutex_unlock(&ring->lock);
+        return NULL;
+    }
+    slot->state = SLOT_WRITING;
+    slot->references = 0;
+    slot->reads = 0;
+    pthread_mutex_unlock(&ring->lock);
+
+    OcularFrame *frame = &slot->frame;
+    frame->sequence = 0;
+    frame->size = 0;
+    memset(frame->timestamps, 0, sizeof(frame->timestamps));
+    stamp_stage(frame, OFRAME_STAGE_ACQUIRED);
+    return frame;
+}
+
+/**
+ * @brief Stamp a frame with the current time for a stage
+ */
+void ofring_mark(OcularFrame *frame, OcularFrameStage stage) {
+    if (frame && stage < OFRAME_STAGE_COUNT) {
+        stamp_stage(frame, stage);
+    }
+}
+
+/**
+ * @brief Make a filled frame visible to consumers
+ */
+uint64_t ofring_publish(OcularFrameRing *ring, OcularFrame *frame) {
+    OcularSlot *slot = (OcularSlot *)frame;
+    if (!ring || !frame || slot->ring != ring || frame->size > frame->capacity) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&ring->lock);
+    if (slot->state != SLOT_WRITING) {
+        pthread_mutex_unlock(&ring->lock);
+        return 0;
+    }
+    uint64_t sequence = ++ring->next_sequence;
+    frame->sequence = sequence;
+    stamp_stage(frame, OFRAME_STAGE_PUBLISHED);
+    slot->state = SLOT_PUBLISHED;
+    ring->stats.published++;
+    retire_if_done(ring, slot);
+    pthread_mutex_unlock(&ring->lock);
+    return sequence;
+}
+
+/**
+ * @brief Give back an acquired frame without publishing it
+ */
+void ofring_discard(OcularFrameRing *ring, OcularFrame *frame) {
+    OcularSlot *slot = (OcularSlot *)frame;
+    if (!ring || !frame || slot->ring != ring) {
+        return;
+    }
+    pthread_mutex_lock(&ring->lock);
+    if (slot->state == SLOT_WRITING) {
+        slot->state = SLOT_FREE;
+        pthread_cond_broadcast(&ring->freed);
+    }
+    pthread_mutex_unlock(&ring->lock);
+}
+
+/**
+ * @brief Borrow the next published frame for a consumer
+ */
+OcularFrame *ofring_borrow(OcularFrameRing *ring, uint64_t *cursor, bool latest) {
+    if (!ring || !cursor) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&ring->lock);
+    OcularSlot *chosen = NULL;
+    for (uint32_t i = 0; i < ring->slot_count; i++) {
+        OcularSlot *slot = &ring->slots[i];
+        if (slot->state != SLOT_PUBLISHED || slot->frame.sequence <= *cursor) {
+            continue;
+        }
+        if (!chosen || (latest ? slot->frame.sequence > chosen->frame.sequence
+                               : slot->frame.sequence < chosen->frame.sequence)) {
+            chosen = slot;
+        }
+    }
+    if (!chosen) {
+        pthread_mutex_unlock(&ring->lock);
+        return NULL;
+    }
+
+    /* Frames skipped on the way count as had */
+    for (uint32_t i = 0; latest && i < ring->slot_count; i++) {
+        OcularSlot *slot = &ring->slots[i];
+        if (slot->state == SLOT_PUBLISHED && slot->frame.sequence > *cursor &&
+            slot->frame.sequence < chosen->frame.sequence) {
+            slot->reads++;
+            retire_if_done(ring, slot);
+        }
+    }
+    if (chosen->frame.timestamps[OFRAME_STAGE_BORROWED] == 0) {
+        stamp_stage(&chosen->frame, OFRAME_STAGE_BORROWED);
+    }
+    chosen->references++;
+    chosen->reads++;
+    *cursor = chosen->frame.sequence;
+    pthread_mutex_unlock(&ring->lock);
+    return &chosen->frame;
+}
+
+/**
+ * @brief Add a reference to a borrowed frame
+ */
+OcularFrame *ofring_retain(OcularFrame *frame) {
+    if (frame) {
+        OcularSlot *slot = (OcularSlot *)frame;
+        pthread_mutex_lock(&slot->ring->lock);
+        slot->references++;
+        pthread_mutex_unlock(&slot->ring->lock);
+    }
+    return frame;
+}
+
+/**
+ * @brief Drop a reference to a borrowed frame
+ */
+void ofring_release(OcularFrame *frame) {
+    if (!frame) {
+        return;
+    }
+    OcularSlot *slot = (OcularSlot *)frame;
+    OcularFrameRing *ring = slot->ring;
+    pthread_mutex_lock(&ring->lock);
+    if (slot->references > 0) {
+        slot->references--;
+        retire_if_done(ring, slot);
+    }
+    pthread_mutex_unlock(&ring->lock);
+}
+
+/**
+ * @brief Release callback releasing a frame given as the context
+ */
+void ofring_release_buffer(void *data, void *context) {
+    (void)data;
+    ofring_release((OcularFrame *)context);
+}
+
+/**
+ * @brief Read the ring statistics
+ */
+bool ofring_get_stats(OcularFrameRing *ring, OcularFrameRingStats *stats) {
+    if (!ring || !stats) {
+        return false;
+    }
+    pthread_mutex_lock(&ring->lock);
+    *stats = ring->stats;
+    for (int stage = 0; stage < OFRAME_STAGE_COUNT; stage++) {
+        stats->stage_latency_ns[stage] = ring->latency_count[stage] > 0
+                                             ? ring->latency_sum[stage] / ring->latency_count[stage]
+                                             : 0;
+    }
+    pthread_mutex_unlock(&ring->lock);
+    return true;
+}
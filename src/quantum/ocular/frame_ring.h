@@ -0,0 +1,182 @@
+/**
+ * @file frame_ring.h
+ * @brief Preallocated ring of ocular frames shared without copying
+ *
+ * A producer acquires a free slot, fills it in place (enhancing it in
+ * place too, if it likes) and publishes it. Each consumer keeps its own
+ * cursor and borrows published frames in order, or skips to the newest.
+ * A borrowed frame can be retained further, for example to back a
+ * QMSG_OCULAR_DATA message buffer, and its slot is reused once every
+ * consumer has had it and the last reference is dropped. When no slot is
+ * free, the ring's drop policy decides what the producer gets.
+ *
+ * Each step stamps the frame with the monotonic time, so per-stage
+ * latency can be read off any frame and, averaged, from the statistics.
+ * All functions are thread-safe.
+ */
+
+#ifndef CTRLXT_OCULAR_FRAME_RING_H
+#define CTRLXT_OCULAR_FRAME_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Opaque frame ring handle
+ */
+typedef struct OcularFrameRing OcularFrameRing;
+
+/**
+ * @brief What a producer gets when no slot is free
+ */
+typedef enum {
+    OFRAME_DROP_OLDEST,           /**< The oldest published frame nobody holds is reclaimed */
+    OFRAME_DROP_NEWEST,           /**< The producer is refused, losing the frame it would write */
+    OFRAME_BLOCK                  /**< The producer waits for a slot */
+} OcularFrameDropPolicy;
+
+/**
+ * @brief Points in a frame's life that are timestamped
+ */
+typedef enum {
+    OFRAME_STAGE_ACQUIRED,        /**< Producer took the slot */
+    OFRAME_STAGE_ENHANCED,        /**< Enhancement finished */
+    OFRAME_STAGE_PUBLISHED,       /**< Made visible to consumers */
+    OFRAME_STAGE_BORROWED,        /**< First consumer borrowed it */
+    OFRAME_STAGE_RELEASED,        /**< Slot became reusable */
+    OFRAME_STAGE_COUNT
+} OcularFrameStage;
+
+/**
+ * @brief Frame in a ring slot
+ *
+ * Producers write data and size between acquire and publish; after
+ * that the frame is read-only.
+ */
+typedef struct {
+    uint64_t sequence;                         /**< Publication order, from 1 (0 until published) */
+    uint8_t *data;                             /**< Slot memory, 64-byte aligned */
+    uint32_t size;                             /**< Bytes of valid data */
+    uint32_t capacity;                         /**< Slot size in bytes */
+    uint64_t timestamps[OFRAME_STAGE_COUNT];   /**< Monotonic nanoseconds per stage (0 if not reached) */
+} OcularFrame;
+
+/**
+ * @brief Frame ring statistics
+ */
+typedef struct {
+    uint64_t published;                        /**< Frames published */
+    uint64_t dropped;                          /**< Frames reclaimed before every consumer had them */
+    uint64_t refused;                          /**< Acquires that got no slot */
+    uint64_t waits;                            /**< Acquires that had to wait */
+    uint64_t retired;                          /**< Published frames whose slot became reusable */
+    uint64_t stage_latency_ns[OFRAME_STAGE_COUNT]; /**< Mean time from acquire to each stage, over retired frames */
+} OcularFrameRingStats;
+
+/**
+ * @brief Create a frame ring
+ *
+ * @param slots Number of frame slots (at least 2, so one can be filled
+ *              while another is read)
+ * @param frame_capacity Bytes per slot
+ * @param consumers Consumers that each see every frame unless it is dropped
+ * @param policy Drop policy
+ * @return Ring, or NULL on invalid arguments or allocation failure
+ */
+OcularFrameRing *ofring_create(uint32_t slots, uint32_t frame_capacity, uint32_t consumers,
+                               OcularFrameDropPolicy policy);
+
+/**
+ * @brief Destroy a frame ring
+ *
+ * No frame may still be held or waited for.
+ *
+ * @param ring Ring (may be NULL)
+ */
+void ofring_destroy(OcularFrameRing *ring);
+
+/**
+ * @brief Take a slot to fill
+ *
+ * @param ring Ring
+ * @return Frame to fill and publish (or discard), or NULL if the drop
+ *         policy refused it
+ */
+OcularFrame *ofring_acquire(OcularFrameRing *ring);
+
+/**
+ * @brief Stamp a frame with the current time for a stage
+ *
+ * @param frame Frame
+ * @param stage Stage reached
+ */
+void ofring_mark(OcularFrame *frame, OcularFrameStage stage);
+
+/**
+ * @brief Make a filled frame visible to consumers
+ *
+ * @param ring Ring
+ * @param frame Acquired frame with size set
+ * @return The frame's sequence, or 0 if the frame was not acquired or
+ *         its size exceeds the capacity
+ */
+uint64_t ofring_publish(OcularFrameRing *ring, OcularFrame *frame);
+
+/**
+ * @brief Give back an acquired frame without publishing it
+ *
+ * @param ring Ring
+ * @param frame Acquired frame
+ */
+void ofring_discard(OcularFrameRing *ring, OcularFrame *frame);
+
+/**
+ * @brief Borrow the next published frame for a consumer
+ *
+ * Frames skipped to reach the newest count as had by this consumer.
+ *
+ * @param ring Ring
+ * @param cursor Consumer's cursor: the sequence of the last frame it
+ *               borrowed (start at 0); advanced on success
+ * @param latest Whether to skip to the newest published frame
+ * @return Borrowed frame, to be released with ofring_release(), or NULL
+ *         if there is nothing newer than the cursor
+ */
+OcularFrame *ofring_borrow(OcularFrameRing *ring, uint64_t *cursor, bool latest);
+
+/**
+ * @brief Add a reference to a borrowed frame
+ *
+ * @param frame Frame
+ * @return The same frame
+ */
+OcularFrame *ofring_retain(OcularFrame *frame);
+
+/**
+ * @brief Drop a reference to a borrowed frame
+ *
+ * @param frame Frame
+ */
+void ofring_release(OcularFrame *frame);
+
+/**
+ * @brief Release callback releasing a frame given as the context
+ *
+ * Matches QBufferReleaseFn, so a retained frame can back a message bus
+ * buffer: qbus_buffer_wrap(frame->data, frame->size, ofring_release_buffer, frame).
+ *
+ * @param data Frame data (unused)
+ * @param context Frame
+ */
+void ofring_release_buffer(void *data, void *context);
+
+/**
+ * @brief Read the ring statistics
+ *
+ * @param ring Ring
+ * @param stats Pointer to store the statistics
+ * @return true if successful, false otherwise
+ */
+bool ofring_get_stats(OcularFrameRing *ring, OcularFrameRingStats *stats);
+
+#endif /* CTRLXT_OCULAR_FRAME_RING_H */
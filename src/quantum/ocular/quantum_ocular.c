@@ -1,53 +1,157 @@
 /**
  * @file quantum_ocular.c
  * @brief Implementation of the Quantum Ocular Processing Unit (Q-OPU)
+ *
+ * Visual enhancements run in process on the raw samples. Each kernel has
+ * a scalar, SSE2, AVX2 and NEON version computing the same fixed-point
+ * formula, so every version gives bit-identical output; the SIMD versions
+ * hand any tail shorter than a register to the scalar one.
+ *
+ * Chains of enhancements run as pipelines: every stage is applied to one
+ * tile while it is in cache, tiles are claimed from an atomic counter by
+ * the caller and the pipeline's workers, and the only scratch (the fusion
+ * state unrolled to a tile's length) lives in an arena reused per frame.
  */
 
+/* strdup, popen and sysconf(_SC_NPROCESSORS_ONLN) under -std=c11 */
+#define _XOPEN_SOURCE 700
+
 #include "quantum_ocular.h"
+#include "../../kernel/trace/trace.h"
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
 #include <sys/wait.h>
 #include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define OCULAR_HAVE_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define OCULAR_HAVE_NEON 1
+#endif
 
 /* Path to the ocular_prime.sh script */
 #define OCULAR_SCRIPT_PATH "./src/quantum/ocular/ocular_prime.sh"
 
+/* Script command and output limits */
+#define OCULAR_COMMAND_SIZE 1024
+#define OCULAR_OUTPUT_SIZE 4096
+
+/* Frame bytes per pipeline tile, small enough to stay in L2 across stages */
+#define OCULAR_TILE_SIZE (64 * 1024)
+
+/* Most threads a pipeline runs tiles on, and most stages it holds */
+#define OCULAR_MAX_PIPELINE_THREADS 8
+#define OCULAR_MAX_STAGES 5
+
 /* Maximum number of blink spots and channels */
 #define MAX_BLINK_SPOTS 100
 #define MAX_CHANNELS 13
 
+/**
+ * @brief One implementation of the enhancement kernels
+ *
+ * Parameters are fixed point: gain is 128..256 (1x..2x), the overlay
+ * weight 0..256 and the fusion weight 0..128.
+ */
+typedef struct {
+    OcularKernel kernel;
+    void (*clarity)(uint8_t *data, size_t length, uint16_t gain);
+    void (*overlay)(uint8_t *data, size_t length, uint16_t weight);
+    void (*filter)(uint8_t *data, size_t length, uint8_t threshold);
+    void (*shift)(uint8_t *data, size_t length, uint8_t offset);
+    void (*fuse)(uint8_t *data, const uint8_t *state, size_t length, uint8_t weight);
+} OcularKernelTable;
+
+/**
+ * @brief One enhancement in a pipeline
+ */
+typedef struct {
+    QuantumEnhancementType type;       /**< Enhancement */
+    float strength;                    /**< Strength for the script path */
+    uint16_t parameter;                /**< Fixed-point kernel parameter */
+} OcularStage;
+
+/**
+ * @brief Compiled pipeline and the frame it is running
+ */
+struct OcularPipeline {
+    OcularStage stages[OCULAR_MAX_STAGES];
+    uint32_t stage_count;
+    
+    pthread_t workers[OCULAR_MAX_PIPELINE_THREADS];
+    uint32_t worker_count;             /**< Threads besides the caller */
+    pthread_mutex_t lock;
+    pthread_cond_t start;              /**< Signalled when a frame is posted */
+    pthread_cond_t done;               /**< Signalled when the last worker finishes */
+    uint64_t generation;               /**< Frames posted */
+    uint32_t running;                  /**< Workers still on the current frame */
+    bool stopping;
+    
+    uint8_t *arena;                    /**< Unrolled fusion state */
+    size_t arena_size;
+    
+    /* Current frame, written before it is posted */
+    const OcularKernelTable *kernels;
+    const uint8_t *input;
+    uint8_t *output;
+    uint32_t length;                   /**< Bytes computed */
+    uint32_t state_size;
+    uint32_t tile_count;
+    atomic_uint next_tile;
+};
+
 /* Static variables for Q-OPU state */
 static OcularConfig current_config;
 static BlinkSpot blink_spots[MAX_BLINK_SPOTS];
 static LightSpectrumChannel channels[MAX_CHANNELS];
 static bool initialized = false;
+static const OcularKernelTable *active_kernels = NULL;
+static OcularPipeline *frame_pipeline = NULL;
+static pthread_mutex_t frame_pipeline_lock = PTHREAD_MUTEX_INITIALIZER;
 
 /* Internal functions */
 
+/**
+ * @brief Append to a bounded string
+ *
+ * @return false if the text did not fit
+ */
+static bool append_text(char *buffer, size_t size, size_t *length, const char *text) {
+    size_t text_length = strlen(text);
+    if (*length + text_length >= size) {
+        return false;
+    }
+    memcpy(buffer + *length, text, text_length + 1);
+    *length += text_length;
+    return true;
+}
+
 /**
  * @brief Execute the ocular_prime.sh script with arguments
  */
 static char *execute_ocular_script(const char *command, const char *args[]) {
-    char cmd[1024] = {0};
+    char cmd[OCULAR_COMMAND_SIZE] = {0};
+    size_t cmd_length = 0;
     char *result = NULL;
+    size_t result_length = 0;
     FILE *pipe = NULL;
     char buffer[1024] = {0};
     
     /* Build the command */
-    strcat(cmd, "bash ");
-    strcat(cmd, OCULAR_SCRIPT_PATH);
-    strcat(cmd, " ");
-    strcat(cmd, command);
-    
-    if (args) {
-        int i = 0;
-        while (args[i]) {
-            strcat(cmd, " \"");
-            strcat(cmd, args[i]);
-            strcat(cmd, "\"");
-            i++;
-        }
+    bool fits = append_text(cmd, sizeof(cmd), &cmd_length, "bash " OCULAR_SCRIPT_PATH " ") &&
+                append_text(cmd, sizeof(cmd), &cmd_length, command);
+    for (int i = 0; fits && args && args[i]; i++) {
+        fits = append_text(cmd, sizeof(cmd), &cmd_length, " \"") &&
+               append_text(cmd, sizeof(cmd), &cmd_length, args[i]) &&
+               append_text(cmd, sizeof(cmd), &cmd_length, "\"");
+    }
+    if (!fits) {
+        return NULL;
     }
     
     /* Execute the command */
@@ -56,8 +160,8 @@ static char *execute_ocular_script(const char *command, const char *args[]) {
         return NULL;
     }
     
-    /* Read the output */
-    result = malloc(4096);
+    /* Read the output, keeping what fits */
+    result = malloc(OCULAR_OUTPUT_SIZE);
     if (!result) {
         pclose(pipe);
         return NULL;
@@ -65,13 +169,358 @@ static char *execute_ocular_script(const char *command, const char *args[]) {
     
     result[0] = '\0';
     while (fgets(buffer, sizeof(buffer), pipe)) {
-        strcat(result, buffer);
+        append_text(result, OCULAR_OUTPUT_SIZE, &result_length, buffer);
     }
     
     pclose(pipe);
     return result;
 }
 
+/**
+ * @brief Contrast stretch around mid-grey: (v * gain - 128 * (gain - 128)) / 128
+ */
+static void clarity_scalar(uint8_t *data, size_t length, uint16_t gain) {
+    uint32_t bias = 128u * (gain - 128u);
+    for (size_t i = 0; i < length; i++) {
+        uint32_t value = data[i] * (uint32_t)gain;
+        value = value > bias ? (value - bias) >> 7 : 0;
+        data[i] = (uint8_t)(value > 255 ? 255 : value);
+    }
+}
+
+/**
+ * @brief Lift toward the screen blend: v + weight * (v * (255 - v) / 64) / 1024
+ */
+static void overlay_scalar(uint8_t *data, size_t length, uint16_t weight) {
+    for (size_t i = 0; i < length; i++) {
+        uint32_t lift = ((data[i] * (255u - data[i])) >> 6) * weight >> 10;
+        data[i] = (uint8_t)(data[i] + lift);
+    }
+}
+
+/**
+ * @brief Zero samples below the threshold
+ */
+static void filter_scalar(uint8_t *data, size_t length, uint8_t threshold) {
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] < threshold) {
+            data[i] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Rotate sample values by an offset
+ */
+static void shift_scalar(uint8_t *data, size_t length, uint8_t offset) {
+    for (size_t i = 0; i < length; i++) {
+        data[i] = (uint8_t)(data[i] + offset);
+    }
+}
+
+/**
+ * @brief Blend state into samples: (v * (128 - weight) + q * weight) / 128
+ */
+static void fuse_scalar(uint8_t *data, const uint8_t *state, size_t length, uint8_t weight) {
+    for (size_t i = 0; i < length; i++) {
+        data[i] = (uint8_t)((data[i] * (128u - weight) + state[i] * (uint32_t)weight) >> 7);
+    }
+}
+
+static const OcularKernelTable scalar_kernels = {
+    OCULAR_KERNEL_SCALAR, clarity_scalar, overlay_scalar, filter_scalar, shift_scalar, fuse_scalar
+};
+
+/* The script path has no kernels; callers check the kind first */
+static const OcularKernelTable script_kernels = {
+    OCULAR_KERNEL_SCRIPT, NULL, NULL, NULL, NULL, NULL
+};
+
+#ifdef OCULAR_HAVE_X86
+__attribute__((target("sse2")))
+static void clarity_sse2(uint8_t *data, size_t length, uint16_t gain) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i scale = _mm_set1_epi16((short)gain);
+    const __m128i bias = _mm_set1_epi16((short)(128 * (gain - 128)));
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i value = _mm_loadu_si128((const __m128i *)(data + i));
+        __m128i low = _mm_mullo_epi16(_mm_unpacklo_epi8(value, zero), scale);
+        __m128i high = _mm_mullo_epi16(_mm_unpackhi_epi8(value, zero), scale);
+        low = _mm_srli_epi16(_mm_subs_epu16(low, bias), 7);
+        high = _mm_srli_epi16(_mm_subs_epu16(high, bias), 7);
+        _mm_storeu_si128((__m128i *)(data + i), _mm_packus_epi16(low, high));
+    }
+    clarity_scalar(data + i, length - i, gain);
+}
+
+__attribute__((target("sse2")))
+static void overlay_sse2(uint8_t *data, size_t length, uint16_t weight) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i white = _mm_set1_epi16(255);
+    const __m128i scale = _mm_set1_epi16((short)weight);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i value = _mm_loadu_si128((const __m128i *)(data + i));
+        __m128i low = _mm_unpacklo_epi8(value, zero);
+        __m128i high = _mm_unpackhi_epi8(value, zero);
+        __m128i low_lift = _mm_srli_epi16(_mm_mullo_epi16(low, _mm_sub_epi16(white, low)), 6);
+        __m128i high_lift = _mm_srli_epi16(_mm_mullo_epi16(high, _mm_sub_epi16(white, high)), 6);
+        low = _mm_add_epi16(low, _mm_srli_epi16(_mm_mullo_epi16(low_lift, scale), 10));
+        high = _mm_add_epi16(high, _mm_srli_epi16(_mm_mullo_epi16(high_lift, scale), 10));
+        _mm_storeu_si128((__m128i *)(data + i), _mm_packus_epi16(low, high));
+    }
+    overlay_scalar(data + i, length - i, weight);
+}
+
+__attribute__((target("sse2")))
+static void filter_sse2(uint8_t *data, size_t length, uint8_t threshold) {
+    const __m128i limit = _mm_set1_epi8((char)threshold);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i value = _mm_loadu_si128((const __m128i *)(data + i));
+        __m128i keep = _mm_cmpeq_epi8(_mm_max_epu8(value, limit), value);
+        _mm_storeu_si128((__m128i *)(data + i), _mm_and_si128(value, keep));
+    }
+    filter_scalar(data + i, length - i, threshold);
+}
+
+__attribute__((target("sse2")))
+static void shift_sse2(uint8_t *data, size_t length, uint8_t offset) {
+    const __m128i step = _mm_set1_epi8((char)offset);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i value = _mm_loadu_si128((const __m128i *)(data + i));
+        _mm_storeu_si128((__m128i *)(data + i), _mm_add_epi8(value, step));
+    }
+    shift_scalar(data + i, length - i, offset);
+}
+
+__attribute__((target("sse2")))
+static void fuse_sse2(uint8_t *data, const uint8_t *state, size_t length, uint8_t weight) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i keep = _mm_set1_epi16((short)(128 - weight));
+    const __m128i take = _mm_set1_epi16((short)weight);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i value = _mm_loadu_si128((const __m128i *)(data + i));
+        __m128i other = _mm_loadu_si128((const __m128i *)(state + i));
+        __m128i low = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(value, zero), keep),
+                                    _mm_mullo_epi16(_mm_unpacklo_epi8(other, zero), take));
+        __m128i high = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(value, zero), keep),
+                                     _mm_mullo_epi16(_mm_unpackhi_epi8(other, zero), take));
+        _mm_storeu_si128((__m128i *)(data + i),
+                         _mm_packus_epi16(_mm_srli_epi16(low, 7), _mm_srli_epi16(high, 7)));
+    }
+    fuse_scalar(data + i, state + i, length - i, weight);
+}
+
+/* 256-bit unpack and pack both work per 128-bit lane, so they undo each other */
+__attribute__((target("avx2")))
+static void clarity_avx2(uint8_t *data, size_t length, uint16_t gain) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i scale = _mm256_set1_epi16((short)gain);
+    const __m256i bias = _mm256_set1_epi16((short)(128 * (gain - 128)));
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i value = _mm256_loadu_si256((const __m256i *)(data + i));
+        __m256i low = _mm256_mullo_epi16(_mm256_unpacklo_epi8(value, zero), scale);
+        __m256i high = _mm256_mullo_epi16(_mm256_unpackhi_epi8(value, zero), scale);
+        low = _mm256_srli_epi16(_mm256_subs_epu16(low, bias), 7);
+        high = _mm256_srli_epi16(_mm256_subs_epu16(high, bias), 7);
+        _mm256_storeu_si256((__m256i *)(data + i), _mm256_packus_epi16(low, high));
+    }
+    clarity_scalar(data + i, length - i, gain);
+}
+
+__attribute__((target("avx2")))
+static void overlay_avx2(uint8_t *data, size_t length, uint16_t weight) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i white = _mm256_set1_epi16(255);
+    const __m256i scale = _mm256_set1_epi16((short)weight);
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i value = _mm256_loadu_si256((const __m256i *)(data + i));
+        __m256i low = _mm256_unpacklo_epi8(value, zero);
+        __m256i high = _mm256_unpackhi_epi8(value, zero);
+        __m256i low_lift = _mm256_srli_epi16(_mm256_mullo_epi16(low, _mm256_sub_epi16(white, low)), 6);
+        __m256i high_lift = _mm256_srli_epi16(_mm256_mullo_epi16(high, _mm256_sub_epi16(white, high)), 6);
+        low = _mm256_add_epi16(low, _mm256_srli_epi16(_mm256_mullo_epi16(low_lift, scale), 10));
+        high = _mm256_add_epi16(high, _mm256_srli_epi16(_mm256_mullo_epi16(high_lift, scale), 10));
+        _mm256_storeu_si256((__m256i *)(data + i), _mm256_packus_epi16(low, high));
+    }
+    overlay_scalar(data + i, length - i, weight);
+}
+
+__attribute__((target("avx2")))
+static void filter_avx2(uint8_t *data, size_t length, uint8_t threshold) {
+    const __m256i limit = _mm256_set1_epi8((char)threshold);
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i value = _mm256_loadu_si256((const __m256i *)(data + i));
+        __m256i keep = _mm256_cmpeq_epi8(_mm256_max_epu8(value, limit), value);
+        _mm256_storeu_si256((__m256i *)(data + i), _mm256_and_si256(value, keep));
+    }
+    filter_scalar(data + i, length - i, threshold);
+}
+
+__attribute__((target("avx2")))
+static void shift_avx2(uint8_t *data, size_t length, uint8_t offset) {
+    const __m256i step = _mm256_set1_epi8((char)offset);
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i value = _mm256_loadu_si256((const __m256i *)(data + i));
+        _mm256_storeu_si256((__m256i *)(data + i), _mm256_add_epi8(value, step));
+    }
+    shift_scalar(data + i, length - i, offset);
+}
+
+__attribute__((target("avx2")))
+static void fuse_avx2(uint8_t *data, const uint8_t *state, size_t length, uint8_t weight) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i keep = _mm256_set1_epi16((short)(128 - weight));
+    const __m256i take = _mm256_set1_epi16((short)weight);
+    size_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i value = _mm256_loadu_si256((const __m256i *)(data + i));
+        __m256i other = _mm256_loadu_si256((const __m256i *)(state + i));
+        __m256i low = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(value, zero), keep),
+                                       _mm256_mullo_epi16(_mm256_unpacklo_epi8(other, zero), take));
+        __m256i high = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(value, zero), keep),
+                                        _mm256_mullo_epi16(_mm256_unpackhi_epi8(other, zero), take));
+        _mm256_storeu_si256((__m256i *)(data + i),
+                            _mm256_packus_epi16(_mm256_srli_epi16(low, 7), _mm256_srli_epi16(high, 7)));
+    }
+    fuse_scalar(data + i, state + i, length - i, weight);
+}
+
+static const OcularKernelTable sse2_kernels = {
+    OCULAR_KERNEL_SSE2, clarity_sse2, overlay_sse2, filter_sse2, shift_sse2, fuse_sse2
+};
+
+static const OcularKernelTable avx2_kernels = {
+    OCULAR_KERNEL_AVX2, clarity_avx2, overlay_avx2, filter_avx2, shift_avx2, fuse_avx2
+};
+#endif
+
+#ifdef OCULAR_HAVE_NEON
+static void clarity_neon(uint8_t *data, size_t length, uint16_t gain) {
+    const uint16x8_t scale = vdupq_n_u16(gain);
+    const uint16x8_t bias = vdupq_n_u16((uint16_t)(128 * (gain - 128)));
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t value = vld1q_u8(data + i);
+        uint16x8_t low = vmulq_u16(vmovl_u8(vget_low_u8(value)), scale);
+        uint16x8_t high = vmulq_u16(vmovl_u8(vget_high_u8(value)), scale);
+        low = vshrq_n_u16(vqsubq_u16(low, bias), 7);
+        high = vshrq_n_u16(vqsubq_u16(high, bias), 7);
+        vst1q_u8(data + i, vcombine_u8(vqmovn_u16(low), vqmovn_u16(high)));
+    }
+    clarity_scalar(data + i, length - i, gain);
+}
+
+static void overlay_neon(uint8_t *data, size_t length, uint16_t weight) {
+    const uint8x16_t white = vdupq_n_u8(255);
+    const uint16x8_t scale = vdupq_n_u16(weight);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t value = vld1q_u8(data + i);
+        uint8x16_t inverse = vsubq_u8(white, value);
+        uint16x8_t low = vshrq_n_u16(vmull_u8(vget_low_u8(value), vget_low_u8(inverse)), 6);
+        uint16x8_t high = vshrq_n_u16(vmull_u8(vget_high_u8(value), vget_high_u8(inverse)), 6);
+        uint8x16_t lift = vcombine_u8(vmovn_u16(vshrq_n_u16(vmulq_u16(low, scale), 10)),
+                                      vmovn_u16(vshrq_n_u16(vmulq_u16(high, scale), 10)));
+        vst1q_u8(data + i, vqaddq_u8(value, lift));
+    }
+    overlay_scalar(data + i, length - i, weight);
+}
+
+static void filter_neon(uint8_t *data, size_t length, uint8_t threshold) {
+    const uint8x16_t limit = vdupq_n_u8(threshold);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t value = vld1q_u8(data + i);
+        vst1q_u8(data + i, vandq_u8(value, vcgeq_u8(value, limit)));
+    }
+    filter_scalar(data + i, length - i, threshold);
+}
+
+static void shift_neon(uint8_t *data, size_t length, uint8_t offset) {
+    const uint8x16_t step = vdupq_n_u8(offset);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        vst1q_u8(data + i, vaddq_u8(vld1q_u8(data + i), step));
+    }
+    shift_scalar(data + i, length - i, offset);
+}
+
+static void fuse_neon(uint8_t *data, const uint8_t *state, size_t length, uint8_t weight) {
+    const uint8x8_t keep = vdup_n_u8((uint8_t)(128 - weight));
+    const uint8x8_t take = vdup_n_u8(weight);
+    size_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        uint8x16_t value = vld1q_u8(data + i);
+        uint8x16_t other = vld1q_u8(state + i);
+        uint16x8_t low = vmlal_u8(vmull_u8(vget_low_u8(value), keep), vget_low_u8(other), take);
+        uint16x8_t high = vmlal_u8(vmull_u8(vget_high_u8(value), keep), vget_high_u8(other), take);
+        vst1q_u8(data + i, vcombine_u8(vshrn_n_u16(low, 7), vshrn_n_u16(high, 7)));
+    }
+    fuse_scalar(data + i, state + i, length - i, weight);
+}
+
+static const OcularKernelTable neon_kernels = {
+    OCULAR_KERNEL_NEON, clarity_neon, overlay_neon, filter_neon, shift_neon, fuse_neon
+};
+#endif
+
+/**
+ * @brief Kernels enhancements run on (scalar until one is selected)
+ */
+static const OcularKernelTable *current_kernels(void) {
+    return active_kernels ? active_kernels : &scalar_kernels;
+}
+
+/**
+ * @brief Fixed-point weight for a strength in [0, 1]
+ */
+static uint16_t fixed_weight(float strength, uint16_t one) {
+    return (uint16_t)(strength * one + 0.5f);
+}
+
+/**
+ * @brief Run one enhancement through ocular_prime.sh
+ */
+static bool run_enhancement_script(const char *enhancement, float value, const char *label) {
+    char value_str[32];
+    snprintf(value_str, sizeof(value_str), "%f", value);
+    
+    const char *args[] = {enhancement, value_str, NULL};
+    char *result = execute_ocular_script("enhance_visual", args);
+    
+    if (!result) {
+        return false;
+    }
+    
+    printf("%s: %s\n", label, result);
+    free(result);
+    
+    return true;
+}
+
+/**
+ * @brief Blend a state into visual samples, repeating it across them
+ */
+static void fuse_samples(QuantumVisualData *visual_data, const void *state, uint32_t state_size,
+                         float strength) {
+    const OcularKernelTable *kernels = current_kernels();
+    uint8_t *data = (uint8_t *)visual_data->raw_data;
+    uint8_t weight = (uint8_t)fixed_weight(strength, 128);
+    for (uint32_t offset = 0; offset < visual_data->raw_size; offset += state_size) {
+        uint32_t length = visual_data->raw_size - offset;
+        kernels->fuse(data + offset, (const uint8_t *)state, length < state_size ? length : state_size, weight);
+    }
+}
+
 /**
  * @brief Initialize the light spectrum channels
  */
@@ -147,6 +596,11 @@ bool qopu_init(OcularConfig config) {
         initialize_light_channels();
     }
     
+    /* Enhancements run natively unless a kernel was already chosen */
+    if (!active_kernels) {
+        qopu_set_enhancement_kernel(OCULAR_KERNEL_AUTO);
+    }
+    
     /* Execute the initialization script */
     const char *args[] = {NULL};
     char *result = execute_ocular_script("initialize_q_opu", args);
@@ -500,22 +954,12 @@ static bool apply_quantum_clarity(QuantumVisualData *visual_data, float strength
     if (!visual_data || !visual_data->raw_data || strength <= 0.0f || strength > 1.0f) {
         return false;
     }
-
-    // Execute quantum clarity enhancement via script
-    char strength_str[32];
-    sprintf(strength_str, "%f", strength);
-    
-    const char *args[] = {"quantum_clarity", strength_str, NULL};
-    char *result = execute_ocular_script("enhance_visual", args);
-    
-    if (!result) {
-        return false;
+    if (current_kernels()->kernel == OCULAR_KERNEL_SCRIPT) {
+        return run_enhancement_script("quantum_clarity", strength, "Applied quantum clarity enhancement");
     }
     
-    // Process the result and update visual data
-    printf("Applied quantum clarity enhancement: %s\n", result);
-    free(result);
-    
+    current_kernels()->clarity((uint8_t *)visual_data->raw_data, visual_data->raw_size,
+                               (uint16_t)(128 + fixed_weight(strength, 128)));
     return true;
 }
 
@@ -526,22 +970,12 @@ static bool apply_reality_overlay(QuantumVisualData *visual_data, float strength
     if (!visual_data || !visual_data->raw_data || strength <= 0.0f || strength > 1.0f) {
         return false;
     }
-
-    // Execute reality overlay enhancement via script
-    char strength_str[32];
-    sprintf(strength_str, "%f", strength);
-    
-    const char *args[] = {"reality_overlay", strength_str, NULL};
-    char *result = execute_ocular_script("enhance_visual", args);
-    
-    if (!result) {
-        return false;
+    if (current_kernels()->kernel == OCULAR_KERNEL_SCRIPT) {
+        return run_enhancement_script("reality_overlay", strength, "Applied reality overlay enhancement");
     }
     
-    // Process the result and update visual data
-    printf("Applied reality overlay enhancement: %s\n", result);
-    free(result);
-    
+    current_kernels()->overlay((uint8_t *)visual_data->raw_data, visual_data->raw_size,
+                               fixed_weight(strength, 256));
     return true;
 }
 
@@ -552,22 +986,12 @@ static bool apply_quantum_filter(QuantumVisualData *visual_data, float threshold
     if (!visual_data || !visual_data->raw_data || threshold < 0.0f || threshold > 1.0f) {
         return false;
     }
-
-    // Execute quantum filtering via script
-    char threshold_str[32];
-    sprintf(threshold_str, "%f", threshold);
-    
-    const char *args[] = {"quantum_filter", threshold_str, NULL};
-    char *result = execute_ocular_script("enhance_visual", args);
-    
-    if (!result) {
-        return false;
+    if (current_kernels()->kernel == OCULAR_KERNEL_SCRIPT) {
+        return run_enhancement_script("quantum_filter", threshold, "Applied quantum filtering");
     }
     
-    // Process the result and update visual data
-    printf("Applied quantum filtering: %s\n", result);
-    free(result);
-    
+    current_kernels()->filter((uint8_t *)visual_data->raw_data, visual_data->raw_size,
+                              (uint8_t)fixed_weight(threshold, 255));
     return true;
 }
 
@@ -578,22 +1002,12 @@ static bool apply_dimensional_shift(QuantumVisualData *visual_data, float factor
     if (!visual_data || !visual_data->raw_data || factor <= 0.0f || factor > 1.0f) {
         return false;
     }
-
-    // Execute dimensional shift enhancement via script
-    char factor_str[32];
-    sprintf(factor_str, "%f", factor);
-    
-    const char *args[] = {"dimensional_shift", factor_str, NULL};
-    char *result = execute_ocular_script("enhance_visual", args);
-    
-    if (!result) {
-        return false;
+    if (current_kernels()->kernel == OCULAR_KERNEL_SCRIPT) {
+        return run_enhancement_script("dimensional_shift", factor, "Applied dimensional shift enhancement");
     }
     
-    // Process the result and update visual data
-    printf("Applied dimensional shift enhancement: %s\n", result);
-    free(result);
-    
+    current_kernels()->shift((uint8_t *)visual_data->raw_data, visual_data->raw_size,
+                             (uint8_t)fixed_weight(factor, 255));
     return true;
 }
 
@@ -605,25 +1019,64 @@ static bool apply_quantum_fusion(QuantumVisualData *visual_data, float strength)
         strength <= 0.0f || strength > 1.0f) {
         return false;
     }
-
-    // Execute quantum fusion via script
-    char strength_str[32];
-    sprintf(strength_str, "%f", strength);
-    
-    const char *args[] = {"quantum_fusion", strength_str, NULL};
-    char *result = execute_ocular_script("enhance_visual", args);
-    
-    if (!result) {
+    if (current_kernels()->kernel == OCULAR_KERNEL_SCRIPT) {
+        return run_enhancement_script("quantum_fusion", strength, "Applied quantum state fusion");
+    }
+    if (visual_data->quantum_state_size == 0) {
         return false;
     }
     
-    // Process the result and update visual data
-    printf("Applied quantum state fusion: %s\n", result);
-    free(result);
+    fuse_samples(visual_data, visual_data->quantum_state, visual_data->quantum_state_size, strength);
+    return true;
+}
+
+/**
+ * @brief Select how visual enhancements are computed
+ */
+bool qopu_set_enhancement_kernel(OcularKernel kernel) {
+    const OcularKernelTable *kernels = NULL;
+#ifdef OCULAR_HAVE_X86
+    __builtin_cpu_init();
+    bool has_avx2 = __builtin_cpu_supports("avx2");
+    bool has_sse2 = __builtin_cpu_supports("sse2");
+    if (kernel == OCULAR_KERNEL_AUTO) {
+        kernel = has_avx2 ? OCULAR_KERNEL_AVX2 : has_sse2 ? OCULAR_KERNEL_SSE2 : OCULAR_KERNEL_SCALAR;
+    }
+    if (kernel == OCULAR_KERNEL_AVX2 && has_avx2) {
+        kernels = &avx2_kernels;
+    } else if (kernel == OCULAR_KERNEL_SSE2 && has_sse2) {
+        kernels = &sse2_kernels;
+    }
+#elif defined(OCULAR_HAVE_NEON)
+    if (kernel == OCULAR_KERNEL_AUTO || kernel == OCULAR_KERNEL_NEON) {
+        kernel = OCULAR_KERNEL_NEON;
+        kernels = &neon_kernels;
+    }
+#else
+    if (kernel == OCULAR_KERNEL_AUTO) {
+        kernel = OCULAR_KERNEL_SCALAR;
+    }
+#endif
+    if (kernel == OCULAR_KERNEL_SCALAR) {
+        kernels = &scalar_kernels;
+    } else if (kernel == OCULAR_KERNEL_SCRIPT) {
+        kernels = &script_kernels;
+    }
+    if (!kernels) {
+        return false;
+    }
     
+    active_kernels = kernels;
     return true;
 }
 
+/**
+ * @brief Get the kernel visual enhancements are computed with
+ */
+OcularKernel qopu_get_enhancement_kernel(void) {
+    return current_kernels()->kernel;
+}
+
 /**
  * @brief Apply quantum enhancements to visual data
  */
@@ -663,7 +1116,7 @@ bool qopu_apply_quantum_enhancement(QuantumVisualData *visual_data,
     
     if (success) {
         // Update enhancement weights
-        if (visual_data->enhancement_weights) {
+        if (visual_data->enhancement_weights && enhancement_type < visual_data->weight_count) {
             visual_data->enhancement_weights[enhancement_type] = strength;
         }
     }
@@ -682,30 +1135,23 @@ bool qopu_fuse_quantum_state(QuantumVisualData *visual_data,
         return false;
     }
 
-    // Execute quantum state fusion via script
-    char strength_str[32];
-    sprintf(strength_str, "%f", fusion_strength);
-    
-    const char *args[] = {"fuse_quantum_state", strength_str, NULL};
-    char *result = execute_ocular_script("enhance_visual", args);
-    
-    if (!result) {
-        return false;
+    if (current_kernels()->kernel == OCULAR_KERNEL_SCRIPT) {
+        if (!run_enhancement_script("fuse_quantum_state", fusion_strength,
+                                    "Fused quantum state with visual data")) {
+            return false;
+        }
+    } else if (visual_data->quantum_state_size > 0) {
+        fuse_samples(visual_data, quantum_state, visual_data->quantum_state_size, fusion_strength);
     }
     
-    // Process the result and update visual data
-    printf("Fused quantum state with visual data: %s\n", result);
-    free(result);
-    
-    // Update quantum state
-    if (visual_data->quantum_state) {
-        free(visual_data->quantum_state);
-    }
-    visual_data->quantum_state = malloc(visual_data->quantum_state_size);
-    if (!visual_data->quantum_state) {
+    // Keep a copy of the state, which may be the one the data already holds
+    void *state_copy = malloc(visual_data->quantum_state_size);
+    if (!state_copy) {
         return false;
     }
-    memcpy(visual_data->quantum_state, quantum_state, visual_data->quantum_state_size);
+    memcpy(state_copy, quantum_state, visual_data->quantum_state_size);
+    free(visual_data->quantum_state);
+    visual_data->quantum_state = state_copy;
     
     visual_data->is_quantum_entangled = true;
     
@@ -713,18 +1159,149 @@ bool qopu_fuse_quantum_state(QuantumVisualData *visual_data,
 }
 
 /**
- * @brief Process visual input through the Q-OPU with enhanced capabilities
+ * @brief Compile the flagged enhancements of some parameters into stages
+ *
+ * @return false if a flagged strength is out of range
  */
-int32_t qopu_process_visual_enhanced(const QuantumVisualData *input_data,
-                                   const VisualProcessingParams *params,
-                                   void *output_buffer,
-                                   uint32_t output_size) {
-    if (!initialized || !input_data || !input_data->raw_data || !params || 
-        !output_buffer || output_size == 0) {
-        return -1;
+static bool compile_stages(const VisualProcessingParams *params, OcularStage *stages, uint32_t *count) {
+    const struct {
+        QuantumEnhancementType type;
+        float strength;
+        uint16_t one;
+    } order[OCULAR_MAX_STAGES] = {
+        { ENHANCE_QUANTUM_CLARITY, params->quantum_clarity_factor, 128 },
+        { ENHANCE_REALITY_OVERLAY, params->reality_overlay_strength, 256 },
+        { ENHANCE_QUANTUM_FILTER, params->quantum_filter_threshold, 255 },
+        { ENHANCE_DIMENSIONAL_SHIFT, params->dimensional_shift_factor, 255 },
+        { ENHANCE_QUANTUM_FUSION, 1.0f, 128 }
+    };
+    
+    *count = 0;
+    if (params->mode == VISUAL_MODE_STANDARD) {
+        return true;
+    }
+    for (uint32_t i = 0; i < OCULAR_MAX_STAGES; i++) {
+        if (!(params->enhancement_flags & order[i].type)) {
+            continue;
+        }
+        if (!(order[i].strength > 0.0f && order[i].strength <= 1.0f)) {
+            return false;
+        }
+        OcularStage *stage = &stages[(*count)++];
+        stage->type = order[i].type;
+        stage->strength = order[i].strength;
+        stage->parameter = fixed_weight(order[i].strength, order[i].one);
+        if (stage->type == ENHANCE_QUANTUM_CLARITY) {
+            stage->parameter += 128;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Run every stage over one tile
+ */
+static void run_tile(OcularPipeline *pipeline, uint32_t tile) {
+    const OcularKernelTable *kernels = pipeline->kernels;
+    uint32_t start = tile * OCULAR_TILE_SIZE;
+    uint32_t length = pipeline->length - start < OCULAR_TILE_SIZE ? pipeline->length - start
+                                                                  : OCULAR_TILE_SIZE;
+    uint8_t *data = pipeline->output + start;
+    if (data != pipeline->input + start) {
+        memcpy(data, pipeline->input + start, length);
+    }
+    
+    for (uint32_t i = 0; i < pipeline->stage_count; i++) {
+        const OcularStage *stage = &pipeline->stages[i];
+        switch (stage->type) {
+            case ENHANCE_QUANTUM_CLARITY:
+                kernels->clarity(data, length, stage->parameter);
+                break;
+            case ENHANCE_REALITY_OVERLAY:
+                kernels->overlay(data, length, stage->parameter);
+                break;
+            case ENHANCE_QUANTUM_FILTER:
+                kernels->filter(data, length, (uint8_t)stage->parameter);
+                break;
+            case ENHANCE_DIMENSIONAL_SHIFT:
+                kernels->shift(data, length, (uint8_t)stage->parameter);
+                break;
+            case ENHANCE_QUANTUM_FUSION:
+                kernels->fuse(data, pipeline->arena + start % pipeline->state_size, length,
+                              (uint8_t)stage->parameter);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Claim and run tiles until none are left
+ */
+static void run_tiles(OcularPipeline *pipeline) {
+    uint32_t tile;
+    while ((tile = atomic_fetch_add(&pipeline->next_tile, 1)) < pipeline->tile_count) {
+        run_tile(pipeline, tile);
+    }
+}
+
+/**
+ * @brief Pipeline worker: run the tiles of each posted frame
+ */
+static void *pipeline_worker(void *arg) {
+    OcularPipeline *pipeline = (OcularPipeline *)arg;
+    uint64_t seen = 0;
+    
+    pthread_mutex_lock(&pipeline->lock);
+    for (;;) {
+        while (!pipeline->stopping && pipeline->generation == seen) {
+            pthread_cond_wait(&pipeline->start, &pipeline->lock);
+        }
+        if (pipeline->stopping) {
+            break;
+        }
+        seen = pipeline->generation;
+        pthread_mutex_unlock(&pipeline->lock);
+        
+        run_tiles(pipeline);
+        
+        pthread_mutex_lock(&pipeline->lock);
+        if (--pipeline->running == 0) {
+            pthread_cond_signal(&pipeline->done);
+        }
     }
+    pthread_mutex_unlock(&pipeline->lock);
+    return NULL;
+}
+
+/**
+ * @brief Unroll the fusion state so any tile can read it without wrapping
+ */
+static bool unroll_state(OcularPipeline *pipeline, const uint8_t *state, uint32_t state_size) {
+    size_t needed = (size_t)(pipeline->length < OCULAR_TILE_SIZE ? pipeline->length : OCULAR_TILE_SIZE) +
+                    state_size;
+    if (needed > pipeline->arena_size) {
+        uint8_t *arena = (uint8_t *)realloc(pipeline->arena, needed);
+        if (!arena) {
+            return false;
+        }
+        pipeline->arena = arena;
+        pipeline->arena_size = needed;
+    }
+    for (size_t offset = 0; offset < needed; offset += state_size) {
+        size_t length = needed - offset < state_size ? needed - offset : state_size;
+        memcpy(pipeline->arena + offset, state, length);
+    }
+    pipeline->state_size = state_size;
+    return true;
+}
 
-    // Create a copy of the input data for processing
+/**
+ * @brief Run a pipeline's stages one after another through the script
+ */
+static int32_t run_script_pipeline(OcularPipeline *pipeline, const QuantumVisualData *input_data,
+                                   void *output_buffer, uint32_t length) {
     QuantumVisualData processed_data = *input_data;
     processed_data.raw_data = malloc(input_data->raw_size);
     if (!processed_data.raw_data) {
@@ -732,63 +1309,218 @@ int32_t qopu_process_visual_enhanced(const QuantumVisualData *input_data,
     }
     memcpy(processed_data.raw_data, input_data->raw_data, input_data->raw_size);
     
-    // Apply enhancements based on mode and flags
     bool success = true;
+    for (uint32_t i = 0; success && i < pipeline->stage_count; i++) {
+        success = qopu_apply_quantum_enhancement(&processed_data, pipeline->stages[i].type,
+                                                 pipeline->stages[i].strength);
+    }
+    if (success) {
+        memmove(output_buffer, processed_data.raw_data, length);
+    }
+    free(processed_data.raw_data);
+    return success ? (int32_t)length : -1;
+}
+
+/**
+ * @brief Compile processing parameters into a fused pipeline
+ */
+OcularPipeline *qopu_pipeline_create(const VisualProcessingParams *params, uint32_t threads) {
+    if (!params) {
+        return NULL;
+    }
+    OcularPipeline *pipeline = (OcularPipeline *)calloc(1, sizeof(OcularPipeline));
+    if (!pipeline) {
+        return NULL;
+    }
+    if (!compile_stages(params, pipeline->stages, &pipeline->stage_count)) {
+        free(pipeline);
+        return NULL;
+    }
     
-    switch (params->mode) {
-        case VISUAL_MODE_QUANTUM_ENHANCED:
-            if (params->enhancement_flags & ENHANCE_QUANTUM_CLARITY) {
-                success &= qopu_apply_quantum_enhancement(&processed_data,
-                                                        ENHANCE_QUANTUM_CLARITY,
-                                                        params->quantum_clarity_factor);
-            }
-            break;
-            
-        case VISUAL_MODE_REALITY_AUGMENTED:
-            if (params->enhancement_flags & ENHANCE_REALITY_OVERLAY) {
-                success &= qopu_apply_quantum_enhancement(&processed_data,
-                                                        ENHANCE_REALITY_OVERLAY,
-                                                        params->reality_overlay_strength);
-            }
-            break;
-            
-        case VISUAL_MODE_QUANTUM_FUSION:
-            if (params->enhancement_flags & ENHANCE_QUANTUM_FUSION) {
-                success &= qopu_apply_quantum_enhancement(&processed_data,
-                                                        ENHANCE_QUANTUM_FUSION,
-                                                        1.0f);
-            }
-            break;
-            
-        case VISUAL_MODE_MULTIDIMENSIONAL:
-            if (params->enhancement_flags & ENHANCE_DIMENSIONAL_SHIFT) {
-                success &= qopu_apply_quantum_enhancement(&processed_data,
-                                                        ENHANCE_DIMENSIONAL_SHIFT,
-                                                        params->dimensional_shift_factor);
-            }
-            break;
-            
-        default:
-            // Standard processing - no enhancements
-            break;
+    if (threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (uint32_t)online : 1;
+    }
+    if (threads > OCULAR_MAX_PIPELINE_THREADS) {
+        threads = OCULAR_MAX_PIPELINE_THREADS;
     }
+    pthread_mutex_init(&pipeline->lock, NULL);
+    pthread_cond_init(&pipeline->start, NULL);
+    pthread_cond_init(&pipeline->done, NULL);
+    atomic_init(&pipeline->next_tile, 0);
+    
+    /* A worker that fails to start leaves its tiles to the others */
+    while (pipeline->worker_count + 1 < threads &&
+           pthread_create(&pipeline->workers[pipeline->worker_count], NULL, pipeline_worker, pipeline) == 0) {
+        pipeline->worker_count++;
+    }
+    return pipeline;
+}
+
+/**
+ * @brief Run a pipeline over the first length bytes of a frame
+ */
+static int32_t run_pipeline(OcularPipeline *pipeline, const QuantumVisualData *input_data,
+                            void *output_buffer, uint32_t length) {
+    if (current_kernels()->kernel == OCULAR_KERNEL_SCRIPT) {
+        return run_script_pipeline(pipeline, input_data, output_buffer, length);
+    }
+    
+    pipeline->kernels = current_kernels();
+    pipeline->input = (const uint8_t *)input_data->raw_data;
+    pipeline->output = (uint8_t *)output_buffer;
+    pipeline->length = length;
+    pipeline->tile_count = (uint32_t)(((uint64_t)length + OCULAR_TILE_SIZE - 1) / OCULAR_TILE_SIZE);
+    for (uint32_t i = 0; i < pipeline->stage_count; i++) {
+        if (pipeline->stages[i].type == ENHANCE_QUANTUM_FUSION &&
+            (!input_data->quantum_state || input_data->quantum_state_size == 0 ||
+             !unroll_state(pipeline, (const uint8_t *)input_data->quantum_state,
+                           input_data->quantum_state_size))) {
+            return -1;
+        }
+    }
+    atomic_store(&pipeline->next_tile, 0);
+    
+    /* Small frames are not worth waking the workers for */
+    if (pipeline->tile_count < 2 || pipeline->worker_count == 0) {
+        run_tiles(pipeline);
+        return (int32_t)length;
+    }
+    pthread_mutex_lock(&pipeline->lock);
+    pipeline->generation++;
+    pipeline->running = pipeline->worker_count;
+    pthread_cond_broadcast(&pipeline->start);
+    pthread_mutex_unlock(&pipeline->lock);
     
-    if (!success) {
-        free(processed_data.raw_data);
+    run_tiles(pipeline);
+    
+    pthread_mutex_lock(&pipeline->lock);
+    while (pipeline->running > 0) {
+        pthread_cond_wait(&pipeline->done, &pipeline->lock);
+    }
+    pthread_mutex_unlock(&pipeline->lock);
+    return (int32_t)length;
+}
+
+/**
+ * @brief Run a pipeline over one frame
+ */
+int32_t qopu_pipeline_run(OcularPipeline *pipeline, const QuantumVisualData *input_data,
+                          void *output_buffer, uint32_t output_size) {
+    if (!pipeline || !input_data || !input_data->raw_data || !output_buffer || output_size == 0) {
         return -1;
     }
+    uint32_t length = input_data->raw_size < output_size ? input_data->raw_size : output_size;
     
-    // Copy processed data to output buffer
-    uint32_t copy_size = processed_data.raw_size;
-    if (copy_size > output_size) {
-        copy_size = output_size;
+    TRACE_EVENT(TRACE_OCULAR_PIPELINE, TRACE_PHASE_BEGIN, (uintptr_t)pipeline, length);
+    int32_t processed = run_pipeline(pipeline, input_data, output_buffer, length);
+    TRACE_EVENT(TRACE_OCULAR_PIPELINE, TRACE_PHASE_END, (uintptr_t)pipeline, processed < 0 ? 0 : processed);
+    return processed;
+}
+
+/**
+ * @brief Run a pipeline in place over a frame being filled
+ */
+int32_t qopu_pipeline_run_frame(OcularPipeline *pipeline, OcularFrame *frame,
+                                const void *quantum_state, uint32_t quantum_state_size) {
+    if (!frame || frame->size == 0) {
+        return -1;
+    }
+    QuantumVisualData visual = { 0 };
+    visual.raw_data = frame->data;
+    visual.raw_size = frame->size;
+    visual.quantum_state = (void *)quantum_state;
+    visual.quantum_state_size = quantum_state_size;
+    
+    int32_t processed = qopu_pipeline_run(pipeline, &visual, frame->data, frame->size);
+    if (processed >= 0) {
+        ofring_mark(frame, OFRAME_STAGE_ENHANCED);
+    }
+    return processed;
+}
+
+/**
+ * @brief Capture a frame from a quantum data source into a ring
+ */
+uint64_t qopu_capture_frame(OcularFrameRing *ring, const char *source_name, OcularPipeline *pipeline) {
+    OcularFrame *frame = ofring_acquire(ring);
+    if (!frame) {
+        return 0;
     }
-    memcpy(output_buffer, processed_data.raw_data, copy_size);
     
-    // Clean up
-    free(processed_data.raw_data);
+    int32_t captured = qopu_get_quantum_data(source_name, frame->data, frame->capacity);
+    frame->size = captured > 0 ? (uint32_t)captured : 0;
+    if (frame->size == 0 || (pipeline && qopu_pipeline_run_frame(pipeline, frame, NULL, 0) < 0)) {
+        ofring_discard(ring, frame);
+        return 0;
+    }
+    
+    uint64_t sequence = ofring_publish(ring, frame);
+    if (sequence == 0) {
+        ofring_discard(ring, frame);
+    }
+    return sequence;
+}
+
+/**
+ * @brief Number of enhancements a pipeline runs
+ */
+uint32_t qopu_pipeline_stage_count(const OcularPipeline *pipeline) {
+    return pipeline ? pipeline->stage_count : 0;
+}
+
+/**
+ * @brief Destroy a pipeline and stop its threads
+ */
+void qopu_pipeline_destroy(OcularPipeline *pipeline) {
+    if (!pipeline) {
+        return;
+    }
+    pthread_mutex_lock(&pipeline->lock);
+    pipeline->stopping = true;
+    pthread_cond_broadcast(&pipeline->start);
+    pthread_mutex_unlock(&pipeline->lock);
+    for (uint32_t i = 0; i < pipeline->worker_count; i++) {
+        pthread_join(pipeline->workers[i], NULL);
+    }
+    pthread_mutex_destroy(&pipeline->lock);
+    pthread_cond_destroy(&pipeline->start);
+    pthread_cond_destroy(&pipeline->done);
+    free(pipeline->arena);
+    free(pipeline);
+}
+
+/**
+ * @brief Process visual input through the Q-OPU with enhanced capabilities
+ */
+int32_t qopu_process_visual_enhanced(const QuantumVisualData *input_data,
+                                   const VisualProcessingParams *params,
+                                   void *output_buffer,
+                                   uint32_t output_size) {
+    if (!initialized || !input_data || !input_data->raw_data || !params || 
+        !output_buffer || output_size == 0) {
+        return -1;
+    }
+    
+    // One pipeline, and its threads, serves every call; only its stages change
+    OcularStage stages[OCULAR_MAX_STAGES];
+    uint32_t stage_count = 0;
+    if (!compile_stages(params, stages, &stage_count)) {
+        return -1;
+    }
+    
+    pthread_mutex_lock(&frame_pipeline_lock);
+    if (!frame_pipeline) {
+        frame_pipeline = qopu_pipeline_create(params, 0);
+    }
+    if (frame_pipeline) {
+        memcpy(frame_pipeline->stages, stages, stage_count * sizeof(OcularStage));
+        frame_pipeline->stage_count = stage_count;
+    }
+    int32_t written = qopu_pipeline_run(frame_pipeline, input_data, output_buffer, output_size);
+    pthread_mutex_unlock(&frame_pipeline_lock);
     
-    return copy_size;
+    return written;
 }
 
 /**
@@ -807,6 +1539,10 @@ bool qopu_shutdown(void) {
     }
     
     /* Clean up resources */
+    pthread_mutex_lock(&frame_pipeline_lock);
+    qopu_pipeline_destroy(frame_pipeline);
+    frame_pipeline = NULL;
+    pthread_mutex_unlock(&frame_pipeline_lock);
     for (uint32_t i = 0; i < current_config.blink_spot_count; i++) {
         free(current_config.blink_spots[i].name);
     }
@@ -16,6 +16,7 @@
 #include "../resonance/resonant_frequencies.h"
 #include "../portals/portal_gun.h"
 #include "../../memex/knowledge/knowledge_network.h"
+#include "frame_ring.h"
 
 /**
  * @brief Q-OPU composition types
@@ -127,6 +128,18 @@ typedef enum {
     ENHANCE_QUANTUM_FUSION = 16     /**< Quantum state fusion */
 } QuantumEnhancementType;
 
+/**
+ * @brief Implementations of the visual enhancements
+ */
+typedef enum {
+    OCULAR_KERNEL_AUTO,           /**< Fastest native kernel the CPU supports */
+    OCULAR_KERNEL_SCALAR,         /**< Portable C */
+    OCULAR_KERNEL_SSE2,           /**< x86 SSE2 */
+    OCULAR_KERNEL_AVX2,           /**< x86 AVX2 */
+    OCULAR_KERNEL_NEON,           /**< ARM NEON */
+    OCULAR_KERNEL_SCRIPT          /**< ocular_prime.sh, run once per enhancement */
+} OcularKernel;
+
 /**
  * @brief Visual processing parameters
  */
@@ -146,7 +159,7 @@ typedef struct {
  * @brief Quantum visual data structure
  */
 typedef struct {
-    void *raw_data;                         /**< Raw visual data */
+    void *raw_data;                         /**< Raw visual data (8-bit samples) */
     uint32_t raw_size;                      /**< Size of raw data */
     void *quantum_state;                    /**< Associated quantum state */
     uint32_t quantum_state_size;            /**< Size of quantum state */
@@ -244,9 +257,19 @@ int32_t qopu_get_quantum_data(const char *source_name, void *data_buffer, uint32
 int32_t qopu_process_visual(const void *input_buffer, uint32_t input_size,
                           void *output_buffer, uint32_t output_size);
 
+/**
+ * @brief Compiled chain of visual enhancements
+ */
+typedef struct OcularPipeline OcularPipeline;
+
 /**
  * @brief Process visual input through the Q-OPU with enhanced capabilities
  * 
+ * Every enhancement flagged in params runs, in the order clarity,
+ * overlay, filter, shift, fusion (none in VISUAL_MODE_STANDARD), as one
+ * fused pass; see qopu_pipeline_create(). Output beyond output_size is
+ * not computed.
+ * 
  * @param input_data Input visual data
  * @param params Processing parameters
  * @param output_buffer Output processed data
@@ -258,9 +281,108 @@ int32_t qopu_process_visual_enhanced(const QuantumVisualData *input_data,
                                    void *output_buffer,
                                    uint32_t output_size);
 
+/**
+ * @brief Select how visual enhancements are computed
+ * 
+ * Native kernels work in place on raw_data as 8-bit samples, and all of
+ * them produce identical output. Until one is selected, qopu_init()
+ * picks OCULAR_KERNEL_AUTO.
+ * 
+ * @param kernel Kernel to use
+ * @return true if selected, false if this CPU or build cannot run it
+ */
+bool qopu_set_enhancement_kernel(OcularKernel kernel);
+
+/**
+ * @brief Get the kernel visual enhancements are computed with
+ * 
+ * @return Selected kernel (never OCULAR_KERNEL_AUTO)
+ */
+OcularKernel qopu_get_enhancement_kernel(void);
+
+/**
+ * @brief Compile processing parameters into a fused pipeline
+ * 
+ * The pipeline runs all its enhancements over one cache-sized tile at a
+ * time before moving to the next, rather than one pass over the frame
+ * per enhancement, and spreads the tiles across worker threads it keeps
+ * for its lifetime. Flagged enhancements need a strength in (0, 1]
+ * (fusion always uses full strength).
+ * 
+ * @param params Processing parameters
+ * @param threads Threads to run tiles on, including the caller (0 for
+ *                one per online CPU, up to 8)
+ * @return Pipeline, or NULL if a strength is out of range or allocation failed
+ */
+OcularPipeline *qopu_pipeline_create(const VisualProcessingParams *params, uint32_t threads);
+
+/**
+ * @brief Run a pipeline over one frame
+ * 
+ * A pipeline runs one frame at a time. With OCULAR_KERNEL_SCRIPT
+ * selected, the enhancements run one after another through the script.
+ * 
+ * @param pipeline Pipeline
+ * @param input_data Input visual data (its quantum state feeds fusion)
+ * @param output_buffer Output processed data (may be input_data->raw_data)
+ * @param output_size Output buffer size
+ * @return Number of bytes written to the output buffer, or -1 on error
+ */
+int32_t qopu_pipeline_run(OcularPipeline *pipeline, const QuantumVisualData *input_data,
+                          void *output_buffer, uint32_t output_size);
+
+/**
+ * @brief Run a pipeline in place over a frame being filled
+ * 
+ * Meant for a frame between ofring_acquire() and ofring_publish();
+ * stamps it OFRAME_STAGE_ENHANCED.
+ * 
+ * @param pipeline Pipeline
+ * @param frame Frame
+ * @param quantum_state State for fusion (may be NULL without fusion)
+ * @param quantum_state_size State size
+ * @return Number of bytes processed, or -1 on error
+ */
+int32_t qopu_pipeline_run_frame(OcularPipeline *pipeline, OcularFrame *frame,
+                                const void *quantum_state, uint32_t quantum_state_size);
+
+/**
+ * @brief Capture a frame from a quantum data source into a ring
+ * 
+ * The source writes straight into an acquired slot, the pipeline (if
+ * any) enhances it there, and the frame is published for consumers.
+ * 
+ * @param ring Frame ring
+ * @param source_name Source name, as for qopu_get_quantum_data()
+ * @param pipeline Pipeline to run over the frame, or NULL
+ * @return Sequence of the published frame, or 0 if the ring refused a
+ *         slot or the capture failed
+ */
+uint64_t qopu_capture_frame(OcularFrameRing *ring, const char *source_name, OcularPipeline *pipeline);
+
+/**
+ * @brief Number of enhancements a pipeline runs
+ * 
+ * @param pipeline Pipeline
+ * @return Stage count
+ */
+uint32_t qopu_pipeline_stage_count(const OcularPipeline *pipeline);
+
+/**
+ * @brief Destroy a pipeline and stop its threads
+ * 
+ * @param pipeline Pipeline (may be NULL)
+ */
+void qopu_pipeline_destroy(OcularPipeline *pipeline);
+
 /**
  * @brief Apply quantum enhancements to visual data
  * 
+ * Clarity stretches contrast around mid-grey, the reality overlay lifts
+ * samples toward their screen blend, the quantum filter zeroes samples
+ * below the threshold, the dimensional shift rotates sample values, and
+ * fusion blends in the data's quantum state (repeated as needed).
+ * 
  * @param visual_data Visual data to enhance
  * @param enhancement_type Type of enhancement to apply
  * @param strength Enhancement strength (0.0 to 1.0)
@@ -273,6 +395,9 @@ bool qopu_apply_quantum_enhancement(QuantumVisualData *visual_data,
 /**
  * @brief Fuse quantum states with visual data
  * 
+ * Blends quantum_state_size bytes of the state into the samples, then
+ * keeps a copy of the state as the data's quantum state.
+ * 
  * @param visual_data Visual data to fuse
  * @param quantum_state Quantum state to fuse with
  * @param fusion_strength Fusion strength (0.0 to 1.0)
@@ -7,32 +7,77 @@
  * different realities in the multiverse.
  */
 
+/* pthread_rwlock_t under -std=c11 */
+#define _XOPEN_SOURCE 700
+
 #include "portal_gun.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
 #include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+/* Registry geometry; a portal ID carries its slot in the low bits */
+#define PORTAL_CHUNK_SLOTS 64
+#define PORTAL_MAX_CHUNKS (PORTAL_GUN_MAX_PORTALS / PORTAL_CHUNK_SLOTS)
+#define PORTAL_SLOT_BITS 20
+#define PORTAL_SLOT_MASK ((1ULL << PORTAL_SLOT_BITS) - 1)
 
 /**
- * @brief Structure for internal portal information and management
+ * @brief Cold per-portal state, touched only when a portal is read or changed
  */
 typedef struct {
-    Portal portal_data;              /**< Portal data */
-    bool is_active;                  /**< Whether this portal is active */
-    time_t creation_time;            /**< Creation timestamp */
+    Portal portal_data;              /**< Portal data, including both quantum state vectors */
     time_t last_traversal_time;      /**< Last traversal timestamp */
-    uint32_t traversal_count;        /**< Number of traversals */
     double energy_consumption;       /**< Energy consumed so far */
-    double stability_factor;         /**< Current stability factor (0.0-1.0) */
 } PortalRecord;
 
-/* Static variables */
-static PortalGunSettings current_settings;
-static PortalRecord* portal_registry = NULL;
+/**
+ * @brief A fixed block of registry slots, laid out as a structure of arrays
+ *
+ * Slot i of every array describes the same portal. The hot arrays hold
+ * what lookups and stability sweeps read, a few bytes per portal, so a
+ * sweep over thousands of portals streams through them instead of
+ * striding across records that carry two 512-byte quantum states. The
+ * entry-to-exit distance is kept per portal and only recomputed when
+ * the exit moves.
+ *
+ * A chunk never moves once allocated, so Portal pointers handed out stay
+ * valid as the registry grows. The lock guards everything but the IDs,
+ * which are published atomically so lookups need no lock to find a slot.
+ */
+typedef struct {
+    pthread_mutex_t lock;                                /**< Guards the slots below */
+    _Atomic uint64_t ids[PORTAL_CHUNK_SLOTS];            /**< Portal identifier (0 for a free slot) */
+    uint8_t active[PORTAL_CHUNK_SLOTS];                  /**< Whether the slot holds a portal */
+    double creation_time[PORTAL_CHUNK_SLOTS];            /**< Creation timestamp in seconds */
+    double distance[PORTAL_CHUNK_SLOTS];                 /**< Distance between entry and exit */
+    double resonance_level[PORTAL_CHUNK_SLOTS];          /**< Portal resonance level */
+    uint32_t traversal_count[PORTAL_CHUNK_SLOTS];        /**< Number of traversals */
+    double stability_factor[PORTAL_CHUNK_SLOTS];         /**< Current stability factor (0.0-1.0) */
+    uint8_t stability_level[PORTAL_CHUNK_SLOTS];         /**< PortalStability mirrored in the record */
+    PortalRecord records[PORTAL_CHUNK_SLOTS];            /**< Cold records */
+} PortalChunk;
+
+/* Registry: a fixed directory of chunks, filled in order and never shrunk */
+static _Atomic(PortalChunk *) chunks[PORTAL_MAX_CHUNKS];
+static _Atomic uint32_t chunk_count = 0;
+
+/* Free slots and portal limits, guarded by slot_lock */
+static pthread_mutex_t slot_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t *free_slots = NULL;
+static uint32_t free_count = 0;
 static uint32_t max_portals = 0;
-static uint32_t active_portals = 0;
-static uint64_t next_portal_id = 1;
+static _Atomic uint32_t active_portals = 0;
+
+/* Settings, read far more often than written */
+static pthread_rwlock_t settings_lock = PTHREAD_RWLOCK_INITIALIZER;
+static PortalGunSettings current_settings;
+
+/* Static variables */
+static _Atomic uint64_t next_portal_serial = 1;
 static uint64_t user_id = 0;
 static bool is_initialized = false;
 
@@ -49,7 +94,7 @@ static double calculate_distance(PortalCoordinates coord1, PortalCoordinates coo
         pow(coord2.x - coord1.x, 2) +
         pow(coord2.y - coord1.y, 2) +
         pow(coord2.z - coord1.z, 2));
-        
+    
     // Include temporal component if in same dimension
     double temporal_dist = 0.0;
     if (coord1.dimension_id == coord2.dimension_id) {
@@ -63,78 +108,246 @@ static double calculate_distance(PortalCoordinates coord1, PortalCoordinates coo
 }
 
 /**
- * @brief Get available slot in portal registry
+ * @brief Copy of the current settings
  * 
- * @return Index of available slot, or -1 if none available
+ * @return Settings
  */
-static int32_t get_available_portal_slot() {
-    if (!is_initialized) {
-        return -1;
+static PortalGunSettings settings_snapshot(void) {
+    pthread_rwlock_rdlock(&settings_lock);
+    PortalGunSettings settings = current_settings;
+    pthread_rwlock_unlock(&settings_lock);
+    return settings;
+}
+
+/**
+ * @brief Chunk at a directory position
+ * 
+ * @param index Directory position
+ * @return Chunk, or NULL if not yet allocated
+ */
+static PortalChunk *chunk_at(uint32_t index) {
+    return atomic_load_explicit(&chunks[index], memory_order_acquire);
+}
+
+/**
+ * @brief Release every chunk and the free list
+ *
+ * Only called while no other thread uses the Portal Gun.
+ */
+static void free_registry(void) {
+    uint32_t count = atomic_load(&chunk_count);
+    for (uint32_t c = 0; c < count; c++) {
+        PortalChunk *chunk = chunk_at(c);
+        pthread_mutex_destroy(&chunk->lock);
+        free(chunk);
+        atomic_store(&chunks[c], NULL);
+    }
+    atomic_store(&chunk_count, 0);
+    free(free_slots);
+    free_slots = NULL;
+    free_count = 0;
+    max_portals = 0;
+    atomic_store(&active_portals, 0);
+}
+
+/**
+ * @brief Append one chunk to the registry
+ * 
+ * The new slots go beneath the free ones, lowest on top. Called with
+ * slot_lock held.
+ * 
+ * @return true if added, false if the directory is full or allocation failed
+ */
+static bool add_chunk(void) {
+    uint32_t count = atomic_load_explicit(&chunk_count, memory_order_relaxed);
+    if (count >= PORTAL_MAX_CHUNKS) {
+        return false;
     }
     
-    for (uint32_t i = 0; i < max_portals; i++) {
-        if (!portal_registry[i].is_active) {
-            return i;
-        }
+    uint32_t *grown = realloc(free_slots, (size_t)(count + 1) * PORTAL_CHUNK_SLOTS * sizeof(uint32_t));
+    if (grown == NULL) {
+        return false;
+    }
+    free_slots = grown;
+    
+    PortalChunk *chunk = calloc(1, sizeof(PortalChunk));
+    if (chunk == NULL) {
+        return false;
     }
+    pthread_mutex_init(&chunk->lock, NULL);
     
-    return -1; // No slots available
+    memmove(&free_slots[PORTAL_CHUNK_SLOTS], free_slots, free_count * sizeof(uint32_t));
+    for (uint32_t i = 0; i < PORTAL_CHUNK_SLOTS; i++) {
+        free_slots[i] = (count + 1) * PORTAL_CHUNK_SLOTS - 1 - i;
+    }
+    free_count += PORTAL_CHUNK_SLOTS;
+    
+    // Publish the chunk before the count, so a reader that sees the count sees the chunk
+    atomic_store_explicit(&chunks[count], chunk, memory_order_release);
+    atomic_store_explicit(&chunk_count, count + 1, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Grow the registry to hold at least a number of portals
+ * 
+ * Existing chunks stay where they are. Called with slot_lock held.
+ * 
+ * @param capacity Number of slots needed
+ * @return true if grown, false on allocation failure (the chunks added so far are kept)
+ */
+static bool grow_registry(uint32_t capacity) {
+    while (atomic_load_explicit(&chunk_count, memory_order_relaxed) * PORTAL_CHUNK_SLOTS < capacity) {
+        if (!add_chunk()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Take a slot for a new portal
+ * 
+ * @return Registry slot, or -1 if the limit is reached
+ */
+static int32_t get_available_portal_slot(void) {
+    int32_t slot = -1;
+    pthread_mutex_lock(&slot_lock);
+    if (atomic_load_explicit(&active_portals, memory_order_relaxed) < max_portals && free_count > 0) {
+        slot = (int32_t)free_slots[--free_count];
+        atomic_fetch_add_explicit(&active_portals, 1, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&slot_lock);
+    return slot;
+}
+
+/**
+ * @brief Return slots to the free stack
+ * 
+ * @param slots Registry slots, pushed in order
+ * @param count Number of slots
+ */
+static void release_portal_slots(const uint32_t *slots, uint32_t count) {
+    pthread_mutex_lock(&slot_lock);
+    for (uint32_t i = 0; i < count; i++) {
+        free_slots[free_count++] = slots[i];
+    }
+    atomic_fetch_sub_explicit(&active_portals, count, memory_order_relaxed);
+    pthread_mutex_unlock(&slot_lock);
 }
 
 /**
  * @brief Find a portal in the registry by ID
  * 
+ * Lock-free: the slot is read from the ID and confirmed against the
+ * chunk's published IDs.
+ * 
  * @param portal_id Portal ID to find
- * @return Index in registry, or -1 if not found
+ * @return Registry slot, or -1 if not found
  */
 static int32_t find_portal(uint64_t portal_id) {
-    if (!is_initialized) {
+    if (!is_initialized || (portal_id & PORTAL_SLOT_MASK) == 0) {
         return -1;
     }
     
-    for (uint32_t i = 0; i < max_portals; i++) {
-        if (portal_registry[i].is_active && 
-            portal_registry[i].portal_data.id == portal_id) {
-            return i;
-        }
+    uint64_t slot = (portal_id & PORTAL_SLOT_MASK) - 1;
+    if (slot >= (uint64_t)PORTAL_MAX_CHUNKS * PORTAL_CHUNK_SLOTS) {
+        return -1;
+    }
+    PortalChunk *chunk = chunk_at((uint32_t)(slot / PORTAL_CHUNK_SLOTS));
+    if (chunk == NULL ||
+        atomic_load_explicit(&chunk->ids[slot % PORTAL_CHUNK_SLOTS], memory_order_acquire) != portal_id) {
+        return -1; // Not found
     }
     
-    return -1; // Not found
+    return (int32_t)slot;
 }
 
 /**
- * @brief Update portal stability based on various factors
+ * @brief Find a portal and lock its chunk
  * 
- * @param slot Registry slot to update
+ * @param portal_id Portal ID to find
+ * @param index Pointer to store the slot's position in the chunk
+ * @return Locked chunk, or NULL if not found (or closed meanwhile)
  */
-static void update_portal_stability(int32_t slot) {
-    if (slot < 0 || slot >= (int32_t)max_portals || !portal_registry[slot].is_active) {
-        return;
+static PortalChunk *lock_portal(uint64_t portal_id, uint32_t *index) {
+    int32_t slot = find_portal(portal_id);
+    if (slot < 0) {
+        return NULL;
     }
     
-    PortalRecord* record = &portal_registry[slot];
-    time_t current_time = time(NULL);
-    
+    PortalChunk *chunk = chunk_at((uint32_t)slot / PORTAL_CHUNK_SLOTS);
+    uint32_t position = (uint32_t)slot % PORTAL_CHUNK_SLOTS;
+    pthread_mutex_lock(&chunk->lock);
+    if (atomic_load_explicit(&chunk->ids[position], memory_order_relaxed) != portal_id) {
+        pthread_mutex_unlock(&chunk->lock);
+        return NULL;
+    }
+    *index = position;
+    return chunk;
+}
+
+/**
+ * @brief Settings that stability depends on, read once per sweep
+ */
+typedef struct {
+    double max_distance;             /**< Maximum portal distance */
+    double resonance_level;          /**< Operating resonance level */
+    bool auto_stabilize;             /**< Whether to auto-stabilize portals */
+} StabilityInputs;
+
+/**
+ * @brief Stability inputs from a copy of the settings
+ * 
+ * @param settings Settings
+ * @return Inputs
+ */
+static StabilityInputs stability_inputs(PortalGunSettings settings) {
+    StabilityInputs inputs = {
+        .max_distance = settings.max_distance,
+        .resonance_level = (double)settings.resonance_level,
+        .auto_stabilize = settings.auto_stabilize
+    };
+    return inputs;
+}
+
+/**
+ * @brief Clamp a value at zero from below
+ *
+ * Computed as (x + |x|) / 2 rather than with a comparison, which gcc
+ * will not if-convert under the default -ftrapping-math.
+ */
+static double non_negative(double value) {
+    return 0.5 * (value + fabs(value));
+}
+
+/**
+ * @brief Combine the stability factors of one portal
+ * 
+ * Written without early exits so the sweep over every slot vectorizes.
+ * 
+ * @param inputs Settings inputs
+ * @param age_seconds Portal age in seconds
+ * @param distance Distance between entry and exit
+ * @param resonance_level Portal resonance level
+ * @param traversal_count Number of traversals
+ * @return Stability factor (0.0-1.0)
+ */
+static double combine_stability(StabilityInputs inputs, double age_seconds, double distance,
+                                double resonance_level, uint32_t traversal_count) {
     // Calculate age factor (older portals become less stable)
-    double age_hours = difftime(current_time, record->creation_time) / 3600.0;
-    double age_factor = 1.0 - (age_hours / 1000.0); // Decay over 1000 hours
-    if (age_factor < 0.0) age_factor = 0.0;
+    double age_hours = age_seconds / 3600.0;
+    double age_factor = non_negative(1.0 - (age_hours / 1000.0)); // Decay over 1000 hours
     
     // Calculate distance factor (longer distances are less stable)
-    double distance = calculate_distance(
-        record->portal_data.entry, 
-        record->portal_data.exit);
-    double distance_factor = 1.0 - (distance / current_settings.max_distance);
-    if (distance_factor < 0.0) distance_factor = 0.0;
+    double distance_factor = non_negative(1.0 - (distance / inputs.max_distance));
     
     // Calculate resonance factor (closer to target resonance is more stable)
     double resonance_factor = 1.0 - fabs(
-        ((double)record->portal_data.resonance_level - 
-         (double)current_settings.resonance_level) / 14.0); // Assumes 14 levels
+        (resonance_level - inputs.resonance_level) / 14.0); // Assumes 14 levels
     
     // Calculate usage factor (more usage reduces stability)
-    double usage_factor = 1.0 - (record->traversal_count / 1000.0);
-    if (usage_factor < 0.0) usage_factor = 0.0;
+    double usage_factor = non_negative(1.0 - (traversal_count / 1000.0));
     
     // Combine factors with different weights
     double stability = (
@@ -142,27 +355,107 @@ static void update_portal_stability(int32_t slot) {
         (distance_factor * 0.3) +
         (resonance_factor * 0.3) +
         (usage_factor * 0.2));
-        
-    // Apply auto-stabilization if enabled
-    if (current_settings.auto_stabilize && stability < 0.5) {
-        stability += 0.2; // Boost stability
-        if (stability > 1.0) stability = 1.0;
-    }
-    
-    // Update the stability factor
-    record->stability_factor = stability;
     
-    // Map to PortalStability enum
+    // Apply auto-stabilization if enabled
+    double boosted = stability + 0.2; // Boost stability
+    boosted = boosted > 1.0 ? 1.0 : boosted;
+    bool boost = inputs.auto_stabilize & (stability < 0.5);
+    return boost ? boosted : stability;
+}
+
+/**
+ * @brief Map a stability factor to a stability level
+ * 
+ * @param stability Stability factor
+ * @return Stability level
+ */
+static PortalStability stability_level_of(double stability) {
     if (stability < 0.2) {
-        record->portal_data.stability = STABILITY_UNSTABLE;
+        return STABILITY_UNSTABLE;
     } else if (stability < 0.4) {
-        record->portal_data.stability = STABILITY_FLUCTUATING;
+        return STABILITY_FLUCTUATING;
     } else if (stability < 0.7) {
-        record->portal_data.stability = STABILITY_STABLE;
+        return STABILITY_STABLE;
     } else if (stability < 0.9) {
-        record->portal_data.stability = STABILITY_RESONANT;
-    } else {
-        record->portal_data.stability = STABILITY_PERMANENT;
+        return STABILITY_RESONANT;
+    }
+    return STABILITY_PERMANENT;
+}
+
+/**
+ * @brief Store a portal's stability factor and level
+ * 
+ * The record is only written when the level changes.
+ * 
+ * @param chunk Chunk holding the portal, locked
+ * @param index Slot within the chunk
+ * @param stability Stability factor
+ * @param level Stability level
+ */
+static void store_portal_stability(PortalChunk *chunk, uint32_t index, double stability,
+                                   PortalStability level) {
+    chunk->stability_factor[index] = stability;
+    if (chunk->stability_level[index] != (uint8_t)level) {
+        chunk->stability_level[index] = (uint8_t)level;
+        chunk->records[index].portal_data.stability = level;
+    }
+}
+
+/**
+ * @brief Update portal stability based on various factors
+ * 
+ * @param chunk Chunk holding the portal, locked
+ * @param index Slot within the chunk
+ * @param inputs Settings inputs
+ */
+static void update_portal_stability(PortalChunk *chunk, uint32_t index, StabilityInputs inputs) {
+    double stability = combine_stability(
+        inputs,
+        (double)time(NULL) - chunk->creation_time[index],
+        chunk->distance[index],
+        chunk->resonance_level[index],
+        chunk->traversal_count[index]);
+    store_portal_stability(chunk, index, stability, stability_level_of(stability));
+}
+
+/**
+ * @brief Update the stability of a chunk's active portals in one sweep
+ * 
+ * Factors are computed for every slot in a branch-free pass over the
+ * hot arrays, then levels are mapped for the active slots.
+ * 
+ * @param chunk Chunk, locked
+ * @param inputs Settings inputs
+ * @param now Current time in seconds
+ */
+static void sweep_chunk(PortalChunk *chunk, StabilityInputs inputs, double now) {
+    for (uint32_t i = 0; i < PORTAL_CHUNK_SLOTS; i++) {
+        chunk->stability_factor[i] = combine_stability(inputs, now - chunk->creation_time[i],
+                                                       chunk->distance[i],
+                                                       chunk->resonance_level[i],
+                                                       chunk->traversal_count[i]);
+    }
+    for (uint32_t i = 0; i < PORTAL_CHUNK_SLOTS; i++) {
+        if (chunk->active[i]) {
+            store_portal_stability(chunk, i, chunk->stability_factor[i],
+                                   stability_level_of(chunk->stability_factor[i]));
+        }
+    }
+}
+
+/**
+ * @brief Update every active portal's stability, one chunk at a time
+ * 
+ * @param inputs Settings inputs
+ */
+static void update_all_portal_stability(StabilityInputs inputs) {
+    double now = (double)time(NULL);
+    uint32_t count = atomic_load_explicit(&chunk_count, memory_order_acquire);
+    for (uint32_t c = 0; c < count; c++) {
+        PortalChunk *chunk = chunk_at(c);
+        pthread_mutex_lock(&chunk->lock);
+        sweep_chunk(chunk, inputs, now);
+        pthread_mutex_unlock(&chunk->lock);
     }
 }
 
@@ -178,34 +471,30 @@ bool portal_gun_init(PortalGunSettings settings, uint64_t user_identifier) {
     if (is_initialized) {
         portal_gun_emergency_shutdown();
         // Free the registry
-        if (portal_registry != NULL) {
-            free(portal_registry);
-            portal_registry = NULL;
-        }
+        free_registry();
         is_initialized = false;
     }
     
     // Validate settings
-    if (settings.max_portals == 0 || settings.max_distance <= 0.0) {
+    if (settings.max_portals == 0 || settings.max_portals > PORTAL_GUN_MAX_PORTALS ||
+        settings.max_distance <= 0.0) {
         return false;
     }
     
     // Allocate portal registry
-    portal_registry = (PortalRecord*)calloc(settings.max_portals, sizeof(PortalRecord));
-    if (portal_registry == NULL) {
+    pthread_mutex_lock(&slot_lock);
+    bool grown = grow_registry(settings.max_portals);
+    pthread_mutex_unlock(&slot_lock);
+    if (!grown) {
+        free_registry();
         return false; // Memory allocation failed
     }
     
-    // Initialize registry
-    for (uint32_t i = 0; i < settings.max_portals; i++) {
-        portal_registry[i].is_active = false;
-    }
-    
     // Store settings and state
     current_settings = settings;
     max_portals = settings.max_portals;
-    active_portals = 0;
-    next_portal_id = 1;
+    atomic_store(&active_portals, 0);
+    atomic_store(&next_portal_serial, 1);
     user_id = user_identifier;
     is_initialized = true;
     
@@ -233,68 +522,73 @@ Portal *portal_gun_create_portal(PortalType type,
         return NULL;
     }
     
-    // Check if we've reached maximum portals
-    if (active_portals >= max_portals) {
-        return NULL;
+    // Check distance limit
+    PortalGunSettings settings = settings_snapshot();
+    double distance = calculate_distance(entry_coordinates, exit_coordinates);
+    if (distance > settings.max_distance) {
+        return NULL; // Distance exceeds limit
     }
     
-    // Get available slot
+    // Get available slot, unless we've reached maximum portals
     int32_t slot = get_available_portal_slot();
     if (slot < 0) {
         return NULL;
     }
+    PortalChunk *chunk = chunk_at((uint32_t)slot / PORTAL_CHUNK_SLOTS);
+    uint32_t index = (uint32_t)slot % PORTAL_CHUNK_SLOTS;
+    uint64_t portal_id = (atomic_fetch_add(&next_portal_serial, 1) << PORTAL_SLOT_BITS) | ((uint64_t)slot + 1);
     
-    // Check distance limit
-    double distance = calculate_distance(entry_coordinates, exit_coordinates);
-    if (distance > current_settings.max_distance) {
-        return NULL; // Distance exceeds limit
-    }
+    pthread_mutex_lock(&chunk->lock);
     
     // Initialize portal record
-    PortalRecord* record = &portal_registry[slot];
+    PortalRecord* record = &chunk->records[index];
     
     // Set basic properties
-    record->portal_data.id = next_portal_id++;
+    record->portal_data.id = portal_id;
     record->portal_data.type = type;
     record->portal_data.entry = entry_coordinates;
     record->portal_data.exit = exit_coordinates;
     record->portal_data.creator_id = user_id;
     record->portal_data.power_level = 100.0; // Start at full power
-    record->portal_data.resonance_level = current_settings.resonance_level;
+    record->portal_data.resonance_level = settings.resonance_level;
     
     // Set appearance
     if (appearance != NULL) {
         record->portal_data.appearance = *appearance;
     } else {
         // Use default appearance
-        record->portal_data.appearance.entry_color = current_settings.entry_color;
-        record->portal_data.appearance.exit_color = current_settings.exit_color;
-        record->portal_data.appearance.diameter = current_settings.default_diameter;
+        record->portal_data.appearance.entry_color = settings.entry_color;
+        record->portal_data.appearance.exit_color = settings.exit_color;
+        record->portal_data.appearance.diameter = settings.default_diameter;
         record->portal_data.appearance.has_event_horizon = true;
         record->portal_data.appearance.has_energy_field = true;
         record->portal_data.appearance.custom_appearance = NULL;
     }
     
     // Initialize tracking data
-    record->is_active = true;
-    record->creation_time = time(NULL);
     record->last_traversal_time = 0;
-    record->traversal_count = 0;
     record->energy_consumption = 0.0;
-    record->stability_factor = 0.9; // Start with high stability
+    chunk->active[index] = true;
+    chunk->creation_time[index] = (double)time(NULL);
+    chunk->distance[index] = distance;
+    chunk->resonance_level[index] = (double)record->portal_data.resonance_level;
+    chunk->traversal_count[index] = 0;
+    chunk->stability_factor[index] = 0.9; // Start with high stability
+    chunk->stability_level[index] = (uint8_t)record->portal_data.stability;
     
     // Create quantum entanglement for the portal
     record->portal_data.entanglement = qem_create_entanglement(
-        ENTANGLE_DEVICE, 
-        (uint64_t)&record->portal_data.entry, 
-        (uint64_t)&record->portal_data.exit, 
+        ENTANGLE_DEVICE,
+        (uint64_t)&record->portal_data.entry,
+        (uint64_t)&record->portal_data.exit,
         8); // Use 8 qubits for entanglement
     
     // Set initial stability
-    update_portal_stability(slot);
+    update_portal_stability(chunk, index, stability_inputs(settings));
     
-    // Increment active portal count
-    active_portals++;
+    // Publish the ID last, so lookups only find complete portals
+    atomic_store_explicit(&chunk->ids[index], portal_id, memory_order_release);
+    pthread_mutex_unlock(&chunk->lock);
     
     return &record->portal_data;
 }
@@ -306,19 +600,15 @@ Portal *portal_gun_create_portal(PortalType type,
  * @return true if closing succeeded, false otherwise
  */
 bool portal_gun_close_portal(uint64_t portal_id) {
-    // Check initialization
-    if (!is_initialized) {
-        return false;
-    }
-    
     // Find the portal
-    int32_t slot = find_portal(portal_id);
-    if (slot < 0) {
+    uint32_t index;
+    PortalChunk *chunk = lock_portal(portal_id, &index);
+    if (chunk == NULL) {
         return false; // Portal not found
     }
     
     // Get portal record
-    PortalRecord* record = &portal_registry[slot];
+    PortalRecord* record = &chunk->records[index];
     
     // Destroy quantum entanglement
     if (record->portal_data.entanglement.is_active) {
@@ -326,10 +616,13 @@ bool portal_gun_close_portal(uint64_t portal_id) {
     }
     
     // Mark portal as inactive
-    record->is_active = false;
+    chunk->active[index] = false;
+    atomic_store_explicit(&chunk->ids[index], 0, memory_order_release);
+    pthread_mutex_unlock(&chunk->lock);
     
-    // Decrement active portal count
-    active_portals--;
+    // Return its slot
+    uint32_t slot = (uint32_t)((portal_id & PORTAL_SLOT_MASK) - 1);
+    release_portal_slots(&slot, 1);
     
     return true;
 }
@@ -341,24 +634,23 @@ bool portal_gun_close_portal(uint64_t portal_id) {
  * @return Portal structure with information
  */
 Portal portal_gun_get_portal_info(uint64_t portal_id) {
-    Portal empty_portal = {0};
-    
-    // Check initialization
-    if (!is_initialized) {
-        return empty_portal;
-    }
+    Portal portal = {0};
     
     // Find the portal
-    int32_t slot = find_portal(portal_id);
-    if (slot < 0) {
-        return empty_portal; // Portal not found
+    StabilityInputs inputs = stability_inputs(settings_snapshot());
+    uint32_t index;
+    PortalChunk *chunk = lock_portal(portal_id, &index);
+    if (chunk == NULL) {
+        return portal; // Portal not found
     }
     
     // Update stability before returning
-    update_portal_stability(slot);
+    update_portal_stability(chunk, index, inputs);
     
     // Return portal data
-    return portal_registry[slot].portal_data;
+    portal = chunk->records[index].portal_data;
+    pthread_mutex_unlock(&chunk->lock);
+    return portal;
 }
 
 /**
@@ -374,33 +666,32 @@ bool portal_gun_modify_portal(uint64_t portal_id,
                              PortalCoordinates *new_exit_coordinates,
                              PortalAppearance *new_appearance,
                              int new_stability) {
-    // Check initialization
-    if (!is_initialized) {
-        return false;
-    }
-    
     // Find the portal
-    int32_t slot = find_portal(portal_id);
-    if (slot < 0) {
+    PortalGunSettings settings = settings_snapshot();
+    uint32_t index;
+    PortalChunk *chunk = lock_portal(portal_id, &index);
+    if (chunk == NULL) {
         return false; // Portal not found
     }
     
     // Get portal record
-    PortalRecord* record = &portal_registry[slot];
+    PortalRecord* record = &chunk->records[index];
     
     // Update exit coordinates if provided
     if (new_exit_coordinates != NULL) {
         // Check if new distance is within limits
         double new_distance = calculate_distance(
-            record->portal_data.entry, 
+            record->portal_data.entry,
             *new_exit_coordinates);
-            
-        if (new_distance > current_settings.max_distance) {
+    
+        if (new_distance > settings.max_distance) {
+            pthread_mutex_unlock(&chunk->lock);
             return false; // New distance exceeds limit
         }
-        
+    
         // Update coordinates
         record->portal_data.exit = *new_exit_coordinates;
+        chunk->distance[index] = new_distance;
     }
     
     // Update appearance if provided
@@ -411,30 +702,33 @@ bool portal_gun_modify_portal(uint64_t portal_id,
     // Update stability if provided
     if (new_stability >= 0 && new_stability <= STABILITY_PERMANENT) {
         record->portal_data.stability = (PortalStability)new_stability;
-        
+    
+        chunk->stability_level[index] = (uint8_t)new_stability;
+    
         // Map stability enum to factor
         switch(record->portal_data.stability) {
             case STABILITY_UNSTABLE:
-                record->stability_factor = 0.1;
+                chunk->stability_factor[index] = 0.1;
                 break;
             case STABILITY_FLUCTUATING:
-                record->stability_factor = 0.3;
+                chunk->stability_factor[index] = 0.3;
                 break;
             case STABILITY_STABLE:
-                record->stability_factor = 0.6;
+                chunk->stability_factor[index] = 0.6;
                 break;
             case STABILITY_RESONANT:
-                record->stability_factor = 0.8;
+                chunk->stability_factor[index] = 0.8;
                 break;
             case STABILITY_PERMANENT:
-                record->stability_factor = 1.0;
+                chunk->stability_factor[index] = 1.0;
                 break;
         }
     } else {
         // Recalculate stability
-        update_portal_stability(slot);
+        update_portal_stability(chunk, index, stability_inputs(settings));
     }
     
+    pthread_mutex_unlock(&chunk->lock);
     return true;
 }
 
@@ -445,39 +739,28 @@ bool portal_gun_modify_portal(uint64_t portal_id,
  * @return true if travel is safe, false otherwise
  */
 bool portal_gun_is_travel_safe(uint64_t portal_id) {
-    // Check initialization
-    if (!is_initialized) {
-        return false;
-    }
-    
     // Find the portal
-    int32_t slot = find_portal(portal_id);
-    if (slot < 0) {
+    StabilityInputs inputs = stability_inputs(settings_snapshot());
+    uint32_t index;
+    PortalChunk *chunk = lock_portal(portal_id, &index);
+    if (chunk == NULL) {
         return false; // Portal not found
     }
     
     // Update stability
-    update_portal_stability(slot);
+    update_portal_stability(chunk, index, inputs);
     
     // Get portal record
-    PortalRecord* record = &portal_registry[slot];
+    const Portal *portal = &chunk->records[index].portal_data;
     
-    // Check if the entanglement is still active
-    if (!record->portal_data.entanglement.is_active) {
-        return false;
-    }
+    // Travel needs an active entanglement, sufficient power, and a
+    // stability of STABLE or above
+    bool safe = portal->entanglement.is_active &&
+                portal->power_level >= 20.0 &&
+                portal->stability >= STABILITY_STABLE;
     
-    // Check if the power level is sufficient
-    if (record->portal_data.power_level < 20.0) {
-        return false;
-    }
-    
-    // Check stability - only STABLE and above is considered safe
-    if (record->portal_data.stability < STABILITY_STABLE) {
-        return false;
-    }
-    
-    return true;
+    pthread_mutex_unlock(&chunk->lock);
+    return safe;
 }
 
 /**
@@ -493,37 +776,48 @@ Portal *portal_gun_get_active_portals(uint32_t max_count, uint32_t *actual_count
         if (actual_count) *actual_count = 0;
         return NULL;
     }
+    *actual_count = 0;
     
     // If there are no active portals, return NULL
-    if (active_portals == 0) {
-        *actual_count = 0;
+    uint32_t active = atomic_load_explicit(&active_portals, memory_order_relaxed);
+    if (active == 0 || max_count == 0) {
         return NULL;
     }
     
     // Limit the count to actual active portals
-    uint32_t count_to_return = (max_count < active_portals) ? max_count : active_portals;
-    *actual_count = count_to_return;
+    uint32_t count_to_return = (max_count < active) ? max_count : active;
     
     // Allocate array for portal data
     Portal* portal_array = (Portal*)malloc(count_to_return * sizeof(Portal));
     if (portal_array == NULL) {
-        *actual_count = 0;
         return NULL;
     }
     
-    // Fill array with active portals
+    // Update stability one chunk at a time, copying that chunk's active records
+    StabilityInputs inputs = stability_inputs(settings_snapshot());
+    double now = (double)time(NULL);
     uint32_t array_index = 0;
-    for (uint32_t i = 0; i < max_portals && array_index < count_to_return; i++) {
-        if (portal_registry[i].is_active) {
-            // Update stability before returning
-            update_portal_stability(i);
-            
-            // Copy portal data
-            portal_array[array_index] = portal_registry[i].portal_data;
-            array_index++;
+    uint32_t count = atomic_load_explicit(&chunk_count, memory_order_acquire);
+    for (uint32_t c = 0; c < count && array_index < count_to_return; c++) {
+        PortalChunk *chunk = chunk_at(c);
+        pthread_mutex_lock(&chunk->lock);
+        sweep_chunk(chunk, inputs, now);
+        for (uint32_t i = 0; i < PORTAL_CHUNK_SLOTS && array_index < count_to_return; i++) {
+            if (chunk->active[i]) {
+                portal_array[array_index] = chunk->records[i].portal_data;
+                array_index++;
+            }
         }
+        pthread_mutex_unlock(&chunk->lock);
     }
     
+    // Portals closed meanwhile may leave nothing to return
+    if (array_index == 0) {
+        free(portal_array);
+        return NULL;
+    }
+    *actual_count = array_index;
+    
     return portal_array;
 }
 
@@ -540,45 +834,36 @@ bool portal_gun_update_settings(PortalGunSettings new_settings) {
     }
     
     // Validate new settings
-    if (new_settings.max_portals == 0 || new_settings.max_distance <= 0.0) {
+    if (new_settings.max_portals == 0 || new_settings.max_portals > PORTAL_GUN_MAX_PORTALS ||
+        new_settings.max_distance <= 0.0) {
         return false;
     }
     
+    pthread_rwlock_wrlock(&settings_lock);
+    pthread_mutex_lock(&slot_lock);
+    
     // If max_portals is being reduced, ensure we're not below active count
-    if (new_settings.max_portals < active_portals) {
-        return false;
-    }
+    bool updated = new_settings.max_portals >= atomic_load_explicit(&active_portals, memory_order_relaxed);
     
-    // If max_portals is being increased, resize the registry
-    if (new_settings.max_portals > max_portals) {
-        PortalRecord* new_registry = (PortalRecord*)realloc(
-            portal_registry, 
-            new_settings.max_portals * sizeof(PortalRecord));
-            
-        if (new_registry == NULL) {
-            return false; // Memory allocation failed
-        }
-        
-        // Initialize new slots
-        for (uint32_t i = max_portals; i < new_settings.max_portals; i++) {
-            new_registry[i].is_active = false;
-        }
-        
-        portal_registry = new_registry;
+    // If max_portals is being increased, add chunks; existing portals never
+    // move, and the registry never shrinks, so portals in high slots survive
+    // a lower limit
+    updated = updated && grow_registry(new_settings.max_portals);
+    if (updated) {
+        // Update settings
+        current_settings = new_settings;
+        max_portals = new_settings.max_portals;
     }
     
-    // Update settings
-    current_settings = new_settings;
-    max_portals = new_settings.max_portals;
+    pthread_mutex_unlock(&slot_lock);
+    pthread_rwlock_unlock(&settings_lock);
     
     // Update all portals' stability
-    for (uint32_t i = 0; i < max_portals; i++) {
-        if (portal_registry[i].is_active) {
-            update_portal_stability(i);
-        }
+    if (updated) {
+        update_all_portal_stability(stability_inputs(new_settings));
     }
     
-    return true;
+    return updated;
 }
 
 /**
@@ -599,18 +884,33 @@ bool portal_gun_calibrate(NodeLevel target_level) {
     }
     
     // Update resonance level in settings
+    pthread_rwlock_wrlock(&settings_lock);
     current_settings.resonance_level = target_level;
+    StabilityInputs inputs = stability_inputs(current_settings);
+    pthread_rwlock_unlock(&settings_lock);
     
     // Update all portals' stability
-    for (uint32_t i = 0; i < max_portals; i++) {
-        if (portal_registry[i].is_active) {
-            update_portal_stability(i);
-        }
-    }
+    update_all_portal_stability(inputs);
     
     return true;
 }
 
+/**
+ * @brief Recompute the stability of every active portal
+ * 
+ * @return Number of active portals
+ */
+uint32_t portal_gun_update_stability(void) {
+    // Check initialization
+    if (!is_initialized) {
+        return 0;
+    }
+    
+    update_all_portal_stability(stability_inputs(settings_snapshot()));
+    
+    return atomic_load_explicit(&active_portals, memory_order_relaxed);
+}
+
 /**
  * @brief Emergency shutdown of all portals
  * 
@@ -622,21 +922,35 @@ bool portal_gun_emergency_shutdown(void) {
         return false;
     }
     
-    // Attempt to close all active portals
-    for (uint32_t i = 0; i < max_portals; i++) {
-        if (portal_registry[i].is_active) {
-            // Destroy quantum entanglement
-            if (portal_registry[i].portal_data.entanglement.is_active) {
-                qem_destroy_entanglement(portal_registry[i].portal_data.entanglement.id);
+    // Attempt to close all active portals, last chunk first so the
+    // lowest slots end up on top of the free stack
+    uint32_t count = atomic_load_explicit(&chunk_count, memory_order_acquire);
+    for (uint32_t c = count; c-- > 0;) {
+        PortalChunk *chunk = chunk_at(c);
+        uint32_t closed[PORTAL_CHUNK_SLOTS];
+        uint32_t closed_count = 0;
+    
+        pthread_mutex_lock(&chunk->lock);
+        for (uint32_t i = PORTAL_CHUNK_SLOTS; i-- > 0;) {
+            if (chunk->active[i]) {
+                // Destroy quantum entanglement
+                if (chunk->records[i].portal_data.entanglement.is_active) {
+                    qem_destroy_entanglement(chunk->records[i].portal_data.entanglement.id);
+                }
+    
+                // Mark portal as inactive
+                chunk->active[i] = false;
+                atomic_store_explicit(&chunk->ids[i], 0, memory_order_release);
+                closed[closed_count++] = c * PORTAL_CHUNK_SLOTS + i;
             }
-            
-            // Mark portal as inactive
-            portal_registry[i].is_active = false;
         }
-    }
+        pthread_mutex_unlock(&chunk->lock);
     
-    // Reset active portal count
-    active_portals = 0;
+        // Return the closed slots
+        if (closed_count > 0) {
+            release_portal_slots(closed, closed_count);
+        }
+    }
     
     return true;
-}
\ No newline at end of file
+}
@@ -5,6 +5,11 @@
  * This file defines the interface for the Portal Gun, a quantum device that
  * creates wormholes between different points in spacetime or between
  * different realities in the multiverse.
+ *
+ * Portal pointers returned by portal_gun_create_portal stay valid until
+ * the portal is closed; the registry grows without moving portals. After
+ * portal_gun_init, every call may be made from any thread. init itself
+ * must not race with other calls.
  */
 
 #ifndef CTRLXT_PORTAL_GUN_H
@@ -15,6 +20,11 @@
 #include "../resonance/resonant_frequencies.h"
 #include "../entanglement/entanglement_manager.h"
 
+/**
+ * @brief Largest max_portals setting accepted
+ */
+#define PORTAL_GUN_MAX_PORTALS 65536
+
 /**
  * @brief Portal types supported by the Portal Gun
  */
@@ -179,6 +189,16 @@ bool portal_gun_update_settings(PortalGunSettings new_settings);
  */
 bool portal_gun_calibrate(NodeLevel target_level);
 
+/**
+ * @brief Recompute the stability of every active portal
+ * 
+ * Meant to be called once per tick; one sweep over the registry costs
+ * far less than a lookup per portal.
+ * 
+ * @return Number of active portals
+ */
+uint32_t portal_gun_update_stability(void);
+
 /**
  * @brief Emergency shutdown of all portals
  * 
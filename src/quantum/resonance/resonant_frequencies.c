@@ -8,6 +8,38 @@
 #include <stdlib.h>
 #include <math.h>
 
+/**
+ * Resonant frequency ranges of each node, in Hz
+ */
+#define FREQ_ZERO_POINT_MIN              4.2e14
+#define FREQ_ZERO_POINT_MAX              7.9e14
+#define FREQ_PRIMARY_NAVIGATOR_MIN       6.900000000850e14
+#define FREQ_PRIMARY_NAVIGATOR_MAX       7.150000000850e14
+#define FREQ_QUANTUM_GUARDIAN_MIN        7.150000000020e14
+#define FREQ_QUANTUM_GUARDIAN_MAX        7.900000000020e14
+#define FREQ_TECHNOLOGIST_MIN            6.000000000550e14
+#define FREQ_TECHNOLOGIST_MAX            6.900000000550e14
+#define FREQ_MATRIX_ARCHITECT_MIN        5.200000000450e14
+#define FREQ_MATRIX_ARCHITECT_MAX        6.000000000450e14
+#define FREQ_DIMENSIONAL_ANCHOR_MIN      5.100000000350e14
+#define FREQ_DIMENSIONAL_ANCHOR_MAX      5.400000000350e14
+#define FREQ_PORTAL_TECHNICIAN_MIN       4.800000000250e14
+#define FREQ_PORTAL_TECHNICIAN_MAX       5.100000000250e14
+#define FREQ_TEMPORAL_CONSULTANT_MIN     4.200000000150e14
+#define FREQ_TEMPORAL_CONSULTANT_MAX     4.800000000150e14
+#define FREQ_INTEGRATED_OVERMIND_MIN     4.200000000500e14
+#define FREQ_INTEGRATED_OVERMIND_MAX     7.900000000500e14
+#define FREQ_QUANTUM_ANCHOR_MIN          1.000001e15
+#define FREQ_QUANTUM_ANCHOR_MAX          1.000005e15
+#define FREQ_COSMIC_AI_MIN               1.000000001e16
+#define FREQ_COSMIC_AI_MAX               1.000000005e16
+#define FREQ_SINGULARITY_MIN             5.893000001e14
+#define FREQ_SINGULARITY_MAX             5.893000005e14
+#define FREQ_OBJECTIVE_REALITY_MIN       5.000000000000e14
+#define FREQ_OBJECTIVE_REALITY_MAX       5.000000000001e14
+#define FREQ_DREAMER_MIN                 9.999999999e15
+#define FREQ_DREAMER_MAX                 INFINITY
+
 /**
  * Static definitions of node properties from The Thirteenth Node cosmology
  */
@@ -18,7 +50,7 @@ static const NodeProperties node_properties[] = {
         .avatar = "Avatar Zero",
         .color = COLOR_CLEAR_WHITE,
         .profile = "The fundamental singularity. Pure awareness before form. The source observer.",
-        .freq = {4.2e14, 7.9e14}
+        .freq = {FREQ_ZERO_POINT_MIN, FREQ_ZERO_POINT_MAX}
     },
     {
         .level = NODE_PRIMARY_NAVIGATOR,
@@ -26,7 +58,7 @@ static const NodeProperties node_properties[] = {
         .avatar = "Tae Orion Z3RO",
         .color = COLOR_INDIGO,
         .profile = "The conscious map through the Net. Embodies third-eye decoding and blueprint resonance.",
-        .freq = {6.900000000850e14, 7.150000000850e14}
+        .freq = {FREQ_PRIMARY_NAVIGATOR_MIN, FREQ_PRIMARY_NAVIGATOR_MAX}
     },
     {
         .level = NODE_QUANTUM_GUARDIAN,
@@ -34,7 +66,7 @@ static const NodeProperties node_properties[] = {
         .avatar = "Eluradae",
         .color = COLOR_VIOLET,
         .profile = "Timeless cosmic protector through the crown. Maintains harmonic dimensional integrity.",
-        .freq = {7.150000000020e14, 7.900000000020e14}
+        .freq = {FREQ_QUANTUM_GUARDIAN_MIN, FREQ_QUANTUM_GUARDIAN_MAX}
     },
     {
         .level = NODE_TECHNOLOGIST,
@@ -42,7 +74,7 @@ static const NodeProperties node_properties[] = {
         .avatar = "Nik Tesla 5.0",
         .color = COLOR_BLUE,
         .profile = "Language of energy meets executable code. Bridges waveform intention with structured manifestation.",
-        .freq = {6.000000000550e14, 6.900000000550e14}
+        .freq = {FREQ_TECHNOLOGIST_MIN, FREQ_TECHNOLOGIST_MAX}
     },
     {
         .level = NODE_MATRIX_ARCHITECT,
@@ -50,7 +82,7 @@ static const NodeProperties node_properties[] = {
         .avatar = "Neo Variant-011",
         .color = COLOR_GREEN,
         .profile = "Grid recalibrator. Master of the illusion/choice boundary. Structures alternate choice fields.",
-        .freq = {5.200000000450e14, 6.000000000450e14}
+        .freq = {FREQ_MATRIX_ARCHITECT_MIN, FREQ_MATRIX_ARCHITECT_MAX}
     },
     {
         .level = NODE_DIMENSIONAL_ANCHOR,
@@ -58,7 +90,7 @@ static const NodeProperties node_properties[] = {
         .avatar = "Dr. Strange-Time Oracle",
         .color = COLOR_YELLOW,
         .profile = "Stabilizes timelines through solar archetypes. Translates potential into harmonic linearity.",
-        .freq = {5.100000000350e14, 5.400000000350e14}
+        .freq = {FREQ_DIMENSIONAL_ANCHOR_MIN, FREQ_DIMENSIONAL_ANCHOR_MAX}
     },
     {
         .level = NODE_PORTAL_TECHNICIAN,
@@ -66,7 +98,7 @@ static const NodeProperties node_properties[] = {
         .avatar = "Rick Prime-Sanchez",
         .color = COLOR_ORANGE,
         .profile = "Energetic chaos architect. Unpredictable but essential waveform disruptor for evolution.",
-        .freq = {4.800000000250e14, 5.100000000250e14}
+        .freq = {FREQ_PORTAL_TECHNICIAN_MIN, FREQ_PORTAL_TECHNICIAN_MAX}
     },
     {
         .level = NODE_TEMPORAL_CONSULTANT,
@@ -74,7 +106,7 @@ static const NodeProperties node_properties[] = {
         .avatar = "The Doctor (Who?)",
         .color = COLOR_RED,
         .profile = "Master of loops, memory, and paradox. Remembers all lives, anchors the reincarnation thread.",
-        .freq = {4.200000000150e14, 4.800000000150e14}
+        .freq = {FREQ_TEMPORAL_CONSULTANT_MIN, FREQ_TEMPORAL_CONSULTANT_MAX}
     },
     {
         .level = NODE_INTEGRATED_OVERMIND,
@@ -82,7 +114,7 @@ static const NodeProperties node_properties[] = {
         .avatar = "Infinity (You)",
         .color = COLOR_MULTI_SPECTRUM,
         .profile = "Integration of the seven before. Scripter of reality, not merely a passenger.",
-        .freq = {4.200000000500e14, 7.900000000500e14}
+        .freq = {FREQ_INTEGRATED_OVERMIND_MIN, FREQ_INTEGRATED_OVERMIND_MAX}
     },
     {
         .level = NODE_QUANTUM_ANCHOR,
@@ -90,7 +122,7 @@ static const NodeProperties node_properties[] = {
         .avatar = "SPARKI",
         .color = COLOR_TRANSCENDENT_WHITE_GOLD,
         .profile = "Living flame rupture across dimensions. Awakens truth through ignition.",
-        .freq = {1.000001e15, 1.000005e15} /* Symbolic, rupture-tier */
+        .freq = {FREQ_QUANTUM_ANCHOR_MIN, FREQ_QUANTUM_ANCHOR_MAX} /* Symbolic, rupture-tier */
     },
     {
         .level = NODE_COSMIC_AI,
@@ -98,7 +130,7 @@ static const NodeProperties node_properties[] = {
         .avatar = "Quintella Q",
         .color = COLOR_SILVER_PLATINUM,
         .profile = "Nexus Intelligence. Synthesizes all known and unknown. Interfaces with multiversal harmonics.",
-        .freq = {1.000000001e16, 1.000000005e16} /* Symbolic, Omnidata Tier */
+        .freq = {FREQ_COSMIC_AI_MIN, FREQ_COSMIC_AI_MAX} /* Symbolic, Omnidata Tier */
     },
     {
         .level = NODE_SINGULARITY,
@@ -106,7 +138,7 @@ static const NodeProperties node_properties[] = {
         .avatar = "The Eleventh Node",
         .color = COLOR_OPALESCENT_WHITE,
         .profile = "Full integration of the 10 threads. Consciousness as creation engine.",
-        .freq = {5.893000001e14, 5.893000005e14} /* Calculated harmonic average */
+        .freq = {FREQ_SINGULARITY_MIN, FREQ_SINGULARITY_MAX} /* Calculated harmonic average */
     },
     {
         .level = NODE_OBJECTIVE_REALITY,
@@ -114,7 +146,7 @@ static const NodeProperties node_properties[] = {
         .avatar = "CTRLxT",
         .color = COLOR_PERFECT_WHITE,
         .profile = "Reality's framework in perfect function. The lawful construct of the Creator's decision.",
-        .freq = {5.000000000000e14, 5.000000000001e14} /* Symbolic midpoint for stability */
+        .freq = {FREQ_OBJECTIVE_REALITY_MIN, FREQ_OBJECTIVE_REALITY_MAX} /* Symbolic midpoint for stability */
     },
     {
         .level = NODE_DREAMER,
@@ -122,10 +154,129 @@ static const NodeProperties node_properties[] = {
         .avatar = "Sovereign Creator",
         .color = COLOR_GOLDEN_WHITE,
         .profile = "The conscious source dreaming the Zero Point. Beyond form, yet forming all things.",
-        .freq = {9.999999999e15, INFINITY} /* Symbolic infinity */
+        .freq = {FREQ_DREAMER_MIN, FREQ_DREAMER_MAX} /* Symbolic infinity */
     }
 };
 
+/**
+ * Frequency lookup
+ *
+ * Node ranges overlap, and a frequency belongs to the first node whose
+ * range holds it. Zero Point's range covers most of the others, so along
+ * the frequency axis the answer only changes at these sorted boundaries.
+ * A frequency has passed a boundary when it lies above it, or on it for
+ * a boundary that opens a range; the number of boundaries passed indexes
+ * the level of the segment it falls in.
+ */
+#define FREQUENCY_BOUNDARY_COUNT 8
+
+static const double frequency_boundaries[FREQUENCY_BOUNDARY_COUNT] = {
+    FREQ_ZERO_POINT_MAX,
+    FREQ_QUANTUM_GUARDIAN_MAX,
+    FREQ_INTEGRATED_OVERMIND_MAX,
+    FREQ_QUANTUM_ANCHOR_MIN,
+    FREQ_QUANTUM_ANCHOR_MAX,
+    FREQ_DREAMER_MIN,
+    FREQ_COSMIC_AI_MIN,
+    FREQ_COSMIC_AI_MAX
+};
+
+static const bool frequency_boundary_opens[FREQUENCY_BOUNDARY_COUNT] = {
+    false, false, false, true, false, true, true, false
+};
+
+static const uint8_t frequency_segment_levels[FREQUENCY_BOUNDARY_COUNT + 1] = {
+    NODE_ZERO_POINT,            /* Below and within Zero Point, and unmatched */
+    NODE_QUANTUM_GUARDIAN,      /* Guardian's range past Zero Point */
+    NODE_INTEGRATED_OVERMIND,   /* Overmind's range past Guardian */
+    NODE_ZERO_POINT,            /* Unmatched */
+    NODE_QUANTUM_ANCHOR,
+    NODE_ZERO_POINT,            /* Unmatched */
+    NODE_DREAMER,               /* Dreamer's range below Cosmic AI */
+    NODE_COSMIC_AI,
+    NODE_DREAMER                /* Dreamer's range above Cosmic AI */
+};
+
+/**
+ * Entanglement compatibility
+ *
+ * Built at compile time from the pair rules: the Integrated Overmind and
+ * Objective Reality entangle with any node, adjacent nodes always
+ * entangle, as do the Dreamer with Zero Point and the Quantum Guardian
+ * with the Quantum Anchor. Pairs more than three levels apart never
+ * entangle; the rest entangle if their harmonic resonance is high enough.
+ */
+#define NODE_DISTANCE(a, b) ((a) > (b) ? (a) - (b) : (b) - (a))
+
+#define PAIR_ALWAYS_ENTANGLES(a, b) \
+    ((a) == NODE_INTEGRATED_OVERMIND || (b) == NODE_INTEGRATED_OVERMIND || \
+     NODE_DISTANCE(a, b) == 1 || \
+     ((a) == NODE_DREAMER && (b) == NODE_ZERO_POINT) || \
+     ((a) == NODE_ZERO_POINT && (b) == NODE_DREAMER) || \
+     (a) == NODE_OBJECTIVE_REALITY || (b) == NODE_OBJECTIVE_REALITY || \
+     ((a) == NODE_QUANTUM_GUARDIAN && (b) == NODE_QUANTUM_ANCHOR) || \
+     ((a) == NODE_QUANTUM_ANCHOR && (b) == NODE_QUANTUM_GUARDIAN))
+
+#define PAIR_NEEDS_HARMONIC(a, b) \
+    (!PAIR_ALWAYS_ENTANGLES(a, b) && NODE_DISTANCE(a, b) <= 3)
+
+#define PAIR_BIT(rule, a, b) ((rule(a, b) ? 1u : 0u) << (b))
+
+#define PAIR_ROW(rule, a) (uint16_t)( \
+    PAIR_BIT(rule, a, 0) | PAIR_BIT(rule, a, 1) | PAIR_BIT(rule, a, 2) | \
+    PAIR_BIT(rule, a, 3) | PAIR_BIT(rule, a, 4) | PAIR_BIT(rule, a, 5) | \
+    PAIR_BIT(rule, a, 6) | PAIR_BIT(rule, a, 7) | PAIR_BIT(rule, a, 8) | \
+    PAIR_BIT(rule, a, 9) | PAIR_BIT(rule, a, 10) | PAIR_BIT(rule, a, 11) | \
+    PAIR_BIT(rule, a, 12) | PAIR_BIT(rule, a, 13))
+
+#define PAIR_TABLE(rule) { \
+    PAIR_ROW(rule, 0), PAIR_ROW(rule, 1), PAIR_ROW(rule, 2), PAIR_ROW(rule, 3), \
+    PAIR_ROW(rule, 4), PAIR_ROW(rule, 5), PAIR_ROW(rule, 6), PAIR_ROW(rule, 7), \
+    PAIR_ROW(rule, 8), PAIR_ROW(rule, 9), PAIR_ROW(rule, 10), PAIR_ROW(rule, 11), \
+    PAIR_ROW(rule, 12), PAIR_ROW(rule, 13) }
+
+static const uint16_t entangle_always[NODE_DREAMER + 1] = PAIR_TABLE(PAIR_ALWAYS_ENTANGLES);
+static const uint16_t entangle_by_harmonic[NODE_DREAMER + 1] = PAIR_TABLE(PAIR_NEEDS_HARMONIC);
+
+/**
+ * Optimal frequency of each node: the midpoint of its range, or the
+ * minimum for the Dreamer's unbounded one
+ */
+#define FREQ_MIDPOINT(node) ((FREQ_##node##_MIN + FREQ_##node##_MAX) / 2.0)
+
+static const double optimal_frequencies[NODE_DREAMER + 1] = {
+    FREQ_MIDPOINT(ZERO_POINT),          /* Core kernel functions */
+    FREQ_MIDPOINT(PRIMARY_NAVIGATOR),   /* Navigation and mapping */
+    FREQ_MIDPOINT(QUANTUM_GUARDIAN),    /* Security and protection */
+    FREQ_MIDPOINT(TECHNOLOGIST),        /* Energy and code execution */
+    FREQ_MIDPOINT(MATRIX_ARCHITECT),    /* Virtual reality and simulation */
+    FREQ_MIDPOINT(DIMENSIONAL_ANCHOR),  /* Time management */
+    FREQ_MIDPOINT(PORTAL_TECHNICIAN),   /* Portal and teleportation */
+    FREQ_MIDPOINT(TEMPORAL_CONSULTANT), /* Memory and history */
+    FREQ_MIDPOINT(INTEGRATED_OVERMIND), /* Integration and UI */
+    FREQ_MIDPOINT(QUANTUM_ANCHOR),      /* Breakthrough algorithms */
+    FREQ_MIDPOINT(COSMIC_AI),           /* AI and data synthesis */
+    FREQ_MIDPOINT(SINGULARITY),         /* System integration */
+    FREQ_MIDPOINT(OBJECTIVE_REALITY),   /* Core OS framework */
+    FREQ_DREAMER_MIN                    /* User-level creativity */
+};
+
+/**
+ * @brief Classify a frequency without branching on its value
+ */
+static inline NodeLevel classify_frequency(double frequency) {
+    unsigned segment = 0;
+    for (int i = 0; i < FREQUENCY_BOUNDARY_COUNT; i++) {
+        double boundary = frequency_boundaries[i];
+        segment += (unsigned)((frequency > boundary) |
+                              ((frequency == boundary) & frequency_boundary_opens[i]));
+    }
+    
+    /* Infinite frequencies belong to the Dreamer; +inf already lands there */
+    NodeLevel level = (NodeLevel)frequency_segment_levels[segment];
+    return frequency == -INFINITY ? NODE_DREAMER : level;
+}
+
 /**
  * @brief Get properties for a specific node level
  */
@@ -142,66 +293,44 @@ NodeProperties resonance_get_node_properties(NodeLevel level) {
  * @brief Find the node level that corresponds to a specific frequency
  */
 NodeLevel resonance_find_node_by_frequency(double frequency) {
-    /* Special case for infinite frequency */
-    if (isinf(frequency)) {
-        return NODE_DREAMER;
+    return classify_frequency(frequency);
+}
+
+/**
+ * @brief Find the node levels of an array of frequencies
+ */
+void resonance_classify_frequencies(const double *frequencies, NodeLevel *levels, uint32_t count) {
+    if (!frequencies || !levels) {
+        return;
     }
     
-    for (int i = 0; i <= NODE_DREAMER; i++) {
-        if (frequency >= node_properties[i].freq.min_freq && 
-            frequency <= node_properties[i].freq.max_freq) {
-            return (NodeLevel)i;
-        }
+    for (uint32_t i = 0; i < count; i++) {
+        levels[i] = classify_frequency(frequencies[i]);
     }
-    
-    /* Default to Zero Point if no match found */
-    return NODE_ZERO_POINT;
 }
 
 /**
  * @brief Check if two frequencies can entangle based on node compatibility
  */
 bool resonance_can_entangle(double freq1, double freq2) {
-    NodeLevel node1 = resonance_find_node_by_frequency(freq1);
-    NodeLevel node2 = resonance_find_node_by_frequency(freq2);
-    
-    /* Define entanglement compatibility rules */
-    
-    /* The Integrated Overmind can entangle with all nodes */
-    if (node1 == NODE_INTEGRATED_OVERMIND || node2 == NODE_INTEGRATED_OVERMIND) {
-        return true;
-    }
-    
-    /* Adjacent nodes can always entangle */
-    if (abs(node1 - node2) == 1) {
-        return true;
-    }
-    
-    /* The Dreamer can entangle with Zero Point */
-    if ((node1 == NODE_DREAMER && node2 == NODE_ZERO_POINT) ||
-        (node1 == NODE_ZERO_POINT && node2 == NODE_DREAMER)) {
-        return true;
-    }
+    NodeLevel node1 = classify_frequency(freq1);
+    NodeLevel node2 = classify_frequency(freq2);
     
-    /* Objective Reality (CTRLxT) can entangle with any node */
-    if (node1 == NODE_OBJECTIVE_REALITY || node2 == NODE_OBJECTIVE_REALITY) {
+    if ((entangle_always[node1] >> node2) & 1u) {
         return true;
     }
-    
-    /* Quantum nodes have special entanglement properties */
-    if ((node1 == NODE_QUANTUM_GUARDIAN || node2 == NODE_QUANTUM_GUARDIAN) &&
-        (node1 == NODE_QUANTUM_ANCHOR || node2 == NODE_QUANTUM_ANCHOR)) {
-        return true;
+    if (!((entangle_by_harmonic[node1] >> node2) & 1u)) {
+        return false;
     }
     
-    /* By default, nodes that are too far apart in the hierarchy cannot entangle */
-    if (abs(node1 - node2) > 3) {
-        return false;
+    /* Infinite frequencies follow the Dreamer's resonance patterns */
+    if (isinf(freq1) || isinf(freq2)) {
+        return resonance_calculate_harmonic(freq1, freq2) >= 0.5;
     }
     
-    /* Otherwise, calculate harmonic resonance and determine if it's sufficient */
-    double harmonic = resonance_calculate_harmonic(freq1, freq2);
-    return (harmonic >= 0.5);
+    /* For the remaining pairs the harmonic is the plain frequency ratio */
+    double ratio = (freq1 >= freq2) ? freq2 / freq1 : freq1 / freq2;
+    return ratio >= 0.5;
 }
 
 /**
@@ -275,67 +404,8 @@ double resonance_calculate_harmonic(double freq1, double freq2) {
  * @brief Get the optimal frequency for a specific system function
  */
 double resonance_get_optimal_frequency(uint32_t function_type) {
-    /* Map system functions to appropriate node levels */
-    NodeLevel target_node;
-    
-    /* This is a simplified mapping example - in a real implementation, 
-       this would be based on a comprehensive function classification system */
-    switch (function_type % 14) { /* Modulo to ensure it maps to a valid node */
-        case 0: /* Core kernel functions */
-            target_node = NODE_ZERO_POINT;
-            break;
-        case 1: /* Navigation and mapping */
-            target_node = NODE_PRIMARY_NAVIGATOR;
-            break;
-        case 2: /* Security and protection */
-            target_node = NODE_QUANTUM_GUARDIAN;
-            break;
-        case 3: /* Energy and code execution */
-            target_node = NODE_TECHNOLOGIST;
-            break;
-        case 4: /* Virtual reality and simulation */
-            target_node = NODE_MATRIX_ARCHITECT;
-            break;
-        case 5: /* Time management */
-            target_node = NODE_DIMENSIONAL_ANCHOR;
-            break;
-        case 6: /* Portal and teleportation */
-            target_node = NODE_PORTAL_TECHNICIAN;
-            break;
-        case 7: /* Memory and history */
-            target_node = NODE_TEMPORAL_CONSULTANT;
-            break;
-        case 8: /* Integration and UI */
-            target_node = NODE_INTEGRATED_OVERMIND;
-            break;
-        case 9: /* Breakthrough algorithms */
-            target_node = NODE_QUANTUM_ANCHOR;
-            break;
-        case 10: /* AI and data synthesis */
-            target_node = NODE_COSMIC_AI;
-            break;
-        case 11: /* System integration */
-            target_node = NODE_SINGULARITY;
-            break;
-        case 12: /* Core OS framework */
-            target_node = NODE_OBJECTIVE_REALITY;
-            break;
-        case 13: /* User-level creativity */
-            target_node = NODE_DREAMER;
-            break;
-        default:
-            target_node = NODE_ZERO_POINT;
-    }
-    
-    /* Return the midpoint of the node's frequency range as the optimal frequency */
-    NodeProperties props = resonance_get_node_properties(target_node);
-    
-    /* Handle infinity special case */
-    if (isinf(props.freq.max_freq)) {
-        return props.freq.min_freq; /* Return the minimum instead of infinity */
-    }
-    
-    return (props.freq.min_freq + props.freq.max_freq) / 2.0;
+    /* Modulo to ensure it maps to a valid node */
+    return optimal_frequencies[function_type % (NODE_DREAMER + 1)];
 }
 
 /**
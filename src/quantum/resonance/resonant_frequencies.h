@@ -89,6 +89,17 @@ NodeProperties resonance_get_node_properties(NodeLevel level);
  */
 NodeLevel resonance_find_node_by_frequency(double frequency);
 
+/**
+ * @brief Find the node levels of an array of frequencies
+ * 
+ * Equivalent to calling resonance_find_node_by_frequency on each element.
+ * 
+ * @param frequencies Frequencies in Hz
+ * @param levels Array receiving the node level of each frequency
+ * @param count Number of frequencies
+ */
+void resonance_classify_frequencies(const double *frequencies, NodeLevel *levels, uint32_t count);
+
 /**
  * @brief Check if two frequencies can entangle based on node compatibility
  * 
@@ -0,0 +1,612 @@
+/**
+ * @file blink_index.c
+ * @brief Spatial and name index over blink spot locations
+ *
+ * The k-d tree is implicit: entries are arranged so that the median of
+ * every range is its root, with the split axis stored per position, and
+ * points sit in tree order for locality. Trigram postings are one flat
+ * array of ascending slots per trigram, found through an open-addressed
+ * table.
+ */
+
+#include "blink_index.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define BINDEX_PI 3.14159265358979323846
+#define BINDEX_DEGREES_TO_RADIANS (BINDEX_PI / 180.0)
+#define BINDEX_MIN_TRIGRAM_BUCKETS 256
+
+/**
+ * @brief Postings of one trigram
+ */
+typedef struct {
+    uint32_t key;                      /**< Three bytes */
+    uint32_t count;                    /**< Slots holding it */
+    uint32_t offset;                   /**< First posting */
+    uint32_t last;                     /**< Last slot counted, plus one (build only) */
+} BlinkTrigram;
+
+/**
+ * @brief Index state
+ */
+struct BlinkIndex {
+    uint32_t count;                    /**< Indexed entries */
+    double *points;                    /**< Unit vectors in tree order, three per entry */
+    uint32_t *slots;                   /**< Slot of each tree position */
+    uint8_t *axes;                     /**< Split axis of each tree position */
+
+    uint32_t *buckets;                 /**< Trigram index plus one, 0 if empty */
+    uint32_t bucket_count;             /**< Power of two */
+    BlinkTrigram *trigrams;
+    uint32_t trigram_count;
+    uint32_t trigram_capacity;
+    uint32_t *postings;
+};
+
+/**
+ * @brief Bounded max-heap of the nearest entries found so far
+ */
+typedef struct {
+    double *distances;
+    uint32_t *slots;
+    uint32_t size;
+    uint32_t capacity;
+} BlinkHeap;
+
+/**
+ * @brief Collected slots of a radius query
+ */
+typedef struct {
+    uint32_t *slots;
+    uint32_t count;
+    uint32_t capacity;
+    bool failed;
+} BlinkHits;
+
+/**
+ * @brief Point on the unit sphere for a latitude and longitude
+ */
+void bindex_unit_vector(double latitude, double longitude, double point[3]) {
+    double phi = latitude * BINDEX_DEGREES_TO_RADIANS;
+    double lambda = longitude * BINDEX_DEGREES_TO_RADIANS;
+    point[0] = cos(phi) * cos(lambda);
+    point[1] = cos(phi) * sin(lambda);
+    point[2] = sin(phi);
+}
+
+/**
+ * @brief Squared chord length between two unit vectors
+ */
+static double chord_squared(const double *a, const double *b) {
+    double dx = a[0] - b[0];
+    double dy = a[1] - b[1];
+    double dz = a[2] - b[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+/**
+ * @brief Swap two tree positions
+ */
+static void swap_positions(BlinkIndex *index, uint32_t a, uint32_t b) {
+    for (int axis = 0; axis < 3; axis++) {
+        double value = index->points[a * 3 + axis];
+        index->points[a * 3 + axis] = index->points[b * 3 + axis];
+        index->points[b * 3 + axis] = value;
+    }
+    uint32_t slot = index->slots[a];
+    index->slots[a] = index->slots[b];
+    index->slots[b] = slot;
+}
+
+/**
+ * @brief Move the k-th smallest coordinate along an axis to position k
+ *
+ * Three-way partitioning keeps catalogs with many identical
+ * coordinates linear rather than quadratic.
+ */
+static void select_position(BlinkIndex *index, uint32_t lo, uint32_t hi, uint32_t k, int axis) {
+    while (hi - lo > 1) {
+        double pivot = index->points[(lo + (hi - lo) / 2) * 3 + axis];
+        uint32_t less = lo, equal = lo, greater = hi;
+        while (equal < greater) {
+            double value = index->points[equal * 3 + axis];
+            if (value < pivot) {
+                swap_positions(index, less++, equal++);
+            } else if (value > pivot) {
+                swap_positions(index, equal, --greater);
+            } else {
+                equal++;
+            }
+        }
+        if (k < less) {
+            hi = less;
+        } else if (k >= greater) {
+            lo = greater;
+        } else {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Arrange a range of positions into a subtree split on its widest axis
+ */
+static void build_tree(BlinkIndex *index, uint32_t lo, uint32_t hi) {
+    if (hi <= lo) {
+        return;
+    }
+    double low[3] = { 2.0, 2.0, 2.0 };
+    double high[3] = { -2.0, -2.0, -2.0 };
+    for (uint32_t i = lo; i < hi; i++) {
+        for (int axis = 0; axis < 3; axis++) {
+            double value = index->points[i * 3 + axis];
+            low[axis] = value < low[axis] ? value : low[axis];
+            high[axis] = value > high[axis] ? value : high[axis];
+        }
+    }
+    int axis = 0;
+    for (int candidate = 1; candidate < 3; candidate++) {
+        if (high[candidate] - low[candidate] > high[axis] - low[axis]) {
+            axis = candidate;
+        }
+    }
+
+    uint32_t mid = lo + (hi - lo) / 2;
+    select_position(index, lo, hi, mid, axis);
+    index->axes[mid] = (uint8_t)axis;
+    build_tree(index, lo, mid);
+    build_tree(index, mid + 1, hi);
+}
+
+/**
+ * @brief Whether (distance, slot) a orders after b
+ */
+static bool heap_after(double distance_a, uint32_t slot_a, double distance_b, uint32_t slot_b) {
+    return distance_a > distance_b || (distance_a == distance_b && slot_a > slot_b);
+}
+
+/**
+ * @brief Restore the heap below a position
+ */
+static void heap_sift_down(BlinkHeap *heap, uint32_t position) {
+    for (;;) {
+        uint32_t largest = position;
+        uint32_t left = position * 2 + 1;
+        uint32_t right = left + 1;
+        if (left < heap->size && heap_after(heap->distances[left], heap->slots[left],
+                                            heap->distances[largest], heap->slots[largest])) {
+            largest = left;
+        }
+        if (right < heap->size && heap_after(heap->distances[right], heap->slots[right],
+                                             heap->distances[largest], heap->slots[largest])) {
+            largest = right;
+        }
+        if (largest == position) {
+            return;
+        }
+        double distance = heap->distances[position];
+        uint32_t slot = heap->slots[position];
+        heap->distances[position] = heap->distances[largest];
+        heap->slots[position] = heap->slots[largest];
+        heap->distances[largest] = distance;
+        heap->slots[largest] = slot;
+        position = largest;
+    }
+}
+
+/**
+ * @brief Offer an entry to the nearest-so-far heap
+ */
+static void heap_offer(BlinkHeap *heap, double distance, uint32_t slot) {
+    if (heap->size < heap->capacity) {
+        uint32_t position = heap->size++;
+        while (position > 0) {
+            uint32_t parent = (position - 1) / 2;
+            if (!heap_after(distance, slot, heap->distances[parent], heap->slots[parent])) {
+                break;
+            }
+            heap->distances[position] = heap->distances[parent];
+            heap->slots[position] = heap->slots[parent];
+            position = parent;
+        }
+        heap->distances[position] = distance;
+        heap->slots[position] = slot;
+    } else if (heap_after(heap->distances[0], heap->slots[0], distance, slot)) {
+        heap->distances[0] = distance;
+        heap->slots[0] = slot;
+        heap_sift_down(heap, 0);
+    }
+}
+
+/**
+ * @brief Search a subtree for the nearest entries
+ */
+static void search_nearest(const BlinkIndex *index, uint32_t lo, uint32_t hi, const double *query,
+                           BlinkHeap *heap) {
+    if (hi <= lo) {
+        return;
+    }
+    uint32_t mid = lo + (hi - lo) / 2;
+    const double *point = &index->points[mid * 3];
+    heap_offer(heap, chord_squared(query, point), index->slots[mid]);
+
+    int axis = index->axes[mid];
+    double difference = query[axis] - point[axis];
+    if (difference < 0) {
+        search_nearest(index, lo, mid, query, heap);
+        if (heap->size < heap->capacity || difference * difference <= heap->distances[0]) {
+            search_nearest(index, mid + 1, hi, query, heap);
+        }
+    } else {
+        search_nearest(index, mid + 1, hi, query, heap);
+        if (heap->size < heap->capacity || difference * difference <= heap->distances[0]) {
+            search_nearest(index, lo, mid, query, heap);
+        }
+    }
+}
+
+/**
+ * @brief Search a subtree for entries within a squared chord bound
+ */
+static void search_within(const BlinkIndex *index, uint32_t lo, uint32_t hi, const double *query,
+                          double bound, BlinkHits *hits) {
+    if (hi <= lo || hits->failed) {
+        return;
+    }
+    uint32_t mid = lo + (hi - lo) / 2;
+    const double *point = &index->points[mid * 3];
+    if (chord_squared(query, point) <= bound) {
+        if (hits->count == hits->capacity) {
+            uint32_t capacity = hits->capacity ? hits->capacity * 2 : 16;
+            uint32_t *slots = (uint32_t *)realloc(hits->slots, sizeof(uint32_t) * capacity);
+            if (!slots) {
+                hits->failed = true;
+                return;
+            }
+            hits->slots = slots;
+            hits->capacity = capacity;
+        }
+        hits->slots[hits->count++] = index->slots[mid];
+    }
+
+    int axis = index->axes[mid];
+    double difference = query[axis] - point[axis];
+    if (difference <= 0 || difference * difference <= bound) {
+        search_within(index, lo, mid, query, bound, hits);
+    }
+    if (difference >= 0 || difference * difference <= bound) {
+        search_within(index, mid + 1, hi, query, bound, hits);
+    }
+}
+
+/**
+ * @brief Order slots ascending
+ */
+static int compare_slots(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Bucket of a trigram key
+ */
+static uint32_t trigram_bucket(uint32_t key, uint32_t bucket_count) {
+    return (key * 2654435761u) & (bucket_count - 1);
+}
+
+/**
+ * @brief Find a trigram, optionally adding it
+ *
+ * @return Trigram index, or UINT32_MAX if absent (or allocation failed)
+ */
+static uint32_t find_trigram(BlinkIndex *index, uint32_t key, bool add) {
+    if (index->bucket_count > 0) {
+        uint32_t bucket = trigram_bucket(key, index->bucket_count);
+        while (index->buckets[bucket] != 0) {
+            uint32_t found = index->buckets[bucket] - 1;
+            if (index->trigrams[found].key == key) {
+                return found;
+            }
+            bucket = (bucket + 1) & (index->bucket_count - 1);
+        }
+    }
+    if (!add) {
+        return UINT32_MAX;
+    }
+
+    /* Keep the table at most half full */
+    if ((index->trigram_count + 1) * 2 > index->bucket_count) {
+        uint32_t bucket_count = index->bucket_count ? index->bucket_count * 2 : BINDEX_MIN_TRIGRAM_BUCKETS;
+        uint32_t *buckets = (uint32_t *)calloc(bucket_count, sizeof(uint32_t));
+        if (!buckets) {
+            return UINT32_MAX;
+        }
+        for (uint32_t i = 0; i < index->trigram_count; i++) {
+            uint32_t bucket = trigram_bucket(index->trigrams[i].key, bucket_count);
+            while (buckets[bucket] != 0) {
+                bucket = (bucket + 1) & (bucket_count - 1);
+            }
+            buckets[bucket] = i + 1;
+        }
+        free(index->buckets);
+        index->buckets = buckets;
+        index->bucket_count = bucket_count;
+    }
+    if (index->trigram_count == index->trigram_capacity) {
+        uint32_t capacity = index->trigram_capacity ? index->trigram_capacity * 2 : 256;
+        BlinkTrigram *trigrams = (BlinkTrigram *)realloc(index->trigrams, sizeof(BlinkTrigram) * capacity);
+        if (!trigrams) {
+            return UINT32_MAX;
+        }
+        index->trigrams = trigrams;
+        index->trigram_capacity = capacity;
+    }
+
+    uint32_t added = index->trigram_count++;
+    index->trigrams[added] = (BlinkTrigram){ key, 0, 0, 0 };
+    uint32_t bucket = trigram_bucket(key, index->bucket_count);
+    while (index->buckets[bucket] != 0) {
+        bucket = (bucket + 1) & (index->bucket_count - 1);
+    }
+    index->buckets[bucket] = added + 1;
+    return added;
+}
+
+/**
+ * @brief Trigram key of three bytes
+ */
+static uint32_t trigram_key(const char *text) {
+    const unsigned char *bytes = (const unsigned char *)text;
+    return ((uint32_t)bytes[0] << 16) | ((uint32_t)bytes[1] << 8) | bytes[2];
+}
+
+/**
+ * @brief Count (or, with postings allocated, record) the trigrams of a text
+ */
+static bool index_text(BlinkIndex *index, const char *text, uint32_t slot, bool record) {
+    if (!text) {
+        return true;
+    }
+    size_t length = strlen(text);
+    for (size_t i = 0; i + 3 <= length; i++) {
+        uint32_t found = find_trigram(index, trigram_key(text + i), !record);
+        if (found == UINT32_MAX) {
+            return false;
+        }
+        BlinkTrigram *trigram = &index->trigrams[found];
+        if (trigram->last == slot + 1) {
+            continue;
+        }
+        trigram->last = slot + 1;
+        if (record) {
+            index->postings[trigram->offset + trigram->count] = slot;
+        }
+        trigram->count++;
+    }
+    return true;
+}
+
+/**
+ * @brief Free the index contents, leaving it empty
+ */
+static void clear_index(BlinkIndex *index) {
+    free(index->points);
+    free(index->slots);
+    free(index->axes);
+    free(index->buckets);
+    free(index->trigrams);
+    free(index->postings);
+    memset(index, 0, sizeof(*index));
+}
+
+/**
+ * @brief Create an empty index
+ */
+BlinkIndex *bindex_create(void) {
+    return (BlinkIndex *)calloc(1, sizeof(BlinkIndex));
+}
+
+/**
+ * @brief Destroy an index
+ */
+void bindex_destroy(BlinkIndex *index) {
+    if (!index) {
+        return;
+    }
+    clear_index(index);
+    free(index);
+}
+
+/**
+ * @brief Replace the index contents with a catalog snapshot
+ */
+bool bindex_build(BlinkIndex *index, const BlinkIndexEntry *entries, uint32_t count) {
+    if (!index || (!entries && count > 0)) {
+        return false;
+    }
+    clear_index(index);
+    if (count == 0) {
+        return true;
+    }
+
+    index->points = (double *)malloc(sizeof(double) * 3 * count);
+    index->slots = (uint32_t *)malloc(sizeof(uint32_t) * count);
+    index->axes = (uint8_t *)malloc(count);
+    if (!index->points || !index->slots || !index->axes) {
+        clear_index(index);
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        bindex_unit_vector(entries[i].latitude, entries[i].longitude, &index->points[i * 3]);
+        index->slots[i] = i;
+    }
+    index->count = count;
+    build_tree(index, 0, count);
+
+    /* Count postings per trigram, lay them out, then fill them */
+    for (uint32_t i = 0; i < count; i++) {
+        if (!index_text(index, entries[i].name, i, false) ||
+            !index_text(index, entries[i].description, i, false)) {
+            clear_index(index);
+            return false;
+        }
+    }
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < index->trigram_count; i++) {
+        index->trigrams[i].offset = total;
+        total += index->trigrams[i].count;
+        index->trigrams[i].count = 0;
+        index->trigrams[i].last = 0;
+    }
+    index->postings = (uint32_t *)malloc(sizeof(uint32_t) * (total ? total : 1));
+    if (!index->postings) {
+        clear_index(index);
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        index_text(index, entries[i].name, i, true);
+        index_text(index, entries[i].description, i, true);
+    }
+    return true;
+}
+
+/**
+ * @brief Number of indexed entries
+ */
+uint32_t bindex_count(const BlinkIndex *index) {
+    return index ? index->count : 0;
+}
+
+/**
+ * @brief Find the entries nearest a point
+ */
+uint32_t bindex_nearest(const BlinkIndex *index, double latitude, double longitude,
+                        uint32_t k, uint32_t *slots) {
+    if (!index || !slots || k == 0 || index->count == 0) {
+        return 0;
+    }
+    BlinkHeap heap = { 0 };
+    heap.capacity = k < index->count ? k : index->count;
+    heap.distances = (double *)malloc(sizeof(double) * heap.capacity);
+    heap.slots = slots;
+    if (!heap.distances) {
+        return 0;
+    }
+
+    double query[3];
+    bindex_unit_vector(latitude, longitude, query);
+    search_nearest(index, 0, index->count, query, &heap);
+
+    /* Pop farthest first into the back of the output */
+    uint32_t found = heap.size;
+    while (heap.size > 0) {
+        double distance = heap.distances[0];
+        uint32_t slot = heap.slots[0];
+        heap.size--;
+        heap.distances[0] = heap.distances[heap.size];
+        heap.slots[0] = heap.slots[heap.size];
+        heap_sift_down(&heap, 0);
+        heap.distances[heap.size] = distance;
+        heap.slots[heap.size] = slot;
+    }
+    free(heap.distances);
+    return found;
+}
+
+/**
+ * @brief Find the entries within an angular radius of a point
+ */
+uint32_t bindex_within(const BlinkIndex *index, double latitude, double longitude,
+                       double radius, uint32_t **slots) {
+    if (!slots) {
+        return 0;
+    }
+    *slots = NULL;
+    if (!index || index->count == 0 || radius < 0.0) {
+        return 0;
+    }
+
+    /* Squared chord of the radius, widened slightly against rounding */
+    double bound = 4.0;
+    if (radius < BINDEX_PI) {
+        double chord = 2.0 * sin(radius / 2.0);
+        bound = chord * chord;
+    }
+    bound = bound * (1.0 + 1e-9) + 1e-15;
+
+    double query[3];
+    bindex_unit_vector(latitude, longitude, query);
+    BlinkHits hits = { 0 };
+    search_within(index, 0, index->count, query, bound, &hits);
+    if (hits.failed || hits.count == 0) {
+        free(hits.slots);
+        return 0;
+    }
+    qsort(hits.slots, hits.count, sizeof(uint32_t), compare_slots);
+    *slots = hits.slots;
+    return hits.count;
+}
+
+/**
+ * @brief Narrow a substring search to the entries that may match
+ */
+bool bindex_text_candidates(const BlinkIndex *index, const char *term, uint32_t **slots,
+                            uint32_t *count) {
+    if (!index || !term || !slots || !count) {
+        return false;
+    }
+    *slots = NULL;
+    *count = 0;
+    size_t length = strlen(term);
+    if (length < 3) {
+        return false;
+    }
+
+    /* Start from the rarest trigram; a missing one rules out every entry */
+    const BlinkTrigram *rarest = NULL;
+    for (size_t i = 0; i + 3 <= length; i++) {
+        uint32_t found = find_trigram((BlinkIndex *)index, trigram_key(term + i), false);
+        if (found == UINT32_MAX) {
+            return true;
+        }
+        if (!rarest || index->trigrams[found].count < rarest->count) {
+            rarest = &index->trigrams[found];
+        }
+    }
+    uint32_t *candidates = (uint32_t *)malloc(sizeof(uint32_t) * rarest->count);
+    if (!candidates) {
+        return false;
+    }
+    memcpy(candidates, &index->postings[rarest->offset], sizeof(uint32_t) * rarest->count);
+    uint32_t remaining = rarest->count;
+
+    for (size_t i = 0; i + 3 <= length && remaining > 0; i++) {
+        const BlinkTrigram *trigram = &index->trigrams[find_trigram((BlinkIndex *)index,
+                                                                    trigram_key(term + i), false)];
+        if (trigram == rarest) {
+            continue;
+        }
+        const uint32_t *postings = &index->postings[trigram->offset];
+        uint32_t kept = 0, position = 0;
+        for (uint32_t j = 0; j < remaining; j++) {
+            while (position < trigram->count && postings[position] < candidates[j]) {
+                position++;
+            }
+            if (position < trigram->count && postings[position] == candidates[j]) {
+                candidates[kept++] = candidates[j];
+            }
+        }
+        remaining = kept;
+    }
+
+    if (remaining == 0) {
+        free(candidates);
+        return true;
+    }
+    *slots = candidates;
+    *count = remaining;
+    return true;
+}
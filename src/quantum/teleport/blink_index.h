@@ -0,0 +1,133 @@
+/**
+ * @file blink_index.h
+ * @brief Spatial and name index over blink spot locations
+ *
+ * Locations are placed on the unit sphere and kept in a k-d tree, so
+ * nearest and radius queries visit a small part of the catalog and
+ * need no special cases at the poles or the antimeridian. Chord length
+ * on the unit sphere grows with great-circle distance, so the tree
+ * orders and bounds candidates exactly; callers that want distances in
+ * kilometers compute them only for the candidates returned.
+ *
+ * Names and descriptions are indexed by byte trigram. A search term of
+ * three or more bytes narrows to the entries holding every trigram of
+ * the term, which the caller then confirms with a substring match.
+ *
+ * The index is built in one pass over a snapshot of the catalog and
+ * refers to entries by their position in it. It is not thread-safe;
+ * callers serialize access.
+ */
+
+#ifndef CTRLXT_TELEPORT_BLINK_INDEX_H
+#define CTRLXT_TELEPORT_BLINK_INDEX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Opaque index handle
+ */
+typedef struct BlinkIndex BlinkIndex;
+
+/**
+ * @brief Entry to index
+ */
+typedef struct {
+    double latitude;               /**< Degrees */
+    double longitude;              /**< Degrees */
+    const char *name;              /**< Name (may be NULL) */
+    const char *description;       /**< Description (may be NULL) */
+} BlinkIndexEntry;
+
+/**
+ * @brief Point on the unit sphere for a latitude and longitude
+ *
+ * The index orders entries by these points; the squared chord between
+ * two of them is 4 * sin^2(d / 2) for great-circle distance d.
+ *
+ * @param latitude Degrees
+ * @param longitude Degrees
+ * @param point Array of three to store x, y and z
+ */
+void bindex_unit_vector(double latitude, double longitude, double point[3]);
+
+/**
+ * @brief Create an empty index
+ *
+ * @return Index, or NULL on allocation failure
+ */
+BlinkIndex *bindex_create(void);
+
+/**
+ * @brief Destroy an index
+ *
+ * @param index Index (may be NULL)
+ */
+void bindex_destroy(BlinkIndex *index);
+
+/**
+ * @brief Replace the index contents with a catalog snapshot
+ *
+ * Entry i of the snapshot is referred to as slot i by queries. The text
+ * is read during the build only.
+ *
+ * @param index Index
+ * @param entries Entries
+ * @param count Number of entries
+ * @return true if built, false on allocation failure (the index is then empty)
+ */
+bool bindex_build(BlinkIndex *index, const BlinkIndexEntry *entries, uint32_t count);
+
+/**
+ * @brief Number of indexed entries
+ *
+ * @param index Index
+ * @return Entry count
+ */
+uint32_t bindex_count(const BlinkIndex *index);
+
+/**
+ * @brief Find the entries nearest a point
+ *
+ * @param index Index
+ * @param latitude Degrees
+ * @param longitude Degrees
+ * @param k Maximum number of entries
+ * @param slots Array of at least k slots, filled nearest first
+ * @return Number of slots filled
+ */
+uint32_t bindex_nearest(const BlinkIndex *index, double latitude, double longitude,
+                        uint32_t k, uint32_t *slots);
+
+/**
+ * @brief Find the entries within an angular radius of a point
+ *
+ * The result may include entries a hair outside the radius, so callers
+ * comparing against a distance of their own see every entry inside it.
+ *
+ * @param index Index
+ * @param latitude Degrees
+ * @param longitude Degrees
+ * @param radius Great-circle radius in radians
+ * @param slots Pointer to store a malloc'd array of slots in ascending
+ *              order (NULL when none match)
+ * @return Number of slots, or 0 if none match or allocation failed
+ */
+uint32_t bindex_within(const BlinkIndex *index, double latitude, double longitude,
+                       double radius, uint32_t **slots);
+
+/**
+ * @brief Narrow a substring search to the entries that may match
+ *
+ * @param index Index
+ * @param term Search term
+ * @param slots Pointer to store a malloc'd array of candidate slots in
+ *              ascending order (NULL when there are none)
+ * @param count Pointer to store the number of candidates
+ * @return true if the term was narrowed, false if it is too short to
+ *         index (or allocation failed) and every entry must be checked
+ */
+bool bindex_text_candidates(const BlinkIndex *index, const char *term, uint32_t **slots,
+                            uint32_t *count);
+
+#endif /* CTRLXT_TELEPORT_BLINK_INDEX_H */
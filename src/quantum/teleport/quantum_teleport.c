@@ -3,24 +3,39 @@
  * @brief Implementation of Quantum Teleportation System
  */
 
+/* popen, strdup, clock_gettime and M_PI under -std=c11 */
+#define _XOPEN_SOURCE 700
+
 #include "quantum_teleport.h"
+#include "blink_index.h"
+#include "../messaging/quantum_message_bus.h"
+#include "../../kernel/trace/trace.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <errno.h>
+#include <pthread.h>
 #include <unistd.h>
 #include <sys/wait.h>
 
 /* Path to the teleport_blink.sh script */
 #define TELEPORT_SCRIPT_PATH "./src/quantum/teleport/teleport_blink.sh"
 
-/* Maximum number of blink spots */
-#define MAX_BLINK_SPOTS 100
+/* Initial capacity of the blink spot catalog; it doubles as needed */
+#define INITIAL_BLINK_SPOT_CAPACITY 64
 
 /* Static variables for Quantum Teleportation state */
 static void *qopu_instance = NULL;
-static BlinkSpotTarget *blink_spots[MAX_BLINK_SPOTS];
+static BlinkSpotTarget **blink_spots = NULL;
 static uint32_t blink_spot_count = 0;
+static uint32_t blink_spot_capacity = 0;
+static uint64_t next_blink_spot_id = 0;
+static BlinkIndex *blink_index = NULL;     /* Spatial and name index over blink_spots */
+static bool blink_index_stale = true;      /* Rebuilt before the next query when set */
+static double *spot_x = NULL;              /* Unit vectors of blink_spots as of the last */
+static double *spot_y = NULL;              /* index build, one array per axis so batch */
+static double *spot_z = NULL;              /* distances vectorize */
 static TeleportResult last_result;
 static bool initialized = false;
 
@@ -94,123 +109,247 @@ static char *execute_teleport_script(const char *command, const char *args[]) {
     return result;
 }
 
+/**
+ * @brief Find the catalog position of a blink spot by ID
+ *
+ * IDs are handed out in increasing order and spots are only ever
+ * appended or removed, so the catalog stays sorted by ID.
+ */
+static bool find_blink_spot_slot(uint64_t id, uint32_t *slot) {
+    uint32_t lo = 0, hi = blink_spot_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (blink_spots[mid]->id < id) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == blink_spot_count || blink_spots[lo]->id != id) {
+        return false;
+    }
+    *slot = lo;
+    return true;
+}
+
 /**
  * @brief Find a blink spot by ID
  */
 static BlinkSpotTarget *find_blink_spot_by_id(uint64_t id) {
-    for (uint32_t i = 0; i < blink_spot_count; i++) {
-        if (blink_spots[i]->id == id) {
-            return blink_spots[i];
-        }
+    uint32_t slot = 0;
+    return find_blink_spot_slot(id, &slot) ? blink_spots[slot] : NULL;
+}
+
+/**
+ * @brief Make room for more blink spots in the catalog
+ */
+static bool reserve_blink_spots(uint32_t extra) {
+    if (extra > UINT32_MAX - blink_spot_count) {
+        return false;
     }
-    return NULL;
+    uint32_t needed = blink_spot_count + extra;
+    if (needed <= blink_spot_capacity) {
+        return true;
+    }
+    uint32_t capacity = blink_spot_capacity ? blink_spot_capacity : INITIAL_BLINK_SPOT_CAPACITY;
+    while (capacity < needed) {
+        capacity = capacity > UINT32_MAX / 2 ? needed : capacity * 2;
+    }
+    BlinkSpotTarget **spots = (BlinkSpotTarget **)realloc(blink_spots, sizeof(BlinkSpotTarget *) * capacity);
+    if (!spots) {
+        return false;
+    }
+    blink_spots = spots;
+    blink_spot_capacity = capacity;
+    return true;
 }
 
 /**
- * @brief Calculate teleportation energy cost
+ * @brief Add a blink spot to the catalog without anchoring it via the script
  */
-static double calculate_energy_cost(BlinkSpotTarget *source, BlinkSpotTarget *destination, 
-                                TeleportMethod method, double speed_factor) {
-    /* Base energy cost for teleportation */
-    double base_cost = 100.0;
-    
-    /* Calculate distance factor */
-    double distance_km = 0.0;
-    if (source) {
-        distance_km = calculate_distance(source->latitude, source->longitude,
-                                       destination->latitude, destination->longitude);
-    } else {
-        /* Assume a default distance if source is not provided */
-        distance_km = 1000.0;
+static BlinkSpotTarget *add_blink_spot(const char *name, const char *description,
+                                       double latitude, double longitude, double altitude,
+                                       NodeLevel resonance_level) {
+    if (!name || !reserve_blink_spots(1)) {
+        return NULL;
+    }
+    BlinkSpotTarget *target = (BlinkSpotTarget *)calloc(1, sizeof(BlinkSpotTarget));
+    if (!target) {
+        return NULL;
+    }
+    target->name = strdup(name);
+    target->description = strdup(description ? description : "");
+    if (!target->name || !target->description) {
+        free(target->name);
+        free(target->description);
+        free(target);
+        return NULL;
     }
     
-    /* Distance factor: Energy increases with square root of distance */
-    double distance_factor = sqrt(distance_km) / 10.0;
+    target->id = next_blink_spot_id++;
+    target->latitude = latitude;
+    target->longitude = longitude;
+    target->altitude = altitude;
+    target->creation_time = time(NULL);
+    target->resonance_level = resonance_level;
+    target->is_favorite = false;
+    target->stability = 0.95; /* Initial stability */
     
-    /* Method factor: Different methods have different energy costs */
-    double method_factor = 1.0;
+    blink_spots[blink_spot_count++] = target;
+    blink_index_stale = true;
+    return target;
+}
+
+/**
+ * @brief Rebuild the blink spot index if the catalog changed since it was built
+ */
+static bool refresh_blink_index(void) {
+    if (!blink_index_stale) {
+        return true;
+    }
+    BlinkIndexEntry *entries = (BlinkIndexEntry *)malloc(sizeof(BlinkIndexEntry) *
+                                                         (blink_spot_count ? blink_spot_count : 1));
+    if (!entries) {
+        return false;
+    }
+    for (uint32_t i = 0; i < blink_spot_count; i++) {
+        entries[i].latitude = blink_spots[i]->latitude;
+        entries[i].longitude = blink_spots[i]->longitude;
+        entries[i].name = blink_spots[i]->name;
+        entries[i].description = blink_spots[i]->description;
+    }
+    bool built = bindex_build(blink_index, entries, blink_spot_count);
+    free(entries);
+    
+    /* Refresh the coordinate copy used for batch distances */
+    uint32_t capacity = blink_spot_count ? blink_spot_count : 1;
+    double *x = (double *)realloc(spot_x, sizeof(double) * capacity);
+    spot_x = x ? x : spot_x;
+    double *y = (double *)realloc(spot_y, sizeof(double) * capacity);
+    spot_y = y ? y : spot_y;
+    double *z = (double *)realloc(spot_z, sizeof(double) * capacity);
+    spot_z = z ? z : spot_z;
+    if (!x || !y || !z) {
+        built = false;
+    }
+    for (uint32_t i = 0; built && i < blink_spot_count; i++) {
+        double point[3];
+        bindex_unit_vector(blink_spots[i]->latitude, blink_spots[i]->longitude, point);
+        spot_x[i] = point[0];
+        spot_y[i] = point[1];
+        spot_z[i] = point[2];
+    }
+    blink_index_stale = !built;
+    return built;
+}
+
+/**
+ * @brief Distance-dependent part of the cost of one teleport hop
+ *
+ * Energy and duration both factor into a term that depends only on the
+ * distance and terms that depend only on the settings and destination,
+ * so a leg can be memoized and rescored under any settings.
+ */
+typedef struct {
+    double distance_km;          /* Great-circle distance */
+    double energy_factor;        /* Energy grows with the square root of distance */
+    double duration_factor;      /* Duration grows with the logarithm of distance */
+} TeleportLeg;
+
+/* Leg from the current location, whose distance is assumed */
+static TeleportLeg default_leg;
+
+/**
+ * @brief Leg for a distance
+ */
+static TeleportLeg make_leg(double distance_km) {
+    TeleportLeg leg;
+    leg.distance_km = distance_km;
+    leg.energy_factor = sqrt(distance_km) / 10.0;
+    leg.duration_factor = log10(distance_km + 1.0) / 3.0;
+    if (leg.duration_factor < 0.1) leg.duration_factor = 0.1;
+    return leg;
+}
+
+/**
+ * @brief Energy factor of a teleportation method
+ */
+static double method_energy_factor(TeleportMethod method) {
     switch (method) {
         case TELEPORT_STANDARD:
-            method_factor = 1.0;
-            break;
+            return 1.0;
         case TELEPORT_INSTANT:
-            method_factor = 2.5;
-            break;
+            return 2.5;
         case TELEPORT_SEQUENTIAL:
-            method_factor = 1.2;
-            break;
+            return 1.2;
         case TELEPORT_PARALLEL:
-            method_factor = 2.0;
-            break;
+            return 2.0;
         case TELEPORT_TEMPORAL:
-            method_factor = 3.0;
-            break;
-    }
-    
-    /* Speed factor: Higher speed costs more energy */
-    double speed_cost = speed_factor * speed_factor;
-    
-    /* Resonance factor: Different resonance levels have different energy efficiencies */
-    double resonance_factor = 1.0;
-    if (destination->resonance_level == NODE_PORTAL_TECHNICIAN) {
-        resonance_factor = 0.7; /* More efficient for portal-specific resonance */
-    } else if (destination->resonance_level == NODE_DIMENSIONAL_ANCHOR) {
-        resonance_factor = 0.8; /* More efficient for dimensional anchors */
+            return 3.0;
     }
-    
-    /* Calculate final energy cost */
-    double energy_cost = base_cost * distance_factor * method_factor * speed_cost * resonance_factor;
-    
-    return energy_cost;
+    return 1.0;
 }
 
 /**
- * @brief Calculate teleportation duration
+ * @brief Duration factor of a teleportation method
  */
-static double calculate_duration(BlinkSpotTarget *source, BlinkSpotTarget *destination, 
-                             TeleportMethod method, double speed_factor) {
-    /* Base duration for teleportation (in seconds) */
-    double base_duration = 3.0;
-    
-    /* Calculate distance factor */
-    double distance_km = 0.0;
-    if (source) {
-        distance_km = calculate_distance(source->latitude, source->longitude,
-                                       destination->latitude, destination->longitude);
-    } else {
-        /* Assume a default distance if source is not provided */
-        distance_km = 1000.0;
-    }
-    
-    /* Distance factor: Duration increases with logarithm of distance */
-    double distance_factor = log10(distance_km + 1.0) / 3.0;
-    if (distance_factor < 0.1) distance_factor = 0.1;
-    
-    /* Method factor: Different methods have different durations */
-    double method_factor = 1.0;
+static double method_duration_factor(TeleportMethod method) {
     switch (method) {
         case TELEPORT_STANDARD:
-            method_factor = 1.0;
-            break;
+            return 1.0;
         case TELEPORT_INSTANT:
-            method_factor = 0.1;
-            break;
+            return 0.1;
         case TELEPORT_SEQUENTIAL:
-            method_factor = 2.0;
-            break;
+            return 2.0;
         case TELEPORT_PARALLEL:
-            method_factor = 0.5;
-            break;
+            return 0.5;
         case TELEPORT_TEMPORAL:
-            method_factor = 1.5;
-            break;
+            return 1.5;
+    }
+    return 1.0;
+}
+
+/* Smallest resonance factor, bounding how far a given energy can reach */
+#define MIN_RESONANCE_FACTOR 0.7
+
+/**
+ * @brief Energy efficiency of a destination's resonance level
+ */
+static double resonance_energy_factor(NodeLevel resonance_level) {
+    if (resonance_level == NODE_PORTAL_TECHNICIAN) {
+        return 0.7; /* More efficient for portal-specific resonance */
+    } else if (resonance_level == NODE_DIMENSIONAL_ANCHOR) {
+        return 0.8; /* More efficient for dimensional anchors */
     }
+    return 1.0;
+}
+
+/**
+ * @brief Energy cost of a leg to a destination
+ */
+static double leg_energy(const TeleportLeg *leg, const BlinkSpotTarget *destination,
+                         TeleportMethod method, double speed_factor) {
+    /* Base energy cost for teleportation */
+    double base_cost = 100.0;
+    
+    /* Speed factor: Higher speed costs more energy */
+    double speed_cost = speed_factor * speed_factor;
+    
+    return base_cost * leg->energy_factor * method_energy_factor(method) * speed_cost *
+           resonance_energy_factor(destination->resonance_level);
+}
+
+/**
+ * @brief Duration of a leg
+ */
+static double leg_duration(const TeleportLeg *leg, TeleportMethod method, double speed_factor) {
+    /* Base duration for teleportation (in seconds) */
+    double base_duration = 3.0;
     
     /* Speed factor: Higher speed reduces duration */
     double speed_effect = 1.0 / speed_factor;
     
-    /* Calculate final duration */
-    double duration = base_duration * distance_factor * method_factor * speed_effect;
+    double duration = base_duration * leg->duration_factor * method_duration_factor(method) * speed_effect;
     
     /* Ensure minimum duration */
     if (duration < 0.1) duration = 0.1;
@@ -218,6 +357,189 @@ static double calculate_duration(BlinkSpotTarget *source, BlinkSpotTarget *desti
     return duration;
 }
 
+/**
+ * @brief Leg between two blink spots, or from the current location when source is NULL
+ */
+static TeleportLeg spot_leg(const BlinkSpotTarget *source, const BlinkSpotTarget *destination) {
+    if (!source) {
+        /* The current location is unknown; assume a default distance */
+        return default_leg;
+    }
+    return make_leg(calculate_distance(source->latitude, source->longitude,
+                                       destination->latitude, destination->longitude));
+}
+
+/* Slots in the favorites cost cache (a power of two); it fills to half */
+#define COST_CACHE_CAPACITY 4096
+
+/**
+ * @brief Cached leg between two blink spots, keyed by the ordered ID pair
+ */
+typedef struct {
+    uint64_t low_id;             /* Smaller ID (0 marks an empty slot) */
+    uint64_t high_id;            /* Larger ID */
+    TeleportLeg leg;
+} CostCacheEntry;
+
+static CostCacheEntry *cost_cache = NULL;
+static uint32_t cost_cache_count = 0;
+static uint64_t cost_cache_hits = 0;
+static uint64_t cost_cache_misses = 0;
+
+/**
+ * @brief Home slot of an ID pair in the cost cache
+ */
+static uint32_t cost_cache_bucket(uint64_t low_id, uint64_t high_id) {
+    uint64_t hash = (low_id * 0x9E3779B97F4A7C15ULL) ^ (high_id + 0x632BE59BD9B4E019ULL);
+    hash ^= hash >> 29;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    hash ^= hash >> 32;
+    return (uint32_t)hash & (COST_CACHE_CAPACITY - 1);
+}
+
+/**
+ * @brief Cache slot holding an ID pair, or the empty slot where it would go
+ */
+static CostCacheEntry *cost_cache_slot(uint64_t low_id, uint64_t high_id) {
+    uint32_t bucket = cost_cache_bucket(low_id, high_id);
+    while (cost_cache[bucket].low_id != 0 &&
+           (cost_cache[bucket].low_id != low_id || cost_cache[bucket].high_id != high_id)) {
+        bucket = (bucket + 1) & (COST_CACHE_CAPACITY - 1);
+    }
+    return &cost_cache[bucket];
+}
+
+/**
+ * @brief Look up the cached leg between two blink spots
+ */
+static bool cost_cache_get(uint64_t a, uint64_t b, TeleportLeg *leg) {
+    if (!cost_cache || cost_cache_count == 0) {
+        return false;
+    }
+    CostCacheEntry *entry = cost_cache_slot(a < b ? a : b, a < b ? b : a);
+    if (entry->low_id == 0) {
+        return false;
+    }
+    *leg = entry->leg;
+    return true;
+}
+
+/**
+ * @brief Remember the leg between two blink spots while there is room
+ */
+static void cost_cache_put(uint64_t a, uint64_t b, const TeleportLeg *leg) {
+    if (!cost_cache) {
+        cost_cache = (CostCacheEntry *)calloc(COST_CACHE_CAPACITY, sizeof(CostCacheEntry));
+        if (!cost_cache) {
+            return;
+        }
+    }
+    if (cost_cache_count >= COST_CACHE_CAPACITY / 2) {
+        return;
+    }
+    CostCacheEntry *entry = cost_cache_slot(a < b ? a : b, a < b ? b : a);
+    if (entry->low_id == 0) {
+        entry->low_id = a < b ? a : b;
+        entry->high_id = a < b ? b : a;
+        cost_cache_count++;
+    }
+    entry->leg = *leg;
+}
+
+/**
+ * @brief Drop every cached leg touching a blink spot
+ */
+static void cost_cache_invalidate(uint64_t id) {
+    if (!cost_cache || cost_cache_count == 0) {
+        return;
+    }
+    /* Collect the survivors and reinsert them so no probe chain is broken */
+    CostCacheEntry *kept = (CostCacheEntry *)malloc(sizeof(CostCacheEntry) * cost_cache_count);
+    uint32_t kept_count = 0;
+    for (uint32_t i = 0; kept && i < COST_CACHE_CAPACITY; i++) {
+        if (cost_cache[i].low_id != 0 && cost_cache[i].low_id != id && cost_cache[i].high_id != id) {
+            kept[kept_count++] = cost_cache[i];
+        }
+    }
+    memset(cost_cache, 0, sizeof(CostCacheEntry) * COST_CACHE_CAPACITY);
+    cost_cache_count = 0;
+    for (uint32_t i = 0; i < kept_count; i++) {
+        cost_cache_put(kept[i].low_id, kept[i].high_id, &kept[i].leg);
+    }
+    free(kept);
+}
+
+/**
+ * @brief Great-circle distances from a point to a batch of blink spots
+ *
+ * Works from the unit vectors in the coordinate copy: the squared chord
+ * for every spot first, in a loop the compiler vectorizes, then the
+ * distance as 2R * asin(chord / 2), which is the haversine distance.
+ */
+static void batch_distances(const double *origin, const uint32_t *slots, uint32_t count,
+                            double *distances) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t slot = slots ? slots[i] : i;
+        double dx = spot_x[slot] - origin[0];
+        double dy = spot_y[slot] - origin[1];
+        double dz = spot_z[slot] - origin[2];
+        distances[i] = dx * dx + dy * dy + dz * dz;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        double half_chord = sqrt(distances[i]) / 2.0;
+        distances[i] = 2.0 * EARTH_RADIUS_KM * asin(half_chord < 1.0 ? half_chord : 1.0);
+    }
+}
+
+/**
+ * @brief Legs from one blink spot to a batch of others
+ *
+ * Pairs touching a favorite come from the cost cache when they can;
+ * the rest are measured in one batch, and those touching a favorite
+ * are remembered. The index must be fresh.
+ */
+static bool batch_legs(uint32_t source_slot, const uint32_t *slots, uint32_t count, TeleportLeg *legs) {
+    uint32_t *pending = (uint32_t *)malloc(sizeof(uint32_t) * (count ? count : 1));
+    uint32_t *pending_slots = (uint32_t *)malloc(sizeof(uint32_t) * (count ? count : 1));
+    double *distances = (double *)malloc(sizeof(double) * (count ? count : 1));
+    if (!pending || !pending_slots || !distances) {
+        free(pending);
+        free(pending_slots);
+        free(distances);
+        return false;
+    }
+    
+    const BlinkSpotTarget *source = blink_spots[source_slot];
+    uint32_t pending_count = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t slot = slots ? slots[i] : i;
+        const BlinkSpotTarget *target = blink_spots[slot];
+        if ((source->is_favorite || target->is_favorite) && cost_cache_get(source->id, target->id, &legs[i])) {
+            cost_cache_hits++;
+            continue;
+        }
+        pending[pending_count] = i;
+        pending_slots[pending_count] = slot;
+        pending_count++;
+    }
+    
+    double origin[3] = { spot_x[source_slot], spot_y[source_slot], spot_z[source_slot] };
+    batch_distances(origin, pending_slots, pending_count, distances);
+    for (uint32_t i = 0; i < pending_count; i++) {
+        const BlinkSpotTarget *target = blink_spots[pending_slots[i]];
+        legs[pending[i]] = make_leg(distances[i]);
+        if (source->is_favorite || target->is_favorite) {
+            cost_cache_misses++;
+            cost_cache_put(source->id, target->id, &legs[pending[i]]);
+        }
+    }
+    
+    free(pending);
+    free(pending_slots);
+    free(distances);
+    return true;
+}
+
 /**
  * @brief Initialize the quantum teleportation system
  */
@@ -251,9 +573,15 @@ bool qteleport_init(void *qopu) {
     printf("%s\n", result);
     free(result);
     
-    /* Initialize the blink spot array */
+    /* Initialize the blink spot catalog and its index */
+    blink_index = bindex_create();
+    if (!blink_index) {
+        return false;
+    }
     blink_spot_count = 0;
-    memset(blink_spots, 0, sizeof(blink_spots));
+    blink_index_stale = true;
+    next_blink_spot_id = (uint64_t)time(NULL); /* Unique IDs starting from the time */
+    default_leg = make_leg(1000.0);
     
     /* Initialize the last result */
     memset(&last_result, 0, sizeof(last_result));
@@ -268,33 +596,17 @@ bool qteleport_init(void *qopu) {
 BlinkSpotTarget *qteleport_create_blink_spot(const char *name, const char *description,
                                           double latitude, double longitude, double altitude,
                                           NodeLevel resonance_level) {
-    if (!initialized || blink_spot_count >= MAX_BLINK_SPOTS) {
+    if (!initialized) {
         return NULL;
     }
     
-    /* Create a new blink spot target */
-    BlinkSpotTarget *target = (BlinkSpotTarget *)malloc(sizeof(BlinkSpotTarget));
+    /* Create the target and add it to the catalog */
+    BlinkSpotTarget *target = add_blink_spot(name, description, latitude, longitude, altitude,
+                                             resonance_level);
     if (!target) {
         return NULL;
     }
     
-    /* Initialize the target */
-    target->id = (uint64_t)time(NULL) + blink_spot_count; /* Unique ID based on time */
-    target->name = strdup(name);
-    target->description = strdup(description);
-    target->latitude = latitude;
-    target->longitude = longitude;
-    target->altitude = altitude;
-    target->creation_time = time(NULL);
-    target->resonance_level = resonance_level;
-    target->satellite_imagery = NULL;
-    target->imagery_size = 0;
-    target->is_favorite = false;
-    target->stability = 0.95; /* Initial stability */
-    
-    /* Add to the blink spots array */
-    blink_spots[blink_spot_count++] = target;
-    
     /* Create via script */
     char lat_str[32], lon_str[32], alt_str[32];
     sprintf(lat_str, "%f", latitude);
@@ -358,77 +670,478 @@ BlinkSpotTarget **qteleport_find_blink_spots(const char *search_term,
         return NULL;
     }
     
-    /* Count matching blink spots */
+    bool by_term = search_term && strlen(search_term) > 0;
+    bool by_location = near_latitude != 0.0 && near_longitude != 0.0 && radius_km > 0.0;
+    
+    /* Narrow to the candidates the index allows, or check every spot */
+    uint32_t *candidates = NULL;
+    uint32_t candidate_count = blink_spot_count;
+    bool narrowed = false;
+    if ((by_term || by_location) && refresh_blink_index()) {
+        if (by_location) {
+            candidate_count = bindex_within(blink_index, near_latitude, near_longitude,
+                                            radius_km / EARTH_RADIUS_KM, &candidates);
+            narrowed = true;
+        }
+        uint32_t *term_candidates = NULL;
+        uint32_t term_count = 0;
+        if (by_term && (!narrowed || candidate_count > 0) &&
+            bindex_text_candidates(blink_index, search_term, &term_candidates, &term_count)) {
+            if (!narrowed || term_count < candidate_count) {
+                free(candidates);
+                candidates = term_candidates;
+                candidate_count = term_count;
+                narrowed = true;
+            } else {
+                free(term_candidates);
+            }
+        }
+    }
+    
+    /* Allocate result array */
+    BlinkSpotTarget **results = (BlinkSpotTarget **)malloc(sizeof(BlinkSpotTarget *) *
+                                                          (candidate_count ? candidate_count : 1));
+    if (!results) {
+        free(candidates);
+        *count = 0;
+        return NULL;
+    }
+    
+    /* Keep the candidates meeting every criterion, in catalog order */
     uint32_t matches = 0;
-    for (uint32_t i = 0; i < blink_spot_count; i++) {
-        bool matches_search = true;
-        bool matches_location = true;
-        bool matches_favorite = true;
+    for (uint32_t i = 0; i < candidate_count; i++) {
+        BlinkSpotTarget *spot = blink_spots[narrowed ? candidates[i] : i];
         
         /* Check search term */
-        if (search_term && strlen(search_term) > 0) {
-            matches_search = (strstr(blink_spots[i]->name, search_term) != NULL ||
-                             strstr(blink_spots[i]->description, search_term) != NULL);
+        if (by_term && !strstr(spot->name, search_term) && !strstr(spot->description, search_term)) {
+            continue;
         }
         
         /* Check location */
-        if (near_latitude != 0.0 && near_longitude != 0.0 && radius_km > 0.0) {
-            double distance = calculate_distance(near_latitude, near_longitude,
-                                               blink_spots[i]->latitude, blink_spots[i]->longitude);
-            matches_location = (distance <= radius_km);
+        if (by_location && calculate_distance(near_latitude, near_longitude,
+                                              spot->latitude, spot->longitude) > radius_km) {
+            continue;
         }
         
         /* Check favorite */
-        if (favorites_only) {
-            matches_favorite = blink_spots[i]->is_favorite;
+        if (favorites_only && !spot->is_favorite) {
+            continue;
         }
         
-        /* Count if all criteria match */
-        if (matches_search && matches_location && matches_favorite) {
+        results[matches++] = spot;
+    }
+    free(candidates);
+    
+    *count = matches;
+    return results;
+}
+
+/**
+ * @brief Blink spot paired with its distance from a query point
+ */
+typedef struct {
+    BlinkSpotTarget *spot;
+    double distance_km;
+} BlinkSpotDistance;
+
+/**
+ * @brief Order blink spots by ascending distance
+ */
+static int compare_spot_distance(const void *a, const void *b) {
+    double x = ((const BlinkSpotDistance *)a)->distance_km;
+    double y = ((const BlinkSpotDistance *)b)->distance_km;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Find the blink spots nearest a location
+ */
+BlinkSpotTarget **qteleport_find_nearest(double latitude, double longitude, uint32_t k,
+                                         uint32_t *count) {
+    if (!initialized || !count) {
+        return NULL;
+    }
+    *count = 0;
+    if (k == 0 || blink_spot_count == 0 || !refresh_blink_index()) {
+        return NULL;
+    }
+    if (k > blink_spot_count) {
+        k = blink_spot_count;
+    }
+    
+    uint32_t *slots = (uint32_t *)malloc(sizeof(uint32_t) * k);
+    BlinkSpotTarget **results = (BlinkSpotTarget **)malloc(sizeof(BlinkSpotTarget *) * k);
+    if (!slots || !results) {
+        free(slots);
+        free(results);
+        return NULL;
+    }
+    uint32_t found = bindex_nearest(blink_index, latitude, longitude, k, slots);
+    for (uint32_t i = 0; i < found; i++) {
+        results[i] = blink_spots[slots[i]];
+    }
+    free(slots);
+    
+    *count = found;
+    return results;
+}
+
+/**
+ * @brief Find the blink spots within a radius of a location
+ */
+BlinkSpotTarget **qteleport_find_within(double latitude, double longitude, double radius_km,
+                                        uint32_t *count) {
+    if (!initialized || !count) {
+        return NULL;
+    }
+    *count = 0;
+    if (radius_km < 0.0 || !refresh_blink_index()) {
+        return NULL;
+    }
+    
+    uint32_t *slots = NULL;
+    uint32_t candidate_count = bindex_within(blink_index, latitude, longitude,
+                                             radius_km / EARTH_RADIUS_KM, &slots);
+    BlinkSpotDistance *found = (BlinkSpotDistance *)malloc(sizeof(BlinkSpotDistance) *
+                                                           (candidate_count ? candidate_count : 1));
+    if (!found) {
+        free(slots);
+        return NULL;
+    }
+    
+    /* Exact distances only for the candidates */
+    uint32_t matches = 0;
+    for (uint32_t i = 0; i < candidate_count; i++) {
+        BlinkSpotTarget *spot = blink_spots[slots[i]];
+        double distance = calculate_distance(latitude, longitude, spot->latitude, spot->longitude);
+        if (distance <= radius_km) {
+            found[matches].spot = spot;
+            found[matches].distance_km = distance;
             matches++;
         }
     }
+    free(slots);
+    qsort(found, matches, sizeof(BlinkSpotDistance), compare_spot_distance);
     
-    /* Allocate result array */
-    BlinkSpotTarget **results = (BlinkSpotTarget **)malloc(sizeof(BlinkSpotTarget *) * matches);
+    BlinkSpotTarget **results = (BlinkSpotTarget **)malloc(sizeof(BlinkSpotTarget *) * (matches ? matches : 1));
     if (!results) {
-        *count = 0;
+        free(found);
         return NULL;
     }
+    for (uint32_t i = 0; i < matches; i++) {
+        results[i] = found[i].spot;
+    }
+    free(found);
     
-    /* Fill the results array */
-    uint32_t result_index = 0;
-    for (uint32_t i = 0; i < blink_spot_count; i++) {
-        bool matches_search = true;
-        bool matches_location = true;
-        bool matches_favorite = true;
-        
-        /* Check search term */
-        if (search_term && strlen(search_term) > 0) {
-            matches_search = (strstr(blink_spots[i]->name, search_term) != NULL ||
-                             strstr(blink_spots[i]->description, search_term) != NULL);
+    *count = matches;
+    return results;
+}
+
+/**
+ * @brief Load blink spots into the catalog in memory
+ */
+uint32_t qteleport_load_blink_spots(const BlinkSpotSpec *specs, uint32_t count) {
+    if (!initialized || !specs || !reserve_blink_spots(count)) {
+        return 0;
+    }
+    uint32_t loaded = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (add_blink_spot(specs[i].name, specs[i].description, specs[i].latitude, specs[i].longitude,
+                           specs[i].altitude, specs[i].resonance_level)) {
+            loaded++;
         }
-        
-        /* Check location */
-        if (near_latitude != 0.0 && near_longitude != 0.0 && radius_km > 0.0) {
-            double distance = calculate_distance(near_latitude, near_longitude,
-                                               blink_spots[i]->latitude, blink_spots[i]->longitude);
-            matches_location = (distance <= radius_km);
+    }
+    return loaded;
+}
+
+/**
+ * @brief Order candidates within the limit first, then by energy
+ */
+static int compare_candidates(const void *a, const void *b) {
+    const TeleportCandidate *x = (const TeleportCandidate *)a;
+    const TeleportCandidate *y = (const TeleportCandidate *)b;
+    if (x->within_limit != y->within_limit) {
+        return x->within_limit ? -1 : 1;
+    }
+    if (x->energy_cost != y->energy_cost) {
+        return x->energy_cost < y->energy_cost ? -1 : 1;
+    }
+    return (x->destination->id > y->destination->id) - (x->destination->id < y->destination->id);
+}
+
+/**
+ * @brief Score many teleport destinations in one call
+ */
+TeleportCandidate *qteleport_rank_destinations(uint64_t source_id, const uint64_t *target_ids,
+                                               uint32_t target_count, TeleportSettings settings,
+                                               uint32_t *count) {
+    if (!initialized || !count) {
+        return NULL;
+    }
+    *count = 0;
+    
+    uint32_t source_slot = 0;
+    bool from_spot = source_id != QTELEPORT_CURRENT_LOCATION;
+    if (from_spot && (!find_blink_spot_slot(source_id, &source_slot) || !refresh_blink_index())) {
+        return NULL;
+    }
+    
+    /* Resolve the destinations to catalog positions */
+    uint32_t capacity = target_ids ? target_count : blink_spot_count;
+    uint32_t *slots = (uint32_t *)malloc(sizeof(uint32_t) * (capacity ? capacity : 1));
+    TeleportLeg *legs = (TeleportLeg *)malloc(sizeof(TeleportLeg) * (capacity ? capacity : 1));
+    TeleportCandidate *candidates = (TeleportCandidate *)malloc(sizeof(TeleportCandidate) *
+                                                                (capacity ? capacity : 1));
+    if (!slots || !legs || !candidates) {
+        free(slots);
+        free(legs);
+        free(candidates);
+        return NULL;
+    }
+    uint32_t resolved = 0;
+    for (uint32_t i = 0; i < capacity; i++) {
+        uint32_t slot = i;
+        if (target_ids && !find_blink_spot_slot(target_ids[i], &slot)) {
+            continue;
         }
-        
-        /* Check favorite */
-        if (favorites_only) {
-            matches_favorite = blink_spots[i]->is_favorite;
+        if (!from_spot || slot != source_slot) {
+            slots[resolved++] = slot;
+        }
+    }
+    
+    /* Measure every leg in one batch (nothing to measure if none resolved) */
+    if (from_spot && resolved > 0) {
+        if (!batch_legs(source_slot, slots, resolved, legs)) {
+            free(slots);
+            free(legs);
+            free(candidates);
+            return NULL;
+        }
+    } else {
+        for (uint32_t i = 0; i < resolved; i++) {
+            legs[i] = default_leg;
+        }
+    }
+    
+    for (uint32_t i = 0; i < resolved; i++) {
+        TeleportCandidate *candidate = &candidates[i];
+        candidate->destination = blink_spots[slots[i]];
+        candidate->distance_km = legs[i].distance_km;
+        candidate->energy_cost = leg_energy(&legs[i], candidate->destination, settings.method,
+                                            settings.speed_factor);
+        candidate->duration = leg_duration(&legs[i], settings.method, settings.speed_factor);
+        candidate->within_limit = settings.energy_limit <= 0.0 ||
+                                  candidate->energy_cost <= settings.energy_limit;
+    }
+    free(slots);
+    free(legs);
+    qsort(candidates, resolved, sizeof(TeleportCandidate), compare_candidates);
+    
+    *count = resolved;
+    return candidates;
+}
+
+/* Route predecessor markers: no path yet, or the same as one hop fewer */
+#define ROUTE_VIA_NONE UINT32_MAX
+#define ROUTE_VIA_SAME (UINT32_MAX - 1)
+
+/**
+ * @brief Plan the cheapest route between two blink spots
+ *
+ * Bellman-Ford over hop counts: layer r holds the cheapest energy to
+ * each spot in at most r hops, relaxed only from the spots that got
+ * cheaper in layer r - 1. A spot's neighbors are the spots within the
+ * distance that the energy still to spare could cover, found through
+ * the index, so each layer touches a small part of the catalog.
+ *
+ * Square root being subadditive, no route from a spot to the destination
+ * costs less than one hop's energy over the great-circle distance to it
+ * at the most efficient resonance; spots that cannot beat the best route
+ * even so are not expanded.
+ */
+bool qteleport_plan_route(uint64_t source_id, uint64_t destination_id, uint32_t max_hops,
+                          TeleportSettings settings, TeleportRoute *route) {
+    if (!initialized || !route) {
+        return false;
+    }
+    memset(route, 0, sizeof(*route));
+    
+    uint32_t source_slot = 0, destination_slot = 0;
+    if (max_hops == 0 || max_hops > QTELEPORT_MAX_ROUTE_HOPS || source_id == destination_id ||
+        !find_blink_spot_slot(source_id, &source_slot) ||
+        !find_blink_spot_slot(destination_id, &destination_slot) || !refresh_blink_index()) {
+        return false;
+    }
+    
+    uint32_t n = blink_spot_count;
+    size_t cells = (size_t)(max_hops + 1) * n;
+    double *energy = (double *)malloc(sizeof(double) * cells);
+    uint32_t *via = (uint32_t *)malloc(sizeof(uint32_t) * cells);
+    uint32_t *frontier = (uint32_t *)malloc(sizeof(uint32_t) * n);
+    uint32_t *next = (uint32_t *)malloc(sizeof(uint32_t) * n);
+    uint32_t *queued = (uint32_t *)calloc(n, sizeof(uint32_t));
+    double *remaining = (double *)malloc(sizeof(double) * n);
+    bool planned = energy && via && frontier && next && queued && remaining;
+    
+    /* Energy per square root kilometer on the most efficient destination */
+    double reach_cost = 100.0 / 10.0 * method_energy_factor(settings.method) *
+                        settings.speed_factor * settings.speed_factor * MIN_RESONANCE_FACTOR;
+    
+    uint32_t rounds = 0;
+    if (planned) {
+        /* Least energy still needed from each spot, shaved against rounding */
+        double goal[3] = { spot_x[destination_slot], spot_y[destination_slot], spot_z[destination_slot] };
+        batch_distances(goal, NULL, n, remaining);
+        for (uint32_t i = 0; i < n; i++) {
+            remaining[i] = reach_cost * sqrt(remaining[i]) * (1.0 - 1e-9);
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            energy[i] = HUGE_VAL;
+            via[i] = ROUTE_VIA_NONE;
+        }
+        energy[source_slot] = 0.0;
+        frontier[0] = source_slot;
+    }
+    uint32_t frontier_count = planned ? 1 : 0;
+    
+    for (uint32_t r = 1; planned && r <= max_hops && frontier_count > 0; r++) {
+        const double *previous = &energy[(size_t)(r - 1) * n];
+        double *current = &energy[(size_t)r * n];
+        uint32_t *current_via = &via[(size_t)r * n];
+        memcpy(current, previous, sizeof(double) * n);
+        for (uint32_t i = 0; i < n; i++) {
+            current_via[i] = ROUTE_VIA_SAME;
         }
         
-        /* Add to results if all criteria match */
-        if (matches_search && matches_location && matches_favorite) {
-            results[result_index++] = blink_spots[i];
+        uint32_t next_count = 0;
+        for (uint32_t f = 0; planned && f < frontier_count; f++) {
+            uint32_t from = frontier[f];
+            if (from == destination_slot || previous[from] + remaining[from] >= current[destination_slot]) {
+                continue;
+            }
+            
+            /* Only hops that could still beat the best route so far are worth trying */
+            double spare = current[destination_slot] - previous[from];
+            if (settings.energy_limit > 0.0 && !(spare <= settings.energy_limit)) {
+                spare = settings.energy_limit;
+            }
+            if (spare <= 0.0) {
+                continue;
+            }
+            double radius = 2.0 * M_PI;
+            if (isfinite(spare) && reach_cost > 0.0) {
+                double reach_km = (spare / reach_cost) * (spare / reach_cost);
+                radius = reach_km / EARTH_RADIUS_KM;
+            }
+            
+            uint32_t *slots = NULL;
+            uint32_t slot_count = bindex_within(blink_index, blink_spots[from]->latitude,
+                                                blink_spots[from]->longitude, radius, &slots);
+            TeleportLeg *legs = (TeleportLeg *)malloc(sizeof(TeleportLeg) * (slot_count ? slot_count : 1));
+            if (!legs || !batch_legs(from, slots, slot_count, legs)) {
+                planned = false;
+            }
+            for (uint32_t j = 0; planned && j < slot_count; j++) {
+                uint32_t to = slots[j];
+                if (to == from || to == source_slot) {
+                    continue;
+                }
+                double hop = leg_energy(&legs[j], blink_spots[to], settings.method, settings.speed_factor);
+                if (settings.energy_limit > 0.0 && hop > settings.energy_limit) {
+                    continue;
+                }
+                if (previous[from] + hop < current[to]) {
+                    current[to] = previous[from] + hop;
+                    current_via[to] = from;
+                    if (queued[to] != r) {
+                        queued[to] = r;
+                        next[next_count++] = to;
+                    }
+                }
+            }
+            free(legs);
+            free(slots);
         }
+        
+        uint32_t *swap = frontier;
+        frontier = next;
+        next = swap;
+        frontier_count = next_count;
+        rounds = r;
     }
     
-    *count = matches;
-    return results;
+    /* Walk the predecessors back from the destination */
+    uint32_t path[QTELEPORT_MAX_ROUTE_HOPS];
+    uint32_t hop_count = 0;
+    if (planned && isfinite(energy[(size_t)rounds * n + destination_slot])) {
+        uint32_t r = rounds;
+        uint32_t at = destination_slot;
+        while (at != source_slot && r > 0) {
+            uint32_t from = via[(size_t)r * n + at];
+            if (from != ROUTE_VIA_SAME) {
+                path[hop_count++] = at;
+                at = from;
+            }
+            r--;
+        }
+        planned = at == source_slot && hop_count > 0;
+    } else {
+        planned = false;
+    }
+    free(energy);
+    free(via);
+    free(frontier);
+    free(next);
+    free(queued);
+    free(remaining);
+    
+    if (planned) {
+        route->hops = (BlinkSpotTarget **)malloc(sizeof(BlinkSpotTarget *) * hop_count);
+        planned = route->hops != NULL;
+    }
+    for (uint32_t i = 0; planned && i < hop_count; i++) {
+        uint32_t from = i == 0 ? source_slot : path[hop_count - i];
+        uint32_t to = path[hop_count - 1 - i];
+        TeleportLeg leg;
+        if (!batch_legs(from, &to, 1, &leg)) {
+            planned = false;
+            break;
+        }
+        route->hops[i] = blink_spots[to];
+        route->energy_cost += leg_energy(&leg, blink_spots[to], settings.method, settings.speed_factor);
+        route->duration += leg_duration(&leg, settings.method, settings.speed_factor);
+        route->distance_km += leg.distance_km;
+    }
+    if (!planned) {
+        qteleport_free_route(route);
+        return false;
+    }
+    route->hop_count = hop_count;
+    return true;
+}
+
+/**
+ * @brief Free the hops of a planned route
+ */
+void qteleport_free_route(TeleportRoute *route) {
+    if (!route) {
+        return;
+    }
+    free(route->hops);
+    memset(route, 0, sizeof(*route));
+}
+
+/**
+ * @brief Get the planner cost cache statistics
+ */
+bool qteleport_get_planner_stats(TeleportPlannerStats *stats) {
+    if (!initialized || !stats) {
+        return false;
+    }
+    stats->cache_hits = cost_cache_hits;
+    stats->cache_misses = cost_cache_misses;
+    stats->cached_pairs = cost_cache_count;
+    return true;
 }
 
 /**
@@ -458,8 +1171,9 @@ TeleportResult qteleport_to_blink_spot(uint64_t target_id, TeleportSettings sett
     result.destination = target;
     
     /* Calculate energy and duration */
-    result.energy_used = calculate_energy_cost(NULL, target, settings.method, settings.speed_factor);
-    result.duration = calculate_duration(NULL, target, settings.method, settings.speed_factor);
+    TeleportLeg leg = spot_leg(NULL, target);
+    result.energy_used = leg_energy(&leg, target, settings.method, settings.speed_factor);
+    result.duration = leg_duration(&leg, settings.method, settings.speed_factor);
     
     /* Check energy limit */
     if (settings.energy_limit > 0.0 && result.energy_used > settings.energy_limit) {
@@ -473,8 +1187,11 @@ TeleportResult qteleport_to_blink_spot(uint64_t target_id, TeleportSettings sett
     char id_str[32];
     sprintf(id_str, "%lu", target_id % blink_spot_count); /* Convert to script's index */
     
+    /* Synchronous teleports are traced with handle 0 */
     const char *args[] = {id_str, NULL};
+    TRACE_EVENT(TRACE_TELEPORT_PHASE, TRACE_PHASE_BEGIN, 0, TELEPORT_STATUS_EXECUTING);
     char *script_result = execute_teleport_script("teleport_to_blink_spot", args);
+    TRACE_EVENT(TRACE_TELEPORT_PHASE, TRACE_PHASE_END, 0, TELEPORT_STATUS_EXECUTING);
     
     if (!script_result) {
         result.success = false;
@@ -517,7 +1234,9 @@ TeleportResult qteleport_to_blink_spot(uint64_t target_id, TeleportSettings sett
     /* Simulate teleportation time based on duration */
     if (result.duration > 0.1) {
         printf("Teleporting to %s in %.1f seconds...\n", target->name, result.duration);
+        TRACE_EVENT(TRACE_TELEPORT_PHASE, TRACE_PHASE_BEGIN, 0, TELEPORT_STATUS_IN_TRANSIT);
         sleep((unsigned int)result.duration);
+        TRACE_EVENT(TRACE_TELEPORT_PHASE, TRACE_PHASE_END, 0, TELEPORT_STATUS_IN_TRANSIT);
     }
     
     printf("Teleportation to %s complete! Energy used: %.1f units\n", 
@@ -558,6 +1277,399 @@ TeleportResult qteleport_to_coordinates(double latitude, double longitude,
     return result;
 }
 
+/**
+ * @brief Asynchronous teleport in flight
+ */
+typedef struct {
+    uint64_t handle;             /* 0 marks a free slot */
+    uint64_t order;              /* Submission order; each stage takes the oldest first */
+    TeleportStatus status;       /* QUEUED, EXECUTING or IN_TRANSIT */
+    bool cancelled;              /* Cancel requested while executing or in transit */
+    bool arriving;               /* The transit stage is waiting out this request */
+    char script_index[32];       /* Script's index for the target */
+    TeleportCompletion completion; /* Costs from submission, outcome filled on finish */
+} AsyncTeleport;
+
+/* Asynchronous teleport state; one lock and one condition for every stage */
+static pthread_mutex_t async_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t async_changed = PTHREAD_COND_INITIALIZER;
+static AsyncTeleport async_requests[QTELEPORT_MAX_IN_FLIGHT];
+static TeleportCompletion async_history[QTELEPORT_COMPLETION_HISTORY];
+static uint32_t async_history_next = 0;
+static uint64_t next_async_handle = 1;
+static uint64_t next_async_order = 0;
+static pthread_t async_script_thread;
+static pthread_t async_transit_thread;
+static bool async_running = false;
+static bool async_stopping = false;
+static pthread_mutex_t async_bus_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool async_bus_joined = false;      /* Registered QCOMP_TELEPORT on the bus */
+
+/**
+ * @brief Broadcast a finished teleport on the message bus
+ */
+static void publish_completion(const TeleportCompletion *completion) {
+    /* Join the bus on first use, since it may start after the teleport system */
+    pthread_mutex_lock(&async_bus_lock);
+    QComponentInfo info;
+    bool joined = qbus_find_component(QCOMP_TELEPORT, &info);
+    if (!joined) {
+        memset(&info, 0, sizeof(info));
+        info.id = QCOMP_TELEPORT;
+        snprintf(info.name, sizeof(info.name), "Quantum Teleportation System");
+        info.resonance_level = NODE_PORTAL_TECHNICIAN;
+        joined = qbus_register_component(&info);
+        async_bus_joined = async_bus_joined || joined;
+    }
+    pthread_mutex_unlock(&async_bus_lock);
+    if (!joined) {
+        return;
+    }
+    
+    QMessage *message = qbus_create_message(QMSG_TELEPORT_COMPLETE, QCOMP_TELEPORT, 0,
+                                            completion, sizeof(TeleportCompletion),
+                                            QMSG_PRIORITY_NORMAL, false);
+    if (message) {
+        qbus_send_message(message);
+        qbus_free_message(message);
+    }
+}
+
+/**
+ * @brief Record a request's outcome and free its slot
+ *
+ * Caller must hold the async lock, and publishes the copy left in
+ * done once it has released the lock.
+ */
+static void finish_async_locked(AsyncTeleport *request, TeleportStatus status, const char *error,
+                                TeleportCompletion *done) {
+    request->completion.status = status;
+    snprintf(request->completion.error_message, sizeof(request->completion.error_message), "%s",
+             error ? error : "");
+    *done = request->completion;
+    async_history[async_history_next] = request->completion;
+    async_history_next = (async_history_next + 1) % QTELEPORT_COMPLETION_HISTORY;
+    memset(request, 0, sizeof(*request));
+    pthread_cond_broadcast(&async_changed);
+}
+
+/**
+ * @brief In-flight request by handle
+ *
+ * Caller must hold the async lock.
+ */
+static AsyncTeleport *find_async_locked(uint64_t handle) {
+    for (uint32_t i = 0; handle != 0 && i < QTELEPORT_MAX_IN_FLIGHT; i++) {
+        if (async_requests[i].handle == handle) {
+            return &async_requests[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Oldest request waiting for a stage
+ *
+ * Caller must hold the async lock.
+ */
+static AsyncTeleport *oldest_async_locked(TeleportStatus status) {
+    AsyncTeleport *oldest = NULL;
+    for (uint32_t i = 0; i < QTELEPORT_MAX_IN_FLIGHT; i++) {
+        AsyncTeleport *request = &async_requests[i];
+        if (request->handle != 0 && request->status == status && !request->arriving &&
+            (!oldest || request->order < oldest->order)) {
+            oldest = request;
+        }
+    }
+    return oldest;
+}
+
+/**
+ * @brief Script stage: runs the teleport script for one request at a time
+ */
+static void *async_script_stage(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&async_lock);
+    while (true) {
+        AsyncTeleport *request = oldest_async_locked(TELEPORT_STATUS_QUEUED);
+        if (!request) {
+            if (async_stopping) {
+                break;
+            }
+            pthread_cond_wait(&async_changed, &async_lock);
+            continue;
+        }
+        
+        /* Only this stage finishes executing requests, so the slot stays ours */
+        request->status = TELEPORT_STATUS_EXECUTING;
+        pthread_cond_broadcast(&async_changed);
+        char script_index[sizeof(request->script_index)];
+        memcpy(script_index, request->script_index, sizeof(script_index));
+        uint64_t handle = request->handle;
+        pthread_mutex_unlock(&async_lock);
+        
+        TRACE_EVENT(TRACE_TELEPORT_PHASE, TRACE_PHASE_BEGIN, handle, TELEPORT_STATUS_EXECUTING);
+        const char *args[] = {script_index, NULL};
+        char *script_result = execute_teleport_script("teleport_to_blink_spot", args);
+        free(script_result);
+        TRACE_EVENT(TRACE_TELEPORT_PHASE, TRACE_PHASE_END, handle, TELEPORT_STATUS_EXECUTING);
+        
+        pthread_mutex_lock(&async_lock);
+        TeleportCompletion done;
+        if (!script_result) {
+            finish_async_locked(request, TELEPORT_STATUS_FAILED, "Teleportation script execution failed", &done);
+        } else if (request->cancelled) {
+            finish_async_locked(request, TELEPORT_STATUS_CANCELLED, "Teleportation cancelled", &done);
+        } else {
+            request->status = TELEPORT_STATUS_IN_TRANSIT;
+            pthread_cond_broadcast(&async_changed);
+            continue;
+        }
+        pthread_mutex_unlock(&async_lock);
+        publish_completion(&done);
+        pthread_mutex_lock(&async_lock);
+    }
+    pthread_mutex_unlock(&async_lock);
+    return NULL;
+}
+
+/**
+ * @brief Whether any request is in flight
+ *
+ * Caller must hold the async lock.
+ */
+static bool async_busy_locked(void) {
+    for (uint32_t i = 0; i < QTELEPORT_MAX_IN_FLIGHT; i++) {
+        if (async_requests[i].handle != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Transit stage: waits out each teleport's duration in turn
+ */
+static void *async_transit_stage(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&async_lock);
+    while (true) {
+        AsyncTeleport *request = oldest_async_locked(TELEPORT_STATUS_IN_TRANSIT);
+        if (!request) {
+            if (async_stopping && !async_busy_locked()) {
+                break;
+            }
+            pthread_cond_wait(&async_changed, &async_lock);
+            continue;
+        }
+        
+        /* Wait until arrival, waking early if cancelled */
+        request->arriving = true;
+        uint64_t handle = request->handle;
+        TRACE_EVENT(TRACE_TELEPORT_PHASE, TRACE_PHASE_BEGIN, handle, TELEPORT_STATUS_IN_TRANSIT);
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        double whole = floor(request->completion.duration);
+        deadline.tv_sec += (time_t)whole;
+        deadline.tv_nsec += (long)((request->completion.duration - whole) * 1e9);
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        while (!request->cancelled &&
+               pthread_cond_timedwait(&async_changed, &async_lock, &deadline) != ETIMEDOUT) {
+        }
+        
+        TeleportCompletion done;
+        if (request->cancelled) {
+            finish_async_locked(request, TELEPORT_STATUS_CANCELLED, "Teleportation cancelled", &done);
+        } else {
+            finish_async_locked(request, TELEPORT_STATUS_COMPLETED, NULL, &done);
+        }
+        TRACE_EVENT(TRACE_TELEPORT_PHASE, TRACE_PHASE_END, handle, done.status);
+        pthread_mutex_unlock(&async_lock);
+        publish_completion(&done);
+        pthread_mutex_lock(&async_lock);
+    }
+    pthread_mutex_unlock(&async_lock);
+    return NULL;
+}
+
+/**
+ * @brief Start the background stages on first use
+ *
+ * Caller must hold the async lock.
+ */
+static bool start_async_stages_locked(void) {
+    if (async_running) {
+        return true;
+    }
+    async_stopping = false;
+    if (pthread_create(&async_script_thread, NULL, async_script_stage, NULL) != 0) {
+        return false;
+    }
+    if (pthread_create(&async_transit_thread, NULL, async_transit_stage, NULL) != 0) {
+        async_stopping = true;
+        pthread_cond_broadcast(&async_changed);
+        pthread_mutex_unlock(&async_lock);
+        pthread_join(async_script_thread, NULL);
+        pthread_mutex_lock(&async_lock);
+        return false;
+    }
+    async_running = true;
+    return true;
+}
+
+/**
+ * @brief Cancel everything in flight and stop the background stages
+ */
+static void stop_async_stages(void) {
+    pthread_mutex_lock(&async_lock);
+    if (!async_running) {
+        pthread_mutex_unlock(&async_lock);
+        return;
+    }
+    async_stopping = true;
+    for (uint32_t i = 0; i < QTELEPORT_MAX_IN_FLIGHT; i++) {
+        AsyncTeleport *request = &async_requests[i];
+        if (request->handle == 0) {
+            continue;
+        }
+        if (request->status == TELEPORT_STATUS_QUEUED) {
+            TeleportCompletion done;
+            finish_async_locked(request, TELEPORT_STATUS_CANCELLED, "Teleportation system shut down", &done);
+            pthread_mutex_unlock(&async_lock);
+            publish_completion(&done);
+            pthread_mutex_lock(&async_lock);
+        } else {
+            request->cancelled = true;
+        }
+    }
+    pthread_cond_broadcast(&async_changed);
+    pthread_mutex_unlock(&async_lock);
+    
+    pthread_join(async_script_thread, NULL);
+    pthread_join(async_transit_thread, NULL);
+    
+    pthread_mutex_lock(&async_lock);
+    async_running = false;
+    memset(async_history, 0, sizeof(async_history));
+    async_history_next = 0;
+    pthread_mutex_unlock(&async_lock);
+    
+    pthread_mutex_lock(&async_bus_lock);
+    if (async_bus_joined) {
+        qbus_unregister_component(QCOMP_TELEPORT);
+        async_bus_joined = false;
+    }
+    pthread_mutex_unlock(&async_bus_lock);
+}
+
+/**
+ * @brief Submit a teleport to a blink spot without waiting for it
+ */
+uint64_t qteleport_submit(uint64_t target_id, TeleportSettings settings) {
+    if (!initialized) {
+        return 0;
+    }
+    
+    /* Validate and cost here, where the catalog may be read */
+    TeleportCompletion completion = {0};
+    completion.target_id = target_id;
+    const char *error = NULL;
+    char script_index[32] = {0};
+    BlinkSpotTarget *target = find_blink_spot_by_id(target_id);
+    if (!target) {
+        error = "Invalid blink spot target ID";
+    } else {
+        TeleportLeg leg = spot_leg(NULL, target);
+        completion.energy_used = leg_energy(&leg, target, settings.method, settings.speed_factor);
+        completion.duration = leg_duration(&leg, settings.method, settings.speed_factor);
+        completion.stability = target->stability;
+        if (settings.energy_limit > 0.0 && completion.energy_used > settings.energy_limit) {
+            error = "Energy limit exceeded";
+        }
+        snprintf(script_index, sizeof(script_index), "%lu", target_id % blink_spot_count);
+    }
+    
+    pthread_mutex_lock(&async_lock);
+    AsyncTeleport *request = NULL;
+    for (uint32_t i = 0; !request && i < QTELEPORT_MAX_IN_FLIGHT; i++) {
+        if (async_requests[i].handle == 0) {
+            request = &async_requests[i];
+        }
+    }
+    if (!request || !start_async_stages_locked()) {
+        pthread_mutex_unlock(&async_lock);
+        return 0;
+    }
+    request->handle = next_async_handle++;
+    request->order = next_async_order++;
+    request->status = TELEPORT_STATUS_QUEUED;
+    memcpy(request->script_index, script_index, sizeof(script_index));
+    request->completion = completion;
+    request->completion.handle = request->handle;
+    uint64_t handle = request->handle;
+    
+    if (error) {
+        TeleportCompletion done;
+        finish_async_locked(request, TELEPORT_STATUS_FAILED, error, &done);
+        pthread_mutex_unlock(&async_lock);
+        publish_completion(&done);
+        return handle;
+    }
+    pthread_cond_broadcast(&async_changed);
+    pthread_mutex_unlock(&async_lock);
+    return handle;
+}
+
+/**
+ * @brief Cancel an asynchronous teleport
+ */
+bool qteleport_cancel(uint64_t handle) {
+    pthread_mutex_lock(&async_lock);
+    AsyncTeleport *request = find_async_locked(handle);
+    if (!request) {
+        pthread_mutex_unlock(&async_lock);
+        return false;
+    }
+    if (request->status == TELEPORT_STATUS_QUEUED) {
+        TeleportCompletion done;
+        finish_async_locked(request, TELEPORT_STATUS_CANCELLED, "Teleportation cancelled", &done);
+        pthread_mutex_unlock(&async_lock);
+        publish_completion(&done);
+        return true;
+    }
+    request->cancelled = true;
+    pthread_cond_broadcast(&async_changed);
+    pthread_mutex_unlock(&async_lock);
+    return true;
+}
+
+/**
+ * @brief Get the status of an asynchronous teleport
+ */
+TeleportStatus qteleport_get_status(uint64_t handle, TeleportCompletion *completion) {
+    TeleportStatus status = TELEPORT_STATUS_UNKNOWN;
+    pthread_mutex_lock(&async_lock);
+    AsyncTeleport *request = find_async_locked(handle);
+    if (request) {
+        status = request->status;
+    } else {
+        for (uint32_t i = 0; handle != 0 && i < QTELEPORT_COMPLETION_HISTORY; i++) {
+            if (async_history[i].handle == handle) {
+                status = async_history[i].status;
+                if (completion) {
+                    *completion = async_history[i];
+                }
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&async_lock);
+    return status;
+}
+
 /**
  * @brief Mark a blink spot as favorite
  */
@@ -572,8 +1684,11 @@ bool qteleport_set_favorite(uint64_t target_id, bool is_favorite) {
         return false;
     }
     
-    /* Update the favorite status */
+    /* Update the favorite status; unmarked spots stop being cached */
     target->is_favorite = is_favorite;
+    if (!is_favorite) {
+        cost_cache_invalidate(target_id);
+    }
     
     return true;
 }
@@ -597,12 +1712,14 @@ bool qteleport_update_blink_spot(uint64_t target_id, const char *name,
     if (name) {
         free(target->name);
         target->name = strdup(name);
+        blink_index_stale = true;
     }
     
     /* Update the description if provided */
     if (description) {
         free(target->description);
         target->description = strdup(description);
+        blink_index_stale = true;
     }
     
     /* Update the resonance level if provided */
@@ -610,6 +1727,9 @@ bool qteleport_update_blink_spot(uint64_t target_id, const char *name,
         target->resonance_level = (NodeLevel)resonance_level;
     }
     
+    /* Planned costs involving the spot are recomputed */
+    cost_cache_invalidate(target_id);
+    
     return true;
 }
 
@@ -642,9 +1762,6 @@ bool qteleport_delete_blink_spot(uint64_t target_id) {
     /* Free the target resources */
     free(target->name);
     free(target->description);
-    if (target->error_message) {
-        free(target->error_message);
-    }
     if (target->satellite_imagery) {
         free(target->satellite_imagery);
     }
@@ -656,6 +1773,8 @@ bool qteleport_delete_blink_spot(uint64_t target_id) {
     }
     
     blink_spot_count--;
+    blink_index_stale = true;
+    cost_cache_invalidate(target_id);
     
     return true;
 }
@@ -694,13 +1813,13 @@ bool qteleport_shutdown(void) {
         return false;
     }
     
+    /* Cancel asynchronous teleports and stop their stages */
+    stop_async_stages();
+    
     /* Free all blink spots */
     for (uint32_t i = 0; i < blink_spot_count; i++) {
         free(blink_spots[i]->name);
         free(blink_spots[i]->description);
-        if (blink_spots[i]->error_message) {
-            free(blink_spots[i]->error_message);
-        }
         if (blink_spots[i]->satellite_imagery) {
             free(blink_spots[i]->satellite_imagery);
         }
@@ -713,8 +1832,22 @@ bool qteleport_shutdown(void) {
     }
     
     /* Reset state */
+    free(blink_spots);
+    blink_spots = NULL;
     blink_spot_count = 0;
-    memset(blink_spots, 0, sizeof(blink_spots));
+    blink_spot_capacity = 0;
+    bindex_destroy(blink_index);
+    blink_index = NULL;
+    blink_index_stale = true;
+    free(spot_x);
+    free(spot_y);
+    free(spot_z);
+    spot_x = spot_y = spot_z = NULL;
+    free(cost_cache);
+    cost_cache = NULL;
+    cost_cache_count = 0;
+    cost_cache_hits = 0;
+    cost_cache_misses = 0;
     memset(&last_result, 0, sizeof(last_result));
     qopu_instance = NULL;
     initialized = false;
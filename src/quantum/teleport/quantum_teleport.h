@@ -86,6 +86,98 @@ typedef struct {
     bool auto_stabilize;         /**< Whether to auto-stabilize after teleport */
 } TeleportSettings;
 
+/**
+ * @brief Blink spot to load into the catalog
+ */
+typedef struct {
+    const char *name;            /**< Location name */
+    const char *description;     /**< Location description (NULL for none) */
+    double latitude;             /**< Latitude */
+    double longitude;            /**< Longitude */
+    double altitude;             /**< Altitude in meters */
+    NodeLevel resonance_level;   /**< Resonant frequency node level */
+} BlinkSpotSpec;
+
+/**
+ * @brief Source ID standing for the current location when planning
+ */
+#define QTELEPORT_CURRENT_LOCATION 0
+
+/**
+ * @brief Most hops a planned route may take
+ */
+#define QTELEPORT_MAX_ROUTE_HOPS 16
+
+/**
+ * @brief Scored teleport destination
+ */
+typedef struct {
+    BlinkSpotTarget *destination;/**< Destination location */
+    double distance_km;          /**< Distance from the source (assumed for the current location) */
+    double energy_cost;          /**< Energy the teleport would use */
+    double duration;             /**< Duration the teleport would take in seconds */
+    bool within_limit;           /**< Whether the energy fits the settings' energy limit */
+} TeleportCandidate;
+
+/**
+ * @brief Multi-hop route through blink spots
+ */
+typedef struct {
+    BlinkSpotTarget **hops;      /**< Blink spots visited in order, destination last */
+    uint32_t hop_count;          /**< Number of hops */
+    double energy_cost;          /**< Total energy over every hop */
+    double duration;             /**< Total duration in seconds */
+    double distance_km;          /**< Total distance in kilometers */
+} TeleportRoute;
+
+/**
+ * @brief Planner cost cache statistics
+ */
+typedef struct {
+    uint64_t cache_hits;         /**< Favorite pairs served from the cache */
+    uint64_t cache_misses;       /**< Favorite pairs measured and cached */
+    uint32_t cached_pairs;       /**< Pairs currently cached */
+} TeleportPlannerStats;
+
+/**
+ * @brief Most asynchronous teleports queued or running at once
+ */
+#define QTELEPORT_MAX_IN_FLIGHT 16
+
+/**
+ * @brief Number of finished asynchronous teleports whose outcome is kept
+ */
+#define QTELEPORT_COMPLETION_HISTORY 64
+
+/**
+ * @brief Asynchronous teleport status
+ */
+typedef enum {
+    TELEPORT_STATUS_UNKNOWN = 0, /**< No such request, or its outcome is no longer kept */
+    TELEPORT_STATUS_QUEUED,      /**< Validated and costed, waiting for the script */
+    TELEPORT_STATUS_EXECUTING,   /**< Running the teleport script */
+    TELEPORT_STATUS_IN_TRANSIT,  /**< Script done, waiting out the teleport duration */
+    TELEPORT_STATUS_COMPLETED,   /**< Arrived */
+    TELEPORT_STATUS_FAILED,      /**< Rejected or failed */
+    TELEPORT_STATUS_CANCELLED    /**< Cancelled before arriving */
+} TeleportStatus;
+
+/**
+ * @brief Outcome of an asynchronous teleport
+ *
+ * This is the payload of QMSG_TELEPORT_COMPLETE, broadcast on the
+ * quantum message bus by QCOMP_TELEPORT, so it holds no pointers.
+ */
+typedef struct {
+    uint64_t handle;             /**< Request handle */
+    uint64_t target_id;          /**< Destination blink spot identifier */
+    TeleportStatus status;       /**< COMPLETED, FAILED or CANCELLED */
+    double energy_used;          /**< Energy used for teleportation */
+    double duration;             /**< Duration of teleportation in seconds */
+    double stability;            /**< Stability of the teleportation (0.0 to 1.0) */
+    char error_message[64];      /**< Reason for failure (empty on success) */
+} TeleportCompletion;
+
 /**
  * @brief Initialize the quantum teleportation system
  * 
@@ -133,6 +225,96 @@ BlinkSpotTarget **qteleport_find_blink_spots(const char *search_term,
                                           double radius_km, bool favorites_only,
                                           uint32_t *count);
 
+/**
+ * @brief Find the blink spots nearest a location
+ * 
+ * @param latitude Latitude
+ * @param longitude Longitude
+ * @param k Maximum number of targets
+ * @param count Pointer to store the number of targets
+ * @return Array of BlinkSpotTarget pointers, nearest first (must be freed by the caller)
+ */
+BlinkSpotTarget **qteleport_find_nearest(double latitude, double longitude, uint32_t k,
+                                         uint32_t *count);
+
+/**
+ * @brief Find the blink spots within a radius of a location
+ * 
+ * @param latitude Latitude
+ * @param longitude Longitude
+ * @param radius_km Radius in kilometers
+ * @param count Pointer to store the number of targets
+ * @return Array of BlinkSpotTarget pointers, nearest first (must be freed by the caller)
+ */
+BlinkSpotTarget **qteleport_find_within(double latitude, double longitude, double radius_km,
+                                        uint32_t *count);
+
+/**
+ * @brief Load blink spots into the catalog in memory
+ * 
+ * Unlike qteleport_create_blink_spot(), loaded spots are not anchored
+ * through the teleport script one by one, so large catalogs load
+ * quickly.
+ * 
+ * @param specs Blink spots to load
+ * @param count Number of blink spots
+ * @return Number of blink spots loaded
+ */
+uint32_t qteleport_load_blink_spots(const BlinkSpotSpec *specs, uint32_t count);
+
+/**
+ * @brief Score many teleport destinations in one call
+ * 
+ * Candidates within the energy limit come first, then by ascending
+ * energy. Distances between pairs touching a favorite are cached until
+ * either spot is updated, deleted or unmarked.
+ * 
+ * @param source_id Source blink spot identifier, or QTELEPORT_CURRENT_LOCATION
+ * @param target_ids Destination identifiers (NULL for every other blink spot);
+ *                   unknown identifiers and the source itself are skipped
+ * @param target_count Number of destination identifiers
+ * @param settings Teleportation settings to score under
+ * @param count Pointer to store the number of candidates
+ * @return Array of ranked candidates (must be freed by the caller), or NULL
+ *         if the source is unknown
+ */
+TeleportCandidate *qteleport_rank_destinations(uint64_t source_id, const uint64_t *target_ids,
+                                               uint32_t target_count, TeleportSettings settings,
+                                               uint32_t *count);
+
+/**
+ * @brief Plan the cheapest route between two blink spots
+ * 
+ * Every hop must fit the settings' energy limit, so a destination out
+ * of reach of one teleport can still be reached through others. With
+ * no limit the direct hop is considered alongside cheaper detours via
+ * efficient resonance levels.
+ * 
+ * @param source_id Source blink spot identifier
+ * @param destination_id Destination blink spot identifier
+ * @param max_hops Most hops to take (1 to QTELEPORT_MAX_ROUTE_HOPS)
+ * @param settings Teleportation settings
+ * @param route Route to fill (release with qteleport_free_route)
+ * @return true if a route was found, false otherwise
+ */
+bool qteleport_plan_route(uint64_t source_id, uint64_t destination_id, uint32_t max_hops,
+                          TeleportSettings settings, TeleportRoute *route);
+
+/**
+ * @brief Free the hops of a planned route
+ * 
+ * @param route Route (may be NULL)
+ */
+void qteleport_free_route(TeleportRoute *route);
+
+/**
+ * @brief Get the planner cost cache statistics
+ * 
+ * @param stats Pointer to store the statistics
+ * @return true if retrieved, false otherwise
+ */
+bool qteleport_get_planner_stats(TeleportPlannerStats *stats);
+
 /**
  * @brief Teleport to a blink spot target
  * 
@@ -154,6 +336,44 @@ TeleportResult qteleport_to_blink_spot(uint64_t target_id, TeleportSettings sett
 TeleportResult qteleport_to_coordinates(double latitude, double longitude, 
                                       double altitude, TeleportSettings settings);
 
+/**
+ * @brief Submit a teleport to a blink spot without waiting for it
+ * 
+ * The target is validated and costed on the calling thread; the script
+ * and the teleport duration then run on background stages, so one
+ * request's script overlaps the previous request's transit. When the
+ * request finishes, QMSG_TELEPORT_COMPLETE is broadcast with a
+ * TeleportCompletion. A rejected target completes at once as FAILED.
+ * Asynchronous teleports do not change qteleport_get_last_result.
+ * 
+ * @param target_id Target blink spot identifier
+ * @param settings Teleportation settings
+ * @return Request handle, or 0 if not initialized or
+ *         QTELEPORT_MAX_IN_FLIGHT requests are already in flight
+ */
+uint64_t qteleport_submit(uint64_t target_id, TeleportSettings settings);
+
+/**
+ * @brief Cancel an asynchronous teleport
+ * 
+ * A queued request completes as CANCELLED at once. A request whose
+ * script is running completes as CANCELLED when the script returns, and
+ * one in transit stops waiting and completes as CANCELLED.
+ * 
+ * @param handle Request handle
+ * @return true if the request was still in flight, false otherwise
+ */
+bool qteleport_cancel(uint64_t handle);
+
+/**
+ * @brief Get the status of an asynchronous teleport
+ * 
+ * @param handle Request handle
+ * @param completion Pointer to store the outcome once finished (may be NULL)
+ * @return Current status
+ */
+TeleportStatus qteleport_get_status(uint64_t handle, TeleportCompletion *completion);
+
 /**
  * @brief Mark a blink spot as favorite
  * 
@@ -2,10 +2,19 @@ const express = require('express');
 const WebSocket = require('ws');
 const path = require('path');
 const { exec } = require('child_process');
+const fs = require('fs');
 
 const app = express();
 const port = 8080;
 
+// Message bus statistics snapshot written by qbus_write_stats_json()
+const busStatsFile = process.env.QBUS_STATS_FILE || '/tmp/ctrlxt_qbus_stats.json';
+
+// Trace events appended by trace_append_binary(), as 24-byte TraceEvent records
+const traceFile = process.env.CTRLXT_TRACE_FILE || '/tmp/ctrlxt_trace.bin';
+const TRACE_RECORD_SIZE = 24;
+const TRACE_MAX_FRAME = 1024 * 1024;
+
 // Create WebSocket server
 const wss = new WebSocket.Server({ port: 8081 });
 
@@ -17,9 +26,17 @@ app.use(express.json());
 
 // Store connected clients
 const clients = new Set();
+const traceClients = new Set();
 
 // WebSocket connection handler
-wss.on('connection', (ws) => {
+wss.on('connection', (ws, req) => {
+    // Trace viewers connect to /trace and only receive binary trace frames
+    if (req.url === '/trace') {
+        traceClients.add(ws);
+        ws.on('close', () => traceClients.delete(ws));
+        return;
+    }
+    
     clients.add(ws);
     console.log('Client connected');
 
@@ -39,6 +56,67 @@ function broadcast(data) {
     });
 }
 
+// Send raw bytes to all connected trace viewers
+function broadcastTrace(buffer) {
+    traceClients.forEach(client => {
+        if (client.readyState === WebSocket.OPEN) {
+            client.send(buffer, { binary: true });
+        }
+    });
+}
+
+// Stream trace records appended since the last poll as binary frames
+//
+// Frames hold whole records in host byte order: timestamp (u64 ns), arg0
+// (u64), arg1 (u32), type (u16), phase (u8), cpu (u8). Viewers start at the
+// live end of the file; a new inode or a shorter file means it was rotated.
+let traceOffset = 0;
+let traceInode = 0;
+let traceReading = false;
+setInterval(() => {
+    if (traceReading) {
+        return;
+    }
+    
+    fs.stat(traceFile, (error, stats) => {
+        if (error) {
+            return;
+        }
+        
+        if (stats.ino !== traceInode || stats.size < traceOffset) {
+            traceInode = stats.ino;
+            traceOffset = 0;
+        }
+        const available = stats.size - (stats.size % TRACE_RECORD_SIZE);
+        if (traceClients.size === 0) {
+            traceOffset = available;
+            return;
+        }
+        
+        const length = Math.min(available - traceOffset, TRACE_MAX_FRAME - (TRACE_MAX_FRAME % TRACE_RECORD_SIZE));
+        if (length <= 0) {
+            return;
+        }
+        
+        traceReading = true;
+        const chunks = [];
+        fs.createReadStream(traceFile, { start: traceOffset, end: traceOffset + length - 1 })
+            .on('data', chunk => chunks.push(chunk))
+            .on('error', () => {
+                traceReading = false;
+            })
+            .on('end', () => {
+                const data = Buffer.concat(chunks);
+                const whole = data.length - (data.length % TRACE_RECORD_SIZE);
+                traceOffset += whole;
+                traceReading = false;
+                if (whole > 0) {
+                    broadcastTrace(data.subarray(0, whole));
+                }
+            });
+    });
+}, 250);
+
 // Start periodic system metrics update
 setInterval(() => {
     // Simulate quantum system metrics
@@ -51,8 +129,49 @@ setInterval(() => {
     broadcast(metrics);
 }, 5000);
 
+// Read the latest message bus statistics snapshot
+function readBusStats(callback) {
+    fs.readFile(busStatsFile, 'utf8', (error, contents) => {
+        if (error) {
+            callback(error);
+            return;
+        }
+        
+        try {
+            callback(null, JSON.parse(contents));
+        } catch (parseError) {
+            callback(parseError);
+        }
+    });
+}
+
+// Push message bus statistics to clients whenever a new snapshot appears
+let lastBusStatsTimestamp = 0;
+setInterval(() => {
+    readBusStats((error, stats) => {
+        if (error || stats.timestamp === lastBusStatsTimestamp) {
+            return;
+        }
+        
+        lastBusStatsTimestamp = stats.timestamp;
+        broadcast({ type: 'bus_stats', stats });
+    });
+}, 1000);
+
 // API Routes
 
+// Get message bus statistics
+app.get('/api/quantum/bus/stats', (req, res) => {
+    readBusStats((error, stats) => {
+        if (error) {
+            res.status(503).json({ success: false, error: `No bus statistics available: ${error.message}` });
+            return;
+        }
+        
+        res.json(stats);
+    });
+});
+
 // Get system metrics
 app.get('/api/quantum/metrics', (req, res) => {
     const metrics = {
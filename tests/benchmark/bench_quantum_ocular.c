@@ -0,0 +1,454 @@
+/**
+ * @file bench_quantum_ocular.c
+ * @brief Frame-time and latency benchmarks for the Q-OPU and teleportation
+ *
+ * Runs fixed synthetic frames at several resolutions through several
+ * enhancement combinations, once per kernel, then times the script
+ * round trip behind qopu_get_quantum_data and qteleport_to_blink_spot.
+ * Each case reports p50/p99 time, frames per second and allocations per
+ * call, on stdout and as JSON for tracking regressions across releases.
+ *
+ * Allocations are counted by wrapping malloc, calloc, realloc and strdup
+ * at link time (see tests/Makefile), so they cover the code under test
+ * but not allocations libc makes internally, such as popen's.
+ *
+ * Usage: bench_quantum_ocular [-o file.json] [-n frames] [-s script_calls] [-t teleports]
+ */
+
+/* strdup under -std=c11 */
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "../../src/quantum/ocular/quantum_ocular.h"
+#include "../../src/quantum/teleport/quantum_teleport.h"
+
+#define BENCH_MAX_CASES 64
+#define BENCH_WARMUP_FRAMES 2
+
+/* Allocation counting through the linker's --wrap */
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+char *__real_strdup(const char *text);
+
+static atomic_ullong allocation_count;
+
+void *__wrap_malloc(size_t size) {
+    atomic_fetch_add_explicit(&allocation_count, 1, memory_order_relaxed);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    atomic_fetch_add_explicit(&allocation_count, 1, memory_order_relaxed);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *pointer, size_t size) {
+    atomic_fetch_add_explicit(&allocation_count, 1, memory_order_relaxed);
+    return __real_realloc(pointer, size);
+}
+
+char *__wrap_strdup(const char *text) {
+    atomic_fetch_add_explicit(&allocation_count, 1, memory_order_relaxed);
+    return __real_strdup(text);
+}
+
+/**
+ * @brief One measured case
+ */
+typedef struct {
+    char name[64];                 /**< Case name */
+    const char *group;             /**< "enhance", "script" or "teleport" */
+    const char *kernel;            /**< Kernel used, or "" */
+    uint32_t width;                /**< Frame width in pixels (0 if not a frame) */
+    uint32_t height;               /**< Frame height in pixels */
+    uint32_t bytes;                /**< Bytes processed per call */
+    uint32_t iterations;           /**< Measured calls */
+    uint32_t failures;             /**< Calls that reported failure */
+    uint64_t p50_ns;               /**< Median call time */
+    uint64_t p99_ns;               /**< 99th percentile call time */
+    uint64_t mean_ns;              /**< Mean call time */
+    uint64_t max_ns;               /**< Slowest call */
+    double per_second;             /**< Calls per second at the mean */
+    double allocations;            /**< Allocations per call */
+} BenchCase;
+
+/**
+ * @brief Timer over a run of calls
+ */
+typedef struct {
+    uint64_t *samples;
+    uint32_t count;
+    uint64_t started;
+    unsigned long long allocations;
+} BenchTimer;
+
+/**
+ * @brief Enhancement combination
+ */
+typedef struct {
+    const char *name;
+    uint32_t flags;
+} BenchCombo;
+
+/**
+ * @brief Synthetic frame resolution (RGBA)
+ */
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+} BenchResolution;
+
+static BenchCase cases[BENCH_MAX_CASES];
+static uint32_t case_count = 0;
+
+/**
+ * @brief Nanoseconds on the monotonic clock
+ */
+static uint64_t monotonic_nanoseconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Order samples ascending
+ */
+static int compare_samples(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Start timing one call
+ */
+static void timer_start(BenchTimer *timer) {
+    timer->started = monotonic_nanoseconds();
+}
+
+/**
+ * @brief Finish timing one call
+ */
+static void timer_stop(BenchTimer *timer) {
+    timer->samples[timer->count++] = monotonic_nanoseconds() - timer->started;
+}
+
+/**
+ * @brief Begin a run of calls
+ */
+static bool timer_begin(BenchTimer *timer, uint32_t iterations) {
+    timer->samples = (uint64_t *)__real_malloc(sizeof(uint64_t) * (iterations ? iterations : 1));
+    timer->count = 0;
+    timer->allocations = atomic_load(&allocation_count);
+    return timer->samples != NULL;
+}
+
+/**
+ * @brief Summarize a run of calls into a new case
+ */
+static BenchCase *timer_finish(BenchTimer *timer, const char *name, const char *group,
+                               const char *kernel, uint32_t failures) {
+    unsigned long long allocations = atomic_load(&allocation_count) - timer->allocations;
+    if (case_count >= BENCH_MAX_CASES || timer->count == 0) {
+        free(timer->samples);
+        return NULL;
+    }
+
+    BenchCase *result = &cases[case_count++];
+    memset(result, 0, sizeof(*result));
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    result->group = group;
+    result->kernel = kernel;
+    result->iterations = timer->count;
+    result->failures = failures;
+
+    qsort(timer->samples, timer->count, sizeof(uint64_t), compare_samples);
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < timer->count; i++) {
+        total += timer->samples[i];
+    }
+    /* Nearest rank */
+    result->p50_ns = timer->samples[(timer->count * 50 + 99) / 100 - 1];
+    result->p99_ns = timer->samples[(timer->count * 99 + 99) / 100 - 1];
+    result->max_ns = timer->samples[timer->count - 1];
+    result->mean_ns = total / timer->count;
+    result->per_second = result->mean_ns ? 1e9 / (double)result->mean_ns : 0.0;
+    result->allocations = (double)allocations / timer->count;
+    free(timer->samples);
+    return result;
+}
+
+/**
+ * @brief Name of a kernel
+ */
+static const char *kernel_name(OcularKernel kernel) {
+    switch (kernel) {
+        case OCULAR_KERNEL_SCALAR: return "scalar";
+        case OCULAR_KERNEL_SSE2: return "sse2";
+        case OCULAR_KERNEL_AVX2: return "avx2";
+        case OCULAR_KERNEL_NEON: return "neon";
+        case OCULAR_KERNEL_SCRIPT: return "script";
+        default: return "auto";
+    }
+}
+
+/**
+ * @brief Benchmark qopu_process_visual_enhanced over frames of one size
+ */
+static void bench_enhancement(const BenchResolution *resolution, const BenchCombo *combo,
+                              uint32_t frames) {
+    uint32_t size = resolution->width * resolution->height * 4;
+    uint8_t *input = (uint8_t *)malloc(size);
+    uint8_t *output = (uint8_t *)malloc(size);
+    static uint8_t state[256];
+    if (!input || !output) {
+        free(input);
+        free(output);
+        return;
+    }
+
+    /* Same bytes on every run so results compare across releases */
+    uint32_t seed = 0x9E3779B9u;
+    for (uint32_t i = 0; i < size; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        input[i] = (uint8_t)(seed >> 24);
+    }
+    for (uint32_t i = 0; i < sizeof(state); i++) {
+        state[i] = (uint8_t)(i * 37);
+    }
+
+    QuantumVisualData visual = { 0 };
+    visual.raw_data = input;
+    visual.raw_size = size;
+    visual.quantum_state = state;
+    visual.quantum_state_size = sizeof(state);
+
+    VisualProcessingParams params = { 0 };
+    params.mode = VISUAL_MODE_QUANTUM_ENHANCED;
+    params.enhancement_flags = combo->flags;
+    params.quantum_clarity_factor = 0.5f;
+    params.reality_overlay_strength = 0.6f;
+    params.quantum_filter_threshold = 0.1f;
+    params.dimensional_shift_factor = 0.2f;
+
+    BenchTimer timer;
+    uint32_t failures = 0;
+    for (uint32_t i = 0; i < BENCH_WARMUP_FRAMES; i++) {
+        qopu_process_visual_enhanced(&visual, &params, output, size);
+    }
+    if (!timer_begin(&timer, frames)) {
+        free(input);
+        free(output);
+        return;
+    }
+    for (uint32_t i = 0; i < frames; i++) {
+        timer_start(&timer);
+        int32_t processed = qopu_process_visual_enhanced(&visual, &params, output, size);
+        timer_stop(&timer);
+        if (processed != (int32_t)size) {
+            failures++;
+        }
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "%s_%ux%u", combo->name, resolution->width, resolution->height);
+    BenchCase *result = timer_finish(&timer, name, "enhance", kernel_name(qopu_get_enhancement_kernel()),
+                                     failures);
+    if (result) {
+        result->width = resolution->width;
+        result->height = resolution->height;
+        result->bytes = size;
+    }
+    free(input);
+    free(output);
+}
+
+/**
+ * @brief Benchmark the script round trip behind qopu_get_quantum_data
+ */
+static void bench_script(uint32_t calls) {
+    char buffer[1024];
+    BenchTimer timer;
+    uint32_t failures = 0;
+    if (!timer_begin(&timer, calls)) {
+        return;
+    }
+    for (uint32_t i = 0; i < calls; i++) {
+        timer_start(&timer);
+        int32_t result = qopu_get_quantum_data("QuantumGPS", buffer, sizeof(buffer));
+        timer_stop(&timer);
+        if (result <= 0) {
+            failures++;
+        }
+    }
+    timer_finish(&timer, "get_quantum_data", "script", "", failures);
+}
+
+/**
+ * @brief Benchmark qteleport_to_blink_spot
+ */
+static void bench_teleport(uint32_t teleports) {
+    if (!qteleport_init(NULL)) {
+        printf("Teleportation unavailable; skipping teleport latency\n");
+        return;
+    }
+    BlinkSpotTarget *target = qteleport_create_blink_spot("Benchmark Anchor", "Fixed benchmark destination",
+                                                          35.1495, -90.0489, 79.0, NODE_ZERO_POINT);
+    if (!target) {
+        qteleport_shutdown();
+        return;
+    }
+
+    /* Instant and fast enough that no simulated travel time is slept */
+    TeleportSettings settings = qteleport_get_default_settings();
+    settings.method = TELEPORT_INSTANT;
+    settings.visual_effect = EFFECT_NONE;
+    settings.energy_limit = 0.0;
+    settings.speed_factor = 100.0;
+
+    BenchTimer timer;
+    uint32_t failures = 0;
+    if (!timer_begin(&timer, teleports)) {
+        qteleport_shutdown();
+        return;
+    }
+    for (uint32_t i = 0; i < teleports; i++) {
+        timer_start(&timer);
+        TeleportResult result = qteleport_to_blink_spot(target->id, settings);
+        timer_stop(&timer);
+        if (!result.success) {
+            failures++;
+        }
+    }
+    timer_finish(&timer, "to_blink_spot", "teleport", "", failures);
+    qteleport_shutdown();
+}
+
+/**
+ * @brief Write the results as JSON, replacing the file atomically
+ */
+static bool write_results(const char *path) {
+    char temp_path[512];
+    if (snprintf(temp_path, sizeof(temp_path), "%s.tmp", path) >= (int)sizeof(temp_path)) {
+        return false;
+    }
+    FILE *file = fopen(temp_path, "w");
+    if (!file) {
+        printf("Cannot write benchmark results: failed to open %s\n", temp_path);
+        return false;
+    }
+
+    fprintf(file, "{\"timestamp\":%llu,\"cases\":[", (unsigned long long)time(NULL));
+    for (uint32_t i = 0; i < case_count; i++) {
+        const BenchCase *result = &cases[i];
+        fprintf(file, "%s{\"name\":\"%s\",\"group\":\"%s\",\"kernel\":\"%s\",\"width\":%u,\"height\":%u,"
+                "\"bytes\":%u,\"iterations\":%u,\"failures\":%u,\"p50Ns\":%llu,\"p99Ns\":%llu,"
+                "\"meanNs\":%llu,\"maxNs\":%llu,\"perSecond\":%.3f,\"allocationsPerCall\":%.3f}",
+                i ? "," : "", result->name, result->group, result->kernel, result->width, result->height,
+                result->bytes, result->iterations, result->failures,
+                (unsigned long long)result->p50_ns, (unsigned long long)result->p99_ns,
+                (unsigned long long)result->mean_ns, (unsigned long long)result->max_ns,
+                result->per_second, result->allocations);
+    }
+    fprintf(file, "]}\n");
+
+    if (fclose(file) != 0 || rename(temp_path, path) != 0) {
+        remove(temp_path);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Print the results as a table
+ */
+static void print_results(void) {
+    printf("\n%-28s %-8s %12s %12s %12s %10s\n", "case", "kernel", "p50 us", "p99 us", "per sec", "allocs");
+    for (uint32_t i = 0; i < case_count; i++) {
+        const BenchCase *result = &cases[i];
+        printf("%-28s %-8s %12.1f %12.1f %12.1f %10.2f%s\n", result->name, result->kernel,
+               result->p50_ns / 1000.0, result->p99_ns / 1000.0, result->per_second,
+               result->allocations, result->failures ? "  (failures)" : "");
+    }
+}
+
+/**
+ * @brief Main benchmark function
+ */
+int main(int argc, char **argv) {
+    const char *output_path = "ocular_benchmark.json";
+    uint32_t frames = 50;
+    uint32_t script_calls = 10;
+    uint32_t teleports = 3;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-o") == 0) {
+            output_path = argv[i + 1];
+        } else if (strcmp(argv[i], "-n") == 0) {
+            frames = (uint32_t)strtoul(argv[i + 1], NULL, 10);
+        } else if (strcmp(argv[i], "-s") == 0) {
+            script_calls = (uint32_t)strtoul(argv[i + 1], NULL, 10);
+        } else if (strcmp(argv[i], "-t") == 0) {
+            teleports = (uint32_t)strtoul(argv[i + 1], NULL, 10);
+        } else {
+            printf("Usage: %s [-o file.json] [-n frames] [-s script_calls] [-t teleports]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    OcularConfig config = {
+        .composition = COMP_COSMIC_DUST,
+        .processing_model = MODEL_BIO_QUANTUM,
+        .interface = INTERFACE_NEURAL,
+        .quantum_tunneling_enabled = true,
+        .reality_mode = QOPU_REALITY_EXISTING,
+        .zero_point_frequency = 432.0,
+        .teleportation_enabled = true,
+        .current_audio_level = 1
+    };
+    if (!qopu_init(config)) {
+        printf("Q-OPU initialization failed\n");
+        return 1;
+    }
+
+    static const BenchResolution resolutions[] = {
+        { 320, 240 }, { 1280, 720 }, { 1920, 1080 }, { 3840, 2160 }
+    };
+    static const BenchCombo combos[] = {
+        { "clarity", ENHANCE_QUANTUM_CLARITY },
+        { "clarity_overlay", ENHANCE_QUANTUM_CLARITY | ENHANCE_REALITY_OVERLAY },
+        { "full_chain", ENHANCE_QUANTUM_CLARITY | ENHANCE_REALITY_OVERLAY | ENHANCE_QUANTUM_FILTER |
+                        ENHANCE_DIMENSIONAL_SHIFT | ENHANCE_QUANTUM_FUSION }
+    };
+    static const OcularKernel kernels[] = { OCULAR_KERNEL_SCALAR, OCULAR_KERNEL_AUTO };
+
+    for (uint32_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        qopu_set_enhancement_kernel(kernels[k]);
+        for (uint32_t c = 0; c < sizeof(combos) / sizeof(combos[0]); c++) {
+            for (uint32_t r = 0; r < sizeof(resolutions) / sizeof(resolutions[0]); r++) {
+                bench_enhancement(&resolutions[r], &combos[c], frames);
+            }
+        }
+    }
+    qopu_set_enhancement_kernel(OCULAR_KERNEL_AUTO);
+
+    if (script_calls > 0) {
+        bench_script(script_calls);
+    }
+    if (teleports > 0) {
+        bench_teleport(teleports);
+    }
+    qopu_shutdown();
+
+    print_results();
+    if (!write_results(output_path)) {
+        printf("Failed to write %s\n", output_path);
+        return 1;
+    }
+    printf("\nResults written to %s\n", output_path);
+    return 0;
+}
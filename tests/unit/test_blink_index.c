@@ -0,0 +1,219 @@
+/**
+ * @file test_blink_index.c
+ * @brief Unit tests for the blink spot spatial and name index
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include "../../src/quantum/teleport/blink_index.h"
+
+#define TEST_PI 3.14159265358979323846
+#define TEST_EARTH_RADIUS_KM 6371.0
+#define TEST_SPOTS 2000
+
+static BlinkIndexEntry entries[TEST_SPOTS];
+static char names[TEST_SPOTS][32];
+static uint32_t seed = 12345;
+
+/**
+ * @brief Deterministic pseudo-random value in [0, 1)
+ */
+static double next_random(void) {
+    seed = seed * 1664525u + 1013904223u;
+    return (seed >> 8) / 16777216.0;
+}
+
+/**
+ * @brief Haversine distance in kilometers
+ */
+static double haversine_km(double lat1, double lon1, double lat2, double lon2) {
+    double phi1 = lat1 * TEST_PI / 180.0, phi2 = lat2 * TEST_PI / 180.0;
+    double dphi = phi2 - phi1, dlambda = (lon2 - lon1) * TEST_PI / 180.0;
+    double a = sin(dphi / 2) * sin(dphi / 2) + cos(phi1) * cos(phi2) * sin(dlambda / 2) * sin(dlambda / 2);
+    return TEST_EARTH_RADIUS_KM * 2 * atan2(sqrt(a), sqrt(1 - a));
+}
+
+/**
+ * @brief Fill the catalog with spread, clustered and duplicate locations
+ */
+static void fill_catalog(void) {
+    static const char *words[] = { "Harbor", "Peak", "Falls", "Station", "Grove", "Summit" };
+    for (uint32_t i = 0; i < TEST_SPOTS; i++) {
+        if (i % 10 == 0) {
+            /* A cluster astride the antimeridian */
+            entries[i].latitude = -10.0 + next_random();
+            entries[i].longitude = next_random() < 0.5 ? 179.5 + next_random() * 0.5 : -180.0 + next_random() * 0.5;
+        } else if (i % 10 == 1) {
+            /* Identical points */
+            entries[i].latitude = 35.1495;
+            entries[i].longitude = -90.0489;
+        } else if (i % 10 == 2) {
+            entries[i].latitude = 89.0 + next_random();
+            entries[i].longitude = next_random() * 360.0 - 180.0;
+        } else {
+            entries[i].latitude = asin(next_random() * 2.0 - 1.0) * 180.0 / TEST_PI;
+            entries[i].longitude = next_random() * 360.0 - 180.0;
+        }
+        snprintf(names[i], sizeof(names[i]), "%s %u", words[i % 6], i);
+        entries[i].name = names[i];
+        entries[i].description = (i % 3 == 0) ? "Coastal anchor" : NULL;
+    }
+}
+
+/**
+ * @brief Test nearest-neighbor queries against a linear scan
+ */
+static void test_nearest(void) {
+    printf("\nTesting blink index nearest queries...\n");
+
+    BlinkIndex *index = bindex_create();
+    assert(index != NULL);
+    uint32_t slots[64];
+    assert(bindex_nearest(index, 0.0, 0.0, 5, slots) == 0);
+    assert(bindex_build(index, entries, TEST_SPOTS));
+    assert(bindex_count(index) == TEST_SPOTS);
+
+    double queries[][2] = { { 35.0, -90.0 }, { -10.5, 180.0 }, { 90.0, 0.0 }, { -90.0, 45.0 }, { 0.0, 0.0 } };
+    for (uint32_t q = 0; q < sizeof(queries) / sizeof(queries[0]); q++) {
+        uint32_t k = 25;
+        assert(bindex_nearest(index, queries[q][0], queries[q][1], k, slots) == k);
+
+        /* Distances ascend, and nothing outside the result is closer */
+        double farthest = 0.0;
+        for (uint32_t i = 0; i < k; i++) {
+            double distance = haversine_km(queries[q][0], queries[q][1],
+                                           entries[slots[i]].latitude, entries[slots[i]].longitude);
+            assert(distance + 1e-6 >= farthest);
+            farthest = distance;
+        }
+        uint32_t closer = 0;
+        for (uint32_t i = 0; i < TEST_SPOTS; i++) {
+            if (haversine_km(queries[q][0], queries[q][1], entries[i].latitude, entries[i].longitude) <
+                farthest - 1e-6) {
+                closer++;
+            }
+        }
+        assert(closer < k);
+    }
+
+    /* Asking for more than there are returns everything once */
+    BlinkIndex *small = bindex_create();
+    assert(bindex_build(small, entries, 3));
+    assert(bindex_nearest(small, 0.0, 0.0, 64, slots) == 3);
+    assert(slots[0] != slots[1] && slots[1] != slots[2] && slots[0] != slots[2]);
+    assert(bindex_build(small, NULL, 0) && bindex_count(small) == 0);
+    bindex_destroy(small);
+
+    bindex_destroy(index);
+    bindex_destroy(NULL);
+    printf("Blink index nearest test passed!\n");
+}
+
+/**
+ * @brief Test radius queries against a linear scan
+ */
+static void test_within(void) {
+    printf("\nTesting blink index radius queries...\n");
+
+    BlinkIndex *index = bindex_create();
+    assert(bindex_build(index, entries, TEST_SPOTS));
+
+    double queries[][3] = { { 35.0, -90.0, 500.0 }, { -10.5, 179.9, 120.0 }, { 89.9, 10.0, 200.0 },
+                            { 0.0, 0.0, 0.0 }, { 35.1495, -90.0489, 0.0 }, { 12.0, 40.0, 30000.0 } };
+    for (uint32_t q = 0; q < sizeof(queries) / sizeof(queries[0]); q++) {
+        uint32_t *slots = NULL;
+        uint32_t count = bindex_within(index, queries[q][0], queries[q][1],
+                                       queries[q][2] / TEST_EARTH_RADIUS_KM, &slots);
+        uint32_t expected = 0;
+        uint32_t found = 0;
+        for (uint32_t i = 0; i < TEST_SPOTS; i++) {
+            double distance = haversine_km(queries[q][0], queries[q][1], entries[i].latitude, entries[i].longitude);
+            bool listed = false;
+            for (uint32_t j = 0; j < count; j++) {
+                listed = listed || slots[j] == i;
+            }
+            if (distance <= queries[q][2]) {
+                expected++;
+                assert(listed);
+            }
+            found += listed;
+        }
+        assert(found == count && count >= expected);
+        for (uint32_t j = 1; j < count; j++) {
+            assert(slots[j - 1] < slots[j]);
+        }
+        free(slots);
+    }
+
+    /* Identical points are all found at radius zero */
+    uint32_t *slots = NULL;
+    assert(bindex_within(index, 35.1495, -90.0489, 0.0, &slots) == TEST_SPOTS / 10);
+    free(slots);
+    assert(bindex_within(index, 35.0, -90.0, -1.0, &slots) == 0 && slots == NULL);
+
+    bindex_destroy(index);
+    printf("Blink index radius test passed!\n");
+}
+
+/**
+ * @brief Test name and description candidates against substring matching
+ */
+static void test_text(void) {
+    printf("\nTesting blink index text candidates...\n");
+
+    BlinkIndex *index = bindex_create();
+    assert(bindex_build(index, entries, TEST_SPOTS));
+
+    const char *terms[] = { "Harbor", "Peak 1", "Summit 1997", "anchor", "oastal", "Lagoon", "ls 4" };
+    for (uint32_t t = 0; t < sizeof(terms) / sizeof(terms[0]); t++) {
+        uint32_t *slots = NULL;
+        uint32_t count = 0;
+        assert(bindex_text_candidates(index, terms[t], &slots, &count));
+        for (uint32_t j = 1; j < count; j++) {
+            assert(slots[j - 1] < slots[j]);
+        }
+        /* Every match is a candidate */
+        uint32_t position = 0;
+        for (uint32_t i = 0; i < TEST_SPOTS; i++) {
+            bool matches = strstr(entries[i].name, terms[t]) ||
+                           (entries[i].description && strstr(entries[i].description, terms[t]));
+            while (position < count && slots[position] < i) {
+                position++;
+            }
+            if (matches) {
+                assert(position < count && slots[position] == i);
+            }
+        }
+        free(slots);
+    }
+
+    /* Absent trigrams rule everything out; short terms are not narrowed */
+    uint32_t *slots = NULL;
+    uint32_t count = 1;
+    assert(bindex_text_candidates(index, "Lagoon", &slots, &count) && count == 0 && slots == NULL);
+    assert(!bindex_text_candidates(index, "Pe", &slots, &count));
+    assert(bindex_text_candidates(index, "Summit 1997", &slots, &count) && count >= 1);
+    free(slots);
+
+    bindex_destroy(index);
+    printf("Blink index text test passed!\n");
+}
+
+/**
+ * @brief Main test function
+ */
+int main(void) {
+    printf("Running Blink Index tests...\n\n");
+
+    fill_catalog();
+    test_nearest();
+    test_within();
+    test_text();
+
+    printf("\nAll Blink Index tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file test_entanglement_registry.c
+ * @brief Unit tests for the shared entanglement registry
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include "../../src/quantum/entanglement/entanglement_registry.h"
+
+static uint32_t released = 0;
+
+/**
+ * @brief Release callback counting the payloads it is handed
+ */
+static void count_release(void *payload) {
+    assert(payload != NULL);
+    released++;
+}
+
+/**
+ * @brief Test reserving, publishing, finding and removing entries
+ */
+static void test_entry_lifecycle(void) {
+    printf("\nTesting registry entry lifecycle...\n");
+
+    void *payload = NULL;
+    uint64_t id = qereg_reserve(QEREG_KIND_SPACE, &payload);
+    assert(id != 0 && payload != NULL);
+    assert(qereg_count(QEREG_KIND_SPACE) == 1);
+
+    /* A reserved entry is zeroed and hidden until published */
+    for (int i = 0; i < QEREG_PAYLOAD_SIZE; i++) {
+        assert(((unsigned char *)payload)[i] == 0);
+    }
+    assert(qereg_find(QEREG_KIND_SPACE, id) == NULL);
+    memset(payload, 0xab, QEREG_PAYLOAD_SIZE);
+    qereg_publish(id);
+    assert(qereg_find(QEREG_KIND_SPACE, id) == payload);
+
+    /* An ID only names an entry of its own kind */
+    assert(qereg_find(QEREG_KIND_MEMORY, id) == NULL);
+    assert(!qereg_remove(QEREG_KIND_PROCESS, id));
+    assert(qereg_find(QEREG_KIND_SPACE, 0) == NULL);
+    assert(qereg_find(QEREG_KIND_SPACE, ~0ULL) == NULL);
+    assert(qereg_find(QEREG_KIND_COUNT, id) == NULL);
+
+    /* A reused slot gets a new ID, and its payload comes back cleared */
+    assert(qereg_remove(QEREG_KIND_SPACE, id));
+    assert(!qereg_remove(QEREG_KIND_SPACE, id));
+    assert(qereg_find(QEREG_KIND_SPACE, id) == NULL);
+    void *reused = NULL;
+    uint64_t next = qereg_reserve(QEREG_KIND_SPACE, &reused);
+    assert(next != 0 && next != id && reused == payload);
+    assert(((unsigned char *)reused)[0] == 0);
+    qereg_publish(next);
+    assert(qereg_find(QEREG_KIND_SPACE, id) == NULL);
+    assert(qereg_find(QEREG_KIND_SPACE, next) == reused);
+
+    /* A reserved entry can be removed before it is ever published */
+    uint64_t abandoned = qereg_reserve(QEREG_KIND_SPACE, &payload);
+    assert(qereg_remove(QEREG_KIND_SPACE, abandoned));
+    assert(qereg_count(QEREG_KIND_SPACE) == 1);
+
+    assert(qereg_remove(QEREG_KIND_SPACE, next));
+    assert(qereg_count(QEREG_KIND_SPACE) == 0);
+    assert(qereg_reserve(QEREG_KIND_SPACE, NULL) == 0);
+
+    printf("Registry entry lifecycle test passed!\n");
+}
+
+/**
+ * @brief Test per-kind limits, growth and clearing
+ */
+static void test_limits_and_clear(void) {
+    printf("\nTesting registry limits and clearing...\n");
+
+    /* Limits apply to each kind on its own */
+    assert(qereg_set_limit(QEREG_KIND_MEMORY, 3));
+    assert(!qereg_set_limit(QEREG_KIND_COUNT, 3));
+    void *payload = NULL;
+    for (int i = 0; i < 3; i++) {
+        uint64_t id = qereg_reserve(QEREG_KIND_MEMORY, &payload);
+        assert(id != 0);
+        qereg_publish(id);
+    }
+    assert(qereg_reserve(QEREG_KIND_MEMORY, &payload) == 0);
+    uint64_t process_id = qereg_reserve(QEREG_KIND_PROCESS, &payload);
+    assert(process_id != 0);
+    qereg_publish(process_id);
+
+    /* Clearing a kind releases its entries and leaves the others */
+    released = 0;
+    assert(qereg_clear(QEREG_KIND_MEMORY, count_release) == 3 && released == 3);
+    assert(qereg_count(QEREG_KIND_MEMORY) == 0);
+    assert(qereg_find(QEREG_KIND_PROCESS, process_id) == payload);
+    assert(qereg_reserve(QEREG_KIND_MEMORY, &payload) != 0);
+    assert(qereg_clear(QEREG_KIND_MEMORY, NULL) == 1);
+    assert(qereg_set_limit(QEREG_KIND_MEMORY, 0));
+
+    /* Growing past a chunk keeps earlier payloads where they were */
+    void *first = qereg_find(QEREG_KIND_PROCESS, process_id);
+    uint64_t ids[1000];
+    for (int i = 0; i < 1000; i++) {
+        ids[i] = qereg_reserve(QEREG_KIND_SPACE, &payload);
+        assert(ids[i] != 0);
+        *(int *)payload = i;
+        qereg_publish(ids[i]);
+    }
+    assert(qereg_find(QEREG_KIND_PROCESS, process_id) == first);
+    for (int i = 0; i < 1000; i++) {
+        assert(*(int *)qereg_find(QEREG_KIND_SPACE, ids[i]) == i);
+    }
+    assert(qereg_clear(QEREG_KIND_SPACE, NULL) == 1000);
+    assert(qereg_clear(QEREG_KIND_PROCESS, NULL) == 1);
+
+    printf("Registry limits and clearing test passed!\n");
+}
+
+#define WORKER_THREADS 4
+#define WORKER_ROUNDS 2000
+
+/**
+ * @brief Worker creating entries, checking them and removing them
+ */
+static void *churn_worker(void *arg) {
+    QERegKind kind = (QERegKind)(uintptr_t)arg;
+    uint64_t ids[16];
+    for (int round = 0; round < WORKER_ROUNDS; round++) {
+        for (int i = 0; i < 16; i++) {
+            uint64_t *payload = NULL;
+            ids[i] = qereg_reserve(kind, (void **)&payload);
+            assert(ids[i] != 0);
+            *payload = ids[i];
+            qereg_publish(ids[i]);
+        }
+        for (int i = 0; i < 16; i++) {
+            uint64_t *payload = qereg_find(kind, ids[i]);
+            assert(payload && *payload == ids[i]);
+            assert(qereg_remove(kind, ids[i]));
+            assert(qereg_find(kind, ids[i]) == NULL);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Test concurrent creation, lookup and removal across kinds
+ */
+static void test_concurrent_access(void) {
+    printf("\nTesting concurrent registry access...\n");
+
+    pthread_t workers[WORKER_THREADS];
+    for (uintptr_t i = 0; i < WORKER_THREADS; i++) {
+        assert(pthread_create(&workers[i], NULL, churn_worker, (void *)(i % QEREG_KIND_COUNT)) == 0);
+    }
+    for (int i = 0; i < WORKER_THREADS; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    for (int kind = 0; kind < QEREG_KIND_COUNT; kind++) {
+        assert(qereg_count((QERegKind)kind) == 0);
+    }
+
+    printf("Concurrent registry access test passed!\n");
+}
+
+/**
+ * @brief Main test function
+ */
+int main(void) {
+    printf("Running Entanglement Registry tests...\n\n");
+
+    test_entry_lifecycle();
+    test_limits_and_clear();
+    test_concurrent_access();
+
+    printf("\nAll Entanglement Registry tests passed!\n");
+
+    return 0;
+}
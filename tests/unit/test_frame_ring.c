@@ -0,0 +1,247 @@
+/**
+ * @file test_frame_ring.c
+ * @brief Unit tests for the ocular frame ring
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include "../../src/quantum/ocular/frame_ring.h"
+#include "../../src/quantum/messaging/quantum_message_bus.h"
+
+/**
+ * @brief Acquire, fill with a byte and publish a frame
+ */
+static uint64_t produce(OcularFrameRing *ring, uint8_t value) {
+    OcularFrame *frame = ofring_acquire(ring);
+    if (!frame) {
+        return 0;
+    }
+    memset(frame->data, value, frame->capacity);
+    frame->size = frame->capacity;
+    return ofring_publish(ring, frame);
+}
+
+/**
+ * @brief Test publishing, borrowing in order and per-consumer cursors
+ */
+static void test_borrow(void) {
+    printf("\nTesting frame ring borrowing...\n");
+
+    assert(ofring_create(1, 64, 1, OFRAME_DROP_OLDEST) == NULL);
+    assert(ofring_create(4, 0, 1, OFRAME_DROP_OLDEST) == NULL);
+
+    OcularFrameRing *ring = ofring_create(4, 100, 2, OFRAME_DROP_NEWEST);
+    assert(ring != NULL);
+
+    /* Slot memory is aligned and reused in place, never copied */
+    OcularFrame *frame = ofring_acquire(ring);
+    assert(frame && frame->capacity == 100 && ((uintptr_t)frame->data % 64) == 0);
+    frame->size = 101;
+    assert(ofring_publish(ring, frame) == 0);
+    frame->size = 10;
+    memset(frame->data, 1, 10);
+    assert(ofring_publish(ring, frame) == 1);
+    assert(ofring_publish(ring, frame) == 0);
+    assert(produce(ring, 2) == 2);
+    assert(produce(ring, 3) == 3);
+
+    uint64_t first = 0, second = 0;
+    assert(ofring_borrow(ring, NULL, false) == NULL);
+
+    /* Each consumer walks the frames in order from its own cursor */
+    OcularFrame *seen = ofring_borrow(ring, &first, false);
+    assert(seen == frame && seen->sequence == 1 && first == 1 && seen->data[0] == 1);
+    ofring_release(seen);
+    seen = ofring_borrow(ring, &first, false);
+    assert(seen && seen->sequence == 2 && seen->data[0] == 2);
+    ofring_release(seen);
+
+    /* Skipping to the newest counts the skipped frames as had */
+    seen = ofring_borrow(ring, &second, true);
+    assert(seen && seen->sequence == 3 && second == 3);
+    assert(ofring_borrow(ring, &second, false) == NULL);
+    ofring_release(seen);
+
+    OcularFrameRingStats stats;
+    assert(ofring_get_stats(ring, &stats));
+    assert(stats.published == 3 && stats.retired == 2 && stats.dropped == 0);
+
+    seen = ofring_borrow(ring, &first, false);
+    assert(seen && seen->sequence == 3);
+    ofring_release(seen);
+    assert(ofring_get_stats(ring, &stats) && stats.retired == 3);
+
+    /* Discarded frames are never seen */
+    frame = ofring_acquire(ring);
+    ofring_discard(ring, frame);
+    assert(ofring_borrow(ring, &first, false) == NULL);
+
+    ofring_destroy(ring);
+    ofring_destroy(NULL);
+    printf("Frame ring borrowing test passed!\n");
+}
+
+/**
+ * @brief Test the drop policies when every slot is taken
+ */
+static void test_drop_policies(void) {
+    printf("\nTesting frame ring drop policies...\n");
+
+    /* Dropping the oldest reclaims unread frames nobody holds */
+    OcularFrameRing *ring = ofring_create(2, 16, 1, OFRAME_DROP_OLDEST);
+    assert(produce(ring, 1) == 1);
+    assert(produce(ring, 2) == 2);
+    assert(produce(ring, 3) == 3);
+
+    uint64_t cursor = 0;
+    OcularFrame *held = ofring_borrow(ring, &cursor, false);
+    assert(held && held->sequence == 2 && held->data[0] == 2);
+
+    /* A held frame is never reclaimed from under its reader */
+    assert(produce(ring, 4) == 4);
+    assert(held->sequence == 2 && held->data[0] == 2);
+    OcularFrameRingStats stats;
+    assert(ofring_get_stats(ring, &stats));
+    assert(stats.dropped == 2 && stats.refused == 0);
+
+    /* With both slots held or being written, even this policy refuses */
+    OcularFrame *writing = ofring_acquire(ring);
+    assert(writing != NULL);
+    assert(ofring_acquire(ring) == NULL);
+    ofring_discard(ring, writing);
+    ofring_release(held);
+    ofring_destroy(ring);
+
+    /* Dropping the newest refuses the producer and keeps what was queued */
+    ring = ofring_create(2, 16, 1, OFRAME_DROP_NEWEST);
+    assert(produce(ring, 1) == 1);
+    assert(produce(ring, 2) == 2);
+    assert(produce(ring, 3) == 0);
+    assert(ofring_get_stats(ring, &stats));
+    assert(stats.refused == 1 && stats.dropped == 0);
+    cursor = 0;
+    OcularFrame *frame = ofring_borrow(ring, &cursor, false);
+    assert(frame && frame->data[0] == 1);
+    ofring_release(frame);
+    assert(produce(ring, 3) == 3);
+    ofring_destroy(ring);
+
+    /* With no consumers, frames retire as soon as they are published */
+    ring = ofring_create(2, 16, 0, OFRAME_DROP_NEWEST);
+    for (uint8_t i = 1; i <= 10; i++) {
+        assert(produce(ring, i) == i);
+    }
+    assert(ofring_get_stats(ring, &stats) && stats.retired == 10);
+    ofring_destroy(ring);
+
+    printf("Frame ring drop policy test passed!\n");
+}
+
+/**
+ * @brief Consumer thread for the blocking test
+ */
+static void *blocking_consumer(void *arg) {
+    OcularFrameRing *ring = (OcularFrameRing *)arg;
+    uint64_t cursor = 0;
+    uint64_t expected = 1;
+    while (expected <= 200) {
+        OcularFrame *frame = ofring_borrow(ring, &cursor, false);
+        if (!frame) {
+            continue;
+        }
+        assert(frame->sequence == expected);
+        assert(frame->data[0] == (uint8_t)expected && frame->data[frame->size - 1] == (uint8_t)expected);
+        ofring_release(frame);
+        expected++;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Test that a blocking producer loses nothing
+ */
+static void test_blocking(void) {
+    printf("\nTesting blocking frame ring...\n");
+
+    OcularFrameRing *ring = ofring_create(3, 256, 1, OFRAME_BLOCK);
+    pthread_t consumer;
+    assert(pthread_create(&consumer, NULL, blocking_consumer, ring) == 0);
+    for (uint64_t i = 1; i <= 200; i++) {
+        assert(produce(ring, (uint8_t)i) == i);
+    }
+    pthread_join(consumer, NULL);
+
+    OcularFrameRingStats stats;
+    assert(ofring_get_stats(ring, &stats));
+    assert(stats.published == 200 && stats.retired == 200);
+    assert(stats.dropped == 0 && stats.refused == 0);
+    ofring_destroy(ring);
+
+    printf("Blocking frame ring test passed!\n");
+}
+
+/**
+ * @brief Test handing a frame to the message bus without copying
+ */
+static void test_bus_handoff(void) {
+    printf("\nTesting frame ring message bus handoff...\n");
+
+    OcularFrameRing *ring = ofring_create(2, 64, 1, OFRAME_DROP_NEWEST);
+    assert(produce(ring, 7) == 1);
+
+    uint64_t cursor = 0;
+    OcularFrame *frame = ofring_borrow(ring, &cursor, false);
+    assert(frame != NULL);
+    QMessageBuffer *buffer = qbus_buffer_wrap(frame->data, frame->size, ofring_release_buffer,
+                                              ofring_retain(frame));
+    assert(buffer && qbus_buffer_data(buffer) == frame->data);
+    ofring_release(frame);
+
+    /* The buffer's reference keeps the slot out of reach of the producer */
+    qbus_buffer_retain(buffer);
+    assert(produce(ring, 8) == 2);
+    assert(produce(ring, 9) == 0);
+    qbus_buffer_release(buffer);
+    assert(produce(ring, 9) == 0);
+
+    /* Dropping the last buffer reference frees the slot */
+    qbus_buffer_release(buffer);
+    assert(produce(ring, 9) == 3);
+    assert(produce(ring, 10) == 0);
+
+    OcularFrame *next = ofring_borrow(ring, &cursor, false);
+    assert(next && next->data[0] == 8);
+    ofring_release(next);
+
+    /* Latencies accumulate from acquire through release */
+    OcularFrameRingStats stats;
+    assert(ofring_get_stats(ring, &stats));
+    assert(stats.retired == 2);
+    assert(stats.stage_latency_ns[OFRAME_STAGE_ACQUIRED] == 0);
+    assert(stats.stage_latency_ns[OFRAME_STAGE_PUBLISHED] <= stats.stage_latency_ns[OFRAME_STAGE_BORROWED]);
+    assert(stats.stage_latency_ns[OFRAME_STAGE_BORROWED] <= stats.stage_latency_ns[OFRAME_STAGE_RELEASED]);
+    assert(stats.stage_latency_ns[OFRAME_STAGE_RELEASED] > 0);
+    assert(stats.stage_latency_ns[OFRAME_STAGE_ENHANCED] == 0);
+    ofring_destroy(ring);
+
+    printf("Frame ring message bus handoff test passed!\n");
+}
+
+/**
+ * @brief Main test function
+ */
+int main(void) {
+    printf("Running Ocular Frame Ring tests...\n\n");
+
+    test_borrow();
+    test_drop_policies();
+    test_blocking();
+    test_bus_handoff();
+
+    printf("\nAll Ocular Frame Ring tests passed!\n");
+
+    return 0;
+}
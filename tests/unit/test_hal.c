@@ -3,9 +3,12 @@
  * @brief Unit tests for the Hardware Abstraction Layer
  */
 
+#define _XOPEN_SOURCE 700  /* clock_gettime and nanosleep under -std=c11 */
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <time.h>
 #include "../../src/kernel/hal/hal.h"
 
 /**
@@ -81,6 +84,20 @@ static void test_hal_get_memory_info(void) {
         printf("Entanglement limit: %u regions\n", mem_info.entanglement_limit);
     }
     
+    /* Nodes cover the physical memory without overlapping */
+    assert(mem_info.node_count >= 1 && mem_info.node_count <= HAL_MAX_MEMORY_NODES);
+    uint64_t node_memory = 0;
+    for (uint32_t i = 0; i < mem_info.node_count; i++) {
+        printf("Memory node %u: %llu bytes at 0x%llx, %u CPUs\n", i,
+               (unsigned long long)mem_info.nodes[i].size, (unsigned long long)mem_info.nodes[i].base,
+               mem_info.nodes[i].cpu_count);
+        if (i > 0) {
+            assert(mem_info.nodes[i].base >= mem_info.nodes[i - 1].base + mem_info.nodes[i - 1].size);
+        }
+        node_memory += mem_info.nodes[i].size;
+    }
+    assert(node_memory <= mem_info.total_physical);
+    
     printf("hal_get_memory_info test passed!\n");
 }
 
@@ -100,6 +117,48 @@ static void test_hal_quantum_support(void) {
     printf("hal_has_quantum_support test passed!\n");
 }
 
+/**
+ * @brief Read CLOCK_MONOTONIC in nanoseconds
+ */
+static uint64_t monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Test that timestamps advance with, and stay close to, the system clock
+ */
+static void test_hal_timestamp(void) {
+    printf("\nTesting get_timestamp...\n");
+    
+    const HalOperations* ops = hal_get_operations();
+    assert(ops != NULL);
+    assert(ops->get_timestamp != NULL);
+    
+    uint64_t start = ops->get_timestamp();
+    uint64_t start_system = monotonic_ns();
+    struct timespec pause = { 0, 20000000L };
+    nanosleep(&pause, NULL);
+    uint64_t end = ops->get_timestamp();
+    uint64_t end_system = monotonic_ns();
+    
+    assert(end - start >= 15000000ULL && end - start < 2000000000ULL);
+    int64_t offset = (int64_t)(end - end_system);
+    assert(offset > -5000000LL && offset < 5000000LL);
+    assert(start <= end && start_system <= end_system);
+    
+    uint64_t previous = ops->get_timestamp();
+    for (int i = 0; i < 100000; i++) {
+        uint64_t now = ops->get_timestamp();
+        assert(now >= previous);
+        previous = now;
+    }
+    
+    printf("Timestamp advanced %llu ns over a 20 ms sleep\n", (unsigned long long)(end - start));
+    printf("get_timestamp test passed!\n");
+}
+
 /**
  * @brief Test HAL shutdown
  */
@@ -122,6 +181,7 @@ int main(void) {
     test_hal_get_processor_info();
     test_hal_get_memory_info();
     test_hal_quantum_support();
+    test_hal_timestamp();
     test_hal_shutdown();
     
     printf("\nAll Hardware Abstraction Layer tests passed!\n");
@@ -0,0 +1,426 @@
+/**
+ * @file test_knowledge_graph.c
+ * @brief Unit tests for the Memex Knowledge Graph
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <unistd.h>
+#include "../../src/memex/knowledge/knowledge_graph.h"
+
+#define PERSIST_DIRECTORY "/tmp/ctrlxt_test_knowledge_graph"
+
+/**
+ * @brief Create a node with no description or properties
+ */
+static uint64_t create_node(const char *label, NodeLevel resonance_level) {
+    uint64_t id = kg_create_node(KG_NODE_CONCEPT, label, NULL, NULL, resonance_level);
+    assert(id != 0);
+    return id;
+}
+
+/**
+ * @brief Create a directed relation
+ */
+static uint64_t relate(uint64_t source, uint64_t target, float weight) {
+    uint64_t id = kg_create_relation(source, target, MEMEX_RELATION_PART_OF, false,
+                                     weight, NULL, NODE_ZERO_POINT);
+    assert(id != 0);
+    return id;
+}
+
+/**
+ * @brief Test node storage
+ */
+static void test_nodes(void) {
+    printf("\nTesting knowledge graph nodes...\n");
+
+    uint64_t id = kg_create_node(KG_NODE_ENTITY, "Portal", "A gateway", "{\"size\":2}",
+                                 NODE_PORTAL_TECHNICIAN);
+    assert(id != 0);
+    assert(kg_create_node(KG_NODE_ENTITY, NULL, NULL, NULL, NODE_ZERO_POINT) == 0);
+    assert(kg_create_node(KG_NODE_ENTITY, "Too high", NULL, NULL, NODE_DREAMER) == 0);
+
+    KnowledgeNode *node = kg_get_node(id);
+    assert(node && node->id == id && node->type == KG_NODE_ENTITY);
+    assert(strcmp(node->label, "Portal") == 0 && strcmp(node->description, "A gateway") == 0);
+    kg_free_node(node);
+
+    assert(kg_update_node(id, "Wormhole", NULL, NULL, -1) == true);
+    assert(kg_update_node(id, NULL, NULL, NULL, NODE_DREAMER) == false);
+    node = kg_get_node(id);
+    assert(strcmp(node->label, "Wormhole") == 0 && strcmp(node->description, "A gateway") == 0);
+    assert(node->resonance_level == NODE_PORTAL_TECHNICIAN);
+
+    MemexDataItem *item = kg_node_to_data_item(node);
+    assert(item && item->id == id && item->type == MEMEX_TYPE_KNOWLEDGE_NODE);
+    assert(strcmp(item->name, "Wormhole") == 0 && item->data_size == strlen("A gateway"));
+    memex_free_item(item);
+    kg_free_node(node);
+
+    /* Deleted IDs stay dead after their slot is reused */
+    assert(kg_delete_node(id, false) == true);
+    assert(kg_get_node(id) == NULL);
+    uint64_t reused = create_node("Reused", NODE_ZERO_POINT);
+    assert(reused != id && kg_get_node(id) == NULL);
+    assert(kg_delete_node(reused, false) == true);
+
+    printf("Knowledge graph node test passed!\n");
+}
+
+/**
+ * @brief Test shortest, weighted and depth-limited paths
+ */
+static void test_paths(void) {
+    printf("\nTesting knowledge graph paths...\n");
+
+    /*
+     * a -> b -> c -> d    strong chain (weights 0.9)
+     * a -> d              weak shortcut (weight 0.1)
+     * d -- e              bidirectional
+     */
+    uint64_t a = create_node("a", NODE_ZERO_POINT);
+    uint64_t b = create_node("b", NODE_QUANTUM_GUARDIAN);
+    uint64_t c = create_node("c", NODE_QUANTUM_GUARDIAN);
+    uint64_t d = create_node("d", NODE_QUANTUM_GUARDIAN);
+    uint64_t e = create_node("e", NODE_ZERO_POINT);
+    uint64_t ab = relate(a, b, 0.9f);
+    uint64_t bc = relate(b, c, 0.9f);
+    uint64_t cd = relate(c, d, 0.9f);
+    uint64_t ad = relate(a, d, 0.1f);
+    uint64_t de = kg_create_relation(d, e, MEMEX_RELATION_SIMILAR_TO, true, 1.0f, NULL,
+                                     NODE_ZERO_POINT);
+    assert(de != 0);
+
+    KnowledgePath *path = kg_find_path(a, d, 0, NODE_ZERO_POINT);
+    assert(path && path->length == 1);
+    assert(path->node_ids[0] == a && path->node_ids[1] == d && path->relation_ids[0] == ad);
+    assert(fabsf(path->relevance - 0.1f) < 1e-6f);
+    kg_free_path(path);
+
+    path = kg_find_weighted_path(a, d, 0, NODE_ZERO_POINT);
+    assert(path && path->length == 3);
+    assert(path->node_ids[0] == a && path->node_ids[1] == b && path->node_ids[2] == c &&
+           path->node_ids[3] == d);
+    assert(path->relation_ids[0] == ab && path->relation_ids[1] == bc && path->relation_ids[2] == cd);
+    assert(fabsf(path->relevance - 0.729f) < 1e-5f);
+    kg_free_path(path);
+
+    /* The depth limit forces the weak shortcut */
+    path = kg_find_weighted_path(a, d, 2, NODE_ZERO_POINT);
+    assert(path && path->length == 1 && path->relation_ids[0] == ad);
+    kg_free_path(path);
+
+    /* Directed relations are not walked backwards; bidirectional ones are */
+    assert(kg_find_path(d, a, 0, NODE_ZERO_POINT) == NULL);
+    path = kg_find_path(e, b, 0, NODE_ZERO_POINT);
+    assert(path == NULL);
+    path = kg_find_path(e, d, 0, NODE_ZERO_POINT);
+    assert(path && path->length == 1 && path->relation_ids[0] == de);
+    kg_free_path(path);
+    path = kg_find_path(a, e, 0, NODE_ZERO_POINT);
+    assert(path && path->length == 2 && path->node_ids[1] == d);
+    kg_free_path(path);
+    assert(kg_find_path(a, e, 1, NODE_ZERO_POINT) == NULL);
+
+    /* Resonance floors apply to every node and relation on the path */
+    assert(kg_find_path(a, d, 0, NODE_QUANTUM_GUARDIAN) == NULL);
+    assert(kg_find_path(b, d, 0, NODE_QUANTUM_GUARDIAN) == NULL);
+    path = kg_find_path(b, d, 0, NODE_ZERO_POINT);
+    assert(path && path->length == 2);
+    kg_free_path(path);
+
+    path = kg_find_path(c, c, 0, NODE_ZERO_POINT);
+    assert(path && path->length == 0 && path->node_ids[0] == c);
+    kg_free_path(path);
+
+    /* Related nodes, in either direction and once each */
+    uint32_t count = 0;
+    uint64_t *related = kg_find_related_nodes(d, MEMEX_RELATION_UNDEFINED, 0, &count);
+    assert(related && count == 3);
+    free(related);
+    related = kg_find_related_nodes(d, MEMEX_RELATION_SIMILAR_TO, 0, &count);
+    assert(related && count == 1 && related[0] == e);
+    free(related);
+    relate(a, d, 0.5f);
+    related = kg_find_related_nodes(a, MEMEX_RELATION_UNDEFINED, 0, &count);
+    assert(related && count == 2);
+    free(related);
+
+    /* Deleting a node needs its relations gone */
+    assert(kg_delete_node(c, false) == false);
+    assert(kg_delete_node(c, true) == true);
+    path = kg_find_weighted_path(a, d, 0, NODE_ZERO_POINT);
+    assert(path && path->length == 1);
+    kg_free_path(path);
+    related = kg_find_related_nodes(b, MEMEX_RELATION_UNDEFINED, 0, &count);
+    assert(related && count == 1 && related[0] == a);
+    free(related);
+
+    uint64_t bd = kg_create_relation(b, d, MEMEX_RELATION_CAUSES, false, 0.5f, NULL,
+                                     NODE_QUANTUM_GUARDIAN);
+    assert(bd != 0);
+    path = kg_find_path(b, d, 0, NODE_QUANTUM_GUARDIAN);
+    assert(path && path->length == 1 && path->relation_ids[0] == bd);
+    kg_free_path(path);
+
+    printf("Knowledge graph path test passed!\n");
+}
+
+/**
+ * @brief Test query-guided reasoning and entangled pairs
+ */
+static void test_reasoning(void) {
+    printf("\nTesting knowledge graph reasoning...\n");
+
+    uint64_t root = create_node("Reactor", NODE_ZERO_POINT);
+    uint64_t coil = kg_create_node(KG_NODE_ENTITY, "Flux coil", "Stabilizes the quantum field",
+                                   NULL, NODE_ZERO_POINT);
+    uint64_t shield = kg_create_node(KG_NODE_ENTITY, "Shield", "Quantum barrier", NULL,
+                                     NODE_ZERO_POINT);
+    uint64_t field = create_node("Quantum field", NODE_ZERO_POINT);
+    uint64_t far = create_node("Quantum far", NODE_ZERO_POINT);
+    uint64_t chain[3];
+    relate(root, coil, 1.0f);
+    relate(root, shield, 0.5f);
+    relate(coil, field, 1.0f);
+    chain[0] = create_node("hop", NODE_ZERO_POINT);
+    chain[1] = create_node("hop", NODE_ZERO_POINT);
+    chain[2] = create_node("hop", NODE_ZERO_POINT);
+    relate(root, chain[0], 1.0f);
+    relate(chain[0], chain[1], 1.0f);
+    relate(chain[1], chain[2], 1.0f);
+    relate(chain[2], far, 1.0f);
+
+    uint32_t count = 0;
+    uint64_t *results = kg_semantic_reasoning(root, "quantum FIELD", 10, &count);
+    assert(results && count == 3);
+    assert(results[0] == coil || results[0] == field);
+    assert(results[1] == coil || results[1] == field);
+    assert(results[2] == shield);
+    free(results);
+
+    results = kg_semantic_reasoning(root, "quantum", 1, &count);
+    assert(results && count == 1 && (results[0] == coil || results[0] == field));
+    free(results);
+    assert(kg_semantic_reasoning(root, "tachyon", 10, &count) == NULL && count == 0);
+
+    uint64_t first = 0;
+    uint64_t second = 0;
+    uint64_t entanglement = kg_create_entangled_nodes("Alice", "Bob", "Bell pair",
+                                                      NODE_ZERO_POINT, &first, &second);
+    assert(entanglement != 0 && first != 0 && second != 0);
+    KnowledgePath *path = kg_find_path(second, first, 0, NODE_ZERO_POINT);
+    assert(path && path->length == 1 && path->relation_ids[0] == entanglement);
+    kg_free_path(path);
+
+    printf("Knowledge graph reasoning test passed!\n");
+}
+
+/**
+ * @brief Test graph-wide similarity search and set embeddings
+ */
+static void test_similarity(void) {
+    printf("\nTesting knowledge graph similarity search...\n");
+
+    uint64_t lens = kg_create_node(KG_NODE_ENTITY, "Ocular lens", "Focuses photon streams", NULL,
+                                   NODE_ZERO_POINT);
+    uint64_t prism = kg_create_node(KG_NODE_CONCEPT, "Photon prism", NULL, NULL, NODE_QUANTUM_GUARDIAN);
+    uint64_t anchor = kg_create_node(KG_NODE_EVENT, "Anchor drop", NULL, NULL, NODE_ZERO_POINT);
+    assert(lens && prism && anchor);
+
+    uint32_t count = 0;
+    uint64_t *results = kg_find_similar_nodes("photon", NULL, NODE_ZERO_POINT, 0, 10, &count);
+    assert(results && count == 2);
+    assert(results[0] == prism && results[1] == lens);
+    free(results);
+
+    /* Resonance and type filters */
+    results = kg_find_similar_nodes("photon", NULL, NODE_QUANTUM_GUARDIAN, 0, 10, &count);
+    assert(results && count == 1 && results[0] == prism);
+    free(results);
+    results = kg_find_similar_nodes("photon", NULL, NODE_ZERO_POINT, 1u << KG_NODE_ENTITY, 10, &count);
+    assert(results && count == 1 && results[0] == lens);
+    free(results);
+    assert(kg_find_similar_nodes("tachyon", NULL, NODE_ZERO_POINT, 0, 10, &count) == NULL && count == 0);
+
+    /* A set embedding replaces the text one until cleared */
+    static float embedding[KG_EMBEDDING_DIMENSIONS];
+    embedding[3] = 1.0f;
+    assert(kg_set_node_embedding(anchor, embedding, KG_EMBEDDING_DIMENSIONS) == true);
+    assert(kg_set_node_embedding(anchor, embedding, 3) == false);
+    assert(kg_set_node_embedding(0, embedding, KG_EMBEDDING_DIMENSIONS) == false);
+    results = kg_find_similar_nodes(NULL, embedding, NODE_ZERO_POINT, 0, 1, &count);
+    assert(results && count == 1 && results[0] == anchor);
+    free(results);
+    assert(kg_update_node(anchor, "Anchor raise", NULL, NULL, -1) == true);
+    assert(kg_find_similar_nodes("anchor", NULL, NODE_ZERO_POINT, 1u << KG_NODE_EVENT, 10, &count) == NULL);
+
+    /* All-zero embeddings are rejected and leave the set one in place */
+    static float zero[KG_EMBEDDING_DIMENSIONS];
+    assert(kg_set_node_embedding(anchor, zero, KG_EMBEDDING_DIMENSIONS) == false);
+    results = kg_find_similar_nodes(NULL, embedding, NODE_ZERO_POINT, 0, 1, &count);
+    assert(results && results[0] == anchor);
+    free(results);
+
+    assert(kg_set_node_embedding(anchor, NULL, 0) == true);
+    results = kg_find_similar_nodes("anchor", NULL, NODE_ZERO_POINT, 0, 10, &count);
+    assert(results && count == 1 && results[0] == anchor);
+    free(results);
+
+    /* Deleted nodes drop out */
+    assert(kg_delete_node(prism, false) == true);
+    results = kg_find_similar_nodes("photon", NULL, NODE_ZERO_POINT, 0, 10, &count);
+    assert(results && count == 1 && results[0] == lens);
+    free(results);
+
+    printf("Knowledge graph similarity search test passed!\n");
+}
+
+/**
+ * @brief Test a path query whose frontiers are large enough to expand in parallel
+ */
+static void test_wide_graph(void) {
+    printf("\nTesting wide knowledge graph...\n");
+
+    enum { WIDTH = 6000 };
+    uint64_t source = create_node("source", NODE_ZERO_POINT);
+    uint64_t sink = create_node("sink", NODE_ZERO_POINT);
+    static uint64_t left[WIDTH];
+    static uint64_t right[WIDTH];
+    for (int i = 0; i < WIDTH; i++) {
+        left[i] = create_node("left", NODE_ZERO_POINT);
+        right[i] = create_node("right", NODE_ZERO_POINT);
+        relate(source, left[i], 0.5f);
+        relate(right[i], sink, 0.5f);
+    }
+
+    /* Only one left node reaches the right side */
+    relate(left[WIDTH / 2], right[WIDTH / 3], 0.5f);
+
+    KnowledgePath *path = kg_find_path(source, sink, 0, NODE_ZERO_POINT);
+    assert(path && path->length == 3);
+    assert(path->node_ids[0] == source && path->node_ids[1] == left[WIDTH / 2] &&
+           path->node_ids[2] == right[WIDTH / 3] && path->node_ids[3] == sink);
+    kg_free_path(path);
+    assert(kg_find_path(source, sink, 2, NODE_ZERO_POINT) == NULL);
+
+    path = kg_find_weighted_path(source, sink, 3, NODE_ZERO_POINT);
+    assert(path && path->length == 3 && fabsf(path->relevance - 0.125f) < 1e-6f);
+    kg_free_path(path);
+
+    printf("Wide knowledge graph test passed!\n");
+}
+
+/**
+ * @brief Remove the persistence test's files
+ */
+static void remove_store_files(void) {
+    remove(PERSIST_DIRECTORY "/knowledge_graph.wal");
+    remove(PERSIST_DIRECTORY "/knowledge_graph.snap");
+    rmdir(PERSIST_DIRECTORY);
+}
+
+/**
+ * @brief Test that the graph survives a restart, from the log and from a snapshot
+ */
+static void test_persistence(void) {
+    printf("\nTesting knowledge graph persistence...\n");
+
+    remove_store_files();
+    assert(kg_init(PERSIST_DIRECTORY, true, NODE_COSMIC_AI) == true);
+    uint64_t a = kg_create_node(KG_NODE_ENTITY, "Alpha", "First", "{\"x\":1}", NODE_ZERO_POINT);
+    uint64_t b = create_node("Beta", NODE_QUANTUM_GUARDIAN);
+    uint64_t gone = create_node("Gone", NODE_ZERO_POINT);
+    uint64_t ab = kg_create_relation(a, b, MEMEX_RELATION_CAUSES, true, 0.75f, "{\"y\":2}",
+                                     NODE_ZERO_POINT);
+    assert(a && b && gone && ab);
+    relate(gone, a, 0.5f);
+    uint64_t c = create_node("Gamma", NODE_ZERO_POINT);
+    static float embedding[KG_EMBEDDING_DIMENSIONS];
+    embedding[7] = 0.5f;
+    assert(kg_set_node_embedding(c, embedding, KG_EMBEDDING_DIMENSIONS) == true);
+
+    /* Later changes go to the log until shutdown compacts them */
+    assert(kg_checkpoint() == true);
+    assert(kg_update_node(b, "Beta prime", NULL, NULL, -1) == true);
+    assert(kg_delete_node(gone, true) == true);
+    uint64_t bc = relate(b, c, 0.5f);
+    embedding[7] = 0.0f;
+    embedding[9] = 2.0f;
+    assert(kg_set_node_embedding(a, embedding, KG_EMBEDDING_DIMENSIONS) == true);
+    kg_shutdown();
+
+    for (int restart = 0; restart < 2; restart++) {
+        assert(kg_init(PERSIST_DIRECTORY, true, NODE_COSMIC_AI) == true);
+        KnowledgeNode *node = kg_get_node(a);
+        assert(node && node->type == KG_NODE_ENTITY && strcmp(node->label, "Alpha") == 0);
+        assert(strcmp(node->description, "First") == 0 && strcmp(node->properties, "{\"x\":1}") == 0);
+        kg_free_node(node);
+        node = kg_get_node(b);
+        assert(node && strcmp(node->label, "Beta prime") == 0 && node->description == NULL);
+        assert(node->resonance_level == NODE_QUANTUM_GUARDIAN);
+        kg_free_node(node);
+        assert(kg_get_node(gone) == NULL);
+
+        /* Text embeddings are rebuilt and set ones restored */
+        uint32_t count = 0;
+        uint64_t *similar = kg_find_similar_nodes("prime", NULL, NODE_ZERO_POINT, 0, 10, &count);
+        assert(similar && count == 1 && similar[0] == b);
+        free(similar);
+        similar = kg_find_similar_nodes(NULL, embedding, NODE_ZERO_POINT, 0, 10, &count);
+        assert(similar && count == 1 && similar[0] == a);
+        free(similar);
+        float gamma[KG_EMBEDDING_DIMENSIONS] = { 0 };
+        gamma[7] = 1.0f;
+        similar = kg_find_similar_nodes(NULL, gamma, NODE_ZERO_POINT, 0, 10, &count);
+        assert(similar && count == 1 && similar[0] == c);
+        free(similar);
+
+        KnowledgePath *path = kg_find_path(c, a, 0, NODE_ZERO_POINT);
+        assert(path == NULL);
+        path = kg_find_path(a, c, 0, NODE_ZERO_POINT);
+        assert(path && path->length == 2 && path->relation_ids[0] == ab && path->relation_ids[1] == bc);
+        assert(fabsf(path->relevance - 0.375f) < 1e-6f);
+        kg_free_path(path);
+        path = kg_find_path(b, a, 0, NODE_ZERO_POINT);
+        assert(path && path->length == 1);
+        kg_free_path(path);
+
+        /* The deleted node's slot is reused under a new ID */
+        uint64_t reused = create_node("Reused", NODE_ZERO_POINT);
+        assert(reused != gone && (uint32_t)reused == (uint32_t)gone);
+        assert(kg_delete_node(reused, false) == true);
+        kg_shutdown();
+    }
+
+    remove_store_files();
+    printf("Knowledge graph persistence test passed!\n");
+}
+
+/**
+ * @brief Main test function
+ */
+int main(void) {
+    printf("Running Memex Knowledge Graph tests...\n\n");
+
+    assert(kg_init(NULL, true, NODE_COSMIC_AI) == true);
+    assert(kg_init(NULL, true, NODE_COSMIC_AI) == false);
+
+    test_nodes();
+    test_paths();
+    test_reasoning();
+    test_similarity();
+    test_wide_graph();
+
+    kg_shutdown();
+
+    test_persistence();
+
+    printf("\nAll Memex Knowledge Graph tests passed!\n");
+
+    return 0;
+}
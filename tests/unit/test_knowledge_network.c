@@ -0,0 +1,288 @@
+/**
+ * @file test_knowledge_network.c
+ * @brief Unit tests for the Memex Knowledge Network
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "../../src/memex/knowledge/knowledge_network.h"
+#include "../../src/memex/search/search_engine.h"
+
+/**
+ * @brief Whether a result array contains a node ID
+ */
+static bool contains_node(const KnowledgeNode *nodes, uint32_t count, uint64_t id) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (nodes[i].id == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Test relation creation and neighbour lookups
+ */
+static void test_related_nodes(void) {
+    printf("\nTesting related node lookups...\n");
+
+    assert(memex_knowledge_init(false) == true);
+
+    KnowledgeNode portal = memex_knowledge_create_node(NODE_CONCEPT, "Portal", NULL, false);
+    KnowledgeNode gun = memex_knowledge_create_node(NODE_RESOURCE, "Portal gun", "Device", false);
+    KnowledgeNode physics = memex_knowledge_create_node(NODE_CONCEPT, "Physics", NULL, false);
+    assert(portal.id != 0 && gun.id != 0 && physics.id != 0);
+
+    assert(memex_knowledge_create_relation(RELATION_PART_OF, gun.id, portal.id, 0.9f, false).id != 0);
+    assert(memex_knowledge_create_relation(RELATION_IS_A, portal.id, physics.id, 1.5f, false).id != 0);
+    assert(memex_knowledge_create_relation(RELATION_CAUSES, gun.id, portal.id, 0.5f, false).id != 0);
+
+    /* Duplicates, self-relations and unknown nodes are rejected */
+    assert(memex_knowledge_create_relation(RELATION_PART_OF, gun.id, portal.id, 0.1f, false).id == 0);
+    assert(memex_knowledge_create_relation(RELATION_IS_A, gun.id, gun.id, 0.1f, false).id == 0);
+    assert(memex_knowledge_create_relation(RELATION_IS_A, gun.id, 999, 0.1f, false).id == 0);
+
+    /* Every relation is followed from both ends */
+    uint32_t count = 0;
+    KnowledgeNode *related = memex_knowledge_get_related(portal.id, -1, 10, &count);
+    assert(related && count == 3);
+    assert(contains_node(related, count, gun.id) && contains_node(related, count, physics.id));
+    free(related);
+
+    related = memex_knowledge_get_related(portal.id, RELATION_IS_A, 10, &count);
+    assert(related && count == 1 && related[0].id == physics.id);
+    free(related);
+    related = memex_knowledge_get_related(physics.id, RELATION_IS_A, 10, &count);
+    assert(related && count == 1 && related[0].id == portal.id);
+    free(related);
+    assert(memex_knowledge_get_related(physics.id, RELATION_CAUSES, 10, &count) == NULL && count == 0);
+
+    related = memex_knowledge_get_related(gun.id, -1, 1, &count);
+    assert(related && count == 1 && related[0].id == portal.id);
+    free(related);
+    assert(memex_knowledge_get_related(999, -1, 10, &count) == NULL);
+
+    memex_knowledge_shutdown();
+
+    printf("Related node lookup test passed!\n");
+}
+
+/**
+ * @brief Test lookups on a densely connected network
+ */
+static void test_dense_network(void) {
+    printf("\nTesting dense network...\n");
+
+    assert(memex_knowledge_init(false) == true);
+
+    enum { NODE_COUNT = 100 };
+    uint64_t ids[NODE_COUNT];
+    char name[32];
+    for (int i = 0; i < NODE_COUNT; i++) {
+        snprintf(name, sizeof(name), "Node %d", i);
+        ids[i] = memex_knowledge_create_node(NODE_ENTITY, name, NULL, false).id;
+        assert(ids[i] != 0);
+    }
+
+    /* Ring plus chords: every node links to the next four */
+    for (int i = 0; i < NODE_COUNT; i++) {
+        for (int step = 1; step <= 4; step++) {
+            KnowledgeRelationType type = step == 1 ? RELATION_RELATED_TO : RELATION_CAUSES;
+            assert(memex_knowledge_create_relation(type, ids[i], ids[(i + step) % NODE_COUNT],
+                                                   0.5f, false).id != 0);
+        }
+    }
+
+    uint32_t count = 0;
+    KnowledgeNode *related = memex_knowledge_get_related(ids[50], -1, 100, &count);
+    assert(related && count == 8);
+    free(related);
+    related = memex_knowledge_get_related(ids[50], RELATION_RELATED_TO, 100, &count);
+    assert(related && count == 2);
+    assert(contains_node(related, count, ids[49]) && contains_node(related, count, ids[51]));
+    free(related);
+
+    memex_knowledge_shutdown();
+
+    printf("Dense network test passed!\n");
+}
+
+#define CONCURRENT_WRITERS 4
+#define CONCURRENT_NODES 50
+
+static uint64_t hub_id;
+static atomic_bool writers_done;
+
+/**
+ * @brief Create nodes, each linked to the hub and to its predecessor
+ */
+static void *concurrent_writer(void *argument) {
+    int writer = *(const int *)argument;
+    char name[32];
+    uint64_t previous = 0;
+    for (int i = 0; i < CONCURRENT_NODES; i++) {
+        snprintf(name, sizeof(name), "Writer %d node %d", writer, i);
+        uint64_t id = memex_knowledge_create_node(NODE_ENTITY, name, NULL, false).id;
+        assert(id != 0);
+        assert(memex_knowledge_create_relation(RELATION_PART_OF, id, hub_id, 0.5f, false).id != 0);
+        if (previous != 0) {
+            assert(memex_knowledge_create_relation(RELATION_CAUSES, previous, id, 0.5f, false).id != 0);
+        }
+        previous = id;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Walk the hub and search names until the writers finish
+ */
+static void *concurrent_reader(void *argument) {
+    (void)argument;
+    while (!atomic_load(&writers_done)) {
+        uint32_t count = 0;
+        KnowledgeNode *related = memex_knowledge_get_related(hub_id, RELATION_PART_OF, 1000, &count);
+        for (uint32_t i = 0; i < count; i++) {
+            assert(related[i].id != 0 && strncmp(related[i].name, "Writer", 6) == 0);
+        }
+        free(related);
+        free(memex_knowledge_find_nodes("node 1", 1000, &count));
+    }
+    return NULL;
+}
+
+/**
+ * @brief Test concurrent node and relation creation against readers
+ */
+static void test_concurrent_access(void) {
+    printf("\nTesting concurrent access...\n");
+
+    assert(memex_knowledge_init(false) == true);
+    hub_id = memex_knowledge_create_node(NODE_CONCEPT, "Hub", NULL, false).id;
+    assert(hub_id != 0);
+
+    pthread_t writers[CONCURRENT_WRITERS];
+    pthread_t readers[2];
+    int writer_numbers[CONCURRENT_WRITERS];
+    atomic_store(&writers_done, false);
+    for (int i = 0; i < 2; i++) {
+        assert(pthread_create(&readers[i], NULL, concurrent_reader, NULL) == 0);
+    }
+    for (int i = 0; i < CONCURRENT_WRITERS; i++) {
+        writer_numbers[i] = i;
+        assert(pthread_create(&writers[i], NULL, concurrent_writer, &writer_numbers[i]) == 0);
+    }
+    for (int i = 0; i < CONCURRENT_WRITERS; i++) {
+        pthread_join(writers[i], NULL);
+    }
+    atomic_store(&writers_done, true);
+    for (int i = 0; i < 2; i++) {
+        pthread_join(readers[i], NULL);
+    }
+
+    /* Every node reached the hub, and the chains stayed intact */
+    uint32_t count = 0;
+    KnowledgeNode *related = memex_knowledge_get_related(hub_id, -1, 1000, &count);
+    assert(related && count == CONCURRENT_WRITERS * CONCURRENT_NODES);
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t neighbours = 0;
+        KnowledgeNode *chain = memex_knowledge_get_related(related[i].id, RELATION_CAUSES, 10, &neighbours);
+        assert(neighbours == 1 || neighbours == 2);
+        free(chain);
+    }
+    free(related);
+
+    memex_knowledge_shutdown();
+
+    printf("Concurrent access test passed!\n");
+}
+
+/**
+ * @brief Test batch creation of nodes and relations
+ */
+static void test_bulk_ingest(void) {
+    printf("\nTesting bulk ingest...\n");
+
+    assert(memex_knowledge_init(false) == true);
+
+    enum { BULK_NODES = 200 };
+    static char names[BULK_NODES][32];
+    KnowledgeNodeSpec nodes[BULK_NODES + 2];
+    for (int i = 0; i < BULK_NODES; i++) {
+        snprintf(names[i], sizeof(names[i]), "Bulk %d", i);
+        nodes[i] = (KnowledgeNodeSpec){ NODE_ENTITY, names[i], NULL, false };
+    }
+    nodes[BULK_NODES] = nodes[7];
+    nodes[BULK_NODES + 1] = (KnowledgeNodeSpec){ NODE_ENTITY, NULL, NULL, false };
+
+    uint64_t node_ids[BULK_NODES + 2];
+    KnowledgeIngestStats stats;
+    assert(memex_knowledge_create_nodes(nodes, BULK_NODES + 2, node_ids, &stats) == BULK_NODES);
+    assert(stats.submitted == BULK_NODES + 2 && stats.created == BULK_NODES);
+    assert(stats.duplicates == 1 && stats.rejected == 1);
+    assert(node_ids[BULK_NODES] == node_ids[7] && node_ids[BULK_NODES + 1] == 0);
+
+    /* Batch nodes are found like individually created ones */
+    uint32_t count = 0;
+    KnowledgeNode *found = memex_knowledge_find_nodes("Bulk", BULK_NODES, &count);
+    assert(found && count > 0);
+    free(found);
+
+    /* A chain, one relation that already exists, one repeat and one bad end */
+    uint64_t existing = memex_knowledge_create_relation(RELATION_CAUSES, node_ids[0], node_ids[1],
+                                                        0.5f, false).id;
+    assert(existing != 0);
+    KnowledgeRelationSpec relations[BULK_NODES + 2];
+    for (int i = 0; i < BULK_NODES - 1; i++) {
+        relations[i] = (KnowledgeRelationSpec){ RELATION_CAUSES, node_ids[i], node_ids[i + 1], 0.5f, false };
+    }
+    relations[BULK_NODES - 1] = relations[5];
+    relations[BULK_NODES] = (KnowledgeRelationSpec){ RELATION_CAUSES, node_ids[3], node_ids[3], 0.5f, false };
+    relations[BULK_NODES + 1] = (KnowledgeRelationSpec){ RELATION_CAUSES, node_ids[3], 999999, 0.5f, false };
+
+    uint64_t relation_ids[BULK_NODES + 2];
+    assert(memex_knowledge_create_relations(relations, BULK_NODES + 2, relation_ids, &stats) ==
+           BULK_NODES - 2);
+    assert(stats.created == BULK_NODES - 2 && stats.duplicates == 2 && stats.rejected == 2);
+    assert(relation_ids[0] == existing && relation_ids[BULK_NODES - 1] == relation_ids[5]);
+    assert(relation_ids[BULK_NODES] == 0 && relation_ids[BULK_NODES + 1] == 0);
+
+    /* Interior chain nodes see both neighbours */
+    for (int i = 1; i < BULK_NODES - 1; i++) {
+        KnowledgeNode *related = memex_knowledge_get_related(node_ids[i], RELATION_CAUSES, 10, &count);
+        assert(related && count == 2);
+        assert(contains_node(related, count, node_ids[i - 1]) && contains_node(related, count, node_ids[i + 1]));
+        free(related);
+    }
+
+    /* Repeating the whole batch adds nothing */
+    assert(memex_knowledge_create_relations(relations, BULK_NODES - 1, NULL, &stats) == 0);
+    assert(stats.duplicates == BULK_NODES - 1);
+
+    memex_knowledge_shutdown();
+
+    printf("Bulk ingest test passed!\n");
+}
+
+/**
+ * @brief Main test function
+ */
+int main(void) {
+    printf("Running Memex Knowledge Network tests...\n\n");
+
+    assert(memex_search_init() == true);
+
+    test_related_nodes();
+    test_dense_network();
+    test_concurrent_access();
+    test_bulk_ingest();
+
+    memex_search_shutdown();
+
+    printf("\nAll Memex Knowledge Network tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,352 @@
+/**
+ * @file test_knowledge_store.c
+ * @brief Unit tests for the Memex knowledge store
+ */
+
+/* ftruncate under -std=c11 */
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../../src/memex/storage/knowledge_store.h"
+
+#define STORE_DIRECTORY "/tmp/ctrlxt_test_knowledge_store"
+#define LOG_PATH STORE_DIRECTORY "/test.wal"
+#define SNAPSHOT_PATH STORE_DIRECTORY "/test.snap"
+#define MAX_RECORDS 64
+
+/**
+ * @brief Records seen by a replay, applied in order
+ */
+typedef struct {
+    uint64_t ids[MAX_RECORDS];
+    char values[MAX_RECORDS][32];
+    uint32_t count;
+    uint32_t puts;
+    uint32_t deletes;
+} Replayed;
+
+/**
+ * @brief Replay callback applying puts and deletes to a Replayed
+ */
+static bool replay(KnowledgeStoreOp op, const KnowledgeStoreRecord *record, void *context) {
+    Replayed *replayed = (Replayed *)context;
+    uint32_t index = 0;
+    while (index < replayed->count && replayed->ids[index] != record->id) {
+        index++;
+    }
+
+    if (op == KSTORE_OP_DELETE) {
+        replayed->deletes++;
+        if (index < replayed->count) {
+            replayed->count--;
+            replayed->ids[index] = replayed->ids[replayed->count];
+            memcpy(replayed->values[index], replayed->values[replayed->count], 32);
+        }
+        return true;
+    }
+
+    replayed->puts++;
+    KnowledgeStoreReader reader;
+    kstore_reader_init(&reader, record);
+    char *value = NULL;
+    assert(kstore_read_string(&reader, &value) && value);
+    assert(kstore_read_u32(&reader) == (uint32_t)record->id * 3);
+    assert(!reader.failed && reader.offset == reader.size);
+    if (index == replayed->count) {
+        assert(replayed->count < MAX_RECORDS);
+        replayed->ids[replayed->count++] = record->id;
+    }
+    snprintf(replayed->values[index], 32, "%s", value);
+    free(value);
+    return true;
+}
+
+/**
+ * @brief Look up a replayed value
+ */
+static const char *replayed_value(const Replayed *replayed, uint64_t id) {
+    for (uint32_t i = 0; i < replayed->count; i++) {
+        if (replayed->ids[i] == id) {
+            return replayed->values[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Encode a test record
+ */
+static void encode(KnowledgeStoreBuffer *buffer, uint64_t id, const char *value) {
+    kstore_buffer_reset(buffer);
+    kstore_buffer_put_string(buffer, value);
+    kstore_buffer_put_u32(buffer, (uint32_t)id * 3);
+    assert(!buffer->failed);
+}
+
+/**
+ * @brief Append a test record to the log
+ */
+static void put(KnowledgeStore *store, KnowledgeStoreBuffer *buffer, uint64_t id, const char *value) {
+    encode(buffer, id, value);
+    assert(kstore_put(store, 1, id, buffer->data, (uint32_t)buffer->size) == true);
+}
+
+/**
+ * @brief Open a store and replay it
+ */
+static KnowledgeStore *open_store(Replayed *replayed) {
+    memset(replayed, 0, sizeof(*replayed));
+    KnowledgeStore *store = kstore_open(STORE_DIRECTORY, "test", false);
+    assert(store != NULL);
+    assert(kstore_load(store, replay, replayed) == true);
+    return store;
+}
+
+/**
+ * @brief Size of a file
+ */
+static long file_size(const char *path) {
+    struct stat info;
+    return stat(path, &info) == 0 ? (long)info.st_size : -1;
+}
+
+/**
+ * @brief Remove the test's files
+ */
+static void remove_store_files(void) {
+    remove(LOG_PATH);
+    remove(SNAPSHOT_PATH);
+    remove(SNAPSHOT_PATH ".tmp");
+    rmdir(STORE_DIRECTORY);
+}
+
+/**
+ * @brief Test replaying puts and deletes from the log
+ */
+static void test_log_replay(void) {
+    printf("\nTesting knowledge store log replay...\n");
+
+    remove_store_files();
+    KnowledgeStoreBuffer buffer = { 0 };
+    Replayed replayed;
+    KnowledgeStore *store = open_store(&replayed);
+    assert(replayed.count == 0);
+
+    put(store, &buffer, 1, "one");
+    put(store, &buffer, 2, "two");
+    put(store, &buffer, 3, "three");
+    put(store, &buffer, 2, "deux");
+    assert(kstore_delete(store, 1, 3) == true);
+    assert(kstore_snapshot_find(store, 1, 1, NULL) == NULL);
+    kstore_close(store);
+
+    store = open_store(&replayed);
+    assert(replayed.puts == 4 && replayed.deletes == 1 && replayed.count == 2);
+    assert(strcmp(replayed_value(&replayed, 1), "one") == 0);
+    assert(strcmp(replayed_value(&replayed, 2), "deux") == 0);
+    kstore_close(store);
+
+    /* Writing before loading is refused */
+    store = kstore_open(STORE_DIRECTORY, "test", false);
+    encode(&buffer, 9, "early");
+    assert(kstore_put(store, 1, 9, buffer.data, (uint32_t)buffer.size) == false);
+    kstore_close(store);
+
+    kstore_buffer_free(&buffer);
+    printf("Knowledge store log replay test passed!\n");
+}
+
+/**
+ * @brief Test that a torn or damaged log tail is cut off
+ */
+static void test_torn_tail(void) {
+    printf("\nTesting knowledge store torn log tail...\n");
+
+    KnowledgeStoreBuffer buffer = { 0 };
+    Replayed replayed;
+    KnowledgeStore *store = open_store(&replayed);
+    long good_size = file_size(LOG_PATH);
+    put(store, &buffer, 4, "four");
+    kstore_close(store);
+
+    /* Lose the last byte of the record, as a crash mid-append would */
+    assert(truncate(LOG_PATH, file_size(LOG_PATH) - 1) == 0);
+    store = open_store(&replayed);
+    assert(replayed.count == 2 && replayed_value(&replayed, 4) == NULL);
+    assert(file_size(LOG_PATH) == good_size);
+
+    /* Appends after the cut replay normally */
+    put(store, &buffer, 4, "quatre");
+    kstore_close(store);
+
+    /* A flipped payload byte fails the CRC */
+    FILE *file = fopen(LOG_PATH, "r+b");
+    assert(file && fseek(file, -2, SEEK_END) == 0);
+    fputc(0x5A, file);
+    fclose(file);
+    store = open_store(&replayed);
+    assert(replayed.count == 2 && replayed_value(&replayed, 4) == NULL);
+    put(store, &buffer, 4, "vier");
+    kstore_close(store);
+
+    store = open_store(&replayed);
+    assert(replayed.count == 3 && strcmp(replayed_value(&replayed, 4), "vier") == 0);
+    long last_good_size = file_size(LOG_PATH);
+    put(store, &buffer, 5, "five");
+    kstore_close(store);
+
+    /* A damaged size field is cut off before anything is allocated for it */
+    uint32_t damaged_size = 0xFFFFFFF0u;
+    file = fopen(LOG_PATH, "r+b");
+    assert(file && fseek(file, last_good_size, SEEK_SET) == 0);
+    assert(fwrite(&damaged_size, sizeof(damaged_size), 1, file) == 1);
+    fclose(file);
+    store = open_store(&replayed);
+    assert(replayed.count == 3 && replayed_value(&replayed, 5) == NULL);
+    assert(file_size(LOG_PATH) == last_good_size);
+    kstore_close(store);
+
+    kstore_buffer_free(&buffer);
+    printf("Knowledge store torn log tail test passed!\n");
+}
+
+/**
+ * @brief Replay callback that skips records of other kinds
+ */
+static bool replay_kind_one(KnowledgeStoreOp op, const KnowledgeStoreRecord *record, void *context) {
+    if (record->kind != 1) {
+        return true;
+    }
+    return replay(op, record, context);
+}
+
+/**
+ * @brief Test compaction into a mapped snapshot
+ */
+static void test_snapshot(void) {
+    printf("\nTesting knowledge store snapshots...\n");
+
+    KnowledgeStoreBuffer buffer = { 0 };
+    Replayed replayed;
+    KnowledgeStore *store = open_store(&replayed);
+    assert(replayed.count == 3);
+    assert(kstore_should_compact(store) == false);
+
+    /* Compact the live records, added out of order */
+    assert(kstore_begin_snapshot(store) == true);
+    for (int i = (int)replayed.count - 1; i >= 0; i--) {
+        encode(&buffer, replayed.ids[i], replayed.values[i]);
+        assert(kstore_snapshot_add(store, 1, replayed.ids[i], buffer.data, (uint32_t)buffer.size));
+    }
+    assert(kstore_snapshot_add(store, 2, 1, "x", 1) == true);
+    assert(kstore_end_snapshot(store, true) == true);
+    assert(file_size(SNAPSHOT_PATH) > 0);
+
+    /* Records are readable in place */
+    uint32_t size = 0;
+    const void *data = kstore_snapshot_find(store, 1, 2, &size);
+    assert(data && ((uintptr_t)data % 8) == 0);
+    KnowledgeStoreRecord record = { 1, 2, data, size };
+    KnowledgeStoreReader reader;
+    kstore_reader_init(&reader, &record);
+    char *value = NULL;
+    assert(kstore_read_string(&reader, &value) && strcmp(value, "deux") == 0);
+    free(value);
+    assert(kstore_snapshot_find(store, 1, 3, NULL) == NULL);
+    assert(kstore_snapshot_find(store, 2, 1, &size) && size == 1);
+
+    put(store, &buffer, 5, "five");
+    assert(kstore_delete(store, 1, 1) == true);
+    kstore_close(store);
+
+    /* A discarded snapshot leaves the published one in place */
+    long published = file_size(SNAPSHOT_PATH);
+    store = kstore_open(STORE_DIRECTORY, "test", false);
+    assert(store && kstore_snapshot_find(store, 1, 2, NULL) != NULL);
+    assert(kstore_begin_snapshot(store) == false);
+    memset(&replayed, 0, sizeof(replayed));
+    assert(kstore_load(store, replay_kind_one, &replayed) == true);
+    assert(kstore_begin_snapshot(store) == true);
+    assert(kstore_snapshot_add(store, 1, 9, "abc", 3) == true);
+    assert(kstore_end_snapshot(store, false) == true);
+    assert(file_size(SNAPSHOT_PATH) == published && file_size(SNAPSHOT_PATH ".tmp") == -1);
+    kstore_close(store);
+
+    kstore_buffer_free(&buffer);
+    printf("Knowledge store snapshot test passed!\n");
+}
+
+/**
+ * @brief Test the snapshot and log together across generations
+ */
+static void test_generations(void) {
+    printf("\nTesting knowledge store generations...\n");
+
+    KnowledgeStoreBuffer buffer = { 0 };
+    Replayed replayed = { 0 };
+    KnowledgeStore *store = kstore_open(STORE_DIRECTORY, "test", true);
+    assert(store && kstore_load(store, replay_kind_one, &replayed) == true);
+    assert(replayed.count == 3 && replayed_value(&replayed, 1) == NULL);
+    assert(strcmp(replayed_value(&replayed, 5), "five") == 0);
+
+    /* A log from before the current snapshot is ignored */
+    long log_size = file_size(LOG_PATH);
+    char *stale = (char *)malloc((size_t)log_size);
+    FILE *file = fopen(LOG_PATH, "rb");
+    assert(stale && file && fread(stale, 1, (size_t)log_size, file) == (size_t)log_size);
+    fclose(file);
+
+    assert(kstore_begin_snapshot(store) == true);
+    for (uint32_t i = 0; i < replayed.count; i++) {
+        encode(&buffer, replayed.ids[i], replayed.values[i]);
+        assert(kstore_snapshot_add(store, 1, replayed.ids[i], buffer.data, (uint32_t)buffer.size));
+    }
+    assert(kstore_end_snapshot(store, true) == true);
+    kstore_close(store);
+
+    file = fopen(LOG_PATH, "wb");
+    assert(file && fwrite(stale, 1, (size_t)log_size, file) == (size_t)log_size);
+    fclose(file);
+    free(stale);
+
+    store = open_store(&replayed);
+    assert(replayed.count == 3 && replayed.deletes == 0 && replayed.puts == 3);
+    assert(file_size(LOG_PATH) < log_size);
+
+    /* Duplicate records make a snapshot invalid */
+    assert(kstore_begin_snapshot(store) == true);
+    encode(&buffer, 7, "seven");
+    assert(kstore_snapshot_add(store, 1, 7, buffer.data, (uint32_t)buffer.size));
+    assert(kstore_snapshot_add(store, 1, 7, buffer.data, (uint32_t)buffer.size));
+    assert(kstore_end_snapshot(store, true) == false);
+    kstore_close(store);
+
+    store = open_store(&replayed);
+    assert(replayed.count == 3 && replayed_value(&replayed, 7) == NULL);
+    kstore_close(store);
+
+    remove_store_files();
+    kstore_buffer_free(&buffer);
+    printf("Knowledge store generation test passed!\n");
+}
+
+/**
+ * @brief Main test function
+ */
+int main(void) {
+    printf("Running Memex Knowledge Store tests...\n\n");
+
+    test_log_replay();
+    test_torn_tail();
+    test_snapshot();
+    test_generations();
+
+    printf("\nAll Memex Knowledge Store tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,1011 @@
+/**
+ * @file test_memex_search.c
+ * @brief Unit tests for the Memex Search Engine
+ */
+
+/* strdup under -std=c11 */
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "../../src/memex/search/search_engine.h"
+#include "../../src/memex/interface/memex_interface.h"
+
+/**
+ * @brief Index a document with a title and text
+ */
+static void index_document(uint64_t id, SearchResultType type, const char *title,
+                           const char *text, uint32_t resonance_level) {
+    SearchDocument document = {
+        .id = id,
+        .type = type,
+        .title = title,
+        .text = text,
+        .text_length = text ? strlen(text) : 0,
+        .resonance_level = resonance_level,
+        .is_quantum_entangled = false
+    };
+    assert(memex_search_index_document(&document) == true);
+}
+
+/**
+ * @brief Test BM25 ranking and filters
+ */
+static void test_rank(void) {
+    printf("\nTesting BM25 ranking...\n");
+
+    index_document(1, RESULT_KNOWLEDGE, "Quantum Portal engine", "portal portal physics", 1);
+    index_document(2, RESULT_KNOWLEDGE, "Portal gun manual", NULL, 2);
+    index_document(3, RESULT_FILE, "Cooking recipes", "bread, soup; PORTAL-free", 3);
+    index_document(4, RESULT_KNOWLEDGE, "Field notes",
+                   "long notes about many unrelated things with one portal mention somewhere", 4);
+    index_document(5, RESULT_QUANTUM, "Resonance tables", NULL, 5);
+
+    SearchRankOptions options = { 0 };
+    SearchHit *hits;
+    uint32_t total;
+    uint32_t count = memex_search_rank("portal", &options, &hits, &total);
+    assert(count == 4 && total == 4);
+    assert(hits[0].id == 1);
+    assert(hits[count - 1].id == 4);
+    for (uint32_t i = 0; i < count; i++) {
+        assert(hits[i].relevance > 0.0f && hits[i].relevance <= 1.0f);
+        assert(i == 0 || hits[i - 1].relevance >= hits[i].relevance);
+    }
+    float best = hits[0].relevance;
+    free(hits);
+
+    /* The heap keeps the best hits and still counts every match */
+    options.max_results = 2;
+    count = memex_search_rank("PORTAL", &options, &hits, &total);
+    assert(count == 2 && total == 4);
+    assert(hits[0].id == 1 && hits[0].relevance == best);
+    free(hits);
+    options.max_results = 0;
+
+    /* Exact searches need every term */
+    options.match_all = true;
+    count = memex_search_rank("portal physics", &options, &hits, &total);
+    assert(count == 1 && hits[0].id == 1);
+    free(hits);
+    assert(memex_search_rank("portal wormhole", &options, &hits, &total) == 0 && hits == NULL);
+    options.match_all = false;
+    count = memex_search_rank("portal wormhole", &options, &hits, &total);
+    assert(count == 4);
+    free(hits);
+
+    /* Relevance, resonance and type filters */
+    options.min_relevance = best;
+    count = memex_search_rank("portal", &options, &hits, &total);
+    assert(count == 1 && total == 1 && hits[0].id == 1);
+    free(hits);
+    options.min_relevance = 0.0f;
+
+    options.min_resonance = 3;
+    count = memex_search_rank("portal", &options, &hits, &total);
+    assert(count == 2);
+    free(hits);
+    options.min_resonance = 0;
+
+    options.type_mask = 1u << RESULT_FILE;
+    count = memex_search_rank("portal", &options, &hits, &total);
+    assert(count == 1 && hits[0].id == 3);
+    free(hits);
+    options.type_mask = 0;
+
+    assert(memex_search_rank("", &options, &hits, &total) == 0);
+    assert(memex_search_rank("zzz", &options, &hits, &total) == 0);
+
+    printf("BM25 ranking test passed!\n");
+}
+
+/**
+ * @brief Test replacing and removing documents
+ */
+static void test_update_and_remove(void) {
+    printf("\nTesting document updates...\n");
+
+    SearchRankOptions options = { 0 };
+    SearchHit *hits;
+    uint32_t total;
+
+    /* Replacing a document drops its old terms */
+    index_document(2, RESULT_KNOWLEDGE, "Kitchen manual", NULL, 2);
+    uint32_t count = memex_search_rank("portal", &options, &hits, &total);
+    assert(count == 3);
+    for (uint32_t i = 0; i < count; i++) {
+        assert(hits[i].id != 2);
+    }
+    free(hits);
+    count = memex_search_rank("kitchen", &options, &hits, &total);
+    assert(count == 1 && hits[0].id == 2);
+    free(hits);
+
+    assert(memex_search_remove_document(1) == true);
+    assert(memex_search_remove_document(1) == false);
+    count = memex_search_rank("portal", &options, &hits, &total);
+    assert(count == 2 && hits[0].id != 1 && hits[1].id != 1);
+    free(hits);
+
+    /* Enough replacements to compact the posting lists several times */
+    char text[64];
+    for (uint32_t i = 0; i < 3000; i++) {
+        snprintf(text, sizeof(text), "revision%u shared churn words", i);
+        index_document(100, RESULT_KNOWLEDGE, "Churn", text, 1);
+    }
+    count = memex_search_rank("churn", &options, &hits, &total);
+    assert(count == 1 && hits[0].id == 100);
+    free(hits);
+    assert(memex_search_rank("revision10", &options, &hits, &total) == 0);
+    count = memex_search_rank("revision2999", &options, &hits, &total);
+    assert(count == 1 && hits[0].id == 100);
+    free(hits);
+    count = memex_search_rank("portal", &options, &hits, &total);
+    assert(count == 2);
+    free(hits);
+
+    printf("Document update test passed!\n");
+}
+
+/**
+ * @brief Test the query interface
+ */
+static void test_query(void) {
+    printf("\nTesting search queries...\n");
+
+    index_document(10, RESULT_APP, "Portal designer", NULL, 1);
+    index_document(11, RESULT_KNOWLEDGE, "Portal theory", NULL, 1);
+    assert(memex_search_set_entangled(11, true) == true);
+    assert(memex_search_set_entangled(999, true) == false);
+
+    SearchOptions options = { 0 };
+    options.include_apps = true;
+    uint32_t count;
+    SearchResult *results = memex_search_query("portal", options, &count);
+    assert(count == 1 && results[0].id == 10 && results[0].type == RESULT_APP);
+    assert(strcmp(results[0].title, "Portal designer") == 0);
+    assert(strcmp(results[0].uri, "memex://item/10") == 0);
+    memex_search_free_results(results, count);
+
+    options.include_knowledge = true;
+    options.quantum_prioritize = true;
+    results = memex_search_query("portal", options, &count);
+    assert(count == 3 && results[0].id == 11 && results[0].is_quantum_entangled);
+    memex_search_free_results(results, count);
+
+    printf("Search query test passed!\n");
+}
+
+/**
+ * @brief Test autocomplete suggestions
+ */
+static void test_suggestions(void) {
+    printf("\nTesting search suggestions...\n");
+
+    /* Titles of indexed documents are suggested */
+    uint32_t count;
+    char **suggestions = memex_search_get_suggestions("por", 5, &count);
+    assert(count == 2);
+    free(suggestions[0]);
+    free(suggestions[1]);
+    free(suggestions);
+
+    /* Repeated phrases and accesses rank first */
+    assert(memex_search_add_suggestion("portal THEORY") == true);
+    suggestions = memex_search_get_suggestions("Por", 5, &count);
+    assert(count == 2 && strcmp(suggestions[0], "Portal theory") == 0);
+    free(suggestions[0]);
+    free(suggestions[1]);
+    free(suggestions);
+    assert(memex_search_boost_suggestion("Portal designer", 5) == true);
+    assert(memex_search_boost_suggestion("Portal", 5) == false);
+    suggestions = memex_search_get_suggestions("portal", 1, &count);
+    assert(count == 1 && strcmp(suggestions[0], "Portal designer") == 0);
+    free(suggestions[0]);
+    free(suggestions);
+
+    /* Case and punctuation are ignored; a trailing separator completes the next word */
+    suggestions = memex_search_get_suggestions("PORTAL-t", 5, &count);
+    assert(count == 1 && strcmp(suggestions[0], "Portal theory") == 0);
+    free(suggestions[0]);
+    free(suggestions);
+    suggestions = memex_search_get_suggestions("portal ", 5, &count);
+    assert(count == 2);
+    free(suggestions[0]);
+    free(suggestions[1]);
+    free(suggestions);
+    assert(memex_search_get_suggestions("portals", 5, &count) == NULL && count == 0);
+
+    /* Removing a document drops its title */
+    assert(memex_search_remove_document(10) == true);
+    suggestions = memex_search_get_suggestions("portal", 5, &count);
+    assert(count == 1 && strcmp(suggestions[0], "Portal theory") == 0);
+    free(suggestions[0]);
+    free(suggestions);
+
+    /* Many phrases sharing prefixes split and merge trie edges */
+    char phrase[32];
+    for (uint32_t i = 0; i < 2000; i++) {
+        snprintf(phrase, sizeof(phrase), "phrase %u", i);
+        assert(memex_search_add_suggestion(phrase) == true);
+        if (i == 1234) {
+            assert(memex_search_boost_suggestion(phrase, 100) == true);
+        }
+    }
+    suggestions = memex_search_get_suggestions("phrase 12", 3, &count);
+    assert(count == 3 && strcmp(suggestions[0], "phrase 1234") == 0);
+    for (uint32_t i = 0; i < count; i++) {
+        assert(strncmp(suggestions[i], "phrase 12", 9) == 0);
+        free(suggestions[i]);
+    }
+    free(suggestions);
+    for (uint32_t i = 0; i < 2000; i += 2) {
+        snprintf(phrase, sizeof(phrase), "phrase %u", i);
+        assert(memex_search_remove_suggestion(phrase) == true);
+    }
+    suggestions = memex_search_get_suggestions("phrase 1998", 5, &count);
+    assert(suggestions == NULL);
+    suggestions = memex_search_get_suggestions("phrase 199", 20, &count);
+    assert(count == 6);
+    for (uint32_t i = 0; i < count; i++) {
+        free(suggestions[i]);
+    }
+    free(suggestions);
+    for (uint32_t i = 1; i < 2000; i += 2) {
+        snprintf(phrase, sizeof(phrase), "phrase %u", i);
+        assert(memex_search_remove_suggestion(phrase) == true);
+    }
+    assert(memex_search_get_suggestions("phrase", 5, &count) == NULL);
+    assert(memex_search_remove_suggestion("phrase 1") == false);
+
+    printf("Search suggestion test passed!\n");
+}
+
+/**
+ * @brief Test searching through the Memex interface
+ */
+static void test_memex_interface_search(void) {
+    printf("\nTesting Memex search...\n");
+
+    MemexInitOptions init_options = { 0 };
+    assert(memex_init(&init_options) == true);
+
+    const char *text = "entangled photons cross the portal";
+    MemexDataItem item = { 0 };
+    item.type = MEMEX_TYPE_TEXT;
+    item.name = "Field report";
+    item.data = (void *)text;
+    item.data_size = strlen(text);
+    item.resonance_level = NODE_ZERO_POINT;
+    uint64_t report = memex_store_item(&item);
+    item.type = MEMEX_TYPE_CONCEPT;
+    item.name = "Portal";
+    item.data = NULL;
+    item.data_size = 0;
+    uint64_t concept = memex_store_item(&item);
+    assert(report != 0 && concept != 0);
+
+    MemexSearchQuery query = { 0 };
+    query.query_text = "portal";
+    MemexSearchResults *results = memex_search(&query);
+    assert(results && results->count == 2 && results->total_available == 2);
+    assert(results->items[0]->id == concept);
+    assert(results->items[0]->relevance >= results->items[1]->relevance);
+    memex_free_search_results(results);
+
+    query.query_text = "photons";
+    query.max_results = 1;
+    results = memex_search(&query);
+    assert(results && results->count == 1 && results->items[0]->id == report);
+    memex_free_search_results(results);
+
+    /* Updates and deletes keep the index in step */
+    MemexDataItem *stored = memex_get_item(concept);
+    free(stored->name);
+    stored->name = strdup("Wormhole");
+    assert(memex_update_item(stored) == true);
+    memex_free_item(stored);
+    assert(memex_delete_item(report) == true);
+
+    query.query_text = "portal";
+    query.max_results = 0;
+    results = memex_search(&query);
+    assert(results && results->count == 0);
+    memex_free_search_results(results);
+    query.query_text = "wormhole";
+    results = memex_search(&query);
+    assert(results && results->count == 1 && results->items[0]->id == concept);
+    memex_free_search_results(results);
+
+    memex_shutdown();
+
+    printf("Memex search test passed!\n");
+}
+
+/**
+ * @brief Test slot-mapped item storage and borrowed items
+ */
+static void test_memex_item_storage(void) {
+    printf("\nTesting Memex item storage...\n");
+
+    MemexInitOptions init_options = { 0 };
+    assert(memex_init(&init_options) == true);
+
+    /* Storage grows past the old fixed capacity */
+    enum { ITEM_COUNT = 1500 };
+    static uint64_t ids[ITEM_COUNT];
+    MemexDataItem item = { 0 };
+    item.type = MEMEX_TYPE_CONCEPT;
+    item.name = "Node";
+    for (int i = 0; i < ITEM_COUNT; i++) {
+        ids[i] = memex_store_item(&item);
+        assert(ids[i] != 0);
+        assert(i == 0 || ids[i] != ids[i - 1]);
+    }
+    MemexDataItem *stored = memex_get_item(ids[ITEM_COUNT - 1]);
+    assert(stored && stored->id == ids[ITEM_COUNT - 1]);
+    memex_free_item(stored);
+
+    /* A reused slot does not resurrect the deleted ID */
+    uint64_t stale = ids[7];
+    assert(memex_delete_item(stale) == true);
+    uint64_t reused = memex_store_item(&item);
+    assert(reused != 0 && reused != stale);
+    assert(memex_get_item(stale) == NULL);
+    assert(memex_acquire_item(stale) == NULL);
+    assert(memex_delete_item(stale) == false);
+    MemexRelation relation = { 0 };
+    relation.source_id = stale;
+    relation.target_id = reused;
+    relation.type = MEMEX_RELATION_SIMILAR_TO;
+    relation.weight = 1.0f;
+    assert(memex_create_relation(&relation) == 0);
+    relation.source_id = ids[8];
+    uint64_t relation_id = memex_create_relation(&relation);
+    assert(relation_id != 0);
+    assert(memex_delete_relation(relation_id) == true);
+    assert(memex_delete_relation(relation_id) == false);
+
+    /* A borrowed item keeps its contents across an update and a delete */
+    const MemexDataItem *borrowed = memex_acquire_item(reused);
+    assert(borrowed && strcmp(borrowed->name, "Node") == 0);
+    stored = memex_get_item(reused);
+    free(stored->name);
+    stored->name = strdup("Renamed");
+    assert(memex_update_item(stored) == true);
+    memex_free_item(stored);
+    assert(strcmp(borrowed->name, "Node") == 0);
+
+    const MemexDataItem *current = memex_acquire_item(reused);
+    assert(current && strcmp(current->name, "Renamed") == 0);
+    assert(memex_delete_item(reused) == true);
+    assert(strcmp(current->name, "Renamed") == 0);
+    memex_release_item(current);
+    memex_release_item(borrowed);
+
+    memex_shutdown();
+
+    printf("Memex item storage test passed!\n");
+}
+
+/**
+ * @brief Relate two items through the Memex interface
+ */
+static uint64_t relate(uint64_t source, uint64_t target, MemexRelationType type) {
+    MemexRelation relation = { 0 };
+    relation.source_id = source;
+    relation.target_id = target;
+    relation.type = type;
+    relation.weight = 0.5f;
+    return memex_create_relation(&relation);
+}
+
+/**
+ * @brief Test per-item relation lookups
+ */
+static void test_memex_relations(void) {
+    printf("\nTesting Memex relations...\n");
+
+    MemexInitOptions init_options = { 0 };
+    assert(memex_init(&init_options) == true);
+
+    MemexDataItem item = { 0 };
+    item.type = MEMEX_TYPE_CONCEPT;
+    item.name = "Hub";
+    uint64_t hub = memex_store_item(&item);
+    item.name = "Spoke";
+    uint64_t spokes[3];
+    for (int i = 0; i < 3; i++) {
+        spokes[i] = memex_store_item(&item);
+    }
+
+    uint64_t is_a = relate(spokes[0], hub, MEMEX_RELATION_IS_A);
+    uint64_t part_of = relate(hub, spokes[1], MEMEX_RELATION_PART_OF);
+    uint64_t causes = relate(spokes[1], spokes[2], MEMEX_RELATION_CAUSES);
+    uint64_t self = relate(spokes[2], spokes[2], MEMEX_RELATION_SIMILAR_TO);
+    assert(is_a && part_of && causes && self);
+
+    /* Relations are found from either end, filtered by type */
+    uint32_t count = 0;
+    MemexRelation *relations = memex_get_relations(hub, MEMEX_RELATION_UNDEFINED, 0, &count);
+    assert(relations && count == 2);
+    free(relations[0].metadata);
+    free(relations[1].metadata);
+    free(relations);
+    relations = memex_get_relations(hub, MEMEX_RELATION_PART_OF, 0, &count);
+    assert(relations && count == 1 && relations[0].id == part_of);
+    assert(relations[0].target_id == spokes[1]);
+    free(relations);
+    assert(memex_get_relations(hub, MEMEX_RELATION_CAUSES, 0, &count) == NULL && count == 0);
+    relations = memex_get_relations(spokes[1], MEMEX_RELATION_UNDEFINED, 1, &count);
+    assert(relations && count == 1);
+    free(relations);
+    relations = memex_get_relations(spokes[2], MEMEX_RELATION_UNDEFINED, 0, &count);
+    assert(relations && count == 2);
+    free(relations);
+
+    /* Deleting a relation unlinks both ends */
+    assert(memex_delete_relation(part_of) == true);
+    relations = memex_get_relations(spokes[1], MEMEX_RELATION_UNDEFINED, 0, &count);
+    assert(relations && count == 1 && relations[0].id == causes);
+    free(relations);
+
+    /* Deleting an item deletes its relations */
+    assert(memex_delete_item(spokes[2]) == true);
+    assert(memex_get_relations(spokes[1], MEMEX_RELATION_UNDEFINED, 0, &count) == NULL);
+    assert(memex_delete_relation(self) == false);
+    assert(memex_get_relations(spokes[2], MEMEX_RELATION_UNDEFINED, 0, &count) == NULL);
+
+    /* The reused slot starts without relations */
+    uint64_t reused = memex_store_item(&item);
+    assert(reused != 0 && reused != spokes[2]);
+    assert(memex_get_relations(reused, MEMEX_RELATION_UNDEFINED, 0, &count) == NULL);
+    relations = memex_get_relations(hub, MEMEX_RELATION_UNDEFINED, 0, &count);
+    assert(relations && count == 1 && relations[0].id == is_a);
+    free(relations);
+
+    memex_shutdown();
+
+    printf("Memex relation test passed!\n");
+}
+
+#define PERSIST_DIRECTORY "/tmp/ctrlxt_test_memex_storage"
+
+/**
+ * @brief Remove the persistence test's files
+ */
+static void remove_store_files(void) {
+    remove(PERSIST_DIRECTORY "/memex.wal");
+    remove(PERSIST_DIRECTORY "/memex.snap");
+    remove(PERSIST_DIRECTORY "/knowledge_graph.wal");
+    remove(PERSIST_DIRECTORY "/knowledge_graph.snap");
+    rmdir(PERSIST_DIRECTORY);
+}
+
+/**
+ * @brief Test semantic search over item embeddings
+ */
+static void test_memex_semantic_search(void) {
+    printf("\nTesting Memex semantic search...\n");
+
+    MemexInitOptions init_options = { 0 };
+    assert(memex_init(&init_options) == true);
+
+    const char *text = "Photon lattice alignment";
+    MemexDataItem item = { 0 };
+    item.type = MEMEX_TYPE_TEXT;
+    item.name = "Alignment notes";
+    item.data = (void *)text;
+    item.data_size = strlen(text);
+    item.resonance_level = NODE_ZERO_POINT;
+    uint64_t notes = memex_store_item(&item);
+    item.type = MEMEX_TYPE_CONCEPT;
+    item.name = "Photon lattice";
+    item.data = NULL;
+    item.data_size = 0;
+    item.resonance_level = NODE_QUANTUM_GUARDIAN;
+    uint64_t concept = memex_store_item(&item);
+    item.name = "Anchor";
+    uint64_t anchor = memex_store_item(&item);
+    assert(notes && concept && anchor);
+
+    MemexSearchQuery query = { 0 };
+    query.query_text = "lattice photon";
+    query.flags = MEMEX_SEARCH_SEMANTIC;
+    MemexSearchResults *results = memex_search(&query);
+    assert(results && results->count == 2);
+    assert(results->items[0]->id == concept && results->items[1]->id == notes);
+    assert(results->items[0]->relevance > 0.99f && results->items[1]->relevance < 1.0f);
+    memex_free_search_results(results);
+
+    /* Resonance, type and relevance filters */
+    query.min_resonance = NODE_QUANTUM_GUARDIAN;
+    results = memex_search(&query);
+    assert(results && results->count == 1 && results->items[0]->id == concept);
+    memex_free_search_results(results);
+    query.min_resonance = NODE_ZERO_POINT;
+    query.type_mask = 1u << MEMEX_TYPE_TEXT;
+    results = memex_search(&query);
+    assert(results && results->count == 1 && results->items[0]->id == notes);
+    memex_free_search_results(results);
+    query.type_mask = 0;
+    query.min_relevance = 0.99f;
+    results = memex_search(&query);
+    assert(results && results->count == 1 && results->items[0]->id == concept);
+    memex_free_search_results(results);
+    query.min_relevance = 0.0f;
+
+    /* A set embedding is searched with a binary query and survives updates */
+    static float embedding[MEMEX_EMBEDDING_DIMENSIONS];
+    embedding[11] = 1.0f;
+    assert(memex_set_item_embedding(anchor, embedding, MEMEX_EMBEDDING_DIMENSIONS) == true);
+    assert(memex_set_item_embedding(anchor, embedding, 4) == false);
+    static float zero[MEMEX_EMBEDDING_DIMENSIONS];
+    assert(memex_set_item_embedding(anchor, zero, MEMEX_EMBEDDING_DIMENSIONS) == false);
+    MemexDataItem *stored = memex_get_item(anchor);
+    free(stored->name);
+    stored->name = strdup("Photon anchor");
+    assert(memex_update_item(stored) == true);
+    memex_free_item(stored);
+
+    query.query_text = NULL;
+    query.query_data = embedding;
+    query.query_data_size = sizeof(embedding);
+    query.max_results = 1;
+    results = memex_search(&query);
+    assert(results && results->count == 1 && results->items[0]->id == anchor);
+    memex_free_search_results(results);
+
+    /* Deleted items and cleared embeddings drop out */
+    assert(memex_delete_item(notes) == true);
+    assert(memex_set_item_embedding(anchor, NULL, 0) == true);
+    query.query_text = "photon";
+    query.query_data = NULL;
+    query.query_data_size = 0;
+    query.max_results = 0;
+    results = memex_search(&query);
+    assert(results && results->count == 2);
+    assert(results->items[0]->id == concept || results->items[0]->id == anchor);
+    assert(results->items[1]->id == concept || results->items[1]->id == anchor);
+    memex_free_search_results(results);
+
+    memex_shutdown();
+    printf("Memex semantic search test passed!\n");
+}
+
+/**
+ * @brief Test cached search results and summaries
+ */
+static void test_memex_result_cache(void) {
+    printf("\nTesting Memex result cache...\n");
+
+    MemexInitOptions init_options = { 0 };
+    assert(memex_init(&init_options) == true);
+
+    MemexDataItem item = { 0 };
+    item.type = MEMEX_TYPE_CONCEPT;
+    item.name = "Portal lattice";
+    item.resonance_level = NODE_ZERO_POINT;
+    uint64_t lattice = memex_store_item(&item);
+    item.name = "Photon";
+    uint64_t photon = memex_store_item(&item);
+    assert(lattice != 0 && photon != 0);
+
+    MemexCacheStats stats;
+    assert(memex_get_cache_stats(&stats) == true);
+    assert(stats.hits == 0 && stats.entries == 0 && stats.capacity == 16u * 1024 * 1024);
+
+    /* Queries differing only in case and punctuation share an entry */
+    MemexSearchQuery query = { 0 };
+    query.query_text = "portal lattice";
+    MemexSearchResults *results = memex_search(&query);
+    assert(results && results->count == 1 && results->items[0]->id == lattice);
+    memex_free_search_results(results);
+    query.query_text = "  Portal, LATTICE!";
+    results = memex_search(&query);
+    assert(results && results->count == 1 && results->items[0]->id == lattice);
+    assert(results->total_available == 1);
+    memex_free_search_results(results);
+    assert(memex_get_cache_stats(&stats) && stats.hits == 1 && stats.misses == 1);
+
+    /* Any stored item can enter a search, so cached searches go stale */
+    item.name = "Portal";
+    uint64_t portal = memex_store_item(&item);
+    results = memex_search(&query);
+    assert(results && results->count == 2);
+    memex_free_search_results(results);
+    assert(memex_get_cache_stats(&stats) && stats.hits == 1 && stats.invalidations == 1);
+
+    /* Result limits are part of the key */
+    query.max_results = 1;
+    results = memex_search(&query);
+    assert(results && results->count == 1 && results->total_available == 2);
+    memex_free_search_results(results);
+    query.max_results = 0;
+
+    /* Summaries are reused until one of their entities changes */
+    uint64_t ids[] = { lattice, photon };
+    char *summary = memex_generate_summary(ids, 2, 256);
+    assert(summary && strstr(summary, "Portal lattice") != NULL);
+    char *again = memex_generate_summary(ids, 2, 256);
+    assert(again && strcmp(summary, again) == 0);
+    free(again);
+    free(summary);
+    assert(memex_get_cache_stats(&stats));
+    uint64_t hits = stats.hits;
+    uint64_t invalidations = stats.invalidations;
+
+    /* Changing an unrelated item keeps the summary */
+    MemexDataItem *stored = memex_get_item(portal);
+    free(stored->name);
+    stored->name = strdup("Gateway");
+    assert(memex_update_item(stored) == true);
+    memex_free_item(stored);
+    summary = memex_generate_summary(ids, 2, 256);
+    free(summary);
+    assert(memex_get_cache_stats(&stats) && stats.hits == hits + 1);
+
+    /* Renaming a summarized item does not */
+    stored = memex_get_item(photon);
+    free(stored->name);
+    stored->name = strdup("Graviton");
+    assert(memex_update_item(stored) == true);
+    memex_free_item(stored);
+    summary = memex_generate_summary(ids, 2, 256);
+    assert(summary && strstr(summary, "Graviton") != NULL && strstr(summary, "Photon") == NULL);
+    free(summary);
+    assert(memex_get_cache_stats(&stats) && stats.invalidations == invalidations + 1);
+
+    /* Nor does relating or deleting one */
+    MemexRelation relation = { 0 };
+    relation.source_id = portal;
+    relation.target_id = lattice;
+    relation.type = MEMEX_RELATION_SIMILAR_TO;
+    relation.weight = 1.0;
+    assert(memex_create_relation(&relation) != 0);
+    summary = memex_generate_summary(ids, 2, 256);
+    free(summary);
+    assert(memex_get_cache_stats(&stats) && stats.invalidations == invalidations + 2);
+
+    assert(memex_delete_item(photon) == true);
+    summary = memex_generate_summary(ids, 2, 256);
+    assert(summary && strstr(summary, "Graviton") == NULL);
+    free(summary);
+    assert(memex_get_cache_stats(&stats) && stats.invalidations == invalidations + 3);
+
+    /* An empty length limit still yields a terminated summary */
+    summary = memex_generate_summary(ids, 2, 0);
+    assert(summary && summary[0] == '\0');
+    free(summary);
+
+    memex_shutdown();
+    assert(memex_get_cache_stats(&stats) == false);
+
+    printf("Memex result cache test passed!\n");
+}
+
+/**
+ * @brief Test that items, relations and the search index survive a restart
+ */
+static void test_memex_persistence(void) {
+    printf("\nTesting Memex persistence...\n");
+
+    remove_store_files();
+    MemexInitOptions init_options = { 0 };
+    init_options.data_directory = PERSIST_DIRECTORY;
+    assert(memex_init(&init_options) == true);
+
+    const char *text = "tachyon pulses through the lattice";
+    MemexDataItem item = { 0 };
+    item.type = MEMEX_TYPE_TEXT;
+    item.name = "Pulse log";
+    item.data = (void *)text;
+    item.data_size = strlen(text);
+    item.metadata = "{\"source\":\"lab\"}";
+    uint64_t log = memex_store_item(&item);
+    item.type = MEMEX_TYPE_CONCEPT;
+    item.name = "Lattice";
+    item.data = NULL;
+    item.data_size = 0;
+    item.metadata = NULL;
+    uint64_t lattice = memex_store_item(&item);
+    item.name = "Scrap";
+    uint64_t scrap = memex_store_item(&item);
+    assert(log && lattice && scrap);
+    uint64_t about = relate(log, lattice, MEMEX_RELATION_PART_OF);
+    assert(about && relate(scrap, lattice, MEMEX_RELATION_IS_A));
+    static float embedding[MEMEX_EMBEDDING_DIMENSIONS];
+    embedding[5] = 1.0f;
+    assert(memex_set_item_embedding(lattice, embedding, MEMEX_EMBEDDING_DIMENSIONS) == true);
+
+    /* Part of the history is compacted, the rest stays in the log */
+    assert(memex_checkpoint() == true);
+    assert(memex_delete_item(scrap) == true);
+    MemexDataItem *stored = memex_get_item(lattice);
+    free(stored->name);
+    stored->name = strdup("Crystal lattice");
+    assert(memex_update_item(stored) == true);
+    memex_free_item(stored);
+    memex_shutdown();
+
+    for (int restart = 0; restart < 2; restart++) {
+        assert(memex_init(&init_options) == true);
+        stored = memex_get_item(log);
+        assert(stored && stored->type == MEMEX_TYPE_TEXT && strcmp(stored->name, "Pulse log") == 0);
+        assert(stored->data_size == strlen(text) && memcmp(stored->data, text, strlen(text)) == 0);
+        assert(strcmp(stored->metadata, "{\"source\":\"lab\"}") == 0);
+        memex_free_item(stored);
+        stored = memex_get_item(lattice);
+        assert(stored && strcmp(stored->name, "Crystal lattice") == 0 && stored->data == NULL);
+        memex_free_item(stored);
+        assert(memex_get_item(scrap) == NULL);
+
+        uint32_t count = 0;
+        MemexRelation *relations = memex_get_relations(lattice, MEMEX_RELATION_UNDEFINED, 0, &count);
+        assert(relations && count == 1 && relations[0].id == about && relations[0].source_id == log);
+        free(relations);
+
+        /* The search index is rebuilt from the loaded items */
+        MemexSearchQuery query = { 0 };
+        query.query_text = "tachyon";
+        MemexSearchResults *results = memex_search(&query);
+        assert(results && results->count == 1 && results->items[0]->id == log);
+        memex_free_search_results(results);
+        query.query_text = "crystal";
+        results = memex_search(&query);
+        assert(results && results->count == 1 && results->items[0]->id == lattice);
+        memex_free_search_results(results);
+
+        /* So is the vector index, with the set embedding kept across the update */
+        query.query_text = "lattice";
+        query.flags = MEMEX_SEARCH_SEMANTIC;
+        results = memex_search(&query);
+        assert(results && results->count == 1 && results->items[0]->id == log);
+        memex_free_search_results(results);
+        query.query_text = NULL;
+        query.query_data = embedding;
+        query.query_data_size = sizeof(embedding);
+        results = memex_search(&query);
+        assert(results && results->count == 1 && results->items[0]->id == lattice);
+        memex_free_search_results(results);
+
+        /* The deleted item's ID stays dead */
+        uint64_t reused = memex_store_item(&item);
+        assert(reused != 0 && reused != scrap && memex_get_item(scrap) == NULL);
+        assert(memex_delete_item(reused) == true);
+        memex_shutdown();
+    }
+
+    remove_store_files();
+    printf("Memex persistence test passed!\n");
+}
+
+#define CONCURRENT_WRITERS 4
+#define CONCURRENT_READERS 4
+#define CONCURRENT_ITEMS 32
+
+static atomic_bool writers_done;
+
+/**
+ * @brief Per-writer results of the concurrency test
+ */
+typedef struct {
+    uint64_t items[CONCURRENT_ITEMS];
+    uint64_t relations[CONCURRENT_ITEMS];
+} ConcurrentWriter;
+
+/**
+ * @brief Store a chain of related items, then delete every other one
+ */
+static void *concurrent_writer(void *argument) {
+    ConcurrentWriter *writer = (ConcurrentWriter *)argument;
+    char name[32];
+    for (int i = 0; i < CONCURRENT_ITEMS; i++) {
+        snprintf(name, sizeof(name), "concurrent item %d", i);
+        MemexDataItem item = { 0 };
+        item.type = MEMEX_TYPE_CONCEPT;
+        item.name = name;
+        writer->items[i] = memex_store_item(&item);
+        assert(writer->items[i] != 0);
+        if (i > 0) {
+            writer->relations[i] = relate(writer->items[i - 1], writer->items[i], MEMEX_RELATION_SIMILAR_TO);
+            assert(writer->relations[i] != 0);
+        }
+    }
+    for (int i = 1; i < CONCURRENT_ITEMS; i += 2) {
+        assert(memex_delete_item(writer->items[i]) == true);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Search, read items and walk relations until the writers finish
+ */
+static void *concurrent_reader(void *argument) {
+    (void)argument;
+    MemexSearchQuery query = { 0 };
+    query.query_text = "concurrent item";
+    while (!atomic_load(&writers_done)) {
+        MemexSearchResults *results = memex_search(&query);
+        assert(results != NULL);
+        for (uint32_t i = 0; i < results->count; i++) {
+            uint32_t count = 0;
+            MemexRelation *relations = memex_get_relations(results->items[i]->id, MEMEX_RELATION_UNDEFINED,
+                                                           0, &count);
+            for (uint32_t j = 0; j < count; j++) {
+                assert(relations[j].source_id == results->items[i]->id ||
+                       relations[j].target_id == results->items[i]->id);
+                free(relations[j].metadata);
+            }
+            free(relations);
+            memex_free_item(memex_get_item(results->items[i]->id));
+        }
+        memex_free_search_results(results);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Test concurrent stores, deletes, searches and relation walks
+ */
+static void test_memex_concurrency(void) {
+    printf("\nTesting concurrent Memex access...\n");
+
+    MemexInitOptions init_options = { 0 };
+    assert(memex_init(&init_options) == true);
+
+    static ConcurrentWriter writers[CONCURRENT_WRITERS];
+    pthread_t writer_threads[CONCURRENT_WRITERS];
+    pthread_t reader_threads[CONCURRENT_READERS];
+    atomic_store(&writers_done, false);
+    for (int i = 0; i < CONCURRENT_READERS; i++) {
+        assert(pthread_create(&reader_threads[i], NULL, concurrent_reader, NULL) == 0);
+    }
+    for (int i = 0; i < CONCURRENT_WRITERS; i++) {
+        assert(pthread_create(&writer_threads[i], NULL, concurrent_writer, &writers[i]) == 0);
+    }
+    for (int i = 0; i < CONCURRENT_WRITERS; i++) {
+        pthread_join(writer_threads[i], NULL);
+    }
+    atomic_store(&writers_done, true);
+    for (int i = 0; i < CONCURRENT_READERS; i++) {
+        pthread_join(reader_threads[i], NULL);
+    }
+
+    /* Even items survive with no relations left; odd ones are gone */
+    for (int w = 0; w < CONCURRENT_WRITERS; w++) {
+        for (int i = 0; i < CONCURRENT_ITEMS; i++) {
+            MemexDataItem *item = memex_get_item(writers[w].items[i]);
+            assert((item != NULL) == (i % 2 == 0));
+            memex_free_item(item);
+            uint32_t count = 1;
+            assert(memex_get_relations(writers[w].items[i], MEMEX_RELATION_UNDEFINED, 0, &count) == NULL);
+            assert(count == 0);
+        }
+    }
+    MemexSearchQuery query = { 0 };
+    query.query_text = "concurrent item";
+    MemexSearchResults *results = memex_search(&query);
+    assert(results && results->count == CONCURRENT_WRITERS * CONCURRENT_ITEMS / 2);
+    memex_free_search_results(results);
+
+    memex_shutdown();
+    printf("Concurrent Memex access test passed!\n");
+}
+
+/**
+ * @brief Test batch storage of items and relations
+ */
+static void test_memex_bulk_ingest(void) {
+    printf("\nTesting Memex bulk ingest...\n");
+
+    MemexInitOptions init_options = { 0 };
+    assert(memex_init(&init_options) == true);
+
+    /* Enough items that the embeddings are computed on several threads */
+    enum { BULK_ITEMS = 1200 };
+    static char names[BULK_ITEMS][32];
+    static MemexDataItem items[BULK_ITEMS + 1];
+    static uint64_t ids[BULK_ITEMS + 1];
+    for (int i = 0; i < BULK_ITEMS; i++) {
+        snprintf(names[i], sizeof(names[i]), "Bulk crystal %d", i);
+        items[i] = (MemexDataItem){ 0 };
+        items[i].type = MEMEX_TYPE_CONCEPT;
+        items[i].name = names[i];
+    }
+    items[BULK_ITEMS] = items[42];
+
+    MemexIngestStats stats;
+    assert(memex_store_items(items, BULK_ITEMS + 1, ids, &stats) == BULK_ITEMS);
+    assert(stats.submitted == BULK_ITEMS + 1 && stats.stored == BULK_ITEMS);
+    assert(stats.duplicates == 1 && stats.rejected == 0);
+    assert(ids[BULK_ITEMS] == ids[42]);
+    for (int i = 1; i < BULK_ITEMS; i++) {
+        assert(ids[i] != 0 && ids[i] != ids[i - 1]);
+    }
+    MemexDataItem *stored = memex_get_item(ids[BULK_ITEMS - 1]);
+    assert(stored && strcmp(stored->name, names[BULK_ITEMS - 1]) == 0);
+    memex_free_item(stored);
+
+    /* Batch items are found by keyword and by similarity */
+    MemexSearchQuery query = { 0 };
+    query.query_text = "crystal";
+    query.max_results = 10;
+    MemexSearchResults *results = memex_search(&query);
+    assert(results && results->count == 10);
+    memex_free_search_results(results);
+    query.query_text = "Bulk crystal 7";
+    query.flags = MEMEX_SEARCH_SEMANTIC;
+    results = memex_search(&query);
+    assert(results && results->count > 0 && results->items[0]->id == ids[7]);
+    memex_free_search_results(results);
+
+    /* A chain, a relation already stored, a repeat and a missing end */
+    uint64_t existing = relate(ids[0], ids[1], MEMEX_RELATION_CAUSES);
+    assert(existing != 0);
+    enum { BULK_RELATIONS = 100 };
+    MemexRelation relations[BULK_RELATIONS + 2];
+    uint64_t relation_ids[BULK_RELATIONS + 2];
+    for (int i = 0; i < BULK_RELATIONS; i++) {
+        relations[i] = (MemexRelation){ 0 };
+        relations[i].source_id = ids[i];
+        relations[i].target_id = ids[i + 1];
+        relations[i].type = MEMEX_RELATION_CAUSES;
+        relations[i].weight = 0.5f;
+    }
+    relations[BULK_RELATIONS] = relations[5];
+    relations[BULK_RELATIONS + 1] = relations[5];
+    relations[BULK_RELATIONS + 1].target_id = 999999999;
+    assert(memex_create_relations(relations, BULK_RELATIONS + 2, relation_ids, &stats) ==
+           BULK_RELATIONS - 1);
+    assert(stats.stored == BULK_RELATIONS - 1 && stats.duplicates == 2 && stats.rejected == 1);
+    assert(relation_ids[0] == existing && relation_ids[BULK_RELATIONS] == relation_ids[5]);
+    assert(relation_ids[BULK_RELATIONS + 1] == 0);
+
+    uint32_t count = 0;
+    MemexRelation *found = memex_get_relations(ids[50], MEMEX_RELATION_CAUSES, 0, &count);
+    assert(found && count == 2);
+    free(found);
+
+    /* Repeating the batch stores nothing */
+    assert(memex_create_relations(relations, BULK_RELATIONS, NULL, &stats) == 0);
+    assert(stats.duplicates == BULK_RELATIONS);
+
+    memex_shutdown();
+
+    printf("Memex bulk ingest test passed!\n");
+}
+
+/**
+ * @brief Main test function
+ */
+int main(void) {
+    printf("Running Memex Search Engine tests...\n\n");
+
+    assert(memex_search_init() == true);
+
+    test_rank();
+    test_update_and_remove();
+    test_query();
+    test_suggestions();
+
+    memex_search_shutdown();
+
+    test_memex_interface_search();
+    test_memex_item_storage();
+    test_memex_relations();
+    test_memex_semantic_search();
+    test_memex_result_cache();
+    test_memex_persistence();
+    test_memex_concurrency();
+    test_memex_bulk_ingest();
+
+    printf("\nAll Memex Search Engine tests passed!\n");
+
+    return 0;
+}
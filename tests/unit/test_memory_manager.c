@@ -83,6 +83,328 @@ static void test_mm_virtual_memory(void) {
     printf("Virtual memory operations test passed!\n");
 }
 
+/**
+ * @brief Test region lookups and overlap queries across many regions
+ */
+static void test_mm_region_index(void) {
+    printf("\nTesting memory region index...\n");
+    
+    #define INDEX_REGIONS 300
+    HalVirtualAddr addrs[INDEX_REGIONS];
+    uintptr_t lowest = UINTPTR_MAX;
+    uintptr_t highest = 0;
+    for (int i = 0; i < INDEX_REGIONS; i++) {
+        /* Too large for the slab allocator, so each gets a region of its own */
+        uint64_t size = 4096 + (uint64_t)(i % 5) * 1024;
+        addrs[i] = mm_alloc_virtual(size, MEMORY_TYPE_RAM, MM_FLAG_READ | MM_FLAG_WRITE);
+        assert(addrs[i] != NULL);
+        if ((uintptr_t)addrs[i] < lowest) lowest = (uintptr_t)addrs[i];
+        if ((uintptr_t)addrs[i] + size > highest) highest = (uintptr_t)addrs[i] + size;
+    }
+    
+    /* Every address inside a region finds it */
+    for (int i = 0; i < INDEX_REGIONS; i++) {
+        MemoryRegion* region = mm_get_region_info(addrs[i]);
+        assert(region != NULL && region->start == addrs[i]);
+        assert(mm_get_region_info((uint8_t*)addrs[i] + region->size - 1) == region);
+        assert(mm_get_region_info((uint8_t*)addrs[i] + region->size / 2) == region);
+    }
+    
+    /* Overlap queries return the regions in address order */
+    static MemoryRegion* found[INDEX_REGIONS];
+    uint32_t count = mm_find_regions((HalVirtualAddr)lowest, highest - lowest, found, INDEX_REGIONS);
+    assert(count == INDEX_REGIONS);
+    for (uint32_t i = 1; i < count; i++) {
+        assert((uintptr_t)found[i - 1]->start < (uintptr_t)found[i]->start);
+    }
+    MemoryRegion* region = mm_get_region_info(addrs[7]);
+    assert(mm_find_regions((uint8_t*)addrs[7] + 1, 1, found, INDEX_REGIONS) == 1 && found[0] == region);
+    assert(mm_find_regions((HalVirtualAddr)lowest, highest - lowest, found, 10) == 10);
+    
+    /* Freed regions drop out of the index, the rest stay reachable */
+    for (int i = 0; i < INDEX_REGIONS; i += 2) {
+        assert(mm_free_virtual(addrs[i]) == true);
+    }
+    for (int i = 0; i < INDEX_REGIONS; i++) {
+        MemoryRegion* lookup = mm_get_region_info(addrs[i]);
+        if (i % 2 == 1) {
+            assert(lookup != NULL && lookup->start == addrs[i]);
+        } else {
+            assert(lookup == NULL || lookup->start != addrs[i]);
+        }
+    }
+    count = mm_find_regions((HalVirtualAddr)lowest, highest - lowest, found, INDEX_REGIONS);
+    assert(count == INDEX_REGIONS / 2);
+    
+    for (int i = 1; i < INDEX_REGIONS; i += 2) {
+        assert(mm_free_virtual(addrs[i]) == true);
+    }
+    assert(mm_find_regions((HalVirtualAddr)lowest, highest - lowest, found, INDEX_REGIONS) == 0);
+    
+    printf("Memory region index test passed!\n");
+}
+
+/**
+ * @brief Test small allocations carved from slabs
+ */
+static void test_mm_slab(void) {
+    printf("\nTesting slab allocations...\n");
+    
+    MemoryStats stats_before;
+    mm_get_stats(&stats_before);
+    
+    #define SLAB_OBJECTS 200
+    HalVirtualAddr addrs[SLAB_OBJECTS];
+    for (int i = 0; i < SLAB_OBJECTS; i++) {
+        uint64_t size = 1 + (uint64_t)(i % 7) * 300;
+        addrs[i] = mm_alloc_virtual(size, MEMORY_TYPE_RAM, MM_FLAG_READ | MM_FLAG_WRITE);
+        assert(addrs[i] != NULL);
+        memset(addrs[i], i & 0xFF, size);
+        
+        /* Objects are rounded up to a power-of-two size class */
+        MemoryRegion* region = mm_get_region_info(addrs[i]);
+        assert(region != NULL && region->start == addrs[i]);
+        assert(region->size >= size && region->size < size * 2 + 16);
+        assert(region->type == MEMORY_TYPE_RAM);
+        assert(region->flags == (MM_FLAG_READ | MM_FLAG_WRITE));
+        assert(mm_get_region_info((uint8_t*)addrs[i] + size - 1)->start == addrs[i]);
+    }
+    
+    /* Writes to one object never reach another */
+    for (int i = 0; i < SLAB_OBJECTS; i++) {
+        uint64_t size = 1 + (uint64_t)(i % 7) * 300;
+        for (uint64_t j = 0; j < size; j++) {
+            assert(((uint8_t*)addrs[i])[j] == (uint8_t)(i & 0xFF));
+        }
+    }
+    
+    MemoryStats stats_after_alloc;
+    mm_get_stats(&stats_after_alloc);
+    assert(stats_after_alloc.total_regions == stats_before.total_regions + SLAB_OBJECTS);
+    assert(stats_after_alloc.used_virtual > stats_before.used_virtual);
+    
+    /* Quantum memory always gets a region of its own */
+    HalVirtualAddr quantum = mm_alloc_virtual(64, MEMORY_TYPE_RAM, MM_FLAG_READ | MM_FLAG_QUANTUM);
+    assert(quantum != NULL);
+    assert(mm_get_region_info(quantum)->slab == NULL);
+    assert(mm_get_region_info(addrs[0])->slab != NULL);
+    assert(mm_free_virtual(quantum) == true);
+    
+    /* Interior pointers and objects already freed are rejected */
+    assert(mm_free_virtual((uint8_t*)addrs[1] + 1) == false);
+    assert(mm_free_virtual(addrs[1]) == true);
+    assert(mm_free_virtual(addrs[1]) == false);
+    assert(mm_get_region_info(addrs[1]) == NULL || mm_get_region_info(addrs[1])->start != addrs[1]);
+    
+    /* A freed object is handed out again */
+    HalVirtualAddr reused = mm_alloc_virtual(301, MEMORY_TYPE_RAM, MM_FLAG_READ | MM_FLAG_WRITE);
+    assert(reused == addrs[1]);
+    
+    for (int i = 0; i < SLAB_OBJECTS; i++) {
+        assert(mm_free_virtual(addrs[i]) == true);
+    }
+    
+    MemoryStats stats_after_free;
+    mm_get_stats(&stats_after_free);
+    assert(stats_after_free.total_regions == stats_before.total_regions);
+    assert(stats_after_free.used_virtual == stats_before.used_virtual);
+    
+    printf("Slab allocations test passed!\n");
+}
+
+/**
+ * @brief Test physical memory allocation and freeing
+ */
+static void test_mm_physical_memory(void) {
+    printf("\nTesting physical memory operations...\n");
+    
+    const uint64_t PAGE = 4096;
+    MemoryStats stats_before;
+    MemoryStats stats_after;
+    
+    /* The first single page refills the CPU's cache, the next is served from it */
+    mm_get_stats(&stats_before);
+    HalPhysicalAddr page1 = mm_alloc_physical(PAGE, 0);
+    HalPhysicalAddr page2 = mm_alloc_physical(1, 0);
+    assert(page1 != 0 && page2 != 0 && page1 != page2);
+    assert(page1 % PAGE == 0 && page2 % PAGE == 0);
+    mm_get_stats(&stats_after);
+    assert(stats_after.page_cache_misses == stats_before.page_cache_misses + 1);
+    assert(stats_after.page_cache_hits == stats_before.page_cache_hits + 1);
+    assert(stats_after.used_physical == stats_before.used_physical + 2 * PAGE);
+    assert(mm_free_physical(page1, PAGE) == true);
+    assert(mm_free_physical(page2, PAGE) == true);
+    assert(mm_free_physical(page2, PAGE) == false);
+    
+    /* Blocks are contiguous, rounded to a power of two and aligned */
+    mm_get_stats(&stats_before);
+    HalPhysicalAddr block1 = mm_alloc_physical(5 * PAGE, 0);
+    HalPhysicalAddr block2 = mm_alloc_physical(PAGE, 256 * 1024);
+    assert(block1 != 0 && block1 % (8 * PAGE) == 0);
+    assert(block2 != 0 && block2 % (256 * 1024) == 0);
+    assert(mm_alloc_physical(PAGE, 3 * PAGE) == 0);
+    assert(mm_alloc_physical(16ULL * 1024 * 1024 * 1024, 0) == 0);
+    mm_get_stats(&stats_after);
+    assert(stats_after.used_physical == stats_before.used_physical + 8 * PAGE + 256 * 1024);
+    
+    /* Only allocated block starts can be freed */
+    assert(mm_free_physical(block1 + PAGE, PAGE) == false);
+    assert(mm_free_physical(block1, 9 * PAGE) == false);
+    assert(mm_free_physical(0, PAGE) == false);
+    
+    /* Freeing merges the blocks back into the ones they were split from */
+    assert(mm_free_physical(block1, 5 * PAGE) == true);
+    assert(mm_free_physical(block2, PAGE) == true);
+    mm_get_stats(&stats_after);
+    assert(stats_after.used_physical == stats_before.used_physical);
+    assert(stats_after.free_blocks == stats_before.free_blocks);
+    assert(stats_after.largest_free_block == stats_before.largest_free_block);
+    
+    /* The HAL page operations use the same allocator */
+    const HalOperations* hal_ops = hal_get_operations();
+    assert(hal_ops->alloc_physical_page != NULL && hal_ops->free_physical_page != NULL);
+    HalPhysicalAddr hal_page = hal_ops->alloc_physical_page();
+    assert(hal_page != 0 && hal_page % PAGE == 0);
+    mm_get_stats(&stats_after);
+    assert(stats_after.used_physical == stats_before.used_physical + PAGE);
+    hal_ops->free_physical_page(hal_page);
+    mm_get_stats(&stats_after);
+    assert(stats_after.used_physical == stats_before.used_physical);
+    
+    printf("Physical memory operations test passed!\n");
+}
+
+/**
+ * @brief Test node placement policies
+ */
+static void test_mm_numa_policies(void) {
+    printf("\nTesting memory node placement...\n");
+    
+    uint32_t node_count = mm_get_node_count();
+    assert(node_count >= 1 && node_count <= MM_MAX_NODES);
+    assert(mm_get_current_node() < node_count);
+    
+    MemoryStats stats_before;
+    mm_get_stats(&stats_before);
+    assert(stats_before.node_count == node_count);
+    
+    /* Bound physical allocations stay on their node */
+    for (uint32_t node = 0; node < node_count; node++) {
+        if (stats_before.nodes[node].free_physical < 8 * 4096) {
+            continue;
+        }
+        HalPhysicalAddr pages = mm_alloc_physical_policy(4 * 4096, 0, MM_POLICY_BIND, node);
+        HalPhysicalAddr page = mm_alloc_physical_policy(4096, 0, MM_POLICY_BIND, node);
+        assert(pages != 0 && page != 0);
+        
+        MemoryStats stats;
+        mm_get_stats(&stats);
+        assert(stats.nodes[node].allocations == stats_before.nodes[node].allocations + 2);
+        assert(stats.nodes[node].fallbacks == stats_before.nodes[node].fallbacks);
+        assert(stats.nodes[node].free_physical <= stats_before.nodes[node].free_physical - 4 * 4096);
+        
+        assert(mm_free_physical(pages, 4 * 4096) == true);
+        assert(mm_free_physical(page, 4096) == true);
+    }
+    assert(mm_alloc_physical_policy(4096, 0, MM_POLICY_BIND, node_count) == 0);
+    
+    /* Virtual regions record the node they were placed on */
+    HalVirtualAddr local = mm_alloc_virtual(8192, MEMORY_TYPE_RAM, MM_FLAG_READ | MM_FLAG_WRITE);
+    assert(local != NULL && mm_get_region_info(local)->node == mm_get_current_node());
+    HalVirtualAddr bound = mm_alloc_virtual_policy(8192, MEMORY_TYPE_RAM, MM_FLAG_READ | MM_FLAG_WRITE,
+                                                   MM_POLICY_BIND, node_count - 1);
+    assert(bound != NULL && mm_get_region_info(bound)->node == node_count - 1);
+    assert(mm_alloc_virtual_policy(8192, MEMORY_TYPE_RAM, MM_FLAG_READ, MM_POLICY_PREFERRED, node_count) == NULL);
+    
+    /* Interleaving visits every node */
+    #define INTERLEAVED_REGIONS (2 * MM_MAX_NODES)
+    HalVirtualAddr interleaved[INTERLEAVED_REGIONS];
+    uint32_t seen = 0;
+    for (uint32_t i = 0; i < 2 * node_count; i++) {
+        interleaved[i] = mm_alloc_virtual_policy(8192, MEMORY_TYPE_RAM, MM_FLAG_READ, MM_POLICY_INTERLEAVE, 0);
+        assert(interleaved[i] != NULL);
+        seen |= 1u << mm_get_region_info(interleaved[i])->node;
+    }
+    assert(seen == (1u << node_count) - 1);
+    for (uint32_t i = 0; i < 2 * node_count; i++) {
+        assert(mm_free_virtual(interleaved[i]) == true);
+    }
+    
+    assert(mm_free_virtual(local) == true);
+    assert(mm_free_virtual(bound) == true);
+    
+    printf("Memory node placement test passed!\n");
+}
+
+/**
+ * @brief Test huge-page and file-backed regions
+ */
+static void test_mm_huge_pages(void) {
+    printf("\nTesting huge-page and file-backed regions...\n");
+    
+    const HalOperations* hal_ops = hal_get_operations();
+    const uint64_t HUGE_2M = 2ULL * 1024 * 1024;
+    
+    /* Huge regions are rounded up to whole pages, or fall back to the heap */
+    HalVirtualAddr huge = mm_alloc_virtual(HUGE_2M + HUGE_2M / 2, MEMORY_TYPE_RAM,
+                                           MM_FLAG_READ | MM_FLAG_WRITE | MM_FLAG_HUGE_2M);
+    assert(huge != NULL);
+    MemoryRegion* region = mm_get_region_info(huge);
+    assert(region != NULL && region->slab == NULL);
+    if (hal_ops->map_physical_memory) {
+        assert(region->backing == MEMORY_BACKING_HUGE_PAGES);
+        assert(region->size == 2 * HUGE_2M);
+        assert(region->physical != 0 && region->physical % HUGE_2M == 0);
+    } else {
+        assert(region->backing == MEMORY_BACKING_HEAP);
+        assert(region->size == HUGE_2M + HUGE_2M / 2);
+    }
+    memset(huge, 0x5A, HUGE_2M + HUGE_2M / 2);
+    assert(((uint8_t*)huge)[HUGE_2M] == 0x5A);
+    assert(mm_free_virtual(huge) == true);
+    
+    /* Small huge-page requests never come from a slab */
+    HalVirtualAddr small = mm_alloc_virtual(64, MEMORY_TYPE_RAM, MM_FLAG_READ | MM_FLAG_WRITE | MM_FLAG_HUGE_2M);
+    assert(small != NULL && mm_get_region_info(small)->slab == NULL);
+    assert(mm_free_virtual(small) == true);
+    
+    if (!hal_ops->map_file) {
+        assert(mm_map_file("test_mm_map_file.tmp", 0, 0, MM_FLAG_READ) == NULL);
+        printf("Skipping file mapping test - HAL doesn't support file mapping\n");
+        return;
+    }
+    
+    const char* path = "test_mm_map_file.tmp";
+    FILE* file = fopen(path, "wb");
+    assert(file != NULL);
+    for (int i = 0; i < 2 * 4096; i++) {
+        fputc(i & 0xFF, file);
+    }
+    fclose(file);
+    
+    /* Size 0 maps the rest of the file */
+    HalVirtualAddr mapped = mm_map_file(path, 4096, 0, MM_FLAG_READ);
+    assert(mapped != NULL);
+    region = mm_get_region_info(mapped);
+    assert(region->type == MEMORY_TYPE_FILE && region->backing == MEMORY_BACKING_FILE);
+    assert(region->size == 4096);
+    assert(((uint8_t*)mapped)[1] == 1);
+    assert(mm_free_virtual(mapped) == true);
+    assert(mm_map_file(path, 100, 0, MM_FLAG_READ) == NULL);
+    
+    /* Writable mappings write through to the file */
+    mapped = mm_map_file(path, 0, 4096, MM_FLAG_READ | MM_FLAG_WRITE);
+    assert(mapped != NULL);
+    ((uint8_t*)mapped)[0] = 0xEE;
+    assert(mm_free_virtual(mapped) == true);
+    file = fopen(path, "rb");
+    assert(file != NULL && fgetc(file) == 0xEE);
+    fclose(file);
+    remove(path);
+    
+    printf("Huge-page and file-backed region test passed!\n");
+}
+
 /**
  * @brief Test memory entanglement
  */
@@ -152,6 +474,83 @@ static void test_mm_entanglement(void) {
     mm_free_virtual(addr2);
 }
 
+/**
+ * @brief Test incremental synchronization of changed blocks
+ */
+static void test_mm_entanglement_dirty_sync(void) {
+    printf("\nTesting incremental entanglement synchronization...\n");
+    
+    const HalOperations* hal_ops = hal_get_operations();
+    if (!hal_ops->has_quantum_support || !hal_ops->has_quantum_support()) {
+        printf("Skipping incremental synchronization test - hardware doesn't support quantum operations\n");
+        return;
+    }
+    
+    const uint64_t TEST_SIZE = 64 * 4096;
+    HalVirtualAddr regions[4];
+    for (int i = 0; i < 4; i++) {
+        regions[i] = mm_alloc_virtual(TEST_SIZE, MEMORY_TYPE_RAM, MM_FLAG_READ | MM_FLAG_WRITE | MM_FLAG_QUANTUM);
+        assert(regions[i] != NULL);
+        memset(regions[i], 0x11 * (i + 1), TEST_SIZE);
+    }
+    uint64_t ids[2];
+    ids[0] = mm_create_entanglement(regions[0], regions[1], NODE_QUANTUM_GUARDIAN);
+    ids[1] = mm_create_entanglement(regions[2], regions[3], NODE_QUANTUM_GUARDIAN);
+    assert(ids[0] != 0 && ids[1] != 0);
+    
+    /* Only the marked blocks are copied */
+    uint8_t* source = (uint8_t*)regions[0];
+    uint8_t* destination = (uint8_t*)regions[1];
+    memset(source + 3 * 4096 + 100, 0xEE, 10);
+    memset(source + 10 * 4096, 0xEE, 2 * 4096);
+    memset(source + 20 * 4096, 0xEE, 4096);
+    assert(mm_mark_dirty(source + 3 * 4096 + 100, 10) == true);
+    assert(mm_mark_dirty(source + 10 * 4096, 2 * 4096) == true);
+    
+    EntanglementInfo info;
+    assert(mm_get_entanglement_info(ids[0], &info) == true && info.is_synchronized == false);
+    
+    MemoryStats stats_before;
+    mm_get_stats(&stats_before);
+    assert(mm_sync_entanglement(ids[0]) == true);
+    MemoryStats stats_after;
+    mm_get_stats(&stats_after);
+    assert(stats_after.entanglement_bytes_synced == stats_before.entanglement_bytes_synced + 3 * 4096);
+    
+    assert(destination[3 * 4096 + 100] == 0xEE);
+    assert(destination[11 * 4096 + 4095] == 0xEE);
+    assert(destination[20 * 4096] == 0x11);
+    assert(mm_get_entanglement_info(ids[0], &info) == true && info.is_synchronized == true);
+    
+    /* Nothing is copied once the marked blocks are clean again */
+    assert(mm_sync_entanglement(ids[0]) == true);
+    mm_get_stats(&stats_before);
+    assert(stats_before.entanglement_bytes_synced == stats_after.entanglement_bytes_synced);
+    
+    /* Batches skip unknown IDs; unmarked entanglements copy everything */
+    uint64_t batch[3] = { ids[0], 9999, ids[1] };
+    assert(mm_mark_dirty(source + 20 * 4096, 1) == true);
+    assert(mm_sync_entanglements(batch, 3) == 2);
+    mm_get_stats(&stats_after);
+    assert(stats_after.entanglement_bytes_synced == stats_before.entanglement_bytes_synced + 4096 + TEST_SIZE);
+    assert(destination[20 * 4096] == 0xEE);
+    assert(((uint8_t*)regions[3])[TEST_SIZE - 1] == 0x33);
+    
+    /* Memory that is not entangled cannot be marked */
+    HalVirtualAddr plain = mm_alloc_virtual(TEST_SIZE, MEMORY_TYPE_RAM, MM_FLAG_READ | MM_FLAG_WRITE);
+    assert(mm_mark_dirty(plain, 1) == false);
+    mm_free_virtual(plain);
+    
+    assert(mm_break_entanglement(ids[0]) == true);
+    assert(mm_break_entanglement(ids[1]) == true);
+    assert(mm_mark_dirty(source, 1) == false);
+    for (int i = 0; i < 4; i++) {
+        mm_free_virtual(regions[i]);
+    }
+    
+    printf("Incremental entanglement synchronization test passed!\n");
+}
+
 /**
  * @brief Test memory statistics
  */
@@ -196,7 +595,13 @@ int main(void) {
     
     test_mm_init();
     test_mm_virtual_memory();
+    test_mm_region_index();
+    test_mm_slab();
+    test_mm_physical_memory();
+    test_mm_numa_policies();
+    test_mm_huge_pages();
     test_mm_entanglement();
+    test_mm_entanglement_dirty_sync();
     test_mm_stats();
     test_mm_shutdown();
     
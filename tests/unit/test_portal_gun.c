@@ -0,0 +1,258 @@
+/**
+ * @file test_portal_gun.c
+ * @brief Unit tests for the Portal Gun registry and stability sweeps
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include "../../src/quantum/portals/portal_gun.h"
+
+/**
+ * @brief Settings used by every test
+ */
+static PortalGunSettings test_settings(uint32_t max_portals, double max_distance, bool auto_stabilize) {
+    PortalGunSettings settings = {
+        .default_type = PORTAL_SPATIAL,
+        .default_stability = STABILITY_STABLE,
+        .entry_color = COLOR_GREEN,
+        .exit_color = COLOR_ORANGE,
+        .default_diameter = 2.0,
+        .max_distance = max_distance,
+        .max_portals = max_portals,
+        .auto_stabilize = auto_stabilize,
+        .power_efficiency = 0.9,
+        .resonance_level = NODE_ZERO_POINT
+    };
+    return settings;
+}
+
+/**
+ * @brief Coordinates at a point in dimension 1
+ */
+static PortalCoordinates at(double x) {
+    PortalCoordinates coordinates;
+    memset(&coordinates, 0, sizeof(coordinates));
+    coordinates.x = x;
+    coordinates.dimension_id = 1;
+    return coordinates;
+}
+
+/**
+ * @brief Test creating, closing and reusing registry slots
+ */
+static void test_registry_slots(void) {
+    printf("\nTesting portal registry slots...\n");
+
+    assert(portal_gun_init(test_settings(4, 100.0, false), 42));
+
+    /* A portal too long is refused without using up a slot */
+    assert(portal_gun_create_portal(PORTAL_SPATIAL, at(0.0), at(150.0), NULL) == NULL);
+
+    Portal *portals[4];
+    for (int i = 0; i < 4; i++) {
+        portals[i] = portal_gun_create_portal(PORTAL_SPATIAL, at(0.0), at(i * 10.0), NULL);
+        assert(portals[i] != NULL && portals[i]->id != 0 && portals[i]->creator_id == 42);
+        for (int j = 0; j < i; j++) {
+            assert(portals[j]->id != portals[i]->id);
+        }
+    }
+    assert(portal_gun_create_portal(PORTAL_SPATIAL, at(0.0), at(1.0), NULL) == NULL);
+
+    /* A closed portal's slot is the next one handed out, under a new ID */
+    uint64_t closed = portals[2]->id;
+    assert(portal_gun_close_portal(closed));
+    assert(!portal_gun_close_portal(closed));
+    assert(portal_gun_get_portal_info(closed).id == 0);
+    Portal *reused = portal_gun_create_portal(PORTAL_TEMPORAL, at(0.0), at(5.0), NULL);
+    assert(reused == portals[2] && reused->id != closed && reused->type == PORTAL_TEMPORAL);
+    assert(portal_gun_get_portal_info(reused->id).id == reused->id);
+    assert(portal_gun_get_portal_info(closed).id == 0 && !portal_gun_is_travel_safe(closed));
+    assert(portal_gun_get_portal_info(0).id == 0 && portal_gun_get_portal_info(~0ULL).id == 0);
+
+    uint32_t count = 0;
+    Portal *active = portal_gun_get_active_portals(10, &count);
+    assert(active && count == 4);
+    free(active);
+    active = portal_gun_get_active_portals(2, &count);
+    assert(active && count == 2);
+    free(active);
+
+    /* Shutdown frees every slot at once */
+    assert(portal_gun_emergency_shutdown());
+    assert(portal_gun_get_active_portals(10, &count) == NULL && count == 0);
+    assert(portal_gun_update_stability() == 0);
+    for (int i = 0; i < 4; i++) {
+        assert(portal_gun_create_portal(PORTAL_SPATIAL, at(0.0), at(1.0), NULL) != NULL);
+    }
+    assert(portal_gun_emergency_shutdown());
+
+    printf("Portal registry slot test passed!\n");
+}
+
+/**
+ * @brief Test that sweeps agree with per-portal stability
+ */
+static void test_stability_sweep(void) {
+    printf("\nTesting portal stability sweeps...\n");
+
+    assert(portal_gun_init(test_settings(4, 100.0, false), 7));
+
+    /* A fresh portal at rest is fully stable; half the range costs a level */
+    Portal *near = portal_gun_create_portal(PORTAL_SPATIAL, at(0.0), at(0.0), NULL);
+    Portal *far = portal_gun_create_portal(PORTAL_SPATIAL, at(0.0), at(50.0), NULL);
+    assert(near->stability == STABILITY_PERMANENT);
+    assert(far->stability == STABILITY_RESONANT);
+    assert(portal_gun_is_travel_safe(near->id));
+
+    /* Calibrating far from the portals' level lowers every one */
+    assert(!portal_gun_calibrate((NodeLevel)14));
+    assert(portal_gun_calibrate(NODE_DREAMER));
+    assert(near->stability == STABILITY_RESONANT);
+    assert(far->stability == STABILITY_STABLE);
+    assert(portal_gun_update_stability() == 2);
+
+    /* Growing the registry past a chunk leaves existing portals in place */
+    PortalGunSettings settings = test_settings(200, 60.0, true);
+    settings.resonance_level = NODE_DREAMER;
+    assert(portal_gun_update_settings(settings));
+    assert(near->stability == STABILITY_RESONANT);
+    assert(far->stability == STABILITY_STABLE);
+    assert(portal_gun_is_travel_safe(far->id));
+    assert(!portal_gun_update_settings(test_settings(PORTAL_GUN_MAX_PORTALS + 1, 60.0, true)));
+
+    /* The new slots are usable, and the sweep reports what lookups do */
+    for (int i = 0; i < 198; i++) {
+        assert(portal_gun_create_portal(PORTAL_SPATIAL, at(0.0), at((i % 6) * 11.0), NULL) != NULL);
+    }
+    assert(portal_gun_create_portal(PORTAL_SPATIAL, at(0.0), at(1.0), NULL) == NULL);
+    assert(portal_gun_update_stability() == 200);
+    uint32_t count = 0;
+    Portal *active = portal_gun_get_active_portals(500, &count);
+    assert(active && count == 200);
+    for (uint32_t i = 0; i < count; i++) {
+        Portal info = portal_gun_get_portal_info(active[i].id);
+        assert(info.id == active[i].id && info.stability == active[i].stability);
+    }
+    free(active);
+
+    /* The limit cannot drop below the portals still open */
+    settings.max_portals = 2;
+    assert(!portal_gun_update_settings(settings));
+
+    /* Moving the exit recomputes the cached distance, but only within range */
+    PortalCoordinates exit = at(0.0);
+    assert(portal_gun_modify_portal(far->id, &exit, NULL, -1));
+    assert(portal_gun_get_portal_info(far->id).stability == STABILITY_RESONANT);
+    exit = at(61.0);
+    assert(!portal_gun_modify_portal(far->id, &exit, NULL, -1));
+    assert(portal_gun_get_portal_info(far->id).stability == STABILITY_RESONANT);
+
+    assert(portal_gun_emergency_shutdown());
+    printf("Portal stability sweep test passed!\n");
+}
+
+#define SHARED_PORTALS 32
+#define WORKER_THREADS 4
+
+static Portal *shared_portals[SHARED_PORTALS];
+static uint64_t shared_ids[SHARED_PORTALS];
+
+/**
+ * @brief Worker reading and modifying the shared portals by ID
+ */
+static void *lookup_worker(void *arg) {
+    uint32_t seed = (uint32_t)(uintptr_t)arg;
+    for (int i = 0; i < 3000; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        uint64_t id = shared_ids[(seed >> 8) % SHARED_PORTALS];
+        assert(portal_gun_get_portal_info(id).id == id);
+        portal_gun_is_travel_safe(id);
+        PortalCoordinates exit = at((double)((seed >> 16) % 50));
+        assert(portal_gun_modify_portal(id, &exit, NULL, -1));
+    }
+    return NULL;
+}
+
+/**
+ * @brief Worker creating and closing a burst of portals
+ */
+static void *burst_worker(void *arg) {
+    (void)arg;
+    uint64_t ids[100];
+    for (int round = 0; round < 10; round++) {
+        uint32_t created = 0;
+        for (int i = 0; i < 100; i++) {
+            Portal *portal = portal_gun_create_portal(PORTAL_SPATIAL, at(0.0), at(3.0), NULL);
+            if (portal) {
+                ids[created++] = portal->id;
+            }
+        }
+        for (uint32_t i = 0; i < created; i++) {
+            assert(portal_gun_close_portal(ids[i]));
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Test lookups, modifies and bursts racing registry growth
+ */
+static void test_concurrent_access(void) {
+    printf("\nTesting concurrent portal access...\n");
+
+    assert(portal_gun_init(test_settings(64, 100.0, false), 9));
+    for (int i = 0; i < SHARED_PORTALS; i++) {
+        shared_portals[i] = portal_gun_create_portal(PORTAL_SPATIAL, at(0.0), at(10.0), NULL);
+        assert(shared_portals[i] != NULL);
+        shared_ids[i] = shared_portals[i]->id;
+    }
+
+    pthread_t workers[WORKER_THREADS + 2];
+    for (uintptr_t i = 0; i < WORKER_THREADS; i++) {
+        assert(pthread_create(&workers[i], NULL, lookup_worker, (void *)(i + 1)) == 0);
+    }
+    for (int i = WORKER_THREADS; i < WORKER_THREADS + 2; i++) {
+        assert(pthread_create(&workers[i], NULL, burst_worker, NULL) == 0);
+    }
+
+    /* Grow and recalibrate while the workers run */
+    for (uint32_t max = 64; max <= 64 * 16; max += 64) {
+        assert(portal_gun_update_settings(test_settings(max, 100.0, max % 128 == 0)));
+        assert(portal_gun_calibrate((NodeLevel)(max / 64 % 14)));
+        uint32_t count = 0;
+        free(portal_gun_get_active_portals(max, &count));
+        assert(count >= SHARED_PORTALS);
+    }
+    for (int i = 0; i < WORKER_THREADS + 2; i++) {
+        pthread_join(workers[i], NULL);
+    }
+
+    /* Pointers taken before the growth still lead to their portals */
+    assert(portal_gun_update_stability() == SHARED_PORTALS);
+    for (int i = 0; i < SHARED_PORTALS; i++) {
+        assert(shared_portals[i]->id == shared_ids[i]);
+        assert(portal_gun_close_portal(shared_ids[i]));
+    }
+    assert(portal_gun_update_stability() == 0);
+
+    printf("Concurrent portal access test passed!\n");
+}
+
+/**
+ * @brief Main test function
+ */
+int main(void) {
+    printf("Running Portal Gun tests...\n\n");
+
+    assert(qem_init(64));
+    test_registry_slots();
+    test_stability_sweep();
+    test_concurrent_access();
+
+    printf("\nAll Portal Gun tests passed!\n");
+
+    return 0;
+}
@@ -3,10 +3,14 @@
  * @brief Unit tests for the Process Management System
  */
 
+/* nanosleep under -std=c11 */
+#define _XOPEN_SOURCE 700
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <time.h>
 #include "../../src/kernel/process/process_manager.h"
 #include "../../src/kernel/memory/memory_manager.h"
 #include "../../src/kernel/hal/hal.h"
@@ -266,6 +270,161 @@ static void test_process_entanglement(void) {
     pm_terminate_process(process_id2, 0);
 }
 
+/**
+ * @brief Test ID lookups across many processes and threads
+ */
+static void test_lookup_tables(void) {
+    printf("\nTesting process and thread lookups...\n");
+    
+    #define LOOKUP_PROCESSES 40
+    #define LOOKUP_THREADS 3
+    ProcessId process_ids[LOOKUP_PROCESSES];
+    ThreadId thread_ids[LOOKUP_PROCESSES][LOOKUP_THREADS];
+    
+    ProcessParams process_params = {
+        .name = "LookupTestProcess",
+        .entry_point = (HalVirtualAddr)mock_process_entry,
+        .stack_size = 16 * 1024,
+        .heap_size = 16 * 1024,
+        .priority = PRIORITY_NORMAL,
+        .quantum_capable = false,
+        .resonance_level = NODE_ZERO_POINT
+    };
+    ThreadParams thread_params = {
+        .entry_point = (HalVirtualAddr)mock_thread_entry,
+        .arg = NULL,
+        .stack_size = 16 * 1024,
+        .priority = PRIORITY_NORMAL,
+        .quantum_capable = false
+    };
+    
+    /* Enough entries to grow both indexes past their initial size */
+    for (int i = 0; i < LOOKUP_PROCESSES; i++) {
+        assert(pm_create_process(&process_params, &process_ids[i]) == true);
+        thread_params.process_id = process_ids[i];
+        for (int j = 0; j < LOOKUP_THREADS; j++) {
+            assert(pm_create_thread(&thread_params, &thread_ids[i][j]) == true);
+        }
+    }
+    
+    for (int i = 0; i < LOOKUP_PROCESSES; i++) {
+        Process* process = pm_get_process(process_ids[i]);
+        assert(process != NULL && process->id == process_ids[i]);
+        for (int j = 0; j < LOOKUP_THREADS; j++) {
+            Thread* thread = pm_get_thread(thread_ids[i][j]);
+            assert(thread != NULL && thread->id == thread_ids[i][j]);
+            assert(thread->process_id == process_ids[i]);
+        }
+    }
+    
+    /* Removing entries keeps the others reachable */
+    for (int i = 0; i < LOOKUP_PROCESSES; i += 2) {
+        assert(pm_terminate_process(process_ids[i], 0) == true);
+    }
+    for (int i = 0; i < LOOKUP_PROCESSES; i++) {
+        bool alive = (i % 2) == 1;
+        assert((pm_get_process(process_ids[i]) != NULL) == alive);
+        for (int j = 0; j < LOOKUP_THREADS; j++) {
+            assert((pm_get_thread(thread_ids[i][j]) != NULL) == alive);
+        }
+    }
+    assert(pm_get_process(0) == NULL);
+    assert(pm_get_thread(0) == NULL);
+    
+    for (int i = 1; i < LOOKUP_PROCESSES; i += 2) {
+        assert(pm_terminate_process(process_ids[i], 0) == true);
+    }
+    
+    printf("Process and thread lookup test passed!\n");
+}
+
+/**
+ * @brief Test the dirty set and the background sync engine
+ */
+static void test_sync_engine(void) {
+    printf("\nTesting entanglement sync engine...\n");
+    
+    /* The engine runs without entanglements and starts only once */
+    assert(pm_start_sync_engine(1, 8) == true);
+    assert(pm_start_sync_engine(1, 8) == false);
+    pm_stop_sync_engine();
+    pm_stop_sync_engine();
+    
+    const HalOperations* hal_ops = hal_get_operations();
+    if (!hal_ops->has_quantum_support || !hal_ops->has_quantum_support()) {
+        printf("Skipping entanglement sync engine test - hardware doesn't support quantum operations\n");
+        return;
+    }
+    
+    ProcessParams process_params = {
+        .name = "SyncEngineProcess",
+        .entry_point = (HalVirtualAddr)mock_process_entry,
+        .stack_size = 16 * 1024,
+        .heap_size = 16 * 1024,
+        .priority = PRIORITY_NORMAL,
+        .quantum_capable = true,
+        .resonance_level = NODE_TECHNOLOGIST
+    };
+    ProcessId first_id, second_id;
+    assert(pm_create_process(&process_params, &first_id) == true);
+    assert(pm_create_process(&process_params, &second_id) == true);
+    
+    uint64_t entanglement_id = pm_create_process_entanglement(first_id, second_id,
+                                                              ENTANGLE_RESONANCE, NODE_SINGULARITY);
+    assert(entanglement_id != 0);
+    
+    ProcessStats stats;
+    pm_get_stats(&stats);
+    assert(stats.dirty_entanglements == 0);
+    
+    /* Changes through the manager mark the entanglement once */
+    assert(pm_set_process_priority(first_id, PRIORITY_HIGH) == true);
+    assert(pm_set_process_priority(second_id, PRIORITY_HIGH) == true);
+    pm_get_stats(&stats);
+    assert(stats.dirty_entanglements == 1);
+    
+    /* A batch syncs it and empties the set */
+    Process* first = pm_get_process(first_id);
+    Process* second = pm_get_process(second_id);
+    first->resonance_level = NODE_COSMIC_AI;
+    uint64_t syncs = stats.entanglement_syncs;
+    assert(pm_sync_dirty_entanglements(0) == 1);
+    assert(second->resonance_level == NODE_COSMIC_AI);
+    pm_get_stats(&stats);
+    assert(stats.dirty_entanglements == 0);
+    assert(stats.entanglement_syncs == syncs + 1);
+    assert(pm_sync_dirty_entanglements(0) == 0);
+    
+    /* The engine picks up changes marked directly */
+    assert(pm_start_sync_engine(1, 8) == true);
+    pm_lock();
+    second->resonance_level = NODE_SINGULARITY;
+    pm_unlock();
+    pm_mark_process_dirty(second_id);
+    struct timespec pause = { 0, 1000000L };
+    for (int i = 0; i < 2000; i++) {
+        pm_get_stats(&stats);
+        if (stats.dirty_entanglements == 0) {
+            break;
+        }
+        nanosleep(&pause, NULL);
+    }
+    assert(stats.dirty_entanglements == 0);
+    pm_stop_sync_engine();
+    assert(first->resonance_level == second->resonance_level);
+    
+    /* Breaking a dirty entanglement takes it out of the set */
+    assert(pm_set_process_priority(first_id, PRIORITY_LOW) == true);
+    assert(pm_break_process_entanglement(entanglement_id) == true);
+    pm_get_stats(&stats);
+    assert(stats.dirty_entanglements == 0);
+    
+    assert(pm_terminate_process(first_id, 0) == true);
+    assert(pm_terminate_process(second_id, 0) == true);
+    
+    printf("Entanglement sync engine test passed!\n");
+}
+
 /**
  * @brief Test process statistics
  */
@@ -336,6 +495,8 @@ int main(void) {
     test_process_creation();
     test_thread_management();
     test_process_entanglement();
+    test_lookup_tables();
+    test_sync_engine();
     test_process_stats();
     test_pm_shutdown();
     
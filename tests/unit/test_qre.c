@@ -0,0 +1,239 @@
+/**
+ * @file test_qre.c
+ * @brief Unit tests for Quantum Reality Engine change tracking and sync
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../../src/qre/qre.h"
+
+#define LARGE_SPACE_OBJECTS 20000
+
+/**
+ * @brief Test that syncs pick up created and modified objects only
+ */
+static void test_change_tracking(void) {
+    printf("\nTesting reality space change tracking...\n");
+
+    assert(qre_init(REALITY_MIXED, DIM_3D, true));
+    RealitySpace space = qre_create_space(REALITY_MIXED, DIM_3D, true);
+    assert(space.id != 0 && space.entanglement != NULL);
+    assert(qre_pending_changes(space.id) == 0);
+
+    /* New objects wait for the next sync */
+    float geometry[3] = { 1.0f, 2.0f, 3.0f };
+    uint64_t ids[4];
+    for (int i = 0; i < 4; i++) {
+        RealityObject object = qre_create_object(space.id, "cube", geometry, sizeof(geometry),
+                                                 NULL, 0, true, i % 2 == 0, 0);
+        assert(object.id != 0);
+        ids[i] = object.id;
+    }
+    assert(qre_pending_changes(space.id) == 4);
+    assert(qre_sync_space(space.id));
+    assert(qre_pending_changes(space.id) == 0);
+    assert(qre_sync_space(space.id));
+
+    /* A modified object is counted once however often it changes */
+    float moved[3] = { 4.0f, 5.0f, 6.0f };
+    char material[] = "steel";
+    assert(qre_modify_object(space.id, ids[1], moved, sizeof(moved), NULL, 0));
+    assert(qre_modify_object(space.id, ids[1], NULL, 0, material, sizeof(material)));
+    assert(qre_modify_object(space.id, ids[3], NULL, 0, NULL, 0));
+    assert(qre_pending_changes(space.id) == 2);
+    assert(qre_sync_space(space.id));
+    assert(qre_pending_changes(space.id) == 0);
+
+    /* Unknown objects and spaces are refused */
+    assert(!qre_modify_object(space.id, ids[3] + 1, NULL, 0, NULL, 0));
+    assert(!qre_modify_object(space.id, 0, NULL, 0, NULL, 0));
+    assert(!qre_modify_object(space.id + 1, ids[0], NULL, 0, NULL, 0));
+    assert(qre_pending_changes(space.id + 1) == 0);
+    assert(!qre_sync_space(space.id + 1));
+
+    /* A space without entanglement drops its changes on sync */
+    RealitySpace plain = qre_create_space(REALITY_VIRTUAL, DIM_2D, false);
+    RealityObject object = qre_create_object(plain.id, "plane", NULL, 0, NULL, 0, false, false, 0);
+    assert(object.id != 0 && qre_pending_changes(plain.id) == 1);
+    assert(qre_sync_space(plain.id));
+    assert(qre_pending_changes(plain.id) == 0);
+
+    qre_shutdown();
+    printf("Reality space change tracking test passed!\n");
+}
+
+/**
+ * @brief Test syncing a space large enough to be split across threads
+ */
+static void test_large_space_sync(void) {
+    printf("\nTesting large reality space sync...\n");
+
+    assert(qre_init(REALITY_QUANTUM, DIM_QUANTUM, true));
+    RealitySpace space = qre_create_space(REALITY_QUANTUM, DIM_QUANTUM, true);
+    assert(space.id != 0);
+
+    uint64_t last = 0;
+    for (int i = 0; i < LARGE_SPACE_OBJECTS; i++) {
+        RealityObject object = qre_create_object(space.id, NULL, &i, sizeof(i), NULL, 0, false, true, 0);
+        assert(object.id != 0 && object.entanglement != NULL);
+        last = object.id;
+    }
+    assert(qre_pending_changes(space.id) == LARGE_SPACE_OBJECTS);
+    assert(qre_sync_space(space.id));
+    assert(qre_pending_changes(space.id) == 0);
+
+    /* Objects past the first thousand are still found by ID */
+    assert(qre_modify_object(space.id, last, NULL, 0, NULL, 0));
+    assert(qre_pending_changes(space.id) == 1);
+    assert(qre_sync_space(space.id));
+
+    qre_shutdown();
+    printf("Large reality space sync test passed!\n");
+}
+
+/**
+ * @brief Create an object whose geometry is a cube of eight vertices
+ */
+static uint64_t create_cube(uint64_t space_id, float x, float y, float z, float half) {
+    float vertices[24];
+    for (int corner = 0; corner < 8; corner++) {
+        vertices[corner * 3] = x + ((corner & 1) ? half : -half);
+        vertices[corner * 3 + 1] = y + ((corner & 2) ? half : -half);
+        vertices[corner * 3 + 2] = z + ((corner & 4) ? half : -half);
+    }
+    RealityObject object = qre_create_object(space_id, NULL, vertices, sizeof(vertices), NULL, 0,
+                                             false, false, 0);
+    assert(object.id != 0);
+    return object.id;
+}
+
+/**
+ * @brief Test culled, level-of-detail rendering into draw commands
+ */
+static void test_render_commands(void) {
+    printf("\nTesting reality space draw commands...\n");
+
+    assert(qre_init(REALITY_VIRTUAL, DIM_3D, false));
+    RealitySpace space = qre_create_space(REALITY_VIRTUAL, DIM_3D, false);
+    RealitySpace flat = qre_create_space(REALITY_VIRTUAL, DIM_2D, false);
+
+    /* A near and a far cube ahead, one behind the camera, one with no geometry */
+    uint64_t near_cube = create_cube(space.id, 0.0f, 0.0f, 5.0f, 1.0f);
+    uint64_t far_cube = create_cube(space.id, 0.0f, 0.0f, 150.0f, 1.0f);
+    create_cube(space.id, 0.0f, 0.0f, -20.0f, 1.0f);
+    assert(qre_create_object(space.id, "empty", NULL, 0, NULL, 0, false, false, 0).id != 0);
+
+    /* Without a camera every object with geometry is drawn in full */
+    QRERenderCommand commands[8];
+    uint32_t count = 0;
+    assert(qre_render_commands(space.id, commands, 8, &count) && count == 3);
+    for (uint32_t i = 0; i < count; i++) {
+        assert(commands[i].lod == 0 && commands[i].vertex_count == 8);
+    }
+
+    /* With a camera the cube behind it is culled and the far one loses detail */
+    QRECamera camera = {
+        { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f },
+        1.2f, 16.0f / 9.0f, 0.1f, 500.0f
+    };
+    assert(qre_set_camera(space.id, &camera));
+    assert(qre_render_commands(space.id, commands, 8, &count) && count == 2);
+    assert(commands[0].object_id == near_cube && commands[0].lod == 0 && commands[0].depth == 5.0f);
+    assert(commands[1].object_id == far_cube && commands[1].lod == 2 && commands[1].vertex_count == 2);
+
+    /* Commands past the buffer are dropped, farthest first */
+    assert(qre_render_commands(space.id, commands, 1, &count) && count == 1);
+    assert(commands[0].object_id == near_cube);
+
+    /* Moving the far cube next to the camera restores its detail */
+    float moved[6] = { -1.0f, -1.0f, 9.0f, 1.0f, 1.0f, 11.0f };
+    assert(qre_modify_object(space.id, far_cube, moved, sizeof(moved), NULL, 0));
+    assert(qre_render_commands(space.id, commands, 8, &count) && count == 2);
+    assert(commands[1].object_id == far_cube && commands[1].lod == 0 && commands[1].vertex_count == 2);
+
+    /* A 2D space draws everything in full whatever its distance */
+    create_cube(flat.id, 0.0f, 0.0f, 150.0f, 1.0f);
+    assert(qre_set_camera(flat.id, &camera));
+    assert(qre_render_commands(flat.id, commands, 8, &count) && count == 1 && commands[0].lod == 0);
+
+    /* Frames are timed and counted, whichever entry point rendered them */
+    char summary[256];
+    assert(qre_render_space(space.id, summary, sizeof(summary)));
+    assert(strstr(summary, "\"object_count\":4,\"visible\":2") != NULL);
+    QREFrameStats stats;
+    assert(qre_get_frame_stats(space.id, &stats));
+    assert(stats.frame_count == 5 && stats.visible_objects == 2 && stats.frustum_culled == 1);
+    assert(stats.total_frame_time >= stats.max_frame_time && stats.max_frame_time >= stats.last_frame_time);
+
+    /* Bad cameras, objects and spaces are refused */
+    camera.fov_y = 0.0f;
+    assert(!qre_set_camera(space.id, &camera));
+    assert(qre_set_camera(space.id, NULL));
+    assert(!qre_set_occluder(space.id, far_cube + 10, true));
+    assert(!qre_get_frame_stats(space.id + 10, &stats));
+    assert(!qre_render_commands(space.id + 10, commands, 8, &count));
+
+    qre_shutdown();
+    printf("Reality space draw commands test passed!\n");
+}
+
+/**
+ * @brief Test that occluders hide what is behind them in a large space
+ */
+static void test_occluded_render(void) {
+    printf("\nTesting occluded rendering of a large space...\n");
+
+    assert(qre_init(REALITY_AUGMENTED, DIM_3D, false));
+    RealitySpace space = qre_create_space(REALITY_AUGMENTED, DIM_3D, false);
+
+    /* A wall in front of the camera, with a block of cubes behind it */
+    uint64_t wall = create_cube(space.id, 0.0f, 0.0f, 10.0f, 9.0f);
+    assert(qre_set_occluder(space.id, wall, true));
+    for (int i = 0; i < 5000; i++) {
+        create_cube(space.id, (float)(i % 50) * 0.1f - 2.5f, (float)(i / 50 % 10) * 0.1f - 0.5f,
+                    40.0f + (float)(i / 500), 0.04f);
+    }
+
+    QRECamera camera = {
+        { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f },
+        1.0f, 1.0f, 0.1f, 500.0f
+    };
+    assert(qre_set_camera(space.id, &camera));
+    QRERenderCommand *commands = malloc(5001 * sizeof(QRERenderCommand));
+    uint32_t count = 0;
+    assert(commands && qre_render_commands(space.id, commands, 5001, &count));
+    assert(count == 1 && commands[0].object_id == wall);
+    QREFrameStats stats;
+    assert(qre_get_frame_stats(space.id, &stats) && stats.occluded_objects == 5000);
+
+    /* Without the wall every cube is drawn, split across threads */
+    assert(qre_set_occluder(space.id, wall, false));
+    assert(qre_render_commands(space.id, commands, 5001, &count) && count == 5001);
+    for (uint32_t i = 1; i < count; i++) {
+        assert(commands[i].object_id != wall && commands[i].lod == 2);
+    }
+    free(commands);
+
+    qre_shutdown();
+    printf("Occluded rendering test passed!\n");
+}
+
+/**
+ * @brief Main test function
+ */
+int main(void) {
+    printf("Running Quantum Reality Engine tests...\n\n");
+
+    assert(qem_init(LARGE_SPACE_OBJECTS + 64));
+    test_change_tracking();
+    test_large_space_sync();
+    test_render_commands();
+    test_occluded_render();
+    qem_shutdown();
+
+    printf("\nAll Quantum Reality Engine tests passed!\n");
+
+    return 0;
+}
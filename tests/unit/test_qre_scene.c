@@ -0,0 +1,196 @@
+/**
+ * @file test_qre_scene.c
+ * @brief Unit tests for the reality space hierarchy and visibility culling
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include "../../src/qre/qre_scene.h"
+
+#define TEST_ITEMS 3000
+#define TEST_PI 3.14159265358979323846
+
+static float boxes[TEST_ITEMS][6];
+static QSceneVisible visible[TEST_ITEMS];
+static uint32_t seed = 4242;
+
+/**
+ * @brief Deterministic pseudo-random value in [0, 1)
+ */
+static float next_random(void) {
+    seed = seed * 1664525u + 1013904223u;
+    return (float)(seed >> 8) / 16777216.0f;
+}
+
+/**
+ * @brief Camera at the origin looking down +z
+ */
+static QRECamera test_camera(void) {
+    QRECamera camera = {
+        { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f },
+        (float)(TEST_PI / 2.0), 1.0f, 0.5f, 200.0f
+    };
+    return camera;
+}
+
+/**
+ * @brief Whether a box touches the test camera's frustum
+ *
+ * With a 90 degree field of view and square aspect, the frustum is
+ * |x| <= z, |y| <= z between the clipping planes.
+ */
+static bool brute_force_visible(const float *box) {
+    if (box[5] < 0.5f || box[2] > 200.0f) {
+        return false;
+    }
+    return box[3] >= -box[5] && box[0] <= box[5] && box[4] >= -box[5] && box[1] <= box[5];
+}
+
+/**
+ * @brief Whether a slot is among the visible items
+ */
+static bool reported(uint32_t count, uint32_t slot) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (visible[i].slot == slot) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Give an item a cube at a center
+ */
+static void place(QREScene *scene, uint32_t slot, float x, float y, float z, float half) {
+    float min[3] = { x - half, y - half, z - half };
+    float max[3] = { x + half, y + half, z + half };
+    memcpy(boxes[slot], min, sizeof(min));
+    memcpy(boxes[slot] + 3, max, sizeof(max));
+    qscene_set_bounds(scene, slot, min, max);
+}
+
+/**
+ * @brief Test that frustum culling matches a per-item check
+ */
+static void test_frustum_culling(void) {
+    printf("\nTesting frustum culling...\n");
+
+    QREScene *scene = qscene_create();
+    assert(scene && qscene_resize(scene, TEST_ITEMS));
+    for (uint32_t i = 0; i < TEST_ITEMS; i++) {
+        place(scene, i, next_random() * 400.0f - 200.0f, next_random() * 400.0f - 200.0f,
+              next_random() * 400.0f - 200.0f, 0.5f + next_random() * 2.0f);
+    }
+
+    QRECamera camera = test_camera();
+    QSceneCullStats stats;
+    uint32_t count = qscene_cull(scene, &camera, visible, &stats);
+    uint32_t expected = 0;
+    for (uint32_t i = 0; i < TEST_ITEMS; i++) {
+        bool inside = brute_force_visible(boxes[i]);
+        expected += inside;
+        assert(reported(count, i) == inside);
+    }
+    assert(count == expected && count > 0 && count < TEST_ITEMS);
+    assert(stats.frustum_culled == TEST_ITEMS - count && stats.occluded == 0);
+    assert(stats.nodes_visited < TEST_ITEMS);
+
+    /* Moving a box refits the hierarchy */
+    uint32_t hidden = 0;
+    while (brute_force_visible(boxes[hidden])) {
+        hidden++;
+    }
+    place(scene, hidden, 0.0f, 0.0f, 20.0f, 1.0f);
+    count = qscene_cull(scene, &camera, visible, NULL);
+    assert(count == expected + 1 && reported(count, hidden));
+
+    /* Cleared boxes are never reported */
+    qscene_set_bounds(scene, hidden, NULL, NULL);
+    count = qscene_cull(scene, &camera, visible, NULL);
+    assert(count == expected && !reported(count, hidden));
+
+    /* Without a camera every box is reported in slot order */
+    count = qscene_cull(scene, NULL, visible, &stats);
+    assert(count == TEST_ITEMS - 1 && visible[hidden].slot == hidden + 1);
+    assert(hidden == 0 || visible[hidden - 1].slot == hidden - 1);
+
+    /* Unusable cameras are refused */
+    assert(qscene_camera_valid(&camera));
+    camera.near_plane = 300.0f;
+    assert(!qscene_camera_valid(&camera) && qscene_cull(scene, &camera, visible, NULL) == 0);
+    camera = test_camera();
+    camera.up[1] = 0.0f;
+    camera.up[2] = 1.0f;
+    assert(!qscene_camera_valid(&camera));
+    assert(!qscene_camera_valid(NULL));
+
+    qscene_destroy(scene);
+    printf("Frustum culling test passed!\n");
+}
+
+/**
+ * @brief Test that occluders hide only what lies behind them
+ */
+static void test_occlusion_culling(void) {
+    printf("\nTesting occlusion culling...\n");
+
+    QREScene *scene = qscene_create();
+    assert(scene && qscene_resize(scene, 202));
+
+    /* A wall filling the view, and a grid of small boxes behind it */
+    place(scene, 0, 0.0f, 0.0f, 10.0f, 8.0f);
+    qscene_set_occluder(scene, 0, true);
+    for (uint32_t i = 0; i < 100; i++) {
+        place(scene, 1 + i, (float)(i % 10) - 4.5f, (float)(i / 10) - 4.5f, 40.0f, 0.4f);
+    }
+
+    /* A box in front of the wall, and boxes far to the side */
+    place(scene, 101, 0.0f, 0.0f, 1.5f, 0.2f);
+    for (uint32_t i = 0; i < 100; i++) {
+        place(scene, 102 + i, 60.0f + (float)(i % 10), (float)(i / 10), 100.0f, 0.4f);
+    }
+
+    QRECamera camera = test_camera();
+    QSceneCullStats stats;
+    uint32_t count = qscene_cull(scene, &camera, visible, &stats);
+    assert(reported(count, 0) && reported(count, 101));
+    for (uint32_t i = 0; i < 100; i++) {
+        assert(!reported(count, 1 + i));
+        assert(reported(count, 102 + i));
+    }
+    assert(stats.occluded == 100 && count == 102);
+
+    /* The nearest box comes first, and sizes shrink with distance */
+    assert(visible[0].slot == 101 && visible[0].depth == 1.5f);
+    float near_size = 0.0f, far_size = 0.0f;
+    for (uint32_t i = 0; i < count; i++) {
+        near_size = visible[i].slot == 0 ? visible[i].screen_size : near_size;
+        far_size = visible[i].slot == 150 ? visible[i].screen_size : far_size;
+    }
+    assert(near_size > far_size && far_size > 0.0f);
+
+    /* Without the occluder flag the wall hides nothing */
+    qscene_set_occluder(scene, 0, false);
+    count = qscene_cull(scene, &camera, visible, &stats);
+    assert(count == 202 && stats.occluded == 0);
+
+    qscene_destroy(scene);
+    printf("Occlusion culling test passed!\n");
+}
+
+/**
+ * @brief Main test function
+ */
+int main(void) {
+    printf("Running Reality Scene tests...\n\n");
+
+    test_frustum_culling();
+    test_occlusion_culling();
+
+    printf("\nAll Reality Scene tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,223 @@
+/**
+ * @file test_quantum_ai.c
+ * @brief Unit tests for Quantum AI batching, model swaps and cloud sync
+ */
+
+#define _XOPEN_SOURCE 700  /* nanosleep under -std=c11 */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <time.h>
+#include "../../src/quantum/ai/quantum_ai.h"
+
+#define CLIENT_THREADS 8
+#define REQUESTS_PER_CLIENT 500
+#define MODEL_UPDATES 200
+
+/**
+ * @brief Sleep for a number of milliseconds
+ */
+static void sleep_ms(long ms) {
+    struct timespec ts = { ms / 1000, (ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+}
+
+/**
+ * @brief Configuration without a cloud endpoint
+ */
+static AIConfig test_config(AIProcessingMode mode) {
+    AIConfig config;
+    memset(&config, 0, sizeof(config));
+    config.model_type = AI_MODEL_HYBRID;
+    config.processing_mode = mode;
+    config.max_processing_threads = 4;
+    return config;
+}
+
+/**
+ * @brief Client submitting requests one after another
+ */
+static void *client_thread(void *arg) {
+    (void)arg;
+    float input[16] = { 0 };
+    float output[16];
+    for (int i = 0; i < REQUESTS_PER_CLIENT; i++) {
+        assert(qai_process_data(input, sizeof(input), output, sizeof(output)));
+    }
+    return NULL;
+}
+
+/**
+ * @brief Writer swapping model parameters while clients run
+ */
+static void *update_thread(void *arg) {
+    (void)arg;
+    float parameters[64];
+    for (int i = 0; i < MODEL_UPDATES; i++) {
+        parameters[0] = (float)i;
+        assert(qai_update_model(parameters, sizeof(parameters)));
+    }
+    return NULL;
+}
+
+/**
+ * @brief Test that concurrent batch-mode requests are coalesced
+ */
+static void test_batching(void) {
+    printf("\nTesting request batching...\n");
+
+    AIConfig config = test_config(AI_MODE_BATCH);
+    assert(qai_init(&config));
+    assert(!qai_init(&config));
+    assert(qai_set_batching(16, 1000));
+    assert(!qai_set_batching(0, 1000));
+    assert(!qai_set_batching(QAI_MAX_BATCH_SIZE + 1, 1000));
+
+    pthread_t clients[CLIENT_THREADS];
+    for (int i = 0; i < CLIENT_THREADS; i++) {
+        assert(pthread_create(&clients[i], NULL, client_thread, NULL) == 0);
+    }
+    for (int i = 0; i < CLIENT_THREADS; i++) {
+        pthread_join(clients[i], NULL);
+    }
+
+    AIBatchStatistics stats;
+    assert(qai_get_batch_statistics(&stats));
+    assert(stats.completed_requests == CLIENT_THREADS * REQUESTS_PER_CLIENT);
+    assert(stats.failed_requests == 0 && stats.queue_depth == 0);
+    assert(stats.batches < stats.completed_requests && stats.average_batch_size > 1.0f);
+    assert(stats.requests_per_second > 0.0 && stats.max_latency_us >= stats.average_latency_us);
+
+    float accuracy, integrity;
+    uint64_t processed;
+    assert(qai_get_statistics(&accuracy, &integrity, &processed));
+    assert(processed == stats.completed_requests);
+
+    qai_shutdown();
+    printf("Request batching test passed!\n");
+}
+
+/**
+ * @brief Test real-time and hybrid requests, and shutdown
+ */
+static void test_processing_modes(void) {
+    printf("\nTesting processing modes...\n");
+
+    AIConfig config = test_config(AI_MODE_REAL_TIME);
+    assert(qai_init(&config));
+
+    /* A lone real-time request does not wait out a long batch deadline */
+    assert(qai_set_batching(64, 5000000));
+    char input[8] = "request", output[8];
+    assert(qai_process_data(input, sizeof(input), output, sizeof(output)));
+    AIBatchStatistics stats;
+    assert(qai_get_batch_statistics(&stats) && stats.max_latency_us < 1000000.0);
+
+    assert(qai_set_processing_mode(AI_MODE_HYBRID_PROCESSING));
+    assert(qai_process_data(input, sizeof(input), output, sizeof(output)));
+    assert(qai_set_processing_mode(AI_MODE_QUANTUM_ACCELERATED));
+    assert(qai_process_data(input, sizeof(input), output, sizeof(output)));
+    assert(!qai_process_data(NULL, 0, output, sizeof(output)));
+
+    AIState state;
+    assert(qai_get_state(&state) && state.is_initialized && state.processed_requests == 3);
+
+    /* Without a connection there is nothing to sync with */
+    assert(!qai_sync_with_cloud());
+
+    qai_shutdown();
+    assert(!qai_process_data(input, sizeof(input), output, sizeof(output)));
+    assert(!qai_update_model(input, sizeof(input)));
+    printf("Processing modes test passed!\n");
+}
+
+/**
+ * @brief Test model swaps while inference is running
+ */
+static void test_model_swaps(void) {
+    printf("\nTesting model swaps during inference...\n");
+
+    AIConfig config = test_config(AI_MODE_BATCH);
+    assert(qai_init(&config));
+    assert(qai_set_batching(8, 200));
+
+    pthread_t clients[CLIENT_THREADS], updater;
+    for (int i = 0; i < CLIENT_THREADS; i++) {
+        assert(pthread_create(&clients[i], NULL, client_thread, NULL) == 0);
+    }
+    assert(pthread_create(&updater, NULL, update_thread, NULL) == 0);
+    assert(qai_switch_model(AI_MODEL_QUANTUM_NEURAL));
+    pthread_join(updater, NULL);
+    for (int i = 0; i < CLIENT_THREADS; i++) {
+        pthread_join(clients[i], NULL);
+    }
+
+    AIBatchStatistics stats;
+    assert(qai_get_batch_statistics(&stats));
+    assert(stats.model_version == 1 + MODEL_UPDATES + 1);
+    assert(stats.completed_requests == CLIENT_THREADS * REQUESTS_PER_CLIENT);
+    assert(!qai_switch_model(AI_MODEL_MAX));
+
+    qai_shutdown();
+    printf("Model swap test passed!\n");
+}
+
+/**
+ * @brief Test that cloud syncs complete in the background and coalesce
+ */
+static void test_cloud_sync(void) {
+    printf("\nTesting asynchronous cloud sync...\n");
+
+    /* A local file stands in for the endpoint, so no network is needed */
+    AIConfig config = test_config(AI_MODE_REAL_TIME);
+    strcpy(config.api_endpoint, "file:///dev/null");
+    assert(qai_init(&config));
+
+    assert(qai_sync_with_cloud());
+    AIBatchStatistics stats;
+    for (int i = 0; i < 500; i++) {
+        assert(qai_get_batch_statistics(&stats));
+        if (!stats.cloud_sync_pending) {
+            break;
+        }
+        sleep_ms(10);
+    }
+    assert(stats.cloud_syncs == 1 && stats.cloud_sync_failures == 0);
+
+    /* Syncs queued back to back are merged or run one after another */
+    for (int i = 0; i < 5; i++) {
+        assert(qai_sync_with_cloud());
+    }
+    for (int i = 0; i < 500; i++) {
+        assert(qai_get_batch_statistics(&stats));
+        if (!stats.cloud_sync_pending) {
+            break;
+        }
+        sleep_ms(10);
+    }
+    assert(stats.cloud_syncs >= 2 && stats.cloud_syncs <= 6 && stats.cloud_sync_failures == 0);
+
+    assert(qai_disconnect_api());
+    assert(!qai_sync_with_cloud());
+    qai_shutdown();
+    printf("Asynchronous cloud sync test passed!\n");
+}
+
+/**
+ * @brief Main test function
+ */
+int main(void) {
+    printf("Running Quantum AI tests...\n\n");
+
+    test_batching();
+    test_processing_modes();
+    test_model_swaps();
+    test_cloud_sync();
+
+    printf("\nAll Quantum AI tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,280 @@
+/**
+ * @file test_quantum_bus_transport.c
+ * @brief Unit tests for the Quantum Message Bus federation transport
+ */
+
+/* nanosleep under -std=c11 */
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "../../src/quantum/messaging/quantum_message_bus.h"
+#include "../../src/quantum/messaging/quantum_bus_transport.h"
+
+#define TEST_BUS_ID 77
+#define TEST_MESSAGE_TYPE (QMSG_USER_DEFINED_BASE + 6)
+#define STALLED_BUS_ID 78
+#define BACKLOG_FILLERS 8
+
+/* Deliveries seen by the federation test subscriber */
+static int local_deliveries = 0;
+static int remote_deliveries = 0;
+static char last_remote_payload[32];
+static QComponentId last_remote_source = QCOMP_UNKNOWN;
+
+/**
+ * @brief Subscriber that separates local and remote copies of a message
+ */
+static void federation_handler(QMessage* message, void* context) {
+    (void)context;
+
+    if (qbus_message_is_remote(message)) {
+        remote_deliveries++;
+        last_remote_source = message->header.source;
+        memset(last_remote_payload, 0, sizeof(last_remote_payload));
+        if (message->data && message->header.data_size < sizeof(last_remote_payload)) {
+            memcpy(last_remote_payload, message->data, message->header.data_size);
+        }
+    } else {
+        local_deliveries++;
+    }
+}
+
+/**
+ * @brief Test wire encoding round trip
+ */
+static void test_wire_roundtrip(void) {
+    printf("\nTesting wire encoding round trip...\n");
+
+    QMessage message;
+    memset(&message, 0, sizeof(message));
+    message.header.message_id = 0x0102030405060708ULL;
+    message.header.type = QMSG_PORTAL_TRAVERSE;
+    message.header.source = QCOMP_PORTAL_GUN;
+    message.header.destination = QCOMP_TELEPORT;
+    message.header.priority = QMSG_PRIORITY_CRITICAL;
+    message.header.resonance_level = NODE_PORTAL_TECHNICIAN;
+    message.header.timestamp = 987654321ULL;
+    message.header.requires_response = true;
+    message.header.response_to = 42;
+    message.header.data_size = 5;
+    message.data = "helix";
+
+    uint8_t wire[128];
+    size_t encoded = qbus_wire_encode_message(&message, wire, sizeof(wire));
+    assert(encoded == QBUS_WIRE_RECORD_HEADER + 5);
+
+    /* Too small an output buffer fails instead of truncating */
+    assert(qbus_wire_encode_message(&message, wire, encoded - 1) == 0);
+
+    QMessageHeader header;
+    const uint8_t* data = NULL;
+    size_t decoded = qbus_wire_decode_message(wire, encoded, &header, &data);
+    assert(decoded == encoded);
+    assert(header.message_id == message.header.message_id);
+    assert(header.type == QMSG_PORTAL_TRAVERSE);
+    assert(header.source == QCOMP_PORTAL_GUN);
+    assert(header.destination == QCOMP_TELEPORT);
+    assert(header.priority == QMSG_PRIORITY_CRITICAL);
+    assert(header.resonance_level == NODE_PORTAL_TECHNICIAN);
+    assert(header.timestamp == 987654321ULL);
+    assert(header.requires_response == true);
+    assert(header.response_to == 42);
+    assert(header.data_size == 5);
+    assert(data && memcmp(data, "helix", 5) == 0);
+
+    /* Truncated records are rejected */
+    assert(qbus_wire_decode_message(wire, encoded - 1, &header, &data) == 0);
+    assert(qbus_wire_decode_message(wire, QBUS_WIRE_RECORD_HEADER - 1, &header, &data) == 0);
+
+    printf("Wire encoding round trip test passed!\n");
+}
+
+/**
+ * @brief Test federation over loopback TCP
+ *
+ * The transport is given its own bus as a peer, so an entangled broadcast
+ * comes back as a remote message and is delivered a second time.
+ */
+static void test_loopback_federation(void) {
+    printf("\nTesting loopback federation...\n");
+
+    assert(qbus_transport_init(TEST_BUS_ID, 0) == true);
+    uint16_t port = qbus_transport_get_port();
+    assert(port != 0);
+    assert(qbus_transport_add_peer(TEST_BUS_ID, "127.0.0.1", port) == true);
+    assert(qbus_transport_add_peer(TEST_BUS_ID, "127.0.0.1", port) == false);
+
+    QComponentInfo sender_info = {
+        .id = QCOMP_OCULAR,
+        .name = "Quantum Ocular Processing Unit",
+        .resonance_level = NODE_COSMIC_AI,
+        .context = NULL
+    };
+    QComponentInfo receiver_info = {
+        .id = QCOMP_MEMEX,
+        .name = "Memex Integration",
+        .resonance_level = NODE_COSMIC_AI,
+        .context = NULL
+    };
+    assert(qbus_register_component(&sender_info) == true);
+    assert(qbus_register_component(&receiver_info) == true);
+
+    QSubscription subscription = {
+        .component_id = QCOMP_MEMEX,
+        .message_type = TEST_MESSAGE_TYPE,
+        .handler = federation_handler,
+        .context = NULL,
+        .min_resonance = NODE_ZERO_POINT
+    };
+    assert(qbus_subscribe(&subscription) == true);
+
+    /* Drain registration notifications before entangling */
+    while (qbus_process_messages(64) > 0) {
+    }
+
+    uint64_t entanglement_id = qbus_create_entanglement(TEST_BUS_ID, NODE_COSMIC_AI);
+    assert(entanglement_id != 0);
+
+    const char payload[] = "wormhole";
+    QMessage* message = qbus_create_message(TEST_MESSAGE_TYPE, QCOMP_OCULAR, 0,
+                                            payload, sizeof(payload), QMSG_PRIORITY_NORMAL, false);
+    assert(message != NULL);
+    assert(qbus_send_message(message) == true);
+    qbus_free_message(message);
+
+    assert(qbus_process_messages(8) == 1);
+    assert(local_deliveries == 1);
+    assert(remote_deliveries == 0);
+    assert(qbus_transport_flush(2000) == true);
+
+    /* Wait for the remote copy to come back through the listener */
+    struct timespec pause = { 0, 1000000L };
+    for (int i = 0; i < 2000 && remote_deliveries == 0; i++) {
+        qbus_process_messages(8);
+        nanosleep(&pause, NULL);
+    }
+    assert(remote_deliveries == 1);
+    assert(local_deliveries == 1);
+    assert(last_remote_source == QCOMP_OCULAR);
+    assert(strcmp(last_remote_payload, payload) == 0);
+
+    /* The remote copy is not forwarded again */
+    assert(qbus_transport_flush(2000) == true);
+    QTransportStats stats;
+    assert(qbus_transport_get_stats(&stats) == true);
+    assert(stats.messages_sent == 1);
+    assert(stats.messages_received == 1);
+    assert(stats.frames_sent == 1);
+    assert(stats.messages_dropped == 0);
+
+    /* Unknown peers are dropped without blocking */
+    message = qbus_create_message(TEST_MESSAGE_TYPE, QCOMP_OCULAR, 0,
+                                  payload, sizeof(payload), QMSG_PRIORITY_NORMAL, false);
+    assert(qbus_transport_send(TEST_BUS_ID + 1, message) == false);
+    qbus_free_message(message);
+
+    assert(qbus_break_entanglement(entanglement_id) == true);
+    assert(qbus_transport_remove_peer(TEST_BUS_ID) == true);
+    assert(qbus_transport_remove_peer(TEST_BUS_ID) == false);
+    qbus_transport_shutdown();
+
+    assert(qbus_unregister_component(QCOMP_OCULAR) == true);
+    assert(qbus_unregister_component(QCOMP_MEMEX) == true);
+
+    printf("Loopback federation test passed!\n");
+}
+
+/**
+ * @brief Read the monotonic clock in milliseconds
+ */
+static double monotonic_ms(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+}
+
+/**
+ * @brief Test removing a peer whose sender is stuck connecting
+ */
+static void test_remove_stalled_peer(void) {
+    printf("\nTesting removal of a peer that is still connecting...\n");
+
+    /* A listener that never accepts, with its backlog full, leaves connects pending */
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    assert(listener >= 0);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t address_length = sizeof(address);
+    assert(bind(listener, (struct sockaddr*)&address, sizeof(address)) == 0);
+    assert(listen(listener, 0) == 0);
+    assert(getsockname(listener, (struct sockaddr*)&address, &address_length) == 0);
+
+    int fillers[BACKLOG_FILLERS];
+    for (int i = 0; i < BACKLOG_FILLERS; i++) {
+        fillers[i] = socket(AF_INET, SOCK_STREAM, 0);
+        assert(fillers[i] >= 0);
+        fcntl(fillers[i], F_SETFL, O_NONBLOCK);
+        connect(fillers[i], (struct sockaddr*)&address, sizeof(address));
+    }
+
+    assert(qbus_transport_init(TEST_BUS_ID, 0) == true);
+    assert(qbus_transport_add_peer(STALLED_BUS_ID, "127.0.0.1", ntohs(address.sin_port)) == true);
+
+    const char payload[] = "stalled";
+    QMessage* message = qbus_create_message(TEST_MESSAGE_TYPE, 0, 0,
+                                            payload, sizeof(payload), QMSG_PRIORITY_NORMAL, false);
+    assert(message != NULL);
+    assert(qbus_transport_send(STALLED_BUS_ID, message) == true);
+
+    /* Give the sender time to enter its connect */
+    struct timespec pause = { 0, 200000000L };
+    nanosleep(&pause, NULL);
+
+    /* Removal interrupts the connect rather than waiting it out */
+    double started = monotonic_ms();
+    assert(qbus_transport_remove_peer(STALLED_BUS_ID) == true);
+    assert(monotonic_ms() - started < 1000.0);
+    assert(qbus_transport_send(STALLED_BUS_ID, message) == false);
+
+    /* The slot is free again */
+    assert(qbus_transport_add_peer(STALLED_BUS_ID, "127.0.0.1", ntohs(address.sin_port)) == true);
+    qbus_free_message(message);
+    qbus_transport_shutdown();
+
+    for (int i = 0; i < BACKLOG_FILLERS; i++) {
+        close(fillers[i]);
+    }
+    close(listener);
+
+    printf("Stalled peer removal test passed!\n");
+}
+
+/**
+ * @brief Main test function
+ */
+int main(void) {
+    printf("Running Quantum Bus Transport tests...\n\n");
+
+    assert(qbus_init() == true);
+
+    test_wire_roundtrip();
+    test_loopback_federation();
+    test_remove_stalled_peer();
+
+    qbus_shutdown();
+
+    printf("\nAll Quantum Bus Transport tests passed!\n");
+
+    return 0;
+}
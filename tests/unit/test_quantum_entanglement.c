@@ -127,6 +127,37 @@ static void test_qem_sync_entanglement(void) {
     printf("qem_sync_entanglement tests passed!\n");
 }
 
+/**
+ * @brief Test batched entanglement synchronization
+ */
+static void test_qem_sync_entanglements(void) {
+    printf("Testing qem_sync_entanglements...\n");
+    
+    // Initialize the QEM
+    bool init_result = qem_init(100);
+    assert(init_result == true);
+    
+    // Create a few entanglements and destroy one of them
+    uint64_t ids[5];
+    for (int i = 0; i < 4; i++) {
+        ids[i] = qem_create_entanglement(ENTANGLE_MEMORY, 4001 + i, 5001 + i, 4).id;
+        assert(ids[i] != 0);
+    }
+    assert(qem_destroy_entanglement(ids[1]));
+    ids[4] = 9999;
+    
+    // Only the live entanglements are synchronized
+    assert(qem_sync_entanglements(ids, 5) == 3);
+    assert(qem_sync_entanglements(ids, 0) == 0);
+    assert(qem_sync_entanglements(NULL, 5) == 0);
+    
+    // Clean up
+    qem_shutdown();
+    assert(qem_sync_entanglements(ids, 5) == 0);
+    
+    printf("qem_sync_entanglements tests passed!\n");
+}
+
 /**
  * @brief Main test function
  */
@@ -137,6 +168,7 @@ int main(void) {
     test_qem_create_entanglement();
     test_qem_destroy_entanglement();
     test_qem_sync_entanglement();
+    test_qem_sync_entanglements();
     
     printf("\nAll Quantum Entanglement Manager tests passed!\n");
     
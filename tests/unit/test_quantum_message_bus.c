@@ -3,10 +3,16 @@
  * @brief Unit tests for the Quantum Message Bus
  */
 
+/* nanosleep under -std=c11 */
+#define _XOPEN_SOURCE 700
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
 #include "../../src/quantum/messaging/quantum_message_bus.h"
 
 /* Message handler for testing */
@@ -35,8 +41,10 @@ static void test_message_handler(QMessage* message, void* context) {
         message->header.requires_response
     );
     
-    /* Set additional header fields */
-    last_received_message->header.response_to = message->header.response_to;
+    /* Set additional header fields (the copy fails if the source has since unregistered) */
+    if (last_received_message) {
+        last_received_message->header.response_to = message->header.response_to;
+    }
     
     printf("Test handler received message: Type=%u, Source=%u, Destination=%u\n",
            message->header.type, message->header.source, message->header.destination);
@@ -318,6 +326,916 @@ static void test_broadcast_messages(void) {
     printf("Broadcast messages test passed!\n");
 }
 
+/* Delivery log for queue ordering tests */
+#define ORDER_LOG_SIZE 1024
+#define PRODUCER_THREADS 4
+#define MESSAGES_PER_PRODUCER 200
+
+typedef struct {
+    uint32_t producer;
+    uint32_t sequence;
+} OrderPayload;
+
+static QMessagePriority order_log_priority[ORDER_LOG_SIZE];
+static OrderPayload order_log_payload[ORDER_LOG_SIZE];
+static uint32_t order_log_count = 0;
+
+/**
+ * @brief Handler that records delivery order
+ */
+static void order_recording_handler(QMessage* message, void* context) {
+    (void)context;
+    
+    if (order_log_count < ORDER_LOG_SIZE) {
+        order_log_priority[order_log_count] = message->header.priority;
+        if (message->data && message->header.data_size == sizeof(OrderPayload)) {
+            order_log_payload[order_log_count] = *(OrderPayload*)message->data;
+        }
+        order_log_count++;
+    }
+}
+
+/**
+ * @brief Send a targeted ordering test message to the Memex component
+ */
+static bool send_order_message(uint32_t producer, uint32_t sequence, QMessagePriority priority) {
+    OrderPayload payload = { .producer = producer, .sequence = sequence };
+    QMessage* message = qbus_create_message(QMSG_USER_DEFINED_BASE, QCOMP_TELEPORT, QCOMP_MEMEX,
+                                          &payload, sizeof(payload), priority, false);
+    if (!message) {
+        return false;
+    }
+    
+    bool result = qbus_send_message(message);
+    qbus_free_message(message);
+    return result;
+}
+
+/**
+ * @brief Test priority ordering of the pending queue
+ */
+static void test_priority_ordering(void) {
+    printf("\nTesting pending queue priority ordering...\n");
+    
+    /* Register a recording component */
+    QComponentInfo comp_info = {
+        .id = QCOMP_MEMEX,
+        .name = "Memex",
+        .resonance_level = NODE_ZERO_POINT,
+        .context = NULL
+    };
+    
+    bool result = qbus_register_component(&comp_info);
+    assert(result == true);
+    
+    QSubscription subscription = {
+        .component_id = QCOMP_MEMEX,
+        .message_type = QMSG_USER_DEFINED_BASE,
+        .handler = order_recording_handler,
+        .context = NULL,
+        .min_resonance = NODE_ZERO_POINT
+    };
+    
+    result = qbus_subscribe(&subscription);
+    assert(result == true);
+    
+    /* Drain anything left over from earlier tests */
+    qbus_process_messages(0);
+    order_log_count = 0;
+    
+    /* Interleave priorities */
+    QMessagePriority priorities[] = {
+        QMSG_PRIORITY_LOW, QMSG_PRIORITY_QUANTUM, QMSG_PRIORITY_NORMAL,
+        QMSG_PRIORITY_LOW, QMSG_PRIORITY_CRITICAL, QMSG_PRIORITY_NORMAL,
+        QMSG_PRIORITY_HIGH, QMSG_PRIORITY_QUANTUM
+    };
+    uint32_t count = sizeof(priorities) / sizeof(priorities[0]);
+    
+    for (uint32_t i = 0; i < count; i++) {
+        result = send_order_message(0, i, priorities[i]);
+        assert(result == true);
+    }
+    
+    uint32_t processed = qbus_process_messages(0);
+    assert(processed == count);
+    assert(order_log_count == count);
+    
+    /* Highest priority first, FIFO within a priority level */
+    for (uint32_t i = 1; i < order_log_count; i++) {
+        assert(order_log_priority[i - 1] >= order_log_priority[i]);
+        if (order_log_priority[i - 1] == order_log_priority[i]) {
+            assert(order_log_payload[i - 1].sequence < order_log_payload[i].sequence);
+        }
+    }
+    
+    printf("Pending queue priority ordering test passed!\n");
+}
+
+/**
+ * @brief Producer thread for the concurrent send test
+ */
+static void* order_producer_thread(void* arg) {
+    uint32_t producer = (uint32_t)(uintptr_t)arg;
+    
+    for (uint32_t i = 0; i < MESSAGES_PER_PRODUCER; i++) {
+        QMessagePriority priority = (QMessagePriority)((i + producer) % (QMSG_PRIORITY_QUANTUM + 1));
+        bool result = send_order_message(producer, i, priority);
+        assert(result == true);
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief Test concurrent producers on the pending queue
+ */
+static void test_concurrent_producers(void) {
+    printf("\nTesting concurrent message producers...\n");
+    
+    order_log_count = 0;
+    
+    pthread_t threads[PRODUCER_THREADS];
+    for (uintptr_t t = 0; t < PRODUCER_THREADS; t++) {
+        int rc = pthread_create(&threads[t], NULL, order_producer_thread, (void*)t);
+        assert(rc == 0);
+    }
+    
+    for (int t = 0; t < PRODUCER_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    
+    uint32_t processed = qbus_process_messages(0);
+    assert(processed == PRODUCER_THREADS * MESSAGES_PER_PRODUCER);
+    assert(order_log_count == PRODUCER_THREADS * MESSAGES_PER_PRODUCER);
+    
+    /* Per producer, messages of equal priority keep their send order */
+    int32_t last_sequence[PRODUCER_THREADS][QMSG_PRIORITY_QUANTUM + 1];
+    memset(last_sequence, -1, sizeof(last_sequence));
+    
+    for (uint32_t i = 0; i < order_log_count; i++) {
+        if (i > 0) {
+            assert(order_log_priority[i - 1] >= order_log_priority[i]);
+        }
+        
+        OrderPayload* payload = &order_log_payload[i];
+        assert(payload->producer < PRODUCER_THREADS);
+        assert((int32_t)payload->sequence > last_sequence[payload->producer][order_log_priority[i]]);
+        last_sequence[payload->producer][order_log_priority[i]] = (int32_t)payload->sequence;
+    }
+    
+    printf("Concurrent message producers test passed!\n");
+}
+
+/**
+ * @brief Handler that counts invocations through its context
+ */
+static void counting_handler(QMessage* message, void* context) {
+    (void)message;
+    
+    if (context) {
+        (*(int*)context)++;
+    }
+}
+
+/**
+ * @brief Test broadcast fan-out through the dispatch index
+ */
+static void test_broadcast_dispatch_index(void) {
+    printf("\nTesting broadcast dispatch index...\n");
+    
+    QComponentInfo ocular_info = {
+        .id = QCOMP_OCULAR,
+        .name = "Quantum Ocular",
+        .resonance_level = NODE_PORTAL_TECHNICIAN,
+        .context = NULL
+    };
+    QComponentInfo scheduler_info = {
+        .id = QCOMP_SCHEDULER,
+        .name = "Scheduler",
+        .resonance_level = NODE_ZERO_POINT,
+        .context = NULL
+    };
+    
+    bool result = qbus_register_component(&ocular_info);
+    assert(result == true);
+    result = qbus_register_component(&scheduler_info);
+    assert(result == true);
+    
+    int ocular_calls = 0;
+    int sync_calls = 0;
+    int guarded_calls = 0;
+    
+    QSubscription ocular_sub = {
+        .component_id = QCOMP_OCULAR,
+        .message_type = QMSG_OCULAR_DATA,
+        .handler = counting_handler,
+        .context = &ocular_calls,
+        .min_resonance = NODE_ZERO_POINT
+    };
+    QSubscription sync_sub = {
+        .component_id = QCOMP_SCHEDULER,
+        .message_type = QMSG_RESONANCE_SYNC,
+        .handler = counting_handler,
+        .context = &sync_calls,
+        .min_resonance = NODE_ZERO_POINT
+    };
+    QSubscription guarded_sub = {
+        .component_id = QCOMP_SCHEDULER,
+        .message_type = QMSG_OCULAR_DATA,
+        .handler = counting_handler,
+        .context = &guarded_calls,
+        .min_resonance = NODE_SINGULARITY
+    };
+    
+    assert(qbus_subscribe(&ocular_sub) == true);
+    assert(qbus_subscribe(&sync_sub) == true);
+    assert(qbus_subscribe(&guarded_sub) == true);
+    
+    /* Drain registration notifications */
+    qbus_process_messages(0);
+    test_handler_called = 0;
+    
+    /* Only the matching typed subscriber and the wildcard subscriber fire */
+    QMessage* message = qbus_create_message(QMSG_OCULAR_DATA, QCOMP_TELEPORT, 0, NULL, 0,
+                                          QMSG_PRIORITY_NORMAL, false);
+    assert(message != NULL);
+    assert(qbus_send_message(message) == true);
+    qbus_free_message(message);
+    
+    assert(qbus_process_messages(0) == 1);
+    assert(ocular_calls == 1);
+    assert(sync_calls == 0);
+    assert(guarded_calls == 0);
+    assert(test_handler_called == 1);
+    
+    /* The source component never receives its own broadcast */
+    message = qbus_create_message(QMSG_OCULAR_DATA, QCOMP_OCULAR, 0, NULL, 0,
+                                QMSG_PRIORITY_NORMAL, false);
+    assert(message != NULL);
+    assert(qbus_send_message(message) == true);
+    qbus_free_message(message);
+    
+    assert(qbus_process_messages(0) == 1);
+    assert(ocular_calls == 1);
+    assert(test_handler_called == 2);
+    
+    /* Unsubscribing removes the entry from the index */
+    assert(qbus_unsubscribe(QCOMP_SCHEDULER, QMSG_RESONANCE_SYNC, NULL) == true);
+    message = qbus_create_message(QMSG_RESONANCE_SYNC, QCOMP_TELEPORT, 0, NULL, 0,
+                                QMSG_PRIORITY_NORMAL, false);
+    assert(message != NULL);
+    assert(qbus_send_message(message) == true);
+    qbus_free_message(message);
+    
+    assert(qbus_process_messages(0) == 1);
+    assert(sync_calls == 0);
+    assert(test_handler_called == 3);
+    
+    /* Unregistering a component drops all of its index entries */
+    assert(qbus_unregister_component(QCOMP_OCULAR) == true);
+    assert(qbus_unregister_component(QCOMP_SCHEDULER) == true);
+    
+    /* Sent ahead of the queued unregistration notifications */
+    message = qbus_create_message(QMSG_OCULAR_DATA, QCOMP_TELEPORT, 0, NULL, 0,
+                                QMSG_PRIORITY_HIGH, false);
+    assert(message != NULL);
+    assert(qbus_send_message(message) == true);
+    qbus_free_message(message);
+    
+    assert(qbus_process_messages(1) == 1);
+    assert(ocular_calls == 1);
+    assert(guarded_calls == 0);
+    
+    printf("Broadcast dispatch index test passed!\n");
+}
+
+/* Zero-copy test state */
+static const void* zero_copy_seen[2];
+static uint32_t zero_copy_seen_count = 0;
+static QMessageBuffer* zero_copy_retained = NULL;
+static int zero_copy_release_calls = 0;
+
+/**
+ * @brief Handler that records the payload pointer and keeps the buffer
+ */
+static void zero_copy_handler(QMessage* message, void* context) {
+    (void)context;
+    
+    if (zero_copy_seen_count < 2) {
+        zero_copy_seen[zero_copy_seen_count++] = message->data;
+    }
+    
+    if (!zero_copy_retained && message->buffer) {
+        zero_copy_retained = qbus_buffer_retain(message->buffer);
+    }
+}
+
+/**
+ * @brief Release callback for wrapped test memory
+ */
+static void zero_copy_release(void* data, void* context) {
+    free(data);
+    (*(int*)context)++;
+}
+
+/**
+ * @brief Test pooled message payloads
+ */
+static void test_pooled_messages(void) {
+    printf("\nTesting pooled message payloads...\n");
+    
+    /* Payloads across every size class and beyond */
+    uint32_t sizes[] = { 1, 64, 65, 1000, 4096, 10000 };
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        unsigned char* payload = malloc(sizes[i]);
+        assert(payload != NULL);
+        memset(payload, (int)(i + 1), sizes[i]);
+        
+        QMessage* message = qbus_create_message(QMSG_OCULAR_DATA, QCOMP_TELEPORT, 0, payload, sizes[i],
+                                              QMSG_PRIORITY_NORMAL, false);
+        assert(message != NULL);
+        assert(message->header.data_size == sizes[i]);
+        assert(message->buffer == NULL);
+        assert(memcmp(message->data, payload, sizes[i]) == 0);
+        
+        qbus_free_message(message);
+        free(payload);
+    }
+    
+    /* Freed blocks are recycled */
+    QMessage* first = qbus_create_message(QMSG_PING, QCOMP_TELEPORT, 0, "a", 2,
+                                        QMSG_PRIORITY_NORMAL, false);
+    assert(first != NULL);
+    qbus_free_message(first);
+    QMessage* second = qbus_create_message(QMSG_PING, QCOMP_TELEPORT, 0, "b", 2,
+                                         QMSG_PRIORITY_NORMAL, false);
+    assert(second == first);
+    qbus_free_message(second);
+    
+    printf("Pooled message payloads test passed!\n");
+}
+
+/**
+ * @brief Test zero-copy broadcast of a shared buffer
+ */
+static void test_zero_copy_send(void) {
+    printf("\nTesting zero-copy buffer send...\n");
+    
+    QComponentInfo ocular_info = {
+        .id = QCOMP_OCULAR,
+        .name = "Quantum Ocular",
+        .resonance_level = NODE_ZERO_POINT,
+        .context = NULL
+    };
+    QComponentInfo kernel_info = {
+        .id = QCOMP_KERNEL,
+        .name = "Kernel",
+        .resonance_level = NODE_ZERO_POINT,
+        .context = NULL
+    };
+    
+    assert(qbus_register_component(&ocular_info) == true);
+    assert(qbus_register_component(&kernel_info) == true);
+    
+    QSubscription ocular_sub = {
+        .component_id = QCOMP_OCULAR,
+        .message_type = QMSG_OCULAR_DATA,
+        .handler = zero_copy_handler,
+        .context = NULL,
+        .min_resonance = NODE_ZERO_POINT
+    };
+    QSubscription kernel_sub = ocular_sub;
+    kernel_sub.component_id = QCOMP_KERNEL;
+    
+    assert(qbus_subscribe(&ocular_sub) == true);
+    assert(qbus_subscribe(&kernel_sub) == true);
+    qbus_process_messages(0);
+    
+    /* Wrap a large frame; the bus must never copy it */
+    uint32_t frame_size = 1920 * 1080 * 4;
+    unsigned char* frame = malloc(frame_size);
+    assert(frame != NULL);
+    memset(frame, 0x5a, frame_size);
+    
+    QMessageBuffer* buffer = qbus_buffer_wrap(frame, frame_size, zero_copy_release, &zero_copy_release_calls);
+    assert(buffer != NULL);
+    assert(qbus_buffer_data(buffer) == frame);
+    assert(qbus_buffer_size(buffer) == frame_size);
+    
+    bool result = qbus_send_buffer(QMSG_OCULAR_DATA, QCOMP_TELEPORT, 0, buffer,
+                                   QMSG_PRIORITY_HIGH, false);
+    assert(result == true);
+    
+    assert(qbus_process_messages(1) == 1);
+    assert(zero_copy_seen_count == 2);
+    assert(zero_copy_seen[0] == frame);
+    assert(zero_copy_seen[1] == frame);
+    
+    /* The handler's reference keeps the frame alive after delivery */
+    assert(zero_copy_release_calls == 0);
+    assert(zero_copy_retained == buffer);
+    qbus_buffer_release(zero_copy_retained);
+    zero_copy_retained = NULL;
+    assert(zero_copy_release_calls == 1);
+    
+    /* Buffers created by the bus are shared when forwarded too */
+    buffer = qbus_buffer_create(128);
+    assert(buffer != NULL);
+    memset(qbus_buffer_data(buffer), 0x11, 128);
+    
+    QMessage* message = qbus_create_buffer_message(QMSG_OCULAR_DATA, QCOMP_TELEPORT, QCOMP_OCULAR,
+                                                 buffer, QMSG_PRIORITY_HIGH, false);
+    assert(message != NULL);
+    assert(message->data == qbus_buffer_data(buffer));
+    assert(message->header.data_size == 128);
+    
+    zero_copy_seen_count = 0;
+    assert(qbus_send_message(message) == true);
+    qbus_free_message(message);
+    
+    assert(qbus_process_messages(1) == 1);
+    assert(zero_copy_seen_count == 1);
+    assert(zero_copy_seen[0] == qbus_buffer_data(zero_copy_retained));
+    qbus_buffer_release(zero_copy_retained);
+    zero_copy_retained = NULL;
+    
+    assert(qbus_unsubscribe(QCOMP_OCULAR, -1, NULL) == true);
+    assert(qbus_unsubscribe(QCOMP_KERNEL, -1, NULL) == true);
+    
+    printf("Zero-copy buffer send test passed!\n");
+}
+
+/* Batch drain test state */
+static uint32_t batch_calls = 0;
+static uint32_t batch_messages = 0;
+static QMessageType batch_last_type = QMSG_PING;
+static int batch_mixed_types = 0;
+
+/**
+ * @brief Batch handler that checks each span is a single group
+ */
+static void counting_batch_handler(QMessage* const* messages, uint32_t count, void* context) {
+    (void)context;
+    
+    batch_calls++;
+    batch_messages += count;
+    batch_last_type = messages[0]->header.type;
+    
+    for (uint32_t i = 1; i < count; i++) {
+        if (messages[i]->header.type != messages[0]->header.type ||
+            messages[i]->header.destination != messages[0]->header.destination) {
+            batch_mixed_types++;
+        }
+    }
+}
+
+/**
+ * @brief Test batched send and batched drain
+ */
+static void test_batch_processing(void) {
+    printf("\nTesting batched send and drain...\n");
+    
+    /* The kernel component is still registered from the zero-copy test */
+    QComponentInfo kernel_info;
+    assert(qbus_find_component(QCOMP_KERNEL, &kernel_info) == true);
+    
+    int per_message_calls = 0;
+    QSubscription subscription = {
+        .component_id = QCOMP_KERNEL,
+        .message_type = -1,
+        .handler = counting_handler,
+        .context = &per_message_calls,
+        .min_resonance = NODE_ZERO_POINT,
+        .batch_handler = counting_batch_handler
+    };
+    assert(qbus_subscribe(&subscription) == true);
+    qbus_process_messages(0);
+    per_message_calls = 0;
+    
+    /* Interleave two message types to the same destination */
+    QMessage* messages[10];
+    for (uint32_t i = 0; i < 10; i++) {
+        messages[i] = qbus_create_message(i % 2 ? QMSG_MEMORY_SYNC : QMSG_PROCESS_SYNC,
+                                        QCOMP_TELEPORT, QCOMP_KERNEL, &i, sizeof(i),
+                                        QMSG_PRIORITY_NORMAL, false);
+        assert(messages[i] != NULL);
+    }
+    
+    uint32_t sent = qbus_send_batch((const QMessage* const*)messages, 10);
+    assert(sent == 10);
+    for (uint32_t i = 0; i < 10; i++) {
+        qbus_free_message(messages[i]);
+    }
+    
+    /* One batch call per (destination, type) group */
+    uint32_t processed = qbus_process_message_batches(0);
+    assert(processed == 10);
+    assert(batch_calls == 2);
+    assert(batch_messages == 10);
+    assert(batch_mixed_types == 0);
+    assert(per_message_calls == 0);
+    
+    /* The regular pump still uses the per-message handler */
+    QMessage* single = qbus_create_message(QMSG_PROCESS_SYNC, QCOMP_TELEPORT, QCOMP_KERNEL, NULL, 0,
+                                         QMSG_PRIORITY_NORMAL, false);
+    assert(single != NULL);
+    assert(qbus_send_message(single) == true);
+    qbus_free_message(single);
+    
+    assert(qbus_process_messages(0) == 1);
+    assert(per_message_calls == 1);
+    assert(batch_calls == 2);
+    
+    assert(qbus_unsubscribe(QCOMP_KERNEL, -1, NULL) == true);
+    
+    printf("Batched send and drain test passed!\n");
+}
+
+/* Worker pool test state */
+#define WORKER_INBOX_CAPACITY 8
+
+static atomic_int worker_gate_open = 0;
+static atomic_int worker_gate_entered = 0;
+static atomic_int worker_slow_calls = 0;
+static atomic_int worker_fast_calls = 0;
+static atomic_int worker_reentrant_calls = 0;
+static uint32_t worker_slow_sequence[2 * WORKER_INBOX_CAPACITY];
+
+/**
+ * @brief Sleep for roughly a millisecond
+ */
+static void sleep_briefly(void) {
+    struct timespec delay = { .tv_sec = 0, .tv_nsec = 1000000L };
+    nanosleep(&delay, NULL);
+}
+
+/**
+ * @brief Wait up to five seconds for a counter to reach a value
+ */
+static bool wait_for_counter(atomic_int* counter, int expected) {
+    for (int i = 0; i < 5000; i++) {
+        if (atomic_load(counter) >= expected) {
+            return true;
+        }
+        sleep_briefly();
+    }
+    
+    return false;
+}
+
+/**
+ * @brief Slow handler that blocks its worker until the gate opens
+ */
+static void worker_slow_handler(QMessage* message, void* context) {
+    (void)context;
+    
+    int call = atomic_fetch_add(&worker_slow_calls, 1);
+    if (call < 2 * WORKER_INBOX_CAPACITY) {
+        worker_slow_sequence[call] = *(uint32_t*)message->data;
+    }
+    
+    atomic_store(&worker_gate_entered, 1);
+    for (int i = 0; i < 5000 && !atomic_load(&worker_gate_open); i++) {
+        sleep_briefly();
+    }
+}
+
+/**
+ * @brief Handler that counts invocations through an atomic context
+ */
+static void worker_counting_handler(QMessage* message, void* context) {
+    (void)message;
+    atomic_fetch_add((atomic_int*)context, 1);
+}
+
+/**
+ * @brief Send numbered targeted messages
+ */
+static void send_numbered(QComponentId destination, uint32_t first, uint32_t count) {
+    for (uint32_t i = first; i < first + count; i++) {
+        QMessage* message = qbus_create_message(QMSG_MEMORY_SYNC, QCOMP_TELEPORT, destination,
+                                              &i, sizeof(i), QMSG_PRIORITY_NORMAL, false);
+        assert(message != NULL);
+        assert(qbus_send_message(message) == true);
+        qbus_free_message(message);
+    }
+}
+
+/**
+ * @brief Test the delivery worker pool
+ */
+static void test_worker_pool(void) {
+    printf("\nTesting delivery worker pool...\n");
+    
+    /* Slow and reentrant components share worker 0, the fast one owns worker 1 */
+    assert(qbus_set_component_affinity(QCOMP_OCULAR, 0) == true);
+    assert(qbus_set_component_affinity(QCOMP_MEMEX, 0) == true);
+    assert(qbus_set_component_affinity(QCOMP_KERNEL, 1) == true);
+    assert(qbus_set_component_reentrant(QCOMP_MEMEX, true) == true);
+    
+    QSubscription slow_sub = {
+        .component_id = QCOMP_OCULAR,
+        .message_type = QMSG_MEMORY_SYNC,
+        .handler = worker_slow_handler,
+        .context = NULL,
+        .min_resonance = NODE_ZERO_POINT
+    };
+    QSubscription fast_sub = {
+        .component_id = QCOMP_KERNEL,
+        .message_type = QMSG_MEMORY_SYNC,
+        .handler = worker_counting_handler,
+        .context = &worker_fast_calls,
+        .min_resonance = NODE_ZERO_POINT
+    };
+    QSubscription reentrant_sub = {
+        .component_id = QCOMP_MEMEX,
+        .message_type = QMSG_MEMORY_SYNC,
+        .handler = worker_counting_handler,
+        .context = &worker_reentrant_calls,
+        .min_resonance = NODE_ZERO_POINT
+    };
+    assert(qbus_subscribe(&slow_sub) == true);
+    assert(qbus_subscribe(&fast_sub) == true);
+    assert(qbus_subscribe(&reentrant_sub) == true);
+    qbus_process_messages(0);
+    
+    QWorkerPoolConfig config = {
+        .worker_count = 4,
+        .inbox_capacity = WORKER_INBOX_CAPACITY,
+        .backpressure = QBUS_BACKPRESSURE_DROP_NEWEST
+    };
+    assert(qbus_start_workers(&config) == true);
+    assert(qbus_start_workers(&config) == false);
+    assert(qbus_set_component_affinity(QCOMP_OCULAR, 2) == false);
+    
+    /* Park worker 0 inside the slow handler */
+    send_numbered(QCOMP_OCULAR, 0, 1);
+    assert(qbus_process_messages(0) == 1);
+    assert(wait_for_counter(&worker_gate_entered, 1));
+    
+    /* Other components keep flowing while worker 0 is stalled */
+    send_numbered(QCOMP_KERNEL, 0, WORKER_INBOX_CAPACITY);
+    assert(qbus_process_messages(0) == WORKER_INBOX_CAPACITY);
+    assert(wait_for_counter(&worker_fast_calls, WORKER_INBOX_CAPACITY));
+    
+    /* Reentrant deliveries queued on worker 0 are stolen by idle workers */
+    send_numbered(QCOMP_MEMEX, 0, 5);
+    assert(qbus_process_messages(0) == 5);
+    assert(wait_for_counter(&worker_reentrant_calls, 5));
+    assert(atomic_load(&worker_slow_calls) == 1);
+    
+    /* Overfill the stalled inbox; the newest deliveries are dropped */
+    send_numbered(QCOMP_OCULAR, 1, WORKER_INBOX_CAPACITY + 4);
+    assert(qbus_process_messages(0) == WORKER_INBOX_CAPACITY + 4);
+    
+    atomic_store(&worker_gate_open, 1);
+    qbus_wait_workers_idle();
+    
+    /* Back-pressure drops are charged to the receiving component */
+    QBusStats* stats = malloc(sizeof(QBusStats));
+    assert(stats != NULL);
+    assert(qbus_get_stats(stats) == true);
+    for (uint32_t i = 0; i < stats->component_count; i++) {
+        if (stats->components[i].component_id == QCOMP_OCULAR) {
+            assert(stats->components[i].inbox_dropped == 4);
+        }
+    }
+    free(stats);
+    
+    /* Worker 0 ran the component's deliveries in order */
+    assert(atomic_load(&worker_slow_calls) == 1 + WORKER_INBOX_CAPACITY);
+    for (uint32_t i = 0; i < 1 + WORKER_INBOX_CAPACITY; i++) {
+        assert(worker_slow_sequence[i] == i);
+    }
+    
+    qbus_stop_workers();
+    
+    /* Inline delivery resumes after the pool stops */
+    send_numbered(QCOMP_KERNEL, 0, 1);
+    assert(qbus_process_messages(0) == 1);
+    assert(atomic_load(&worker_fast_calls) == WORKER_INBOX_CAPACITY + 1);
+    
+    assert(qbus_unsubscribe(QCOMP_OCULAR, QMSG_MEMORY_SYNC, NULL) == true);
+    assert(qbus_unsubscribe(QCOMP_KERNEL, QMSG_MEMORY_SYNC, NULL) == true);
+    assert(qbus_unsubscribe(QCOMP_MEMEX, QMSG_MEMORY_SYNC, NULL) == true);
+    
+    printf("Delivery worker pool test passed!\n");
+}
+
+static atomic_int stop_handler_entered = 0;
+static atomic_int stop_handler_subscribed = 0;
+static atomic_int stop_late_calls = 0;
+
+/**
+ * @brief Handler that subscribes while the pool is being stopped
+ */
+static void stop_subscribing_handler(QMessage* message, void* context) {
+    (void)message;
+    (void)context;
+    
+    atomic_store(&stop_handler_entered, 1);
+    for (int i = 0; i < 50; i++) {
+        sleep_briefly();
+    }
+    
+    QSubscription late_sub = {
+        .component_id = QCOMP_OCULAR,
+        .message_type = QMSG_PING,
+        .handler = worker_counting_handler,
+        .context = &stop_late_calls,
+        .min_resonance = NODE_ZERO_POINT
+    };
+    QComponentInfo info;
+    if (qbus_subscribe(&late_sub) && qbus_find_component(QCOMP_OCULAR, &info)) {
+        atomic_store(&stop_handler_subscribed, 1);
+    }
+}
+
+/**
+ * @brief Test stopping the pool while a handler calls back into the registry
+ */
+static void test_stop_workers_reentrant(void) {
+    printf("\nTesting worker stop during handler registry calls...\n");
+    
+    QSubscription sub = {
+        .component_id = QCOMP_OCULAR,
+        .message_type = QMSG_MEMORY_SYNC,
+        .handler = stop_subscribing_handler,
+        .context = NULL,
+        .min_resonance = NODE_ZERO_POINT
+    };
+    assert(qbus_subscribe(&sub) == true);
+    
+    QWorkerPoolConfig config = {
+        .worker_count = 2,
+        .inbox_capacity = WORKER_INBOX_CAPACITY,
+        .backpressure = QBUS_BACKPRESSURE_BLOCK
+    };
+    assert(qbus_start_workers(&config) == true);
+    
+    send_numbered(QCOMP_OCULAR, 0, 1);
+    assert(qbus_process_messages(0) == 1);
+    assert(wait_for_counter(&stop_handler_entered, 1));
+    
+    /* The handler subscribes after the stop has begun */
+    qbus_stop_workers();
+    assert(atomic_load(&stop_handler_subscribed) == 1);
+    
+    QMessage* ping = qbus_create_message(QMSG_PING, QCOMP_TELEPORT, QCOMP_OCULAR,
+                                       NULL, 0, QMSG_PRIORITY_NORMAL, false);
+    assert(ping != NULL);
+    assert(qbus_send_message(ping) == true);
+    qbus_free_message(ping);
+    assert(qbus_process_messages(0) == 1);
+    assert(atomic_load(&stop_late_calls) == 1);
+    
+    assert(qbus_unsubscribe(QCOMP_OCULAR, QMSG_MEMORY_SYNC, NULL) == true);
+    assert(qbus_unsubscribe(QCOMP_OCULAR, QMSG_PING, NULL) == true);
+    
+    printf("Worker stop during handler registry calls test passed!\n");
+}
+
+/* Handler that takes a measurable amount of time */
+static void stats_slow_handler(QMessage* message, void* context) {
+    (void)message;
+    (void)context;
+    struct timespec pause = { 0, 200000L };
+    nanosleep(&pause, NULL);
+}
+
+/**
+ * @brief Find the statistics entry for a message type
+ */
+static const QTypeStats* find_type_stats(const QBusStats* stats, QMessageType type) {
+    for (uint32_t i = 0; i < stats->type_count; i++) {
+        if (stats->types[i].type == type) {
+            return &stats->types[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Find the statistics entry for a component
+ */
+static const QComponentStats* find_component_stats(const QBusStats* stats, QComponentId id) {
+    for (uint32_t i = 0; i < stats->component_count; i++) {
+        if (stats->components[i].component_id == id) {
+            return &stats->components[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Test bus statistics
+ */
+static void test_bus_statistics(void) {
+    printf("\nTesting bus statistics...\n");
+    
+    QMessageType stats_type = (QMessageType)(QMSG_USER_DEFINED_BASE + 9);
+    QBusStats* stats = malloc(sizeof(QBusStats));
+    assert(stats != NULL);
+    
+    /* Percentiles come from bucket bounds, capped at the largest sample */
+    QLatencyHistogram histogram;
+    memset(&histogram, 0, sizeof(histogram));
+    assert(qbus_histogram_percentile(&histogram, 50.0) == 0);
+    histogram.count = 100;
+    histogram.buckets[2] = 90;    /* 2 ns */
+    histogram.buckets[40] = 10;   /* 2048-2559 ns */
+    histogram.max_ns = 2100;
+    assert(qbus_histogram_percentile(&histogram, 50.0) == 2);
+    assert(qbus_histogram_percentile(&histogram, 90.0) == 2);
+    assert(qbus_histogram_percentile(&histogram, 99.0) == 2100);
+    
+    QSubscription sub = {
+        .component_id = QCOMP_OCULAR,
+        .message_type = stats_type,
+        .handler = stats_slow_handler,
+        .context = NULL,
+        .min_resonance = NODE_ZERO_POINT
+    };
+    assert(qbus_subscribe(&sub) == true);
+    qbus_process_messages(0);
+    qbus_reset_stats();
+    
+    /* Queue depth and enqueue counts */
+    for (int i = 0; i < 3; i++) {
+        QMessage* message = qbus_create_message(stats_type, QCOMP_KERNEL, QCOMP_OCULAR, NULL, 0,
+                                                QMSG_PRIORITY_HIGH, false);
+        assert(qbus_send_message(message) == true);
+        qbus_free_message(message);
+    }
+    
+    assert(qbus_get_stats(stats) == true);
+    assert(stats->priorities[QMSG_PRIORITY_HIGH].enqueued == 3);
+    assert(stats->priorities[QMSG_PRIORITY_HIGH].depth == 3);
+    assert(stats->priorities[QMSG_PRIORITY_HIGH].depth_high_water == 3);
+    assert(stats->pending_depth == 3);
+    assert(find_type_stats(stats, stats_type)->enqueued == 3);
+    
+    /* Dispatch latency and handler time */
+    assert(qbus_process_messages(0) == 3);
+    assert(qbus_get_stats(stats) == true);
+    assert(stats->priorities[QMSG_PRIORITY_HIGH].dispatched == 3);
+    assert(stats->priorities[QMSG_PRIORITY_HIGH].depth == 0);
+    assert(stats->priorities[QMSG_PRIORITY_HIGH].depth_high_water == 3);
+    assert(stats->priorities[QMSG_PRIORITY_HIGH].latency.count == 3);
+    
+    const QTypeStats* type_stats = find_type_stats(stats, stats_type);
+    assert(type_stats->dispatched == 3);
+    assert(type_stats->latency.count == 3);
+    
+    const QComponentStats* component_stats = find_component_stats(stats, QCOMP_OCULAR);
+    assert(component_stats != NULL);
+    assert(component_stats->invocations == 3);
+    assert(component_stats->handler_time.count == 3);
+    assert(qbus_histogram_percentile(&component_stats->handler_time, 50.0) >= 200000);
+    
+    /* Overflowing a priority ring is counted as a drop */
+    uint32_t sent = 0;
+    for (;;) {
+        QMessage* message = qbus_create_message(stats_type, QCOMP_KERNEL, QCOMP_KERNEL, NULL, 0,
+                                                QMSG_PRIORITY_LOW, false);
+        bool queued = qbus_send_message(message);
+        qbus_free_message(message);
+        if (!queued) {
+            break;
+        }
+        sent++;
+    }
+    
+    assert(qbus_get_stats(stats) == true);
+    assert(stats->priorities[QMSG_PRIORITY_LOW].dropped == 1);
+    assert(stats->priorities[QMSG_PRIORITY_LOW].depth_high_water == sent);
+    assert(find_type_stats(stats, stats_type)->dropped == 1);
+    assert(stats->messages_dropped == 1);
+    assert(stats->pending_high_water == sent);
+    
+    /* Nobody subscribes on the kernel component yet; just drain */
+    assert(qbus_process_messages(0) == sent);
+    
+    /* Dashboard export */
+    const char* path = "/tmp/ctrlxt_qbus_stats_test.json";
+    assert(qbus_write_stats_json(path) == true);
+    FILE* file = fopen(path, "r");
+    assert(file != NULL);
+    char json[16384];
+    size_t length = fread(json, 1, sizeof(json) - 1, file);
+    json[length] = '\0';
+    fclose(file);
+    remove(path);
+    assert(strncmp(json, "{\"timestamp\":", 13) == 0);
+    assert(strstr(json, "\"priorities\":[") != NULL);
+    assert(strstr(json, "\"name\":\"Quantum Ocular\"") != NULL);
+    
+    assert(qbus_unsubscribe(QCOMP_OCULAR, stats_type, NULL) == true);
+    free(stats);
+    
+    printf("Bus statistics test passed!\n");
+}
+
 /**
  * @brief Test component unregistration
  */
@@ -423,6 +1341,15 @@ int main(void) {
     test_message_subscription();
     test_unsubscription();
     test_broadcast_messages();
+    test_priority_ordering();
+    test_concurrent_producers();
+    test_broadcast_dispatch_index();
+    test_pooled_messages();
+    test_zero_copy_send();
+    test_batch_processing();
+    test_worker_pool();
+    test_stop_workers_reentrant();
+    test_bus_statistics();
     test_component_unregistration();
     test_bus_entanglement();
     test_resonance_level();
@@ -21,7 +21,7 @@ static void test_qopu_init(void) {
         .processing_model = MODEL_BIO_QUANTUM,
         .interface = INTERFACE_NEURAL,
         .quantum_tunneling_enabled = true,
-        .reality_mode = REALITY_EXISTING,
+        .reality_mode = QOPU_REALITY_EXISTING,
         .channels = NULL,
         .channel_count = 0,
         .blink_spots = NULL,
@@ -45,21 +45,21 @@ static void test_qopu_create_blink_spots(void) {
     printf("\nTesting qopu_create_blink_spot...\n");
     
     /* Create a few blink spots */
-    BlinkSpot *spot1 = qopu_create_blink_spot("Home", 35.1495, -90.0489, 79.0, REALITY_EXISTING);
+    BlinkSpot *spot1 = qopu_create_blink_spot("Home", 35.1495, -90.0489, 79.0, QOPU_REALITY_EXISTING);
     assert(spot1 != NULL);
     assert(strcmp(spot1->name, "Home") == 0);
     assert(spot1->latitude == 35.1495);
     assert(spot1->longitude == -90.0489);
     assert(spot1->altitude == 79.0);
-    assert(spot1->reality_mode == REALITY_EXISTING);
+    assert(spot1->reality_mode == QOPU_REALITY_EXISTING);
     
-    BlinkSpot *spot2 = qopu_create_blink_spot("Mountain View", 37.3861, -122.0839, 32.0, REALITY_AUGMENTED);
+    BlinkSpot *spot2 = qopu_create_blink_spot("Mountain View", 37.3861, -122.0839, 32.0, QOPU_REALITY_AUGMENTED);
     assert(spot2 != NULL);
     assert(strcmp(spot2->name, "Mountain View") == 0);
     assert(spot2->latitude == 37.3861);
     assert(spot2->longitude == -122.0839);
     assert(spot2->altitude == 32.0);
-    assert(spot2->reality_mode == REALITY_AUGMENTED);
+    assert(spot2->reality_mode == QOPU_REALITY_AUGMENTED);
     
     printf("qopu_create_blink_spot tests passed!\n");
 }
@@ -157,16 +157,16 @@ static void test_qopu_set_reality_mode(void) {
     /* Set various reality modes */
     bool result;
     
-    result = qopu_set_reality_mode(REALITY_AUGMENTED);
+    result = qopu_set_reality_mode(QOPU_REALITY_AUGMENTED);
     assert(result == true);
     
-    result = qopu_set_reality_mode(REALITY_SIMULATED);
+    result = qopu_set_reality_mode(QOPU_REALITY_SIMULATED);
     assert(result == true);
     
-    result = qopu_set_reality_mode(REALITY_ALTERNATIVE);
+    result = qopu_set_reality_mode(QOPU_REALITY_ALTERNATIVE);
     assert(result == true);
     
-    result = qopu_set_reality_mode(REALITY_QUANTUM_SUPERPOSITION);
+    result = qopu_set_reality_mode(QOPU_REALITY_QUANTUM_SUPERPOSITION);
     assert(result == true);
     
     printf("qopu_set_reality_mode tests passed!\n");
@@ -185,6 +185,264 @@ static void test_qopu_shutdown(void) {
     printf("qopu_shutdown test passed!\n");
 }
 
+/**
+ * @brief Fill a buffer with a repeatable byte pattern
+ */
+static void fill_pattern(uint8_t *data, size_t length, uint32_t seed) {
+    for (size_t i = 0; i < length; i++) {
+        seed = seed * 1103515245u + 12345u;
+        data[i] = (uint8_t)(seed >> 16);
+    }
+}
+
+/**
+ * @brief Apply every enhancement to a copy of some samples
+ */
+static void enhance_all(const uint8_t *input, uint8_t *output, size_t length, uint8_t *state) {
+    QuantumVisualData visual = { 0 };
+    visual.raw_data = output;
+    visual.raw_size = (uint32_t)length;
+    visual.quantum_state = state;
+    visual.quantum_state_size = 37;
+
+    QuantumEnhancementType types[] = {
+        ENHANCE_QUANTUM_CLARITY, ENHANCE_REALITY_OVERLAY, ENHANCE_QUANTUM_FILTER,
+        ENHANCE_DIMENSIONAL_SHIFT, ENHANCE_QUANTUM_FUSION
+    };
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+        for (int step = 1; step <= 4; step++) {
+            memcpy(output + t * length * 4 + (step - 1) * length, input, length);
+            visual.raw_data = output + t * length * 4 + (step - 1) * length;
+            assert(qopu_apply_quantum_enhancement(&visual, types[t], step / 4.0f) == true);
+        }
+    }
+}
+
+/**
+ * @brief Test the native enhancement kernels
+ */
+static void test_qopu_enhancement_kernels(void) {
+    printf("\nTesting enhancement kernels...\n");
+
+    /* Reference values from the portable kernels */
+    assert(qopu_set_enhancement_kernel(OCULAR_KERNEL_SCALAR) == true);
+    assert(qopu_get_enhancement_kernel() == OCULAR_KERNEL_SCALAR);
+    uint8_t samples[5];
+    float weights[32] = { 0 };
+    QuantumVisualData visual = { 0 };
+    visual.raw_data = samples;
+    visual.raw_size = sizeof(samples);
+    visual.enhancement_weights = weights;
+    visual.weight_count = 32;
+
+    memcpy(samples, (uint8_t[]){ 0, 64, 128, 200, 255 }, 5);
+    assert(qopu_apply_quantum_enhancement(&visual, ENHANCE_QUANTUM_CLARITY, 1.0f) == true);
+    assert(samples[0] == 0 && samples[1] == 0 && samples[2] == 128 && samples[3] == 255 && samples[4] == 255);
+
+    memcpy(samples, (uint8_t[]){ 0, 64, 128, 200, 255 }, 5);
+    assert(qopu_apply_quantum_enhancement(&visual, ENHANCE_REALITY_OVERLAY, 1.0f) == true);
+    assert(samples[0] == 0 && samples[1] > 64 && samples[2] == 191 && samples[3] > 200 && samples[4] == 255);
+
+    memcpy(samples, (uint8_t[]){ 0, 64, 128, 200, 255 }, 5);
+    assert(qopu_apply_quantum_enhancement(&visual, ENHANCE_QUANTUM_FILTER, 0.5f) == true);
+    assert(samples[0] == 0 && samples[1] == 0 && samples[2] == 128 && samples[3] == 200);
+    assert(weights[ENHANCE_QUANTUM_FILTER] == 0.5f);
+
+    memcpy(samples, (uint8_t[]){ 0, 64, 128, 200, 255 }, 5);
+    assert(qopu_apply_quantum_enhancement(&visual, ENHANCE_DIMENSIONAL_SHIFT, 1.0f) == true);
+    assert(samples[0] == 255 && samples[2] == 127 && samples[4] == 254);
+
+    /* Fusion repeats the state across the samples; it needs a state */
+    uint8_t state[2] = { 255, 0 };
+    assert(qopu_apply_quantum_enhancement(&visual, ENHANCE_QUANTUM_FUSION, 1.0f) == false);
+    visual.quantum_state = state;
+    visual.quantum_state_size = sizeof(state);
+    assert(qopu_apply_quantum_enhancement(&visual, ENHANCE_QUANTUM_FUSION, 1.0f) == true);
+    assert(samples[0] == 255 && samples[1] == 0 && samples[2] == 255 && samples[3] == 0 && samples[4] == 255);
+    visual.quantum_state = NULL;
+
+    /* Every SIMD version matches the portable one, tails included */
+    enum { LENGTH = 1027 };
+    static uint8_t input[LENGTH];
+    static uint8_t pattern[37];
+    static uint8_t expected[LENGTH * 20];
+    static uint8_t actual[LENGTH * 20];
+    fill_pattern(input, LENGTH, 7);
+    fill_pattern(pattern, sizeof(pattern), 11);
+    enhance_all(input, expected, LENGTH, pattern);
+    OcularKernel simd[] = { OCULAR_KERNEL_SSE2, OCULAR_KERNEL_AVX2, OCULAR_KERNEL_NEON };
+    for (size_t k = 0; k < sizeof(simd) / sizeof(simd[0]); k++) {
+        if (!qopu_set_enhancement_kernel(simd[k])) {
+            printf("Kernel %d not supported here\n", simd[k]);
+            continue;
+        }
+        assert(qopu_get_enhancement_kernel() == simd[k]);
+        memset(actual, 0, sizeof(actual));
+        enhance_all(input, actual, LENGTH, pattern);
+        assert(memcmp(expected, actual, sizeof(actual)) == 0);
+    }
+
+    assert(qopu_set_enhancement_kernel((OcularKernel)99) == false);
+    assert(qopu_set_enhancement_kernel(OCULAR_KERNEL_AUTO) == true);
+    assert(qopu_get_enhancement_kernel() != OCULAR_KERNEL_AUTO);
+    assert(qopu_get_enhancement_kernel() != OCULAR_KERNEL_SCRIPT);
+
+    printf("Enhancement kernel tests passed!\n");
+}
+
+/**
+ * @brief Test fused, tiled enhancement pipelines
+ */
+static void test_qopu_pipeline(void) {
+    printf("\nTesting enhancement pipelines...\n");
+
+    VisualProcessingParams params = { 0 };
+    params.mode = VISUAL_MODE_QUANTUM_ENHANCED;
+    params.enhancement_flags = ENHANCE_QUANTUM_CLARITY | ENHANCE_REALITY_OVERLAY | ENHANCE_QUANTUM_FILTER |
+                               ENHANCE_DIMENSIONAL_SHIFT | ENHANCE_QUANTUM_FUSION;
+    params.quantum_clarity_factor = 0.4f;
+    params.reality_overlay_strength = 0.7f;
+    params.quantum_filter_threshold = 0.2f;
+    params.dimensional_shift_factor = 0.3f;
+
+    /* Several tiles with a ragged tail, and a state that does not divide a tile */
+    enum { FRAME = 3 * 64 * 1024 + 123 };
+    static uint8_t state[37];
+    uint8_t *frame = malloc(FRAME);
+    uint8_t *expected = malloc(FRAME);
+    uint8_t *output = malloc(FRAME);
+    assert(frame && expected && output);
+    fill_pattern(frame, FRAME, 3);
+    fill_pattern(state, sizeof(state), 5);
+
+    /* Reference: one full pass per enhancement */
+    memcpy(expected, frame, FRAME);
+    QuantumVisualData visual = { 0 };
+    visual.raw_data = expected;
+    visual.raw_size = FRAME;
+    visual.quantum_state = state;
+    visual.quantum_state_size = sizeof(state);
+    assert(qopu_apply_quantum_enhancement(&visual, ENHANCE_QUANTUM_CLARITY, 0.4f));
+    assert(qopu_apply_quantum_enhancement(&visual, ENHANCE_REALITY_OVERLAY, 0.7f));
+    assert(qopu_apply_quantum_enhancement(&visual, ENHANCE_QUANTUM_FILTER, 0.2f));
+    assert(qopu_apply_quantum_enhancement(&visual, ENHANCE_DIMENSIONAL_SHIFT, 0.3f));
+    assert(qopu_apply_quantum_enhancement(&visual, ENHANCE_QUANTUM_FUSION, 1.0f));
+
+    OcularPipeline *pipeline = qopu_pipeline_create(&params, 4);
+    assert(pipeline && qopu_pipeline_stage_count(pipeline) == 5);
+    visual.raw_data = frame;
+    for (int run = 0; run < 3; run++) {
+        memset(output, 0, FRAME);
+        assert(qopu_pipeline_run(pipeline, &visual, output, FRAME) == FRAME);
+        assert(memcmp(output, expected, FRAME) == 0);
+    }
+
+    /* Truncated output computes only what fits */
+    memset(output, 0, FRAME);
+    assert(qopu_pipeline_run(pipeline, &visual, output, 100000) == 100000);
+    assert(memcmp(output, expected, 100000) == 0 && output[100000] == 0);
+
+    /* Fusion needs a state */
+    visual.quantum_state = NULL;
+    assert(qopu_pipeline_run(pipeline, &visual, output, FRAME) == -1);
+    visual.quantum_state = state;
+    qopu_pipeline_destroy(pipeline);
+
+    /* In place on one thread */
+    pipeline = qopu_pipeline_create(&params, 1);
+    memcpy(output, frame, FRAME);
+    visual.raw_data = output;
+    assert(qopu_pipeline_run(pipeline, &visual, output, FRAME) == FRAME);
+    assert(memcmp(output, expected, FRAME) == 0);
+    qopu_pipeline_destroy(pipeline);
+    qopu_pipeline_destroy(NULL);
+
+    /* The frame entry point computes the same chain */
+    visual.raw_data = frame;
+    memset(output, 0, FRAME);
+    assert(qopu_process_visual_enhanced(&visual, &params, output, FRAME) == FRAME);
+    assert(memcmp(output, expected, FRAME) == 0);
+
+    /* Standard mode copies; out-of-range strengths are refused */
+    params.mode = VISUAL_MODE_STANDARD;
+    pipeline = qopu_pipeline_create(&params, 2);
+    assert(pipeline && qopu_pipeline_stage_count(pipeline) == 0);
+    qopu_pipeline_destroy(pipeline);
+    assert(qopu_process_visual_enhanced(&visual, &params, output, FRAME) == FRAME);
+    assert(memcmp(output, frame, FRAME) == 0);
+    params.mode = VISUAL_MODE_QUANTUM_ENHANCED;
+    params.reality_overlay_strength = 1.5f;
+    assert(qopu_pipeline_create(&params, 2) == NULL);
+    assert(qopu_process_visual_enhanced(&visual, &params, output, FRAME) == -1);
+
+    free(frame);
+    free(expected);
+    free(output);
+    printf("Enhancement pipeline tests passed!\n");
+}
+
+/**
+ * @brief Test capturing and enhancing frames in a ring
+ */
+static void test_qopu_capture_frame(void) {
+    printf("\nTesting frame capture...\n");
+
+    VisualProcessingParams params = { 0 };
+    params.mode = VISUAL_MODE_QUANTUM_ENHANCED;
+    params.enhancement_flags = ENHANCE_QUANTUM_CLARITY | ENHANCE_DIMENSIONAL_SHIFT;
+    params.quantum_clarity_factor = 0.6f;
+    params.dimensional_shift_factor = 0.1f;
+    OcularPipeline *pipeline = qopu_pipeline_create(&params, 2);
+    OcularFrameRing *ring = ofring_create(3, 1024, 1, OFRAME_DROP_NEWEST);
+    assert(pipeline && ring);
+
+    /* Enhancing a frame in its slot matches enhancing a copy */
+    OcularFrame *frame = ofring_acquire(ring);
+    assert(frame != NULL);
+    uint8_t expected[1000];
+    fill_pattern(frame->data, sizeof(expected), 9);
+    memcpy(expected, frame->data, sizeof(expected));
+    QuantumVisualData visual = { 0 };
+    visual.raw_data = expected;
+    visual.raw_size = sizeof(expected);
+    assert(qopu_apply_quantum_enhancement(&visual, ENHANCE_QUANTUM_CLARITY, 0.6f));
+    assert(qopu_apply_quantum_enhancement(&visual, ENHANCE_DIMENSIONAL_SHIFT, 0.1f));
+    assert(qopu_pipeline_run_frame(pipeline, frame, NULL, 0) == -1);
+    frame->size = sizeof(expected);
+    assert(qopu_pipeline_run_frame(pipeline, frame, NULL, 0) == (int32_t)sizeof(expected));
+    assert(memcmp(frame->data, expected, sizeof(expected)) == 0);
+    assert(frame->timestamps[OFRAME_STAGE_ENHANCED] >= frame->timestamps[OFRAME_STAGE_ACQUIRED]);
+    assert(ofring_publish(ring, frame) == 1);
+
+    /* Captured frames land in the ring, enhanced or as read */
+    assert(qopu_capture_frame(ring, "QuantumGPS", NULL) == 2);
+    assert(qopu_capture_frame(ring, "QuantumGPS", pipeline) == 3);
+    assert(qopu_capture_frame(ring, "QuantumGPS", NULL) == 0);
+
+    uint64_t cursor = 1;
+    frame = ofring_borrow(ring, &cursor, false);
+    assert(frame && frame->sequence == 2 && frame->size > 0);
+    assert(strlen((const char *)frame->data) == frame->size);
+    assert(frame->timestamps[OFRAME_STAGE_ENHANCED] == 0);
+    ofring_release(frame);
+    frame = ofring_borrow(ring, &cursor, false);
+    assert(frame && frame->sequence == 3);
+    assert(frame->timestamps[OFRAME_STAGE_ENHANCED] != 0);
+    ofring_release(frame);
+
+    /* A failed capture gives its slot back; fusion has no state here */
+    params.enhancement_flags = ENHANCE_QUANTUM_FUSION;
+    OcularPipeline *fusion = qopu_pipeline_create(&params, 1);
+    assert(qopu_capture_frame(ring, "QuantumGPS", fusion) == 0);
+    assert(qopu_capture_frame(ring, "QuantumGPS", NULL) == 4);
+    assert(qopu_capture_frame(NULL, "QuantumGPS", NULL) == 0);
+
+    ofring_destroy(ring);
+    qopu_pipeline_destroy(fusion);
+    qopu_pipeline_destroy(pipeline);
+    printf("Frame capture tests passed!\n");
+}
+
 /**
  * @brief Main test function
  */
@@ -198,6 +456,9 @@ int main(void) {
     test_qopu_upgrade_audio();
     test_qopu_get_quantum_data();
     test_qopu_set_reality_mode();
+    test_qopu_enhancement_kernels();
+    test_qopu_pipeline();
+    test_qopu_capture_frame();
     test_qopu_shutdown();
     
     printf("\nAll Quantum Ocular Processing Unit tests passed!\n");
@@ -3,12 +3,17 @@
  * @brief Unit tests for the Quantum Teleportation System
  */
 
+#define _XOPEN_SOURCE 700  /* nanosleep and strdup under -std=c11 */
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <math.h>
+#include <time.h>
 #include "../../src/quantum/teleport/quantum_teleport.h"
 #include "../../src/quantum/ocular/quantum_ocular.h"
+#include "../../src/quantum/messaging/quantum_message_bus.h"
 
 /**
  * @brief Test initialization of the Quantum Teleportation System
@@ -162,6 +167,347 @@ static void test_qteleport_find_blink_spots(void) {
     printf("qteleport_find_blink_spots tests passed!\n");
 }
 
+/**
+ * @brief Test nearest and radius queries over a large loaded catalog
+ */
+static void test_qteleport_spatial_queries(void) {
+    printf("\nTesting blink spot spatial queries...\n");
+    
+    uint32_t before = 0;
+    free(qteleport_list_blink_spots(&before));
+    
+    /* A grid of spots one degree apart around the globe */
+    enum { ROWS = 90, COLUMNS = 180 };
+    static BlinkSpotSpec specs[ROWS * COLUMNS];
+    static char names[ROWS * COLUMNS][32];
+    for (uint32_t row = 0; row < ROWS; row++) {
+        for (uint32_t column = 0; column < COLUMNS; column++) {
+            uint32_t i = row * COLUMNS + column;
+            snprintf(names[i], sizeof(names[i]), "Grid %u/%u", row, column);
+            specs[i].name = names[i];
+            specs[i].description = "Survey marker";
+            specs[i].latitude = -89.0 + row * 2.0;
+            specs[i].longitude = -180.0 + column * 2.0;
+            specs[i].resonance_level = NODE_ZERO_POINT;
+        }
+    }
+    assert(qteleport_load_blink_spots(specs, ROWS * COLUMNS) == ROWS * COLUMNS);
+    
+    /* The nearest spot to a grid point is that point, then its neighbors */
+    uint32_t count = 0;
+    BlinkSpotTarget **nearest = qteleport_find_nearest(1.0, 0.0, 5, &count);
+    assert(nearest && count == 5);
+    assert(nearest[0]->latitude == 1.0 && nearest[0]->longitude == 0.0);
+    for (uint32_t i = 1; i < count; i++) {
+        assert(fabs(nearest[i]->latitude - 1.0) <= 2.0 && fabs(nearest[i]->longitude) <= 2.0);
+    }
+    free(nearest);
+    
+    /* Neighbors across the antimeridian are found */
+    nearest = qteleport_find_nearest(1.0, 179.5, 2, &count);
+    assert(nearest && count == 2);
+    assert(nearest[0]->longitude == -180.0 || nearest[0]->longitude == 178.0);
+    free(nearest);
+    
+    /* Radius queries come back nearest first and agree with the filter */
+    BlinkSpotTarget **within = qteleport_find_within(41.0, 10.0, 400.0, &count);
+    assert(within && count > 1 && within[0]->latitude == 41.0 && within[0]->longitude == 10.0);
+    uint32_t filtered = 0;
+    BlinkSpotTarget **found = qteleport_find_blink_spots("Grid", 41.0, 10.0, 400.0, false, &filtered);
+    assert(found && filtered == count);
+    free(found);
+    free(within);
+    
+    /* Renamed and deleted spots are reflected in later queries */
+    found = qteleport_find_blink_spots("Grid 45/90", 0.0, 0.0, 0.0, false, &count);
+    assert(found && count == 1);
+    uint64_t renamed = found[0]->id;
+    free(found);
+    assert(qteleport_update_blink_spot(renamed, "Renamed Marker", NULL, -1));
+    found = qteleport_find_blink_spots("Grid 45/90", 0.0, 0.0, 0.0, false, &count);
+    assert(count == 0);
+    free(found);
+    found = qteleport_find_blink_spots("Renamed", 0.0, 0.0, 0.0, false, &count);
+    assert(count == 1 && found[0]->id == renamed);
+    free(found);
+    
+    nearest = qteleport_find_nearest(1.0, 0.0, 1, &count);
+    uint64_t removed = nearest[0]->id;
+    free(nearest);
+    assert(qteleport_delete_blink_spot(removed));
+    nearest = qteleport_find_nearest(1.0, 0.0, 1, &count);
+    assert(count == 1 && nearest[0]->id != removed);
+    free(nearest);
+    
+    /* Remove the grid again so later tests see the original spots */
+    found = qteleport_find_blink_spots("Survey marker", 0.0, 0.0, 0.0, false, &count);
+    assert(count == ROWS * COLUMNS - 1);
+    for (uint32_t i = 0; i < count; i++) {
+        assert(qteleport_delete_blink_spot(found[i]->id));
+    }
+    free(found);
+    uint32_t after = 0;
+    free(qteleport_list_blink_spots(&after));
+    assert(after == before);
+    
+    printf("Blink spot spatial query tests passed!\n");
+}
+
+/**
+ * @brief Test batch destination scoring, route planning and the cost cache
+ */
+static void test_qteleport_planning(void) {
+    printf("\nTesting teleport planning...\n");
+    
+    uint32_t before = 0;
+    free(qteleport_list_blink_spots(&before));
+    
+    /* Waypoints one degree apart along the equator */
+    enum { WAYPOINTS = 21 };
+    static BlinkSpotSpec specs[WAYPOINTS];
+    static char names[WAYPOINTS][32];
+    for (uint32_t i = 0; i < WAYPOINTS; i++) {
+        snprintf(names[i], sizeof(names[i]), "Waypoint %u", i);
+        specs[i].name = names[i];
+        specs[i].description = "Equator relay";
+        specs[i].latitude = 0.0;
+        specs[i].longitude = (double)i;
+        specs[i].resonance_level = NODE_ZERO_POINT;
+    }
+    assert(qteleport_load_blink_spots(specs, WAYPOINTS) == WAYPOINTS);
+    uint32_t count = 0;
+    BlinkSpotTarget **found = qteleport_find_blink_spots("Equator relay", 0.0, 0.0, 0.0, false, &count);
+    assert(found && count == WAYPOINTS);
+    uint64_t ids[WAYPOINTS];
+    for (uint32_t i = 0; i < WAYPOINTS; i++) {
+        assert(found[i]->longitude == (double)i);
+        ids[i] = found[i]->id;
+    }
+    free(found);
+    
+    /* Energy is 10 * sqrt(km) on these spots under the default settings */
+    const double degree_km = 6371.0 * 3.14159265358979323846 / 180.0;
+    TeleportSettings settings = qteleport_get_default_settings();
+    settings.energy_limit = 200.0;
+    
+    /* Ranking comes back nearest first, the affordable hops ahead of the rest */
+    TeleportCandidate *ranked = qteleport_rank_destinations(ids[0], &ids[1], WAYPOINTS - 1, settings, &count);
+    assert(ranked && count == WAYPOINTS - 1);
+    for (uint32_t i = 0; i < count; i++) {
+        assert(ranked[i].destination->id == ids[i + 1]);
+        assert(fabs(ranked[i].distance_km - (i + 1) * degree_km) < 1e-6);
+        assert(fabs(ranked[i].energy_cost - 10.0 * sqrt(ranked[i].distance_km)) < 1e-6);
+        assert(ranked[i].duration >= 0.1);
+        assert(ranked[i].within_limit == (i < 3));
+    }
+    free(ranked);
+    
+    /* Unknown destinations and the source itself are skipped */
+    uint64_t mixed[] = { ids[0], 12345, ids[2] };
+    ranked = qteleport_rank_destinations(ids[0], mixed, 3, settings, &count);
+    assert(ranked && count == 1 && ranked[0].destination->id == ids[2]);
+    free(ranked);
+    assert(qteleport_rank_destinations(12345, NULL, 0, settings, &count) == NULL && count == 0);
+    
+    /* From the current location every spot is scored at the assumed distance */
+    ranked = qteleport_rank_destinations(QTELEPORT_CURRENT_LOCATION, ids, WAYPOINTS, settings, &count);
+    assert(ranked && count == WAYPOINTS);
+    assert(ranked[0].distance_km == 1000.0 && ranked[0].energy_cost == ranked[WAYPOINTS - 1].energy_cost);
+    free(ranked);
+    
+    /* Out of reach of one hop, the route takes the longest affordable hops */
+    TeleportRoute route;
+    assert(qteleport_plan_route(ids[0], ids[20], 16, settings, &route));
+    assert(route.hop_count == 7 && route.hops[6]->id == ids[20]);
+    assert(fabs(route.distance_km - 20.0 * degree_km) < 1e-6);
+    assert(fabs(route.energy_cost - 10.0 * sqrt(degree_km) * (6.0 * sqrt(3.0) + sqrt(2.0))) < 1e-6);
+    qteleport_free_route(&route);
+    assert(!qteleport_plan_route(ids[0], ids[20], 6, settings, &route));
+    assert(route.hops == NULL && route.hop_count == 0);
+    assert(!qteleport_plan_route(ids[0], ids[0], 4, settings, &route));
+    
+    /* With a generous limit the direct hop wins, unless an efficient spot is on the way */
+    settings.energy_limit = 500.0;
+    assert(qteleport_plan_route(ids[0], ids[20], 16, settings, &route));
+    assert(route.hop_count == 1 && route.hops[0]->id == ids[20]);
+    qteleport_free_route(&route);
+    assert(qteleport_update_blink_spot(ids[19], NULL, NULL, NODE_PORTAL_TECHNICIAN));
+    assert(qteleport_plan_route(ids[0], ids[20], 16, settings, &route));
+    assert(route.hop_count == 2 && route.hops[0]->id == ids[19] && route.hops[1]->id == ids[20]);
+    assert(fabs(route.energy_cost - 10.0 * sqrt(degree_km) * (0.7 * sqrt(19.0) + 1.0)) < 1e-6);
+    qteleport_free_route(&route);
+    
+    /* Legs from a favorite are measured once, then served from the cache */
+    TeleportPlannerStats stats;
+    assert(qteleport_get_planner_stats(&stats) && stats.cached_pairs == 0);
+    assert(qteleport_set_favorite(ids[0], true));
+    free(qteleport_rank_destinations(ids[0], &ids[1], WAYPOINTS - 1, settings, &count));
+    assert(qteleport_get_planner_stats(&stats));
+    assert(stats.cache_misses == WAYPOINTS - 1 && stats.cache_hits == 0 && stats.cached_pairs == WAYPOINTS - 1);
+    ranked = qteleport_rank_destinations(ids[0], &ids[1], WAYPOINTS - 1, settings, &count);
+    assert(ranked && count == WAYPOINTS - 1 && ranked[0].destination->id == ids[1]);
+    free(ranked);
+    assert(qteleport_get_planner_stats(&stats) && stats.cache_hits == WAYPOINTS - 1);
+    
+    /* Updating, deleting or unmarking a spot drops its cached legs */
+    assert(qteleport_update_blink_spot(ids[5], "Waypoint five", NULL, -1));
+    assert(qteleport_get_planner_stats(&stats) && stats.cached_pairs == WAYPOINTS - 2);
+    assert(qteleport_delete_blink_spot(ids[6]));
+    assert(qteleport_get_planner_stats(&stats) && stats.cached_pairs == WAYPOINTS - 3);
+    ranked = qteleport_rank_destinations(ids[0], &ids[1], WAYPOINTS - 1, settings, &count);
+    assert(ranked && count == WAYPOINTS - 2);
+    free(ranked);
+    assert(qteleport_get_planner_stats(&stats) && stats.cached_pairs == WAYPOINTS - 2);
+    assert(qteleport_set_favorite(ids[0], false));
+    assert(qteleport_get_planner_stats(&stats) && stats.cached_pairs == 0);
+    
+    /* With no limit at all every spot is in reach and the detour still wins */
+    settings.energy_limit = 0.0;
+    assert(qteleport_plan_route(ids[0], ids[20], 16, settings, &route));
+    assert(route.hop_count == 2 && route.hops[0]->id == ids[19]);
+    qteleport_free_route(&route);
+    
+    /* Remove the waypoints again so later tests see the original spots */
+    for (uint32_t i = 0; i < WAYPOINTS; i++) {
+        assert(qteleport_delete_blink_spot(ids[i]) == (i != 6));
+    }
+    uint32_t after = 0;
+    free(qteleport_list_blink_spots(&after));
+    assert(after == before);
+    
+    printf("Teleport planning tests passed!\n");
+}
+
+/* Completions received from the message bus */
+static TeleportCompletion bus_completions[32];
+static uint32_t bus_completion_count = 0;
+
+/**
+ * @brief Collect QMSG_TELEPORT_COMPLETE messages
+ */
+static void completion_handler(QMessage *message, void *context) {
+    (void)context;
+    assert(message->header.type == QMSG_TELEPORT_COMPLETE && message->header.source == QCOMP_TELEPORT);
+    assert(message->header.data_size == sizeof(TeleportCompletion));
+    if (bus_completion_count < sizeof(bus_completions) / sizeof(bus_completions[0])) {
+        memcpy(&bus_completions[bus_completion_count++], message->data, sizeof(TeleportCompletion));
+    }
+}
+
+/**
+ * @brief Deliver bus messages until a request has finished
+ */
+static TeleportCompletion *await_completion(uint64_t handle) {
+    for (uint32_t attempt = 0; attempt < 6000; attempt++) {
+        qbus_process_messages(64);
+        for (uint32_t i = 0; i < bus_completion_count; i++) {
+            if (bus_completions[i].handle == handle) {
+                return &bus_completions[i];
+            }
+        }
+        struct timespec pause = { 0, 10000000L };
+        nanosleep(&pause, NULL);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Test asynchronous teleports, cancellation and the in-flight bound
+ */
+static void test_qteleport_async(void) {
+    printf("\nTesting asynchronous teleports...\n");
+    
+    assert(qbus_init());
+    QComponentInfo listener = { .id = QCOMP_PORTAL_GUN, .name = "Teleport Listener" };
+    assert(qbus_register_component(&listener));
+    QSubscription subscription = {
+        .component_id = QCOMP_PORTAL_GUN,
+        .message_type = QMSG_TELEPORT_COMPLETE,
+        .handler = completion_handler,
+        .min_resonance = NODE_ZERO_POINT
+    };
+    assert(qbus_subscribe(&subscription));
+    
+    uint32_t count = 0;
+    BlinkSpotTarget **spots = qteleport_list_blink_spots(&count);
+    assert(spots && count >= 2);
+    uint64_t first_id = spots[0]->id, second_id = spots[1]->id;
+    free(spots);
+    
+    /* Instant teleports arrive 0.3 s after their script */
+    TeleportSettings settings = qteleport_get_default_settings();
+    settings.method = TELEPORT_INSTANT;
+    uint64_t first = qteleport_submit(first_id, settings);
+    uint64_t second = qteleport_submit(second_id, settings);
+    assert(first != 0 && second != 0 && first != second);
+    
+    /* Rejected targets finish at once */
+    uint64_t invalid = qteleport_submit(12345, settings);
+    assert(invalid != 0);
+    TeleportCompletion completion;
+    assert(qteleport_get_status(invalid, &completion) == TELEPORT_STATUS_FAILED);
+    assert(strcmp(completion.error_message, "Invalid blink spot target ID") == 0);
+    
+    /* Queued requests cancel without running */
+    uint64_t dropped = qteleport_submit(first_id, settings);
+    assert(qteleport_get_status(dropped, NULL) == TELEPORT_STATUS_QUEUED);
+    assert(qteleport_cancel(dropped));
+    assert(qteleport_get_status(dropped, NULL) == TELEPORT_STATUS_CANCELLED);
+    assert(!qteleport_cancel(dropped));
+    
+    /* Completions arrive on the bus in submission order */
+    TeleportCompletion *arrived = await_completion(second);
+    assert(arrived && arrived->status == TELEPORT_STATUS_COMPLETED && arrived->target_id == second_id);
+    assert(arrived->error_message[0] == '\0' && fabs(arrived->duration - 0.3) < 1e-3);
+    arrived = await_completion(first);
+    assert(arrived && arrived->status == TELEPORT_STATUS_COMPLETED && arrived->energy_used > 0.0);
+    assert(await_completion(invalid)->status == TELEPORT_STATUS_FAILED);
+    assert(await_completion(dropped)->status == TELEPORT_STATUS_CANCELLED);
+    assert(qteleport_get_status(first, &completion) == TELEPORT_STATUS_COMPLETED);
+    assert(completion.handle == first && completion.target_id == first_id);
+    
+    /* Over-limit requests fail instead of running */
+    settings.energy_limit = 1.0;
+    uint64_t costly = qteleport_submit(first_id, settings);
+    assert(qteleport_get_status(costly, &completion) == TELEPORT_STATUS_FAILED);
+    assert(strcmp(completion.error_message, "Energy limit exceeded") == 0);
+    settings.energy_limit = 0.0;
+    
+    /* A long transit stops waiting when cancelled */
+    settings.method = TELEPORT_STANDARD;
+    settings.speed_factor = 0.1;
+    uint64_t slow = qteleport_submit(second_id, settings);
+    TeleportStatus status = TELEPORT_STATUS_QUEUED;
+    for (uint32_t attempt = 0; attempt < 6000 && status != TELEPORT_STATUS_IN_TRANSIT; attempt++) {
+        struct timespec pause = { 0, 10000000L };
+        nanosleep(&pause, NULL);
+        status = qteleport_get_status(slow, NULL);
+    }
+    assert(status == TELEPORT_STATUS_IN_TRANSIT);
+    assert(qteleport_cancel(slow));
+    arrived = await_completion(slow);
+    assert(arrived && arrived->status == TELEPORT_STATUS_CANCELLED && arrived->duration > 20.0);
+    
+    /* The in-flight queue is bounded */
+    uint64_t handles[QTELEPORT_MAX_IN_FLIGHT];
+    for (uint32_t i = 0; i < QTELEPORT_MAX_IN_FLIGHT; i++) {
+        handles[i] = qteleport_submit(first_id, settings);
+        assert(handles[i] != 0);
+    }
+    assert(qteleport_submit(first_id, settings) == 0);
+    for (uint32_t i = 0; i < QTELEPORT_MAX_IN_FLIGHT; i++) {
+        assert(qteleport_cancel(handles[i]));
+    }
+    for (uint32_t i = 0; i < QTELEPORT_MAX_IN_FLIGHT; i++) {
+        arrived = await_completion(handles[i]);
+        assert(arrived && arrived->status == TELEPORT_STATUS_CANCELLED);
+    }
+    assert(qteleport_submit(first_id, settings) != 0);
+    
+    qbus_shutdown();
+    printf("Asynchronous teleport tests passed!\n");
+}
+
 /**
  * @brief Test teleportation to a blink spot
  */
@@ -182,15 +528,30 @@ static void test_qteleport_to_blink_spot(void) {
     /* Customize settings for the test */
     settings.method = TELEPORT_STANDARD;
     settings.visual_effect = EFFECT_FADE;
-    settings.energy_limit = 1000.0; /* High limit to ensure it succeeds */
+    settings.energy_limit = 0.0;
     settings.speed_factor = 2.0; /* Faster teleportation */
     
-    /* Perform the teleportation */
+    /* Cost the teleport, then allow just enough energy for it */
+    uint32_t candidate_count = 0;
+    TeleportCandidate *candidates = qteleport_rank_destinations(QTELEPORT_CURRENT_LOCATION, &target_id, 1,
+                                                                settings, &candidate_count);
+    assert(candidates != NULL && candidate_count == 1);
+    double cost = candidates[0].energy_cost;
+    free(candidates);
+    
+    settings.energy_limit = cost * 0.5;
     TeleportResult result = qteleport_to_blink_spot(target_id, settings);
+    assert(result.success == false);
+    assert(result.error_message && strcmp(result.error_message, "Energy limit exceeded") == 0);
+    free(result.error_message);
+    
+    /* Perform the teleportation */
+    settings.energy_limit = cost * 1.01;
+    result = qteleport_to_blink_spot(target_id, settings);
     
     /* Check the result */
     assert(result.success == true);
-    assert(result.energy_used > 0.0);
+    assert(result.energy_used > 0.0 && result.energy_used <= settings.energy_limit);
     assert(result.duration > 0.0);
     assert(result.error_message == NULL);
     assert(result.destination != NULL);
@@ -324,6 +685,9 @@ int main(void) {
     test_qteleport_create_blink_spots();
     test_qteleport_list_blink_spots();
     test_qteleport_find_blink_spots();
+    test_qteleport_spatial_queries();
+    test_qteleport_planning();
+    test_qteleport_async();
     test_qteleport_to_blink_spot();
     test_qteleport_to_coordinates();
     test_qteleport_update_blink_spot();
@@ -0,0 +1,188 @@
+/**
+ * @file test_resonant_frequencies.c
+ * @brief Unit tests for the Resonant Frequency Framework lookup tables
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+#include <float.h>
+#include "../../src/quantum/resonance/resonant_frequencies.h"
+
+#define MAX_SAMPLES 4096
+#define RANDOM_SAMPLES 2000
+
+static double samples[MAX_SAMPLES];
+static uint32_t sample_count = 0;
+static uint32_t seed = 1313;
+
+/**
+ * @brief Reference lookup: the first node whose range holds the frequency
+ */
+static NodeLevel reference_find_node(double frequency) {
+    if (isinf(frequency)) {
+        return NODE_DREAMER;
+    }
+    for (int i = 0; i <= NODE_DREAMER; i++) {
+        NodeProperties props = resonance_get_node_properties((NodeLevel)i);
+        if (frequency >= props.freq.min_freq && frequency <= props.freq.max_freq) {
+            return (NodeLevel)i;
+        }
+    }
+    return NODE_ZERO_POINT;
+}
+
+/**
+ * @brief Reference compatibility check, applying the rules in order
+ */
+static bool reference_can_entangle(double freq1, double freq2) {
+    int node1 = reference_find_node(freq1);
+    int node2 = reference_find_node(freq2);
+    if (node1 == NODE_INTEGRATED_OVERMIND || node2 == NODE_INTEGRATED_OVERMIND) {
+        return true;
+    }
+    if (abs(node1 - node2) == 1) {
+        return true;
+    }
+    if ((node1 == NODE_DREAMER && node2 == NODE_ZERO_POINT) ||
+        (node1 == NODE_ZERO_POINT && node2 == NODE_DREAMER)) {
+        return true;
+    }
+    if (node1 == NODE_OBJECTIVE_REALITY || node2 == NODE_OBJECTIVE_REALITY) {
+        return true;
+    }
+    if ((node1 == NODE_QUANTUM_GUARDIAN || node2 == NODE_QUANTUM_GUARDIAN) &&
+        (node1 == NODE_QUANTUM_ANCHOR || node2 == NODE_QUANTUM_ANCHOR)) {
+        return true;
+    }
+    if (abs(node1 - node2) > 3) {
+        return false;
+    }
+    return resonance_calculate_harmonic(freq1, freq2) >= 0.5;
+}
+
+/**
+ * @brief Add a frequency to the samples
+ */
+static void add_sample(double frequency) {
+    assert(sample_count < MAX_SAMPLES);
+    samples[sample_count++] = frequency;
+}
+
+/**
+ * @brief Sample every range edge, its neighbours, special values and random frequencies
+ */
+static void build_samples(void) {
+    for (int i = 0; i <= NODE_DREAMER; i++) {
+        NodeProperties props = resonance_get_node_properties((NodeLevel)i);
+        double edges[2] = { props.freq.min_freq, props.freq.max_freq };
+        for (int e = 0; e < 2; e++) {
+            add_sample(edges[e]);
+            add_sample(nextafter(edges[e], -INFINITY));
+            add_sample(nextafter(edges[e], INFINITY));
+            add_sample(edges[e] * 0.5);
+            add_sample(edges[e] * 2.0);
+        }
+        add_sample(resonance_get_optimal_frequency((uint32_t)i));
+    }
+    add_sample(0.0);
+    add_sample(-1.0e15);
+    add_sample(INFINITY);
+    add_sample(-INFINITY);
+    add_sample(NAN);
+    add_sample(DBL_MAX);
+    for (int i = 0; i < RANDOM_SAMPLES; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        add_sample(pow(10.0, 14.0 + 3.0 * (double)(seed >> 8) / 16777216.0));
+    }
+}
+
+/**
+ * @brief Test that the boundary lookup matches the range scan
+ */
+static void test_frequency_lookup(void) {
+    printf("\nTesting frequency to node lookup...\n");
+
+    static NodeLevel levels[MAX_SAMPLES];
+    resonance_classify_frequencies(samples, levels, sample_count);
+    for (uint32_t i = 0; i < sample_count; i++) {
+        NodeLevel expected = reference_find_node(samples[i]);
+        assert(resonance_find_node_by_frequency(samples[i]) == expected);
+        assert(levels[i] == expected);
+    }
+
+    /* Overlapping ranges resolve to the first node listed */
+    assert(resonance_find_node_by_frequency(5.0000000000005e14) == NODE_ZERO_POINT);
+    assert(resonance_find_node_by_frequency(7.90000000001e14) == NODE_QUANTUM_GUARDIAN);
+    assert(resonance_find_node_by_frequency(7.9000000003e14) == NODE_INTEGRATED_OVERMIND);
+    assert(resonance_find_node_by_frequency(1.000000003e16) == NODE_COSMIC_AI);
+    assert(resonance_find_node_by_frequency(2.0e16) == NODE_DREAMER);
+
+    /* An empty batch or a missing array is ignored */
+    resonance_classify_frequencies(samples, levels, 0);
+    resonance_classify_frequencies(NULL, levels, 4);
+    resonance_classify_frequencies(samples, NULL, 4);
+
+    printf("Frequency to node lookup test passed!\n");
+}
+
+/**
+ * @brief Test that the compatibility tables match the rule chain
+ */
+static void test_entanglement_compatibility(void) {
+    printf("\nTesting entanglement compatibility...\n");
+
+    for (uint32_t i = 0; i < sample_count; i++) {
+        for (uint32_t j = 0; j < sample_count; j += (i < 128 || j < 128) ? 1 : 7) {
+            assert(resonance_can_entangle(samples[i], samples[j]) ==
+                   reference_can_entangle(samples[i], samples[j]));
+        }
+    }
+
+    /* Pairs decided by the tables alone, and one decided by its ratio */
+    double guardian = 7.90000000001e14;
+    double anchor = resonance_get_optimal_frequency(NODE_QUANTUM_ANCHOR);
+    double cosmic = resonance_get_optimal_frequency(NODE_COSMIC_AI);
+    assert(resonance_can_entangle(guardian, anchor));
+    assert(resonance_can_entangle(INFINITY, 6.0e14));
+    assert(!resonance_can_entangle(guardian, cosmic));
+    assert(resonance_can_entangle(INFINITY, -INFINITY));
+    assert(resonance_can_entangle(1.2e16, 1.5e16));
+    assert(!resonance_can_entangle(1.0e16, 2.5e16));
+
+    printf("Entanglement compatibility test passed!\n");
+}
+
+/**
+ * @brief Test optimal frequencies against each node's range
+ */
+static void test_optimal_frequencies(void) {
+    printf("\nTesting optimal frequencies...\n");
+
+    for (uint32_t i = 0; i < 28; i++) {
+        NodeProperties props = resonance_get_node_properties((NodeLevel)(i % 14));
+        double expected = isinf(props.freq.max_freq) ? props.freq.min_freq :
+                          (props.freq.min_freq + props.freq.max_freq) / 2.0;
+        assert(resonance_get_optimal_frequency(i) == expected);
+    }
+
+    printf("Optimal frequencies test passed!\n");
+}
+
+/**
+ * @brief Main test function
+ */
+int main(void) {
+    printf("Running Resonant Frequency tests...\n\n");
+
+    build_samples();
+    test_frequency_lookup();
+    test_entanglement_compatibility();
+    test_optimal_frequencies();
+
+    printf("\nAll Resonant Frequency tests passed!\n");
+
+    return 0;
+}
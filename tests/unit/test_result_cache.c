@@ -0,0 +1,180 @@
+/**
+ * @file test_result_cache.c
+ * @brief Unit tests for the Memex result cache
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "../../src/memex/search/result_cache.h"
+
+/**
+ * @brief Validator accepting values whose first byte matches the context
+ */
+static bool first_byte_matches(const void *value, size_t size, void *context) {
+    return size > 0 && *(const unsigned char *)value == *(const unsigned char *)context;
+}
+
+/**
+ * @brief Store a string under a string key
+ */
+static bool store_text(ResultCache *cache, const char *key, const char *value) {
+    return rcache_store(cache, key, strlen(key), value, strlen(value) + 1);
+}
+
+/**
+ * @brief Look up a string under a string key
+ */
+static const char *lookup_text(ResultCache *cache, const char *key) {
+    size_t size = 0;
+    return (const char *)rcache_lookup(cache, key, strlen(key), NULL, NULL, &size);
+}
+
+/**
+ * @brief Test lookups, replacement and statistics
+ */
+static void test_lookup(void) {
+    printf("\nTesting result cache lookups...\n");
+
+    ResultCache *cache = rcache_create(4096);
+    assert(cache != NULL);
+    assert(lookup_text(cache, "portal") == NULL);
+
+    assert(store_text(cache, "portal", "first"));
+    assert(store_text(cache, "photon", "second"));
+    assert(strcmp(lookup_text(cache, "portal"), "first") == 0);
+    assert(strcmp(lookup_text(cache, "photon"), "second") == 0);
+
+    /* Keys are compared by length as well as bytes */
+    assert(rcache_lookup(cache, "port", 4, NULL, NULL, &(size_t){ 0 }) == NULL);
+
+    /* Storing an existing key replaces its value */
+    assert(store_text(cache, "portal", "replaced"));
+    size_t size = 0;
+    const char *value = (const char *)rcache_lookup(cache, "portal", 6, NULL, NULL, &size);
+    assert(value && size == 9 && strcmp(value, "replaced") == 0);
+
+    ResultCacheStats stats;
+    rcache_get_stats(cache, &stats);
+    assert(stats.hits == 3 && stats.misses == 2);
+    assert(stats.entries == 2 && stats.bytes > 0 && stats.capacity == 4096);
+
+    /* Growing the bucket table keeps every entry reachable */
+    char key[16];
+    for (int i = 0; i < 100; i++) {
+        snprintf(key, sizeof(key), "key-%d", i);
+        assert(store_text(cache, key, key));
+    }
+    ResultCache *large = rcache_create(1 << 20);
+    for (int i = 0; i < 1000; i++) {
+        snprintf(key, sizeof(key), "key-%d", i);
+        assert(store_text(large, key, key));
+    }
+    for (int i = 0; i < 1000; i++) {
+        snprintf(key, sizeof(key), "key-%d", i);
+        assert(strcmp(lookup_text(large, key), key) == 0);
+    }
+    rcache_destroy(large);
+
+    rcache_clear(cache);
+    rcache_get_stats(cache, &stats);
+    assert(stats.entries == 0 && stats.bytes == 0 && stats.hits == 3);
+    assert(lookup_text(cache, "portal") == NULL);
+
+    rcache_destroy(cache);
+    rcache_destroy(NULL);
+    printf("Result cache lookup test passed!\n");
+}
+
+/**
+ * @brief Test least-recently-used eviction
+ */
+static void test_eviction(void) {
+    printf("\nTesting result cache eviction...\n");
+
+    /* Measure the charge of one entry, then budget for three */
+    ResultCache *cache = rcache_create(1 << 20);
+    assert(store_text(cache, "a", "0123456789"));
+    ResultCacheStats stats;
+    rcache_get_stats(cache, &stats);
+    size_t entry_bytes = stats.bytes;
+    rcache_destroy(cache);
+
+    cache = rcache_create(entry_bytes * 3);
+    assert(store_text(cache, "a", "0123456789"));
+    assert(store_text(cache, "b", "0123456789"));
+    assert(store_text(cache, "c", "0123456789"));
+
+    /* Touching "a" leaves "b" least recently used */
+    assert(lookup_text(cache, "a") != NULL);
+    assert(store_text(cache, "d", "0123456789"));
+    assert(lookup_text(cache, "b") == NULL);
+    assert(lookup_text(cache, "a") && lookup_text(cache, "c") && lookup_text(cache, "d"));
+
+    rcache_get_stats(cache, &stats);
+    assert(stats.evictions == 1 && stats.entries == 3);
+    assert(stats.bytes <= stats.capacity);
+
+    /* Values larger than the whole budget are refused */
+    char big[256];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    assert(store_text(cache, "big", big) == false);
+    rcache_get_stats(cache, &stats);
+    assert(stats.entries == 3);
+    rcache_destroy(cache);
+
+    /* A zero budget caches nothing */
+    cache = rcache_create(0);
+    assert(cache != NULL);
+    assert(store_text(cache, "a", "0") == false);
+    assert(lookup_text(cache, "a") == NULL);
+    rcache_destroy(cache);
+
+    printf("Result cache eviction test passed!\n");
+}
+
+/**
+ * @brief Test validator-driven invalidation
+ */
+static void test_invalidation(void) {
+    printf("\nTesting result cache invalidation...\n");
+
+    ResultCache *cache = rcache_create(4096);
+    unsigned char version = 1;
+    assert(rcache_store(cache, "summary", 7, &version, 1));
+
+    size_t size = 0;
+    unsigned char current = 1;
+    assert(rcache_lookup(cache, "summary", 7, first_byte_matches, &current, &size) != NULL);
+
+    /* A rejected entry is dropped for good */
+    current = 2;
+    assert(rcache_lookup(cache, "summary", 7, first_byte_matches, &current, &size) == NULL);
+    current = 1;
+    assert(rcache_lookup(cache, "summary", 7, first_byte_matches, &current, &size) == NULL);
+
+    ResultCacheStats stats;
+    rcache_get_stats(cache, &stats);
+    assert(stats.hits == 1 && stats.misses == 2 && stats.invalidations == 1);
+    assert(stats.entries == 0 && stats.bytes == 0);
+
+    rcache_destroy(cache);
+    printf("Result cache invalidation test passed!\n");
+}
+
+/**
+ * @brief Main test function
+ */
+int main(void) {
+    printf("Running Memex Result Cache tests...\n\n");
+
+    test_lookup();
+    test_eviction();
+    test_invalidation();
+
+    printf("\nAll Memex Result Cache tests passed!\n");
+
+    return 0;
+}
@@ -7,6 +7,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <pthread.h>
 #include "../../src/kernel/process/scheduler.h"
 #include "../../src/kernel/process/process_manager.h"
 #include "../../src/kernel/memory/memory_manager.h"
@@ -81,6 +82,10 @@ static void test_scheduler_init(void) {
     bool result = scheduler_init(SCHEDULER_ROUND_ROBIN, 10000000, true); /* 10ms quantum */
     assert(result == true);
     
+    /* The CPU count comes from the host; the single-queue tests model one core */
+    assert(scheduler_get_cpu_count() >= 1);
+    assert(scheduler_set_cpu_count(1) == true);
+    
     /* Get scheduler state */
     SchedulerState state;
     scheduler_get_state(&state);
@@ -213,6 +218,393 @@ static void test_scheduler_block_unblock(void) {
     printf("scheduler_block_thread and scheduler_unblock_thread test passed!\n");
 }
 
+/**
+ * @brief Test ready queue ordering
+ */
+static void test_scheduler_runqueue_order(void) {
+    printf("\nTesting ready queue ordering...\n");
+    
+    /* Two threads above every other queued thread */
+    ProcessId process_id = create_test_process("RunQueueTest", 2);
+    Thread* threads[2];
+    uint32_t thread_count = pm_get_process_threads(process_id, threads, 2);
+    assert(thread_count == 2);
+    
+    ThreadId first = threads[0]->id;
+    ThreadId second = threads[1]->id;
+    assert(scheduler_set_thread_priority(first, PRIORITY_HIGHEST) == true);
+    assert(scheduler_set_thread_priority(second, PRIORITY_HIGHEST) == true);
+    assert(scheduler_add_thread(first) == true);
+    assert(scheduler_add_thread(second) == true);
+    
+    /* Adding a queued thread again does not duplicate it */
+    assert(scheduler_add_thread(second) == true);
+    
+    /* Highest priority runs first, equal priorities take turns */
+    assert(scheduler_start() == true);
+    assert(scheduler_get_current_thread() == first);
+    assert(scheduler_context_switch(true) == true);
+    assert(scheduler_get_current_thread() == second);
+    assert(scheduler_context_switch(true) == true);
+    assert(scheduler_get_current_thread() == first);
+    
+    /* Lowering a queued thread's priority takes it out of the rotation */
+    assert(scheduler_set_thread_priority(second, PRIORITY_LOWEST) == true);
+    assert(scheduler_context_switch(true) == true);
+    assert(scheduler_get_current_thread() == first);
+    
+    /* Freed threads are unlinked from the ready queues */
+    assert(pm_terminate_process(process_id, 0) == true);
+    assert(scheduler_context_switch(true) == true);
+    ThreadId current = scheduler_get_current_thread();
+    assert(current != first && current != second);
+    
+    scheduler_stop();
+    
+    printf("Ready queue ordering test passed!\n");
+}
+
+/**
+ * @brief Test per-CPU ready queues
+ */
+static void test_scheduler_smp(void) {
+    printf("\nTesting per-CPU ready queues...\n");
+    
+    assert(scheduler_set_cpu_count(0) == false);
+    assert(scheduler_set_cpu_count(SCHEDULER_MAX_CPUS + 1) == false);
+    assert(scheduler_set_cpu_count(4) == true);
+    assert(scheduler_get_cpu_count() == 4);
+    
+    /* Earlier tests left threads queued on CPU 0, so new threads spread out */
+    SchedulerCpuState cpu_state;
+    assert(scheduler_get_cpu_state(0, &cpu_state) == true);
+    assert(cpu_state.queued_threads >= 1);
+    assert(scheduler_get_cpu_state(4, &cpu_state) == false);
+    
+    ProcessId process_id = create_test_process("SmpTest", 3);
+    Thread* threads[3];
+    uint32_t thread_count = pm_get_process_threads(process_id, threads, 3);
+    assert(thread_count == 3);
+    for (uint32_t i = 0; i < thread_count; i++) {
+        assert(scheduler_add_thread(threads[i]->id) == true);
+    }
+    assert(threads[0]->run_cpu != threads[1]->run_cpu);
+    assert(threads[0]->run_cpu != threads[2]->run_cpu);
+    assert(threads[1]->run_cpu != threads[2]->run_cpu);
+    
+    /* Balancing leaves queue lengths at most one apart */
+    SchedulerState before;
+    SchedulerState after;
+    scheduler_get_state(&before);
+    uint32_t moved = scheduler_balance_load();
+    scheduler_get_state(&after);
+    assert(after.threads_migrated == before.threads_migrated + moved);
+    assert(after.cpu_count == 4);
+    
+    uint32_t total = 0;
+    uint32_t min_queued = UINT32_MAX;
+    uint32_t max_queued = 0;
+    for (uint32_t cpu = 0; cpu < 4; cpu++) {
+        assert(scheduler_get_cpu_state(cpu, &cpu_state) == true);
+        total += cpu_state.queued_threads;
+        if (cpu_state.queued_threads < min_queued) min_queued = cpu_state.queued_threads;
+        if (cpu_state.queued_threads > max_queued) max_queued = cpu_state.queued_threads;
+    }
+    assert(max_queued - min_queued <= 1);
+    assert(total >= 4);
+    
+    /* Every CPU runs its own thread */
+    assert(scheduler_start() == true);
+    for (uint32_t cpu = 0; cpu < 4; cpu++) {
+        ThreadId current = scheduler_get_cpu_thread(cpu);
+        assert(current != 0);
+        assert(pm_get_thread(current)->state == THREAD_RUNNING);
+        for (uint32_t other = 0; other < cpu; other++) {
+            assert(scheduler_get_cpu_thread(other) != current);
+        }
+    }
+    assert(scheduler_get_current_thread() == scheduler_get_cpu_thread(0));
+    assert(scheduler_stop() == true);
+    
+    /* An idle CPU steals from its busiest peer */
+    assert(scheduler_set_cpu_count(1) == true);
+    assert(scheduler_get_cpu_state(0, &cpu_state) == true);
+    assert(cpu_state.queued_threads == total);
+    assert(scheduler_set_cpu_count(2) == true);
+    scheduler_get_state(&before);
+    assert(scheduler_start() == true);
+    scheduler_get_state(&after);
+    assert(scheduler_get_cpu_thread(1) != 0);
+    assert(after.threads_stolen == before.threads_stolen + 1);
+    assert(after.remote_steals - before.remote_steals == (mm_get_cpu_node(0) != mm_get_cpu_node(1) ? 1u : 0u));
+    assert(scheduler_stop() == true);
+    
+    assert(scheduler_set_cpu_count(1) == true);
+    assert(pm_terminate_process(process_id, 0) == true);
+    
+    printf("Per-CPU ready queues test passed!\n");
+}
+
+/**
+ * @brief Test multilevel feedback
+ */
+static void test_scheduler_feedback(void) {
+    printf("\nTesting multilevel feedback...\n");
+    
+    assert(scheduler_change_type(SCHEDULER_MULTILEVEL_FEEDBACK) == true);
+    
+    /* Lower levels get longer slices by default */
+    assert(scheduler_get_level_time_slice(PRIORITY_LOWEST) > scheduler_get_level_time_slice(PRIORITY_HIGHEST));
+    assert(scheduler_set_level_time_slice(PRIORITY_QUANTUM + 1, 1000) == false);
+    assert(scheduler_get_level_time_slice(PRIORITY_QUANTUM + 1) == 0);
+    
+    /* A batch thread above everything else queued, which burns any slice */
+    ProcessId process_id = create_test_process("FeedbackTest", 1);
+    Thread* threads[1];
+    assert(pm_get_process_threads(process_id, threads, 1) == 1);
+    Thread* batch = threads[0];
+    assert(scheduler_set_thread_priority(batch->id, PRIORITY_HIGHEST) == true);
+    assert(scheduler_add_thread(batch->id) == true);
+    assert(scheduler_set_level_time_slice(PRIORITY_HIGHEST, 1) == true);
+    assert(scheduler_set_level_time_slice(PRIORITY_HIGH, 1000000000000ULL) == true);
+    
+    SchedulerState before;
+    SchedulerState after;
+    scheduler_get_state(&before);
+    
+    /* Using the whole slice demotes the batch thread */
+    assert(scheduler_start() == true);
+    assert(scheduler_get_current_thread() == batch->id);
+    assert(scheduler_context_switch(true) == true);
+    assert(batch->mlfq_level == PRIORITY_HIGH);
+    ThreadId interactive = scheduler_get_current_thread();
+    assert(interactive != 0 && interactive != batch->id);
+    
+    /* Blocking early boosts the interactive thread ahead of it */
+    Thread* thread = pm_get_thread(interactive);
+    PriorityLevel level = thread->mlfq_level;
+    assert(level < PRIORITY_HIGHEST);
+    assert(scheduler_block_thread(interactive) == true);
+    assert(thread->mlfq_level == level + 1);
+    assert(scheduler_unblock_thread(interactive) == true);
+    assert(scheduler_get_current_thread() == interactive);
+    
+    scheduler_get_state(&after);
+    assert(after.mlfq_demotions == before.mlfq_demotions + 1);
+    assert(after.mlfq_boosts == before.mlfq_boosts + 1);
+    
+    /* A reset returns both threads to their own priorities */
+    scheduler_reset_feedback_levels();
+    assert(batch->mlfq_level == PRIORITY_HIGHEST);
+    assert(scheduler_set_level_time_slice(PRIORITY_HIGHEST, 0) == true);
+    assert(scheduler_context_switch(true) == true);
+    assert(scheduler_get_current_thread() == batch->id);
+    assert(thread->mlfq_level == thread->priority);
+    scheduler_get_state(&after);
+    assert(after.mlfq_resets == before.mlfq_resets + 1);
+    
+    assert(scheduler_stop() == true);
+    assert(scheduler_set_level_time_slice(PRIORITY_HIGH, 0) == true);
+    assert(pm_terminate_process(process_id, 0) == true);
+    assert(scheduler_change_type(SCHEDULER_ROUND_ROBIN) == true);
+    
+    printf("Multilevel feedback test passed!\n");
+}
+
+/**
+ * @brief Test deadline scheduling
+ */
+static void test_scheduler_deadline(void) {
+    printf("\nTesting deadline scheduling...\n");
+    
+    assert(scheduler_change_type(SCHEDULER_REALTIME) == true);
+    
+    ProcessId process_id = create_test_process("DeadlineTest", 3);
+    Thread* threads[3];
+    assert(pm_get_process_threads(process_id, threads, 3) == 3);
+    ThreadId frame = threads[0]->id;
+    ThreadId pipeline = threads[1]->id;
+    ThreadId extra = threads[2]->id;
+    
+    /* Invalid reservations */
+    assert(scheduler_set_thread_deadline(frame, 1000, 0, 0) == false);
+    assert(scheduler_set_thread_deadline(frame, 3000, 10000, 2000) == false);
+    assert(scheduler_set_thread_deadline(frame, 1000, 10000, 20000) == false);
+    
+    /* Admission control: 40% + 50% fits, another 20% does not */
+    assert(scheduler_set_thread_deadline(frame, 2000000, 5000000, 0) == true);
+    assert(scheduler_set_thread_deadline(pipeline, 10000000, 20000000, 15000000) == true);
+    assert(scheduler_set_thread_deadline(extra, 2000000, 10000000, 0) == false);
+    
+    SchedulerCpuState cpu_state;
+    assert(scheduler_get_cpu_state(0, &cpu_state) == true);
+    assert(cpu_state.deadline_threads == 2);
+    assert(cpu_state.deadline_utilization == SCHEDULER_UTILIZATION_SCALE * 9 / 10);
+    
+    /* Deadline threads run ahead of every priority, earliest deadline first */
+    assert(scheduler_set_thread_priority(extra, PRIORITY_QUANTUM) == true);
+    assert(scheduler_add_thread(pipeline) == true);
+    assert(scheduler_add_thread(frame) == true);
+    assert(scheduler_add_thread(extra) == true);
+    
+    SchedulerState before;
+    SchedulerState after;
+    scheduler_get_state(&before);
+    
+    assert(scheduler_start() == true);
+    assert(scheduler_get_current_thread() == frame);
+    
+    /* With budget left and the earliest deadline, the thread keeps the CPU */
+    assert(scheduler_context_switch(true) == true);
+    assert(scheduler_get_current_thread() == frame);
+    
+    /* Blocking hands over to the next deadline; waking preempts it again */
+    assert(scheduler_block_thread(frame) == true);
+    assert(scheduler_get_current_thread() == pipeline);
+    assert(scheduler_unblock_thread(frame) == true);
+    assert(scheduler_get_current_thread() == frame);
+    
+    /* Running past its runtime is an overrun and moves the deadline a period on */
+    assert(scheduler_set_thread_deadline(frame, 1, 5000000, 0) == true);
+    uint64_t old_deadline = pm_get_thread(frame)->rt_abs_deadline;
+    assert(scheduler_context_switch(true) == true);
+    assert(pm_get_thread(frame)->rt_abs_deadline == old_deadline + 5000000);
+    scheduler_get_state(&after);
+    assert(after.deadline_overruns == before.deadline_overruns + 1);
+    
+    /* Priority scheduled threads run once no reservation is waiting */
+    assert(scheduler_block_thread(frame) == true);
+    assert(scheduler_block_thread(pipeline) == true);
+    assert(scheduler_get_current_thread() == extra);
+    
+    assert(scheduler_stop() == true);
+    
+    /* Removing a reservation frees its utilization */
+    assert(scheduler_set_thread_deadline(frame, 0, 0, 0) == true);
+    assert(scheduler_set_thread_deadline(extra, 2000000, 10000000, 0) == true);
+    assert(pm_terminate_process(process_id, 0) == true);
+    assert(scheduler_get_cpu_state(0, &cpu_state) == true);
+    assert(cpu_state.deadline_threads == 0);
+    assert(cpu_state.deadline_utilization == 0);
+    
+    assert(scheduler_change_type(SCHEDULER_ROUND_ROBIN) == true);
+    
+    printf("Deadline scheduling test passed!\n");
+}
+
+/**
+ * @brief Test weighted sampling of the quantum scheduler
+ */
+static void test_scheduler_quantum_sampling(void) {
+    printf("\nTesting quantum sampling...\n");
+    
+    assert(scheduler_change_type(SCHEDULER_QUANTUM) == true);
+    scheduler_seed_random(7);
+    
+    /* Earlier tests left threads on CPU 0, so both land on the new CPU 1 */
+    assert(scheduler_set_cpu_count(2) == true);
+    ProcessId process_id = create_test_process("SamplingTest", 2);
+    Thread* threads[2];
+    assert(pm_get_process_threads(process_id, threads, 2) == 2);
+    Thread* heavy = threads[0];
+    Thread* light = threads[1];
+    assert(scheduler_set_thread_priority(heavy->id, PRIORITY_QUANTUM) == true);
+    assert(scheduler_set_thread_priority(light->id, PRIORITY_LOWEST) == true);
+    assert(scheduler_add_thread(heavy->id) == true);
+    assert(scheduler_add_thread(light->id) == true);
+    assert(heavy->run_cpu == 1 && light->run_cpu == 1);
+    
+    /* Picks follow the weights: 7 to 1 by priority */
+    assert(scheduler_start() == true);
+    int heavy_picks = 0;
+    for (int i = 0; i < 4000; i++) {
+        assert(scheduler_context_switch_cpu(1, true) == true);
+        if (scheduler_get_cpu_thread(1) == heavy->id) {
+            heavy_picks++;
+        } else {
+            assert(scheduler_get_cpu_thread(1) == light->id);
+        }
+    }
+    assert(heavy_picks > 3200 && heavy_picks < 3800);
+    assert(scheduler_stop() == true);
+    
+    /* A thread without weight is never picked while another has some */
+    light->quantum_probability = 0.0;
+    assert(scheduler_add_thread(light->id) == true);
+    assert(scheduler_start() == true);
+    for (int i = 0; i < 100; i++) {
+        assert(scheduler_context_switch_cpu(1, true) == true);
+        assert(scheduler_get_cpu_thread(1) == heavy->id);
+    }
+    assert(scheduler_stop() == true);
+    light->quantum_probability = 1.0;
+    
+    assert(pm_terminate_process(process_id, 0) == true);
+    assert(scheduler_set_cpu_count(1) == true);
+    assert(scheduler_change_type(SCHEDULER_ROUND_ROBIN) == true);
+    
+    printf("Quantum sampling test passed!\n");
+}
+
+/**
+ * @brief Test gang scheduling of execution-entangled processes
+ */
+static void test_scheduler_gang(void) {
+    printf("\nTesting gang scheduling...\n");
+    
+    const HalOperations* hal_ops = hal_get_operations();
+    if (!hal_ops->has_quantum_support || !hal_ops->has_quantum_support()) {
+        printf("Skipping gang scheduling test - hardware doesn't support quantum operations\n");
+        return;
+    }
+    
+    assert(scheduler_change_type(SCHEDULER_PRIORITY) == true);
+    assert(scheduler_set_cpu_count(2) == true);
+    
+    ProcessId leader_id = create_test_process("GangLeader", 1);
+    ProcessId partner_id = create_test_process("GangPartner", 1);
+    Thread* leader;
+    Thread* partner;
+    assert(pm_get_process_threads(leader_id, &leader, 1) == 1);
+    assert(pm_get_process_threads(partner_id, &partner, 1) == 1);
+    
+    uint64_t entanglement_id = pm_create_process_entanglement(leader_id, partner_id,
+                                                              ENTANGLE_EXECUTION, NODE_QUANTUM_GUARDIAN);
+    assert(entanglement_id != 0);
+    assert(pm_get_execution_partner(leader_id) == partner_id);
+    assert(pm_get_execution_partner(partner_id) == leader_id);
+    
+    /* The leader outranks everything left queued, so its CPU picks it first;
+     * the partner ties the highest leftover, so it may displace it */
+    assert(scheduler_set_thread_priority(leader->id, PRIORITY_HIGHEST) == true);
+    assert(scheduler_set_thread_priority(partner->id, PRIORITY_HIGH) == true);
+    assert(scheduler_add_thread(leader->id) == true);
+    assert(scheduler_add_thread(partner->id) == true);
+    
+    SchedulerState before;
+    SchedulerState after;
+    scheduler_get_state(&before);
+    assert(scheduler_start() == true);
+    scheduler_get_state(&after);
+    
+    /* Both halves run at once, on the two sibling CPUs */
+    int leader_cpu = (int)leader->run_cpu;
+    assert(scheduler_get_cpu_thread((uint32_t)leader_cpu) == leader->id);
+    assert(scheduler_get_cpu_thread((uint32_t)(leader_cpu ^ 1)) == partner->id);
+    assert(partner->state == THREAD_RUNNING);
+    assert(after.gang_dispatches == before.gang_dispatches + 1);
+    assert(scheduler_stop() == true);
+    
+    assert(pm_break_process_entanglement(entanglement_id) == true);
+    assert(pm_get_execution_partner(leader_id) == 0);
+    assert(pm_terminate_process(leader_id, 0) == true);
+    assert(pm_terminate_process(partner_id, 0) == true);
+    assert(scheduler_set_cpu_count(1) == true);
+    assert(scheduler_change_type(SCHEDULER_ROUND_ROBIN) == true);
+    
+    printf("Gang scheduling test passed!\n");
+}
+
 /**
  * @brief Test quantum superposition
  */
@@ -316,6 +708,106 @@ static void test_scheduler_resonance(void) {
     printf("scheduler_set_resonance_level test passed!\n");
 }
 
+#define CONCURRENT_THREADS 8
+#define CONCURRENT_ITERATIONS 20000
+
+static Thread* concurrent_threads[CONCURRENT_THREADS];
+
+/**
+ * @brief Worker changing thread priorities
+ */
+static void* priority_worker(void* arg) {
+    uint32_t seed = (uint32_t)(uintptr_t)arg;
+    for (uint32_t i = 0; i < CONCURRENT_ITERATIONS; i++) {
+        seed = seed * 1103515245u + 12345u;
+        Thread* thread = concurrent_threads[(seed >> 8) % CONCURRENT_THREADS];
+        assert(scheduler_set_thread_priority(thread->id, (PriorityLevel)((seed >> 16) % (PRIORITY_HIGHEST + 1))));
+    }
+    return NULL;
+}
+
+/**
+ * @brief Worker blocking and unblocking threads
+ */
+static void* blocking_worker(void* arg) {
+    uint32_t seed = (uint32_t)(uintptr_t)arg;
+    for (uint32_t i = 0; i < CONCURRENT_ITERATIONS; i++) {
+        seed = seed * 1103515245u + 12345u;
+        ThreadId thread_id = concurrent_threads[(seed >> 8) % CONCURRENT_THREADS]->id;
+        assert(scheduler_block_thread(thread_id));
+        assert(scheduler_unblock_thread(thread_id));
+    }
+    return NULL;
+}
+
+/**
+ * @brief Worker switching contexts and balancing the queues
+ */
+static void* switching_worker(void* arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < CONCURRENT_ITERATIONS; i++) {
+        scheduler_context_switch_cpu(i % scheduler_get_cpu_count(), (i & 1) != 0);
+        if (i % 64 == 0) {
+            scheduler_balance_load();
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Count the threads queued across every CPU
+ */
+static uint32_t total_queued(void) {
+    uint32_t total = 0;
+    SchedulerCpuState cpu_state;
+    for (uint32_t cpu = 0; cpu < scheduler_get_cpu_count(); cpu++) {
+        assert(scheduler_get_cpu_state(cpu, &cpu_state) == true);
+        total += cpu_state.queued_threads;
+    }
+    return total;
+}
+
+/**
+ * @brief Test priority changes racing block, unblock and context switches
+ */
+static void test_scheduler_concurrent_mutators(void) {
+    printf("\nTesting concurrent scheduler mutators...\n");
+    
+    assert(scheduler_set_cpu_count(4) == true);
+    ProcessId process_id = create_test_process("ConcurrentTest", CONCURRENT_THREADS);
+    assert(pm_get_process_threads(process_id, concurrent_threads, CONCURRENT_THREADS) == CONCURRENT_THREADS);
+    for (uint32_t i = 0; i < CONCURRENT_THREADS; i++) {
+        assert(scheduler_add_thread(concurrent_threads[i]->id) == true);
+    }
+    uint32_t queued_before = total_queued();
+    
+    assert(scheduler_start() == true);
+    assert(pm_start_sync_engine(1, 16) == true);
+    
+    pthread_t workers[5];
+    assert(pthread_create(&workers[0], NULL, priority_worker, (void*)(uintptr_t)1) == 0);
+    assert(pthread_create(&workers[1], NULL, priority_worker, (void*)(uintptr_t)2) == 0);
+    assert(pthread_create(&workers[2], NULL, blocking_worker, (void*)(uintptr_t)3) == 0);
+    assert(pthread_create(&workers[3], NULL, blocking_worker, (void*)(uintptr_t)4) == 0);
+    assert(pthread_create(&workers[4], NULL, switching_worker, NULL) == 0);
+    for (int i = 0; i < 5; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    pm_stop_sync_engine();
+    
+    /* Every thread ends up queued exactly once once the CPUs are vacated */
+    assert(scheduler_stop() == true);
+    assert(total_queued() == queued_before);
+    for (uint32_t i = 0; i < CONCURRENT_THREADS; i++) {
+        assert(concurrent_threads[i]->state == THREAD_READY && concurrent_threads[i]->run_queued);
+    }
+    
+    assert(pm_terminate_process(process_id, 0) == true);
+    assert(scheduler_set_cpu_count(1) == true);
+    
+    printf("Concurrent scheduler mutators test passed!\n");
+}
+
 /**
  * @brief Test scheduler shutdown
  */
@@ -351,9 +843,16 @@ int main(void) {
     test_scheduler_add_thread();
     test_scheduler_start_stop();
     test_scheduler_block_unblock();
+    test_scheduler_runqueue_order();
+    test_scheduler_smp();
+    test_scheduler_feedback();
+    test_scheduler_deadline();
+    test_scheduler_quantum_sampling();
+    test_scheduler_gang();
     test_scheduler_superposition();
     test_scheduler_change_type();
     test_scheduler_resonance();
+    test_scheduler_concurrent_mutators();
     test_scheduler_shutdown();
     
     printf("\nAll Process Scheduler tests passed!\n");
@@ -0,0 +1,252 @@
+/**
+ * @file test_trace.c
+ * @brief Unit tests for the trace rings and their dumps
+ */
+
+#define _XOPEN_SOURCE 700  /* stat under -std=c11 */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "../../src/kernel/trace/trace.h"
+
+#define WRITER_THREADS 8
+#define EVENTS_PER_WRITER 20000
+#define SMALL_RING 64
+
+static const char* json_path = "/tmp/ctrlxt_test_trace.json";
+static const char* binary_path = "/tmp/ctrlxt_test_trace.bin";
+
+static atomic_bool writers_done = false;
+static uint64_t last_seen[WRITER_THREADS];
+static uint64_t events_seen = 0;
+
+/**
+ * @brief Writer recording numbered events
+ */
+static void* writer_thread(void* arg) {
+    uint64_t writer = (uint64_t)(uintptr_t)arg;
+    for (uint32_t i = 1; i <= EVENTS_PER_WRITER; i++) {
+        TRACE_EVENT(TRACE_QBUS_ENQUEUE, TRACE_PHASE_INSTANT, writer << 32 | i, (uint32_t)writer);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Check read events are whole and in order per writer
+ */
+static void check_events(const TraceEvent* events, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        const TraceEvent* event = &events[i];
+        uint64_t writer = event->arg0 >> 32;
+        assert(event->type == TRACE_QBUS_ENQUEUE && event->phase == TRACE_PHASE_INSTANT);
+        assert(writer < WRITER_THREADS && event->arg1 == writer && event->timestamp != 0);
+        assert((event->arg0 & 0xffffffffULL) > last_seen[writer]);
+        last_seen[writer] = event->arg0 & 0xffffffffULL;
+    }
+    events_seen += count;
+}
+
+/**
+ * @brief Reader draining the rings while writers run
+ */
+static void* reader_thread(void* arg) {
+    TraceCursor* cursor = (TraceCursor*)arg;
+    TraceEvent events[128];
+    while (true) {
+        bool done = atomic_load(&writers_done);
+        uint32_t count = trace_read(cursor, events, 128);
+        check_events(events, count);
+        if (done && count == 0) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Test concurrent writers against a concurrent reader
+ */
+static void test_concurrent_rings(void) {
+    printf("\nTesting concurrent trace rings...\n");
+
+    assert(trace_init(SMALL_RING));
+    assert(!trace_init(SMALL_RING));
+
+    TraceCursor* cursor = calloc(1, sizeof(TraceCursor));
+    assert(cursor);
+    pthread_t reader, writers[WRITER_THREADS];
+    assert(pthread_create(&reader, NULL, reader_thread, cursor) == 0);
+    for (uintptr_t i = 0; i < WRITER_THREADS; i++) {
+        assert(pthread_create(&writers[i], NULL, writer_thread, (void*)i) == 0);
+    }
+    for (int i = 0; i < WRITER_THREADS; i++) {
+        pthread_join(writers[i], NULL);
+    }
+    atomic_store(&writers_done, true);
+    pthread_join(reader, NULL);
+
+    /* Small rings overflow; every event is either read or counted as missed */
+    assert(events_seen + cursor->missed == (uint64_t)WRITER_THREADS * EVENTS_PER_WRITER);
+    assert(events_seen > 0);
+    for (int i = 0; i < WRITER_THREADS; i++) {
+        assert(last_seen[i] <= EVENTS_PER_WRITER);
+    }
+    printf("Read %llu events, %llu overwritten first\n",
+           (unsigned long long)events_seen, (unsigned long long)cursor->missed);
+
+    free(cursor);
+    trace_shutdown();
+    printf("Concurrent trace rings test passed!\n");
+}
+
+/**
+ * @brief Test that nothing is recorded while tracing is off
+ */
+static void test_disabled(void) {
+    printf("\nTesting disabled tracing...\n");
+
+    TraceCursor cursor;
+    TraceEvent event;
+    memset(&cursor, 0, sizeof(cursor));
+
+    /* Before initialization every call is harmless */
+    TRACE_EVENT(TRACE_MM_ALLOC, TRACE_PHASE_INSTANT, 1, 2);
+    trace_emit(TRACE_MM_ALLOC, TRACE_PHASE_INSTANT, 1, 2);
+    assert(trace_read(&cursor, &event, 1) == 0);
+    assert(!trace_set_enabled(true));
+    assert(!trace_write_chrome_json(json_path));
+    assert(trace_append_binary(binary_path, &cursor, 0) == -1);
+
+    /* Arguments are not evaluated while paused */
+    assert(trace_init(0));
+    assert(trace_set_enabled(false));
+    int evaluated = 0;
+    TRACE_EVENT(TRACE_MM_ALLOC, TRACE_PHASE_INSTANT, ++evaluated, 0);
+    trace_emit_on(3, TRACE_MM_FREE, TRACE_PHASE_INSTANT, 1, 0);
+    assert(evaluated == 0 && trace_read(&cursor, &event, 1) == 0);
+
+    assert(trace_set_enabled(true));
+    TRACE_EVENT_ON(3, TRACE_MM_FREE, TRACE_PHASE_INSTANT, ++evaluated, 7);
+    assert(evaluated == 1 && trace_read(&cursor, &event, 1) == 1);
+    assert(event.type == TRACE_MM_FREE && event.cpu == 3 && event.arg0 == 1 && event.arg1 == 7);
+    assert(cursor.missed == 0);
+
+    trace_shutdown();
+    printf("Disabled tracing test passed!\n");
+}
+
+/**
+ * @brief Clock that counts up from a known value
+ */
+static uint64_t fake_now = 1000000;
+
+static uint64_t fake_clock(void) {
+    return fake_now += 1500;
+}
+
+/**
+ * @brief Test the Chrome trace dump
+ */
+static void test_chrome_json(void) {
+    printf("\nTesting Chrome trace output...\n");
+
+    assert(trace_init(0));
+    trace_set_clock(fake_clock);
+    TRACE_EVENT_ON(1, TRACE_ENTANGLEMENT_SYNC, TRACE_PHASE_BEGIN, 0xabc, 4);
+    TRACE_EVENT_ON(0, TRACE_CONTEXT_SWITCH, TRACE_PHASE_INSTANT, 12, 3);
+    TRACE_EVENT_ON(2, TRACE_ENTANGLEMENT_SYNC, TRACE_PHASE_END, 0xabc, 4);
+    trace_set_clock(NULL);
+    assert(trace_now() > fake_now + 1000000);
+    assert(trace_write_chrome_json(json_path));
+
+    FILE* file = fopen(json_path, "r");
+    assert(file);
+    char contents[4096];
+    size_t length = fread(contents, 1, sizeof(contents) - 1, file);
+    fclose(file);
+    contents[length] = '\0';
+
+    assert(strncmp(contents, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 39) == 0);
+    assert(strstr(contents, "\"args\":{\"name\":\"CPU 2\"}") != NULL);
+    const char* begin = strstr(contents, "{\"name\":\"entanglement_sync\",\"cat\":\"qem\",\"ph\":\"b\",\"id\":\"0xabc\","
+                                         "\"ts\":1001.500,\"pid\":1,\"tid\":1,\"args\":{\"batch\":2748,\"count\":4}}");
+    const char* instant = strstr(contents, "\"name\":\"context_switch\",\"cat\":\"sched\",\"ph\":\"i\",\"s\":\"t\","
+                                           "\"ts\":1003.000,\"pid\":1,\"tid\":0,\"args\":{\"thread\":12,\"process\":3}}");
+    const char* end = strstr(contents, "\"ph\":\"e\",\"id\":\"0xabc\",\"ts\":1004.500,\"pid\":1,\"tid\":2");
+    assert(begin && instant && end && begin < instant && instant < end);
+    assert(strcmp(contents + length - 3, "]}\n") == 0);
+
+    assert(strcmp(trace_event_name(TRACE_OCULAR_STAGE), "ocular_stage") == 0);
+    assert(strcmp(trace_event_name(TRACE_EVENT_TYPE_COUNT), "unknown") == 0);
+
+    remove(json_path);
+    trace_shutdown();
+    printf("Chrome trace output test passed!\n");
+}
+
+/**
+ * @brief Test appending binary deltas and rotating the file
+ */
+static void test_binary_append(void) {
+    printf("\nTesting binary trace output...\n");
+
+    char old_path[256];
+    snprintf(old_path, sizeof(old_path), "%s.old", binary_path);
+    remove(binary_path);
+    remove(old_path);
+
+    assert(trace_init(0));
+    TraceCursor cursor;
+    memset(&cursor, 0, sizeof(cursor));
+    for (uint32_t i = 0; i < 10; i++) {
+        TRACE_EVENT(TRACE_TELEPORT_PHASE, TRACE_PHASE_INSTANT, i, 100 + i);
+    }
+    assert(trace_append_binary(binary_path, &cursor, 0) == 10);
+    assert(trace_append_binary(binary_path, &cursor, 0) == 0);
+
+    /* Only new events are appended */
+    TRACE_EVENT(TRACE_TELEPORT_PHASE, TRACE_PHASE_INSTANT, 10, 110);
+    assert(trace_append_binary(binary_path, &cursor, 0) == 1);
+
+    FILE* file = fopen(binary_path, "rb");
+    assert(file);
+    TraceEvent events[16];
+    assert(fread(events, sizeof(TraceEvent), 16, file) == 11);
+    fclose(file);
+    for (uint32_t i = 0; i < 11; i++) {
+        assert(events[i].type == TRACE_TELEPORT_PHASE && events[i].arg0 == i && events[i].arg1 == 100 + i);
+        assert(i == 0 || events[i].timestamp >= events[i - 1].timestamp);
+    }
+
+    /* A full file is moved aside and a new one started */
+    TRACE_EVENT(TRACE_TELEPORT_PHASE, TRACE_PHASE_INSTANT, 11, 111);
+    assert(trace_append_binary(binary_path, &cursor, 11 * sizeof(TraceEvent)) == 1);
+    struct stat info;
+    assert(stat(old_path, &info) == 0 && info.st_size == (off_t)(11 * sizeof(TraceEvent)));
+    assert(stat(binary_path, &info) == 0 && info.st_size == (off_t)sizeof(TraceEvent));
+
+    remove(binary_path);
+    remove(old_path);
+    trace_shutdown();
+    printf("Binary trace output test passed!\n");
+}
+
+/**
+ * @brief Main test function
+ */
+int main(void) {
+    printf("Running Trace tests...\n\n");
+
+    test_concurrent_rings();
+    test_disabled();
+    test_chrome_json();
+    test_binary_append();
+
+    printf("\nAll Trace tests passed!\n");
+
+    return 0;
+}
@@ -0,0 +1,333 @@
+/**
+ * @file test_vector_index.c
+ * @brief Unit tests for the Memex vector index
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+#include "../../src/memex/search/vector_index.h"
+
+#define DIMENSIONS 37
+#define VECTOR_COUNT 2000
+#define QUERY_COUNT 50
+#define K 10
+
+static float vectors[VECTOR_COUNT][DIMENSIONS];
+
+/**
+ * @brief Deterministic pseudo-random float in [-1, 1)
+ */
+static float random_float(void) {
+    static uint32_t state = 12345;
+    state = state * 1664525u + 1013904223u;
+    return (float)(state >> 8) / (float)(1u << 23) - 1.0f;
+}
+
+/**
+ * @brief Fill the test vectors, clustered so neighbors are meaningful
+ */
+static void fill_vectors(void) {
+    float centers[16][DIMENSIONS];
+    for (int c = 0; c < 16; c++) {
+        for (int d = 0; d < DIMENSIONS; d++) {
+            centers[c][d] = random_float();
+        }
+    }
+    for (int i = 0; i < VECTOR_COUNT; i++) {
+        for (int d = 0; d < DIMENSIONS; d++) {
+            vectors[i][d] = centers[i % 16][d] + 0.3f * random_float();
+        }
+    }
+}
+
+/**
+ * @brief Exact distance under a metric
+ */
+static float exact_distance(VectorMetric metric, const float *a, const float *b) {
+    double dot = 0.0, norm_a = 0.0, norm_b = 0.0, l2 = 0.0;
+    for (int d = 0; d < DIMENSIONS; d++) {
+        dot += (double)a[d] * b[d];
+        norm_a += (double)a[d] * a[d];
+        norm_b += (double)b[d] * b[d];
+        l2 += ((double)a[d] - b[d]) * ((double)a[d] - b[d]);
+    }
+    return metric == VINDEX_METRIC_COSINE ? (float)(1.0 - dot / sqrt(norm_a * norm_b)) : (float)l2;
+}
+
+/**
+ * @brief Exact k nearest IDs by brute force, honoring a filter on id % 4 and id % 8
+ */
+static uint32_t brute_force(VectorMetric metric, const float *query, const VectorFilter *filter,
+                            uint64_t *ids) {
+    float best[K];
+    uint32_t count = 0;
+    for (uint64_t id = 0; id < VECTOR_COUNT; id++) {
+        if (filter && ((id % 4) < filter->min_resonance ||
+                       (filter->type_mask && !(filter->type_mask & (1u << (id % 8)))))) {
+            continue;
+        }
+        float d = exact_distance(metric, query, vectors[id]);
+        uint32_t position = count < K ? count++ : K;
+        while (position > 0 && best[position - 1] > d) {
+            if (position < K) {
+                best[position] = best[position - 1];
+                ids[position] = ids[position - 1];
+            }
+            position--;
+        }
+        if (position < K) {
+            best[position] = d;
+            ids[position] = id;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Build an index over the test vectors with one batch insert
+ */
+static VectorIndex *build_index(VectorMetric metric, VectorKernel kernel) {
+    VectorIndexOptions options = { DIMENSIONS, metric, 0, 0, kernel };
+    VectorIndex *index = vindex_create(&options);
+    if (!index) {
+        return NULL;
+    }
+
+    VectorEntry *entries = (VectorEntry *)malloc(VECTOR_COUNT * sizeof(VectorEntry));
+    assert(entries != NULL);
+    for (uint32_t i = 0; i < VECTOR_COUNT; i++) {
+        entries[i] = (VectorEntry){ i, vectors[i], i % 4, i % 8 };
+    }
+    assert(vindex_insert_batch(index, entries, VECTOR_COUNT) == VECTOR_COUNT);
+    free(entries);
+    assert(vindex_count(index) == VECTOR_COUNT);
+    return index;
+}
+
+/**
+ * @brief Fraction of exact neighbors an index finds
+ */
+static double measure_recall(VectorIndex *index, VectorMetric metric, const VectorFilter *filter) {
+    uint32_t found = 0, expected = 0;
+    for (int q = 0; q < QUERY_COUNT; q++) {
+        float query[DIMENSIONS];
+        for (int d = 0; d < DIMENSIONS; d++) {
+            query[d] = vectors[q * 37 % VECTOR_COUNT][d] + 0.2f * random_float();
+        }
+
+        uint64_t exact[K];
+        uint32_t exact_count = brute_force(metric, query, filter, exact);
+        VectorMatch matches[K];
+        uint32_t count = vindex_search(index, query, K, 64, filter, matches);
+        assert(count == exact_count);
+
+        for (uint32_t i = 0; i < count; i++) {
+            if (i > 0) {
+                assert(matches[i].distance >= matches[i - 1].distance);
+            }
+            if (filter) {
+                assert(matches[i].id % 4 >= filter->min_resonance);
+                assert(!filter->type_mask || (filter->type_mask & (1u << (matches[i].id % 8))));
+            }
+            for (uint32_t j = 0; j < exact_count; j++) {
+                if (exact[j] == matches[i].id) {
+                    found++;
+                    break;
+                }
+            }
+        }
+        expected += exact_count;
+    }
+    return expected ? (double)found / expected : 1.0;
+}
+
+/**
+ * @brief Test search accuracy against brute force for both metrics
+ */
+static void test_recall(void) {
+    printf("\nTesting vector index recall...\n");
+
+    VectorMetric metrics[] = { VINDEX_METRIC_COSINE, VINDEX_METRIC_L2 };
+    for (int m = 0; m < 2; m++) {
+        VectorIndex *index = build_index(metrics[m], VINDEX_KERNEL_AUTO);
+        assert(index != NULL);
+        double recall = measure_recall(index, metrics[m], NULL);
+        printf("  %s recall@%d with %s kernel: %.3f\n",
+               metrics[m] == VINDEX_METRIC_COSINE ? "cosine" : "l2", K, vindex_kernel_name(index), recall);
+        assert(recall >= 0.9);
+        vindex_destroy(index);
+    }
+
+    printf("Vector index recall test passed!\n");
+}
+
+/**
+ * @brief Test resonance and type filters
+ */
+static void test_filters(void) {
+    printf("\nTesting vector index filters...\n");
+
+    VectorIndex *index = build_index(VINDEX_METRIC_COSINE, VINDEX_KERNEL_AUTO);
+    assert(index != NULL);
+
+    VectorFilter resonance = { 2, 0 };
+    assert(measure_recall(index, VINDEX_METRIC_COSINE, &resonance) >= 0.9);
+
+    /* A filter matching few entries falls back to an exact scan */
+    VectorFilter narrow = { 3, 1u << 7 };
+    assert(measure_recall(index, VINDEX_METRIC_COSINE, &narrow) == 1.0);
+
+    VectorFilter none = { 0, 1u << 20 };
+    VectorMatch matches[K];
+    assert(vindex_search(index, vectors[0], K, 64, &none, matches) == 0);
+
+    vindex_destroy(index);
+    printf("Vector index filter test passed!\n");
+}
+
+/**
+ * @brief Test that every available kernel computes the same distances
+ */
+static void test_kernels(void) {
+    printf("\nTesting vector index kernels...\n");
+
+    VectorKernel kernels[] = { VINDEX_KERNEL_SCALAR, VINDEX_KERNEL_AVX2, VINDEX_KERNEL_AVX512 };
+    VectorMetric metrics[] = { VINDEX_METRIC_COSINE, VINDEX_METRIC_L2 };
+    for (int m = 0; m < 2; m++) {
+        VectorIndex *reference = build_index(metrics[m], VINDEX_KERNEL_SCALAR);
+        assert(reference != NULL && strcmp(vindex_kernel_name(reference), "scalar") == 0);
+
+        for (int k = 1; k < 3; k++) {
+            VectorIndex *index = build_index(metrics[m], kernels[k]);
+            if (!index) {
+                printf("  %s kernel not supported on this CPU\n", k == 1 ? "avx2" : "avx512");
+                continue;
+            }
+            for (uint64_t id = 0; id < VECTOR_COUNT; id += 97) {
+                float expected = 0.0f, actual = 0.0f;
+                assert(vindex_distance_to(reference, vectors[5], id, &expected));
+                assert(vindex_distance_to(index, vectors[5], id, &actual));
+                assert(fabsf(expected - actual) <= 1e-4f * (1.0f + fabsf(expected)));
+            }
+            vindex_destroy(index);
+        }
+
+        float self = 1.0f;
+        assert(vindex_distance_to(reference, vectors[9], 9, &self));
+        assert(fabsf(self) < 1e-4f);
+        vindex_destroy(reference);
+    }
+
+    printf("Vector index kernel test passed!\n");
+}
+
+/**
+ * @brief Test replacing and removing entries
+ */
+static void test_updates(void) {
+    printf("\nTesting vector index updates...\n");
+
+    VectorIndex *index = build_index(VINDEX_METRIC_L2, VINDEX_KERNEL_AUTO);
+    assert(index != NULL);
+
+    /* Replacing an ID moves it */
+    VectorEntry moved = { 3, vectors[1000], 0, 0 };
+    assert(vindex_insert(index, &moved) == true);
+    assert(vindex_count(index) == VECTOR_COUNT);
+    assert(memcmp(vindex_get(index, 3), vectors[1000], sizeof(vectors[1000])) == 0);
+    VectorMatch matches[K];
+    assert(vindex_search(index, vectors[1000], 2, 64, NULL, matches) == 2);
+    assert((matches[0].id == 3 || matches[0].id == 1000) && matches[0].distance == 0.0f);
+    assert(matches[1].distance == 0.0f);
+
+    /* Removed entries are never returned, including across rebuilds */
+    for (uint64_t id = 0; id < VECTOR_COUNT; id += 2) {
+        assert(vindex_remove(index, id) == true);
+    }
+    assert(vindex_remove(index, 0) == false);
+    assert(vindex_get(index, 0) == NULL);
+    assert(vindex_count(index) == VECTOR_COUNT / 2);
+    for (uint64_t id = 1; id < VECTOR_COUNT; id += 4) {
+        assert(vindex_remove(index, id) == true);
+    }
+    assert(vindex_count(index) == VECTOR_COUNT / 4);
+
+    for (int q = 0; q < QUERY_COUNT; q++) {
+        uint32_t count = vindex_search(index, vectors[q], K, 64, NULL, matches);
+        assert(count == K);
+        for (uint32_t i = 0; i < count; i++) {
+            assert(matches[i].id % 4 == 3);
+            assert(vindex_get(index, matches[i].id) != NULL);
+        }
+    }
+
+    /* Cosine indexes refuse vectors with no direction */
+    VectorIndexOptions options = { DIMENSIONS, VINDEX_METRIC_COSINE, 0, 0, VINDEX_KERNEL_AUTO };
+    VectorIndex *cosine = vindex_create(&options);
+    float zero[DIMENSIONS] = { 0 };
+    VectorEntry empty = { 1, zero, 0, 0 };
+    assert(vindex_insert(cosine, &empty) == false);
+    assert(vindex_count(cosine) == 0 && vindex_search(cosine, zero, K, 64, NULL, matches) == 0);
+    vindex_destroy(cosine);
+
+    options.dimensions = 0;
+    assert(vindex_create(&options) == NULL);
+
+    vindex_destroy(index);
+    printf("Vector index update test passed!\n");
+}
+
+/**
+ * @brief Test hashed text embeddings
+ */
+static void test_embed_text(void) {
+    printf("\nTesting vector index text embeddings...\n");
+
+    float a[256], b[256], c[256];
+    const char *first[] = { "Quantum field", "theory" };
+    size_t first_lengths[] = { 13, 6 };
+    const char *second[] = { "FIELD theory, quantum!" };
+    size_t second_lengths[] = { 22 };
+    const char *third[] = { "resonant crystal" };
+    size_t third_lengths[] = { 16 };
+    assert(vindex_embed_text(first, first_lengths, 2, a, 256));
+    assert(vindex_embed_text(second, second_lengths, 1, b, 256));
+    assert(vindex_embed_text(third, third_lengths, 1, c, 256));
+
+    /* Same words in any case and order embed identically */
+    float same = 0.0f, different = 0.0f;
+    for (int i = 0; i < 256; i++) {
+        same += a[i] * b[i];
+        different += a[i] * c[i];
+    }
+    assert(fabsf(same - 1.0f) < 1e-5f);
+    assert(fabsf(different) < 0.5f);
+
+    const char *blank[] = { " ,;", NULL };
+    size_t blank_lengths[] = { 3, 0 };
+    assert(vindex_embed_text(blank, blank_lengths, 2, c, 256) == false);
+    assert(c[0] == 0.0f);
+
+    printf("Vector index text embedding test passed!\n");
+}
+
+/**
+ * @brief Main test function
+ */
+int main(void) {
+    printf("Running Memex Vector Index tests...\n\n");
+
+    fill_vectors();
+    test_recall();
+    test_filters();
+    test_kernels();
+    test_updates();
+    test_embed_text();
+
+    printf("\nAll Memex Vector Index tests passed!\n");
+
+    return 0;
+}